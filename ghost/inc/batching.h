@@ -0,0 +1,25 @@
+#pragma once
+
+#include <gst/gst.h>
+
+typedef struct _GstTemPy GstTemPy;
+typedef struct _GstTemPyBatcher GstTemPyBatcher;
+
+// Collects up to size buffers, or as many as arrived within timeout
+// nanoseconds from the first one (0 waits for a full batch), and passes
+// them to the Python function in a single call. Outputs are pushed
+// downstream directly, one per input buffer and with its timestamps.
+GstTemPyBatcher * gst_tempy_batcher_new (GstTemPy * filter, guint size, guint64 timeout);
+
+void gst_tempy_batcher_free (GstTemPyBatcher * batcher);
+
+// Takes ownership of the buffer. Returns the result of the last push.
+GstFlowReturn gst_tempy_batcher_submit (GstTemPyBatcher * batcher, GstBuffer * inbuf);
+
+// Processes and pushes the pending partial batch, if any.
+GstFlowReturn gst_tempy_batcher_flush (GstTemPyBatcher * batcher);
+
+// Drops the pending buffers without processing them.
+void gst_tempy_batcher_drop (GstTemPyBatcher * batcher);
+
+void gst_tempy_batcher_set_flushing (GstTemPyBatcher * batcher, gboolean flushing);
@@ -9,6 +9,8 @@
 #include "ppfuncs.h"
 #include "pyrelated.h"
 
+typedef struct _GstTemPy GstTemPy;
+
 
 void gst_tempy_finalize(GObject * object);
 
@@ -26,6 +28,16 @@ GstCaps * gst_tempy_transform_caps (GstBaseTransform * base, GstPadDirection dir
 
 GstFlowReturn gst_tempy_prepare_output_buffer (GstBaseTransform * base, GstBuffer * inbuffer, GstBuffer ** outbuffer);
 
+GstFlowReturn gst_tempy_process_buffer(GstTemPy *filter, GstBuffer *inbuf, GstBuffer *outbuf);
+
+GstFlowReturn gst_tempy_process_batch(GstTemPy *filter, GstBuffer **inbufs, GstBuffer **outbufs, guint n_buffers);
+
 GstFlowReturn gst_tempy_transform(GstBaseTransform *trans, GstBuffer *inbuf, GstBuffer *outbuf);
 
-gboolean gst_tempy_stop(GstBaseTransform * trans);
\ No newline at end of file
+GstFlowReturn gst_tempy_submit_input_buffer(GstBaseTransform *trans, gboolean is_discont, GstBuffer *inbuf);
+
+GstFlowReturn gst_tempy_generate_output(GstBaseTransform *trans, GstBuffer **outbuf);
+
+gboolean gst_tempy_sink_event(GstBaseTransform *trans, GstEvent *event);
+
+gboolean gst_tempy_stop(GstBaseTransform * trans);
\ No newline at end of file
@@ -17,6 +17,8 @@
 #include "ppfuncs.h"
 #include "pptypes.h"
 #include "pyrelated.h"
+#include "workerpool.h"
+#include "batching.h"
 
 G_BEGIN_DECLS
 
@@ -29,7 +31,12 @@ GST_DEBUG_CATEGORY_EXTERN(gst_tempy_debug);
 enum {
     PROP_0,
     PROP_PYTHON_SCRIPT,
-    PROP_PYTHON_FUNCTION
+    PROP_PYTHON_FUNCTION,
+    PROP_ZERO_COPY,
+    PROP_N_WORKERS,
+    PROP_MAX_INFLIGHT,
+    PROP_BATCH_SIZE,
+    PROP_BATCH_TIMEOUT
 };  
 
 struct _GstTemPy {
@@ -51,11 +58,24 @@ struct _GstTemPy {
   // Python callback system
   PyObject* python_module;
   PyObject* python_function;
+  // numpy.stack, looked up once for the batched mode.
+  PyObject* numpy_stack;
   gboolean python_initialized;
   
   // Properties
   gchar* python_script_path;
   gchar* python_function_name;
+  gboolean zero_copy;
+  guint n_workers;
+  guint max_inflight;
+
+  guint batch_size;
+  guint64 batch_timeout;
+
+  // Asynchronous processing, only used when n_workers is more than 1.
+  GstTemPyWorkerPool *workers;
+  // Batched processing, only used when batch_size is more than 1.
+  GstTemPyBatcher *batcher;
 
   GstVideoPixelLayout  pixlayout;
   
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <gst/gst.h>
+
+typedef struct _GstTemPy GstTemPy;
+typedef struct _GstTemPyWorkerPool GstTemPyWorkerPool;
+
+// Runs the Python function on up to n_workers threads with at most
+// max_inflight buffers being processed at a time. Results are returned
+// strictly in submission order so output PTS order is preserved.
+GstTemPyWorkerPool * gst_tempy_worker_pool_new (GstTemPy * filter, guint n_workers, guint max_inflight);
+
+void gst_tempy_worker_pool_free (GstTemPyWorkerPool * pool);
+
+// Takes ownership of both buffers.
+GstFlowReturn gst_tempy_worker_pool_submit (GstTemPyWorkerPool * pool, GstBuffer * inbuf, GstBuffer * outbuf);
+
+// Returns the oldest processed output buffer or NULL if it is still in flight.
+// Blocks while the in-flight window is full.
+GstFlowReturn gst_tempy_worker_pool_pop (GstTemPyWorkerPool * pool, GstBuffer ** outbuf);
+
+// Waits for all in-flight buffers and pushes them downstream or drops them.
+GstFlowReturn gst_tempy_worker_pool_drain (GstTemPyWorkerPool * pool, gboolean push);
+
+void gst_tempy_worker_pool_set_flushing (GstTemPyWorkerPool * pool, gboolean flushing);
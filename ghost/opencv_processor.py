@@ -31,6 +31,43 @@ def gray_scale_filter(frame_info):
     print(f"Result: {result.shape}, dtype: {result.dtype}")
     return result
 
+def gray_scale_filter_inplace(frame_info):
+    """
+    Grayscale filter for zero-copy mode (qtitempy zero-copy=true)
+
+    Reads the read-only input view and writes straight into the output
+    buffer exposed as 'output_data', so no copy is made on return.
+    """
+    frame = frame_info['data']
+    output = frame_info.get('output_data')
+
+    gray = cv2.cvtColor(frame, cv2.COLOR_RGB2GRAY)
+
+    # Output buffer not exposed (e.g. padded or multi-memory), copy path.
+    if output is None:
+        return cv2.cvtColor(gray, cv2.COLOR_GRAY2RGB)
+
+    if gray.shape[:2] != output.shape[:2]:
+        gray = cv2.resize(gray, (output.shape[1], output.shape[0]))
+
+    cv2.cvtColor(gray, cv2.COLOR_GRAY2RGB, dst=output)
+    return output
+
+def gray_scale_filter_batch(frame_info):
+    """
+    Grayscale filter for batched processing (qtitempy batch-size > 1)
+
+    Receives a stacked (N, H, W, 3) array and converts the whole batch
+    with vectorized NumPy instead of once per frame.
+    """
+    frames = frame_info['data']
+
+    # ITU-R BT.601 luma weights, applied to all frames at once.
+    gray = frames @ np.array([0.299, 0.587, 0.114], dtype=np.float32)
+    gray = gray.astype(np.uint8)
+
+    return np.repeat(gray[..., np.newaxis], 3, axis=-1)
+
 def mobilenet_preprocess(frame_info):
     """
     Preprocess for MobileNet v2 quantized model
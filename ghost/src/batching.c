@@ -0,0 +1,246 @@
+#include "batching.h"
+#include "qtitempy.h"
+
+#define GST_CAT_DEFAULT gst_tempy_debug
+
+struct _GstTemPyBatcher {
+  GstTemPy      *filter;
+
+  // Protects the pending buffers and the flags, never held while pushing.
+  GMutex        lock;
+  // Signalled on new pending buffers or when the timer needs to exit.
+  GCond         wakeup;
+  // Serializes processing and pushing so that batches stay in order.
+  // Always taken before lock.
+  GMutex        pushlock;
+
+  // Flushes partial batches once the timeout expires, NULL without timeout.
+  GThread       *timer;
+
+  // Pending input buffers, in arrival order.
+  GPtrArray     *inbufs;
+  // Buffers of the batch being processed, swapped with inbufs.
+  GPtrArray     *batch;
+  // Monotonic time (microseconds) at which the first pending buffer arrived.
+  gint64        deadline;
+
+  guint         size;
+  guint64       timeout;
+
+  // Result of the last push, returned upstream on the next submit.
+  GstFlowReturn last_ret;
+
+  gboolean      flushing;
+  gboolean      stopping;
+};
+
+static GstFlowReturn
+gst_tempy_batcher_process (GstTemPyBatcher * batcher)
+{
+  GstBaseTransform *base = GST_BASE_TRANSFORM (batcher->filter);
+  GstBaseTransformClass *klass = GST_BASE_TRANSFORM_GET_CLASS (base);
+  GstBuffer **inbufs = NULL, **outbufs = NULL;
+  GPtrArray *batch = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint idx = 0, n_buffers = 0;
+
+  g_mutex_lock (&batcher->pushlock);
+  g_mutex_lock (&batcher->lock);
+
+  if (batcher->flushing || (batcher->inbufs->len == 0)) {
+    g_mutex_unlock (&batcher->lock);
+    g_mutex_unlock (&batcher->pushlock);
+    return GST_FLOW_OK;
+  }
+
+  // Take the pending buffers, new ones are queued while this batch is pushed.
+  batch = batcher->inbufs;
+  batcher->inbufs = batcher->batch;
+  batcher->batch = batch;
+
+  g_mutex_unlock (&batcher->lock);
+
+  n_buffers = batch->len;
+  inbufs = (GstBuffer **) batch->pdata;
+  outbufs = g_new0 (GstBuffer *, n_buffers);
+
+  // The output buffers inherit the metadata and timestamps of the inputs.
+  for (idx = 0; (idx < n_buffers) && (ret == GST_FLOW_OK); idx++)
+    ret = klass->prepare_output_buffer (base, inbufs[idx], &outbufs[idx]);
+
+  if (ret == GST_FLOW_OK)
+    ret = gst_tempy_process_batch (batcher->filter, inbufs, outbufs, n_buffers);
+
+  GST_LOG_OBJECT (batcher->filter, "Processed batch of %u buffers, %s",
+      n_buffers, gst_flow_get_name (ret));
+
+  for (idx = 0; idx < n_buffers; idx++) {
+    if ((ret == GST_FLOW_OK) && (outbufs[idx] != NULL)) {
+      ret = gst_pad_push (GST_BASE_TRANSFORM_SRC_PAD (base), outbufs[idx]);
+      outbufs[idx] = NULL;
+    }
+
+    if (outbufs[idx] != NULL)
+      gst_buffer_unref (outbufs[idx]);
+  }
+
+  g_free (outbufs);
+  g_ptr_array_set_size (batch, 0);
+
+  g_mutex_lock (&batcher->lock);
+  batcher->last_ret = ret;
+  g_mutex_unlock (&batcher->lock);
+
+  g_mutex_unlock (&batcher->pushlock);
+  return ret;
+}
+
+static gpointer
+gst_tempy_batcher_timer (gpointer userdata)
+{
+  GstTemPyBatcher *batcher = userdata;
+
+  g_mutex_lock (&batcher->lock);
+
+  while (!batcher->stopping) {
+    if (batcher->flushing || (batcher->inbufs->len == 0)) {
+      g_cond_wait (&batcher->wakeup, &batcher->lock);
+      continue;
+    }
+
+    if (g_cond_wait_until (&batcher->wakeup, &batcher->lock, batcher->deadline))
+      continue;
+
+    // Woken up by the timeout, the batch may have been completed meanwhile.
+    if (!batcher->stopping && !batcher->flushing && (batcher->inbufs->len > 0) &&
+        (g_get_monotonic_time () >= batcher->deadline)) {
+      GST_LOG_OBJECT (batcher->filter, "Batch timeout with %u buffers",
+          batcher->inbufs->len);
+
+      // Push without the lock so that flushes and queries are not blocked.
+      g_mutex_unlock (&batcher->lock);
+      gst_tempy_batcher_process (batcher);
+      g_mutex_lock (&batcher->lock);
+    }
+  }
+
+  g_mutex_unlock (&batcher->lock);
+  return NULL;
+}
+
+GstTemPyBatcher *
+gst_tempy_batcher_new (GstTemPy * filter, guint size, guint64 timeout)
+{
+  GstTemPyBatcher *batcher = g_slice_new0 (GstTemPyBatcher);
+
+  g_mutex_init (&batcher->lock);
+  g_cond_init (&batcher->wakeup);
+  g_mutex_init (&batcher->pushlock);
+
+  batcher->filter = filter;
+  batcher->inbufs = g_ptr_array_new_full (size,
+      (GDestroyNotify) gst_buffer_unref);
+  batcher->batch = g_ptr_array_new_full (size,
+      (GDestroyNotify) gst_buffer_unref);
+  batcher->size = size;
+  batcher->timeout = timeout;
+  batcher->last_ret = GST_FLOW_OK;
+  batcher->flushing = FALSE;
+  batcher->stopping = FALSE;
+
+  if (timeout != 0)
+    batcher->timer = g_thread_new ("TemPyBatchTimer", gst_tempy_batcher_timer,
+        batcher);
+
+  GST_INFO_OBJECT (filter, "Batching up to %u buffers, timeout %"
+      GST_TIME_FORMAT, size, GST_TIME_ARGS (timeout));
+  return batcher;
+}
+
+void
+gst_tempy_batcher_free (GstTemPyBatcher * batcher)
+{
+  if (batcher->timer != NULL) {
+    g_mutex_lock (&batcher->lock);
+    batcher->stopping = TRUE;
+    g_cond_signal (&batcher->wakeup);
+    g_mutex_unlock (&batcher->lock);
+
+    g_thread_join (batcher->timer);
+  }
+
+  g_ptr_array_free (batcher->inbufs, TRUE);
+  g_ptr_array_free (batcher->batch, TRUE);
+
+  g_mutex_clear (&batcher->pushlock);
+  g_cond_clear (&batcher->wakeup);
+  g_mutex_clear (&batcher->lock);
+
+  g_slice_free (GstTemPyBatcher, batcher);
+}
+
+GstFlowReturn
+gst_tempy_batcher_submit (GstTemPyBatcher * batcher, GstBuffer * inbuf)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  g_mutex_lock (&batcher->lock);
+
+  if (batcher->flushing) {
+    g_mutex_unlock (&batcher->lock);
+    gst_buffer_unref (inbuf);
+    return GST_FLOW_FLUSHING;
+  }
+
+  // Report errors of a batch pushed by the timer thread.
+  if ((ret = batcher->last_ret) != GST_FLOW_OK) {
+    g_mutex_unlock (&batcher->lock);
+    gst_buffer_unref (inbuf);
+    return ret;
+  }
+
+  if (batcher->inbufs->len == 0) {
+    batcher->deadline = g_get_monotonic_time () +
+        (gint64) (batcher->timeout / GST_USECOND);
+    g_cond_signal (&batcher->wakeup);
+  }
+
+  g_ptr_array_add (batcher->inbufs, inbuf);
+
+  if (batcher->inbufs->len < batcher->size) {
+    g_mutex_unlock (&batcher->lock);
+    return GST_FLOW_OK;
+  }
+
+  g_mutex_unlock (&batcher->lock);
+
+  // The timer may have pushed the batch meanwhile, then this is a no-op.
+  return gst_tempy_batcher_process (batcher);
+}
+
+GstFlowReturn
+gst_tempy_batcher_flush (GstTemPyBatcher * batcher)
+{
+  return gst_tempy_batcher_process (batcher);
+}
+
+void
+gst_tempy_batcher_drop (GstTemPyBatcher * batcher)
+{
+  g_mutex_lock (&batcher->lock);
+
+  g_ptr_array_set_size (batcher->inbufs, 0);
+  batcher->last_ret = GST_FLOW_OK;
+
+  g_mutex_unlock (&batcher->lock);
+}
+
+void
+gst_tempy_batcher_set_flushing (GstTemPyBatcher * batcher, gboolean flushing)
+{
+  // Never blocks on a batch being pushed, which does not hold the lock.
+  g_mutex_lock (&batcher->lock);
+  batcher->flushing = flushing;
+  g_cond_signal (&batcher->wakeup);
+  g_mutex_unlock (&batcher->lock);
+}
@@ -4,6 +4,9 @@
 
 #define GST_CAT_DEFAULT gst_tempy_debug
 
+#define GST_TEMPY_PARENT_CLASS \
+    GST_BASE_TRANSFORM_CLASS (g_type_class_peek (GST_TYPE_BASE_TRANSFORM))
+
 void 
 gst_tempy_set_property (GObject * object, guint prop_id, const GValue * value, GParamSpec * pspec)
 {
@@ -18,6 +21,21 @@ gst_tempy_set_property (GObject * object, guint prop_id, const GValue * value, G
           g_free(filter->python_function_name);
           filter->python_function_name = g_value_dup_string(value);
           break;
+      case PROP_ZERO_COPY:
+          filter->zero_copy = g_value_get_boolean(value);
+          break;
+      case PROP_N_WORKERS:
+          filter->n_workers = g_value_get_uint(value);
+          break;
+      case PROP_MAX_INFLIGHT:
+          filter->max_inflight = g_value_get_uint(value);
+          break;
+      case PROP_BATCH_SIZE:
+          filter->batch_size = g_value_get_uint(value);
+          break;
+      case PROP_BATCH_TIMEOUT:
+          filter->batch_timeout = g_value_get_uint64(value);
+          break;
       default:
           G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
           break;
@@ -36,6 +54,21 @@ gst_tempy_get_property (GObject * object, guint prop_id, GValue * value, GParamS
       case PROP_PYTHON_FUNCTION:
           g_value_set_string(value, filter->python_function_name);
           break;
+      case PROP_ZERO_COPY:
+          g_value_set_boolean(value, filter->zero_copy);
+          break;
+      case PROP_N_WORKERS:
+          g_value_set_uint(value, filter->n_workers);
+          break;
+      case PROP_MAX_INFLIGHT:
+          g_value_set_uint(value, filter->max_inflight);
+          break;
+      case PROP_BATCH_SIZE:
+          g_value_set_uint(value, filter->batch_size);
+          break;
+      case PROP_BATCH_TIMEOUT:
+          g_value_set_uint64(value, filter->batch_timeout);
+          break;
       default:
           G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
           break;
@@ -47,7 +80,25 @@ gst_tempy_start (GstBaseTransform * base)
 {
   GST_ERROR("=== QTITEMPY START CALLED ===");
   GstTemPy *tempy = GST_TEMPY(base);
-  return gst_tempy_init_python(tempy);
+
+  if (!gst_tempy_init_python(tempy))
+    return FALSE;
+
+  if (tempy->batch_size > 1) {
+    if (tempy->n_workers > 1)
+      GST_WARNING_OBJECT(tempy, "Batching enabled, ignoring n-workers");
+
+    tempy->batcher = gst_tempy_batcher_new(tempy, tempy->batch_size,
+        tempy->batch_timeout);
+  } else if (tempy->n_workers > 1) {
+    tempy->workers = gst_tempy_worker_pool_new(tempy, tempy->n_workers,
+        tempy->max_inflight);
+
+    if (!tempy->workers)
+      return FALSE;
+  }
+
+  return TRUE;
 }
 
 GstCaps* 
@@ -224,13 +275,9 @@ gst_tempy_prepare_output_buffer (GstBaseTransform * base,
 
 
 
-GstFlowReturn 
-gst_tempy_transform(GstBaseTransform *trans, GstBuffer *inbuf, GstBuffer *outbuf) 
+GstFlowReturn
+gst_tempy_process_buffer(GstTemPy *filter, GstBuffer *inbuf, GstBuffer *outbuf)
 {
-  GstTemPy *filter = GST_TEMPY(trans);
-  
-  filter->frame_count++;
-  
   // If no Python function is loaded, return error
   if (!filter->python_function) {
     GST_ERROR_OBJECT(filter, "No Python function loaded");
@@ -261,6 +308,16 @@ gst_tempy_transform(GstBaseTransform *trans, GstBuffer *inbuf, GstBuffer *outbuf
   
   Py_DECREF(input_array); // We don't need the direct reference anymore
 
+  // Expose the output buffer so the script can write its result in place.
+  if (filter->zero_copy) {
+    PyObject* output_array = gst_tempy_output_buffer_to_numpy(filter, outbuf);
+
+    if (output_array) {
+      PyDict_SetItemString(frame_info, "output_data", output_array);
+      Py_DECREF(output_array);
+    }
+  }
+
   GstClockTime start_time = gst_util_get_timestamp();
   
   // Call Python function with comprehensive format info
@@ -297,10 +354,243 @@ gst_tempy_transform(GstBaseTransform *trans, GstBuffer *inbuf, GstBuffer *outbuf
   return GST_FLOW_OK;
 }
 
+GstFlowReturn
+gst_tempy_process_batch(GstTemPy *filter, GstBuffer **inbufs,
+    GstBuffer **outbufs, guint n_buffers)
+{
+  PyObject *arrays = NULL, *batch = NULL, *timestamps = NULL;
+  PyObject *frame_info = NULL, *args = NULL, *result = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint idx = 0;
+
+  if (!filter->python_function) {
+    GST_ERROR_OBJECT(filter, "No Python function loaded");
+    return GST_FLOW_ERROR;
+  }
+
+  PyGILState_STATE gstate;
+  gstate = PyGILState_Ensure();
+
+  arrays = PyList_New(n_buffers);
+  timestamps = PyList_New(n_buffers);
+
+  for (idx = 0; idx < n_buffers; idx++) {
+    PyObject* input_array = gst_tempy_buffer_to_numpy(filter, inbufs[idx]);
+
+    if (!input_array) {
+      GST_ERROR_OBJECT(filter, "Failed to convert input buffer %u to NumPy array", idx);
+      goto error;
+    }
+
+    PyList_SET_ITEM(arrays, idx, input_array); // steals reference
+    PyList_SET_ITEM(timestamps, idx,
+        PyLong_FromUnsignedLongLong(GST_BUFFER_PTS(inbufs[idx])));
+  }
+
+  // Stack into a single (N, ...) array, the only copy of the input data.
+  batch = PyObject_CallFunctionObjArgs(filter->numpy_stack, arrays, NULL);
+
+  if (!batch) {
+    GST_ERROR_OBJECT(filter, "Failed to stack %u input arrays", n_buffers);
+    PyErr_Print();
+    goto error;
+  }
+
+  // Release the per buffer arrays and with them any zero-copy mappings.
+  Py_CLEAR(arrays);
+
+  frame_info = PyDict_New();
+  PyDict_SetItemString(frame_info, "data", batch);
+  PyDict_SetItemString(frame_info, "timestamps", timestamps);
+
+  PyObject* batch_size = PyLong_FromUnsignedLong(n_buffers);
+  PyDict_SetItemString(frame_info, "batch_size", batch_size);
+  Py_DECREF(batch_size);
+
+  add_format_info_to_dict(frame_info, "input", &filter->input_format);
+  add_format_info_to_dict(frame_info, "output", &filter->output_format);
+
+  args = PyTuple_New(1);
+  PyTuple_SetItem(args, 0, frame_info); // steals reference
+
+  result = PyObject_CallObject(filter->python_function, args);
+  Py_DECREF(args);
+
+  if (!result) {
+    GST_ERROR_OBJECT(filter, "Python function call failed");
+    PyErr_Print();
+    goto error;
+  }
+
+  if (!gst_tempy_numpy_to_output_buffers(filter, result, outbufs, n_buffers)) {
+    GST_ERROR_OBJECT(filter, "Failed to convert Python batch result to output buffers");
+    goto error;
+  }
+
+  Py_DECREF(result);
+  Py_DECREF(batch);
+  Py_DECREF(timestamps);
+
+  PyGILState_Release(gstate);
+  return ret;
+
+error:
+  Py_XDECREF(result);
+  Py_XDECREF(batch);
+  Py_XDECREF(arrays);
+  Py_XDECREF(timestamps);
+
+  PyGILState_Release(gstate);
+  return GST_FLOW_ERROR;
+}
+
+GstFlowReturn 
+gst_tempy_transform(GstBaseTransform *trans, GstBuffer *inbuf, GstBuffer *outbuf) 
+{
+  GstTemPy *filter = GST_TEMPY(trans);
+  
+  filter->frame_count++;
+  
+  return gst_tempy_process_buffer(filter, inbuf, outbuf);
+}
+
+GstFlowReturn
+gst_tempy_submit_input_buffer(GstBaseTransform *trans, gboolean is_discont,
+    GstBuffer *inbuf)
+{
+  GstTemPy *filter = GST_TEMPY(trans);
+  GstBuffer *outbuf = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  // Let baseclass handle caps (re)negotiation and QoS.
+  ret = GST_TEMPY_PARENT_CLASS->submit_input_buffer(trans,
+      is_discont, inbuf);
+
+  if (ret != GST_FLOW_OK || (!filter->workers && !filter->batcher))
+    return ret;
+
+  if (gst_base_transform_is_passthrough(trans))
+    return ret;
+
+  // Take the queued buffer, it is processed by the workers instead.
+  if ((inbuf = trans->queued_buf) == NULL)
+    return GST_FLOW_OK;
+
+  trans->queued_buf = NULL;
+  filter->frame_count++;
+
+  if (filter->batcher && gst_buffer_get_size(inbuf) == 0 &&
+      GST_BUFFER_FLAG_IS_SET(inbuf, GST_BUFFER_FLAG_GAP)) {
+    // GAP buffers cannot be stacked, push them in order after the batch.
+    if ((ret = gst_tempy_batcher_flush(filter->batcher)) != GST_FLOW_OK) {
+      gst_buffer_unref(inbuf);
+      return ret;
+    }
+
+    ret = GST_BASE_TRANSFORM_GET_CLASS(trans)->prepare_output_buffer(trans,
+        inbuf, &outbuf);
+    gst_buffer_unref(inbuf);
+
+    return (ret == GST_FLOW_OK) ?
+        gst_pad_push(GST_BASE_TRANSFORM_SRC_PAD(trans), outbuf) : ret;
+  } else if (filter->batcher) {
+    return gst_tempy_batcher_submit(filter->batcher, inbuf);
+  }
+
+  ret = GST_BASE_TRANSFORM_GET_CLASS(trans)->prepare_output_buffer(trans,
+      inbuf, &outbuf);
+
+  if (ret != GST_FLOW_OK) {
+    gst_buffer_unref(inbuf);
+    return ret;
+  }
+
+  return gst_tempy_worker_pool_submit(filter->workers, inbuf, outbuf);
+}
+
+GstFlowReturn
+gst_tempy_generate_output(GstBaseTransform *trans, GstBuffer **outbuf)
+{
+  GstTemPy *filter = GST_TEMPY(trans);
+
+  // Batches are pushed downstream once they have been processed.
+  if (filter->batcher && !gst_base_transform_is_passthrough(trans)) {
+    *outbuf = NULL;
+    return GST_FLOW_OK;
+  }
+
+  if (!filter->workers || gst_base_transform_is_passthrough(trans))
+    return GST_TEMPY_PARENT_CLASS->generate_output(trans, outbuf);
+
+  return gst_tempy_worker_pool_pop(filter->workers, outbuf);
+}
+
+gboolean
+gst_tempy_sink_event(GstBaseTransform *trans, GstEvent *event)
+{
+  GstTemPy *filter = GST_TEMPY(trans);
+
+  if (filter->batcher) {
+    switch (GST_EVENT_TYPE(event)) {
+      case GST_EVENT_FLUSH_START:
+        gst_tempy_batcher_set_flushing(filter->batcher, TRUE);
+        break;
+      case GST_EVENT_FLUSH_STOP:
+        gst_tempy_batcher_drop(filter->batcher);
+        gst_tempy_batcher_set_flushing(filter->batcher, FALSE);
+        break;
+      case GST_EVENT_EOS:
+      case GST_EVENT_CAPS:
+      case GST_EVENT_SEGMENT:
+        // Process and push the partial batch before the event is forwarded.
+        gst_tempy_batcher_flush(filter->batcher);
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (!filter->workers)
+    return GST_TEMPY_PARENT_CLASS->sink_event(trans, event);
+
+  switch (GST_EVENT_TYPE(event)) {
+    case GST_EVENT_FLUSH_START:
+      gst_tempy_worker_pool_set_flushing(filter->workers, TRUE);
+      break;
+    case GST_EVENT_FLUSH_STOP:
+      gst_tempy_worker_pool_drain(filter->workers, FALSE);
+      gst_tempy_worker_pool_set_flushing(filter->workers, FALSE);
+      break;
+    case GST_EVENT_EOS:
+    case GST_EVENT_CAPS:
+    case GST_EVENT_SEGMENT:
+      // Push everything in flight before the event is forwarded.
+      gst_tempy_worker_pool_drain(filter->workers, TRUE);
+      break;
+    default:
+      break;
+  }
+
+  return GST_TEMPY_PARENT_CLASS->sink_event(trans, event);
+}
+
 gboolean 
 gst_tempy_stop(GstBaseTransform * trans)
 {
   GstTemPy *filter = GST_TEMPY(trans);
+
+  if (filter->batcher) {
+    gst_tempy_batcher_set_flushing(filter->batcher, TRUE);
+    gst_tempy_batcher_free(filter->batcher);
+    filter->batcher = NULL;
+  }
+
+  if (filter->workers) {
+    gst_tempy_worker_pool_set_flushing(filter->workers, TRUE);
+    gst_tempy_worker_pool_free(filter->workers);
+    filter->workers = NULL;
+  }
+
   gst_tempy_cleanup_python(filter);
   return TRUE;
 }
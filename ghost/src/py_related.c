@@ -4,6 +4,282 @@
 // Global flag for NumPy initialization
 gboolean numpy_initialized = FALSE;
 
+// Name of the capsules which keep the wrapped GStreamer memory mapped.
+#define GST_TEMPY_MAPPING_CAPSULE "qtitempy.mapping"
+
+// Mapping kept alive for as long as a zero-copy NumPy array references it.
+typedef struct _GstTemPyMapping GstTemPyMapping;
+
+struct _GstTemPyMapping {
+    // Buffer reference, set for the read-only input arrays.
+    GstBuffer  *buffer;
+    // Memory reference, set for the writable output arrays.
+    GstMemory  *memory;
+    GstMapInfo map;
+};
+
+static void
+gst_tempy_mapping_release (PyObject * capsule)
+{
+    GstTemPyMapping *mapping =
+        PyCapsule_GetPointer (capsule, GST_TEMPY_MAPPING_CAPSULE);
+
+    if (mapping == NULL)
+        return;
+
+    if (mapping->buffer != NULL) {
+        gst_buffer_unmap (mapping->buffer, &mapping->map);
+        gst_buffer_unref (mapping->buffer);
+    } else if (mapping->memory != NULL) {
+        gst_memory_unmap (mapping->memory, &mapping->map);
+        gst_memory_unref (mapping->memory);
+    }
+
+    g_slice_free (GstTemPyMapping, mapping);
+}
+
+// Wraps the mapped memory into a NumPy array without copying it. The array
+// owns a capsule with the mapping which is released with the array.
+static PyObject*
+gst_tempy_mapping_to_numpy (GstTemPy * filter, GstTemPyMapping * mapping,
+    gsize offset, gint n_dims, npy_intp * dims, npy_intp * strides)
+{
+    PyObject *array = NULL, *capsule = NULL;
+    gint flags = NPY_ARRAY_ALIGNED;
+
+    capsule = PyCapsule_New (mapping, GST_TEMPY_MAPPING_CAPSULE,
+        gst_tempy_mapping_release);
+
+    if (capsule == NULL) {
+        GST_ERROR_OBJECT (filter, "Failed to create mapping capsule");
+        PyErr_Print ();
+        // Release the mapping manually, the capsule does not own it.
+        if (mapping->buffer != NULL) {
+            gst_buffer_unmap (mapping->buffer, &mapping->map);
+            gst_buffer_unref (mapping->buffer);
+        } else {
+            gst_memory_unmap (mapping->memory, &mapping->map);
+            gst_memory_unref (mapping->memory);
+        }
+        g_slice_free (GstTemPyMapping, mapping);
+        return NULL;
+    }
+
+    // Only the output memory may be modified in place by the script.
+    if (mapping->map.flags & GST_MAP_WRITE)
+        flags |= NPY_ARRAY_WRITEABLE;
+
+    array = PyArray_New (&PyArray_Type, n_dims, dims, NPY_UINT8, strides,
+        mapping->map.data + offset, 0, flags, NULL);
+
+    if (array == NULL) {
+        GST_ERROR_OBJECT (filter, "Failed to wrap mapped memory");
+        PyErr_Print ();
+        Py_DECREF (capsule);
+        return NULL;
+    }
+
+    // Steals the capsule reference.
+    if (PyArray_SetBaseObject ((PyArrayObject*)array, capsule) < 0) {
+        GST_ERROR_OBJECT (filter, "Failed to attach mapping to NumPy array");
+        PyErr_Print ();
+        Py_DECREF (array);
+        return NULL;
+    }
+
+    return array;
+}
+
+// Copies frame data with the GIL released so that other workers can run
+// Python code meanwhile. The caller must hold the GIL.
+static void
+gst_tempy_copy_nogil (gpointer dest, gconstpointer src, gsize size)
+{
+    Py_BEGIN_ALLOW_THREADS
+    memcpy (dest, src, size);
+    Py_END_ALLOW_THREADS
+}
+
+// Returns the mapping whose capsule is at the bottom of the array base chain.
+static GstTemPyMapping*
+gst_tempy_numpy_get_mapping (PyArrayObject * array)
+{
+    PyObject *base = PyArray_BASE (array);
+
+    while (base != NULL && PyArray_Check (base))
+        base = PyArray_BASE ((PyArrayObject*)base);
+
+    if (base == NULL || !PyCapsule_IsValid (base, GST_TEMPY_MAPPING_CAPSULE))
+        return NULL;
+
+    return PyCapsule_GetPointer (base, GST_TEMPY_MAPPING_CAPSULE);
+}
+
+static PyObject*
+gst_tempy_buffer_to_numpy_view (GstTemPy * filter, GstBuffer * buf)
+{
+    GstTemPyMapping *mapping = NULL;
+    npy_intp dims[3], strides[3];
+    gsize offset = 0;
+    gint n_dims = 1;
+    gboolean success = FALSE;
+
+    mapping = g_slice_new0 (GstTemPyMapping);
+
+    // Mapping may wait on a cache sync, do not block the other workers.
+    Py_BEGIN_ALLOW_THREADS
+    success = gst_buffer_map (buf, &mapping->map, GST_MAP_READ);
+    Py_END_ALLOW_THREADS
+
+    if (!success) {
+        GST_ERROR_OBJECT (filter, "Failed to map buffer");
+        g_slice_free (GstTemPyMapping, mapping);
+        return NULL;
+    }
+
+    mapping->buffer = gst_buffer_ref (buf);
+
+    dims[0] = mapping->map.size;
+    strides[0] = 1;
+
+    if (filter->input_format.type == FORMAT_TYPE_VIDEO) {
+        GstVideoInfo *info = &filter->input_format.info.video;
+        GstVideoMeta *vmeta = gst_buffer_get_video_meta (buf);
+        gint width = GST_VIDEO_INFO_WIDTH (info);
+        gint height = GST_VIDEO_INFO_HEIGHT (info);
+        gint stride = GST_VIDEO_INFO_PLANE_STRIDE (info, 0);
+        gint channels = 0;
+
+        offset = GST_VIDEO_INFO_PLANE_OFFSET (info, 0);
+
+        // Prefer the actual layout of the buffer over the negotiated one.
+        if (vmeta != NULL) {
+            stride = vmeta->stride[0];
+            offset = vmeta->offset[0];
+        }
+
+        switch (GST_VIDEO_INFO_FORMAT (info)) {
+            case GST_VIDEO_FORMAT_RGB:
+            case GST_VIDEO_FORMAT_BGR:
+                channels = 3;
+                break;
+            case GST_VIDEO_FORMAT_RGBA:
+            case GST_VIDEO_FORMAT_BGRA:
+                channels = 4;
+                break;
+            case GST_VIDEO_FORMAT_NV12:
+                // Passed as a 1D raw buffer, same as in the copy path.
+                offset = 0;
+                break;
+            default:
+                GST_ERROR_OBJECT (filter, "Unsupported video format: %s",
+                    gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (info)));
+                goto error;
+        }
+
+        if (channels != 0) {
+            if (mapping->map.size < offset + ((gsize) stride * (height - 1)) +
+                    ((gsize) width * channels)) {
+                GST_ERROR_OBJECT (filter, "Buffer too small: got %zu for "
+                    "%dx%dx%d with stride %d", mapping->map.size, height,
+                    width, channels, stride);
+                goto error;
+            }
+
+            n_dims = 3;
+            dims[0] = height;
+            dims[1] = width;
+            dims[2] = channels;
+            strides[0] = stride;
+            strides[1] = channels;
+            strides[2] = 1;
+        }
+    }
+
+    GST_TRACE_OBJECT (filter, "Wrapping %zu bytes of input memory",
+        mapping->map.size);
+    return gst_tempy_mapping_to_numpy (filter, mapping, offset, n_dims,
+        dims, strides);
+
+error:
+    gst_buffer_unmap (buf, &mapping->map);
+    gst_buffer_unref (buf);
+    g_slice_free (GstTemPyMapping, mapping);
+    return NULL;
+}
+
+PyObject* gst_tempy_output_buffer_to_numpy(GstTemPy* filter, GstBuffer * buf)
+{
+    GstTemPyMapping *mapping = NULL;
+    GstMemory *memory = NULL;
+    npy_intp dims[3], strides[3];
+    gsize offset = 0;
+    gint n_dims = 1;
+    gboolean success = FALSE;
+
+    // Text output replaces the buffer memory, nothing to expose.
+    if (filter->output_format.type != FORMAT_TYPE_VIDEO &&
+        filter->output_format.type != FORMAT_TYPE_TENSOR)
+        return NULL;
+
+    // Only single memory pool buffers can be exposed as one array.
+    if (gst_buffer_n_memory (buf) != 1)
+        return NULL;
+
+    memory = gst_buffer_peek_memory (buf, 0);
+    mapping = g_slice_new0 (GstTemPyMapping);
+
+    // Reference the memory and not the buffer so that it stays writable.
+    Py_BEGIN_ALLOW_THREADS
+    success = gst_memory_map (memory, &mapping->map, GST_MAP_READWRITE);
+    Py_END_ALLOW_THREADS
+
+    if (!success) {
+        GST_WARNING_OBJECT (filter, "Failed to map output memory");
+        g_slice_free (GstTemPyMapping, mapping);
+        return NULL;
+    }
+
+    mapping->memory = gst_memory_ref (memory);
+
+    dims[0] = mapping->map.size;
+    strides[0] = 1;
+
+    if (filter->output_format.type == FORMAT_TYPE_VIDEO) {
+        GstVideoInfo *info = &filter->output_format.info.video;
+        gint channels = 0;
+
+        switch (GST_VIDEO_INFO_FORMAT (info)) {
+            case GST_VIDEO_FORMAT_RGB:
+            case GST_VIDEO_FORMAT_BGR:
+                channels = 3;
+                break;
+            case GST_VIDEO_FORMAT_RGBA:
+            case GST_VIDEO_FORMAT_BGRA:
+                channels = 4;
+                break;
+            default:
+                break;
+        }
+
+        if (channels != 0 && mapping->map.size >= GST_VIDEO_INFO_SIZE (info)) {
+            n_dims = 3;
+            offset = GST_VIDEO_INFO_PLANE_OFFSET (info, 0);
+            dims[0] = GST_VIDEO_INFO_HEIGHT (info);
+            dims[1] = GST_VIDEO_INFO_WIDTH (info);
+            dims[2] = channels;
+            strides[0] = GST_VIDEO_INFO_PLANE_STRIDE (info, 0);
+            strides[1] = channels;
+            strides[2] = 1;
+        }
+    }
+
+    GST_TRACE_OBJECT (filter, "Wrapping %zu bytes of output memory",
+        mapping->map.size);
+    return gst_tempy_mapping_to_numpy (filter, mapping, offset, n_dims,
+        dims, strides);
+}
+
 gboolean gst_tempy_init_python(GstTemPy * filter)
 {
 	if (filter->python_initialized) {
@@ -50,7 +326,16 @@ gboolean gst_tempy_init_python(GstTemPy * filter)
 		PyGILState_Release(gstate);
 		return FALSE;
 	}
+
+	filter->numpy_stack = PyObject_GetAttrString(numpy, "stack");
 	Py_DECREF(numpy);
+
+	if (!filter->numpy_stack) {
+		GST_ERROR_OBJECT(filter, "Failed to get numpy.stack");
+		PyErr_Print();
+		PyGILState_Release(gstate);
+		return FALSE;
+	}
 	
 	// Load the Python script if specified
 	if (filter->python_script_path && strlen(filter->python_script_path) > 0) {
@@ -119,8 +404,16 @@ PyObject* gst_tempy_buffer_to_numpy(GstTemPy* filter, GstBuffer * buf)
 {
     GstMapInfo map;
     PyObject* result = NULL;
+    gboolean success = FALSE;
+
+    if (filter->zero_copy)
+        return gst_tempy_buffer_to_numpy_view(filter, buf);
     
-    if (!gst_buffer_map(buf, &map, GST_MAP_READ)) {
+    Py_BEGIN_ALLOW_THREADS
+    success = gst_buffer_map(buf, &map, GST_MAP_READ);
+    Py_END_ALLOW_THREADS
+
+    if (!success) {
         GST_ERROR_OBJECT(filter, "Failed to map buffer");
         return NULL;
     }
@@ -222,7 +515,7 @@ PyObject* handle_video_buffer(GstTemPy* filter, GstMapInfo* map)
     
     // Copy data from GStreamer buffer to NumPy array
     unsigned char* array_data = (unsigned char*)PyArray_DATA((PyArrayObject*)array);
-    memcpy(array_data, map->data, MIN(map->size, expected_size));
+    gst_tempy_copy_nogil(array_data, map->data, MIN(map->size, expected_size));
     
     GST_DEBUG_OBJECT(filter, "Created video NumPy array: %dx%dx%d", height, width, channels);
     return array;
@@ -242,7 +535,7 @@ PyObject* handle_tensor_buffer(GstTemPy* filter, GstMapInfo* map)
     
     // Copy tensor data
     unsigned char* array_data = (unsigned char*)PyArray_DATA((PyArrayObject*)array);
-    memcpy(array_data, map->data, map->size);
+    gst_tempy_copy_nogil(array_data, map->data, map->size);
     
     GST_DEBUG_OBJECT(filter, "Created tensor NumPy array: %zu bytes", map->size);
     return array;
@@ -264,7 +557,7 @@ PyObject* handle_raw_buffer(GstTemPy* filter, GstMapInfo* map)
     
     // Copy raw data
     unsigned char* array_data = (unsigned char*)PyArray_DATA((PyArrayObject*)array);
-    memcpy(array_data, map->data, map->size);
+    gst_tempy_copy_nogil(array_data, map->data, map->size);
     
     GST_DEBUG_OBJECT(filter, "Created raw NumPy array: %zu bytes", map->size);
     return array;
@@ -286,6 +579,43 @@ gboolean gst_tempy_numpy_to_output_buffer(GstTemPy *filter, PyObject *result, Gs
     }
 }
 
+gboolean gst_tempy_numpy_to_output_buffers(GstTemPy *filter, PyObject *result,
+    GstBuffer **bufs, guint n_buffers) {
+    guint idx = 0;
+
+    // Either a (N, ...) array or a sequence of N per buffer results.
+    if (PyArray_Check(result) &&
+        ((PyArray_NDIM((PyArrayObject*)result) < 2) ||
+         (PyArray_DIM((PyArrayObject*)result, 0) != n_buffers))) {
+        GST_ERROR_OBJECT(filter, "Batch result must have shape (%u, ...)", n_buffers);
+        return FALSE;
+    } else if (!PyArray_Check(result) && !PyList_Check(result) &&
+        !PyTuple_Check(result)) {
+        GST_ERROR_OBJECT(filter, "Batch result must be an array, list or tuple");
+        return FALSE;
+    } else if (PySequence_Size(result) != n_buffers) {
+        GST_ERROR_OBJECT(filter, "Batch result has %zd entries, expected %u",
+            PySequence_Size(result), n_buffers);
+        return FALSE;
+    }
+
+    for (idx = 0; idx < n_buffers; idx++) {
+        // For arrays this is a view of the idx-th slice, no copy is made.
+        PyObject* item = PySequence_GetItem(result, idx);
+        gboolean success = (item != NULL) &&
+            gst_tempy_numpy_to_output_buffer(filter, item, bufs[idx]);
+
+        Py_XDECREF(item);
+
+        if (!success) {
+            GST_ERROR_OBJECT(filter, "Failed to convert batch result %u", idx);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
 gboolean gst_tempy_process_dict(GstTemPy *filter, PyObject *dict, GstBuffer *buf) {
     // At the start of gst_tempy_process_dict
     GST_ERROR_OBJECT(filter, "=== PROCESS_DICT CALLED ===");
@@ -497,9 +827,21 @@ gboolean gst_tempy_process_numpy_array(GstTemPy *filter, PyObject *result, GstBu
 	}
 	
 	PyArrayObject* array = (PyArrayObject*)result;
+	GstTemPyMapping *mapping = gst_tempy_numpy_get_mapping(array);
+	gboolean inplace = FALSE;
+
+	// Result was written straight into the output memory, no copy needed.
+	if (mapping != NULL && mapping->memory != NULL &&
+	    gst_buffer_n_memory(buf) == 1 &&
+	    mapping->memory == gst_buffer_peek_memory(buf, 0) &&
+	    PyArray_DATA(array) == (void*)mapping->map.data &&
+	    PyArray_IS_C_CONTIGUOUS(array)) {
+		GST_TRACE_OBJECT(filter, "Result is backed by the output buffer");
+		inplace = TRUE;
+	}
 	
 	// Ensure contiguous
-	if (!PyArray_IS_C_CONTIGUOUS(array)) {
+	if (!inplace && !PyArray_IS_C_CONTIGUOUS(array)) {
 		array = (PyArrayObject*)PyArray_ContiguousFromAny(result, NPY_NOTYPE, 0, 0);
 		if (!array) return FALSE;
 	}
@@ -511,24 +853,37 @@ gboolean gst_tempy_process_numpy_array(GstTemPy *filter, PyObject *result, GstBu
 	
 	// Map and copy data (universal - works for any format)
 	GstMapInfo map;
-	if (!gst_buffer_map(buf, &map, GST_MAP_WRITE)) {
-		GST_ERROR_OBJECT(filter, "Failed to map output buffer");
-		goto error;
-	}
-	
 	gsize array_size = PyArray_NBYTES(array);
-	if (array_size <= map.size) {
-		memcpy(map.data, PyArray_DATA(array), array_size);
-		GST_DEBUG_OBJECT(filter, "Copied %zu bytes to %s buffer", array_size, media_type);
+	gpointer array_data = PyArray_DATA(array);
+	gboolean mapped = FALSE, copied = FALSE;
+
+	if (inplace) {
+		GST_DEBUG_OBJECT(filter, "Skipped copy of %zu bytes to %s buffer",
+			array_size, media_type);
 	} else {
-		GST_ERROR_OBJECT(filter, "Array too large: %zu bytes, buffer size: %zu", 
-			array_size, map.size);
-		gst_buffer_unmap(buf, &map);
-		goto error;
+		// The array is kept alive by our reference, no Python API is used
+		// until the GIL is taken back.
+		Py_BEGIN_ALLOW_THREADS
+		if ((mapped = gst_buffer_map(buf, &map, GST_MAP_WRITE))) {
+			if ((copied = (array_size <= map.size)))
+				memcpy(map.data, array_data, array_size);
+
+			gst_buffer_unmap(buf, &map);
+		}
+		Py_END_ALLOW_THREADS
+
+		if (!mapped) {
+			GST_ERROR_OBJECT(filter, "Failed to map output buffer");
+			goto error;
+		} else if (!copied) {
+			GST_ERROR_OBJECT(filter, "Array too large: %zu bytes, buffer size: %zu", 
+				array_size, map.size);
+			goto error;
+		}
+
+		GST_DEBUG_OBJECT(filter, "Copied %zu bytes to %s buffer", array_size, media_type);
 	}
 	
-	gst_buffer_unmap(buf, &map);
-	
 	// Smart metadata handling
 	if (g_str_has_prefix(media_type, "neural-network")) {
 		// Add tensor metadata
@@ -562,6 +917,16 @@ error:
 *******************************************************************************/
 void gst_tempy_cleanup_python(GstTemPy * filter)
 {
+  PyGILState_STATE gstate;
+
+  // Nothing to release if the interpreter was never brought up.
+  if (!Py_IsInitialized())
+    return;
+
+  gstate = PyGILState_Ensure();
+
+  Py_CLEAR(filter->numpy_stack);
+
   if (filter->python_function) {
 	  Py_DECREF(filter->python_function);
 	  filter->python_function = NULL;
@@ -571,6 +936,8 @@ void gst_tempy_cleanup_python(GstTemPy * filter)
 	  Py_DECREF(filter->python_module);
 	  filter->python_module = NULL;
   }
+
+  PyGILState_Release(gstate);
   
   filter->python_initialized = FALSE;
 }
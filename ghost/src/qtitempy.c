@@ -41,6 +41,13 @@ G_DEFINE_TYPE(GstTemPy, gst_tempy, GST_TYPE_BASE_TRANSFORM)
 // Default values
 #define DEFAULT_PYTHON_SCRIPT ""
 #define DEFAULT_PYTHON_FUNCTION "process_frame"
+#define DEFAULT_ZERO_COPY       FALSE
+#define DEFAULT_N_WORKERS       1
+#define DEFAULT_MAX_INFLIGHT    4
+#define MAX_WORKERS             64
+#define DEFAULT_BATCH_SIZE      1
+#define DEFAULT_BATCH_TIMEOUT   0
+#define MAX_BATCH_SIZE          256
 
 
 
@@ -116,6 +123,45 @@ static void gst_tempy_class_init(GstTemPyClass *klass)
           "Name of Python function to call for processing",
           DEFAULT_PYTHON_FUNCTION, (GParamFlags)(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 
+  g_object_class_install_property(gobject_class, PROP_ZERO_COPY,
+      g_param_spec_boolean("zero-copy", "Zero Copy",
+          "Wrap the mapped buffers in NumPy arrays instead of copying them. "
+          "The input array is read-only and the output buffer is exposed "
+          "as 'output_data', results backed by it are not copied again",
+          DEFAULT_ZERO_COPY, (GParamFlags)(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+  g_object_class_install_property(gobject_class, PROP_N_WORKERS,
+      g_param_spec_uint("n-workers", "Number of workers",
+          "Number of threads calling the Python function in parallel, "
+          "1 processes the buffers synchronously on the streaming thread",
+          1, MAX_WORKERS, DEFAULT_N_WORKERS,
+          (GParamFlags)(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+              GST_PARAM_MUTABLE_READY)));
+
+  g_object_class_install_property(gobject_class, PROP_MAX_INFLIGHT,
+      g_param_spec_uint("max-inflight", "Max in-flight buffers",
+          "Maximum number of buffers being processed by the workers at a "
+          "time, outputs are pushed in input order",
+          1, MAX_WORKERS * 4, DEFAULT_MAX_INFLIGHT,
+          (GParamFlags)(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+              GST_PARAM_MUTABLE_READY)));
+
+  g_object_class_install_property(gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint("batch-size", "Batch size",
+          "Maximum number of buffers passed to the Python function at once "
+          "as a stacked (N, ...) array, 1 disables batching",
+          1, MAX_BATCH_SIZE, DEFAULT_BATCH_SIZE,
+          (GParamFlags)(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+              GST_PARAM_MUTABLE_READY)));
+
+  g_object_class_install_property(gobject_class, PROP_BATCH_TIMEOUT,
+      g_param_spec_uint64("batch-timeout", "Batch timeout",
+          "Time in nanoseconds to wait for a batch to fill up after its first "
+          "buffer arrived before processing it partially, 0 waits for a full batch",
+          0, G_MAXUINT64, DEFAULT_BATCH_TIMEOUT,
+          (GParamFlags)(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+              GST_PARAM_MUTABLE_READY)));
+
   // Add pad templates
   gst_element_class_add_static_pad_template (gstelement_class, &src_factory);
   gst_element_class_add_static_pad_template (gstelement_class, &sink_factory);
@@ -131,6 +177,9 @@ static void gst_tempy_class_init(GstTemPyClass *klass)
   
   
   base_class->transform = GST_DEBUG_FUNCPTR (gst_tempy_transform);
+  base_class->submit_input_buffer = GST_DEBUG_FUNCPTR (gst_tempy_submit_input_buffer);
+  base_class->generate_output = GST_DEBUG_FUNCPTR (gst_tempy_generate_output);
+  base_class->sink_event = GST_DEBUG_FUNCPTR (gst_tempy_sink_event);
   
 }
 
@@ -147,6 +196,13 @@ static void gst_tempy_init(GstTemPy *self) {
   self->python_initialized = FALSE;
   self->python_script_path = g_strdup (DEFAULT_PYTHON_SCRIPT);
   self->python_function_name = g_strdup (DEFAULT_PYTHON_FUNCTION);
+  self->zero_copy = DEFAULT_ZERO_COPY;
+  self->n_workers = DEFAULT_N_WORKERS;
+  self->max_inflight = DEFAULT_MAX_INFLIGHT;
+  self->batch_size = DEFAULT_BATCH_SIZE;
+  self->batch_timeout = DEFAULT_BATCH_TIMEOUT;
+  self->workers = NULL;
+  self->batcher = NULL;
   self->pixlayout = DEFAULT_PROP_SUBPIXEL_LAYOUT;
 
 
@@ -0,0 +1,239 @@
+#include "workerpool.h"
+#include "qtitempy.h"
+
+#define GST_CAT_DEFAULT gst_tempy_debug
+
+typedef struct _GstTemPyTask GstTemPyTask;
+
+struct _GstTemPyTask {
+  GstBuffer     *inbuf;
+  GstBuffer     *outbuf;
+  GstFlowReturn ret;
+  gboolean      done;
+};
+
+struct _GstTemPyWorkerPool {
+  GstTemPy    *filter;
+
+  // Threads executing the Python function.
+  GThreadPool *threads;
+
+  // Protects the tasks queue and the flushing flag.
+  GMutex      lock;
+  // Signalled when a task completes or the pool starts flushing.
+  GCond       wakeup;
+
+  // Submitted tasks in submission (PTS) order, the reorder window.
+  GQueue      *tasks;
+  guint       max_inflight;
+
+  gboolean    flushing;
+};
+
+static void
+gst_tempy_task_free (GstTemPyTask * task)
+{
+  gst_buffer_unref (task->inbuf);
+
+  if (task->outbuf != NULL)
+    gst_buffer_unref (task->outbuf);
+
+  g_slice_free (GstTemPyTask, task);
+}
+
+static void
+gst_tempy_worker_pool_execute (gpointer data, gpointer userdata)
+{
+  GstTemPyTask *task = data;
+  GstTemPyWorkerPool *pool = userdata;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  ret = gst_tempy_process_buffer (pool->filter, task->inbuf, task->outbuf);
+
+  g_mutex_lock (&pool->lock);
+
+  task->ret = ret;
+  task->done = TRUE;
+
+  g_cond_broadcast (&pool->wakeup);
+  g_mutex_unlock (&pool->lock);
+}
+
+GstTemPyWorkerPool *
+gst_tempy_worker_pool_new (GstTemPy * filter, guint n_workers,
+    guint max_inflight)
+{
+  GstTemPyWorkerPool *pool = NULL;
+  GError *error = NULL;
+
+  pool = g_slice_new0 (GstTemPyWorkerPool);
+
+  g_mutex_init (&pool->lock);
+  g_cond_init (&pool->wakeup);
+
+  pool->filter = filter;
+  pool->tasks = g_queue_new ();
+  // Window smaller than the number of workers would leave them idle.
+  pool->max_inflight = MAX (max_inflight, n_workers);
+  pool->flushing = FALSE;
+
+  pool->threads = g_thread_pool_new (gst_tempy_worker_pool_execute, pool,
+      n_workers, TRUE, &error);
+
+  if (pool->threads == NULL) {
+    GST_ERROR_OBJECT (filter, "Failed to create %u workers, error: '%s'!",
+        n_workers, GST_STR_NULL (error->message));
+    g_clear_error (&error);
+
+    gst_tempy_worker_pool_free (pool);
+    return NULL;
+  }
+
+  GST_INFO_OBJECT (filter, "Created %u workers with %u in-flight buffers",
+      n_workers, pool->max_inflight);
+  return pool;
+}
+
+void
+gst_tempy_worker_pool_free (GstTemPyWorkerPool * pool)
+{
+  // Drop the pending tasks and wait for the running ones to complete.
+  if (pool->threads != NULL)
+    g_thread_pool_free (pool->threads, TRUE, TRUE);
+
+  g_queue_free_full (pool->tasks, (GDestroyNotify) gst_tempy_task_free);
+
+  g_cond_clear (&pool->wakeup);
+  g_mutex_clear (&pool->lock);
+
+  g_slice_free (GstTemPyWorkerPool, pool);
+}
+
+GstFlowReturn
+gst_tempy_worker_pool_submit (GstTemPyWorkerPool * pool, GstBuffer * inbuf,
+    GstBuffer * outbuf)
+{
+  GstTemPyTask *task = NULL;
+  GError *error = NULL;
+
+  task = g_slice_new0 (GstTemPyTask);
+  task->inbuf = inbuf;
+  task->outbuf = outbuf;
+  task->ret = GST_FLOW_OK;
+  task->done = FALSE;
+
+  g_mutex_lock (&pool->lock);
+
+  if (pool->flushing) {
+    g_mutex_unlock (&pool->lock);
+    gst_tempy_task_free (task);
+    return GST_FLOW_FLUSHING;
+  }
+
+  g_queue_push_tail (pool->tasks, task);
+  g_mutex_unlock (&pool->lock);
+
+  if (!g_thread_pool_push (pool->threads, task, &error)) {
+    GST_ERROR_OBJECT (pool->filter, "Failed to submit buffer, error: '%s'!",
+        GST_STR_NULL (error->message));
+    g_clear_error (&error);
+
+    g_mutex_lock (&pool->lock);
+    task->ret = GST_FLOW_ERROR;
+    task->done = TRUE;
+    g_mutex_unlock (&pool->lock);
+  }
+
+  return GST_FLOW_OK;
+}
+
+GstFlowReturn
+gst_tempy_worker_pool_pop (GstTemPyWorkerPool * pool, GstBuffer ** outbuf)
+{
+  GstTemPyTask *task = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  *outbuf = NULL;
+
+  g_mutex_lock (&pool->lock);
+
+  // In-flight window is full, wait for the oldest buffer to be processed.
+  while (!pool->flushing &&
+      (task = g_queue_peek_head (pool->tasks)) != NULL && !task->done &&
+      (g_queue_get_length (pool->tasks) >= pool->max_inflight))
+    g_cond_wait (&pool->wakeup, &pool->lock);
+
+  if (pool->flushing) {
+    g_mutex_unlock (&pool->lock);
+    return GST_FLOW_FLUSHING;
+  }
+
+  task = g_queue_peek_head (pool->tasks);
+
+  if ((task != NULL) && task->done)
+    g_queue_pop_head (pool->tasks);
+  else
+    task = NULL;
+
+  g_mutex_unlock (&pool->lock);
+
+  if (task == NULL)
+    return GST_FLOW_OK;
+
+  if ((ret = task->ret) == GST_FLOW_OK) {
+    *outbuf = task->outbuf;
+    task->outbuf = NULL;
+  }
+
+  gst_tempy_task_free (task);
+  return ret;
+}
+
+GstFlowReturn
+gst_tempy_worker_pool_drain (GstTemPyWorkerPool * pool, gboolean push)
+{
+  GstPad *srcpad = GST_BASE_TRANSFORM_SRC_PAD (pool->filter);
+  GstTemPyTask *task = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  g_mutex_lock (&pool->lock);
+
+  while ((task = g_queue_peek_head (pool->tasks)) != NULL) {
+    // Tasks already handed to the workers cannot be cancelled, wait for them.
+    while (!task->done)
+      g_cond_wait (&pool->wakeup, &pool->lock);
+
+    g_queue_pop_head (pool->tasks);
+    g_mutex_unlock (&pool->lock);
+
+    if (push && (ret == GST_FLOW_OK) && (task->ret != GST_FLOW_OK))
+      ret = task->ret;
+
+    if (push && (ret == GST_FLOW_OK)) {
+      ret = gst_pad_push (srcpad, task->outbuf);
+      task->outbuf = NULL;
+    }
+
+    gst_tempy_task_free (task);
+    g_mutex_lock (&pool->lock);
+  }
+
+  g_cond_broadcast (&pool->wakeup);
+  g_mutex_unlock (&pool->lock);
+
+  GST_DEBUG_OBJECT (pool->filter, "Drained workers, %s",
+      push ? gst_flow_get_name (ret) : "dropped");
+  return ret;
+}
+
+void
+gst_tempy_worker_pool_set_flushing (GstTemPyWorkerPool * pool,
+    gboolean flushing)
+{
+  g_mutex_lock (&pool->lock);
+
+  pool->flushing = flushing;
+  g_cond_broadcast (&pool->wakeup);
+
+  g_mutex_unlock (&pool->lock);
+}
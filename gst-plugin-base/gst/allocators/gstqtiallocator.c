@@ -9,39 +9,79 @@
 
 #include "gstqtiallocator.h"
 
-#include <fcntl.h>
-#include <unistd.h>
-#include <sys/ioctl.h>
-#ifdef HAVE_LINUX_DMA_HEAP_H
-#include <linux/dma-heap.h>
-#else
-#include <linux/ion.h>
-#include <linux/msm_ion.h>
-#endif // HAVE_LINUX_DMA_HEAP_H
-
-#define DEFAULT_PAGE_ALIGNMENT 4096
+#include <stdatomic.h>
+#include <gst/memory/gstdmaarena.h>
+
+// Maximum number of different memory block sizes which can be recycled.
+#define GST_QTI_N_SIZE_CLASSES    8
+// Maximum number of recycled memory blocks per size class.
+#define GST_QTI_FREELIST_CAPACITY 256
+
+// Size class placeholder while its freelist is being initialized.
+#define GST_QTI_SIZE_CLASS_BUSY   G_MAXSIZE
+
+// The head of a freelist stack is a 1-based node index in the lower 32 bits
+// and a modification tag in the upper 32 bits protecting against ABA.
+#define GST_QTI_STACK_INDEX(head) ((guint32) ((head) & G_MAXUINT32))
+#define GST_QTI_STACK_HEAD(head, index) \
+    ((((head) >> 32) + 1) << 32 | (guint64) (index))
 
 GST_DEBUG_CATEGORY_STATIC (gst_qtiallocator_debug);
 #define GST_CAT_DEFAULT gst_qtiallocator_debug
 
+typedef struct _GstQtiFreeNode GstQtiFreeNode;
+typedef struct _GstQtiSizeClass GstQtiSizeClass;
+
+struct _GstQtiFreeNode
+{
+  // Recycled memory block, valid only while the node is in the used stack.
+  GstMemory        *memory;
+  // 1-based index of the next node in the stack or 0 if this is the last one.
+  _Atomic guint32  next;
+};
+
+struct _GstQtiSizeClass
+{
+  // Maximum size of the memory blocks in this class, 0 if class is unused.
+  // Classes are released when the allocator is stopped.
+  _Atomic gsize    size;
+
+  // Statically sized array of nodes, allocated when the class is first
+  // claimed and kept for reuse after the class is released.
+  GstQtiFreeNode   *nodes;
+
+  // Lock-free stacks (Treiber) of nodes holding recycled memory blocks and
+  // of spare nodes available for recycling more memory blocks.
+  _Atomic guint64  used;
+  _Atomic guint64  spare;
+};
+
 struct _GstQtiAllocatorPrivate
 {
-  // DMA/ION device FD
-  gint             devfd;
   GstFdMemoryFlags memflags;
 
-  // Mutex for protecting insert/remove from the data map and memory queue.
+  // Mutex for waiting on free memory blocks.
   GMutex           lock;
-  // Map of data FDs and ION handles on case ION memory is used.
-  GHashTable       *datamap;
+  // Condition signaled when a memory block is recycled or freed.
+  GCond            wakeup;
+  // Number of threads waiting on the wakeup condition.
+  _Atomic guint    n_waiters;
 
   // Total number of allocated memory blocks.
-  guint            n_allocated_memory;
+  _Atomic guint    n_allocated_memory;
   // Maximum number of allocated memory blocks, set via the start() API.
-  guint            max_memory_blocks;
-  // Queue of memory blocks which have been orphaned when stolen and then returned.
-  // Initialized when the start() API is called and used in conjunction with a pool.
-  GstDataQueue     *mem_queue;
+  _Atomic guint    max_memory_blocks;
+
+  // Whether orphaned memory blocks are recycled, set via the start() API.
+  // Used in conjunction with a pool, memory blocks which have been stolen and
+  // then returned are placed in the freelist of their size class.
+  _Atomic gboolean active;
+  GstQtiSizeClass  sclasses[GST_QTI_N_SIZE_CLASSES];
+
+  // Statistics, reset when the start() API is called.
+  _Atomic guint64  n_hits;
+  _Atomic guint64  n_misses;
+  _Atomic guint    high_water;
 };
 
 #define parent_class gst_qti_allocator_parent_class
@@ -49,29 +89,195 @@ struct _GstQtiAllocatorPrivate
 G_DEFINE_TYPE_WITH_PRIVATE (GstQtiAllocator, gst_qti_allocator,
     GST_TYPE_DMABUF_ALLOCATOR);
 
-static gboolean
-gst_data_queue_is_full_cb (GstDataQueue * queue, guint visible, guint bytes,
-    guint64 time, gpointer checkdata)
+static inline guint32
+gst_qti_stack_pop (_Atomic guint64 * stack, GstQtiFreeNode * nodes)
 {
-  GstQtiAllocator *qtiallocator = (GstQtiAllocator *) checkdata;
-  GstQtiAllocatorPrivate *priv = qtiallocator->priv;
+  guint64 head = atomic_load (stack), newhead = 0;
+  guint32 index = 0;
 
-  if ((priv->max_memory_blocks) != 0 && (visible >= priv->max_memory_blocks)) {
-    GST_TRACE_OBJECT (qtiallocator, "Reached queue limit of %d blocks!",
-        priv->max_memory_blocks);
-    return TRUE;
+  do {
+    if ((index = GST_QTI_STACK_INDEX (head)) == 0)
+      return 0;
+
+    // Node may already be popped by another thread, in which case the tag
+    // will have changed and the exchange below will fail.
+    newhead = GST_QTI_STACK_HEAD (head, atomic_load (&(nodes[index - 1].next)));
+  } while (!atomic_compare_exchange_weak (stack, &head, newhead));
+
+  return index;
+}
+
+static inline void
+gst_qti_stack_push (_Atomic guint64 * stack, GstQtiFreeNode * nodes,
+    guint32 index)
+{
+  guint64 head = atomic_load (stack), newhead = 0;
+
+  do {
+    atomic_store (&(nodes[index - 1].next), GST_QTI_STACK_INDEX (head));
+    newhead = GST_QTI_STACK_HEAD (head, index);
+  } while (!atomic_compare_exchange_weak (stack, &head, newhead));
+}
+
+static GstQtiSizeClass *
+gst_qti_allocator_get_size_class (GstQtiAllocatorPrivate * priv, gsize size,
+    gboolean create)
+{
+  GstQtiSizeClass *sclass = NULL;
+  gsize current = 0, expected = 0;
+  guint idx = 0, num = 0;
+
+  for (idx = 0; idx < GST_QTI_N_SIZE_CLASSES; idx++) {
+    sclass = &(priv->sclasses[idx]);
+
+    do {
+      // Class is being initialized by another thread, possibly for the same
+      // size. Wait for its size instead of skipping it, otherwise two classes
+      // may end up holding the same size.
+      while ((current = atomic_load (&(sclass->size))) ==
+                 GST_QTI_SIZE_CLASS_BUSY)
+        g_thread_yield ();
+
+      if (current == size)
+        return sclass;
+
+      expected = 0;
+
+      // Claim the first unused class, it will be visible once initialized.
+      // If another thread claimed it first re-read its size.
+    } while (create && (current == 0) && !atomic_compare_exchange_strong (
+        &(sclass->size), &expected, GST_QTI_SIZE_CLASS_BUSY));
+
+    if (!create || (current != 0))
+      continue;
+
+    // A released class was drained, all of its nodes are already spare.
+    if (sclass->nodes == NULL) {
+      sclass->nodes = g_new0 (GstQtiFreeNode, GST_QTI_FREELIST_CAPACITY);
+
+      for (num = 0; num < GST_QTI_FREELIST_CAPACITY; num++)
+        atomic_store (&(sclass->nodes[num].next),
+            ((num + 1) < GST_QTI_FREELIST_CAPACITY) ? (num + 2) : 0);
+
+      atomic_store (&(sclass->used), 0);
+      atomic_store (&(sclass->spare), 1);
+    }
+
+    atomic_store (&(sclass->size), size);
+    return sclass;
   }
 
-  return FALSE;
+  return NULL;
+}
+
+static gboolean
+gst_qti_size_class_push (GstQtiSizeClass * sclass, GstMemory * memory)
+{
+  guint32 index = gst_qti_stack_pop (&(sclass->spare), sclass->nodes);
+
+  // Freelist has reached its capacity.
+  if (index == 0)
+    return FALSE;
+
+  sclass->nodes[index - 1].memory = memory;
+  gst_qti_stack_push (&(sclass->used), sclass->nodes, index);
+
+  return TRUE;
+}
+
+static GstMemory *
+gst_qti_size_class_pop (GstQtiSizeClass * sclass)
+{
+  GstMemory *memory = NULL;
+  guint32 index = gst_qti_stack_pop (&(sclass->used), sclass->nodes);
+
+  if (index == 0)
+    return NULL;
+
+  memory = g_steal_pointer (&(sclass->nodes[index - 1].memory));
+  gst_qti_stack_push (&(sclass->spare), sclass->nodes, index);
+
+  return memory;
 }
 
 static void
-gst_data_queue_free_item (gpointer userdata)
+gst_qti_size_class_drain (GstQtiSizeClass * sclass)
+{
+  GstMemory *memory = NULL;
+
+  // Free the memory blocks instead of recycling them again.
+  while ((memory = gst_qti_size_class_pop (sclass)) != NULL) {
+    memory->mini_object.dispose = NULL;
+    gst_memory_unref (memory);
+  }
+}
+
+static void
+gst_qti_allocator_wakeup (GstQtiAllocatorPrivate * priv)
+{
+  if (atomic_load (&(priv->n_waiters)) == 0)
+    return;
+
+  g_mutex_lock (&priv->lock);
+  g_cond_broadcast (&priv->wakeup);
+  g_mutex_unlock (&priv->lock);
+}
+
+static gboolean
+gst_qti_allocator_is_exhausted (GstQtiAllocatorPrivate * priv)
+{
+  guint max_memory_blocks = atomic_load (&(priv->max_memory_blocks));
+
+  return atomic_load (&(priv->active)) && (max_memory_blocks != 0) &&
+      (atomic_load (&(priv->n_allocated_memory)) >= max_memory_blocks);
+}
+
+static gboolean
+gst_qti_allocator_reserve (GstQtiAllocatorPrivate * priv)
+{
+  guint n_allocated = atomic_load (&(priv->n_allocated_memory));
+  guint high_water = 0;
+
+  do {
+    if (gst_qti_allocator_is_exhausted (priv))
+      return FALSE;
+  } while (!atomic_compare_exchange_weak (&(priv->n_allocated_memory),
+      &n_allocated, n_allocated + 1));
+
+  high_water = atomic_load (&(priv->high_water));
+
+  while ((n_allocated + 1) > high_water &&
+      !atomic_compare_exchange_weak (&(priv->high_water), &high_water,
+          n_allocated + 1));
+
+  return TRUE;
+}
+
+static gboolean
+gst_qti_allocator_evict (GstQtiAllocatorPrivate * priv,
+    GstQtiSizeClass * exclude)
 {
-  GstDataQueueItem *item = userdata;
+  GstMemory *memory = NULL;
+  guint idx = 0;
+
+  for (idx = 0; idx < GST_QTI_N_SIZE_CLASSES && memory == NULL; idx++) {
+    GstQtiSizeClass *sclass = &(priv->sclasses[idx]);
+    gsize size = atomic_load (&(sclass->size));
+
+    if ((sclass == exclude) || (size == 0) || (size == GST_QTI_SIZE_CLASS_BUSY))
+      continue;
+
+    memory = gst_qti_size_class_pop (sclass);
+  }
 
-  gst_memory_unref (GST_MEMORY_CAST (item->object));
-  g_slice_free (GstDataQueueItem, item);
+  if (memory == NULL)
+    return FALSE;
+
+  // Free the memory block instead of recycling it again.
+  memory->mini_object.dispose = NULL;
+  gst_memory_unref (memory);
+
+  return TRUE;
 }
 
 static gboolean
@@ -80,23 +286,30 @@ gst_qti_allocator_memory_dispose (GstMiniObject * obj)
   GstMemory *memory = GST_MEMORY_CAST (obj);
   GstQtiAllocator *qtiallocator = (GstQtiAllocator *) memory->allocator;
   GstQtiAllocatorPrivate *priv = qtiallocator->priv;
-  GstDataQueueItem *item = NULL;
+  GstQtiSizeClass *sclass = NULL;
 
-  // If memory queue was deinitialized then directly free the memory block.
-  if (priv->mem_queue == NULL)
+  // If allocator was stopped then directly free the memory block.
+  if (!atomic_load (&(priv->active)))
     return TRUE;
 
-  item = g_slice_new0 (GstDataQueueItem);
-  item->object = GST_MINI_OBJECT (gst_memory_ref (memory));
-  item->visible = TRUE;
-  item->destroy = gst_data_queue_free_item;
+  sclass = gst_qti_allocator_get_size_class (priv, memory->maxsize, FALSE);
 
-  if (!gst_data_queue_push (priv->mem_queue, item)) {
-    item->destroy (item);
+  // The reference is owned by the freelist until the block is reused.
+  if ((sclass == NULL) || !gst_qti_size_class_push (sclass,
+          gst_memory_ref (memory)))
     return TRUE;
+
+  // Allocator was stopped or the class released in the meantime, the freelist
+  // may be already drained.
+  if (!atomic_load (&(priv->active)) ||
+      (atomic_load (&(sclass->size)) != memory->maxsize)) {
+    gst_qti_size_class_drain (sclass);
+    return FALSE;
   }
 
-  GST_LOG_OBJECT (qtiallocator, "Memory %p enqueued back to queue", memory);
+  GST_LOG_OBJECT (qtiallocator, "Memory %p returned to freelist", memory);
+
+  gst_qti_allocator_wakeup (priv);
   return FALSE;
 }
 
@@ -106,96 +319,71 @@ gst_qti_allocator_alloc (GstAllocator * allocator, gsize size,
 {
   GstQtiAllocator *qtiallocator = GST_QTI_ALLOCATOR (allocator);
   GstQtiAllocatorPrivate *priv = qtiallocator->priv;
+  GstQtiSizeClass *sclass = NULL;
   GstMemory *memory = NULL;
-#if defined(HAVE_LINUX_DMA_HEAP_H)
-  struct dma_heap_allocation_data alloc_data;
-#else // !defined(HAVE_LINUX_DMA_HEAP_H)
-  struct ion_allocation_data alloc_data;
-#if !defined(TARGET_ION_ABI_VERSION)
-  struct ion_fd_data fd_data;
-#endif // !defined(TARGET_ION_ABI_VERSION)
-#endif // defined(HAVE_LINUX_DMA_HEAP_H)
   GstMapInfo mapinfo = {0,};
   gsize maxsize = 0;
-  gint result = 0, fd = -1;
+  gint fd = -1;
 
-  g_mutex_lock (&priv->lock);
+  maxsize = size + params->prefix + params->padding;
 
-  // Check if there is a memory queue and an available memory block in it.
-  if (priv->mem_queue != NULL && (!gst_data_queue_is_empty (priv->mem_queue) ||
-          ((priv->max_memory_blocks != 0) &&
-              (priv->n_allocated_memory == priv->max_memory_blocks)))) {
-    GstDataQueueItem *item = NULL;
+  if (params->align > 0)
+    maxsize = GST_ROUND_UP_N (maxsize, params->align);
 
-    if (priv->n_allocated_memory == priv->max_memory_blocks)
-      GST_LOG_OBJECT (qtiallocator, "Wait for free memory");
+  if (atomic_load (&(priv->active)))
+    sclass = gst_qti_allocator_get_size_class (priv, maxsize, TRUE);
 
-    if (gst_data_queue_pop (priv->mem_queue, &item)) {
-      memory = gst_memory_ref (GST_MEMORY_CAST (item->object));
-      item->destroy (item);
-    }
+  // Check if there is an available memory block in the freelist.
+  if (sclass != NULL)
+    memory = gst_qti_size_class_pop (sclass);
+
+  while ((memory == NULL) && !gst_qti_allocator_reserve (priv)) {
+    // Limit is reached, free blocks recycled for other sizes if there are any.
+    if (gst_qti_allocator_evict (priv, sclass))
+      continue;
+
+    GST_LOG_OBJECT (qtiallocator, "Wait for free memory");
+
+    g_mutex_lock (&priv->lock);
+    atomic_fetch_add (&(priv->n_waiters), 1);
+
+    // Check again after registering as waiter in order to not miss a wakeup.
+    if (sclass != NULL)
+      memory = gst_qti_size_class_pop (sclass);
+
+    if ((memory == NULL) && gst_qti_allocator_is_exhausted (priv))
+      g_cond_wait (&priv->wakeup, &priv->lock);
+
+    atomic_fetch_sub (&(priv->n_waiters), 1);
+    g_mutex_unlock (&priv->lock);
+
+    if ((memory == NULL) && (sclass != NULL))
+      memory = gst_qti_size_class_pop (sclass);
   }
 
   // Found an available memory block, return it immediately.
   if (memory != NULL) {
+    atomic_fetch_add (&(priv->n_hits), 1);
     GST_LOG_OBJECT (qtiallocator, "Reusing preallocated memory %p", memory);
-    goto cleanup;
+    return memory;
   }
 
   // Couldn't find an available memory block, allocate a new one.
-  maxsize = size + params->prefix + params->padding;
+  atomic_fetch_add (&(priv->n_misses), 1);
 
-  if (params->align > 0)
-    maxsize = GST_ROUND_UP_N (maxsize, params->align);
-
-  alloc_data.fd = 0;
-  alloc_data.len = maxsize;
-
-#if defined(HAVE_LINUX_DMA_HEAP_H)
-  // Permissions for the memory to be allocated.
-  alloc_data.fd_flags = O_RDWR | O_CLOEXEC;
-  alloc_data.heap_flags = 0;
-#else // !defined(HAVE_LINUX_DMA_HEAP_H)
-  alloc_data.heap_id_mask = ION_HEAP(ION_SYSTEM_HEAP_ID);
-  alloc_data.flags = ION_FLAG_CACHED;
-
-#if !defined(TARGET_ION_ABI_VERSION)
-  alloc_data.align = DEFAULT_PAGE_ALIGNMENT;
-#endif // !defined(TARGET_ION_ABI_VERSION)
-#endif // defined(HAVE_LINUX_DMA_HEAP_H)
-
-#if defined(HAVE_LINUX_DMA_HEAP_H)
-  result = ioctl (priv->devfd, DMA_HEAP_IOCTL_ALLOC, &alloc_data);
-#else // !defined(HAVE_LINUX_DMA_HEAP_H)
-  result = ioctl (priv->devfd, ION_IOC_ALLOC, &alloc_data);
-#endif // defined(HAVE_LINUX_DMA_HEAP_H)
-
-  if (result != 0) {
-    GST_ERROR_OBJECT (qtiallocator, "Failed to allocate memory on device fd: "
-        "%d, error: %s", priv->devfd, g_strerror (errno));
-    goto cleanup;
-  }
-
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  fd_data.handle = alloc_data.handle;
-  result = ioctl (priv->devfd, ION_IOC_MAP, &fd_data);
+  // Memory blocks are taken from the process wide arena, shared with pools.
+  fd = gst_dma_arena_alloc (GST_DMA_ARENA_HEAP_SYSTEM, maxsize,
+      GST_OBJECT_NAME (qtiallocator));
 
-  if (result != 0) {
-    GST_ERROR_OBJECT (qtiallocator, "Failed to map ION memory on device fd: "
-        "%d, error: %s", priv->devfd, g_strerror (errno));
-    ioctl (priv->devfd, ION_IOC_FREE, &alloc_data.handle);
+  if (fd < 0) {
+    GST_ERROR_OBJECT (qtiallocator, "Failed to allocate memory of size %"
+        G_GSIZE_FORMAT, maxsize);
     goto cleanup;
   }
 
-  fd = fd_data.fd;
-
-  g_hash_table_insert (priv->datamap, GINT_TO_POINTER (fd),
-      GSIZE_TO_POINTER (alloc_data.handle));
-#else
-  fd = alloc_data.fd;
-#endif // TARGET_ION_ABI_VERSION
-
-  memory = gst_fd_allocator_alloc (allocator, fd, maxsize, priv->memflags);
+  // The FD is owned by the arena and must not be closed together with memory.
+  memory = gst_fd_allocator_alloc (allocator, fd, maxsize,
+      priv->memflags | GST_FD_MEMORY_FLAG_DONT_CLOSE);
   GST_MINI_OBJECT_FLAG_SET (memory, params->flags);
 
   GST_DEBUG_OBJECT (qtiallocator, "Allocated memory %p of size %" G_GSIZE_FORMAT
@@ -203,34 +391,42 @@ gst_qti_allocator_alloc (GstAllocator * allocator, gsize size,
       ", padding %" G_GSIZE_FORMAT, memory, maxsize, fd, params->flags,
       params->align, params->prefix, params->padding);
 
-  // TODO: As a precaution map the memory as READ/WRITE when keep_mapped flag
-  // is set to avoid case where the memory is mapped with READ only access
-  // initially and later on it cannot be mapped with WRITE access.
-  if (!gst_memory_map (memory, &mapinfo, GST_MAP_READWRITE)) {
-    GST_ERROR_OBJECT (qtiallocator, "Failed to map memory %p", memory);
-    gst_memory_unref (memory);
-    return NULL;
-  }
+  // Map the memory only when it needs to be zeroed or when keep_mapped flag is
+  // set. In the latter case as a precaution map it as READ/WRITE to avoid case
+  // where the memory is mapped with READ only access initially and later on it
+  // cannot be mapped with WRITE access.
+  if ((priv->memflags & GST_FD_MEMORY_FLAG_KEEP_MAPPED) ||
+      (params->prefix && (params->flags & GST_MEMORY_FLAG_ZERO_PREFIXED)) ||
+      (params->padding && (params->flags & GST_MEMORY_FLAG_ZERO_PADDED))) {
+    if (!gst_memory_map (memory, &mapinfo, GST_MAP_READWRITE)) {
+      GST_ERROR_OBJECT (qtiallocator, "Failed to map memory %p", memory);
+      gst_memory_unref (memory);
+      return NULL;
+    }
 
-  if (params->prefix && (params->flags & GST_MEMORY_FLAG_ZERO_PREFIXED))
-    memset (mapinfo.data, 0, params->prefix);
+    if (params->prefix && (params->flags & GST_MEMORY_FLAG_ZERO_PREFIXED))
+      memset (mapinfo.data, 0, params->prefix);
 
-  if (params->padding && (params->flags & GST_MEMORY_FLAG_ZERO_PADDED))
-    memset (mapinfo.data + params->prefix + size, 0, params->padding);
+    if (params->padding && (params->flags & GST_MEMORY_FLAG_ZERO_PADDED))
+      memset (mapinfo.data + params->prefix + size, 0, params->padding);
 
-  gst_memory_unmap (memory, &mapinfo);
+    gst_memory_unmap (memory, &mapinfo);
+  }
 
-  if (priv->mem_queue != NULL) {
+  if (sclass != NULL) {
     g_return_val_if_fail (memory->mini_object.dispose == NULL, NULL);
     memory->mini_object.dispose = (GstMiniObjectDisposeFunction)
         gst_qti_allocator_memory_dispose;
   }
 
-  priv->n_allocated_memory++;
+  return memory;
 
 cleanup:
-  g_mutex_unlock (&priv->lock);
-  return memory;
+  // Release the reservation made for the memory block.
+  atomic_fetch_sub (&(priv->n_allocated_memory), 1);
+  gst_qti_allocator_wakeup (priv);
+
+  return NULL;
 }
 
 static void
@@ -240,24 +436,15 @@ gst_qti_allocator_free (GstAllocator * allocator, GstMemory * memory)
   GstQtiAllocatorPrivate *priv = qtiallocator->priv;
   gint fd = gst_fd_memory_get_fd (memory);
 
-  GST_DEBUG_OBJECT (qtiallocator, "Closing memory %p with FD %d", memory, fd);
-
-  g_mutex_lock (&priv->lock);
-
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  ion_user_handle_t handle = GPOINTER_TO_SIZE (
-      g_hash_table_lookup (priv->datamap, GINT_TO_POINTER (fd)));
+  GST_DEBUG_OBJECT (qtiallocator, "Releasing memory %p with FD %d", memory, fd);
 
-  if (ioctl (priv->devfd, ION_IOC_FREE, &handle) < 0)
-    GST_ERROR_OBJECT (qtiallocator, "Failed to free handle for memory FD %d!", fd);
+  GST_ALLOCATOR_CLASS (parent_class)->free (allocator, memory);
 
-  g_hash_table_remove (priv->datamap, GINT_TO_POINTER (fd));
-#endif // TARGET_ION_ABI_VERSION
+  // Return the memory block to the arena, it may be reused by other elements.
+  gst_dma_arena_free (fd);
 
-  close (fd);
-  priv->n_allocated_memory--;
-
-  g_mutex_unlock (&priv->lock);
+  atomic_fetch_sub (&(priv->n_allocated_memory), 1);
+  gst_qti_allocator_wakeup (priv);
 }
 
 static void
@@ -265,17 +452,12 @@ gst_qti_allocator_finalize (GObject * obj)
 {
   GstQtiAllocator *qtiallocator = GST_QTI_ALLOCATOR (obj);
   GstQtiAllocatorPrivate *priv = qtiallocator->priv;
+  guint idx = 0;
 
-  if (priv->devfd >= 0) {
-    GST_INFO_OBJECT (qtiallocator, "Closing device FD %d", priv->devfd);
-    close (priv->devfd);
-  }
-
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  if (priv->datamap != NULL)
-    g_hash_table_destroy (priv->datamap);
-#endif // TARGET_ION_ABI_VERSION
+  for (idx = 0; idx < GST_QTI_N_SIZE_CLASSES; idx++)
+    g_free (priv->sclasses[idx].nodes);
 
+  g_cond_clear (&priv->wakeup);
   g_mutex_clear (&priv->lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (obj);
@@ -303,11 +485,16 @@ gst_qti_allocator_init (GstQtiAllocator * qtiallocator)
       gst_qti_allocator_get_instance_private (qtiallocator);
 
   g_mutex_init (&(qtiallocator->priv->lock));
+  g_cond_init (&(qtiallocator->priv->wakeup));
+
+  atomic_init (&(qtiallocator->priv->n_waiters), 0);
+  atomic_init (&(qtiallocator->priv->n_allocated_memory), 0);
+  atomic_init (&(qtiallocator->priv->max_memory_blocks), 0);
+  atomic_init (&(qtiallocator->priv->active), FALSE);
 
-  qtiallocator->priv->devfd = -1;
-  qtiallocator->priv->datamap = NULL;
-  qtiallocator->priv->mem_queue = NULL;
-  qtiallocator->priv->max_memory_blocks = 0;
+  atomic_init (&(qtiallocator->priv->n_hits), 0);
+  atomic_init (&(qtiallocator->priv->n_misses), 0);
+  atomic_init (&(qtiallocator->priv->high_water), 0);
 
   GST_OBJECT_FLAG_SET (qtiallocator, GST_ALLOCATOR_FLAG_CUSTOM_ALLOC);
 }
@@ -324,32 +511,12 @@ gst_qti_allocator_new (GstFdMemoryFlags memflags)
   priv = allocator->priv;
   priv->memflags = memflags;
 
-  GST_INFO_OBJECT (allocator, "Open /dev/dma_heap/qcom,system");
-  priv->devfd = open ("/dev/dma_heap/qcom,system", O_RDONLY | O_CLOEXEC);
-
-  if (priv->devfd < 0) {
-    GST_WARNING_OBJECT (allocator, "Failed to open /dev/dma_heap/qcom,system, "
-        "error: %s! Falling back to /dev/dma_heap/system", g_strerror (errno));
-    priv->devfd = open ("/dev/dma_heap/system", O_RDONLY | O_CLOEXEC);
-  }
-
-  if (priv->devfd < 0) {
-    GST_WARNING_OBJECT (allocator, "Failed to open /dev/dma_heap/system, "
-        "error: %s! Falling back to /dev/ion", g_strerror (errno));
-    priv->devfd = open ("/dev/ion", O_RDONLY | O_CLOEXEC);
-  }
-
-  if (priv->devfd < 0) {
-    GST_ERROR_OBJECT (allocator, "Failed to open DMA/ION device FD, error: %s!",
-        g_strerror (errno));
+  if (!gst_dma_arena_open (GST_DMA_ARENA_HEAP_SYSTEM)) {
+    GST_ERROR_OBJECT (allocator, "Failed to open DMA/ION device!");
     gst_object_unref (allocator);
     return NULL;
   }
 
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  priv->datamap = g_hash_table_new (NULL, NULL);
-#endif // TARGET_ION_ABI_VERSION
-
   return GST_ALLOCATOR_CAST (allocator);
 }
 
@@ -360,19 +527,25 @@ gst_qti_allocator_start (GstQtiAllocator * qtiallocator, guint max_memory_blocks
 
   GST_DEBUG_OBJECT (qtiallocator, "Starting ...");
 
-  if (priv->mem_queue != NULL) {
+  if (atomic_load (&(priv->active))) {
     GST_INFO_OBJECT (qtiallocator, "Allocator is already active");
     return;
   }
 
-  priv->max_memory_blocks = max_memory_blocks;
-  priv->mem_queue = gst_data_queue_new (gst_data_queue_is_full_cb, NULL, NULL,
-      qtiallocator);
+  atomic_store (&(priv->max_memory_blocks), max_memory_blocks);
 
-  if (priv->max_memory_blocks == 0)
+  if (max_memory_blocks == 0)
     GST_INFO_OBJECT (qtiallocator, "Allocator has not limit for memory blocks");
 
-  gst_data_queue_set_flushing (priv->mem_queue, FALSE);
+  if (max_memory_blocks > GST_QTI_FREELIST_CAPACITY)
+    GST_WARNING_OBJECT (qtiallocator, "Only %u blocks per size can be recycled",
+        GST_QTI_FREELIST_CAPACITY);
+
+  atomic_store (&(priv->n_hits), 0);
+  atomic_store (&(priv->n_misses), 0);
+  atomic_store (&(priv->high_water), atomic_load (&(priv->n_allocated_memory)));
+
+  atomic_store (&(priv->active), TRUE);
   GST_DEBUG_OBJECT (qtiallocator, "Started successfully");
 }
 
@@ -380,23 +553,55 @@ void
 gst_qti_allocator_stop (GstQtiAllocator * qtiallocator)
 {
   GstQtiAllocatorPrivate *priv = qtiallocator->priv;
-  GstDataQueue *mem_queue = NULL;
+  GstQtiAllocatorStats stats = { 0, };
+  guint idx = 0;
 
   GST_DEBUG_OBJECT (qtiallocator, "Stoping ...");
 
-  if (priv->mem_queue == NULL) {
+  if (!atomic_exchange (&(priv->active), FALSE)) {
     GST_INFO_OBJECT (qtiallocator, "Allocator is not active");
     return;
   }
 
-  // Steal the memory queue pointer in order to propery flush and free it.
-  mem_queue = g_steal_pointer (&(priv->mem_queue));
+  // Release any threads waiting for a free memory block.
+  g_mutex_lock (&priv->lock);
+  g_cond_broadcast (&priv->wakeup);
+  g_mutex_unlock (&priv->lock);
+
+  // Free recycled memory blocks, blocks returned later will be freed directly.
+  // Release the size classes as well, sizes may differ after the next start.
+  for (idx = 0; idx < GST_QTI_N_SIZE_CLASSES; idx++) {
+    GstQtiSizeClass *sclass = &(priv->sclasses[idx]);
+    gsize size = atomic_load (&(sclass->size));
+
+    if ((size == 0) || (size == GST_QTI_SIZE_CLASS_BUSY))
+      continue;
+
+    gst_qti_size_class_drain (sclass);
+    atomic_compare_exchange_strong (&(sclass->size), &size, 0);
+  }
+
+  atomic_store (&(priv->max_memory_blocks), 0);
 
-  gst_data_queue_set_flushing (mem_queue, TRUE);
-  gst_data_queue_flush (mem_queue);
+  gst_qti_allocator_get_stats (qtiallocator, &stats);
 
-  gst_clear_object (&mem_queue);
-  priv->max_memory_blocks = 0;
+  GST_INFO_OBJECT (qtiallocator, "Freelist hits: %" G_GUINT64_FORMAT ", misses: %"
+      G_GUINT64_FORMAT ", high water: %u blocks", stats.hits, stats.misses,
+      stats.high_water);
 
   GST_DEBUG_OBJECT (qtiallocator, "Stopped successfully");
 }
+
+void
+gst_qti_allocator_get_stats (GstQtiAllocator * qtiallocator,
+    GstQtiAllocatorStats * stats)
+{
+  GstQtiAllocatorPrivate *priv = qtiallocator->priv;
+
+  g_return_if_fail (stats != NULL);
+
+  stats->hits = atomic_load (&(priv->n_hits));
+  stats->misses = atomic_load (&(priv->n_misses));
+  stats->high_water = atomic_load (&(priv->high_water));
+  stats->n_allocated = atomic_load (&(priv->n_allocated_memory));
+}
@@ -31,6 +31,7 @@ G_BEGIN_DECLS
 typedef struct _GstQtiAllocator GstQtiAllocator;
 typedef struct _GstQtiAllocatorClass GstQtiAllocatorClass;
 typedef struct _GstQtiAllocatorPrivate GstQtiAllocatorPrivate;
+typedef struct _GstQtiAllocatorStats GstQtiAllocatorStats;
 
 struct _GstQtiAllocator
 {
@@ -44,6 +45,23 @@ struct _GstQtiAllocatorClass
   GstDmaBufAllocatorClass parent;
 };
 
+/**
+ * GstQtiAllocatorStats:
+ * @hits: Number of allocations served with a recycled memory block.
+ * @misses: Number of allocations which required a new memory block.
+ * @high_water: Maximum number of simultaneously allocated memory blocks.
+ * @n_allocated: Number of currently allocated memory blocks.
+ *
+ * Memory block recycling statistics, reset on every start.
+ */
+struct _GstQtiAllocatorStats
+{
+  guint64 hits;
+  guint64 misses;
+  guint   high_water;
+  guint   n_allocated;
+};
+
 GST_EXPORT
 GType          gst_qti_allocator_get_type (void);
 
@@ -57,6 +75,10 @@ void           gst_qti_allocator_start (GstQtiAllocator * qtiallocator,
 GST_EXPORT
 void           gst_qti_allocator_stop (GstQtiAllocator * qtiallocator);
 
+GST_EXPORT
+void           gst_qti_allocator_get_stats (GstQtiAllocator * qtiallocator,
+                                            GstQtiAllocatorStats * stats);
+
 G_END_DECLS
 
 #endif /* __GST_QTI_ALLOCATOR_H__ */
@@ -0,0 +1,466 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "gstdmaarena.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#if defined(HAVE_LINUX_DMA_HEAP_H)
+#include <linux/dma-heap.h>
+#else
+#include <linux/ion.h>
+#include <linux/msm_ion.h>
+#endif // HAVE_LINUX_DMA_HEAP_H
+
+GST_DEBUG_CATEGORY_STATIC (gst_dma_arena_debug);
+#define GST_CAT_DEFAULT gst_dma_arena_debug
+
+#define DEFAULT_PAGE_ALIGNMENT 4096
+// Maximum total size of the released blocks which are kept for reuse.
+#define DEFAULT_CACHE_LIMIT    (64 * 1024 * 1024)
+
+typedef struct _GstDmaBlock GstDmaBlock;
+typedef struct _GstDmaUsage GstDmaUsage;
+typedef struct _GstDmaArena GstDmaArena;
+
+struct _GstDmaBlock
+{
+  // Memory block FD.
+  gint            fd;
+  // Page rounded size of the block.
+  gsize           size;
+  // Heap from which the block was allocated.
+  GstDmaArenaHeap heap;
+
+  // Interned name of the owner while the block is in use, NULL if cached.
+  const gchar     *owner;
+
+#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
+  // ION handle of the memory block.
+  ion_user_handle_t handle;
+#endif // TARGET_ION_ABI_VERSION
+
+  // Links in the size class cache and in the least recently used queue.
+  GList           cachelink;
+  GList           lrulink;
+};
+
+struct _GstDmaUsage
+{
+  gsize size;
+  guint n_blocks;
+};
+
+struct _GstDmaArena
+{
+  // Mutex for protecting the members below.
+  GMutex     lock;
+
+  // DMA/ION device FD per heap type, -1 if not opened.
+  gint       devfds[GST_DMA_ARENA_HEAP_MAX];
+
+  // Map of memory block FDs and blocks, both in use and cached.
+  GHashTable *blocks;
+  // Map of page rounded sizes and queues of cached blocks, per heap type.
+  // Most recently released blocks are at the head of the queues.
+  GHashTable *caches[GST_DMA_ARENA_HEAP_MAX];
+  // Queue of all cached blocks, least recently released at the tail.
+  GQueue     lru;
+
+  // Total size of the cached blocks and the maximum allowed.
+  gsize      cached;
+  gsize      limit;
+
+  // Map of interned owner names and their memory usage.
+  GHashTable *usage;
+
+  // Number of allocations served from the cache and from the device.
+  guint64    n_hits;
+  guint64    n_misses;
+};
+
+static GstDmaArena *
+gst_dma_arena_get (void)
+{
+  static GstDmaArena *arena = NULL;
+  guint idx = 0;
+
+  if (g_once_init_enter (&arena)) {
+    GstDmaArena *newarena = g_new0 (GstDmaArena, 1);
+
+    GST_DEBUG_CATEGORY_INIT (gst_dma_arena_debug, "dma-arena", 0,
+        "DMA memory arena");
+
+    g_mutex_init (&newarena->lock);
+
+    for (idx = 0; idx < GST_DMA_ARENA_HEAP_MAX; idx++) {
+      newarena->devfds[idx] = -1;
+      newarena->caches[idx] = g_hash_table_new_full (NULL, NULL, NULL,
+          (GDestroyNotify) g_queue_free);
+    }
+
+    newarena->blocks = g_hash_table_new (NULL, NULL);
+    newarena->usage = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+
+    g_queue_init (&newarena->lru);
+    newarena->limit = DEFAULT_CACHE_LIMIT;
+
+    g_once_init_leave (&arena, newarena);
+  }
+
+  return arena;
+}
+
+static GstDmaBlock *
+gst_dma_arena_device_alloc (GstDmaArena * arena, GstDmaArenaHeap heap,
+    gsize size)
+{
+  GstDmaBlock *block = NULL;
+  gint result = 0, devfd = arena->devfds[heap];
+
+#if defined(HAVE_LINUX_DMA_HEAP_H)
+  struct dma_heap_allocation_data alloc_data;
+#else
+  struct ion_allocation_data alloc_data;
+#if !defined(TARGET_ION_ABI_VERSION)
+  struct ion_fd_data fd_data;
+#endif // TARGET_ION_ABI_VERSION
+#endif
+
+  alloc_data.fd = 0;
+  alloc_data.len = size;
+
+#if defined(HAVE_LINUX_DMA_HEAP_H)
+  // Permissions for the memory to be allocated.
+  alloc_data.fd_flags = O_RDWR | O_CLOEXEC;
+  alloc_data.heap_flags = 0;
+#else
+  alloc_data.heap_id_mask = ION_HEAP(ION_SYSTEM_HEAP_ID);
+  alloc_data.flags = ION_FLAG_CACHED;
+
+#if !defined(TARGET_ION_ABI_VERSION)
+  alloc_data.align = DEFAULT_PAGE_ALIGNMENT;
+#endif // TARGET_ION_ABI_VERSION
+#endif
+
+#if defined(HAVE_LINUX_DMA_HEAP_H)
+  result = ioctl (devfd, DMA_HEAP_IOCTL_ALLOC, &alloc_data);
+#else
+  result = ioctl (devfd, ION_IOC_ALLOC, &alloc_data);
+#endif
+
+  if (result != 0) {
+    GST_WARNING ("Failed to allocate memory of size %" G_GSIZE_FORMAT
+        " on device FD %d, error: %s", size, devfd, g_strerror (errno));
+    return NULL;
+  }
+
+  block = g_new0 (GstDmaBlock, 1);
+
+#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
+  fd_data.handle = alloc_data.handle;
+
+  result = ioctl (devfd, ION_IOC_MAP, &fd_data);
+  if (result != 0) {
+    GST_ERROR ("Failed to map memory to FD, error: %s", g_strerror (errno));
+    ioctl (devfd, ION_IOC_FREE, &alloc_data.handle);
+    g_free (block);
+    return NULL;
+  }
+
+  block->fd = fd_data.fd;
+  block->handle = alloc_data.handle;
+#else
+  block->fd = alloc_data.fd;
+#endif
+
+  block->size = size;
+  block->heap = heap;
+
+  block->cachelink.data = block;
+  block->lrulink.data = block;
+
+  GST_DEBUG ("Allocated DMA/ION memory FD %d of size %" G_GSIZE_FORMAT,
+      block->fd, size);
+  return block;
+}
+
+static void
+gst_dma_arena_device_free (GstDmaArena * arena, GstDmaBlock * block)
+{
+  GST_DEBUG ("Closing DMA/ION memory FD %d", block->fd);
+
+#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
+  if (ioctl (arena->devfds[block->heap], ION_IOC_FREE, &block->handle) < 0)
+    GST_ERROR ("Failed to free handle for memory FD %d!", block->fd);
+#endif // TARGET_ION_ABI_VERSION
+
+  close (block->fd);
+  g_free (block);
+}
+
+static GList *
+gst_dma_arena_evict (GstDmaArena * arena, gsize limit)
+{
+  GList *evicted = NULL;
+
+  while ((arena->cached > limit) && (arena->lru.tail != NULL)) {
+    GstDmaBlock *block = arena->lru.tail->data;
+    GHashTable *cache = arena->caches[block->heap];
+    GQueue *queue = g_hash_table_lookup (cache, GSIZE_TO_POINTER (block->size));
+
+    g_queue_unlink (&arena->lru, &block->lrulink);
+    g_queue_unlink (queue, &block->cachelink);
+
+    if (g_queue_is_empty (queue))
+      g_hash_table_remove (cache, GSIZE_TO_POINTER (block->size));
+
+    g_hash_table_remove (arena->blocks, GINT_TO_POINTER (block->fd));
+    arena->cached -= block->size;
+
+    evicted = g_list_prepend (evicted, block);
+  }
+
+  return evicted;
+}
+
+static void
+gst_dma_arena_release (GstDmaArena * arena, GList * blocks)
+{
+  GList *list = NULL;
+
+  // Blocks are no longer reachable via the arena, free them without the lock.
+  for (list = blocks; list != NULL; list = list->next)
+    gst_dma_arena_device_free (arena, list->data);
+
+  g_list_free (blocks);
+}
+
+gboolean
+gst_dma_arena_open (GstDmaArenaHeap heap)
+{
+  GstDmaArena *arena = gst_dma_arena_get ();
+  gint devfd = -1;
+
+  g_return_val_if_fail (heap < GST_DMA_ARENA_HEAP_MAX, FALSE);
+
+  g_mutex_lock (&arena->lock);
+
+  if ((devfd = arena->devfds[heap]) >= 0) {
+    g_mutex_unlock (&arena->lock);
+    return TRUE;
+  }
+
+  if (heap == GST_DMA_ARENA_HEAP_SECURE) {
+    GST_INFO ("Open /dev/dma_heap/system-secure");
+    devfd = open ("/dev/dma_heap/system-secure", O_RDONLY | O_CLOEXEC);
+  } else {
+    GST_INFO ("Open /dev/dma_heap/qcom,system");
+    devfd = open ("/dev/dma_heap/qcom,system", O_RDONLY | O_CLOEXEC);
+
+    if (devfd < 0) {
+      GST_WARNING ("Failed to open /dev/dma_heap/qcom,system, error: %s! "
+          "Falling back to /dev/dma_heap/system", g_strerror (errno));
+      devfd = open ("/dev/dma_heap/system", O_RDONLY | O_CLOEXEC);
+    }
+  }
+
+  if (devfd < 0) {
+    GST_WARNING ("Falling back to /dev/ion");
+    devfd = open ("/dev/ion", O_RDONLY | O_CLOEXEC);
+  }
+
+  if (devfd < 0) {
+    GST_ERROR ("Failed to open DMA/ION device FD, error: %s!",
+        g_strerror (errno));
+    g_mutex_unlock (&arena->lock);
+    return FALSE;
+  }
+
+  GST_INFO ("Opened DMA/ION device FD %d", devfd);
+  arena->devfds[heap] = devfd;
+
+  g_mutex_unlock (&arena->lock);
+  return TRUE;
+}
+
+gint
+gst_dma_arena_alloc (GstDmaArenaHeap heap, gsize size, const gchar * owner)
+{
+  GstDmaArena *arena = gst_dma_arena_get ();
+  GstDmaBlock *block = NULL;
+  GstDmaUsage *usage = NULL;
+  GQueue *queue = NULL;
+
+  g_return_val_if_fail (heap < GST_DMA_ARENA_HEAP_MAX, -1);
+  g_return_val_if_fail (owner != NULL, -1);
+
+  size = GST_ROUND_UP_N (size, DEFAULT_PAGE_ALIGNMENT);
+
+  g_mutex_lock (&arena->lock);
+
+  if (arena->devfds[heap] < 0) {
+    GST_ERROR ("Device for heap %d is not opened!", heap);
+    g_mutex_unlock (&arena->lock);
+    return -1;
+  }
+
+  queue = g_hash_table_lookup (arena->caches[heap], GSIZE_TO_POINTER (size));
+
+  // Reuse the most recently released block of the same size class.
+  if (queue != NULL) {
+    GList *link = g_queue_pop_head_link (queue);
+
+    block = link->data;
+
+    if (g_queue_is_empty (queue))
+      g_hash_table_remove (arena->caches[heap], GSIZE_TO_POINTER (size));
+
+    g_queue_unlink (&arena->lru, &block->lrulink);
+    arena->cached -= block->size;
+
+    arena->n_hits++;
+  }
+
+  g_mutex_unlock (&arena->lock);
+
+  if (block == NULL)
+    block = gst_dma_arena_device_alloc (arena, heap, size);
+
+  // Allocation may have failed due to memory held in cache, free it and retry.
+  if (block == NULL) {
+    GList *evicted = NULL;
+
+    g_mutex_lock (&arena->lock);
+
+    GST_INFO ("Trimming %" G_GSIZE_FORMAT " cached bytes", arena->cached);
+    evicted = gst_dma_arena_evict (arena, 0);
+
+    g_mutex_unlock (&arena->lock);
+
+    gst_dma_arena_release (arena, evicted);
+    block = gst_dma_arena_device_alloc (arena, heap, size);
+  }
+
+  if (block == NULL) {
+    GST_ERROR ("Failed to allocate memory of size %" G_GSIZE_FORMAT " for %s!",
+        size, owner);
+    return -1;
+  }
+
+  g_mutex_lock (&arena->lock);
+
+  if (block->owner == NULL && !g_hash_table_contains (arena->blocks,
+          GINT_TO_POINTER (block->fd))) {
+    g_hash_table_insert (arena->blocks, GINT_TO_POINTER (block->fd), block);
+    arena->n_misses++;
+  }
+
+  block->owner = g_intern_string (owner);
+
+  if ((usage = g_hash_table_lookup (arena->usage, block->owner)) == NULL) {
+    usage = g_new0 (GstDmaUsage, 1);
+    g_hash_table_insert (arena->usage, (gpointer) block->owner, usage);
+  }
+
+  usage->size += block->size;
+  usage->n_blocks++;
+
+  GST_LOG ("%s: FD %d of size %" G_GSIZE_FORMAT ", in use %" G_GSIZE_FORMAT
+      " bytes in %u blocks, cache hits %" G_GUINT64_FORMAT " misses %"
+      G_GUINT64_FORMAT, block->owner, block->fd, block->size, usage->size,
+      usage->n_blocks, arena->n_hits, arena->n_misses);
+
+  g_mutex_unlock (&arena->lock);
+  return block->fd;
+}
+
+void
+gst_dma_arena_free (gint fd)
+{
+  GstDmaArena *arena = gst_dma_arena_get ();
+  GstDmaBlock *block = NULL;
+  GstDmaUsage *usage = NULL;
+  GQueue *queue = NULL;
+  GList *evicted = NULL;
+
+  g_mutex_lock (&arena->lock);
+
+  block = g_hash_table_lookup (arena->blocks, GINT_TO_POINTER (fd));
+
+  if ((block == NULL) || (block->owner == NULL)) {
+    GST_ERROR ("Memory FD %d is not in use from the arena!", fd);
+    g_mutex_unlock (&arena->lock);
+    return;
+  }
+
+  usage = g_hash_table_lookup (arena->usage, block->owner);
+  usage->size -= block->size;
+  usage->n_blocks--;
+
+  if (usage->n_blocks == 0)
+    g_hash_table_remove (arena->usage, block->owner);
+
+  block->owner = NULL;
+
+  queue = g_hash_table_lookup (arena->caches[block->heap],
+      GSIZE_TO_POINTER (block->size));
+
+  if (queue == NULL) {
+    queue = g_queue_new ();
+    g_hash_table_insert (arena->caches[block->heap],
+        GSIZE_TO_POINTER (block->size), queue);
+  }
+
+  g_queue_push_head_link (queue, &block->cachelink);
+  g_queue_push_head_link (&arena->lru, &block->lrulink);
+  arena->cached += block->size;
+
+  evicted = gst_dma_arena_evict (arena, arena->limit);
+
+  g_mutex_unlock (&arena->lock);
+
+  gst_dma_arena_release (arena, evicted);
+}
+
+void
+gst_dma_arena_trim (gsize limit)
+{
+  GstDmaArena *arena = gst_dma_arena_get ();
+  GList *evicted = NULL;
+
+  g_mutex_lock (&arena->lock);
+
+  GST_INFO ("Trimming cache from %" G_GSIZE_FORMAT " to %" G_GSIZE_FORMAT
+      " bytes", arena->cached, limit);
+  evicted = gst_dma_arena_evict (arena, limit);
+
+  g_mutex_unlock (&arena->lock);
+
+  gst_dma_arena_release (arena, evicted);
+}
+
+void
+gst_dma_arena_get_usage (const gchar * owner, gsize * size, guint * n_blocks)
+{
+  GstDmaArena *arena = gst_dma_arena_get ();
+  GstDmaUsage *usage = NULL;
+
+  g_return_if_fail (owner != NULL);
+
+  g_mutex_lock (&arena->lock);
+
+  usage = g_hash_table_lookup (arena->usage, g_intern_string (owner));
+
+  if (size != NULL)
+    *size = (usage != NULL) ? usage->size : 0;
+
+  if (n_blocks != NULL)
+    *n_blocks = (usage != NULL) ? usage->n_blocks : 0;
+
+  g_mutex_unlock (&arena->lock);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __GST_DMA_ARENA_H__
+#define __GST_DMA_ARENA_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GstDmaArenaHeap:
+ * @GST_DMA_ARENA_HEAP_SYSTEM: Cached system DMA heap.
+ * @GST_DMA_ARENA_HEAP_SECURE: Secure system DMA heap.
+ *
+ * Type of the DMA heap (or ION heap on older kernels) from which memory
+ * blocks are allocated.
+ */
+typedef enum {
+  GST_DMA_ARENA_HEAP_SYSTEM,
+  GST_DMA_ARENA_HEAP_SECURE,
+  GST_DMA_ARENA_HEAP_MAX,
+} GstDmaArenaHeap;
+
+/**
+ * gst_dma_arena_open:
+ * @heap: The DMA heap type.
+ *
+ * Open the device of the given heap type in the process wide DMA arena if it
+ * was not already opened. The device stays opened until process exit.
+ *
+ * return: TRUE on success or FALSE on failure
+ */
+gboolean gst_dma_arena_open (GstDmaArenaHeap heap);
+
+/**
+ * gst_dma_arena_alloc:
+ * @heap: The DMA heap type.
+ * @size: Minimum size of the memory block, rounded up to page size.
+ * @owner: Name of the object (pool, allocator) used for accounting.
+ *
+ * Get a DMA memory block from the process wide arena. Previously released
+ * blocks of the same heap type and page rounded size are reused before new
+ * ones are allocated from the device. In case the device allocation fails,
+ * all cached blocks are freed and the allocation is retried once.
+ *
+ * The returned FD is owned by the arena and must not be closed by the caller.
+ *
+ * return: FD of the memory block on success or -1 on failure
+ */
+gint     gst_dma_arena_alloc (GstDmaArenaHeap heap, gsize size,
+                              const gchar * owner);
+
+/**
+ * gst_dma_arena_free:
+ * @fd: FD of a memory block returned by gst_dma_arena_alloc().
+ *
+ * Release a memory block back to the process wide arena. It is cached for
+ * reuse until the total size of the cached blocks exceeds the cache limit,
+ * in which case the least recently released blocks are freed.
+ *
+ * return: NONE
+ */
+void     gst_dma_arena_free (gint fd);
+
+/**
+ * gst_dma_arena_trim:
+ * @limit: Maximum total size in bytes of the blocks which remain cached.
+ *
+ * Free least recently released blocks until the total size of the cached
+ * blocks is at most @limit bytes. Use 0 in order to free all cached blocks,
+ * e.g. when the system is under memory pressure.
+ *
+ * return: NONE
+ */
+void     gst_dma_arena_trim (gsize limit);
+
+/**
+ * gst_dma_arena_get_usage:
+ * @owner: Name of the object used for accounting.
+ * @size: (out) (optional): Total size in bytes of the blocks in use by @owner.
+ * @n_blocks: (out) (optional): Number of blocks in use by @owner.
+ *
+ * Get the accounted DMA memory usage of an object.
+ *
+ * return: NONE
+ */
+void     gst_dma_arena_get_usage (const gchar * owner, gsize * size,
+                                  guint * n_blocks);
+
+G_END_DECLS
+
+#endif /* __GST_DMA_ARENA_H__ */
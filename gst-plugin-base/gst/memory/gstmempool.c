@@ -33,19 +33,7 @@
  */
 
 #include "gstmempool.h"
-
-#include <fcntl.h>
-#include <unistd.h>
-#include <sys/stat.h>
-#include <sys/ioctl.h>
-
-#if defined(HAVE_LINUX_DMA_HEAP_H)
-#include <linux/dma-heap.h>
-#else
-#include <linux/ion.h>
-#include <linux/msm_ion.h>
-#endif // HAVE_LINUX_DMA_HEAP_H
-
+#include "gstdmaarena.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_mem_pool_debug);
 #define GST_CAT_DEFAULT gst_mem_pool_debug
@@ -57,8 +45,6 @@ GST_DEBUG_CATEGORY_STATIC (gst_mem_pool_debug);
 #define GST_IS_SECURE_MEMORY_TYPE(type) \
     (type == g_quark_from_static_string (GST_MEMORY_BUFFER_POOL_TYPE_SECURE))
 
-#define DEFAULT_PAGE_ALIGNMENT 4096
-
 struct _GstMemBufferPoolPrivate
 {
   GList               *memsizes;
@@ -67,157 +53,34 @@ struct _GstMemBufferPoolPrivate
   GstAllocationParams params;
   GQuark              memtype;
 
-  // DMA/ION device FD.
-  gint                devfd;
-
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  // Map of data FDs and ION handles on case ION memory is used OR
-  GHashTable          *datamap;
-#endif // TARGET_ION_ABI_VERSION
+  // DMA heap from which memory is allocated via the process wide arena.
+  GstDmaArenaHeap     heap;
 };
 
 #define gst_mem_buffer_pool_parent_class parent_class
 G_DEFINE_TYPE_WITH_PRIVATE (GstMemBufferPool, gst_mem_buffer_pool,
     GST_TYPE_BUFFER_POOL);
 
-static gboolean
-open_dma_device (GstMemBufferPool * mempool, gboolean secure)
-{
-  GstMemBufferPoolPrivate *priv = mempool->priv;
-
-  if (secure) {
-    GST_INFO_OBJECT (mempool, "Open /dev/dma_heap/system-secure");
-    priv->devfd = open ("/dev/dma_heap/system-secure", O_RDONLY | O_CLOEXEC);
-  } else {
-    GST_INFO_OBJECT (mempool, "Open /dev/dma_heap/qcom,system");
-    priv->devfd = open ("/dev/dma_heap/qcom,system", O_RDONLY | O_CLOEXEC);
-
-    if (priv->devfd < 0) {
-      GST_WARNING_OBJECT (mempool, "Failed to open /dev/dma_heap/qcom,system, "
-          "error: %s! Falling back to /dev/dma_heap/system", g_strerror (errno));
-      priv->devfd = open ("/dev/dma_heap/system", O_RDONLY | O_CLOEXEC);
-    }
-  }
-
-  if (priv->devfd < 0) {
-    GST_WARNING_OBJECT (mempool, "Falling back to /dev/ion");
-    priv->devfd = open ("/dev/ion", O_RDONLY | O_CLOEXEC);
-  }
-
-  if (priv->devfd < 0) {
-    GST_ERROR_OBJECT (mempool, "Failed to open ION device FD!");
-    return FALSE;
-  }
-
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  priv->datamap = g_hash_table_new (NULL, NULL);
-#endif // TARGET_ION_ABI_VERSION
-
-  GST_INFO_OBJECT (mempool, "Opened DMA/ION device FD %d", priv->devfd);
-  return TRUE;
-}
-
-static void
-close_dma_device (GstMemBufferPool * mempool)
-{
-  GstMemBufferPoolPrivate *priv = mempool->priv;
-
-  if (priv->devfd >= 0) {
-    GST_INFO_OBJECT (mempool, "Closing DMA/ION device FD %d", priv->devfd);
-    close (priv->devfd);
-  }
-
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  g_hash_table_destroy (priv->datamap);
-#endif // TARGET_ION_ABI_VERSION
-}
-
 static GstMemory *
-dma_device_alloc (GstMemBufferPool * mempool, gint size)
+dma_arena_alloc (GstMemBufferPool * mempool, gint size)
 {
   GstMemBufferPoolPrivate *priv = mempool->priv;
-  gint result = 0, fd = -1;
-
-#if defined(HAVE_LINUX_DMA_HEAP_H)
-  struct dma_heap_allocation_data alloc_data;
-#else
-  struct ion_allocation_data alloc_data;
-#if !defined(TARGET_ION_ABI_VERSION)
-  struct ion_fd_data fd_data;
-#endif // TARGET_ION_ABI_VERSION
-#endif
-
-  alloc_data.fd = 0;
-  alloc_data.len = size;
-
-#if defined(HAVE_LINUX_DMA_HEAP_H)
-  // Permissions for the memory to be allocated.
-  alloc_data.fd_flags = O_RDWR | O_CLOEXEC;
-  alloc_data.heap_flags = 0;
-#else
-  alloc_data.heap_id_mask = ION_HEAP(ION_SYSTEM_HEAP_ID);
-  alloc_data.flags = ION_FLAG_CACHED;
-
-#if !defined(TARGET_ION_ABI_VERSION)
-  alloc_data.align = DEFAULT_PAGE_ALIGNMENT;
-#endif // TARGET_ION_ABI_VERSION
-#endif
-
-#if defined(HAVE_LINUX_DMA_HEAP_H)
-  result = ioctl (priv->devfd, DMA_HEAP_IOCTL_ALLOC, &alloc_data);
-#else
-  result = ioctl (priv->devfd, ION_IOC_ALLOC, &alloc_data);
-#endif
-
-  if (result != 0) {
-    GST_ERROR_OBJECT (mempool, "Failed to allocate memory!");
-    return NULL;
-  }
+  gint fd = -1;
 
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  fd_data.handle = alloc_data.handle;
+  fd = gst_dma_arena_alloc (priv->heap, size, GST_OBJECT_NAME (mempool));
 
-  result = ioctl (priv->devfd, ION_IOC_MAP, &fd_data);
-  if (result != 0) {
-    GST_ERROR_OBJECT (mempool, "Failed to map memory to FD!");
-    ioctl (priv->devfd, ION_IOC_FREE, &alloc_data.handle);
+  if (fd < 0) {
+    GST_ERROR_OBJECT (mempool, "Failed to allocate memory!");
     return NULL;
   }
 
-  fd = fd_data.fd;
-
-  g_hash_table_insert (priv->datamap, GINT_TO_POINTER (fd),
-      GSIZE_TO_POINTER (alloc_data.handle));
-#else
-  fd = alloc_data.fd;
-#endif
-
   GST_DEBUG_OBJECT (mempool, "Allocated DMA/ION memory FD %d", fd);
 
-  // Wrap the allocated FD in FD backed allocator.
+  // Wrap the allocated FD in FD backed allocator, the FD is owned by the arena.
   return gst_fd_allocator_alloc (priv->allocator, fd, size,
       GST_FD_MEMORY_FLAG_DONT_CLOSE);
 }
 
-static void
-dma_device_free (GstMemBufferPool * mempool, gint fd)
-{
-  GST_DEBUG_OBJECT (mempool, "Closing DMA/ION memory FD %d", fd);
-
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  ion_user_handle_t handle = GPOINTER_TO_SIZE (
-      g_hash_table_lookup (mempool->priv->datamap, GINT_TO_POINTER (fd)));
-
-  if (ioctl (mempool->priv->devfd, ION_IOC_FREE, &handle) < 0) {
-    GST_ERROR_OBJECT (mempool, "Failed to free handle for memory FD %d!", fd);
-  }
-
-  g_hash_table_remove (mempool->priv->datamap, GINT_TO_POINTER (fd));
-#endif // TARGET_ION_ABI_VERSION
-
-  close (fd);
-}
-
 static const gchar **
 gst_mem_buffer_pool_get_options (GstBufferPool * pool)
 {
@@ -308,7 +171,7 @@ gst_mem_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
       memory = gst_allocator_alloc (priv->allocator, blocksize, &(priv->params));
     } else if (GST_IS_DMA_MEMORY_TYPE (priv->memtype) ||
         GST_IS_SECURE_MEMORY_TYPE (priv->memtype)) {
-      memory = dma_device_alloc (mempool, blocksize);
+      memory = dma_arena_alloc (mempool, blocksize);
     }
 
     if (memory == NULL) {
@@ -339,7 +202,7 @@ gst_mem_buffer_pool_free (GstBufferPool * pool, GstBuffer * buffer)
 
   for (idx = 0; (idx < length) && is_dma_heap; idx++) {
     gint fd = gst_fd_memory_get_fd (gst_buffer_peek_memory (buffer, idx));
-    dma_device_free (mempool, fd);
+    gst_dma_arena_free (fd);
   }
 
   gst_buffer_unref (buffer);
@@ -384,8 +247,6 @@ gst_mem_buffer_pool_finalize (GObject * object)
     priv->memsizes = NULL;
   }
 
-  close_dma_device (mempool);
-
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -411,7 +272,7 @@ static void
 gst_mem_buffer_pool_init (GstMemBufferPool * mempool)
 {
   mempool->priv = gst_mem_buffer_pool_get_instance_private (mempool);
-  mempool->priv->devfd = -1;
+  mempool->priv->heap = GST_DMA_ARENA_HEAP_SYSTEM;
   mempool->priv->memsizes = NULL;
 }
 
@@ -430,10 +291,12 @@ gst_mem_buffer_pool_new (const gchar * type)
     success = TRUE;
   } else if (GST_IS_DMA_MEMORY_TYPE (mempool->priv->memtype)) {
     GST_INFO_OBJECT (mempool, "Using DMA memory");
-    success = open_dma_device (mempool, FALSE);
+    mempool->priv->heap = GST_DMA_ARENA_HEAP_SYSTEM;
+    success = gst_dma_arena_open (mempool->priv->heap);
   } else if (GST_IS_SECURE_MEMORY_TYPE (mempool->priv->memtype)) {
     GST_INFO_OBJECT (mempool, "Using SECURE memory");
-    success = open_dma_device (mempool, TRUE);
+    mempool->priv->heap = GST_DMA_ARENA_HEAP_SECURE;
+    success = gst_dma_arena_open (mempool->priv->heap);
   } else {
     GST_ERROR_OBJECT (mempool, "Invalid memory type %s!",
         g_quark_to_string (mempool->priv->memtype));
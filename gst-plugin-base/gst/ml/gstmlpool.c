@@ -34,17 +34,7 @@
 
 #include "gstmlpool.h"
 
-#include <fcntl.h>
-#include <unistd.h>
-#include <sys/stat.h>
-#include <sys/ioctl.h>
-
-#if defined(HAVE_LINUX_DMA_HEAP_H)
-#include <linux/dma-heap.h>
-#else
-#include <linux/ion.h>
-#include <linux/msm_ion.h>
-#endif // HAVE_LINUX_DMA_HEAP_H
+#include <gst/memory/gstdmaarena.h>
 
 #include "gstmlmeta.h"
 
@@ -57,7 +47,9 @@ GST_DEBUG_CATEGORY_STATIC (gst_ml_pool_debug);
 #define GST_IS_SYSTEM_MEMORY_TYPE(type) \
     (type == g_quark_from_static_string (GST_ML_BUFFER_POOL_TYPE_SYSTEM))
 
-#define DEFAULT_ION_ALIGNMENT 4096
+// Minimum alignment of system memory, enough for binding it to tensors of
+// the inference engines and for the vector instructions.
+#define DEFAULT_TENSOR_ALIGNMENT 64
 
 struct _GstMLBufferPoolPrivate
 {
@@ -72,153 +64,33 @@ struct _GstMLBufferPoolPrivate
   gboolean            addmeta;
   gboolean            continuous;
   GstFdMemoryFlags    memflags;
-
-  // DMA/ION device FD.
-  gint                devfd;
-
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  // Map of data FDs and ION handles on case ION memory is used.
-  GHashTable          *datamap;
-#endif
 };
 
 #define gst_ml_buffer_pool_parent_class parent_class
 G_DEFINE_TYPE_WITH_PRIVATE (GstMLBufferPool, gst_ml_buffer_pool,
     GST_TYPE_BUFFER_POOL);
 
-static gboolean
-open_dma_device (GstMLBufferPool * mlpool)
-{
-  GstMLBufferPoolPrivate *priv = mlpool->priv;
-
-  GST_INFO_OBJECT (mlpool, "Open /dev/dma_heap/qcom,system");
-  priv->devfd = open ("/dev/dma_heap/qcom,system", O_RDONLY | O_CLOEXEC);
-
-  if (priv->devfd < 0) {
-    GST_WARNING_OBJECT (mlpool, "Failed to open /dev/dma_heap/qcom,system, "
-        "error: %s! Falling back to /dev/dma_heap/system", g_strerror (errno));
-    priv->devfd = open ("/dev/dma_heap/system", O_RDONLY | O_CLOEXEC);
-  }
-
-  if (priv->devfd < 0) {
-    GST_WARNING_OBJECT (mlpool, "Falling back to /dev/ion");
-    priv->devfd = open ("/dev/ion", O_RDONLY | O_CLOEXEC);
-  }
-
-  if (priv->devfd < 0) {
-    GST_ERROR_OBJECT (mlpool, "Failed to open ION device FD!");
-    return FALSE;
-  }
-
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  priv->datamap = g_hash_table_new (NULL, NULL);
-#endif // TARGET_ION_ABI_VERSION
-
-  GST_INFO_OBJECT (mlpool, "Opened DMA/ION device FD %d", priv->devfd);
-  return TRUE;
-}
-
-static void
-close_dma_device (GstMLBufferPool * mlpool)
-{
-  GstMLBufferPoolPrivate *priv = mlpool->priv;
-
-  if (priv->devfd >= 0) {
-    GST_INFO_OBJECT (mlpool, "Closing DMA/ION device FD %d", priv->devfd);
-    close (priv->devfd);
-  }
-
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  g_hash_table_destroy (priv->datamap);
-#endif // TARGET_ION_ABI_VERSION
-}
-
 static GstMemory *
-dma_device_alloc (GstMLBufferPool * mlpool, gsize size)
+dma_arena_alloc (GstMLBufferPool * mlpool, gsize size)
 {
   GstMLBufferPoolPrivate *priv = mlpool->priv;
-  gint result = 0, fd = -1;
-
-#if defined(HAVE_LINUX_DMA_HEAP_H)
-  struct dma_heap_allocation_data alloc_data;
-#else
-  struct ion_allocation_data alloc_data;
-#if !defined(TARGET_ION_ABI_VERSION)
-  struct ion_fd_data fd_data;
-#endif // TARGET_ION_ABI_VERSION
-#endif
-
-  alloc_data.fd = 0;
-  alloc_data.len = size;
-
-#if defined(HAVE_LINUX_DMA_HEAP_H)
-  // Permissions for the memory to be allocated.
-  alloc_data.fd_flags = O_RDWR | O_CLOEXEC;
-  alloc_data.heap_flags = 0;
-#else
-  alloc_data.heap_id_mask = ION_HEAP(ION_SYSTEM_HEAP_ID);
-  alloc_data.flags = ION_FLAG_CACHED;
-
-#if !defined(TARGET_ION_ABI_VERSION)
-  alloc_data.align = DEFAULT_PAGE_ALIGNMENT;
-#endif // TARGET_ION_ABI_VERSION
-#endif
-
-#if defined(HAVE_LINUX_DMA_HEAP_H)
-  result = ioctl (priv->devfd, DMA_HEAP_IOCTL_ALLOC, &alloc_data);
-#else
-  result = ioctl (priv->devfd, ION_IOC_ALLOC, &alloc_data);
-#endif
-
-  if (result != 0) {
-    GST_ERROR_OBJECT (mlpool, "Failed to allocate memory!");
-    return NULL;
-  }
+  gint fd = -1;
 
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  fd_data.handle = alloc_data.handle;
+  fd = gst_dma_arena_alloc (GST_DMA_ARENA_HEAP_SYSTEM, size,
+      GST_OBJECT_NAME (mlpool));
 
-  result = ioctl (priv->devfd, ION_IOC_MAP, &fd_data);
-  if (result != 0) {
-    GST_ERROR_OBJECT (mlpool, "Failed to map memory to FD!");
-    ioctl (priv->devfd, ION_IOC_FREE, &alloc_data.handle);
+  if (fd < 0) {
+    GST_ERROR_OBJECT (mlpool, "Failed to allocate memory!");
     return NULL;
   }
 
-  fd = fd_data.fd;
-
-  g_hash_table_insert (priv->datamap, GINT_TO_POINTER (fd),
-      GINT_TO_POINTER (alloc_data.handle));
-#else
-  fd = alloc_data.fd;
-#endif
-
   GST_DEBUG_OBJECT (mlpool, "Allocated DMA/ION memory FD %d", fd);
 
-  // Wrap the allocated FD in FD backed allocator.
+  // Wrap the allocated FD in FD backed allocator, the FD is owned by the arena.
   return gst_fd_allocator_alloc (priv->allocator, fd, size,
       priv->memflags);
 }
 
-static void
-dma_device_free (GstMLBufferPool * mlpool, gint fd)
-{
-  GST_DEBUG_OBJECT (mlpool, "Closing DMA/ION memory FD %d", fd);
-
-#if !defined(HAVE_LINUX_DMA_HEAP_H) && !defined(TARGET_ION_ABI_VERSION)
-  ion_user_handle_t handle = GPOINTER_TO_INT (
-      g_hash_table_lookup (mlpool->priv->datamap, GINT_TO_POINTER (fd)));
-
-  if (ioctl (mlpool->priv->devfd, ION_IOC_FREE, &handle) < 0) {
-    GST_ERROR_OBJECT (mlpool, "Failed to free handle for memory FD %d!", fd);
-  }
-
-  g_hash_table_remove (mlpool->priv->datamap, GINT_TO_POINTER (fd));
-#endif // TARGET_ION_ABI_VERSION
-
-  close (fd);
-}
-
 static const gchar **
 gst_ml_buffer_pool_get_options (GstBufferPool * pool)
 {
@@ -290,6 +162,9 @@ gst_ml_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
 
   GST_DEBUG_OBJECT (pool, "Caps %" GST_PTR_FORMAT, caps);
 
+  // Align system memory so that engines can use it directly as tensor data.
+  params.align = MAX (params.align, DEFAULT_TENSOR_ALIGNMENT - 1);
+
   priv->params = params;
   priv->info = info;
   priv->maxsize = maxsize;
@@ -334,9 +209,9 @@ gst_ml_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
         gst_ml_info_tensor_size (&priv->info, idx);
 
     if (GST_IS_SYSTEM_MEMORY_TYPE (priv->memtype))
-      mem = gst_allocator_alloc (priv->allocator, size, NULL);
+      mem = gst_allocator_alloc (priv->allocator, size, &priv->params);
     else if (GST_IS_DMA_MEMORY_TYPE (priv->memtype))
-      mem = dma_device_alloc (mlpool, size);
+      mem = dma_arena_alloc (mlpool, size);
 
     if (NULL == mem) {
       GST_WARNING_OBJECT (mlpool, "Failed to allocate memory!");
@@ -377,7 +252,7 @@ gst_ml_buffer_pool_free (GstBufferPool * pool, GstBuffer * buffer)
   for (idx = 0; idx < gst_buffer_n_memory (buffer); idx++) {
     if (GST_IS_DMA_MEMORY_TYPE (mlpool->priv->memtype)) {
       gint fd = gst_fd_memory_get_fd (gst_buffer_peek_memory (buffer, idx));
-      dma_device_free (mlpool, fd);
+      gst_dma_arena_free (fd);
     } else if (GST_IS_SYSTEM_MEMORY_TYPE (mlpool->priv->memtype)) {
       // No additional handling is needed.
     }
@@ -399,9 +274,6 @@ gst_ml_buffer_pool_finalize (GObject * object)
     gst_object_unref (priv->allocator);
   }
 
-  if (GST_IS_DMA_MEMORY_TYPE (priv->memtype))
-    close_dma_device (mlpool);
-
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -439,13 +311,12 @@ gst_ml_buffer_pool_new (const gchar * memtype)
   mlpool = g_object_new (GST_TYPE_ML_POOL, NULL);
 
   mlpool->priv->memtype = g_quark_from_static_string (memtype);
-  mlpool->priv->devfd = -1;
   mlpool->priv->addmeta = FALSE;
   mlpool->priv->continuous = FALSE;
 
   if (GST_IS_DMA_MEMORY_TYPE (mlpool->priv->memtype)) {
     GST_INFO_OBJECT (mlpool, "Using DMA memory");
-    success = open_dma_device (mlpool);
+    success = gst_dma_arena_open (GST_DMA_ARENA_HEAP_SYSTEM);
   } else if (GST_IS_SYSTEM_MEMORY_TYPE (mlpool->priv->memtype)) {
     GST_INFO_OBJECT (mlpool, "Using SYSTEM memory");
     success = TRUE;
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __GST_ML_META_RECORDS_H__
+#define __GST_ML_META_RECORDS_H__
+
+#include <gst/gst.h>
+#include <string.h>
+
+G_BEGIN_DECLS
+
+/**
+ * Media type of the binary ML metadata. Buffers with this caps contain one or
+ * more #GstMLMetaBlock placed back to back, each one followed by its fixed
+ * size records. All fields are in host byte order.
+ */
+#define GST_ML_META_RECORDS_MEDIA_TYPE "application/x-qti-ml-meta"
+#define GST_ML_META_RECORDS_CAPS       GST_ML_META_RECORDS_MEDIA_TYPE
+
+#define GST_ML_META_BLOCK_MAGIC        GST_MAKE_FOURCC ('Q', 'M', 'L', 'M')
+#define GST_ML_META_BLOCK_VERSION      1
+
+#define GST_ML_META_LABEL_MAX_LENGTH   36
+#define GST_ML_META_LANDMARK_MAX_LENGTH 24
+
+#define GST_ML_META_BLOCK_SIZE(n_entries, n_landmarks)         \
+    (sizeof (GstMLMetaBlock) +                                 \
+     ((n_entries) * sizeof (GstMLDetectionRecord)) +           \
+     ((n_landmarks) * sizeof (GstMLLandmarkRecord)))
+
+#define GST_ML_META_BLOCK_DETECTIONS(block) \
+    ((GstMLDetectionRecord *) (((guint8 *) (block)) + sizeof (GstMLMetaBlock)))
+#define GST_ML_META_BLOCK_LANDMARKS(block) \
+    ((GstMLLandmarkRecord *) (GST_ML_META_BLOCK_DETECTIONS (block) + \
+        (block)->n_entries))
+
+typedef struct _GstMLMetaBlock GstMLMetaBlock;
+typedef struct _GstMLDetectionRecord GstMLDetectionRecord;
+typedef struct _GstMLLandmarkRecord GstMLLandmarkRecord;
+
+/**
+ * GstMLMetaBlockType:
+ * @GST_ML_META_BLOCK_DETECTION: Block with #GstMLDetectionRecord entries.
+ *
+ * Type of the records which follow the block header.
+ */
+typedef enum {
+  GST_ML_META_BLOCK_DETECTION = 1,
+} GstMLMetaBlockType;
+
+/**
+ * GstMLMetaBlockFlags:
+ * @GST_ML_META_BLOCK_FLAG_STREAM_ID: The stream_id field is valid.
+ * @GST_ML_META_BLOCK_FLAG_STREAM_TIMESTAMP: The stream_timestamp field is valid.
+ * @GST_ML_META_BLOCK_FLAG_PARENT_ID: The parent_id field is valid.
+ *
+ * Flags marking which of the optional block fields are set.
+ */
+typedef enum {
+  GST_ML_META_BLOCK_FLAG_STREAM_ID        = (1 << 0),
+  GST_ML_META_BLOCK_FLAG_STREAM_TIMESTAMP = (1 << 1),
+  GST_ML_META_BLOCK_FLAG_PARENT_ID        = (1 << 2),
+} GstMLMetaBlockFlags;
+
+/**
+ * GstMLMetaBlock:
+ * @magic: Always #GST_ML_META_BLOCK_MAGIC.
+ * @version: Always #GST_ML_META_BLOCK_VERSION.
+ * @type: Type of the records, one of #GstMLMetaBlockType.
+ * @size: Size in bytes of the block, including the header and all records.
+ * @flags: Bitwise OR of #GstMLMetaBlockFlags.
+ * @timestamp: Timestamp of the buffer from which the results were produced.
+ * @stream_timestamp: Optional timestamp of the originating stream buffer.
+ * @sequence_index: Index of this block in the sequence, starting from 1.
+ * @sequence_num_entries: Total number of blocks for the same timestamp.
+ * @stream_id: Optional ID of the originating stream.
+ * @parent_id: Optional ID of the ROI from which the results were derived.
+ * @n_entries: Number of records immediately following the header.
+ * @n_landmarks: Number of #GstMLLandmarkRecord following the records.
+ *
+ * Header of a group of results belonging to the same batch. It carries the
+ * same information as the fields of the "ObjectDetection" structure in the
+ * text output, with the exception of the per entry 'xtraparams'.
+ */
+struct _GstMLMetaBlock {
+  guint32 magic;
+  guint16 version;
+  guint16 type;
+  guint32 size;
+  guint32 flags;
+
+  guint64 timestamp;
+  guint64 stream_timestamp;
+
+  guint32 sequence_index;
+  guint32 sequence_num_entries;
+  gint32  stream_id;
+  gint32  parent_id;
+
+  guint32 n_entries;
+  guint32 n_landmarks;
+};
+
+/**
+ * GstMLDetectionRecord:
+ * @id: Meta ID of the detection.
+ * @color: Color associated with the label, in RGBA format.
+ * @confidence: Percentage certainty that the prediction is accurate.
+ * @x: X axis coordinate of upper-left corner, relative (0.0 to 1.0).
+ * @y: Y axis coordinate of upper-left corner, relative (0.0 to 1.0).
+ * @width: Relative (0.0 to 1.0) width of the bounding box.
+ * @height: Relative (0.0 to 1.0) height of the bounding box.
+ * @landmarks: Index of the first landmark in the block landmarks array.
+ * @n_landmarks: Number of landmarks belonging to this detection.
+ * @label: NULL terminated label, truncated if it doesn't fit.
+ */
+struct _GstMLDetectionRecord {
+  guint32 id;
+  guint32 color;
+  gfloat  confidence;
+
+  gfloat  x;
+  gfloat  y;
+  gfloat  width;
+  gfloat  height;
+
+  guint32 landmarks;
+  guint32 n_landmarks;
+
+  gchar   label[GST_ML_META_LABEL_MAX_LENGTH];
+};
+
+/**
+ * GstMLLandmarkRecord:
+ * @x: X axis coordinate, relative (0.0 to 1.0) to the bounding box.
+ * @y: Y axis coordinate, relative (0.0 to 1.0) to the bounding box.
+ * @name: NULL terminated landmark name, truncated if it doesn't fit.
+ */
+struct _GstMLLandmarkRecord {
+  gfloat x;
+  gfloat y;
+
+  gchar  name[GST_ML_META_LANDMARK_MAX_LENGTH];
+};
+
+G_STATIC_ASSERT (sizeof (GstMLMetaBlock) == 56);
+G_STATIC_ASSERT (sizeof (GstMLDetectionRecord) == 72);
+G_STATIC_ASSERT (sizeof (GstMLLandmarkRecord) == 32);
+
+/**
+ * gst_ml_meta_block_validate:
+ * @data: Pointer to the beginning of a block.
+ * @size: Number of bytes available from @data onwards.
+ *
+ * Check whether the data begins with a complete and consistent block, i.e. all
+ * of its records and landmark references are within the available bytes and
+ * all strings are NULL terminated.
+ *
+ * return: Pointer to the block on success or NULL on failure
+ */
+static inline const GstMLMetaBlock *
+gst_ml_meta_block_validate (gconstpointer data, gsize size)
+{
+  const GstMLMetaBlock *block = (const GstMLMetaBlock *) data;
+  const GstMLDetectionRecord *records = NULL;
+  const GstMLLandmarkRecord *landmarks = NULL;
+  guint idx = 0;
+
+  if (size < sizeof (GstMLMetaBlock))
+    return NULL;
+
+  if ((block->magic != GST_ML_META_BLOCK_MAGIC) ||
+      (block->version != GST_ML_META_BLOCK_VERSION) ||
+      (block->type != GST_ML_META_BLOCK_DETECTION))
+    return NULL;
+
+  // Guard against overflow before calculating the expected block size.
+  if ((block->n_entries > (size / sizeof (GstMLDetectionRecord))) ||
+      (block->n_landmarks > (size / sizeof (GstMLLandmarkRecord))))
+    return NULL;
+
+  if ((block->size > size) ||
+      (block->size != GST_ML_META_BLOCK_SIZE (block->n_entries,
+          block->n_landmarks)))
+    return NULL;
+
+  records = GST_ML_META_BLOCK_DETECTIONS (block);
+  landmarks = GST_ML_META_BLOCK_LANDMARKS (block);
+
+  for (idx = 0; idx < block->n_entries; idx++) {
+    if ((records[idx].landmarks > block->n_landmarks) ||
+        (records[idx].n_landmarks > (block->n_landmarks - records[idx].landmarks)))
+      return NULL;
+
+    if (memchr (records[idx].label, '\0', GST_ML_META_LABEL_MAX_LENGTH) == NULL)
+      return NULL;
+  }
+
+  for (idx = 0; idx < block->n_landmarks; idx++) {
+    if (memchr (landmarks[idx].name, '\0', GST_ML_META_LANDMARK_MAX_LENGTH) == NULL)
+      return NULL;
+  }
+
+  return block;
+}
+
+G_END_DECLS
+
+#endif // __GST_ML_META_RECORDS_H__
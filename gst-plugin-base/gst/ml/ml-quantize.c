@@ -0,0 +1,524 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "ml-quantize.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <gst/utils/common-utils.h>
+#include <gst/utils/float16-utils.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <immintrin.h>
+#endif // __ARM_NEON
+
+// Number of elements converted together by the vectorized kernels.
+#define GST_ML_QUANTIZE_BLOCK_SIZE 16
+
+// Round half to even and saturate to the [min, max] range. This matches the
+// default rounding mode used by the vectorized kernels (vcvtnq_s32_f32 and
+// _mm_cvtps_epi32), so tail elements round the same way as block elements.
+#define GST_ML_SATURATE(value, min, max) \
+    (((value) <= (min)) ? (min) : (((value) >= (max)) ? (max) : \
+        nearbyint (value)))
+
+static inline gfloat
+gst_ml_load_element (GstMLType type, const guint8 * data, gsize idx)
+{
+  switch (type) {
+    case GST_ML_TYPE_INT8:
+      return GINT8_PTR_CAST (data)[idx];
+    case GST_ML_TYPE_UINT8:
+      return GUINT8_PTR_CAST (data)[idx];
+    case GST_ML_TYPE_INT16:
+      return GINT16_PTR_CAST (data)[idx];
+    case GST_ML_TYPE_UINT16:
+      return GUINT16_PTR_CAST (data)[idx];
+    case GST_ML_TYPE_INT32:
+      return GINT32_PTR_CAST (data)[idx];
+    case GST_ML_TYPE_UINT32:
+      return GUINT32_PTR_CAST (data)[idx];
+    case GST_ML_TYPE_INT64:
+      return GINT64_PTR_CAST (data)[idx];
+    case GST_ML_TYPE_UINT64:
+      return GUINT64_PTR_CAST (data)[idx];
+    case GST_ML_TYPE_FLOAT16:
+#if defined(__ARM_FP16_FORMAT_IEEE)
+      return GFLOAT16_PTR_CAST (data)[idx];
+#else
+      return gst_half_to_float (GUINT16_PTR_CAST (data)[idx]);
+#endif // __ARM_FP16_FORMAT_IEEE
+    case GST_ML_TYPE_FLOAT32:
+      return GFLOAT_PTR_CAST (data)[idx];
+    default:
+      break;
+  }
+
+  return 0.0F;
+}
+
+static inline void
+gst_ml_store_element (GstMLType type, guint8 * data, gsize idx, gfloat value)
+{
+  gdouble number = value;
+
+  switch (type) {
+    case GST_ML_TYPE_INT8:
+      GINT8_PTR_CAST (data)[idx] =
+          (gint8) GST_ML_SATURATE (number, G_MININT8, G_MAXINT8);
+      break;
+    case GST_ML_TYPE_UINT8:
+      GUINT8_PTR_CAST (data)[idx] =
+          (guint8) GST_ML_SATURATE (number, 0.0, G_MAXUINT8);
+      break;
+    case GST_ML_TYPE_INT16:
+      GINT16_PTR_CAST (data)[idx] =
+          (gint16) GST_ML_SATURATE (number, G_MININT16, G_MAXINT16);
+      break;
+    case GST_ML_TYPE_UINT16:
+      GUINT16_PTR_CAST (data)[idx] =
+          (guint16) GST_ML_SATURATE (number, 0.0, G_MAXUINT16);
+      break;
+    case GST_ML_TYPE_INT32:
+      GINT32_PTR_CAST (data)[idx] =
+          (gint32) GST_ML_SATURATE (number, G_MININT32, G_MAXINT32);
+      break;
+    case GST_ML_TYPE_UINT32:
+      GUINT32_PTR_CAST (data)[idx] =
+          (guint32) GST_ML_SATURATE (number, 0.0, G_MAXUINT32);
+      break;
+    case GST_ML_TYPE_INT64:
+      // Limits which are exactly representable as double precision values.
+      GINT64_PTR_CAST (data)[idx] = (gint64) GST_ML_SATURATE (number,
+          -9223372036854775808.0, 9223372036854774784.0);
+      break;
+    case GST_ML_TYPE_UINT64:
+      GUINT64_PTR_CAST (data)[idx] = (guint64) GST_ML_SATURATE (number,
+          0.0, 18446744073709549568.0);
+      break;
+    case GST_ML_TYPE_FLOAT16:
+#if defined(__ARM_FP16_FORMAT_IEEE)
+      GFLOAT16_PTR_CAST (data)[idx] = (__fp16) value;
+#else
+      GUINT16_PTR_CAST (data)[idx] = gst_float_to_half (value);
+#endif // __ARM_FP16_FORMAT_IEEE
+      break;
+    case GST_ML_TYPE_FLOAT32:
+      GFLOAT_PTR_CAST (data)[idx] = value;
+      break;
+    default:
+      break;
+  }
+}
+
+static inline void
+gst_ml_dequantize_block (GstMLType type, const guint8 * indata,
+    gfloat * outdata, gfloat scale, gfloat bias)
+{
+  gfloat block[GST_ML_QUANTIZE_BLOCK_SIZE];
+  guint num = 0;
+
+  // All input elements of the block are loaded before anything is stored
+  // in order to allow in place expansion into the wider output elements.
+#if defined(__ARM_NEON)
+  float32x4_t values[4], vscale = vdupq_n_f32 (scale);
+  float32x4_t vbias = vdupq_n_f32 (bias);
+  uint16x8_t ulow, uhigh;
+  int16x8_t low, high;
+
+  switch (type) {
+    case GST_ML_TYPE_UINT8:
+      ulow = vmovl_u8 (vld1_u8 (indata));
+      uhigh = vmovl_u8 (vld1_u8 (indata + 8));
+
+      values[0] = vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (ulow)));
+      values[1] = vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (ulow)));
+      values[2] = vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (uhigh)));
+      values[3] = vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (uhigh)));
+      break;
+    case GST_ML_TYPE_INT8:
+      low = vmovl_s8 (vld1_s8 (GINT8_PTR_CAST (indata)));
+      high = vmovl_s8 (vld1_s8 (GINT8_PTR_CAST (indata) + 8));
+
+      values[0] = vcvtq_f32_s32 (vmovl_s16 (vget_low_s16 (low)));
+      values[1] = vcvtq_f32_s32 (vmovl_s16 (vget_high_s16 (low)));
+      values[2] = vcvtq_f32_s32 (vmovl_s16 (vget_low_s16 (high)));
+      values[3] = vcvtq_f32_s32 (vmovl_s16 (vget_high_s16 (high)));
+      break;
+    case GST_ML_TYPE_UINT16:
+      ulow = vld1q_u16 (GUINT16_PTR_CAST (indata));
+      uhigh = vld1q_u16 (GUINT16_PTR_CAST (indata) + 8);
+
+      values[0] = vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (ulow)));
+      values[1] = vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (ulow)));
+      values[2] = vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (uhigh)));
+      values[3] = vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (uhigh)));
+      break;
+    case GST_ML_TYPE_INT16:
+      low = vld1q_s16 (GINT16_PTR_CAST (indata));
+      high = vld1q_s16 (GINT16_PTR_CAST (indata) + 8);
+
+      values[0] = vcvtq_f32_s32 (vmovl_s16 (vget_low_s16 (low)));
+      values[1] = vcvtq_f32_s32 (vmovl_s16 (vget_high_s16 (low)));
+      values[2] = vcvtq_f32_s32 (vmovl_s16 (vget_low_s16 (high)));
+      values[3] = vcvtq_f32_s32 (vmovl_s16 (vget_high_s16 (high)));
+      break;
+    case GST_ML_TYPE_UINT32:
+      for (num = 0; num < 4; num++)
+        values[num] = vcvtq_f32_u32 (vld1q_u32 (GUINT32_PTR_CAST (indata) + (num * 4)));
+      break;
+    case GST_ML_TYPE_INT32:
+      for (num = 0; num < 4; num++)
+        values[num] = vcvtq_f32_s32 (vld1q_s32 (GINT32_PTR_CAST (indata) + (num * 4)));
+      break;
+#if defined(__aarch64__)
+    case GST_ML_TYPE_FLOAT16:
+      for (num = 0; num < 4; num++) {
+        values[num] = vcvt_f32_f16 (vreinterpret_f16_u16 (
+            vld1_u16 (GUINT16_PTR_CAST (indata) + (num * 4))));
+      }
+      break;
+#endif // __aarch64__
+    case GST_ML_TYPE_FLOAT32:
+      for (num = 0; num < 4; num++)
+        values[num] = vld1q_f32 (GFLOAT_PTR_CAST (indata) + (num * 4));
+      break;
+    default:
+      goto scalar;
+  }
+
+  for (num = 0; num < 4; num++)
+    vst1q_f32 (outdata + (num * 4), vmlaq_f32 (vbias, values[num], vscale));
+
+  return;
+#elif defined(__AVX2__)
+  __m256 values[2], vscale = _mm256_set1_ps (scale);
+  __m256 vbias = _mm256_set1_ps (bias);
+  __m128i pixels;
+
+  switch (type) {
+    case GST_ML_TYPE_UINT8:
+      pixels = _mm_loadu_si128 ((const __m128i *) indata);
+
+      values[0] = _mm256_cvtepi32_ps (_mm256_cvtepu8_epi32 (pixels));
+      values[1] = _mm256_cvtepi32_ps (
+          _mm256_cvtepu8_epi32 (_mm_srli_si128 (pixels, 8)));
+      break;
+    case GST_ML_TYPE_INT8:
+      pixels = _mm_loadu_si128 ((const __m128i *) indata);
+
+      values[0] = _mm256_cvtepi32_ps (_mm256_cvtepi8_epi32 (pixels));
+      values[1] = _mm256_cvtepi32_ps (
+          _mm256_cvtepi8_epi32 (_mm_srli_si128 (pixels, 8)));
+      break;
+    case GST_ML_TYPE_UINT16:
+      for (num = 0; num < 2; num++) {
+        pixels = _mm_loadu_si128 ((const __m128i *) (indata + (num * 16)));
+        values[num] = _mm256_cvtepi32_ps (_mm256_cvtepu16_epi32 (pixels));
+      }
+      break;
+    case GST_ML_TYPE_INT16:
+      for (num = 0; num < 2; num++) {
+        pixels = _mm_loadu_si128 ((const __m128i *) (indata + (num * 16)));
+        values[num] = _mm256_cvtepi32_ps (_mm256_cvtepi16_epi32 (pixels));
+      }
+      break;
+    case GST_ML_TYPE_INT32:
+      for (num = 0; num < 2; num++) {
+        values[num] = _mm256_cvtepi32_ps (
+            _mm256_loadu_si256 ((const __m256i *) (indata + (num * 32))));
+      }
+      break;
+#if defined(__F16C__)
+    case GST_ML_TYPE_FLOAT16:
+      for (num = 0; num < 2; num++) {
+        values[num] = _mm256_cvtph_ps (
+            _mm_loadu_si128 ((const __m128i *) (indata + (num * 16))));
+      }
+      break;
+#endif // __F16C__
+    case GST_ML_TYPE_FLOAT32:
+      for (num = 0; num < 2; num++)
+        values[num] = _mm256_loadu_ps (GFLOAT_PTR_CAST (indata) + (num * 8));
+      break;
+    default:
+      goto scalar;
+  }
+
+  for (num = 0; num < 2; num++) {
+    _mm256_storeu_ps (outdata + (num * 8),
+        _mm256_add_ps (vbias, _mm256_mul_ps (values[num], vscale)));
+  }
+
+  return;
+#elif defined(__SSE2__)
+  __m128 values[4], vscale = _mm_set1_ps (scale), vbias = _mm_set1_ps (bias);
+  __m128i zero = _mm_setzero_si128 (), pixels, low, high;
+
+  switch (type) {
+    case GST_ML_TYPE_UINT8:
+      pixels = _mm_loadu_si128 ((const __m128i *) indata);
+      low = _mm_unpacklo_epi8 (pixels, zero);
+      high = _mm_unpackhi_epi8 (pixels, zero);
+
+      values[0] = _mm_cvtepi32_ps (_mm_unpacklo_epi16 (low, zero));
+      values[1] = _mm_cvtepi32_ps (_mm_unpackhi_epi16 (low, zero));
+      values[2] = _mm_cvtepi32_ps (_mm_unpacklo_epi16 (high, zero));
+      values[3] = _mm_cvtepi32_ps (_mm_unpackhi_epi16 (high, zero));
+      break;
+    case GST_ML_TYPE_INT8:
+      // Sign extend by placing each element in the upper half of a wider lane
+      // and shifting it back down arithmetically.
+      pixels = _mm_loadu_si128 ((const __m128i *) indata);
+      low = _mm_srai_epi16 (_mm_unpacklo_epi8 (pixels, pixels), 8);
+      high = _mm_srai_epi16 (_mm_unpackhi_epi8 (pixels, pixels), 8);
+
+      values[0] = _mm_cvtepi32_ps (
+          _mm_srai_epi32 (_mm_unpacklo_epi16 (low, low), 16));
+      values[1] = _mm_cvtepi32_ps (
+          _mm_srai_epi32 (_mm_unpackhi_epi16 (low, low), 16));
+      values[2] = _mm_cvtepi32_ps (
+          _mm_srai_epi32 (_mm_unpacklo_epi16 (high, high), 16));
+      values[3] = _mm_cvtepi32_ps (
+          _mm_srai_epi32 (_mm_unpackhi_epi16 (high, high), 16));
+      break;
+    case GST_ML_TYPE_UINT16:
+      low = _mm_loadu_si128 ((const __m128i *) indata);
+      high = _mm_loadu_si128 ((const __m128i *) (indata + 16));
+
+      values[0] = _mm_cvtepi32_ps (_mm_unpacklo_epi16 (low, zero));
+      values[1] = _mm_cvtepi32_ps (_mm_unpackhi_epi16 (low, zero));
+      values[2] = _mm_cvtepi32_ps (_mm_unpacklo_epi16 (high, zero));
+      values[3] = _mm_cvtepi32_ps (_mm_unpackhi_epi16 (high, zero));
+      break;
+    case GST_ML_TYPE_INT16:
+      low = _mm_loadu_si128 ((const __m128i *) indata);
+      high = _mm_loadu_si128 ((const __m128i *) (indata + 16));
+
+      values[0] = _mm_cvtepi32_ps (
+          _mm_srai_epi32 (_mm_unpacklo_epi16 (low, low), 16));
+      values[1] = _mm_cvtepi32_ps (
+          _mm_srai_epi32 (_mm_unpackhi_epi16 (low, low), 16));
+      values[2] = _mm_cvtepi32_ps (
+          _mm_srai_epi32 (_mm_unpacklo_epi16 (high, high), 16));
+      values[3] = _mm_cvtepi32_ps (
+          _mm_srai_epi32 (_mm_unpackhi_epi16 (high, high), 16));
+      break;
+    case GST_ML_TYPE_INT32:
+      for (num = 0; num < 4; num++) {
+        values[num] = _mm_cvtepi32_ps (
+            _mm_loadu_si128 ((const __m128i *) (indata + (num * 16))));
+      }
+      break;
+#if defined(__F16C__)
+    case GST_ML_TYPE_FLOAT16:
+      for (num = 0; num < 4; num++) {
+        values[num] = _mm_cvtph_ps (
+            _mm_loadl_epi64 ((const __m128i *) (indata + (num * 8))));
+      }
+      break;
+#endif // __F16C__
+    case GST_ML_TYPE_FLOAT32:
+      for (num = 0; num < 4; num++)
+        values[num] = _mm_loadu_ps (GFLOAT_PTR_CAST (indata) + (num * 4));
+      break;
+    default:
+      goto scalar;
+  }
+
+  for (num = 0; num < 4; num++) {
+    _mm_storeu_ps (outdata + (num * 4),
+        _mm_add_ps (vbias, _mm_mul_ps (values[num], vscale)));
+  }
+
+  return;
+#endif // __ARM_NEON
+
+#if defined(__ARM_NEON) || defined(__SSE2__)
+scalar:
+#endif // __ARM_NEON || __SSE2__
+  for (num = 0; num < GST_ML_QUANTIZE_BLOCK_SIZE; num++)
+    block[num] = gst_ml_load_element (type, indata, num) * scale + bias;
+
+  memcpy (outdata, block, sizeof (block));
+}
+
+static inline void
+gst_ml_quantize_block (GstMLType type, const gfloat * indata,
+    guint8 * outdata, gfloat scale, gfloat offset)
+{
+  gfloat block[GST_ML_QUANTIZE_BLOCK_SIZE];
+  guint num = 0;
+
+  // Stage the block in order to allow in place narrowing of the input.
+  for (num = 0; num < GST_ML_QUANTIZE_BLOCK_SIZE; num++)
+    block[num] = indata[num] * scale + offset;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+  int16x8_t low, high;
+
+  switch (type) {
+    case GST_ML_TYPE_UINT8:
+    case GST_ML_TYPE_INT8:
+      low = vcombine_s16 (vqmovn_s32 (vcvtnq_s32_f32 (vld1q_f32 (block))),
+          vqmovn_s32 (vcvtnq_s32_f32 (vld1q_f32 (block + 4))));
+      high = vcombine_s16 (vqmovn_s32 (vcvtnq_s32_f32 (vld1q_f32 (block + 8))),
+          vqmovn_s32 (vcvtnq_s32_f32 (vld1q_f32 (block + 12))));
+
+      if (type == GST_ML_TYPE_UINT8)
+        vst1q_u8 (outdata, vcombine_u8 (vqmovun_s16 (low), vqmovun_s16 (high)));
+      else
+        vst1q_s8 (GINT8_PTR_CAST (outdata),
+            vcombine_s8 (vqmovn_s16 (low), vqmovn_s16 (high)));
+      return;
+    case GST_ML_TYPE_INT16:
+      for (num = 0; num < GST_ML_QUANTIZE_BLOCK_SIZE; num += 4) {
+        vst1_s16 (GINT16_PTR_CAST (outdata) + num,
+            vqmovn_s32 (vcvtnq_s32_f32 (vld1q_f32 (block + num))));
+      }
+      return;
+    case GST_ML_TYPE_FLOAT16:
+      for (num = 0; num < GST_ML_QUANTIZE_BLOCK_SIZE; num += 4) {
+        vst1_u16 (GUINT16_PTR_CAST (outdata) + num,
+            vreinterpret_u16_f16 (vcvt_f16_f32 (vld1q_f32 (block + num))));
+      }
+      return;
+    default:
+      break;
+  }
+#elif defined(__SSE2__)
+  __m128i low, high;
+
+  switch (type) {
+    case GST_ML_TYPE_UINT8:
+    case GST_ML_TYPE_INT8:
+      // Round to nearest, the default mode, and narrow with saturation.
+      low = _mm_packs_epi32 (_mm_cvtps_epi32 (_mm_loadu_ps (block)),
+          _mm_cvtps_epi32 (_mm_loadu_ps (block + 4)));
+      high = _mm_packs_epi32 (_mm_cvtps_epi32 (_mm_loadu_ps (block + 8)),
+          _mm_cvtps_epi32 (_mm_loadu_ps (block + 12)));
+
+      if (type == GST_ML_TYPE_UINT8)
+        _mm_storeu_si128 ((__m128i *) outdata, _mm_packus_epi16 (low, high));
+      else
+        _mm_storeu_si128 ((__m128i *) outdata, _mm_packs_epi16 (low, high));
+      return;
+    case GST_ML_TYPE_INT16:
+      for (num = 0; num < GST_ML_QUANTIZE_BLOCK_SIZE; num += 8) {
+        low = _mm_packs_epi32 (_mm_cvtps_epi32 (_mm_loadu_ps (block + num)),
+            _mm_cvtps_epi32 (_mm_loadu_ps (block + num + 4)));
+        _mm_storeu_si128 ((__m128i *) (GINT16_PTR_CAST (outdata) + num), low);
+      }
+      return;
+#if defined(__F16C__)
+    case GST_ML_TYPE_FLOAT16:
+      for (num = 0; num < GST_ML_QUANTIZE_BLOCK_SIZE; num += 4) {
+        _mm_storel_epi64 ((__m128i *) (GUINT16_PTR_CAST (outdata) + num),
+            _mm_cvtps_ph (_mm_loadu_ps (block + num), _MM_FROUND_TO_NEAREST_INT));
+      }
+      return;
+#endif // __F16C__
+    default:
+      break;
+  }
+#endif // __ARM_NEON && __aarch64__
+
+  for (num = 0; num < GST_ML_QUANTIZE_BLOCK_SIZE; num++)
+    gst_ml_store_element (type, outdata, num, block[num]);
+}
+
+void
+gst_ml_dequantize (GstMLType type, gconstpointer indata, gfloat * outdata,
+    gsize n_elements, gfloat scale, gfloat offset)
+{
+  const guint8 *source = indata;
+  gsize idx = 0, n_blocks = 0;
+  guint size = 0;
+  gfloat bias = 0.0F;
+
+  g_return_if_fail (type != GST_ML_TYPE_UNKNOWN);
+  g_return_if_fail (indata != NULL && outdata != NULL);
+
+  if ((type == GST_ML_TYPE_FLOAT32) && (scale == 1.0F) && (offset == 0.0F)) {
+    if (GPOINTER_CAST (outdata) != indata)
+      memcpy (outdata, indata, n_elements * sizeof (gfloat));
+
+    return;
+  }
+
+  size = gst_ml_type_get_size (type);
+
+  // Fold the offset into a single multiply-add per element.
+  bias = -offset * scale;
+
+  // Wider input elements are narrowed, which is safe in increasing order.
+  if (size > sizeof (gfloat)) {
+    for (idx = 0; idx < n_elements; idx++)
+      outdata[idx] = gst_ml_load_element (type, source, idx) * scale + bias;
+
+    return;
+  }
+
+  // Narrower input elements are expanded in decreasing order, otherwise in
+  // place conversion will overwrite elements which are not yet loaded.
+  n_blocks = n_elements / GST_ML_QUANTIZE_BLOCK_SIZE;
+
+  for (idx = n_elements; idx > (n_blocks * GST_ML_QUANTIZE_BLOCK_SIZE); idx--)
+    outdata[idx - 1] = gst_ml_load_element (type, source, idx - 1) * scale + bias;
+
+  while (n_blocks-- > 0) {
+    idx = n_blocks * GST_ML_QUANTIZE_BLOCK_SIZE;
+    gst_ml_dequantize_block (type, source + (idx * size), outdata + idx,
+        scale, bias);
+  }
+}
+
+void
+gst_ml_quantize (GstMLType type, const gfloat * indata, gpointer outdata,
+    gsize n_elements, gfloat scale, gfloat offset)
+{
+  guint8 *destination = outdata;
+  gsize idx = 0, length = 0;
+  guint size = 0;
+
+  g_return_if_fail (type != GST_ML_TYPE_UNKNOWN);
+  g_return_if_fail (indata != NULL && outdata != NULL);
+  g_return_if_fail (scale != 0.0F);
+
+  if ((type == GST_ML_TYPE_FLOAT32) && (scale == 1.0F) && (offset == 0.0F)) {
+    if (GPOINTER_CAST (indata) != outdata)
+      memcpy (outdata, indata, n_elements * sizeof (gfloat));
+
+    return;
+  }
+
+  size = gst_ml_type_get_size (type);
+
+  // Replace the division with a multiplication by the reciprocal.
+  scale = 1.0F / scale;
+
+  // Wider output elements are expanded, which is safe in decreasing order.
+  if (size > sizeof (gfloat)) {
+    for (idx = n_elements; idx > 0; idx--)
+      gst_ml_store_element (type, destination, idx - 1,
+          indata[idx - 1] * scale + offset);
+
+    return;
+  }
+
+  // Narrower output elements are stored in increasing order, otherwise in
+  // place conversion will overwrite elements which are not yet loaded.
+  length = n_elements - (n_elements % GST_ML_QUANTIZE_BLOCK_SIZE);
+
+  for (idx = 0; idx < length; idx += GST_ML_QUANTIZE_BLOCK_SIZE)
+    gst_ml_quantize_block (type, indata + idx, destination + (idx * size),
+        scale, offset);
+
+  for (; idx < n_elements; idx++)
+    gst_ml_store_element (type, destination, idx, indata[idx] * scale + offset);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __GST_ML_QUANTIZE_H__
+#define __GST_ML_QUANTIZE_H__
+
+#include <gst/gst.h>
+#include <gst/ml/ml-type.h>
+
+G_BEGIN_DECLS
+
+/**
+ * gst_ml_dequantize:
+ * @type: The data type of the input elements.
+ * @indata: Pointer to the input elements.
+ * @outdata: Pointer to the output FLOAT32 elements.
+ * @n_elements: Number of elements to convert.
+ * @scale: Dequantization scale.
+ * @offset: Dequantization offset (zero point).
+ *
+ * Convert elements of any #GstMLType into FLOAT32 as (value - offset) * scale.
+ * FLOAT16 elements are converted with the same formula, pass 1.0 scale and
+ * 0.0 offset for a plain conversion into FLOAT32.
+ *
+ * The output may begin at the same address as the input, in which case the
+ * elements are expanded in place. Any other overlap is not allowed.
+ *
+ * return: NONE
+ */
+GST_API void
+gst_ml_dequantize (GstMLType type, gconstpointer indata, gfloat * outdata,
+                   gsize n_elements, gfloat scale, gfloat offset);
+
+/**
+ * gst_ml_quantize:
+ * @type: The data type of the output elements.
+ * @indata: Pointer to the input FLOAT32 elements.
+ * @outdata: Pointer to the output elements.
+ * @n_elements: Number of elements to convert.
+ * @scale: Quantization scale.
+ * @offset: Quantization offset (zero point).
+ *
+ * Convert FLOAT32 elements into any #GstMLType as (value / scale) + offset,
+ * rounded to nearest and saturated to the range of the output type. FLOAT16
+ * elements are converted with the same formula, without rounding.
+ *
+ * The output may begin at the same address as the input, in which case the
+ * elements are narrowed in place. Any other overlap is not allowed.
+ *
+ * return: NONE
+ */
+GST_API void
+gst_ml_quantize (GstMLType type, const gfloat * indata, gpointer outdata,
+                 gsize n_elements, gfloat scale, gfloat offset);
+
+G_END_DECLS
+
+#endif // __GST_ML_QUANTIZE_H__
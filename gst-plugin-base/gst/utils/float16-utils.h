@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __GST_QTI_FLOAT16_UTILS_H__
+#define __GST_QTI_FLOAT16_UTILS_H__
+
+// Only standard types are used, the header is shared with the ML post-process
+// modules which do not depend on GLib.
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * gst_float_to_half:
+ * @value: Single precision float value.
+ *
+ * Convert to IEEE half precision with round to nearest, for platforms
+ * without native FLOAT16 support.
+ *
+ * return: The binary representation of the half precision value
+ */
+static inline uint16_t
+gst_float_to_half (float value)
+{
+  union { float f; uint32_t u; } bits;
+  uint32_t sign = 0, mantissa = 0;
+  int32_t exponent = 0;
+
+  bits.f = value;
+
+  sign = (bits.u >> 16) & 0x8000;
+  mantissa = bits.u & 0x007FFFFF;
+  exponent = (int32_t) ((bits.u >> 23) & 0xFF) - 127 + 15;
+
+  // Infinity or NaN.
+  if (((bits.u >> 23) & 0xFF) == 0xFF)
+    return sign | 0x7C00 | ((mantissa != 0) ? 0x0200 : 0);
+
+  // Overflow, saturate to infinity.
+  if (exponent >= 0x1F)
+    return sign | 0x7C00;
+
+  // Subnormal result or underflow to signed zero.
+  if (exponent <= 0) {
+    uint32_t shift = 14 - exponent;
+
+    if (exponent < -10)
+      return sign;
+
+    mantissa |= 0x00800000;
+    return sign | ((mantissa + (1 << (shift - 1))) >> shift);
+  }
+
+  // Round to nearest, a carry will correctly propagate into the exponent.
+  return (sign | (exponent << 10) | (mantissa >> 13)) +
+      ((mantissa >> 12) & 0x1);
+}
+
+/**
+ * gst_half_to_float:
+ * @value: Binary representation of IEEE half precision value.
+ *
+ * Convert to single precision float, for platforms without native FLOAT16
+ * support.
+ *
+ * return: The single precision float value
+ */
+static inline float
+gst_half_to_float (uint16_t value)
+{
+  union { float f; uint32_t u; } bits;
+  uint32_t sign = (uint32_t) (value & 0x8000) << 16;
+  uint32_t mantissa = value & 0x03FF, exponent = (value >> 10) & 0x1F;
+
+  if (exponent == 0) {
+    bits.f = mantissa / 16777216.0F;
+    bits.u |= sign;
+  } else if (exponent == 0x1F) {
+    bits.u = sign | 0x7F800000 | (mantissa << 13);
+  } else {
+    bits.u = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+  }
+
+  return bits.f;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __GST_QTI_FLOAT16_UTILS_H__
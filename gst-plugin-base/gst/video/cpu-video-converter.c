@@ -0,0 +1,1276 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "cpu-video-converter.h"
+#include "video-normalize.h"
+
+#include <string.h>
+
+#include <gst/utils/common-utils.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif // __ARM_NEON
+
+#define GST_CAT_DEFAULT gst_video_converter_engine_debug
+
+#define GST_CPU_GET_LOCK(obj)       (&((GstCpuVideoConverter *)obj)->lock)
+#define GST_CPU_LOCK(obj)           g_mutex_lock (GST_CPU_GET_LOCK(obj))
+#define GST_CPU_UNLOCK(obj)         g_mutex_unlock (GST_CPU_GET_LOCK(obj))
+
+// Upper limit for the number of threads used for a single composition.
+#define GST_CPU_MAX_THREADS         32
+// Minimum number of output rows processed by a single task.
+#define GST_CPU_MIN_TILE_ROWS       16
+
+// Offset and scale used for converting 8-bit values into signed and float types.
+#define GST_CPU_INT8_OFFSET         128.0F
+#define GST_CPU_FLOAT_SCALE         (1.0F / G_MAXUINT8)
+
+// Indexes of the channels in the intermediate row buffers.
+#define GST_CPU_CHANNEL_RED         0
+#define GST_CPU_CHANNEL_GREEN       1
+#define GST_CPU_CHANNEL_BLUE        2
+#define GST_CPU_CHANNEL_ALPHA       3
+
+// Vector abstraction over the supported SIMD instruction sets.
+#if defined(__ARM_NEON)
+#define GST_CPU_VECTOR_SIZE         4
+typedef float32x4_t GstCpuVector;
+#define GST_CPU_VLOAD(ptr)          vld1q_f32 (ptr)
+#define GST_CPU_VSTORE(ptr, v)      vst1q_f32 (ptr, v)
+#define GST_CPU_VSPLAT(value)       vdupq_n_f32 (value)
+#define GST_CPU_VADD(l, r)          vaddq_f32 (l, r)
+#define GST_CPU_VSUB(l, r)          vsubq_f32 (l, r)
+#define GST_CPU_VMUL(l, r)          vmulq_f32 (l, r)
+#define GST_CPU_VMIN(l, r)          vminq_f32 (l, r)
+#define GST_CPU_VMAX(l, r)          vmaxq_f32 (l, r)
+#elif defined(__AVX__)
+#define GST_CPU_VECTOR_SIZE         8
+typedef __m256 GstCpuVector;
+#define GST_CPU_VLOAD(ptr)          _mm256_loadu_ps (ptr)
+#define GST_CPU_VSTORE(ptr, v)      _mm256_storeu_ps (ptr, v)
+#define GST_CPU_VSPLAT(value)       _mm256_set1_ps (value)
+#define GST_CPU_VADD(l, r)          _mm256_add_ps (l, r)
+#define GST_CPU_VSUB(l, r)          _mm256_sub_ps (l, r)
+#define GST_CPU_VMUL(l, r)          _mm256_mul_ps (l, r)
+#define GST_CPU_VMIN(l, r)          _mm256_min_ps (l, r)
+#define GST_CPU_VMAX(l, r)          _mm256_max_ps (l, r)
+#elif defined(__SSE2__)
+#define GST_CPU_VECTOR_SIZE         4
+typedef __m128 GstCpuVector;
+#define GST_CPU_VLOAD(ptr)          _mm_loadu_ps (ptr)
+#define GST_CPU_VSTORE(ptr, v)      _mm_storeu_ps (ptr, v)
+#define GST_CPU_VSPLAT(value)       _mm_set1_ps (value)
+#define GST_CPU_VADD(l, r)          _mm_add_ps (l, r)
+#define GST_CPU_VSUB(l, r)          _mm_sub_ps (l, r)
+#define GST_CPU_VMUL(l, r)          _mm_mul_ps (l, r)
+#define GST_CPU_VMIN(l, r)          _mm_min_ps (l, r)
+#define GST_CPU_VMAX(l, r)          _mm_max_ps (l, r)
+#endif // __ARM_NEON
+
+#define GST_CPU_VMLA(acc, l, r)     GST_CPU_VADD (acc, GST_CPU_VMUL (l, r))
+
+typedef struct _GstCpuTap GstCpuTap;
+typedef struct _GstCpuComponent GstCpuComponent;
+typedef struct _GstCpuYuvCoeffs GstCpuYuvCoeffs;
+typedef struct _GstCpuOutput GstCpuOutput;
+typedef struct _GstCpuBlitContext GstCpuBlitContext;
+typedef struct _GstCpuFillContext GstCpuFillContext;
+typedef struct _GstCpuTask GstCpuTask;
+typedef struct _GstCpuScratch GstCpuScratch;
+
+typedef void (*GstCpuTaskFunction) (gpointer context, gint first, gint last);
+
+typedef enum {
+  GST_CPU_FAMILY_GRAY,
+  GST_CPU_FAMILY_RGB,
+  GST_CPU_FAMILY_YUV,
+} GstCpuFamily;
+
+/**
+ * GstCpuTap:
+ * @offset0: Byte offset of the first sample along one of the axes.
+ * @offset1: Byte offset of the second sample along one of the axes.
+ * @weight: Interpolation weight of the second sample.
+ *
+ * Bilinear interpolation tap along a single axis of a component plane.
+ */
+struct _GstCpuTap
+{
+  gsize  offset0;
+  gsize  offset1;
+  gfloat weight;
+};
+
+/**
+ * GstCpuComponent:
+ * @data: Pointer to the first byte of the component in the input frame.
+ * @taps: Precalculated taps for each output column.
+ * @step: Byte step between two neighbouring samples along the row axis.
+ * @subsample: Subsampling of the component along the row axis.
+ * @first: Index of the first valid sample along the row axis.
+ * @last: Index of the last valid sample along the row axis.
+ *
+ * Input video frame component sampled by a blit.
+ */
+struct _GstCpuComponent
+{
+  const guint8 *data;
+  GstCpuTap    *taps;
+
+  gint         step;
+  gint         subsample;
+  gint         first;
+  gint         last;
+};
+
+/**
+ * GstCpuYuvCoeffs:
+ * @yoffset: Luma offset, 16 for limited and 0 for full range.
+ * @yscale: Luma scale factor.
+ * @rv: Contribution of Cr to red.
+ * @gu: Contribution of Cb to green.
+ * @gv: Contribution of Cr to green.
+ * @bu: Contribution of Cb to blue.
+ *
+ * YUV to RGB conversion coefficients derived from the input colorimetry.
+ */
+struct _GstCpuYuvCoeffs
+{
+  gfloat yoffset;
+  gfloat yscale;
+  gfloat rv;
+  gfloat gu;
+  gfloat gv;
+  gfloat bu;
+};
+
+/**
+ * GstCpuOutput:
+ * @data: Pointer to the first byte of the output frame.
+ * @stride: Aligned width of the output frame in bytes.
+ * @width: Width of the output frame in pixels.
+ * @height: Height of the output frame in pixels.
+ * @n_elements: Number of elements in a single pixel.
+ * @n_bytes: Number of bytes in a single element.
+ * @datatype: The data type of the elements.
+ * @channels: Index of the channel which is stored at a given pixel position.
+ * @scales: Fused normalization scale factor for each pixel position.
+ * @offsets: Fused normalization offset for each pixel position.
+ * @identity: Whether the normalization for all positions is a no-op.
+ *
+ * Output frame along with the fused normalization parameters.
+ */
+struct _GstCpuOutput
+{
+  guint8  *data;
+  gint    stride;
+  gint    width;
+  gint    height;
+
+  guint   n_elements;
+  guint   n_bytes;
+  guint64 datatype;
+
+  guint   channels[GST_VCE_MAX_CHANNELS];
+  gfloat  scales[GST_VCE_MAX_CHANNELS];
+  gfloat  offsets[GST_VCE_MAX_CHANNELS];
+  gboolean identity;
+};
+
+/**
+ * GstCpuBlitContext:
+ * @output: The output frame.
+ * @family: Color family of the input frame.
+ * @components: Sampled input frame components.
+ * @n_components: Number of sampled input frame components.
+ * @coeffs: YUV to RGB conversion coefficients.
+ * @alpha: Global alpha in the range 0.0 - 1.0.
+ * @x: Index of the first output column.
+ * @width: Number of output columns.
+ * @origin: Output row corresponding to the start of the destination rectangle.
+ * @rscale: Ratio between source and destination sizes along the row axis.
+ * @rinvert: Whether the row axis is traversed in reverse direction.
+ * @rdimension: Size of the source rectangle along the row axis.
+ * @rorigin: Start of the source rectangle along the row axis.
+ *
+ * Parameters shared between all tasks processing the rows of a single blit.
+ */
+struct _GstCpuBlitContext
+{
+  GstCpuOutput    *output;
+
+  GstCpuFamily    family;
+  GstCpuComponent components[GST_VCE_MAX_CHANNELS];
+  guint           n_components;
+  GstCpuYuvCoeffs coeffs;
+  gfloat          alpha;
+
+  gint            x;
+  gint            width;
+  gint            origin;
+
+  gfloat          rscale;
+  gboolean        rinvert;
+  gint            rdimension;
+  gint            rorigin;
+};
+
+/**
+ * GstCpuFillContext:
+ * @output: The output frame.
+ * @pattern: One row of background pixels in the output data type.
+ *
+ * Parameters shared between all tasks filling the output background.
+ */
+struct _GstCpuFillContext
+{
+  GstCpuOutput *output;
+  guint8       *pattern;
+};
+
+/**
+ * GstCpuTask:
+ * @function: The function which will process the rows.
+ * @context: Context passed to the function.
+ * @first: Index of the first row processed by the task.
+ * @last: Index after the last row processed by the task.
+ *
+ * Tile of consecutive output rows processed by a single thread.
+ */
+struct _GstCpuTask
+{
+  GstCpuTaskFunction function;
+  gpointer           context;
+  gint               first;
+  gint               last;
+};
+
+/**
+ * GstCpuScratch:
+ * @size: Number of floats in the scratch memory.
+ * @data: Scratch memory.
+ *
+ * Per thread memory for the intermediate row buffers.
+ */
+struct _GstCpuScratch
+{
+  gsize  size;
+  gfloat data[];
+};
+
+struct _GstCpuVideoConverter
+{
+  // Global mutex lock.
+  GMutex      lock;
+
+  // Worker threads, NULL if running in single threaded mode.
+  GThreadPool *workers;
+  // Maximum number of threads (including the caller) used for a composition.
+  guint       n_threads;
+
+  // Number of tasks pushed to the worker threads which are not yet done.
+  guint       pending;
+  GMutex      tasklock;
+  GCond       wakeup;
+};
+
+static GPrivate scratch_key = G_PRIVATE_INIT (g_free);
+
+static inline gfloat *
+gst_cpu_get_scratch (gsize size)
+{
+  GstCpuScratch *scratch = g_private_get (&scratch_key);
+
+  if ((scratch == NULL) || (scratch->size < size)) {
+    scratch = g_malloc (sizeof (GstCpuScratch) + size * sizeof (gfloat));
+    scratch->size = size;
+
+    g_private_replace (&scratch_key, scratch);
+  }
+
+  return scratch->data;
+}
+
+static inline gint
+gst_cpu_floor (gfloat value)
+{
+  gint integer = (gint) value;
+  return (value < integer) ? (integer - 1) : integer;
+}
+
+static inline guint8
+gst_cpu_saturate_u8 (gfloat value)
+{
+  value = CLAMP (value, 0.0F, 255.0F);
+  return (guint8) (value + 0.5F);
+}
+
+static inline gint8
+gst_cpu_saturate_i8 (gfloat value)
+{
+  value = CLAMP (value, -128.0F, 127.0F);
+  return (gint8) gst_cpu_floor (value + 0.5F);
+}
+
+static inline gfloat
+gst_cpu_load_element (const guint8 * data, guint idx, guint64 datatype)
+{
+  switch (datatype) {
+    case GST_VCE_DATA_TYPE_U8:
+      return GUINT8_PTR_CAST (data)[idx];
+    case GST_VCE_DATA_TYPE_I8:
+      return GINT8_PTR_CAST (data)[idx];
+    case GST_VCE_DATA_TYPE_F16:
+#if defined(__ARM_FP16_FORMAT_IEEE)
+      return GFLOAT16_PTR_CAST (data)[idx];
+#else
+      return gst_half_to_float (GUINT16_PTR_CAST (data)[idx]);
+#endif // __ARM_FP16_FORMAT_IEEE
+    case GST_VCE_DATA_TYPE_F32:
+      return GFLOAT_PTR_CAST (data)[idx];
+  }
+
+  return 0.0F;
+}
+
+static inline void
+gst_cpu_store_element (guint8 * data, guint idx, gfloat value,
+    guint64 datatype)
+{
+  switch (datatype) {
+    case GST_VCE_DATA_TYPE_U8:
+      GUINT8_PTR_CAST (data)[idx] = gst_cpu_saturate_u8 (value);
+      break;
+    case GST_VCE_DATA_TYPE_I8:
+      GINT8_PTR_CAST (data)[idx] = gst_cpu_saturate_i8 (value);
+      break;
+    case GST_VCE_DATA_TYPE_F16:
+#if defined(__ARM_FP16_FORMAT_IEEE)
+      GFLOAT16_PTR_CAST (data)[idx] = (__fp16) value;
+#else
+      GUINT16_PTR_CAST (data)[idx] = gst_float_to_half (value);
+#endif // __ARM_FP16_FORMAT_IEEE
+      break;
+    case GST_VCE_DATA_TYPE_F32:
+      GFLOAT_PTR_CAST (data)[idx] = value;
+      break;
+  }
+}
+
+static inline guint
+gst_cpu_data_type_size (guint64 datatype)
+{
+  switch (datatype) {
+    case GST_VCE_DATA_TYPE_U8:
+    case GST_VCE_DATA_TYPE_I8:
+      return 1;
+    case GST_VCE_DATA_TYPE_F16:
+      return 2;
+    case GST_VCE_DATA_TYPE_F32:
+      return 4;
+  }
+
+  return 0;
+}
+
+static inline void
+gst_cpu_tap_init (GstCpuTap * tap, gfloat coordinate, gint subsample,
+    gint first, gint last, gint step)
+{
+  gint idx0 = 0, idx1 = 0;
+
+  // Translate pixel center from full resolution into the component plane.
+  if (subsample != 0)
+    coordinate = ((coordinate + 0.5F) / (1 << subsample)) - 0.5F;
+
+  idx0 = gst_cpu_floor (coordinate);
+  idx1 = idx0 + 1;
+
+  tap->weight = coordinate - idx0;
+
+  idx0 = CLAMP (idx0, first, last);
+  idx1 = CLAMP (idx1, first, last);
+
+  if (idx0 == idx1)
+    tap->weight = 0.0F;
+
+  tap->offset0 = (gsize) idx0 * step;
+  tap->offset1 = (gsize) idx1 * step;
+}
+
+static inline gfloat
+gst_cpu_map_coordinate (gint idx, gfloat scale, gboolean invert,
+    gint dimension, gint origin)
+{
+  gfloat coordinate = ((idx + 0.5F) * scale) - 0.5F;
+
+  // Rotation and flip are expressed as a traversal in reverse direction.
+  if (invert)
+    coordinate = (dimension - 1) - coordinate;
+
+  coordinate = CLAMP (coordinate, 0.0F, (gfloat) (dimension - 1));
+  return origin + coordinate;
+}
+
+static inline void
+gst_cpu_sample_row (const GstCpuComponent * component, const GstCpuTap * rtap,
+    gfloat * outdata, gint n_pixels)
+{
+  const guint8 *row0 = component->data + rtap->offset0;
+  const guint8 *row1 = component->data + rtap->offset1;
+  const GstCpuTap *taps = component->taps;
+  gfloat top = 0.0F, bottom = 0.0F;
+  gint idx = 0;
+
+  // Fast path for rows which are aligned with the source samples.
+  if (rtap->weight == 0.0F) {
+    for (idx = 0; idx < n_pixels; idx++) {
+      top = row0[taps[idx].offset0];
+      outdata[idx] = top + (row0[taps[idx].offset1] - top) * taps[idx].weight;
+    }
+    return;
+  }
+
+  for (idx = 0; idx < n_pixels; idx++) {
+    top = row0[taps[idx].offset0];
+    top += (row0[taps[idx].offset1] - top) * taps[idx].weight;
+
+    bottom = row1[taps[idx].offset0];
+    bottom += (row1[taps[idx].offset1] - bottom) * taps[idx].weight;
+
+    outdata[idx] = top + (bottom - top) * rtap->weight;
+  }
+}
+
+static inline void
+gst_cpu_yuv_to_rgb (gfloat * y_r, gfloat * u_g, gfloat * v_b, gint n_pixels,
+    const GstCpuYuvCoeffs * coeffs)
+{
+  gfloat luma = 0.0F, cb = 0.0F, cr = 0.0F;
+  gint idx = 0;
+
+#if defined(GST_CPU_VECTOR_SIZE)
+  GstCpuVector yoffset = GST_CPU_VSPLAT (coeffs->yoffset);
+  GstCpuVector yscale = GST_CPU_VSPLAT (coeffs->yscale);
+  GstCpuVector rv = GST_CPU_VSPLAT (coeffs->rv);
+  GstCpuVector gu = GST_CPU_VSPLAT (-coeffs->gu);
+  GstCpuVector gv = GST_CPU_VSPLAT (-coeffs->gv);
+  GstCpuVector bu = GST_CPU_VSPLAT (coeffs->bu);
+  GstCpuVector center = GST_CPU_VSPLAT (128.0F);
+  GstCpuVector minimum = GST_CPU_VSPLAT (0.0F);
+  GstCpuVector maximum = GST_CPU_VSPLAT (255.0F);
+  GstCpuVector vluma, vcb, vcr, red, green, blue;
+
+  for (; (idx + GST_CPU_VECTOR_SIZE) <= n_pixels; idx += GST_CPU_VECTOR_SIZE) {
+    vluma = GST_CPU_VSUB (GST_CPU_VLOAD (y_r + idx), yoffset);
+    vluma = GST_CPU_VMUL (vluma, yscale);
+    vcb = GST_CPU_VSUB (GST_CPU_VLOAD (u_g + idx), center);
+    vcr = GST_CPU_VSUB (GST_CPU_VLOAD (v_b + idx), center);
+
+    red = GST_CPU_VMLA (vluma, vcr, rv);
+    green = GST_CPU_VMLA (GST_CPU_VMLA (vluma, vcb, gu), vcr, gv);
+    blue = GST_CPU_VMLA (vluma, vcb, bu);
+
+    GST_CPU_VSTORE (y_r + idx,
+        GST_CPU_VMIN (GST_CPU_VMAX (red, minimum), maximum));
+    GST_CPU_VSTORE (u_g + idx,
+        GST_CPU_VMIN (GST_CPU_VMAX (green, minimum), maximum));
+    GST_CPU_VSTORE (v_b + idx,
+        GST_CPU_VMIN (GST_CPU_VMAX (blue, minimum), maximum));
+  }
+#endif // GST_CPU_VECTOR_SIZE
+
+  for (; idx < n_pixels; idx++) {
+    luma = (y_r[idx] - coeffs->yoffset) * coeffs->yscale;
+    cb = u_g[idx] - 128.0F;
+    cr = v_b[idx] - 128.0F;
+
+    y_r[idx] = CLAMP (luma + cr * coeffs->rv, 0.0F, 255.0F);
+    u_g[idx] = CLAMP (luma - cb * coeffs->gu - cr * coeffs->gv, 0.0F, 255.0F);
+    v_b[idx] = CLAMP (luma + cb * coeffs->bu, 0.0F, 255.0F);
+  }
+}
+
+static inline void
+gst_cpu_affine (const gfloat * indata, gfloat * outdata, gint n_pixels,
+    gfloat scale, gfloat offset)
+{
+  gint idx = 0;
+
+#if defined(GST_CPU_VECTOR_SIZE)
+  GstCpuVector vscale = GST_CPU_VSPLAT (scale);
+  GstCpuVector voffset = GST_CPU_VSPLAT (offset);
+
+  for (; (idx + GST_CPU_VECTOR_SIZE) <= n_pixels; idx += GST_CPU_VECTOR_SIZE) {
+    GST_CPU_VSTORE (outdata + idx,
+        GST_CPU_VMLA (voffset, GST_CPU_VLOAD (indata + idx), vscale));
+  }
+#endif // GST_CPU_VECTOR_SIZE
+
+  for (; idx < n_pixels; idx++)
+    outdata[idx] = indata[idx] * scale + offset;
+}
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+static inline int16x8_t
+gst_cpu_neon_round_s16 (const gfloat * data)
+{
+  int32x4_t low = vcvtnq_s32_f32 (vld1q_f32 (data));
+  int32x4_t high = vcvtnq_s32_f32 (vld1q_f32 (data + 4));
+
+  return vcombine_s16 (vqmovn_s32 (low), vqmovn_s32 (high));
+}
+
+static inline gint
+gst_cpu_neon_store_row (guint8 * outdata, gfloat * planes[],
+    guint n_elements, gint n_pixels, guint64 datatype)
+{
+  gint idx = 0;
+
+  if ((n_elements != 3) && (n_elements != 4))
+    return 0;
+
+  switch (datatype) {
+    case GST_VCE_DATA_TYPE_U8:
+      for (; (idx + 8) <= n_pixels; idx += 8) {
+        uint8x8x4_t pixels;
+
+        pixels.val[0] = vqmovun_s16 (gst_cpu_neon_round_s16 (planes[0] + idx));
+        pixels.val[1] = vqmovun_s16 (gst_cpu_neon_round_s16 (planes[1] + idx));
+        pixels.val[2] = vqmovun_s16 (gst_cpu_neon_round_s16 (planes[2] + idx));
+
+        if (n_elements == 4) {
+          pixels.val[3] =
+              vqmovun_s16 (gst_cpu_neon_round_s16 (planes[3] + idx));
+          vst4_u8 (outdata + idx * 4, pixels);
+        } else {
+          vst3_u8 (outdata + idx * 3,
+              (uint8x8x3_t) {{ pixels.val[0], pixels.val[1], pixels.val[2] }});
+        }
+      }
+      break;
+    case GST_VCE_DATA_TYPE_I8:
+      for (; (idx + 8) <= n_pixels; idx += 8) {
+        int8x8x4_t pixels;
+
+        pixels.val[0] = vqmovn_s16 (gst_cpu_neon_round_s16 (planes[0] + idx));
+        pixels.val[1] = vqmovn_s16 (gst_cpu_neon_round_s16 (planes[1] + idx));
+        pixels.val[2] = vqmovn_s16 (gst_cpu_neon_round_s16 (planes[2] + idx));
+
+        if (n_elements == 4) {
+          pixels.val[3] = vqmovn_s16 (gst_cpu_neon_round_s16 (planes[3] + idx));
+          vst4_s8 (GINT8_PTR_CAST (outdata) + idx * 4, pixels);
+        } else {
+          vst3_s8 (GINT8_PTR_CAST (outdata) + idx * 3,
+              (int8x8x3_t) {{ pixels.val[0], pixels.val[1], pixels.val[2] }});
+        }
+      }
+      break;
+#if defined(__ARM_FP16_FORMAT_IEEE)
+    case GST_VCE_DATA_TYPE_F16:
+      for (; (idx + 4) <= n_pixels; idx += 4) {
+        float16x4x4_t pixels;
+
+        pixels.val[0] = vcvt_f16_f32 (vld1q_f32 (planes[0] + idx));
+        pixels.val[1] = vcvt_f16_f32 (vld1q_f32 (planes[1] + idx));
+        pixels.val[2] = vcvt_f16_f32 (vld1q_f32 (planes[2] + idx));
+
+        if (n_elements == 4) {
+          pixels.val[3] = vcvt_f16_f32 (vld1q_f32 (planes[3] + idx));
+          vst4_f16 (GFLOAT16_PTR_CAST (outdata) + idx * 4, pixels);
+        } else {
+          vst3_f16 (GFLOAT16_PTR_CAST (outdata) + idx * 3,
+              (float16x4x3_t) {{ pixels.val[0], pixels.val[1], pixels.val[2] }});
+        }
+      }
+      break;
+#endif // __ARM_FP16_FORMAT_IEEE
+    case GST_VCE_DATA_TYPE_F32:
+      for (; (idx + 4) <= n_pixels; idx += 4) {
+        float32x4x4_t pixels;
+
+        pixels.val[0] = vld1q_f32 (planes[0] + idx);
+        pixels.val[1] = vld1q_f32 (planes[1] + idx);
+        pixels.val[2] = vld1q_f32 (planes[2] + idx);
+
+        if (n_elements == 4) {
+          pixels.val[3] = vld1q_f32 (planes[3] + idx);
+          vst4q_f32 (GFLOAT_PTR_CAST (outdata) + idx * 4, pixels);
+        } else {
+          vst3q_f32 (GFLOAT_PTR_CAST (outdata) + idx * 3,
+              (float32x4x3_t) {{ pixels.val[0], pixels.val[1], pixels.val[2] }});
+        }
+      }
+      break;
+  }
+
+  return idx;
+}
+#endif // __ARM_NEON && __aarch64__
+
+static inline void
+gst_cpu_store_row (guint8 * outdata, gfloat * planes[], guint n_elements,
+    gint n_pixels, guint64 datatype)
+{
+  gint idx = 0;
+  guint num = 0;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+  // Interleave and convert the bulk of the row with NEON structure stores.
+  idx = gst_cpu_neon_store_row (outdata, planes, n_elements, n_pixels,
+      datatype);
+#endif // __ARM_NEON && __aarch64__
+
+  for (; idx < n_pixels; idx++) {
+    for (num = 0; num < n_elements; num++) {
+      gst_cpu_store_element (outdata, (idx * n_elements) + num,
+          planes[num][idx], datatype);
+    }
+  }
+}
+
+static inline void
+gst_cpu_blend_row (guint8 * outdata, gfloat * planes[], guint n_elements,
+    gint n_pixels, guint64 datatype, gfloat alpha)
+{
+  gfloat value = 0.0F;
+  guint num = 0, idx = 0;
+  gint column = 0;
+
+  for (column = 0; column < n_pixels; column++) {
+    for (num = 0; num < n_elements; num++) {
+      idx = (column * n_elements) + num;
+
+      value = gst_cpu_load_element (outdata, idx, datatype);
+      value += (planes[num][column] - value) * alpha;
+
+      gst_cpu_store_element (outdata, idx, value, datatype);
+    }
+  }
+}
+
+static void
+gst_cpu_blit_rows (gpointer context, gint first, gint last)
+{
+  GstCpuBlitContext *ctx = (GstCpuBlitContext *) context;
+  GstCpuOutput *output = ctx->output;
+  GstCpuTap rtap;
+  gfloat *channels[GST_VCE_MAX_CHANNELS] = { NULL, };
+  gfloat *planes[GST_VCE_MAX_CHANNELS] = { NULL, };
+  gfloat *scratch = NULL, coordinate = 0.0F;
+  guint8 *outdata = NULL;
+  gint row = 0, idx = 0, n_pixels = ctx->width;
+  guint num = 0;
+
+  // Intermediate RGBA rows followed by the normalized rows for each position.
+  scratch = gst_cpu_get_scratch (GST_VCE_MAX_CHANNELS * 2 * n_pixels);
+
+  for (num = 0; num < GST_VCE_MAX_CHANNELS; num++) {
+    channels[num] = scratch + (num * n_pixels);
+    planes[num] = scratch + ((GST_VCE_MAX_CHANNELS + num) * n_pixels);
+  }
+
+  // Input frames without alpha channel are treated as fully opaque.
+  if (ctx->n_components < GST_VCE_MAX_CHANNELS) {
+    for (idx = 0; idx < n_pixels; idx++)
+      channels[GST_CPU_CHANNEL_ALPHA][idx] = 255.0F;
+  }
+
+  for (row = first; row < last; row++) {
+    coordinate = gst_cpu_map_coordinate (row - ctx->origin, ctx->rscale,
+        ctx->rinvert, ctx->rdimension, ctx->rorigin);
+
+    for (num = 0; num < ctx->n_components; num++) {
+      GstCpuComponent *component = &(ctx->components[num]);
+
+      gst_cpu_tap_init (&rtap, coordinate, component->subsample,
+          component->first, component->last, component->step);
+      gst_cpu_sample_row (component, &rtap, channels[num], n_pixels);
+    }
+
+    if (ctx->family == GST_CPU_FAMILY_YUV) {
+      gst_cpu_yuv_to_rgb (channels[0], channels[1], channels[2], n_pixels,
+          &(ctx->coeffs));
+    } else if (ctx->family == GST_CPU_FAMILY_GRAY) {
+      memcpy (channels[1], channels[0], n_pixels * sizeof (gfloat));
+      memcpy (channels[2], channels[0], n_pixels * sizeof (gfloat));
+    }
+
+    // Apply the fused normalization, skipped when it is a no-op.
+    for (num = 0; num < output->n_elements; num++) {
+      gfloat *indata = channels[output->channels[num]];
+
+      if (output->identity) {
+        planes[num] = indata;
+        continue;
+      }
+
+      planes[num] = scratch + ((GST_VCE_MAX_CHANNELS + num) * n_pixels);
+      gst_cpu_affine (indata, planes[num], n_pixels, output->scales[num],
+          output->offsets[num]);
+    }
+
+    outdata = output->data + (row * output->stride) +
+        (ctx->x * output->n_elements * output->n_bytes);
+
+    if (ctx->alpha < 1.0F) {
+      gst_cpu_blend_row (outdata, planes, output->n_elements, n_pixels,
+          output->datatype, ctx->alpha);
+    } else {
+      gst_cpu_store_row (outdata, planes, output->n_elements, n_pixels,
+          output->datatype);
+    }
+  }
+}
+
+static void
+gst_cpu_fill_rows (gpointer context, gint first, gint last)
+{
+  GstCpuFillContext *ctx = (GstCpuFillContext *) context;
+  GstCpuOutput *output = ctx->output;
+  gsize size = output->width * output->n_elements * output->n_bytes;
+  gint row = 0;
+
+  for (row = first; row < last; row++)
+    memcpy (output->data + (row * output->stride), ctx->pattern, size);
+}
+
+static void
+gst_cpu_video_converter_task (gpointer data, gpointer userdata)
+{
+  GstCpuTask *task = (GstCpuTask *) data;
+  GstCpuVideoConverter *convert = (GstCpuVideoConverter *) userdata;
+
+  task->function (task->context, task->first, task->last);
+
+  g_mutex_lock (&convert->tasklock);
+
+  if (--(convert->pending) == 0)
+    g_cond_signal (&convert->wakeup);
+
+  g_mutex_unlock (&convert->tasklock);
+}
+
+static void
+gst_cpu_video_converter_dispatch (GstCpuVideoConverter * convert,
+    GstCpuTaskFunction function, gpointer context, gint first, gint last)
+{
+  GstCpuTask tasks[GST_CPU_MAX_THREADS];
+  gint n_rows = last - first, n_tasks = 0, n_tile_rows = 0, idx = 0;
+
+  if (n_rows <= 0)
+    return;
+
+  n_tasks = (n_rows + GST_CPU_MIN_TILE_ROWS - 1) / GST_CPU_MIN_TILE_ROWS;
+  n_tasks = MIN (n_tasks, (gint) convert->n_threads);
+
+  if ((convert->workers == NULL) || (n_tasks <= 1)) {
+    function (context, first, last);
+    return;
+  }
+
+  n_tile_rows = (n_rows + n_tasks - 1) / n_tasks;
+
+  for (idx = 0; idx < n_tasks; idx++) {
+    tasks[idx].function = function;
+    tasks[idx].context = context;
+    tasks[idx].first = first + idx * n_tile_rows;
+    tasks[idx].last = MIN (tasks[idx].first + n_tile_rows, last);
+  }
+
+  convert->pending = n_tasks - 1;
+
+  // Offload all but the first tile which is processed in the calling thread.
+  for (idx = 1; idx < n_tasks; idx++)
+    g_thread_pool_push (convert->workers, &tasks[idx], NULL);
+
+  function (context, tasks[0].first, tasks[0].last);
+
+  g_mutex_lock (&convert->tasklock);
+
+  while (convert->pending != 0)
+    g_cond_wait (&convert->wakeup, &convert->tasklock);
+
+  g_mutex_unlock (&convert->tasklock);
+}
+
+static gboolean
+gst_cpu_output_init (GstCpuOutput * output, GstVideoFrame * vframe,
+    GstVideoComposition * composition)
+{
+  const GstVideoFormatInfo *finfo = vframe->info.finfo;
+  gfloat offset = 0.0F, scale = 1.0F;
+  guint idx = 0, num = 0;
+
+  if (!GST_VIDEO_FORMAT_INFO_IS_RGB (finfo) ||
+      (GST_VIDEO_FORMAT_INFO_N_PLANES (finfo) != 1) ||
+      (GST_VIDEO_FORMAT_INFO_DEPTH (finfo, 0) != 8)) {
+    GST_ERROR ("Unsupported output format %s!",
+        GST_VIDEO_FORMAT_INFO_NAME (finfo));
+    return FALSE;
+  }
+
+  output->datatype = composition->datatype;
+  output->n_bytes = gst_cpu_data_type_size (output->datatype);
+
+  if (output->n_bytes == 0) {
+    GST_ERROR ("Unsupported data type: %" G_GUINT64_FORMAT "!",
+        output->datatype);
+    return FALSE;
+  }
+
+  output->data = GST_VIDEO_FRAME_PLANE_DATA (vframe, 0);
+  output->stride = GST_VIDEO_FRAME_PLANE_STRIDE (vframe, 0);
+  output->width = GST_VIDEO_FRAME_WIDTH (vframe);
+  output->height = GST_VIDEO_FRAME_HEIGHT (vframe);
+  output->n_elements = GST_VIDEO_FRAME_COMP_PSTRIDE (vframe, 0);
+
+  if (output->n_elements > GST_VCE_MAX_CHANNELS) {
+    GST_ERROR ("Unsupported output format %s!",
+        GST_VIDEO_FORMAT_INFO_NAME (finfo));
+    return FALSE;
+  }
+
+  // Padding bytes (e.g. RGBx) are treated as opaque alpha.
+  for (idx = 0; idx < GST_VCE_MAX_CHANNELS; idx++)
+    output->channels[idx] = GST_CPU_CHANNEL_ALPHA;
+
+  for (num = 0; num < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); num++)
+    output->channels[GST_VIDEO_FRAME_COMP_OFFSET (vframe, num)] = num;
+
+  output->identity = TRUE;
+
+  // Fold the type conversion and normalization into a single scale/offset.
+  for (idx = 0; idx < output->n_elements; idx++) {
+    switch (output->datatype) {
+      case GST_VCE_DATA_TYPE_U8:
+        scale = composition->scales[idx];
+        offset = -composition->offsets[idx] * composition->scales[idx];
+        break;
+      case GST_VCE_DATA_TYPE_I8:
+        scale = composition->scales[idx];
+        offset = -(GST_CPU_INT8_OFFSET + composition->offsets[idx]) *
+            composition->scales[idx];
+        break;
+      case GST_VCE_DATA_TYPE_F16:
+      case GST_VCE_DATA_TYPE_F32:
+        scale = composition->scales[idx] * GST_CPU_FLOAT_SCALE;
+        offset = -composition->offsets[idx] * composition->scales[idx];
+        break;
+    }
+
+    output->scales[idx] = scale;
+    output->offsets[idx] = offset;
+
+    output->identity &= (scale == 1.0F) && (offset == 0.0F);
+  }
+
+  return TRUE;
+}
+
+static void
+gst_cpu_video_converter_fill_background (GstCpuVideoConverter * convert,
+    GstCpuOutput * output, guint32 color)
+{
+  GstCpuFillContext ctx = { output, NULL };
+  gfloat values[GST_VCE_MAX_CHANNELS][1];
+  gfloat *planes[GST_VCE_MAX_CHANNELS];
+  gsize size = output->n_elements * output->n_bytes, total = 0;
+  guint idx = 0;
+
+  for (idx = 0; idx < output->n_elements; idx++) {
+    gfloat value = 0.0F;
+
+    switch (output->channels[idx]) {
+      case GST_CPU_CHANNEL_RED:
+        value = EXTRACT_RED_COLOR (color);
+        break;
+      case GST_CPU_CHANNEL_GREEN:
+        value = EXTRACT_GREEN_COLOR (color);
+        break;
+      case GST_CPU_CHANNEL_BLUE:
+        value = EXTRACT_BLUE_COLOR (color);
+        break;
+      case GST_CPU_CHANNEL_ALPHA:
+        value = EXTRACT_ALPHA_COLOR (color);
+        break;
+    }
+
+    values[idx][0] = value * output->scales[idx] + output->offsets[idx];
+    planes[idx] = values[idx];
+  }
+
+  total = output->width * size;
+  ctx.pattern = g_malloc (total);
+
+  // Convert a single pixel and replicate it over the whole pattern row.
+  gst_cpu_store_row (ctx.pattern, planes, output->n_elements, 1,
+      output->datatype);
+
+  for (; size < total; size *= 2)
+    memcpy (ctx.pattern + size, ctx.pattern, MIN (size, total - size));
+
+  gst_cpu_video_converter_dispatch (convert, gst_cpu_fill_rows, &ctx,
+      0, output->height);
+
+  g_free (ctx.pattern);
+}
+
+static gboolean
+gst_cpu_blit_context_init (GstCpuBlitContext * ctx, GstCpuOutput * output,
+    GstVideoFrame * inframe, GstVideoBlit * blit)
+{
+  const GstVideoFormatInfo *finfo = inframe->info.finfo;
+  GstVideoRectangle source = { 0, 0, 0, 0 }, destination = { 0, 0, 0, 0 };
+  gboolean transpose = FALSE, cinvert = FALSE, hflip = FALSE, vflip = FALSE;
+  gint cdimension = 0, corigin = 0, column = 0, x = 0, y = 0;
+  gfloat cscale = 0.0F, coordinate = 0.0F;
+  guint num = 0;
+
+  if (GST_VIDEO_FORMAT_INFO_IS_YUV (finfo)) {
+    ctx->family = GST_CPU_FAMILY_YUV;
+  } else if (GST_VIDEO_FORMAT_INFO_IS_RGB (finfo)) {
+    ctx->family = GST_CPU_FAMILY_RGB;
+  } else if (GST_VIDEO_FORMAT_INFO_IS_GRAY (finfo)) {
+    ctx->family = GST_CPU_FAMILY_GRAY;
+  } else {
+    GST_ERROR ("Unsupported input format %s!",
+        GST_VIDEO_FORMAT_INFO_NAME (finfo));
+    return FALSE;
+  }
+
+  ctx->n_components = GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo);
+
+  if (GST_VIDEO_FORMAT_INFO_IS_TILED (finfo) ||
+      GST_VIDEO_FORMAT_INFO_HAS_PALETTE (finfo) ||
+      (ctx->n_components > GST_VCE_MAX_CHANNELS)) {
+    GST_ERROR ("Unsupported input format %s!",
+        GST_VIDEO_FORMAT_INFO_NAME (finfo));
+    return FALSE;
+  }
+
+  for (num = 0; num < ctx->n_components; num++) {
+    if (GST_VIDEO_FORMAT_INFO_DEPTH (finfo, num) != 8) {
+      GST_ERROR ("Unsupported input format %s!",
+          GST_VIDEO_FORMAT_INFO_NAME (finfo));
+      return FALSE;
+    }
+  }
+
+  if (blit->mask & GST_VCE_MASK_SOURCE) {
+    if (!gst_video_quadrilateral_is_rectangle (&(blit->source))) {
+      GST_ERROR ("Source quadrilateral is not a rectangle! A(%f, %f) "
+          "B(%f, %f) C(%f, %f) D(%f, %f)", blit->source.a.x, blit->source.a.y,
+          blit->source.b.x, blit->source.b.y, blit->source.c.x,
+          blit->source.c.y, blit->source.d.x, blit->source.d.y);
+      return FALSE;
+    }
+
+    gst_video_quadrilateral_to_rectangle (&(blit->source), &source);
+  } else {
+    source.w = GST_VIDEO_FRAME_WIDTH (inframe);
+    source.h = GST_VIDEO_FRAME_HEIGHT (inframe);
+  }
+
+  // Restrict the source rectangle within the boundaries of the input frame.
+  x = CLAMP (source.x, 0, GST_VIDEO_FRAME_WIDTH (inframe));
+  y = CLAMP (source.y, 0, GST_VIDEO_FRAME_HEIGHT (inframe));
+  source.w = MIN (source.x + source.w, GST_VIDEO_FRAME_WIDTH (inframe)) - x;
+  source.h = MIN (source.y + source.h, GST_VIDEO_FRAME_HEIGHT (inframe)) - y;
+  source.x = x;
+  source.y = y;
+
+  if (blit->mask & GST_VCE_MASK_DESTINATION) {
+    destination = blit->destination;
+  } else {
+    destination.w = output->width;
+    destination.h = output->height;
+  }
+
+  if ((source.w <= 0) || (source.h <= 0) ||
+      (destination.w <= 0) || (destination.h <= 0)) {
+    GST_ERROR ("Invalid source (%dx%d) or destination (%dx%d) dimensions!",
+        source.w, source.h, destination.w, destination.h);
+    return FALSE;
+  }
+
+  ctx->output = output;
+  ctx->alpha = blit->alpha / 255.0F;
+
+  // Visible part of the destination rectangle.
+  ctx->x = MAX (destination.x, 0);
+  ctx->width = MIN (destination.x + destination.w, output->width) - ctx->x;
+  ctx->origin = destination.y;
+
+  if (blit->mask & GST_VCE_MASK_ROTATION)
+    transpose = (blit->rotate == GST_VCE_ROTATE_90) ||
+        (blit->rotate == GST_VCE_ROTATE_270);
+
+  hflip = (blit->mask & GST_VCE_MASK_FLIP_HORIZONTAL) ? TRUE : FALSE;
+  vflip = (blit->mask & GST_VCE_MASK_FLIP_VERTICAL) ? TRUE : FALSE;
+
+  // Output columns traverse the source X axis, or the Y axis when transposed.
+  cinvert = hflip;
+  ctx->rinvert = vflip;
+
+  if (blit->mask & GST_VCE_MASK_ROTATION) {
+    switch (blit->rotate) {
+      case GST_VCE_ROTATE_90:
+        cinvert = !cinvert;
+        break;
+      case GST_VCE_ROTATE_180:
+        cinvert = !cinvert;
+        ctx->rinvert = !ctx->rinvert;
+        break;
+      case GST_VCE_ROTATE_270:
+        ctx->rinvert = !ctx->rinvert;
+        break;
+      default:
+        break;
+    }
+  }
+
+  cdimension = transpose ? source.h : source.w;
+  corigin = transpose ? source.y : source.x;
+  cscale = (gfloat) cdimension / destination.w;
+
+  ctx->rdimension = transpose ? source.w : source.h;
+  ctx->rorigin = transpose ? source.x : source.y;
+  ctx->rscale = (gfloat) ctx->rdimension / destination.h;
+
+  ctx->coeffs.yoffset = 0.0F;
+  ctx->coeffs.yscale = 1.0F;
+
+  if (ctx->family == GST_CPU_FAMILY_YUV) {
+    gdouble kr = 0.299, kb = 0.114, kg = 0.0, cfactor = 1.0;
+
+    if (!gst_video_color_matrix_get_Kr_Kb (inframe->info.colorimetry.matrix,
+            &kr, &kb)) {
+      kr = 0.299;
+      kb = 0.114;
+    }
+
+    kg = 1.0 - kr - kb;
+
+    if (inframe->info.colorimetry.range != GST_VIDEO_COLOR_RANGE_0_255) {
+      ctx->coeffs.yoffset = 16.0F;
+      ctx->coeffs.yscale = 255.0F / 219.0F;
+      cfactor = 255.0 / 224.0;
+    }
+
+    ctx->coeffs.rv = 2.0 * (1.0 - kr) * cfactor;
+    ctx->coeffs.gu = (2.0 * kb * (1.0 - kb) / kg) * cfactor;
+    ctx->coeffs.gv = (2.0 * kr * (1.0 - kr) / kg) * cfactor;
+    ctx->coeffs.bu = 2.0 * (1.0 - kb) * cfactor;
+  }
+
+  for (num = 0; num < ctx->n_components; num++) {
+    GstCpuComponent *component = &(ctx->components[num]);
+    gint wsub = GST_VIDEO_FORMAT_INFO_W_SUB (finfo, num);
+    gint hsub = GST_VIDEO_FORMAT_INFO_H_SUB (finfo, num);
+    gint pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (inframe, num);
+    gint stride = GST_VIDEO_FRAME_COMP_STRIDE (inframe, num);
+    gint csubsample = transpose ? hsub : wsub;
+    gint cstep = transpose ? stride : pstride;
+    gint cfirst = corigin >> csubsample;
+    gint clast = (corigin + cdimension - 1) >> csubsample;
+
+    component->data = GST_VIDEO_FRAME_COMP_DATA (inframe, num);
+
+    component->subsample = transpose ? wsub : hsub;
+    component->step = transpose ? pstride : stride;
+    component->first = ctx->rorigin >> component->subsample;
+    component->last =
+        (ctx->rorigin + ctx->rdimension - 1) >> component->subsample;
+
+    component->taps = g_new (GstCpuTap, MAX (ctx->width, 1));
+
+    for (column = 0; column < ctx->width; column++) {
+      coordinate = gst_cpu_map_coordinate (
+          (ctx->x + column) - destination.x, cscale, cinvert, cdimension,
+          corigin);
+      gst_cpu_tap_init (&(component->taps[column]), coordinate, csubsample,
+          cfirst, clast, cstep);
+    }
+  }
+
+  return TRUE;
+}
+
+static void
+gst_cpu_blit_context_deinit (GstCpuBlitContext * ctx)
+{
+  guint num = 0;
+
+  for (num = 0; num < ctx->n_components; num++)
+    g_clear_pointer (&(ctx->components[num].taps), g_free);
+}
+
+static gboolean
+gst_cpu_video_converter_blit (GstCpuVideoConverter * convert,
+    GstCpuOutput * output, GstVideoBlit * blit)
+{
+  GstVideoFrame inframe;
+  GstCpuBlitContext ctx;
+  GstVideoRectangle destination = { 0, 0, output->width, output->height };
+  gint first = 0, last = 0;
+  gboolean success = FALSE;
+
+  if (!gst_video_frame_map (&inframe, blit->info, blit->buffer,
+          GST_MAP_READ | GST_VIDEO_FRAME_MAP_FLAG_NO_REF)) {
+    GST_ERROR ("Failed to map input buffer!");
+    return FALSE;
+  }
+
+  memset (&ctx, 0, sizeof (ctx));
+
+  if (!gst_cpu_blit_context_init (&ctx, output, &inframe, blit))
+    goto cleanup;
+
+  if (blit->mask & GST_VCE_MASK_DESTINATION)
+    destination = blit->destination;
+
+  // Only the rows which are inside the output frame are processed.
+  first = MAX (destination.y, 0);
+  last = MIN (destination.y + destination.h, output->height);
+
+  if (ctx.width > 0)
+    gst_cpu_video_converter_dispatch (convert, gst_cpu_blit_rows, &ctx,
+        first, last);
+
+  success = TRUE;
+
+cleanup:
+  gst_cpu_blit_context_deinit (&ctx);
+  gst_video_frame_unmap (&inframe);
+
+  return success;
+}
+
+gboolean
+gst_cpu_video_converter_compose (GstCpuVideoConverter * convert,
+    GstVideoComposition * compositions, guint n_compositions, gpointer * fence)
+{
+  guint idx = 0, num = 0;
+  gboolean success = TRUE;
+
+  if (fence != NULL)
+    GST_WARNING ("Asynchronous composition operations are not supported!");
+
+  GST_CPU_LOCK (convert);
+
+  for (idx = 0; (idx < n_compositions) && success; idx++) {
+    GstVideoComposition *composition = &(compositions[idx]);
+    GstVideoFrame outframe;
+    GstCpuOutput output;
+
+    if (!gst_video_frame_map (&outframe, composition->info,
+            composition->buffer,
+            GST_MAP_READWRITE | GST_VIDEO_FRAME_MAP_FLAG_NO_REF)) {
+      GST_ERROR ("Failed to map output buffer!");
+      success = FALSE;
+      break;
+    }
+
+    success = gst_cpu_output_init (&output, &outframe, composition);
+
+    if (success && composition->bgfill)
+      gst_cpu_video_converter_fill_background (convert, &output,
+          composition->bgcolor);
+
+    for (num = 0; (num < composition->n_blits) && success; num++) {
+      success = gst_cpu_video_converter_blit (convert, &output,
+          &(composition->blits[num]));
+    }
+
+    gst_video_frame_unmap (&outframe);
+
+    if (!success)
+      GST_ERROR ("Failed to process frames for composition %u!", idx);
+  }
+
+  GST_CPU_UNLOCK (convert);
+
+  return success;
+}
+
+gboolean
+gst_cpu_video_converter_wait_fence (GstCpuVideoConverter * convert,
+    gpointer fence)
+{
+  // Compositions are executed synchronously, there is nothing to wait for.
+  return TRUE;
+}
+
+void
+gst_cpu_video_converter_flush (GstCpuVideoConverter * convert)
+{
+  // Compositions are executed synchronously, there is nothing to flush.
+}
+
+GstCpuVideoConverter *
+gst_cpu_video_converter_new (GstStructure * settings)
+{
+  GstCpuVideoConverter *convert = NULL;
+  GError *error = NULL;
+  guint n_threads = g_get_num_processors ();
+
+  convert = g_slice_new0 (GstCpuVideoConverter);
+  g_return_val_if_fail (convert != NULL, NULL);
+
+  g_mutex_init (&convert->lock);
+  g_mutex_init (&convert->tasklock);
+  g_cond_init (&convert->wakeup);
+
+  if ((settings != NULL) &&
+      gst_structure_has_field (settings, GST_VCE_OPT_CPU_N_THREADS))
+    gst_structure_get_uint (settings, GST_VCE_OPT_CPU_N_THREADS, &n_threads);
+
+  convert->n_threads = CLAMP (n_threads, 1, GST_CPU_MAX_THREADS);
+
+  // The calling thread processes one of the tiles, hence one less worker.
+  if (convert->n_threads > 1) {
+    convert->workers = g_thread_pool_new (gst_cpu_video_converter_task,
+        convert, convert->n_threads - 1, TRUE, &error);
+
+    if (convert->workers == NULL) {
+      GST_ERROR ("Failed to create worker threads, error: '%s'!",
+          GST_STR_NULL (error->message));
+      g_clear_error (&error);
+      goto cleanup;
+    }
+  }
+
+  GST_INFO ("Created CPU Converter %p with %u threads", convert,
+      convert->n_threads);
+  return convert;
+
+cleanup:
+  gst_cpu_video_converter_free (convert);
+  return NULL;
+}
+
+void
+gst_cpu_video_converter_free (GstCpuVideoConverter * convert)
+{
+  if (convert == NULL)
+    return;
+
+  if (convert->workers != NULL)
+    g_thread_pool_free (convert->workers, FALSE, TRUE);
+
+  g_cond_clear (&convert->wakeup);
+  g_mutex_clear (&convert->tasklock);
+  g_mutex_clear (&convert->lock);
+
+  GST_INFO ("Destroyed CPU converter: %p", convert);
+  g_slice_free (GstCpuVideoConverter, convert);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __GST_CPU_VIDEO_CONVERTER_H__
+#define __GST_CPU_VIDEO_CONVERTER_H__
+
+#include "video-converter-engine.h"
+
+G_BEGIN_DECLS
+
+typedef struct _GstCpuVideoConverter GstCpuVideoConverter;
+
+/**
+ * gst_cpu_video_converter_new:
+ * @settings: Structure with optional settings.
+ *
+ * Initialize instance of CPU converter backend.
+ *
+ * return: Pointer to CPU converter on success or NULL on failure
+ */
+GST_VIDEO_API GstCpuVideoConverter *
+gst_cpu_video_converter_new (GstStructure * settings);
+
+/**
+ * gst_cpu_video_converter_free:
+ * @convert: Pointer to CPU converter backend
+ *
+ * Deinitialise the CPU converter.
+ *
+ * return: NONE
+ */
+GST_VIDEO_API void
+gst_cpu_video_converter_free (GstCpuVideoConverter * convert);
+
+/**
+ * gst_cpu_video_converter_compose:
+ * @convert: Pointer to CPU converter backend.
+ * @compositions: Array of composition frames.
+ * @n_compositions: Number of compositions.
+ * @fence: Optional fence to be filled if provided and used for async operation.
+ *
+ * Submit the a number of video composition which will be executed together.
+ * Color conversion, scaling, rotation, flip and normalization of each blit
+ * are fused into a single pass over the output rows, which are split in tiles
+ * and distributed among the worker threads of the converter.
+ *
+ * return: TRUE on success or FALSE on failure
+ */
+GST_VIDEO_API gboolean
+gst_cpu_video_converter_compose (GstCpuVideoConverter * convert,
+                                 GstVideoComposition * compositions,
+                                 guint n_compositions, gpointer * fence);
+
+/**
+ * gst_cpu_video_converter_wait_fence:
+ * @convert: Pointer to CPU converter backend.
+ * @fence: Asynchronously fence object associated with a compose request.
+ *
+ * Wait for the sumbitted compositions to finish.
+ *
+ * return: TRUE on success or FALSE on failure
+ */
+GST_VIDEO_API gboolean
+gst_cpu_video_converter_wait_fence (GstCpuVideoConverter * convert,
+                                    gpointer fence);
+
+/**
+ * gst_cpu_video_converter_flush:
+ * @convert: Pointer to CPU converter backend.
+ *
+ * Wait for sumbitted compositions to finish and flush cached data.
+ *
+ * return: NONE
+ */
+GST_VIDEO_API void
+gst_cpu_video_converter_flush (GstCpuVideoConverter * convert);
+
+G_END_DECLS
+
+#endif // __GST_CPU_VIDEO_CONVERTER_H__
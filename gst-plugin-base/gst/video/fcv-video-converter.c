@@ -4,11 +4,13 @@
  */
 
 #include "fcv-video-converter.h"
+#include "video-normalize.h"
 
 #include <unistd.h>
 #include <dlfcn.h>
 
 #include <fastcv/fastcv.h>
+#include <gst/utils/common-utils.h>
 
 
 #define GST_CAT_DEFAULT gst_video_converter_engine_debug
@@ -81,9 +83,13 @@
 
 #define GST_FCV_WIDTH_ALIGN         8
 
+// Number of rows converted and normalized together in the fused conversion.
+#define GST_FCV_BAND_HEIGHT         16
+
 typedef struct _GstFcvPlane GstFcvPlane;
 typedef struct _GstFcvObject GstFcvObject;
 typedef struct _GstFcvStageBuffer GstFcvStageBuffer;
+typedef struct _GstFcvTarget GstFcvTarget;
 
 enum {
   GST_FCV_FLAG_GRAY   = (1 << 0),
@@ -151,6 +157,26 @@ struct _GstFcvStageBuffer
   gboolean used;
 };
 
+/**
+ * GstFcvTarget:
+ * @normalizer: Normalization and quantization parameters of the composition.
+ * @data: Pointer to the region of interest in the output tensor.
+ * @stride: Stride of the output tensor in bytes.
+ * @stgid: Index of the staging buffer used in place of the output region.
+ * @done: Whether the region was already filled by the fused color conversion.
+ *
+ * Normalized output region of a blit. The destination object operates on an
+ * UINT8 staging buffer which is normalized and quantized into this region.
+ */
+struct _GstFcvTarget
+{
+  const GstVideoNormalizer *normalizer;
+  guint8                   *data;
+  guint32                  stride;
+  gint                     stgid;
+  gboolean                 done;
+};
+
 struct _GstFcvVideoConverter
 {
   // Global mutex lock.
@@ -887,6 +913,50 @@ gst_fcv_video_converter_stage_plane_init (GstFcvVideoConverter * convert,
   return TRUE;
 }
 
+static inline gboolean
+gst_fcv_video_converter_target_init (GstFcvVideoConverter * convert,
+    GstFcvTarget * target, GstFcvObject * object, const GstVideoFrame * frame,
+    const GstVideoRectangle * region, const GstVideoNormalizer * normalizer)
+{
+  GstFcvPlane *plane = &(object->planes[0]);
+  gint x = 0, y = 0;
+
+  // Same clipping as for the destination object.
+  x = MAX (region->x, 0);
+  y = MAX (region->y, 0);
+
+  target->normalizer = normalizer;
+  target->stride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0);
+  target->data = GUINT8_PTR_CAST (GST_VIDEO_FRAME_PLANE_DATA (frame, 0)) +
+      (y * target->stride) +
+      (x * normalizer->n_elements * normalizer->n_bytes);
+  target->done = FALSE;
+
+  // Redirect the destination plane into an UINT8 staging buffer.
+  if (!gst_fcv_video_converter_stage_plane_init (convert, plane, plane->width,
+          plane->height, GST_ROUND_UP_8 (plane->width) * normalizer->n_elements))
+    return FALSE;
+
+  target->stgid = plane->stgid;
+  return TRUE;
+}
+
+static inline void
+gst_fcv_video_converter_target_deinit (GstFcvVideoConverter * convert,
+    GstFcvTarget * target, GstFcvObject * object)
+{
+  GstFcvPlane *plane = &(object->planes[0]);
+
+  // Normalize and quantize the stage unless the fused conversion already did.
+  if (!target->done) {
+    gst_video_normalizer_convert (target->normalizer,
+        GUINT8_PTR_CAST (plane->data), plane->stride, target->data,
+        target->stride, plane->width, plane->height);
+  }
+
+  gst_fcv_video_converter_release_stage_buffer (convert, target->stgid);
+}
+
 static inline gboolean
 gst_fcv_video_converter_compute_conversion (GstFcvVideoConverter * convert,
     GstFcvObject * s_obj, GstFcvObject * d_obj)
@@ -1546,6 +1616,67 @@ gst_fcv_video_converter_color_transform (GstFcvVideoConverter * convert,
   return success;
 }
 
+static inline gboolean
+gst_fcv_video_converter_color_transform_bands (GstFcvVideoConverter * convert,
+    GstFcvObject * s_obj, GstFcvObject * d_obj, GstFcvTarget * target)
+{
+  GstFcvObject s_band = { 0, }, d_band = { 0, };
+  GstFcvPlane *s_plane = &(s_obj->planes[0]), *s_chroma = &(s_obj->planes[1]);
+  GstFcvPlane *d_plane = &(d_obj->planes[0]);
+  guint row = 0, n_rows = 0;
+  gboolean success = TRUE;
+
+  for (row = 0; (row < d_plane->height) && success;
+      row += GST_FCV_BAND_HEIGHT) {
+    n_rows = MIN (GST_FCV_BAND_HEIGHT, d_plane->height - row);
+
+    gst_fcv_copy_object (s_obj, &s_band);
+    gst_fcv_copy_object (d_obj, &d_band);
+
+    s_band.planes[0].data =
+        GUINT8_PTR_CAST (s_plane->data) + (row * s_plane->stride);
+    s_band.planes[0].height = n_rows;
+
+    // Chroma rows corresponding to the luma band, band offsets are even.
+    if ((s_obj->flags & GST_FCV_FLAG_YUV) &&
+        (s_chroma->height < s_plane->height)) {
+      s_band.planes[1].data = GUINT8_PTR_CAST (s_chroma->data) +
+          ((row / 2) * s_chroma->stride);
+      s_band.planes[1].height = GST_ROUND_UP_2 (n_rows) / 2;
+    } else if (s_obj->flags & GST_FCV_FLAG_YUV) {
+      s_band.planes[1].data =
+          GUINT8_PTR_CAST (s_chroma->data) + (row * s_chroma->stride);
+      s_band.planes[1].height = n_rows;
+    }
+
+    // Each band reuses the head of the stage so it stays in cache until
+    // it is normalized and quantized into the output tensor.
+    d_band.planes[0].height = n_rows;
+
+    if (s_obj->flags & GST_FCV_FLAG_YUV)
+      success = gst_fcv_video_converter_yuv_to_rgb (convert, &s_band, &d_band);
+    else
+      success = gst_fcv_video_converter_rgb_to_rgb (convert, &s_band, &d_band);
+
+    if (success) {
+      gst_video_normalizer_convert (target->normalizer,
+          GUINT8_PTR_CAST (d_plane->data), d_plane->stride,
+          target->data + (row * target->stride), target->stride,
+          d_plane->width, n_rows);
+    }
+  }
+
+  // If source is a stage object from previous operation, release stage buffers.
+  if (s_obj->flags & GST_FCV_FLAG_STAGED)
+    gst_fcv_video_converter_stage_object_deinit (convert, s_obj);
+
+  // Set the destination object as source for the next operation.
+  gst_fcv_copy_object (d_obj, s_obj);
+
+  target->done = success;
+  return success;
+}
+
 static inline gboolean
 gst_fcv_video_converter_downscale (GstFcvVideoConverter * convert,
     GstFcvObject * s_obj, GstFcvObject * d_obj)
@@ -2012,6 +2143,53 @@ gst_fcv_video_converter_fill_background (GstFcvVideoConverter * convert,
   return TRUE;
 }
 
+static inline gboolean
+gst_fcv_video_converter_fill_normalized (GstVideoFrame * frame, guint32 color,
+    const GstVideoNormalizer * normalizer)
+{
+  guint8 red = 0, green = 0, blue = 0, alpha = 0;
+  guint8 pixel[GST_VCE_MAX_CHANNELS] = { 0, };
+
+  red = EXTRACT_RED_VALUE (color);
+  green = EXTRACT_GREEN_VALUE (color);
+  blue = EXTRACT_BLUE_VALUE (color);
+  alpha = EXTRACT_ALPHA_VALUE (color);
+
+  GST_TRACE ("Fill buffer %p with normalized 0x%X - %ux%u %s", frame->buffer,
+      color, GST_VIDEO_FRAME_WIDTH (frame), GST_VIDEO_FRAME_HEIGHT (frame),
+      gst_video_format_to_string (GST_VIDEO_FRAME_FORMAT (frame)));
+
+  switch (GST_VIDEO_FRAME_FORMAT (frame)) {
+    case GST_VIDEO_FORMAT_RGB:
+    case GST_VIDEO_FORMAT_RGBA:
+    case GST_VIDEO_FORMAT_RGBx:
+      pixel[0] = red;
+      pixel[1] = green;
+      pixel[2] = blue;
+      pixel[3] = alpha;
+      break;
+    case GST_VIDEO_FORMAT_BGR:
+    case GST_VIDEO_FORMAT_BGRA:
+    case GST_VIDEO_FORMAT_BGRx:
+      pixel[0] = blue;
+      pixel[1] = green;
+      pixel[2] = red;
+      pixel[3] = alpha;
+      break;
+    default:
+      GST_ERROR ("Unsupported format %s!",
+          gst_video_format_to_string (GST_VIDEO_FRAME_FORMAT (frame)));
+      return FALSE;
+  }
+
+  gst_video_normalizer_fill (normalizer, pixel,
+      GST_VIDEO_FRAME_PLANE_DATA (frame, 0),
+      GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0), GST_VIDEO_FRAME_WIDTH (frame),
+      GST_VIDEO_FRAME_HEIGHT (frame));
+
+  return TRUE;
+}
+
 static inline gboolean
 gst_fcv_video_converter_add (GstFcvVideoConverter * convert,
     GstFcvObject * s_obj, GstFcvObject * d_obj)
@@ -2083,17 +2261,22 @@ gst_fcv_video_converter_add (GstFcvVideoConverter * convert,
 
 static inline gboolean
 gst_fcv_video_converter_process (GstFcvVideoConverter * convert,
-    GstFcvObject * objects, guint n_objects)
+    GstFcvObject * objects, GstFcvTarget * targets, guint n_objects)
 {
   GstFcvObject *s_obj = NULL, *d_obj = NULL;
+  GstFcvTarget *target = NULL;
   guint idx = 0, flip = 0, rotate = 0;
   gfloat w_scale = 0.0, h_scale = 0.0, scale = 0.0;
   gboolean downscale = FALSE, upscale = FALSE, aligned = FALSE, add = FALSE;
+  gboolean fused = FALSE;
 
   for (idx = 0; idx < n_objects; idx += 2) {
     s_obj = &(objects[idx]);
     d_obj = &(objects[idx + 1]);
 
+    // Optional normalized output region of the pair.
+    target = (targets != NULL) ? &(targets[idx / 2]) : NULL;
+
     flip = s_obj->flip;
     rotate = s_obj->rotate;
 
@@ -2164,6 +2347,26 @@ gst_fcv_video_converter_process (GstFcvVideoConverter * convert,
       return FALSE;
     }
 
+    // Color conversion into a normalized output is done in bands of rows,
+    // which also covers unaligned widths, if no resize/flip/rotate is pending.
+    fused = (target != NULL) && (s_obj->format != d_obj->format) &&
+        (d_obj->flags & GST_FCV_FLAG_RGB) &&
+        (s_obj->flags & (GST_FCV_FLAG_YUV | GST_FCV_FLAG_RGB)) &&
+        (s_obj->format != GST_VIDEO_FORMAT_P010_10LE) &&
+        (s_obj->planes[0].width == d_obj->planes[0].width) &&
+        (s_obj->planes[0].height == d_obj->planes[0].height) &&
+        (s_obj->rotate == 0) && (s_obj->flip == 0);
+
+    if (fused) {
+      if (!gst_fcv_video_converter_color_transform_bands (convert, s_obj, d_obj,
+              target)) {
+        GST_ERROR ("Failed to convert image format!");
+        return FALSE;
+      }
+
+      continue;
+    }
+
     // Sixth, perform final color conversion if necessary.
     if ((s_obj->format != d_obj->format) &&
         !gst_fcv_video_converter_color_transform (convert, s_obj, d_obj)) {
@@ -2192,10 +2395,13 @@ gst_fcv_video_converter_compose (GstFcvVideoConverter * convert,
     GstVideoComposition * compositions, guint n_compositions, gpointer * fence)
 {
   GstFcvObject objects[GST_FCV_MAX_DRAW_OBJECTS] = { 0, };
-  guint32 idx = 0, num = 0, n_objects = 0, area = 0;
+  GstFcvTarget targets[GST_FCV_MAX_DRAW_OBJECTS / 2] = { 0, };
+  GstVideoNormalizer normalizer;
+  guint32 idx = 0, num = 0, n_objects = 0, n_targets = 0, area = 0;
   GArray *inframes = NULL;
   GstVideoFrame outframe = {0,};
   GstVideoComposition *composition = NULL;
+  gboolean normalize = FALSE, success = FALSE;
 
 
   // TODO: Implement async operations via threads.
@@ -2205,13 +2411,8 @@ gst_fcv_video_converter_compose (GstFcvVideoConverter * convert,
   for (idx = 0; idx < n_compositions; idx++) {
     composition = &(compositions[idx]);
 
-    inframes = g_array_sized_new(FALSE, FALSE, sizeof(GstVideoFrame),
-        composition->n_blits);
-    g_array_set_size (inframes, composition->n_blits);
-
     GstVideoBlit *blits = composition->blits;
     guint n_blits = composition->n_blits;
-    gboolean success = FALSE;
 
     // Sanity checks, blit entries must not be NULL.
     g_return_val_if_fail (composition->buffer != NULL, FALSE);
@@ -2225,29 +2426,52 @@ gst_fcv_video_converter_compose (GstFcvVideoConverter * convert,
       return FALSE;
     }
 
+    // Only successfully mapped input frames are appended.
+    inframes = g_array_sized_new (FALSE, FALSE, sizeof (GstVideoFrame),
+        composition->n_blits);
+
+    // Staging buffers are acquired for the targets, release them on failure.
+    n_targets = 0;
+
     // Total area of the output frame that is to be used in later calculations
     // to determine whether there are unoccupied background pixels to be filled.
     area = GST_VIDEO_FRAME_WIDTH (&outframe) * GST_VIDEO_FRAME_HEIGHT (&outframe);
 
+    // Objects are processed separately for each composition.
+    n_objects = 0;
+
+    // Normalization and quantization of 8-bit single plane outputs is fused
+    // into the last operation of each blit instead of a separate in-place pass.
+    normalize = (GST_VIDEO_FRAME_N_PLANES (&outframe) == 1) &&
+        (GST_VIDEO_FRAME_COMP_DEPTH (&outframe, 0) == 8) &&
+        gst_video_normalizer_init (&normalizer, composition->datatype,
+            GST_VIDEO_FRAME_COMP_PSTRIDE (&outframe, 0), composition->offsets,
+            composition->scales) && !normalizer.identity;
+
     // Iterate over the input blit entries and update each FCV object.
     for (num = 0; num < n_blits; num++) {
       GstVideoBlit *blit = &(blits[num]);
       GstFcvObject *object = NULL;
       GstVideoRectangle rectangle = {0, 0, 0, 0};
       guint flip = 0, rotate = 0;
-      GstVideoFrame *inframe = &g_array_index(inframes, GstVideoFrame, num);
+      GstVideoFrame *inframe = NULL;
+
+      if (n_objects >= GST_FCV_MAX_DRAW_OBJECTS) {
+        GST_ERROR ("Number of objects exceeds %d!", GST_FCV_MAX_DRAW_OBJECTS);
+        success = FALSE;
+        goto cleanup;
+      }
+
+      g_array_set_size (inframes, num + 1);
+      inframe = &g_array_index (inframes, GstVideoFrame, num);
 
       success = gst_video_frame_map (inframe, blit->info, blit->buffer,
           GST_MAP_READ | GST_VIDEO_FRAME_MAP_FLAG_NO_REF);
 
       if (!success) {
         GST_ERROR ("Failed to map input buffer!");
-        return FALSE;
-      }
-
-      if (n_objects >= GST_FCV_MAX_DRAW_OBJECTS) {
-        GST_ERROR ("Number of objects exceeds %d!", GST_FCV_MAX_DRAW_OBJECTS);
-        return FALSE;
+        g_array_set_size (inframes, num);
+        goto cleanup;
       }
 
       if ((blit->mask & GST_VCE_MASK_FLIP_VERTICAL) &&
@@ -2271,7 +2495,8 @@ gst_fcv_video_converter_compose (GstFcvVideoConverter * convert,
               blit->source.a.x, blit->source.a.y, blit->source.b.x,
               blit->source.b.y, blit->source.c.x, blit->source.c.y,
               blit->source.d.x, blit->source.d.y);
-          return FALSE;
+          success = FALSE;
+          goto cleanup;
         }
 
         rectangle.x = blit->source.a.x;
@@ -2302,6 +2527,16 @@ gst_fcv_video_converter_compose (GstFcvVideoConverter * convert,
       gst_fcv_update_object (object, "Destination", &outframe, &rectangle,
           0, 0, composition->datatype);
 
+      if (normalize && !gst_fcv_video_converter_target_init (convert,
+              &(targets[num]), object, &outframe, &rectangle, &normalizer)) {
+        GST_ERROR ("Failed to initialize normalized output for blit %u!", num);
+        success = FALSE;
+        goto cleanup;
+      }
+
+      if (normalize)
+        n_targets++;
+
       // Subtract blit area from total area.
       if (area != 0)
         area -= gst_fcv_composition_blit_area (&outframe, blits, num);
@@ -2310,17 +2545,40 @@ gst_fcv_video_converter_compose (GstFcvVideoConverter * convert,
       n_objects += 2;
     }
 
-    if (composition->bgfill && (area > 0))
+    if (composition->bgfill && (area > 0) && normalize)
+      gst_fcv_video_converter_fill_normalized (&outframe, composition->bgcolor,
+          &normalizer);
+    else if (composition->bgfill && (area > 0))
       gst_fcv_video_converter_fill_background (convert, &outframe,
           composition->bgcolor, composition->datatype);
 
-    if (!gst_fcv_video_converter_process (convert, objects, n_objects)) {
+    success = gst_fcv_video_converter_process (convert, objects,
+        normalize ? targets : NULL, n_objects);
+
+    if (!success) {
       GST_ERROR ("Failed to process frames for composition %u!", idx);
-      return FALSE;
+      goto cleanup;
+    }
+
+    for (num = 0; num < n_targets; num++) {
+      gst_fcv_video_converter_target_deinit (convert, &(targets[num]),
+          &(objects[(num * 2) + 1]));
+    }
+
+    n_targets = 0;
+
+    if (!normalize) {
+      success = gst_video_frame_normalize_ip (&outframe,
+          composition->datatype, composition->offsets, composition->scales);
     }
 
-    success = gst_video_frame_normalize_ip (&outframe,
-        composition->datatype, composition->offsets, composition->scales);
+    if (!success)
+      GST_ERROR ("Failed to normalize output frame for composition %u!", idx);
+
+cleanup:
+    // Release staging buffers of targets which were not normalized.
+    for (num = 0; num < n_targets; num++)
+      gst_fcv_video_converter_release_stage_buffer (convert, targets[num].stgid);
 
     for (num = 0; num < inframes->len; num++) {
       GstVideoFrame *inframe = &g_array_index (inframes, GstVideoFrame, num);
@@ -2332,10 +2590,8 @@ gst_fcv_video_converter_compose (GstFcvVideoConverter * convert,
 
     gst_video_frame_unmap (&outframe);
 
-    if (!success) {
-      GST_ERROR ("Failed to normalize output frame for composition %u!", idx);
+    if (!success)
       return FALSE;
-    }
   }
 
   return TRUE;
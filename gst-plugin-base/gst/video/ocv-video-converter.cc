@@ -4,12 +4,15 @@
  */
 
 #include "ocv-video-converter.h"
+#include "video-normalize.h"
 
 #include <unistd.h>
 #include <dlfcn.h>
 
 #include <opencv4/opencv2/opencv.hpp>
 
+#include <gst/utils/common-utils.h>
+
 #define GST_CAT_DEFAULT gst_video_converter_engine_debug
 
 // Convinient macros for printing plane values.
@@ -24,6 +27,18 @@
 #define GST_OCV_INVALID_STAGE_ID    (-1)
 #define GST_OCV_MAX_DRAW_OBJECTS    50
 
+// Maximum number of threads (including the caller) used for a composition.
+#define GST_OCV_MAX_THREADS         32
+// Minimum number of output rows in a tile processed by a single thread.
+#define GST_OCV_MIN_TILE_ROWS       64
+
+// Staging buffers are kept in power of two sized buckets starting at 4 KiB.
+#define GST_OCV_MIN_STAGE_BUCKET    12
+#define GST_OCV_N_STAGE_BUCKETS     32
+
+// Number of rows converted and normalized together in the fused conversion.
+#define GST_OCV_BAND_HEIGHT         16
+
 #define GST_OCV_OBJ_IS_YUV(obj)     (obj && (obj->flags & GST_OCV_FLAG_YUV))
 #define GST_OCV_OBJ_IS_RGB(obj)     (obj && (obj->flags & GST_OCV_FLAG_RGB))
 #define GST_OCV_OBJ_IS_GRAY(obj)    (obj && (obj->flags & GST_OCV_FLAG_GRAY))
@@ -41,6 +56,8 @@
 typedef struct _GstOcvPlane GstOcvPlane;
 typedef struct _GstOcvObject GstOcvObject;
 typedef struct _GstOcvStageBuffer GstOcvStageBuffer;
+typedef struct _GstOcvTarget GstOcvTarget;
+typedef struct _GstOcvTask GstOcvTask;
 
 enum {
   GST_OCV_FLAG_GRAY   = (1 << 0),
@@ -107,32 +124,94 @@ struct _GstOcvObject
  * @idx: Index of in the staging list.
  * @data: Pointer to bytes of data.
  * @size: Total number of bytes.
+ * @bucket: Index of the free list bucket, log2 of the size.
  * @used: Whether the buffer is currently used by some operaion.
+ * @next: Next buffer in the free list bucket.
  *
  * Blit staging buffer.
  */
 struct _GstOcvStageBuffer
 {
-  guint    idx;
-  gpointer data;
-  guint    size;
-  gboolean used;
+  guint             idx;
+  gpointer          data;
+  guint             size;
+  guint             bucket;
+  gboolean          used;
+  GstOcvStageBuffer *next;
+};
+
+/**
+ * GstOcvTarget:
+ * @normalizer: Normalization and quantization parameters of the composition.
+ * @data: Pointer to the region of interest in the output tensor.
+ * @stride: Stride of the output tensor in bytes.
+ * @stgid: Index of the staging buffer used in place of the output region.
+ * @done: Whether the region was already filled by the fused color conversion.
+ *
+ * Normalized output region of a blit. The destination object operates on an
+ * UINT8 staging buffer which is normalized and quantized into this region.
+ */
+struct _GstOcvTarget
+{
+  const GstVideoNormalizer *normalizer;
+  guint8                   *data;
+  guint32                  stride;
+  gint                     stgid;
+  gboolean                 done;
+};
+
+/**
+ * GstOcvTask:
+ * @s_obj: Source object of the blit tile.
+ * @d_obj: Destination object of the blit tile.
+ * @target: Normalized output region of the tile.
+ * @normalize: Whether the target is used.
+ * @success: Whether the tile was processed successfully.
+ *
+ * Blit or a tile of consecutive output rows of a blit processed by a single
+ * thread.
+ */
+struct _GstOcvTask
+{
+  GstOcvObject         s_obj;
+  GstOcvObject         d_obj;
+  GstOcvTarget         target;
+  gboolean             normalize;
+
+  gboolean             success;
 };
 
 struct _GstOcvVideoConverter
 {
   // Global mutex lock.
-  GMutex   lock;
-
-  // Staging buffers used as intermediaries during the OpenCV operations.
-  GArray   *stgbufs;
+  GMutex            lock;
+
+  // Staging buffers used as intermediaries during the OpenCV operations,
+  // indexed by their stage ID.
+  GPtrArray         *stgbufs;
+  // Free staging buffers, sorted in buckets by their power of two size.
+  GstOcvStageBuffer *freelists[GST_OCV_N_STAGE_BUCKETS];
+  // Lock protecting the staging buffers, shared between the worker threads.
+  GMutex            stglock;
+
+  // Worker threads, NULL if running in single threaded mode.
+  GThreadPool       *workers;
+  // Maximum number of threads (including the caller) used for a composition.
+  guint             n_threads;
+
+  // Number of tasks pushed to the worker threads which are not yet done.
+  guint             pending;
+  GMutex            tasklock;
+  GCond             wakeup;
 };
 
 static inline void
 gst_ocv_stage_buffer_free (gpointer data)
 {
   GstOcvStageBuffer *buffer = (GstOcvStageBuffer *) data;
+
   g_free (buffer->data);
+  g_slice_free (GstOcvStageBuffer, buffer);
 }
 
 static inline void
@@ -318,32 +397,41 @@ gst_ocv_video_converter_fetch_stage_buffer (GstOcvVideoConverter * convert,
     guint size)
 {
   GstOcvStageBuffer *buffer = NULL;
-  guint idx = 0;
+  guint bucket = 0;
+
+  // Round up the size to the power of two of the bucket it belongs to.
+  bucket = MAX (g_bit_storage (MAX (size, 1) - 1), GST_OCV_MIN_STAGE_BUCKET);
+  g_return_val_if_fail (bucket < GST_OCV_N_STAGE_BUCKETS, NULL);
 
-  for (idx = 0; idx < convert->stgbufs->len; idx++) {
-    buffer = &(g_array_index (convert->stgbufs, GstOcvStageBuffer, idx));
+  g_mutex_lock (&convert->stglock);
 
-    // Frame does not have same format and equal or greater dimensions, continue.
-    if (buffer->used || (buffer->size < size))
-      continue;
+  // Any free buffer in the bucket is big enough, take the first one.
+  if ((buffer = convert->freelists[bucket]) != NULL) {
+    convert->freelists[bucket] = buffer->next;
 
+    buffer->next = NULL;
     buffer->used = true;
 
+    g_mutex_unlock (&convert->stglock);
+
     GST_TRACE ("Using staging buffer at index %u, data %p and size %u",
         buffer->idx, buffer->data, buffer->size);
 
     return buffer;
   }
 
-  // Increase the number of staged buffer and take a pointer to the new buffer.
-  g_array_set_size (convert->stgbufs, convert->stgbufs->len + 1);
-  buffer = &(g_array_index (convert->stgbufs, GstOcvStageBuffer, idx));
+  buffer = g_slice_new0 (GstOcvStageBuffer);
 
-  buffer->idx = idx;
-  buffer->data = g_malloc0 (size);
-  buffer->size = size;
+  buffer->idx = convert->stgbufs->len;
+  buffer->size = 1U << bucket;
+  buffer->bucket = bucket;
+  buffer->data = g_malloc0 (buffer->size);
   buffer->used = true;
 
+  g_ptr_array_add (convert->stgbufs, buffer);
+
+  g_mutex_unlock (&convert->stglock);
+
   GST_TRACE ("Allocated staging buffer at index %u, data %p and size %u",
       buffer->idx, buffer->data, buffer->size);
 
@@ -356,9 +444,17 @@ gst_ocv_video_converter_release_stage_buffer (GstOcvVideoConverter * convert,
 {
   GstOcvStageBuffer *buffer = NULL;
 
-  buffer = &(g_array_index (convert->stgbufs, GstOcvStageBuffer, idx));
+  g_mutex_lock (&convert->stglock);
+
+  buffer = (GstOcvStageBuffer *) g_ptr_array_index (convert->stgbufs, idx);
   buffer->used = false;
 
+  // Return the buffer at the head of its bucket so it is reused while warm.
+  buffer->next = convert->freelists[buffer->bucket];
+  convert->freelists[buffer->bucket] = buffer;
+
+  g_mutex_unlock (&convert->stglock);
+
   GST_TRACE ("Released staging buffer at index %u, data %p and size %u",
       buffer->idx, buffer->data, buffer->size);
 }
@@ -497,6 +593,42 @@ gst_ocv_video_converter_stage_object_deinit (GstOcvVideoConverter * convert,
   }
 }
 
+static inline void
+gst_ocv_video_converter_target_init (GstOcvVideoConverter * convert,
+    GstOcvTarget * target, GstOcvObject * object, const GstVideoFrame * frame,
+    const GstVideoRectangle * region, const GstVideoNormalizer * normalizer)
+{
+  GstOcvStageBuffer *buffer = NULL;
+  GstOcvPlane *plane = &(object->planes[0]);
+  gint x = 0, y = 0;
+
+  // Same clipping as for the destination object.
+  x = MAX (region->x, 0);
+  y = MAX (region->y, 0);
+
+  target->normalizer = normalizer;
+  target->stride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0);
+  target->data = GUINT8_PTR_CAST (GST_VIDEO_FRAME_PLANE_DATA (frame, 0)) +
+      (y * target->stride) +
+      (x * normalizer->n_elements * normalizer->n_bytes);
+  target->done = false;
+
+  // Redirect the destination plane into an UINT8 staging buffer.
+  plane->stride = plane->width * normalizer->n_elements;
+  plane->type = CV_MAKETYPE (CV_8U, normalizer->n_elements);
+
+  buffer = gst_ocv_video_converter_fetch_stage_buffer (convert,
+      GST_ROUND_UP_128 (plane->stride * plane->height));
+
+  plane->data = buffer->data;
+  plane->stgid = buffer->idx;
+
+  target->stgid = buffer->idx;
+
+  GST_TRACE ("Target Plane: %" GST_OCV_PLANE_FORMAT " Output Data[%p]",
+      GST_OCV_PLANE_ARGS (plane), target->data);
+}
+
 static inline gint
 gst_ocv_get_conversion_mode (GstOcvObject * s_obj, GstOcvObject * d_obj)
 {
@@ -890,11 +1022,57 @@ gst_ocv_video_converter_resize (GstOcvVideoConverter * convert,
   return true;
 }
 
+static inline void
+gst_ocv_video_converter_cvt_color_bands (GstOcvObject * s_obj,
+    GstOcvObject * d_obj, gint conversion_mode, GstOcvTarget * target)
+{
+  GstOcvPlane *s_plane = &(s_obj->planes[0]), *s_chroma = &(s_obj->planes[1]);
+  GstOcvPlane *d_plane = &(d_obj->planes[0]);
+  guint row = 0, n_rows = 0, c_row = 0, c_rows = 0;
+
+  for (row = 0; row < d_plane->height; row += GST_OCV_BAND_HEIGHT) {
+    n_rows = MIN (GST_OCV_BAND_HEIGHT, d_plane->height - row);
+
+    // Each band reuses the head of the stage so it stays in cache until
+    // it is normalized and quantized into the output tensor.
+    cv::Mat output_matrix (n_rows, d_plane->width, d_plane->type,
+        d_plane->data, d_plane->stride);
+
+    if (GST_OCV_OBJ_IS_YUV (s_obj)) {
+      // Chroma rows corresponding to the luma band, heights are even.
+      c_row = (row * s_chroma->height) / s_plane->height;
+      c_rows = (n_rows * s_chroma->height) / s_plane->height;
+
+      cv::Mat y_plane (n_rows, s_plane->width, s_plane->type,
+          GUINT8_PTR_CAST (s_plane->data) + (row * s_plane->stride),
+          s_plane->stride);
+      cv::Mat uv_plane (c_rows, s_chroma->width, s_chroma->type,
+          GUINT8_PTR_CAST (s_chroma->data) + (c_row * s_chroma->stride),
+          s_chroma->stride);
+
+      cv::cvtColorTwoPlane (y_plane, uv_plane, output_matrix, conversion_mode);
+    } else {
+      cv::Mat input_matrix (n_rows, s_plane->width, s_plane->type,
+          GUINT8_PTR_CAST (s_plane->data) + (row * s_plane->stride),
+          s_plane->stride);
+
+      cv::cvtColor (input_matrix, output_matrix, conversion_mode);
+    }
+
+    gst_video_normalizer_convert (target->normalizer,
+        GUINT8_PTR_CAST (d_plane->data), d_plane->stride,
+        target->data + (row * target->stride), target->stride,
+        d_plane->width, n_rows);
+  }
+
+  target->done = true;
+}
+
 static inline gboolean
 gst_ocv_video_converter_cvt_color (GstOcvVideoConverter * convert,
-    GstOcvObject * s_obj, GstOcvObject * d_obj)
+    GstOcvObject * s_obj, GstOcvObject * d_obj, GstOcvTarget * target)
 {
-  gboolean success = false;
+  gboolean success = false, fused = false;
   gint conversion_mode = gst_ocv_get_conversion_mode (s_obj, d_obj);
 
   GST_TRACE ("Format conversion code: %d", conversion_mode);
@@ -907,7 +1085,17 @@ gst_ocv_video_converter_cvt_color (GstOcvVideoConverter * convert,
     return false;
   }
 
-  if (GST_OCV_OBJ_IS_YUV (s_obj) && GST_OCV_OBJ_IS_RGB (d_obj)) {
+  // Color conversion into a normalized output is done in bands of rows.
+  fused = (target != NULL) && GST_OCV_OBJ_IS_RGB (d_obj) &&
+      (s_obj->planes[0].width == d_obj->planes[0].width) &&
+      (s_obj->planes[0].height == d_obj->planes[0].height);
+
+  if (fused) {
+    gst_ocv_video_converter_cvt_color_bands (s_obj, d_obj, conversion_mode,
+        target);
+
+    success = true;
+  } else if (GST_OCV_OBJ_IS_YUV (s_obj) && GST_OCV_OBJ_IS_RGB (d_obj)) {
     cv::Mat y_plane (s_obj->planes[0].height, s_obj->planes[0].width,
         s_obj->planes[0].type, s_obj->planes[0].data, s_obj->planes[0].stride);
     cv::Mat uv_plane (s_obj->planes[1].height, s_obj->planes[1].width,
@@ -977,85 +1165,240 @@ gst_ocv_video_converter_cvt_color (GstOcvVideoConverter * convert,
 
 static inline gboolean
 gst_ocv_video_converter_process (GstOcvVideoConverter * convert,
-    GstOcvObject * objects, guint n_objects)
+    GstOcvObject * s_obj, GstOcvObject * d_obj, GstOcvTarget * target)
 {
-  GstOcvObject *s_obj = NULL, *d_obj = NULL;
-  guint idx = 0, flip = 0, rotate = 0;
+  guint flip = 0, rotate = 0;
   gfloat w_scale = 0.0, h_scale = 0.0, scale = 0.0;
   gboolean downscale = false, upscale = false, cvt_color = false;
 
-  GST_TRACE ("Processing %d object pairs", n_objects / 2);
-
-  for (idx = 0; idx < n_objects; idx += 2) {
-    s_obj = &(objects[idx]);
-    d_obj = &(objects[idx + 1]);
-
-    flip = s_obj->flip;
-    rotate = s_obj->rotate;
+  flip = s_obj->flip;
+  rotate = s_obj->rotate;
 
+  // Calculte the width and height scale ratios.
+  if ((rotate == GST_VCE_ROTATE_90) || (rotate == GST_VCE_ROTATE_270)) {
     w_scale = ((gfloat) d_obj->planes[0].height) / s_obj->planes[0].width;
     h_scale = ((gfloat) d_obj->planes[0].width) / s_obj->planes[0].height;
+  } else {
+    w_scale = ((gfloat) d_obj->planes[0].width) / s_obj->planes[0].width;
+    h_scale = ((gfloat) d_obj->planes[0].height) / s_obj->planes[0].height;
+  }
 
-    // Calculate the combined scale factor.
-    scale = w_scale * h_scale;
+  // Calculate the combined scale factor.
+  scale = w_scale * h_scale;
 
-    // Use downscale if output is smaller or for simple copy of a region.
-    downscale = (scale < 1.0) || ((w_scale == 1.0) && (h_scale == 1.0) &&
-        (rotate == 0) && (flip == 0) && (s_obj->format == d_obj->format) &&
-        (s_obj->format != GST_VIDEO_FORMAT_P010_10LE));
+  // Use downscale if output is smaller or for simple copy of a region.
+  downscale = (scale < 1.0) || ((w_scale == 1.0) && (h_scale == 1.0) &&
+      (rotate == 0) && (flip == 0) && (s_obj->format == d_obj->format) &&
+      (s_obj->format != GST_VIDEO_FORMAT_P010_10LE));
 
-    // Use upscale if output is bigger or same scale but reversed dimensions.
-    upscale = (scale > 1.0) ||
-        (scale == 1.0 && w_scale != 1.0 && h_scale != 1.0 && rotate == 0);
+  // Use upscale if output is bigger or same scale but reversed dimensions.
+  upscale = (scale > 1.0) ||
+      (scale == 1.0 && w_scale != 1.0 && h_scale != 1.0 && rotate == 0);
 
-    cvt_color = s_obj->format != d_obj->format;
+  cvt_color = s_obj->format != d_obj->format;
 
-    GST_LOG ("Starting processing of object pair %u; flip is: %d, rotate: %d, "
-        "downscale: %d, upscale: %d, scale: %f, color convert: %d",
-        idx / 2, flip, rotate, downscale, upscale, scale, cvt_color);
+  GST_LOG ("Starting processing of object pair; flip is: %d, rotate: %d, "
+      "downscale: %d, upscale: %d, scale: %f, color convert: %d",
+      flip, rotate, downscale, upscale, scale, cvt_color);
 
-    if ((rotate == GST_VCE_ROTATE_90) || (rotate == GST_VCE_ROTATE_270)) {
-      s_obj->resize = ((s_obj->planes[0].width != d_obj->planes[0].height) ||
-          (s_obj->planes[0].height != d_obj->planes[0].width)) ? true : false;
-    } else {
-      s_obj->resize = ((s_obj->planes[0].width != d_obj->planes[0].width) ||
-          (s_obj->planes[0].height != d_obj->planes[0].height)) ? true : false;
-    }
+  if ((rotate == GST_VCE_ROTATE_90) || (rotate == GST_VCE_ROTATE_270)) {
+    s_obj->resize = ((s_obj->planes[0].width != d_obj->planes[0].height) ||
+        (s_obj->planes[0].height != d_obj->planes[0].width)) ? true : false;
+  } else {
+    s_obj->resize = ((s_obj->planes[0].width != d_obj->planes[0].width) ||
+        (s_obj->planes[0].height != d_obj->planes[0].height)) ? true : false;
+  }
 
-    // First, do downscale if required so that next operations are less costly.
-    if (downscale && !gst_ocv_video_converter_resize (convert, s_obj, d_obj)) {
-      GST_ERROR ("Failed to resize image!");
-      return false;
-    }
+  // First, do downscale if required so that next operations are less costly.
+  if (downscale && !gst_ocv_video_converter_resize (convert, s_obj, d_obj)) {
+    GST_ERROR ("Failed to resize image!");
+    return false;
+  }
 
-    // Second, perform image rotate if necessary.
-    if ((rotate != 0) && !gst_ocv_video_converter_rotate (convert, s_obj, d_obj)) {
-      GST_ERROR ("Failed to rotate image!");
-      return false;
-    }
+  // Second, perform image rotate if necessary.
+  if ((rotate != 0) && !gst_ocv_video_converter_rotate (convert, s_obj, d_obj)) {
+    GST_ERROR ("Failed to rotate image!");
+    return false;
+  }
 
-    // Third, perform image flip if necessary.
-    if ((flip != 0) && !gst_ocv_video_converter_flip (convert, s_obj, d_obj)) {
-      GST_ERROR ("Failed to flip image!");
-      return false;
-    }
+  // Third, perform image flip if necessary.
+  if ((flip != 0) && !gst_ocv_video_converter_flip (convert, s_obj, d_obj)) {
+    GST_ERROR ("Failed to flip image!");
+    return false;
+  }
 
-    // Fourth, upscale output if needed
-    if (upscale && !gst_ocv_video_converter_resize (convert, s_obj, d_obj)) {
-      GST_ERROR ("Failed to upscale image!");
-      return false;
+  // Fourth, upscale output if needed
+  if (upscale && !gst_ocv_video_converter_resize (convert, s_obj, d_obj)) {
+    GST_ERROR ("Failed to upscale image!");
+    return false;
+  }
+
+  // Fifth, perform color conversion if necessary.
+  if (cvt_color &&
+      !gst_ocv_video_converter_cvt_color (convert, s_obj, d_obj, target)) {
+    GST_ERROR ("Failed to convert image format!");
+    return false;
+  }
+
+  // Lastly, normalize and quantize the stage unless the fused conversion did.
+  if ((target != NULL) && !target->done) {
+    gst_video_normalizer_convert (target->normalizer,
+        GUINT8_PTR_CAST (d_obj->planes[0].data), d_obj->planes[0].stride,
+        target->data, target->stride, d_obj->planes[0].width,
+        d_obj->planes[0].height);
+  }
+
+  GST_TRACE ("Object pair processed succesfully!");
+  return true;
+}
+
+static inline void
+gst_ocv_object_crop_rows (GstOcvObject * object, guint row, guint n_rows)
+{
+  GstOcvPlane *plane = &(object->planes[0]), *chroma = &(object->planes[1]);
+
+  // Vertically subsampled chroma, tile rows are always even.
+  if ((object->n_planes > 1) && (chroma->height < plane->height)) {
+    chroma->data = GUINT8_PTR_CAST (chroma->data) + ((row / 2) * chroma->stride);
+    chroma->height = n_rows / 2;
+  } else if (object->n_planes > 1) {
+    chroma->data = GUINT8_PTR_CAST (chroma->data) + (row * chroma->stride);
+    chroma->height = n_rows;
+  }
+
+  plane->data = GUINT8_PTR_CAST (plane->data) + (row * plane->stride);
+  plane->height = n_rows;
+}
+
+static inline gboolean
+gst_ocv_rectangles_overlap (const GstVideoRectangle * l_rect,
+    const GstVideoRectangle * r_rect)
+{
+  return (l_rect->x < (r_rect->x + r_rect->w)) &&
+      (r_rect->x < (l_rect->x + l_rect->w)) &&
+      (l_rect->y < (r_rect->y + r_rect->h)) &&
+      (r_rect->y < (l_rect->y + l_rect->h));
+}
+
+static inline guint
+gst_ocv_video_converter_split_tiles (GArray * tasks, GstOcvObject * s_obj,
+    GstOcvObject * d_obj, GstOcvTarget * target, guint n_tiles)
+{
+  GstOcvTask *task = NULL;
+  guint idx = 0, d_height = 0, d_row = 0, d_rows = 0, tile = 0;
+  gboolean mirror = false;
+
+  d_height = d_obj->planes[0].height;
+
+  // Limit the number of tiles so that each has enough output rows.
+  n_tiles = MIN (n_tiles, d_height / GST_OCV_MIN_TILE_ROWS);
+
+  // Output rows of 90/270 degrees rotations map to source columns.
+  if ((s_obj->rotate == GST_VCE_ROTATE_90) ||
+      (s_obj->rotate == GST_VCE_ROTATE_270))
+    n_tiles = 1;
+
+  // Vertical scaling interpolates between neighbouring source rows, which a
+  // tile does not see across its edges. Only blits whose output rows map 1:1
+  // to source rows are split, the rest are processed as a whole.
+  if (s_obj->planes[0].height != d_height)
+    n_tiles = 1;
+
+  n_tiles = MAX (n_tiles, 1);
+  // Tiles must have even number of rows due to chroma subsampling.
+  tile = GST_ROUND_UP_2 ((d_height + n_tiles - 1) / n_tiles);
+
+  // Vertical flip and 180 degrees rotation take the source rows in reverse.
+  mirror = ((s_obj->flip == GST_OCV_FLIP_VERTICAL) ||
+      (s_obj->flip == GST_OCV_FLIP_BOTH)) ^
+          (s_obj->rotate == GST_VCE_ROTATE_180);
+
+  for (d_row = 0; d_row < d_height; d_row += tile, idx++) {
+    d_rows = MIN (tile, d_height - d_row);
+
+    g_array_set_size (tasks, tasks->len + 1);
+    task = &(g_array_index (tasks, GstOcvTask, tasks->len - 1));
+
+    task->s_obj = *s_obj;
+    task->d_obj = *d_obj;
+    task->normalize = (target != NULL);
+
+    if (n_tiles > 1) {
+      gst_ocv_object_crop_rows (&(task->s_obj),
+          mirror ? (d_height - d_row - d_rows) : d_row, d_rows);
+      gst_ocv_object_crop_rows (&(task->d_obj), d_row, d_rows);
     }
 
-    // Fifth, perform color conversion if necessary.
-    if (cvt_color && !gst_ocv_video_converter_cvt_color (convert, s_obj, d_obj)) {
-      GST_ERROR ("Failed to convert image format!");
-      return false;
+    if (target != NULL) {
+      task->target = *target;
+      task->target.data += (n_tiles > 1) ? (d_row * target->stride) : 0;
     }
+  }
+
+  return idx;
+}
+
+static void
+gst_ocv_video_converter_task (gpointer data, gpointer userdata)
+{
+  GstOcvTask *task = (GstOcvTask *) data;
+  GstOcvVideoConverter *convert = (GstOcvVideoConverter *) userdata;
+
+  task->success = gst_ocv_video_converter_process (convert, &(task->s_obj),
+      &(task->d_obj), task->normalize ? &(task->target) : NULL);
+
+  g_mutex_lock (&convert->tasklock);
+
+  if (--(convert->pending) == 0)
+    g_cond_signal (&convert->wakeup);
+
+  g_mutex_unlock (&convert->tasklock);
+}
+
+static gboolean
+gst_ocv_video_converter_dispatch (GstOcvVideoConverter * convert,
+    GArray * tasks)
+{
+  GstOcvTask *task = NULL;
+  guint idx = 0;
+  gboolean success = true;
+
+  if (tasks->len == 0)
+    return true;
 
-    GST_TRACE ("Object pair %u processed succesfully!", idx / 2);
+  convert->pending = tasks->len - 1;
+
+  // Offload all but the first task which is processed in the calling thread.
+  for (idx = 1; (convert->workers != NULL) && (idx < tasks->len); idx++) {
+    task = &(g_array_index (tasks, GstOcvTask, idx));
+    g_thread_pool_push (convert->workers, task, NULL);
   }
 
-  return true;
+  task = &(g_array_index (tasks, GstOcvTask, 0));
+  task->success = gst_ocv_video_converter_process (convert, &(task->s_obj),
+      &(task->d_obj), task->normalize ? &(task->target) : NULL);
+
+  // Without worker threads the rest of the tasks are processed in sequence.
+  for (idx = 1; (convert->workers == NULL) && (idx < tasks->len); idx++) {
+    task = &(g_array_index (tasks, GstOcvTask, idx));
+    task->success = gst_ocv_video_converter_process (convert, &(task->s_obj),
+        &(task->d_obj), task->normalize ? &(task->target) : NULL);
+  }
+
+  if (convert->workers != NULL) {
+    g_mutex_lock (&convert->tasklock);
+
+    while (convert->pending != 0)
+      g_cond_wait (&convert->wakeup, &convert->tasklock);
+
+    g_mutex_unlock (&convert->tasklock);
+  }
+
+  for (idx = 0; idx < tasks->len; idx++)
+    success &= g_array_index (tasks, GstOcvTask, idx).success;
+
+  g_array_set_size (tasks, 0);
+  return success;
 }
 
 gboolean
@@ -1063,13 +1406,22 @@ gst_ocv_video_converter_compose (GstOcvVideoConverter * convert,
     GstVideoComposition * compositions, guint n_compositions, gpointer * fence)
 {
   GstOcvObject objects[GST_OCV_MAX_DRAW_OBJECTS] = {};
-  guint32 idx = 0, n_objects = 0, num = 0;
-  gboolean success = FALSE;
+  GstOcvTarget targets[GST_OCV_MAX_DRAW_OBJECTS / 2] = {};
+  GstVideoRectangle regions[GST_OCV_MAX_DRAW_OBJECTS / 2] = {};
+  GstVideoNormalizer normalizer;
+  GArray *tasks = NULL;
+  guint32 idx = 0, n_objects = 0, num = 0, first = 0, n_tiles = 0;
+  gboolean success = FALSE, normalize = FALSE, overlap = FALSE;
 
   // TODO: Implement async operations via threads.
   if (fence != NULL)
     GST_WARNING ("Asynchronous composition operations are not supported!");
 
+  GST_OCV_LOCK (convert);
+
+  // Tiles of the blits, storage is reused between the compositions.
+  tasks = g_array_new (FALSE, TRUE, sizeof (GstOcvTask));
+
   for (idx = 0; idx < n_compositions; idx++) {
     GstVideoFrame outframe;
     GArray *inframes = NULL;
@@ -1086,10 +1438,20 @@ gst_ocv_video_converter_compose (GstOcvVideoConverter * convert,
         (GstMapFlags)(GST_MAP_READ | GST_VIDEO_FRAME_MAP_FLAG_NO_REF));
 
     if (!success) {
-      GST_ERROR ("Failed to map input buffer!");
-      return FALSE;
+      GST_ERROR ("Failed to map output buffer!");
+      goto cleanup;
     }
 
+    // Objects are processed separately for each composition.
+    n_objects = 0;
+
+    // Normalization and quantization of single plane outputs is fused into
+    // the last operation of each blit instead of a separate in-place pass.
+    normalize = (GST_VIDEO_FRAME_N_PLANES (&outframe) == 1) &&
+        gst_video_normalizer_init (&normalizer, composition->datatype,
+            GST_VIDEO_FRAME_COMP_PSTRIDE (&outframe, 0), composition->offsets,
+            composition->scales) && !normalizer.identity;
+
     // Iterate over the input blit entries and update each OCV object.
     for (num = 0; num < n_blits; num++) {
       GstVideoBlit *blit = &(blits[num]);
@@ -1104,12 +1466,13 @@ gst_ocv_video_converter_compose (GstOcvVideoConverter * convert,
 
       if (!success) {
         GST_ERROR ("Failed to map input buffer!");
-        return FALSE;
+        goto cleanup;
       }
 
       if (n_objects >= GST_OCV_MAX_DRAW_OBJECTS) {
         GST_ERROR ("Number of objects exceeds %d!", GST_OCV_MAX_DRAW_OBJECTS);
-        return false;
+        success = FALSE;
+        goto cleanup;
       }
 
       if ((blit->mask & GST_VCE_MASK_FLIP_VERTICAL) &&
@@ -1133,7 +1496,8 @@ gst_ocv_video_converter_compose (GstOcvVideoConverter * convert,
               blit->source.a.x, blit->source.a.y, blit->source.b.x,
               blit->source.b.y, blit->source.c.x, blit->source.c.y,
               blit->source.d.x, blit->source.d.y);
-          return FALSE;
+          success = FALSE;
+          goto cleanup;
         }
 
         rectangle.x = blit->source.a.x;
@@ -1164,22 +1528,56 @@ gst_ocv_video_converter_compose (GstOcvVideoConverter * convert,
       gst_ocv_update_object (object, "Destination", &outframe, &rectangle,
           GST_OCV_FLIP_NONE, GST_VCE_ROTATE_0, composition->datatype);
 
+      regions[num] = rectangle;
+
+      if (normalize) {
+        gst_ocv_video_converter_target_init (convert, &(targets[num]), object,
+            &outframe, &rectangle, &normalizer);
+      }
+
       // Increment the objects counter by 2 for for Source/Destination pair.
       n_objects += 2;
     }
 
-    // Sanity checks, output frame and blit entries must not be NULL.
-    g_return_val_if_fail (blits != NULL, false);
+    // Blits are executed in waves of consecutive blits with non overlapping
+    // destinations, processed in parallel. A blit overlapping any blit in
+    // the current wave starts a new one in order to preserve the Z order.
+    for (num = 0, first = 0; success && (num <= n_blits); num++) {
+      guint n = 0;
 
-    for (num = 0; num < n_blits; num++) {
-      if (!gst_ocv_video_converter_process (convert, objects, n_objects)) {
-        GST_ERROR ("Failed to process frames for composition %u!", idx);
-        return false;
+      for (n = first, overlap = false; (num < n_blits) && (n < num); n++)
+        overlap |= gst_ocv_rectangles_overlap (&(regions[n]), &(regions[num]));
+
+      if (((num < n_blits) && !overlap) || (num == first))
+        continue;
+
+      // Blits in the wave are split in tiles in order to utilize all threads.
+      n_tiles = MAX (convert->n_threads / (num - first), 1);
+
+      for (n = first; n < num; n++) {
+        gst_ocv_video_converter_split_tiles (tasks, &(objects[n * 2]),
+            &(objects[(n * 2) + 1]), normalize ? &(targets[n]) : NULL, n_tiles);
+      }
+
+      success = gst_ocv_video_converter_dispatch (convert, tasks);
+
+      for (n = first; normalize && (n < num); n++) {
+        gst_ocv_video_converter_release_stage_buffer (convert,
+            targets[n].stgid);
       }
+
+      first = num;
     }
 
-    success = gst_video_frame_normalize_ip (&outframe,
-        composition->datatype, composition->offsets, composition->scales);
+    if (!success) {
+      GST_ERROR ("Failed to process frames for composition %u!", idx);
+      goto cleanup;
+    }
+
+    if (!normalize) {
+      success = gst_video_frame_normalize_ip (&outframe,
+          composition->datatype, composition->offsets, composition->scales);
+    }
 
     for (num = 0; num < inframes->len; num++) {
       GstVideoFrame *inframe = &g_array_index(inframes, GstVideoFrame, num);
@@ -1193,11 +1591,15 @@ gst_ocv_video_converter_compose (GstOcvVideoConverter * convert,
 
     if (!success) {
       GST_ERROR ("Failed to normalize output frame for composition %u!", idx);
-      return FALSE;
+      goto cleanup;
     }
   }
 
-  return true;
+cleanup:
+  g_array_free (tasks, TRUE);
+  GST_OCV_UNLOCK (convert);
+
+  return success;
 }
 
 gboolean
@@ -1219,27 +1621,49 @@ GstOcvVideoConverter *
 gst_ocv_video_converter_new (GstStructure * settings)
 {
   GstOcvVideoConverter *convert = NULL;
+  GError *error = NULL;
+  guint n_threads = g_get_num_processors ();
   gboolean success = true;
 
   convert = g_slice_new0 (GstOcvVideoConverter);
   g_return_val_if_fail (convert != NULL, NULL);
 
   g_mutex_init (&convert->lock);
+  g_mutex_init (&convert->stglock);
+  g_mutex_init (&convert->tasklock);
+  g_cond_init (&convert->wakeup);
 
   // Check whether symbol loading was successful.
   if (!success)
     goto cleanup;
 
-  convert->stgbufs = g_array_new (false, true, sizeof (GstOcvStageBuffer));
+  convert->stgbufs = g_ptr_array_new_with_free_func (gst_ocv_stage_buffer_free);
   if (convert->stgbufs == NULL) {
     GST_ERROR ("Failed to create array for the staging buffers!");
     goto cleanup;
   }
 
-  // Set clearing function for the allocated stage memory.
-  g_array_set_clear_func (convert->stgbufs, gst_ocv_stage_buffer_free);
+  if ((settings != NULL) &&
+      gst_structure_has_field (settings, GST_VCE_OPT_OCV_N_THREADS))
+    gst_structure_get_uint (settings, GST_VCE_OPT_OCV_N_THREADS, &n_threads);
+
+  convert->n_threads = CLAMP (n_threads, 1, GST_OCV_MAX_THREADS);
 
-  GST_INFO ("Created OpenCV Converter %p", convert);
+  // The calling thread processes one of the tasks, hence one less worker.
+  if (convert->n_threads > 1) {
+    convert->workers = g_thread_pool_new (gst_ocv_video_converter_task,
+        convert, convert->n_threads - 1, TRUE, &error);
+
+    if (convert->workers == NULL) {
+      GST_ERROR ("Failed to create worker threads, error: '%s'!",
+          GST_STR_NULL (error->message));
+      g_clear_error (&error);
+      goto cleanup;
+    }
+  }
+
+  GST_INFO ("Created OpenCV Converter %p with %u threads", convert,
+      convert->n_threads);
   return convert;
 
 cleanup:
@@ -1253,9 +1677,15 @@ gst_ocv_video_converter_free (GstOcvVideoConverter * convert)
   if (convert == NULL)
     return;
 
+  if (convert->workers != NULL)
+    g_thread_pool_free (convert->workers, FALSE, TRUE);
+
   if (convert->stgbufs != NULL)
-    g_array_free (convert->stgbufs, true);
+    g_ptr_array_free (convert->stgbufs, true);
 
+  g_cond_clear (&convert->wakeup);
+  g_mutex_clear (&convert->tasklock);
+  g_mutex_clear (&convert->stglock);
   g_mutex_clear (&convert->lock);
 
   GST_INFO ("Destroyed OpenCV converter: %p", convert);
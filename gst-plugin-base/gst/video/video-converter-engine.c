@@ -17,6 +17,10 @@
 #ifdef HAVE_OPENCV_H
 #include "ocv-video-converter.h"
 #endif // HAVE_OPENCV_H
+#include "cpu-video-converter.h"
+#include "video-normalize.h"
+
+#include <string.h>
 
 #include <gst/utils/common-utils.h>
 
@@ -33,6 +37,9 @@ GST_DEBUG_CATEGORY (gst_video_converter_engine_debug);
 #define UINT64_CONVERSION_SCALE  (G_MAXUINT64 / G_MAXUINT8)
 #define FLOAT_CONVERSION_SCALE   (1.0 / G_MAXUINT8)
 
+// Size in bytes of the stack buffer used for in-place normalization.
+#define GST_VIDEO_NORMALIZE_CHUNK_SIZE 3072
+
 /**
  * GstVideoConvNewFunction:
  * @settings: Structure with backend specific settings.
@@ -214,6 +221,7 @@ gst_video_converter_backend_get_type (void)
 #ifdef HAVE_OPENCV_H
     { GST_VCE_BACKEND_OCV, "Use OpenCV based video converter", "ocv" },
 #endif // HAVE_OPENCV_H
+    { GST_VCE_BACKEND_CPU, "Use CPU SIMD based video converter", "cpu" },
     { 0, NULL, NULL },
   };
 
@@ -260,6 +268,7 @@ gboolean
 gst_video_frame_normalize_ip (GstVideoFrame * vframe, guint64 datatype,
     gdouble offsets[GST_VCE_MAX_CHANNELS], gdouble scales[GST_VCE_MAX_CHANNELS])
 {
+  GstVideoNormalizer normalizer;
   guint8 *indata = NULL;
   gpointer outdata = NULL;
   gint row = 0, column = 0, width = 0, height = 0, idx = 0, bpp = 0;
@@ -288,6 +297,28 @@ gst_video_frame_normalize_ip (GstVideoFrame * vframe, guint64 datatype,
   width = GST_VIDEO_FRAME_WIDTH (vframe);
   height = GST_VIDEO_FRAME_HEIGHT (vframe);
 
+  // Use the vectorized kernel for the data types which it supports.
+  if (gst_video_normalizer_init (&normalizer, datatype, bpp, offsets, scales)) {
+    guint8 chunk[GST_VIDEO_NORMALIZE_CHUNK_SIZE];
+    gint n_pixels = 0, length = 0;
+
+    // Whole number of pixels which fit into the chunk.
+    n_pixels = GST_VIDEO_NORMALIZE_CHUNK_SIZE / bpp;
+
+    // Normalize chunks of pixels in reverse as front bytes are occupied. The
+    // output of a chunk may overlap its own input, hence it is copied aside.
+    for (idx = (width * height); idx > 0; idx -= length) {
+      length = MIN (idx, n_pixels);
+
+      memcpy (chunk, indata + ((idx - length) * bpp), length * bpp);
+      gst_video_normalizer_convert (&normalizer, chunk, 0,
+          GUINT8_PTR_CAST (outdata) + ((idx - length) * bpp * normalizer.n_bytes),
+          0, length, 1);
+    }
+
+    return TRUE;
+  }
+
   // Normalize in reverse as front bytes are occupied.
   for (row = (height - 1); row >= 0; row--) {
     for (column = ((width * bpp) - 1); (column >= 0) && success; column--) {
@@ -316,6 +347,8 @@ gst_video_converter_default_backend (void)
   backend = GST_VCE_BACKEND_C2D;
 #elif defined(HAVE_OPENCV_H)
   backend = GST_VCE_BACKEND_OCV;
+#elif !defined(HAVE_FASTCV_H)
+  backend = GST_VCE_BACKEND_CPU;
 #endif // !HAVE_IOT_CORE_IB2C_H && !HAVE_ADRENO_C2D2_H && ! HAVE_OPENCV_H
 
   return backend;
@@ -382,6 +415,15 @@ gst_video_converter_engine_new (GstVideoConvBackend backend,
       engine->flush = (GstVideoConvFlushFunction) gst_ocv_video_converter_flush;
       break;
 #endif // HAVE_OPENCV_H
+    case GST_VCE_BACKEND_CPU:
+      engine->new = (GstVideoConvNewFunction) gst_cpu_video_converter_new;
+      engine->free = (GstVideoConvFreeFunction) gst_cpu_video_converter_free;
+      engine->compose =
+          (GstVideoConvComposeFunction) gst_cpu_video_converter_compose;
+      engine->wait_fence =
+          (GstVideoConvWaitFenceFunction) gst_cpu_video_converter_wait_fence;
+      engine->flush = (GstVideoConvFlushFunction) gst_cpu_video_converter_flush;
+      break;
     default:
       GST_ERROR ("Unsupported video converter backend: 0x%X !", backend);
       goto cleanup;
@@ -51,6 +51,22 @@ GST_DEBUG_CATEGORY_EXTERN (gst_video_converter_engine_debug);
  */
 #define GST_VCE_OPT_FCV_OP_MODE "fcv-op-mode"
 
+/**
+ * GST_VCE_OPT_CPU_N_THREADS:
+ *
+ * #G_TYPE_UINT, set the number of threads used by the CPU converter.
+ * Default: number of available processors.
+ */
+#define GST_VCE_OPT_CPU_N_THREADS "cpu-n-threads"
+
+/**
+ * GST_VCE_OPT_OCV_N_THREADS:
+ *
+ * #G_TYPE_UINT, set the number of threads used by the OpenCV converter.
+ * Default: number of available processors.
+ */
+#define GST_VCE_OPT_OCV_N_THREADS "ocv-n-threads"
+
 typedef struct _GstVideoConvEngine GstVideoConvEngine;
 typedef struct _GstVideoQuadrilateral GstVideoQuadrilateral;
 typedef struct _GstVideoBlit GstVideoBlit;
@@ -79,6 +95,7 @@ typedef enum {
  * @GST_VCE_BACKEND_GLES: Use OpenGLES based video converter.
  * @GST_VCE_BACKEND_FCV: Use FastCV based video converter.
  * @GST_VCE_BACKEND_OCV: Use OpenCV based video converter.
+ * @GST_VCE_BACKEND_CPU: Use CPU SIMD based video converter.
  *
  * The backend of the video converter engine.
  */
@@ -88,6 +105,7 @@ typedef enum {
   GST_VCE_BACKEND_GLES,
   GST_VCE_BACKEND_FCV,
   GST_VCE_BACKEND_OCV,
+  GST_VCE_BACKEND_CPU,
 } GstVideoConvBackend;
 
 GST_VIDEO_API GType gst_video_converter_backend_get_type (void);
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include "video-normalize.h"
+
+#include <string.h>
+
+#include <gst/utils/common-utils.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <immintrin.h>
+#endif // __ARM_NEON
+
+#define GST_CAT_DEFAULT gst_video_converter_engine_debug
+
+#define GST_VIDEO_NORMALIZE_INT8_OFFSET   128.0F
+#define GST_VIDEO_NORMALIZE_FLOAT_SCALE   (1.0F / G_MAXUINT8)
+
+// Integer elements are truncated towards zero, same as the in-place
+// normalization, and saturated instead of wrapping around.
+static inline guint8
+gst_video_normalize_saturate_u8 (gfloat value)
+{
+  return (guint8) CLAMP (value, 0.0F, 255.0F);
+}
+
+static inline gint8
+gst_video_normalize_saturate_i8 (gfloat value)
+{
+  return (gint8) CLAMP (value, -128.0F, 127.0F);
+}
+
+static inline void
+gst_video_normalize_store_element (guint8 * data, guint idx, gfloat value,
+    guint64 datatype)
+{
+  switch (datatype) {
+    case GST_VCE_DATA_TYPE_U8:
+      GUINT8_PTR_CAST (data)[idx] = gst_video_normalize_saturate_u8 (value);
+      break;
+    case GST_VCE_DATA_TYPE_I8:
+      GINT8_PTR_CAST (data)[idx] = gst_video_normalize_saturate_i8 (value);
+      break;
+    case GST_VCE_DATA_TYPE_F16:
+#if defined(__ARM_FP16_FORMAT_IEEE)
+      GFLOAT16_PTR_CAST (data)[idx] = (__fp16) value;
+#else
+      GUINT16_PTR_CAST (data)[idx] = gst_float_to_half (value);
+#endif // __ARM_FP16_FORMAT_IEEE
+      break;
+    case GST_VCE_DATA_TYPE_F32:
+      GFLOAT_PTR_CAST (data)[idx] = value;
+      break;
+  }
+}
+
+static inline void
+gst_video_normalize_block (const guint8 * indata, const gfloat * scales,
+    const gfloat * offsets, gfloat * outdata)
+{
+#if defined(__ARM_NEON)
+  uint8x16_t pixels = vld1q_u8 (indata);
+  uint16x8_t low = vmovl_u8 (vget_low_u8 (pixels));
+  uint16x8_t high = vmovl_u8 (vget_high_u8 (pixels));
+  float32x4_t values[4];
+  guint num = 0;
+
+  values[0] = vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (low)));
+  values[1] = vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (low)));
+  values[2] = vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (high)));
+  values[3] = vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (high)));
+
+  for (num = 0; num < 4; num++) {
+    vst1q_f32 (outdata + (num * 4), vmlaq_f32 (vld1q_f32 (offsets + (num * 4)),
+        values[num], vld1q_f32 (scales + (num * 4))));
+  }
+#elif defined(__SSE2__)
+  __m128i pixels = _mm_loadu_si128 ((const __m128i *) indata);
+  __m128i zero = _mm_setzero_si128 ();
+  __m128i low = _mm_unpacklo_epi8 (pixels, zero);
+  __m128i high = _mm_unpackhi_epi8 (pixels, zero);
+  __m128 values[4];
+  guint num = 0;
+
+  values[0] = _mm_cvtepi32_ps (_mm_unpacklo_epi16 (low, zero));
+  values[1] = _mm_cvtepi32_ps (_mm_unpackhi_epi16 (low, zero));
+  values[2] = _mm_cvtepi32_ps (_mm_unpacklo_epi16 (high, zero));
+  values[3] = _mm_cvtepi32_ps (_mm_unpackhi_epi16 (high, zero));
+
+  for (num = 0; num < 4; num++) {
+    _mm_storeu_ps (outdata + (num * 4), _mm_add_ps (_mm_loadu_ps (
+        offsets + (num * 4)), _mm_mul_ps (values[num],
+            _mm_loadu_ps (scales + (num * 4)))));
+  }
+#else
+  guint num = 0;
+
+  for (num = 0; num < GST_VIDEO_NORMALIZER_BLOCK_SIZE; num++)
+    outdata[num] = indata[num] * scales[num] + offsets[num];
+#endif // __ARM_NEON
+}
+
+static inline void
+gst_video_normalize_store_block (guint8 * outdata, const gfloat * block,
+    guint64 datatype)
+{
+  guint num = 0;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+  int16x8_t low, high;
+
+  switch (datatype) {
+    case GST_VCE_DATA_TYPE_U8:
+    case GST_VCE_DATA_TYPE_I8:
+      low = vcombine_s16 (vqmovn_s32 (vcvtq_s32_f32 (vld1q_f32 (block))),
+          vqmovn_s32 (vcvtq_s32_f32 (vld1q_f32 (block + 4))));
+      high = vcombine_s16 (vqmovn_s32 (vcvtq_s32_f32 (vld1q_f32 (block + 8))),
+          vqmovn_s32 (vcvtq_s32_f32 (vld1q_f32 (block + 12))));
+
+      if (datatype == GST_VCE_DATA_TYPE_U8)
+        vst1q_u8 (outdata, vcombine_u8 (vqmovun_s16 (low), vqmovun_s16 (high)));
+      else
+        vst1q_s8 (GINT8_PTR_CAST (outdata),
+            vcombine_s8 (vqmovn_s16 (low), vqmovn_s16 (high)));
+      return;
+    case GST_VCE_DATA_TYPE_F16:
+      for (num = 0; num < GST_VIDEO_NORMALIZER_BLOCK_SIZE; num += 4) {
+        vst1_u16 (GUINT16_PTR_CAST (outdata) + num,
+            vreinterpret_u16_f16 (vcvt_f16_f32 (vld1q_f32 (block + num))));
+      }
+      return;
+  }
+#elif defined(__SSE2__)
+  __m128i low, high;
+
+  switch (datatype) {
+    case GST_VCE_DATA_TYPE_U8:
+    case GST_VCE_DATA_TYPE_I8:
+      // Truncate towards zero and narrow with saturation.
+      low = _mm_packs_epi32 (_mm_cvttps_epi32 (_mm_loadu_ps (block)),
+          _mm_cvttps_epi32 (_mm_loadu_ps (block + 4)));
+      high = _mm_packs_epi32 (_mm_cvttps_epi32 (_mm_loadu_ps (block + 8)),
+          _mm_cvttps_epi32 (_mm_loadu_ps (block + 12)));
+
+      if (datatype == GST_VCE_DATA_TYPE_U8)
+        _mm_storeu_si128 ((__m128i *) outdata, _mm_packus_epi16 (low, high));
+      else
+        _mm_storeu_si128 ((__m128i *) outdata, _mm_packs_epi16 (low, high));
+      return;
+#if defined(__F16C__)
+    case GST_VCE_DATA_TYPE_F16:
+      for (num = 0; num < GST_VIDEO_NORMALIZER_BLOCK_SIZE; num += 4) {
+        _mm_storel_epi64 ((__m128i *) (GUINT16_PTR_CAST (outdata) + num),
+            _mm_cvtps_ph (_mm_loadu_ps (block + num), _MM_FROUND_TO_NEAREST_INT));
+      }
+      return;
+#endif // __F16C__
+  }
+#endif // __ARM_NEON && __aarch64__
+
+  for (num = 0; num < GST_VIDEO_NORMALIZER_BLOCK_SIZE; num++)
+    gst_video_normalize_store_element (outdata, num, block[num], datatype);
+}
+
+static inline void
+gst_video_normalizer_convert_row (const GstVideoNormalizer * normalizer,
+    const guint8 * indata, guint8 * outdata, guint n_values)
+{
+  gfloat block[GST_VIDEO_NORMALIZER_BLOCK_SIZE];
+  const gfloat *scales = NULL, *offsets = NULL;
+  guint idx = 0, phase = 0, channel = 0;
+
+  for (; (idx + GST_VIDEO_NORMALIZER_BLOCK_SIZE) <= n_values;
+      idx += GST_VIDEO_NORMALIZER_BLOCK_SIZE) {
+    // The factors pattern repeats every 'n_elements' blocks.
+    scales = normalizer->scales + (phase * GST_VIDEO_NORMALIZER_BLOCK_SIZE);
+    offsets = normalizer->offsets + (phase * GST_VIDEO_NORMALIZER_BLOCK_SIZE);
+
+    if (normalizer->datatype == GST_VCE_DATA_TYPE_F32) {
+      gst_video_normalize_block (indata + idx, scales, offsets,
+          GFLOAT_PTR_CAST (outdata) + idx);
+    } else {
+      gst_video_normalize_block (indata + idx, scales, offsets, block);
+      gst_video_normalize_store_block (outdata + (idx * normalizer->n_bytes),
+          block, normalizer->datatype);
+    }
+
+    phase = (phase + 1) % normalizer->n_elements;
+  }
+
+  // Remaining elements at the end of the row which do not fill a whole block.
+  for (; idx < n_values; idx++) {
+    channel = idx % normalizer->n_elements;
+
+    gst_video_normalize_store_element (outdata, idx,
+        indata[idx] * normalizer->scales[channel] + normalizer->offsets[channel],
+        normalizer->datatype);
+  }
+}
+
+gboolean
+gst_video_normalizer_init (GstVideoNormalizer * normalizer, guint64 datatype,
+    guint n_elements, const gdouble offsets[GST_VCE_MAX_CHANNELS],
+    const gdouble scales[GST_VCE_MAX_CHANNELS])
+{
+  gfloat factors[GST_VCE_MAX_CHANNELS], bias[GST_VCE_MAX_CHANNELS];
+  guint idx = 0;
+
+  g_return_val_if_fail (normalizer != NULL, FALSE);
+  g_return_val_if_fail ((n_elements > 0) &&
+      (n_elements <= GST_VCE_MAX_CHANNELS), FALSE);
+
+  switch (datatype) {
+    case GST_VCE_DATA_TYPE_U8:
+    case GST_VCE_DATA_TYPE_I8:
+      normalizer->n_bytes = 1;
+      break;
+    case GST_VCE_DATA_TYPE_F16:
+      normalizer->n_bytes = 2;
+      break;
+    case GST_VCE_DATA_TYPE_F32:
+      normalizer->n_bytes = 4;
+      break;
+    default:
+      GST_DEBUG ("Unsupported data type %" G_GUINT64_FORMAT, datatype);
+      return FALSE;
+  }
+
+  normalizer->datatype = datatype;
+  normalizer->n_elements = n_elements;
+  normalizer->identity = (datatype == GST_VCE_DATA_TYPE_U8);
+
+  // Fold type conversion and (value - mean) * sigma into value * scale + offset.
+  for (idx = 0; idx < n_elements; idx++) {
+    normalizer->identity &= (offsets[idx] == 0) && (scales[idx] == 1);
+
+    switch (datatype) {
+      case GST_VCE_DATA_TYPE_U8:
+        factors[idx] = scales[idx];
+        bias[idx] = -offsets[idx] * scales[idx];
+        break;
+      case GST_VCE_DATA_TYPE_I8:
+        factors[idx] = scales[idx];
+        bias[idx] = -(offsets[idx] + GST_VIDEO_NORMALIZE_INT8_OFFSET) *
+            scales[idx];
+        break;
+      default:
+        factors[idx] = scales[idx] * GST_VIDEO_NORMALIZE_FLOAT_SCALE;
+        bias[idx] = -offsets[idx] * scales[idx];
+        break;
+    }
+  }
+
+  for (idx = 0; idx < GST_VIDEO_NORMALIZER_PATTERN_SIZE; idx++) {
+    normalizer->scales[idx] = factors[idx % n_elements];
+    normalizer->offsets[idx] = bias[idx % n_elements];
+  }
+
+  return TRUE;
+}
+
+void
+gst_video_normalizer_convert (const GstVideoNormalizer * normalizer,
+    const guint8 * indata, guint instride, guint8 * outdata, guint outstride,
+    guint width, guint height)
+{
+  guint row = 0, n_values = width * normalizer->n_elements;
+
+  for (row = 0; row < height; row++) {
+    if (normalizer->identity)
+      memcpy (outdata, indata, n_values);
+    else
+      gst_video_normalizer_convert_row (normalizer, indata, outdata, n_values);
+
+    indata += instride;
+    outdata += outstride;
+  }
+}
+
+void
+gst_video_normalizer_fill (const GstVideoNormalizer * normalizer,
+    const guint8 * pixel, guint8 * outdata, guint outstride, guint width,
+    guint height)
+{
+  guint8 *pattern = NULL;
+  guint idx = 0, row = 0, n_bytes = 0;
+
+  if ((width == 0) || (height == 0))
+    return;
+
+  n_bytes = width * normalizer->n_elements * normalizer->n_bytes;
+
+  // Convert a single row of the fill color and replicate it.
+  pattern = g_malloc (width * normalizer->n_elements);
+
+  for (idx = 0; idx < width; idx++)
+    memcpy (pattern + (idx * normalizer->n_elements), pixel,
+        normalizer->n_elements);
+
+  gst_video_normalizer_convert (normalizer, pattern, 0, outdata, 0, width, 1);
+  g_free (pattern);
+
+  for (row = 1; row < height; row++)
+    memcpy (outdata + (row * outstride), outdata, n_bytes);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __GST_VIDEO_NORMALIZE_H__
+#define __GST_VIDEO_NORMALIZE_H__
+
+#include "video-converter-engine.h"
+
+#include <gst/utils/float16-utils.h>
+
+G_BEGIN_DECLS
+
+// Number of UINT8 elements converted together by the vectorized kernel.
+#define GST_VIDEO_NORMALIZER_BLOCK_SIZE   16
+// Per element factors repeated for a whole number of pixels and blocks.
+#define GST_VIDEO_NORMALIZER_PATTERN_SIZE \
+    (GST_VCE_MAX_CHANNELS * GST_VIDEO_NORMALIZER_BLOCK_SIZE)
+
+typedef struct _GstVideoNormalizer GstVideoNormalizer;
+
+/**
+ * GstVideoNormalizer:
+ * @datatype: The data type of the output tensor elements.
+ * @n_bytes: Size in bytes of a single output element.
+ * @n_elements: Number of interleaved elements (channels) per pixel.
+ * @identity: Whether the conversion is a plain UINT8 copy.
+ * @scales: Folded per element scale factors, repeated over the pattern.
+ * @offsets: Folded per element offsets, repeated over the pattern.
+ *
+ * Precomputed state for converting interleaved UINT8 pixels into normalized
+ * and quantized output elements in a single pass. The mean/sigma parameters
+ * of the composition and the conversion into the end type are folded into a
+ * single multiply-add per element.
+ */
+struct _GstVideoNormalizer
+{
+  guint64  datatype;
+  guint    n_bytes;
+  guint    n_elements;
+  gboolean identity;
+
+  gfloat   scales[GST_VIDEO_NORMALIZER_PATTERN_SIZE];
+  gfloat   offsets[GST_VIDEO_NORMALIZER_PATTERN_SIZE];
+};
+
+/**
+ * gst_video_normalizer_init:
+ * @normalizer: Pointer to the normalizer which will be initialized.
+ * @datatype: The data type of the output tensor elements.
+ * @n_elements: Number of interleaved elements (channels) per pixel.
+ * @offsets: Component offset factors, as set in the composition.
+ * @scales: Component scale factors, as set in the composition.
+ *
+ * Fold the normalization parameters of a composition into a normalizer.
+ * Only UINT8, INT8, FLOAT16 and FLOAT32 output types are supported.
+ *
+ * return: TRUE on success or FALSE if the data type is not supported
+ */
+GST_VIDEO_API gboolean
+gst_video_normalizer_init (GstVideoNormalizer * normalizer, guint64 datatype,
+                           guint n_elements,
+                           const gdouble offsets[GST_VCE_MAX_CHANNELS],
+                           const gdouble scales[GST_VCE_MAX_CHANNELS]);
+
+/**
+ * gst_video_normalizer_convert:
+ * @normalizer: Pointer to initialized normalizer.
+ * @indata: Pointer to the first interleaved UINT8 input row.
+ * @instride: Input stride in bytes.
+ * @outdata: Pointer to the first output row.
+ * @outstride: Output stride in bytes.
+ * @width: Number of pixels in a row.
+ * @height: Number of rows.
+ *
+ * Normalize and quantize a region of interleaved UINT8 pixels into the end
+ * data type. Integer elements are truncated towards zero and saturated.
+ * Input and output rows must not overlap.
+ *
+ * return: NONE
+ */
+GST_VIDEO_API void
+gst_video_normalizer_convert (const GstVideoNormalizer * normalizer,
+                              const guint8 * indata, guint instride,
+                              guint8 * outdata, guint outstride,
+                              guint width, guint height);
+
+/**
+ * gst_video_normalizer_fill:
+ * @normalizer: Pointer to initialized normalizer.
+ * @pixel: Array with the UINT8 value of each element of the fill color.
+ * @outdata: Pointer to the first output row.
+ * @outstride: Output stride in bytes.
+ * @width: Number of pixels in a row.
+ * @height: Number of rows.
+ *
+ * Fill a region with the normalized and quantized value of a single pixel.
+ *
+ * return: NONE
+ */
+GST_VIDEO_API void
+gst_video_normalizer_fill (const GstVideoNormalizer * normalizer,
+                           const guint8 * pixel, guint8 * outdata,
+                           guint outstride, guint width, guint height);
+
+G_END_DECLS
+
+#endif // __GST_VIDEO_NORMALIZE_H__
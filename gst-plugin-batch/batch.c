@@ -26,7 +26,15 @@ GST_DEBUG_CATEGORY (gst_batch_debug);
 #define gst_batch_parent_class parent_class
 G_DEFINE_TYPE (GstBatch, gst_batch, GST_TYPE_ELEMENT);
 
+#define GST_TYPE_BATCH_POLICY (gst_batch_policy_get_type())
+
 #define DEFAULT_PROP_MOVING_WINDOW_SIZE 1
+#define DEFAULT_PROP_POLICY             GST_BATCH_POLICY_ALL
+#define DEFAULT_PROP_MAX_LATENCY        0
+#define DEFAULT_PROP_MIN_BATCH_SIZE     0
+
+// Weight of the latest batch in the fill ratio and latency moving averages.
+#define GST_BATCH_STATS_WEIGHT          0.0625
 
 #define GST_BATCH_SINK_CAPS \
     "video/x-raw(ANY); "    \
@@ -40,6 +48,11 @@ enum
 {
   PROP_0,
   PROP_MOVING_WINDOW_SIZE,
+  PROP_POLICY,
+  PROP_MAX_LATENCY,
+  PROP_MIN_BATCH_SIZE,
+  PROP_FILL_RATIO,
+  PROP_LATENCY,
 };
 
 static GstStaticPadTemplate gst_batch_sink_template =
@@ -56,6 +69,32 @@ static GstStaticPadTemplate gst_batch_src_template =
         GST_STATIC_CAPS (GST_BATCH_SRC_CAPS)
     );
 
+static GType
+gst_batch_policy_get_type (void)
+{
+  static GType gtype = 0;
+  static const GEnumValue variants[] = {
+    { GST_BATCH_POLICY_ALL,
+        "Wait for buffers from all streams up to the output frame duration",
+        "all"
+    },
+    { GST_BATCH_POLICY_LATENCY,
+        "Wait for buffers from all streams, but release the batch once a "
+        "ready stream has waited for the maximum latency", "latency"
+    },
+    { GST_BATCH_POLICY_FIRST_N,
+        "Release the batch as soon as the minimum number of streams and all "
+        "priority streams are ready, or once a ready stream has waited for "
+        "the maximum latency", "first-n"
+    },
+    { 0, NULL, NULL },
+  };
+
+  if (!gtype)
+    gtype = g_enum_register_static ("GstBatchPolicy", variants);
+
+  return gtype;
+}
 
 static void
 gst_data_queue_free_item (gpointer userdata)
@@ -179,22 +218,110 @@ static gboolean
 gst_batch_sink_buffers_available (GstBatch * batch)
 {
   GList *list = NULL;
-  gboolean available = TRUE, idle = TRUE;
+  guint n_active = 0, n_ready = 0, n_required = 0;
+  gboolean priority = TRUE;
 
   for (list = batch->sinkpads; list != NULL; list = g_list_next (list)) {
     GstBatchSinkPad *sinkpad = GST_BATCH_SINK_PAD (list->data);
-
-    idle &= sinkpad->is_idle;
+    gboolean ready = FALSE;
 
     // Pads which are in EOS or FLUSHING state are not included in the checks.
     if (sinkpad->is_idle)
       continue;
 
-    available &= (g_queue_get_length (sinkpad->buffers) >= batch->depth);
+    ready = (g_queue_get_length (sinkpad->buffers) >= batch->depth);
+
+    n_active++;
+    n_ready += ready ? 1 : 0;
+    priority &= !sinkpad->priority || ready;
+  }
+
+  // If all pads are idle there is nothing to wait for.
+  if (n_active == 0)
+    return FALSE;
+
+  if (batch->policy != GST_BATCH_POLICY_FIRST_N)
+    return (n_ready == n_active);
+
+  n_required = (batch->min_batch_size != 0) ?
+      MIN (batch->min_batch_size, n_active) : n_active;
+
+  return priority && (n_ready >= n_required);
+}
+
+static gint64
+gst_batch_sink_buffers_deadline (GstBatch * batch)
+{
+  GList *list = NULL;
+  GstClockTime latency = GST_CLOCK_TIME_NONE;
+  gint64 deadline = -1;
+
+  // The legacy policy releases batches on a grid of output frame durations.
+  if (batch->policy == GST_BATCH_POLICY_ALL)
+    return batch->endtime;
+
+  latency = (batch->max_latency != 0) ? batch->max_latency : batch->duration;
+
+  if (!GST_CLOCK_TIME_IS_VALID (latency))
+    return -1;
+
+  // Release the batch once any of the ready pads has waited long enough.
+  for (list = batch->sinkpads; list != NULL; list = g_list_next (list)) {
+    GstBatchSinkPad *sinkpad = GST_BATCH_SINK_PAD (list->data);
+    gint64 arrival = 0;
+
+    if (sinkpad->is_idle ||
+        (g_queue_get_length (sinkpad->buffers) < batch->depth))
+      continue;
+
+    // Arrival time of the buffer which completed the pad window.
+    arrival = GST_BATCH_SINK_PAD_ARRIVAL (sinkpad, batch->depth - 1);
+
+    if ((deadline == (-1)) || (arrival < deadline))
+      deadline = arrival;
   }
 
-  // If all pads are idle then ignore the cumulative buffers 'available' variable.
-  return !idle && available;
+  if (deadline == (-1))
+    return -1;
+
+  return deadline + (latency / GST_USECOND);
+}
+
+static void
+gst_batch_update_statistics (GstBatch * batch, guint channels, gint64 now)
+{
+  GList *list = NULL;
+  guint n_active = 0, n_used = 0;
+  gint64 latency = 0;
+
+  for (list = batch->sinkpads; list != NULL; list = g_list_next (list)) {
+    GstBatchSinkPad *sinkpad = GST_BATCH_SINK_PAD (list->data);
+    guint stream_id = g_list_index (batch->sinkpads, sinkpad);
+
+    if (!sinkpad->is_idle)
+      n_active++;
+
+    if (!(channels & (1 << stream_id)))
+      continue;
+
+    n_used++;
+
+    // The added latency is the wait time of the longest waiting used stream.
+    latency = MAX (latency, now -
+        GST_BATCH_SINK_PAD_ARRIVAL (sinkpad, batch->depth - 1));
+  }
+
+  if (n_active == 0)
+    return;
+
+  batch->fill_ratio += GST_BATCH_STATS_WEIGHT *
+      (((gdouble) MIN (n_used, n_active) / n_active) - batch->fill_ratio);
+  batch->latency = (GstClockTime) (batch->latency + GST_BATCH_STATS_WEIGHT *
+      (((gdouble) latency * GST_USECOND) - batch->latency));
+
+  GST_LOG_OBJECT (batch, "Used %u out of %u streams, waited %" G_GINT64_FORMAT
+      " us, fill ratio %.2f, latency %" GST_TIME_FORMAT, n_used, n_active,
+      latency, batch->fill_ratio, GST_TIME_ARGS (batch->latency));
 }
 
 static gboolean
@@ -294,6 +421,7 @@ gst_batch_extract_sink_buffer (GstElement * element, GstPad * pad,
   GstVideoRegionOfInterestMeta *roimeta = NULL;
   GstStructure *structure = NULL;
   guint num = 0, stream_id = 0, idx = 0, flags = 0;
+  gint64 latency = 0;
 
   // If the number of buffers in the queue is less than the requered depth,
   // not enough buffers have been accumulated for the current sink pad
@@ -356,10 +484,16 @@ gst_batch_extract_sink_buffer (GstElement * element, GstPad * pad,
 cleanup:
   // Take the timestamp of the first buffer in the queue
   inbuffer = g_queue_peek_head (sinkpad->buffers);
+
+  // Time which the stream waited for the batch to be released.
+  latency = g_get_monotonic_time () -
+      GST_BATCH_SINK_PAD_ARRIVAL (sinkpad, batch->depth - 1);
+
   // Create a structure that will contain information for decryption.
   structure = gst_structure_new (gst_mux_stream_name (stream_id),
       "timestamp", G_TYPE_UINT64, GST_BUFFER_TIMESTAMP (inbuffer),
       "duration", G_TYPE_UINT64, batch->duration,
+      "latency", G_TYPE_UINT64, (guint64) (MAX (latency, 0) * GST_USECOND),
       "flags", G_TYPE_UINT, flags, NULL);
 
   // Add meta containing information for tensor decryption downstream.
@@ -381,15 +515,19 @@ gst_batch_worker_task (gpointer userdata)
   GList *list = NULL;
   guint channels = 0;
   gboolean available = FALSE;
+  gint64 deadline = -1;
 
   GST_BATCH_LOCK (batch);
 
-  // Wait for data from all pads a maximum of average duration seconds.
+  // Wait for data from the pads until the deadline of the batching policy.
+  // The deadline is re-evaluated on each wakeup as it depends on the arrivals.
   while (batch->active && !gst_batch_sink_buffers_available (batch)) {
-    if (batch->endtime == (-1)) {
-      // End time not yet initialized, wait until first buffers are received.
+    deadline = gst_batch_sink_buffers_deadline (batch);
+
+    if (deadline == (-1)) {
+      // Deadline not yet known, wait until first buffers are received.
       g_cond_wait (&batch->wakeup, &batch->lock);
-    } else if (!g_cond_wait_until (&batch->wakeup, &batch->lock, batch->endtime)) {
+    } else if (!g_cond_wait_until (&batch->wakeup, &batch->lock, deadline)) {
       GST_DEBUG_OBJECT (batch, "Clock timeout, not all pads have buffers!");
       break;
     }
@@ -434,6 +572,9 @@ gst_batch_worker_task (gpointer userdata)
   gst_element_foreach_sink_pad (GST_ELEMENT_CAST (batch),
       gst_batch_extract_sink_buffer, buffer);
 
+  gst_batch_update_statistics (batch, GST_BUFFER_OFFSET (buffer),
+      g_get_monotonic_time ());
+
   GST_BATCH_UNLOCK (batch);
 
   GST_BATCH_SRC_LOCK (srcpad);
@@ -494,7 +635,7 @@ gst_batch_worker_task (gpointer userdata)
       if (g_queue_is_empty (sinkpad->buffers))
         break;
 
-      gst_buffer_unref (g_queue_pop_head (sinkpad->buffers));
+      gst_buffer_unref (gst_batch_sink_pad_pop_buffer (sinkpad));
     }
 
   }
@@ -525,6 +666,9 @@ gst_batch_start_worker_task (GstBatch * batch)
   for (list = batch->sinkpads; list != NULL; list = list->next)
     GST_BATCH_SINK_PAD (list->data)->is_idle = FALSE;
 
+  batch->fill_ratio = 0.0;
+  batch->latency = 0;
+
   batch->active = TRUE;
   GST_BATCH_UNLOCK (batch);
 
@@ -579,7 +723,7 @@ gst_batch_stop_worker_task (GstBatch * batch)
 
   for (list = batch->sinkpads; list != NULL; list = list->next) {
     GstBatchSinkPad *sinkpad = GST_BATCH_SINK_PAD (list->data);
-    g_queue_clear_full (sinkpad->buffers, (GDestroyNotify) gst_buffer_unref);
+    gst_batch_sink_pad_flush (sinkpad);
   }
 
   GST_BATCH_UNLOCK (batch);
@@ -846,7 +990,7 @@ gst_batch_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
       GST_BATCH_LOCK (batch);
 
       // When upstream elements query for drain, flush buffers in the queue.
-      g_queue_clear_full (sinkpad->buffers, (GDestroyNotify) gst_buffer_unref);
+      gst_batch_sink_pad_flush (sinkpad);
       g_cond_broadcast (&batch->wakeup);
 
       GST_BATCH_UNLOCK (batch);
@@ -917,7 +1061,7 @@ gst_batch_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
     case GST_EVENT_FLUSH_START:
       GST_BATCH_LOCK (batch);
 
-      g_queue_clear_full (sinkpad->buffers, (GDestroyNotify) gst_buffer_unref);
+      gst_batch_sink_pad_flush (sinkpad);
       sinkpad->is_idle = TRUE;
 
       g_cond_broadcast (&batch->wakeup);
@@ -961,7 +1105,7 @@ gst_batch_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
       }
 
       if (!g_queue_is_empty (sinkpad->buffers))
-        g_queue_clear_full (sinkpad->buffers, (GDestroyNotify) gst_buffer_unref);
+        gst_batch_sink_pad_flush (sinkpad);
 
       GST_TRACE_OBJECT (sinkpad, "Received idle");
       sinkpad->is_idle = TRUE;
@@ -1015,7 +1159,7 @@ gst_batch_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
 
   GST_BATCH_LOCK (batch);
 
-  g_queue_push_tail (sinkpad->buffers, buffer);
+  gst_batch_sink_pad_push_buffer (sinkpad, buffer);
   g_cond_broadcast (&batch->wakeup);
 
   GST_BATCH_UNLOCK (batch);
@@ -1149,6 +1293,22 @@ gst_batch_set_property (GObject * object, guint prop_id,
     case PROP_MOVING_WINDOW_SIZE:
       batch->moving_window_size = g_value_get_uint (value);
       break;
+    case PROP_POLICY:
+      batch->policy = g_value_get_enum (value);
+      break;
+    case PROP_MAX_LATENCY:
+      GST_BATCH_LOCK (batch);
+      batch->max_latency = g_value_get_uint64 (value);
+      // Wake up the worker task in order to re-evaluate its deadline.
+      g_cond_broadcast (&batch->wakeup);
+      GST_BATCH_UNLOCK (batch);
+      break;
+    case PROP_MIN_BATCH_SIZE:
+      GST_BATCH_LOCK (batch);
+      batch->min_batch_size = g_value_get_uint (value);
+      g_cond_broadcast (&batch->wakeup);
+      GST_BATCH_UNLOCK (batch);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1165,6 +1325,25 @@ gst_batch_get_property (GObject * object, guint prop_id,
     case PROP_MOVING_WINDOW_SIZE:
       g_value_set_uint (value, batch->moving_window_size);
       break;
+    case PROP_POLICY:
+      g_value_set_enum (value, batch->policy);
+      break;
+    case PROP_MAX_LATENCY:
+      g_value_set_uint64 (value, batch->max_latency);
+      break;
+    case PROP_MIN_BATCH_SIZE:
+      g_value_set_uint (value, batch->min_batch_size);
+      break;
+    case PROP_FILL_RATIO:
+      GST_BATCH_LOCK (batch);
+      g_value_set_double (value, batch->fill_ratio);
+      GST_BATCH_UNLOCK (batch);
+      break;
+    case PROP_LATENCY:
+      GST_BATCH_LOCK (batch);
+      g_value_set_uint64 (value, batch->latency);
+      GST_BATCH_UNLOCK (batch);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1200,6 +1379,35 @@ gst_batch_class_init (GstBatchClass *klass)
           1, 16, DEFAULT_PROP_MOVING_WINDOW_SIZE,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
+  g_object_class_install_property (object, PROP_POLICY,
+      g_param_spec_enum ("policy", "Policy",
+          "Policy deciding when buffers from the streams are released as a batch",
+          GST_TYPE_BATCH_POLICY, DEFAULT_PROP_POLICY,
+          G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+  g_object_class_install_property (object, PROP_MAX_LATENCY,
+      g_param_spec_uint64 ("max-latency", "Maximum latency",
+          "Maximum time in nanoseconds a ready stream waits for the other "
+          "streams with 'latency' and 'first-n' policies (0 = frame duration)",
+          0, G_MAXUINT64, DEFAULT_PROP_MAX_LATENCY,
+          G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
+  g_object_class_install_property (object, PROP_MIN_BATCH_SIZE,
+      g_param_spec_uint ("min-batch-size", "Minimum batch size",
+          "Number of ready streams which release a batch with 'first-n' "
+          "policy (0 = all active streams)",
+          0, G_MAXUINT, DEFAULT_PROP_MIN_BATCH_SIZE,
+          G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
+  g_object_class_install_property (object, PROP_FILL_RATIO,
+      g_param_spec_double ("fill-ratio", "Fill ratio",
+          "Moving average of the ratio between streams in a batch and active "
+          "streams", 0.0, 1.0, 0.0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (object, PROP_LATENCY,
+      g_param_spec_uint64 ("latency", "Latency",
+          "Moving average of the time in nanoseconds buffers waited for a batch",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
   gst_element_class_add_static_pad_template_with_gtype (element,
       &gst_batch_sink_template, GST_TYPE_BATCH_SINK_PAD);
@@ -1236,7 +1444,13 @@ gst_batch_init (GstBatch * batch)
   batch->worktask = NULL;
 
   batch->depth = 1;
+  batch->fill_ratio = 0.0;
+  batch->latency = 0;
+
   batch->moving_window_size = DEFAULT_PROP_MOVING_WINDOW_SIZE;
+  batch->policy = DEFAULT_PROP_POLICY;
+  batch->max_latency = DEFAULT_PROP_MAX_LATENCY;
+  batch->min_batch_size = DEFAULT_PROP_MIN_BATCH_SIZE;
 
   g_rec_mutex_init (&batch->worklock);
   g_cond_init (&batch->wakeup);
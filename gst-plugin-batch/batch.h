@@ -28,6 +28,12 @@ G_BEGIN_DECLS
 typedef struct _GstBatch GstBatch;
 typedef struct _GstBatchClass GstBatchClass;
 
+typedef enum {
+  GST_BATCH_POLICY_ALL,
+  GST_BATCH_POLICY_LATENCY,
+  GST_BATCH_POLICY_FIRST_N,
+} GstBatchPolicy;
+
 struct _GstBatch
 {
   /// Inherited parent structure.
@@ -61,9 +67,20 @@ struct _GstBatch
   /// Depth indicating how many buffers should be accumulated from each stream.
   guint          depth;
 
+  /// Exponential moving average of the ratio between used and active streams.
+  gdouble        fill_ratio;
+  /// Exponential moving average of the time buffers waited for a batch.
+  GstClockTime   latency;
+
   /// Properties
   /// Indicating how many new buffers will be used for each output frame.
   guint          moving_window_size;
+  /// Policy deciding when an output batch is released.
+  GstBatchPolicy policy;
+  /// Maximum time buffers wait for the other streams, 0 for frame duration.
+  GstClockTime   max_latency;
+  /// Number of ready streams which release a batch in first-n policy.
+  guint          min_batch_size;
 };
 
 struct _GstBatchClass {
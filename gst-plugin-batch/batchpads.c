@@ -11,6 +11,14 @@ GST_DEBUG_CATEGORY_EXTERN (gst_batch_debug);
 G_DEFINE_TYPE(GstBatchSinkPad, gst_batch_sink_pad, GST_TYPE_PAD);
 G_DEFINE_TYPE(GstBatchSrcPad, gst_batch_src_pad, GST_TYPE_PAD);
 
+#define DEFAULT_PROP_PRIORITY FALSE
+
+enum
+{
+  PROP_0,
+  PROP_PRIORITY,
+};
+
 #define GST_BINARY_8BIT_FORMAT "%c%c%c%c%c%c%c%c"
 #define GST_BINARY_8BIT_STRING(x) \
   (x & 0x80 ? '1' : '0'), (x & 0x40 ? '1' : '0'), (x & 0x20 ? '1' : '0'), \
@@ -37,12 +45,45 @@ queue_empty_cb (GstDataQueue * queue, gpointer checkdata)
   GST_BATCH_PAD_SIGNAL_IDLE (srcpad, TRUE);
 }
 
+static void
+gst_batch_sink_pad_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstBatchSinkPad *sinkpad = GST_BATCH_SINK_PAD (object);
+
+  switch (prop_id) {
+    case PROP_PRIORITY:
+      sinkpad->priority = g_value_get_boolean (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_batch_sink_pad_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstBatchSinkPad *sinkpad = GST_BATCH_SINK_PAD (object);
+
+  switch (prop_id) {
+    case PROP_PRIORITY:
+      g_value_set_boolean (value, sinkpad->priority);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
 static void
 gst_batch_sink_pad_finalize (GObject * object)
 {
   GstBatchSinkPad *pad = GST_BATCH_SINK_PAD (object);
 
   g_queue_free_full (pad->buffers, (GDestroyNotify) gst_buffer_unref);
+  g_array_free (pad->arrivals, TRUE);
 
   G_OBJECT_CLASS (gst_batch_sink_pad_parent_class)->finalize(object);
 }
@@ -52,7 +93,16 @@ gst_batch_sink_pad_class_init (GstBatchSinkPadClass * klass)
 {
   GObjectClass *gobject = (GObjectClass *) klass;
 
+  gobject->set_property = GST_DEBUG_FUNCPTR (gst_batch_sink_pad_set_property);
+  gobject->get_property = GST_DEBUG_FUNCPTR (gst_batch_sink_pad_get_property);
   gobject->finalize = GST_DEBUG_FUNCPTR (gst_batch_sink_pad_finalize);
+
+  g_object_class_install_property (gobject, PROP_PRIORITY,
+      g_param_spec_boolean ("priority", "Priority",
+          "With 'first-n' policy a batch is not released before the deadline "
+          "unless this pad has accumulated enough buffers",
+          DEFAULT_PROP_PRIORITY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
 }
 
 void
@@ -62,6 +112,35 @@ gst_batch_sink_pad_init (GstBatchSinkPad * pad)
 
   pad->is_idle = TRUE;
   pad->buffers = g_queue_new ();
+  pad->arrivals = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+  pad->priority = DEFAULT_PROP_PRIORITY;
+}
+
+void
+gst_batch_sink_pad_push_buffer (GstBatchSinkPad * pad, GstBuffer * buffer)
+{
+  gint64 arrival = g_get_monotonic_time ();
+
+  g_queue_push_tail (pad->buffers, buffer);
+  g_array_append_val (pad->arrivals, arrival);
+}
+
+GstBuffer *
+gst_batch_sink_pad_pop_buffer (GstBatchSinkPad * pad)
+{
+  if (g_queue_is_empty (pad->buffers))
+    return NULL;
+
+  g_array_remove_index (pad->arrivals, 0);
+  return g_queue_pop_head (pad->buffers);
+}
+
+void
+gst_batch_sink_pad_flush (GstBatchSinkPad * pad)
+{
+  g_queue_clear_full (pad->buffers, (GDestroyNotify) gst_buffer_unref);
+  g_array_set_size (pad->arrivals, 0);
 }
 
 static void
@@ -37,6 +37,9 @@ G_BEGIN_DECLS
   (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_BATCH_SRC_PAD))
 #define GST_BATCH_SRC_PAD_CAST(obj) ((GstBatchSrcPad *)(obj))
 
+#define GST_BATCH_SINK_PAD_ARRIVAL(pad, idx) \
+  g_array_index ((pad)->arrivals, gint64, idx)
+
 #define GST_BATCH_SRC_GET_LOCK(obj) (&GST_BATCH_SRC_PAD(obj)->lock)
 #define GST_BATCH_SRC_LOCK(obj)     g_mutex_lock(GST_BATCH_SRC_GET_LOCK(obj))
 #define GST_BATCH_SRC_UNLOCK(obj)   g_mutex_unlock(GST_BATCH_SRC_GET_LOCK(obj))
@@ -87,6 +90,12 @@ struct _GstBatchSinkPad {
 
   /// Queue for managing incoming buffers.
   GQueue       *buffers;
+  /// Monotonic arrival time (in microseconds) of each buffer in the queue.
+  GArray       *arrivals;
+
+  /// Properties
+  /// Whether batches are held (until the deadline) for buffers of this pad.
+  gboolean     priority;
 };
 
 struct _GstBatchSinkPadClass {
@@ -123,6 +132,10 @@ struct _GstBatchSrcPadClass {
 GType gst_batch_sink_pad_get_type (void);
 GType gst_batch_src_pad_get_type (void);
 
+void      gst_batch_sink_pad_push_buffer (GstBatchSinkPad * pad,
+                                          GstBuffer * buffer);
+GstBuffer * gst_batch_sink_pad_pop_buffer (GstBatchSinkPad * pad);
+void      gst_batch_sink_pad_flush (GstBatchSinkPad * pad);
 
 gboolean gst_batch_src_pad_event (GstPad * pad, GstObject * parent,
                                   GstEvent * event);
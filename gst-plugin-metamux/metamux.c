@@ -18,6 +18,7 @@
 #include <gst/utils/common-utils.h>
 #include <gst/utils/batch-utils.h>
 #include <gst/cv/gstcvmeta.h>
+#include <gst/ml/ml-meta-records.h>
 #include <gst/video/gstvideoclassificationmeta.h>
 #include <gst/video/gstvideolandmarksmeta.h>
 
@@ -43,10 +44,11 @@ G_DEFINE_TYPE (GstMetaMux, gst_metamux, GST_TYPE_ELEMENT);
 
 
 #define GST_TYPE_METAMUX_MODE       (gst_metamux_mode_get_type())
-
-#define TIMESTAMP_DELTA_THRESHOLD   1000000
+#define GST_TYPE_METAMUX_POLICY     (gst_metamux_policy_get_type())
 
 #define DEFAULT_PROP_MODE           GST_METAMUX_MODE_ASYNC
+#define DEFAULT_PROP_POLICY         GST_METAMUX_POLICY_NEAREST
+#define DEFAULT_PROP_TOLERANCE      1000000
 #define DEFAULT_PROP_LATENCY        0
 #define DEFAULT_PROP_QUEUE_SIZE     10
 
@@ -56,12 +58,15 @@ G_DEFINE_TYPE (GstMetaMux, gst_metamux, GST_TYPE_ELEMENT);
 
 #define GST_METAMUX_DATA_CAPS     \
     "text/x-raw, format = utf8; " \
+    GST_ML_META_RECORDS_CAPS "; " \
     "cv/x-optical-flow"
 
 enum
 {
   PROP_0,
   PROP_MODE,
+  PROP_POLICY,
+  PROP_TOLERANCE,
   PROP_LATENCY,
   PROP_QUEUE_SIZE,
 };
@@ -109,25 +114,6 @@ gst_caps_is_media_type (const GstCaps * caps, const gchar * mediatype)
       TRUE : FALSE;
 }
 
-static GstMetaItem *
-gst_metadata_item_new ()
-{
-  GstMetaItem *item = g_slice_new (GstMetaItem);
-  g_return_val_if_fail (item != NULL, NULL);
-
-  item->values = NULL;
-  item->timestamp = GST_CLOCK_TIME_NONE;
-
-  return item;
-}
-
-static void
-gst_metadata_item_free (GstMetaItem * item)
-{
-  g_list_free_full (item->values, (GDestroyNotify) gst_structure_free);
-  g_slice_free (GstMetaItem, item);
-}
-
 static GType
 gst_metamux_mode_get_type (void)
 {
@@ -155,64 +141,149 @@ gst_metamux_mode_get_type (void)
   return gtype;
 }
 
+static GType
+gst_metamux_policy_get_type (void)
+{
+  static GType gtype = 0;
+  static const GEnumValue variants[] = {
+    { GST_METAMUX_POLICY_NEAREST,
+        "Attach the metadata entry with timestamp nearest to that of the "
+        "media buffer and within the tolerance window. In 'sync' mode the "
+        "media buffer waits until such entry arrives on all pads.",
+        "nearest"
+    },
+    { GST_METAMUX_POLICY_LATEST_BEFORE,
+        "Attach the latest metadata entry with timestamp not newer than that "
+        "of the media buffer plus the tolerance window. Media buffers never "
+        "wait for entries, suitable for metadata streams with lower rate.",
+        "latest-before"
+    },
+    {0, NULL, NULL},
+  };
+
+  if (!gtype)
+    gtype = g_enum_register_static ("GstMetaMuxPolicy", variants);
+
+  return gtype;
+}
+
+static gboolean
+gst_metamux_match_meta_item (GstMetaMux * muxer, GstMetaMuxDataPad * dpad,
+    GstClockTime timestamp, guint * index)
+{
+  GstMetaRing *ring = &(dpad->ring);
+  GstMetaItem *item = NULL;
+  GstClockTime low = 0, high = 0;
+  GstClockTimeDiff delta = 0, mindelta = G_MAXINT64;
+  guint idx = 0;
+
+  // Boundaries of the tolerance window, entries without timestamp excluded.
+  low = (timestamp > muxer->tolerance) ? (timestamp - muxer->tolerance) : 0;
+  high = ((GST_CLOCK_TIME_NONE - timestamp) > muxer->tolerance) ?
+      (timestamp + muxer->tolerance) : (GST_CLOCK_TIME_NONE - 1);
+
+  if (muxer->policy == GST_METAMUX_POLICY_LATEST_BEFORE) {
+    idx = gst_meta_ring_upper_bound (ring, high);
+
+    // All entries are newer, keep them for the subsequent media buffers.
+    if (idx == 0)
+      return FALSE;
+
+    // Drop all entries older than the latest one before the timestamp.
+    gst_meta_ring_drop (ring, idx - 1);
+
+    *index = 0;
+    return TRUE;
+  }
+
+  // Entries older than the tolerance window won't match any further buffers.
+  gst_meta_ring_drop (ring, gst_meta_ring_lower_bound (ring, low));
+
+  // Find the nearest entry inside the tolerance window.
+  for (idx = 0; idx < GST_META_RING_LENGTH (ring); idx++) {
+    item = GST_META_RING_PEEK (ring, idx);
+
+    if (item->timestamp > high)
+      break;
+
+    delta = ABS (GST_CLOCK_DIFF (item->timestamp, timestamp));
+
+    // Entries are sorted, the delta will only grow from now on.
+    if (delta >= mindelta)
+      break;
+
+    mindelta = delta;
+    *index = idx;
+  }
+
+  return (mindelta != G_MAXINT64) ? TRUE : FALSE;
+}
+
 static gboolean
 gst_metamux_is_meta_available (GstMetaMux * muxer, GstClockTime timestamp)
 {
   GList *list = NULL;
-  GstMetaItem *item = NULL;
   gboolean available = TRUE, skip = FALSE;
+  guint index = 0;
 
   // Iterate ovr the data pads and check if data available on all of them.
   for (list = muxer->metapads; list != NULL; list = g_list_next (list)) {
     GstMetaMuxDataPad *dpad = GST_METAMUX_DATA_PAD (list->data);
-    GstClockTimeDiff delta = GST_CLOCK_TIME_NONE;
 
     GST_OBJECT_LOCK (dpad);
     skip = GST_PAD_IS_EOS (dpad) || GST_PAD_IS_FLUSHING (dpad);
 
     // Pads which are in EOS or FLUSHING state are not included in the checks.
-    if (skip && g_queue_is_empty (dpad->queue)) {
+    if (skip && GST_META_RING_IS_EMPTY (&(dpad)->ring)) {
       GST_OBJECT_UNLOCK (dpad);
       continue;
     }
 
     GST_OBJECT_UNLOCK (dpad);
 
-    // If there is no data available to at least one pad return immediately.
-    if (!(available &= !g_queue_is_empty (dpad->queue)))
-      break;
-
     // If timestamp is not valid, no timestamp matching will be performed.
-    if (!GST_CLOCK_TIME_IS_VALID (timestamp))
+    if (!GST_CLOCK_TIME_IS_VALID (timestamp)) {
+      // If there is no data available to at least one pad return immediately.
+      if (!(available &= !GST_META_RING_IS_EMPTY (&(dpad)->ring)))
+        break;
+
       continue;
+    }
 
-    while ((item = g_queue_peek_head (dpad->queue)) != NULL) {
-      // If the item doesn't contain a valid timestamp we cannot do matching.
-      if (!GST_CLOCK_TIME_IS_VALID (item->timestamp)) {
-        gst_metadata_item_free (g_queue_pop_head (dpad->queue));
-        continue;
-      }
+    // Drop the stale entries, buffers do not wait for pads with this policy.
+    if (muxer->policy == GST_METAMUX_POLICY_LATEST_BEFORE) {
+      gst_metamux_match_meta_item (muxer, dpad, timestamp, &index);
+      continue;
+    }
 
-      delta = GST_CLOCK_DIFF (item->timestamp, timestamp);
+    // No matching entry yet on this pad, return immediately.
+    if (!gst_metamux_match_meta_item (muxer, dpad, timestamp, &index))
+      return FALSE;
+  }
 
-      // Timestamp delta is below the threshold, break and continue with next pad.
-      if (ABS (delta) <= TIMESTAMP_DELTA_THRESHOLD)
-        break;
+  return available;
+}
 
-      // Entry timestamp doesn't match but it's newer, keep it and return immediately.
-      if (delta < 0)
-        return FALSE;
+static void
+gst_metamux_push_meta_item (GstMetaMux * muxer, GstMetaMuxDataPad * dpad,
+    GstMetaItem * item)
+{
+  GST_METAMUX_LOCK (muxer);
 
-      // Drop this item as its timestamp is too old.
-      gst_metadata_item_free (g_queue_pop_head (dpad->queue));
-    }
+  // Entries without timestamp can never be matched in sync mode, drop them.
+  if ((muxer->mode == GST_METAMUX_MODE_SYNC) &&
+      !GST_CLOCK_TIME_IS_VALID (item->timestamp)) {
+    GST_METAMUX_UNLOCK (muxer);
 
-    // If there is no data left to this pad return immediately.
-    if (!(available &= !g_queue_is_empty (dpad->queue)))
-      break;
+    GST_DEBUG_OBJECT (dpad, "Dropping entry without timestamp");
+    gst_metadata_item_free (item);
+    return;
   }
 
-  return available;
+  gst_meta_ring_push (&(dpad)->ring, item);
+  g_cond_signal (&(muxer)->wakeup);
+
+  GST_METAMUX_UNLOCK (muxer);
 }
 
 static void
@@ -225,10 +296,10 @@ gst_metamux_flush_metadata_queues (GstMetaMux * muxer)
   for (list = muxer->metapads; list != NULL; list = g_list_next (list)) {
     GstMetaMuxDataPad *dpad = GST_METAMUX_DATA_PAD (list->data);
 
-    while (!g_queue_is_empty (dpad->queue))
-      gst_metadata_item_free (g_queue_pop_head (dpad->queue));
+    gst_meta_ring_clear (&(dpad)->ring);
 
-    g_clear_pointer (&(dpad)->strcache, g_free);
+    g_string_truncate (dpad->strbuf, 0);
+    dpad->strpos = 0;
     g_clear_pointer (&(dpad)->prtlmeta, gst_metadata_item_free);
     g_clear_pointer (&(dpad)->lastmeta, gst_metadata_item_free);
   }
@@ -389,6 +460,102 @@ gst_metamux_process_detection_metadata (GstMetaMux * muxer, GstBuffer * buffer,
   }
 }
 
+static void
+gst_metamux_process_detection_records (GstMetaMux * muxer, GstBuffer * buffer,
+    const GstMLMetaBlock * block)
+{
+  GstVideoRegionOfInterestMeta *roimeta = NULL, *parent_roimeta = NULL;
+  const GstMLDetectionRecord *records = NULL;
+  const GstMLLandmarkRecord *landmarks = NULL;
+  GstStructure *entry = NULL;
+  gfloat x = 0, y = 0, width = 0, height = 0;
+  guint idx = 0, num = 0;
+
+  if (block->n_entries == 0)
+    return;
+
+  if (!gst_buffer_is_writable (buffer)) {
+    GST_WARNING_OBJECT (muxer, "Unable to attach metadata to buffer %p, "
+        "not writable!", buffer);
+    return;
+  }
+
+  // If result is derived from a ROI, use it the recalculate dimensions.
+  if (block->flags & GST_ML_META_BLOCK_FLAG_PARENT_ID) {
+    parent_roimeta = gst_buffer_get_video_region_of_interest_meta_id (buffer,
+        block->parent_id);
+  }
+
+  records = GST_ML_META_BLOCK_DETECTIONS (block);
+  landmarks = GST_ML_META_BLOCK_LANDMARKS (block);
+
+  for (idx = 0; idx < block->n_entries; idx++) {
+    const GstMLDetectionRecord *record = &records[idx];
+
+    // Translate relative coordinates to absolute.
+    if (parent_roimeta != NULL) {
+      x = (record->x * parent_roimeta->w) + parent_roimeta->x;
+      y = (record->y * parent_roimeta->h) + parent_roimeta->y;
+      width = record->width * parent_roimeta->w;
+      height = record->height * parent_roimeta->h;
+    } else { // (parent_roimeta == NULL)
+      x = record->x * GST_VIDEO_INFO_WIDTH (muxer->vinfo);
+      y = record->y * GST_VIDEO_INFO_HEIGHT (muxer->vinfo);
+      width = record->width * GST_VIDEO_INFO_WIDTH (muxer->vinfo);
+      height = record->height * GST_VIDEO_INFO_HEIGHT (muxer->vinfo);
+    }
+
+    entry = gst_structure_new ("ObjectDetection",
+        "confidence", G_TYPE_DOUBLE, (gdouble) record->confidence,
+        "color", G_TYPE_UINT, record->color, NULL);
+
+    if (record->n_landmarks != 0) {
+      GArray *lndmrks = NULL;
+      GstVideoKeypoint *kp = NULL;
+
+      lndmrks = g_array_sized_new (FALSE, FALSE, sizeof (GstVideoKeypoint),
+          record->n_landmarks);
+      g_array_set_size (lndmrks, record->n_landmarks);
+
+      for (num = 0; num < lndmrks->len; num++) {
+        const GstMLLandmarkRecord *landmark =
+            &landmarks[record->landmarks + num];
+
+        kp = &(g_array_index (lndmrks, GstVideoKeypoint, num));
+
+        kp->confidence = 100.0;
+        kp->color = record->color;
+        kp->name = g_quark_from_string (landmark->name);
+
+        // Translate relative coordinates to absolute.
+        kp->x = (landmark->x * width) + x;
+        kp->y = (landmark->y * height) + y;
+      }
+
+      gst_structure_set (entry, "landmarks", G_TYPE_ARRAY, lndmrks, NULL);
+      g_array_unref (lndmrks);
+    }
+
+    // Clip width and height if it outside the frame limits.
+    width = ((x + width) > GST_VIDEO_INFO_WIDTH (muxer->vinfo)) ?
+        (GST_VIDEO_INFO_WIDTH (muxer->vinfo) - x) : width;
+    height = ((y + height) > GST_VIDEO_INFO_HEIGHT (muxer->vinfo)) ?
+        (GST_VIDEO_INFO_HEIGHT (muxer->vinfo) - y) : height;
+
+    roimeta = gst_buffer_add_video_region_of_interest_meta_id (buffer,
+        g_quark_from_string (record->label), x, y, width, height);
+    roimeta->id = record->id;
+
+    // Set the parent ID of the newly added ROI meta.
+    roimeta->parent_id = (parent_roimeta != NULL) ? parent_roimeta->id : (-1);
+
+    gst_video_region_of_interest_meta_add_param (roimeta, entry);
+
+    GST_TRACE_OBJECT (muxer, "Attached 'ObjectDetection' meta with ID[0x%X] "
+        "parent ID[0x%X] to buffer %p", roimeta->id, roimeta->parent_id, buffer);
+  }
+}
+
 static void
 gst_metamux_process_landmarks_metadata (GstMetaMux * muxer, GstBuffer * buffer,
     GstStructure * structure)
@@ -591,18 +758,19 @@ gst_metamux_process_meta_entries (GstMetaMux * muxer, GstBuffer * buffer,
 
   for (list = muxer->metapads; list != NULL; list = g_list_next (list)) {
     GstMetaMuxDataPad *dpad = GST_METAMUX_DATA_PAD (list->data);
-    GstMetaItem *item = g_queue_peek_head (dpad->queue);
-
-    if ((item != NULL) && GST_CLOCK_TIME_IS_VALID (timestamp)) {
-      GstClockTimeDiff delta = GST_CLOCK_DIFF (item->timestamp, timestamp);
-
-      // Timestamp delta is above the threshold, use last meta entry.
-      if (ABS (delta) > TIMESTAMP_DELTA_THRESHOLD)
-        item = NULL;
+    GstMetaItem *item = NULL;
+    guint index = 0;
+
+    if (!GST_CLOCK_TIME_IS_VALID (timestamp)) {
+      item = gst_meta_ring_pop (&(dpad)->ring);
+    } else if (gst_metamux_match_meta_item (muxer, dpad, timestamp, &index)) {
+      // Entries preceding the matched one will not be used anymore.
+      gst_meta_ring_drop (&(dpad)->ring, index);
+      item = gst_meta_ring_pop (&(dpad)->ring);
     }
 
-    // Use the last meta entry if there are no items in the queue.
-    item = (item != NULL) ? g_queue_pop_head (dpad->queue) : dpad->lastmeta;
+    // Use the last meta entry if there is no matching item in the ring.
+    item = (item != NULL) ? item : dpad->lastmeta;
 
     // There is no entry in the queue nor recorded last meta, skip this pad.
     if (item == NULL)
@@ -624,6 +792,11 @@ gst_metamux_process_meta_entries (GstMetaMux * muxer, GstBuffer * buffer,
         gst_metamux_process_classification_metadata (muxer, buffer, structure);
     }
 
+    for (vlist = item->blocks; vlist != NULL; vlist = vlist->next) {
+      const GstMLMetaBlock *block = g_bytes_get_data (vlist->data, NULL);
+      gst_metamux_process_detection_records (muxer, buffer, block);
+    }
+
     // Overwrite previous last meta entry with the new currently processed one.
     if (item != dpad->lastmeta) {
       g_clear_pointer (&(dpad->lastmeta), gst_metadata_item_free);
@@ -800,112 +973,172 @@ gst_metamux_stop_worker_task (GstMetaMux * muxer)
   return TRUE;
 }
 
+static gboolean
+gst_metamux_parse_string_token (GstMetaMux * muxer, GstMetaMuxDataPad * dpad,
+    GValue * vlist, const gchar * token)
+{
+  GstMetaItem *item = NULL;
+  GstClockTime timestamp = GST_CLOCK_TIME_NONE;
+  guint idx = 0, size = 0, seqnum = 0, n_entries = 0;
+
+  if (!gst_value_deserialize (vlist, token)) {
+    g_value_reset (vlist);
+    return FALSE;
+  }
+
+  // Use the partial meta from previous iteration, otherwise allocate a new.
+  item = (dpad->prtlmeta != NULL) ?
+      g_steal_pointer (&(dpad->prtlmeta)) : gst_metadata_item_new ();
+
+  size = gst_value_list_get_size (vlist);
+
+  for (idx = 0; idx < size; idx++) {
+    const GValue *value = gst_value_list_get_value (vlist, idx);
+    // Owned copy of the entry, the list still frees its own one on reset.
+    GstStructure *entry = GST_STRUCTURE (g_value_dup_boxed (value));
+
+    // Extract the sequential index and the total number of entries.
+    gst_structure_get_uint (entry, "sequence-index", &seqnum);
+    gst_structure_get_uint (entry, "sequence-num-entries", &n_entries);
+    // Extract the timestamp for this metadata object.
+    gst_structure_get_uint64 (entry, "timestamp", &timestamp);
+
+    // Remove the timestamp and sequence fields, not needed anymore.
+    gst_structure_remove_fields (entry, "timestamp", "sequence-index",
+        "sequence-num-entries", NULL);
+
+    // Take the timestamp from the parsed GValue entry if not already set.
+    if (!GST_CLOCK_TIME_IS_VALID (item->timestamp))
+      item->timestamp = timestamp;
+
+    item->values = g_list_append (item->values, entry);
+
+    // Not yet the last entries in the sequence for the this timestamp.
+    if (seqnum != n_entries)
+      continue;
+
+    gst_metamux_push_meta_item (muxer, dpad, item);
+
+    // Allocate new item if there are still parsed entries for processing.
+    item = ((idx + 1) < size) ? gst_metadata_item_new () : NULL;
+  }
+
+  // If meta item is incomplete it will be filled on subsequent calls.
+  dpad->prtlmeta = item;
+
+  // Reset the GValue list for next deserialize.
+  g_value_reset (vlist);
+
+  return TRUE;
+}
+
 static gboolean
 gst_metamux_parse_string_metadata (GstMetaMux * muxer,
     GstMetaMuxDataPad * dpad, GstBuffer * buffer)
 {
   GstMapInfo memmap = {};
   GValue vlist = G_VALUE_INIT;
-  gchar *data = NULL, *token = NULL, *ctx = NULL;
-  guint idx = 0, size = 0, offset = 0;
+  GString *strbuf = dpad->strbuf;
+  gchar *token = NULL;
+  gsize idx = 0, start = 0, end = 0;
 
   if (!gst_buffer_map (buffer, &memmap, GST_MAP_READ)) {
     GST_ERROR_OBJECT (dpad, "Failed to map buffer %p!", buffer);
     return FALSE;
   }
 
-  // Calculate the size the local '\0' terminated string data.
-  size = memmap.size + 1;
-  size += (dpad->strcache != NULL) ? strlen (dpad->strcache) : 0;
-
-  // Allocate local '\0' terminated string and transfer stashed and buffer data.
-  data = g_new0 (gchar, size);
-
-  // Transfer stashed partial string from previous operations.
-  if (dpad->strcache != NULL) {
-    offset = g_strlcpy (data, dpad->strcache, size);
-    g_clear_pointer (&(dpad->strcache), g_free);
-  }
-
-  // Transfer the data in from the buffer and unmap it.
-  memcpy ((gpointer) (data + offset), memmap.data, memmap.size);
+  // Append the data after the incomplete string left from previous buffers.
+  g_string_append_len (strbuf, (const gchar *) memmap.data, memmap.size);
   gst_buffer_unmap (buffer, &memmap);
 
   // Initialize the GValue list in which the deserialized string will be stored.
   g_value_init (&vlist, GST_TYPE_LIST);
 
-  // Split the data into separate serialized string token for parsing.
-  token = strtok_r (data, "\n", &ctx);
-
-  // Iterate over the serialized strings and turn them into GST_TYPE_LIST.
-  while (token != NULL) {
-    GstMetaItem *item = NULL;
-    GstClockTime timestamp = GST_CLOCK_TIME_NONE;
-    guint seqnum = 0, n_entries = 0;
-
-    // If deserialize fails it could be a partial string (e.g. reading from a file).
-    // In that case, stash and combine it with the data in subsequent call.
-    if (!gst_value_deserialize (&vlist, token)) {
-      GST_TRACE_OBJECT (dpad, "Failed to deserialize data, probably incomplete "
-          "string token. Caching it for usage in subsequent calls.");
-      dpad->strcache = g_strdup (token);
-      break;
-    }
+  // Resume the scan for delimiters from where the previous one has stopped.
+  for (idx = dpad->strpos; idx < strbuf->len; idx++) {
+    // Serialized strings are either new line or '\0' terminated.
+    if ((strbuf->str[idx] != '\n') && (strbuf->str[idx] != '\0'))
+      continue;
 
-    // Use the partial meta from previous iteration, otherwise allocate a new.
-    item = (dpad->prtlmeta != NULL) ?
-        g_steal_pointer (&(dpad->prtlmeta)) : gst_metadata_item_new ();
+    // Terminate the string token in place and move to the next one.
+    strbuf->str[idx] = '\0';
+    token = strbuf->str + start;
+    start = idx + 1;
 
-    size = gst_value_list_get_size (&vlist);
+    if ((token[0] != '\0') &&
+        !gst_metamux_parse_string_token (muxer, dpad, &vlist, token))
+      GST_WARNING_OBJECT (dpad, "Failed to deserialize '%s'!", token);
+  }
 
-    for (idx = 0; idx < size; idx++) {
-      const GValue *value = gst_value_list_get_value (&vlist, idx);
-      GstStructure *entry = GST_STRUCTURE (g_value_get_boxed (value));
+  end = strbuf->len;
 
-      // Extract the sequential index and the total number of entries.
-      gst_structure_get_uint (entry, "sequence-index", &seqnum);
-      gst_structure_get_uint (entry, "sequence-num-entries", &n_entries);
-      // Extract the timestamp for this metadata object.
-      gst_structure_get_uint64 (entry, "timestamp", &timestamp);
+  // Find the last non whitespace character of the unterminated string token.
+  while ((end > start) && g_ascii_isspace (strbuf->str[end - 1]))
+    end--;
 
-      // Remove the timestamp and sequence fields, not needed anymore.
-      gst_structure_remove_fields (entry, "timestamp", "sequence-index",
-          "sequence-num-entries", NULL);
+  // Unterminated string token which looks complete, e.g. the data is not
+  // coming from a file. Otherwise it will be completed in subsequent calls.
+  if ((end > start) && (strbuf->str[end - 1] == '}') &&
+      gst_metamux_parse_string_token (muxer, dpad, &vlist, strbuf->str + start))
+    start = strbuf->len;
 
-      // Take the timestamp from the parsed GValue entry if not already set.
-      if (!GST_CLOCK_TIME_IS_VALID (item->timestamp))
-        item->timestamp = timestamp;
+  g_value_unset (&vlist);
 
-      item->values = g_list_append (item->values, gst_structure_copy (entry));
+  // Discard the parsed data, only the incomplete string token remains.
+  g_string_erase (strbuf, 0, start);
+  dpad->strpos = strbuf->len;
 
-      // Not yet the last entries in the sequence for the this timestamp.
-      if (seqnum != n_entries)
-        continue;
+  return TRUE;
+}
 
-      GST_METAMUX_LOCK (muxer);
+static gboolean
+gst_metamux_parse_records_metadata (GstMetaMux * muxer,
+    GstMetaMuxDataPad * dpad, GstBuffer * buffer)
+{
+  GstMetaItem *item = NULL;
+  const GstMLMetaBlock *block = NULL;
+  GstMapInfo memmap = {};
+  gsize offset = 0;
 
-      g_queue_push_tail (dpad->queue, item);
-      g_cond_signal (&(muxer)->wakeup);
+  if (!gst_buffer_map (buffer, &memmap, GST_MAP_READ)) {
+    GST_ERROR_OBJECT (dpad, "Failed to map buffer %p!", buffer);
+    return FALSE;
+  }
 
-      GST_METAMUX_UNLOCK (muxer);
+  while (offset < memmap.size) {
+    block = gst_ml_meta_block_validate (memmap.data + offset,
+        memmap.size - offset);
 
-      // Allocate new item if there are still parsed entries for processing.
-      item = ((idx + 1) < size) ? gst_metadata_item_new () : NULL;
+    if (block == NULL) {
+      GST_WARNING_OBJECT (dpad, "Invalid metadata block at offset %"
+          G_GSIZE_FORMAT " in buffer %p!", offset, buffer);
+      break;
     }
 
-    // If meta item is incomplete it will be filled on subsequent calls.
-    dpad->prtlmeta = item;
+    offset += block->size;
 
-    // Grab the next token for subsequent loop.
-    token = strtok_r (NULL, "\n", &ctx);
+    // Use the partial meta from previous iteration, otherwise allocate a new.
+    item = (dpad->prtlmeta != NULL) ?
+        g_steal_pointer (&(dpad->prtlmeta)) : gst_metadata_item_new ();
 
-    // Reset the GValue list for next deserialize.
-    g_value_reset (&vlist);
-  }
+    // Take the timestamp from the block if not already set.
+    if (!GST_CLOCK_TIME_IS_VALID (item->timestamp))
+      item->timestamp = block->timestamp;
 
-  g_value_unset (&vlist);
-  g_free (data);
+    // Records are fixed size and are used as they are, only copy the block.
+    item->blocks = g_list_append (item->blocks,
+        g_bytes_new (block, block->size));
 
+    // Not yet the last entries in the sequence for the this timestamp.
+    if (block->sequence_index != block->sequence_num_entries) {
+      dpad->prtlmeta = item;
+      continue;
+    }
+
+    gst_metamux_push_meta_item (muxer, dpad, item);
+  }
+
+  gst_buffer_unmap (buffer, &memmap);
   return TRUE;
 }
 
@@ -1126,12 +1359,7 @@ gst_metamux_parse_optical_flow_metadata (GstMetaMux * muxer,
     if (GST_BUFFER_TIMESTAMP_IS_VALID (buffer))
       item->timestamp = GST_BUFFER_TIMESTAMP (buffer);
 
-    GST_METAMUX_LOCK (muxer);
-
-    g_queue_push_tail (dpad->queue, item);
-    g_cond_signal (&(muxer)->wakeup);
-
-    GST_METAMUX_UNLOCK (muxer);
+    gst_metamux_push_meta_item (muxer, dpad, item);
   }
 
   return TRUE;
@@ -1462,6 +1690,8 @@ gst_metamux_data_sink_pad_event (GstPad * pad, GstObject * parent,
 
       if (gst_caps_is_media_type (caps, "text/x-raw"))
         GST_METAMUX_DATA_PAD (pad)->type = GST_DATA_TYPE_TEXT;
+      else if (gst_caps_is_media_type (caps, GST_ML_META_RECORDS_MEDIA_TYPE))
+        GST_METAMUX_DATA_PAD (pad)->type = GST_DATA_TYPE_RECORDS;
       else if (gst_caps_is_media_type (caps, "cv/x-optical-flow"))
         GST_METAMUX_DATA_PAD (pad)->type = GST_DATA_TYPE_OPTICAL_FLOW;
       else
@@ -1525,12 +1755,7 @@ gst_metamux_data_sink_pad_chain (GstPad * pad, GstObject * parent,
     // Create an empty item with the buffer TS for synchronization purpose.
     item->timestamp = GST_BUFFER_TIMESTAMP (buffer);
 
-    GST_METAMUX_LOCK (muxer);
-
-    g_queue_push_tail (dpad->queue, item);
-    g_cond_signal (&(muxer)->wakeup);
-
-    GST_METAMUX_UNLOCK (muxer);
+    gst_metamux_push_meta_item (muxer, dpad, item);
 
     // Buffer is marked as GAP, nothing to process. Just consume it.
     gst_buffer_unref (buffer);
@@ -1543,6 +1768,8 @@ gst_metamux_data_sink_pad_chain (GstPad * pad, GstObject * parent,
 
   if (dpad->type == GST_DATA_TYPE_TEXT)
     success = gst_metamux_parse_string_metadata (muxer, dpad, buffer);
+  else if (dpad->type == GST_DATA_TYPE_RECORDS)
+    success = gst_metamux_parse_records_metadata (muxer, dpad, buffer);
   else if (dpad->type == GST_DATA_TYPE_OPTICAL_FLOW)
     success = gst_metamux_parse_optical_flow_metadata (muxer, dpad, buffer);
 
@@ -1667,6 +1894,12 @@ gst_metamux_set_property (GObject * object, guint prop_id,
     case PROP_MODE:
       muxer->mode = g_value_get_enum (value);
       break;
+    case PROP_POLICY:
+      muxer->policy = g_value_get_enum (value);
+      break;
+    case PROP_TOLERANCE:
+      muxer->tolerance = g_value_get_uint64 (value);
+      break;
     case PROP_LATENCY:
       muxer->latency = g_value_get_uint64 (value);
       break;
@@ -1691,6 +1924,12 @@ gst_metamux_get_property (GObject * object, guint prop_id,
     case PROP_MODE:
       g_value_set_enum (value, muxer->mode);
       break;
+    case PROP_POLICY:
+      g_value_set_enum (value, muxer->policy);
+      break;
+    case PROP_TOLERANCE:
+      g_value_set_uint64 (value, muxer->tolerance);
+      break;
     case PROP_LATENCY:
       g_value_set_uint64 (value, muxer->latency);
       break;
@@ -1744,6 +1983,19 @@ gst_metamux_class_init (GstMetaMuxClass *klass)
           GST_TYPE_METAMUX_MODE, DEFAULT_PROP_MODE,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
+  g_object_class_install_property (object, PROP_POLICY,
+      g_param_spec_enum ("policy", "Policy",
+          "Policy for matching metadata entries with the media buffers in "
+          "'sync' mode", GST_TYPE_METAMUX_POLICY, DEFAULT_PROP_POLICY,
+          G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+  g_object_class_install_property (object, PROP_TOLERANCE,
+      g_param_spec_uint64 ("tolerance", "Tolerance",
+          "Maximum difference between the timestamps of a media buffer and "
+          "a metadata entry for them to be considered matching in 'sync' mode "
+          "(in nanoseconds).", 0, G_MAXUINT64, DEFAULT_PROP_TOLERANCE,
+          G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
   g_object_class_install_property (object, PROP_LATENCY,
       g_param_spec_uint64 ("latency", "Latency",
           "Additional latency to allow more time for upstream to produce "
@@ -1794,6 +2046,8 @@ gst_metamux_init (GstMetaMux * muxer)
   muxer->basetime = GST_CLOCK_TIME_NONE;
 
   muxer->mode = DEFAULT_PROP_MODE;
+  muxer->policy = DEFAULT_PROP_POLICY;
+  muxer->tolerance = DEFAULT_PROP_TOLERANCE;
   muxer->latency = DEFAULT_PROP_LATENCY;
   muxer->queue_size = DEFAULT_PROP_QUEUE_SIZE;
 
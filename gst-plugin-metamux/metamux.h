@@ -41,6 +41,11 @@ typedef enum {
   GST_METAMUX_MODE_SYNC,
 } GstMetaMuxMode;
 
+typedef enum {
+  GST_METAMUX_POLICY_NEAREST,
+  GST_METAMUX_POLICY_LATEST_BEFORE,
+} GstMetaMuxPolicy;
+
 struct _GstMetaMux
 {
   /// Inherited parent structure.
@@ -78,6 +83,8 @@ struct _GstMetaMux
 
   /// Properties.
   GstMetaMuxMode    mode;
+  GstMetaMuxPolicy  policy;
+  GstClockTime      tolerance;
   GstClockTime      latency;
   guint             queue_size;
 };
@@ -12,6 +12,139 @@ G_DEFINE_TYPE(GstMetaMuxDataPad, gst_metamux_data_pad, GST_TYPE_PAD);
 G_DEFINE_TYPE(GstMetaMuxSinkPad, gst_metamux_sink_pad, GST_TYPE_PAD);
 G_DEFINE_TYPE(GstMetaMuxSrcPad, gst_metamux_src_pad, GST_TYPE_PAD);
 
+GstMetaItem *
+gst_metadata_item_new (void)
+{
+  GstMetaItem *item = g_slice_new (GstMetaItem);
+  g_return_val_if_fail (item != NULL, NULL);
+
+  item->values = NULL;
+  item->blocks = NULL;
+  item->timestamp = GST_CLOCK_TIME_NONE;
+
+  return item;
+}
+
+void
+gst_metadata_item_free (GstMetaItem * item)
+{
+  g_list_free_full (item->values, (GDestroyNotify) gst_structure_free);
+  g_list_free_full (item->blocks, (GDestroyNotify) g_bytes_unref);
+  g_slice_free (GstMetaItem, item);
+}
+
+void
+gst_meta_ring_init (GstMetaRing * ring, guint size)
+{
+  // Size must be power of 2 in order to wrap the positions with a mask.
+  ring->size = 1U << g_bit_storage (MAX (size, 2) - 1);
+  ring->items = g_new0 (GstMetaItem *, ring->size);
+  ring->head = 0;
+  ring->length = 0;
+}
+
+void
+gst_meta_ring_clear (GstMetaRing * ring)
+{
+  gst_meta_ring_drop (ring, ring->length);
+}
+
+void
+gst_meta_ring_push (GstMetaRing * ring, GstMetaItem * item)
+{
+  guint idx = 0, num = 0;
+
+  // Ring is full, double its size and move the items at the array beginning.
+  if (ring->length == ring->size) {
+    GstMetaItem **items = g_new0 (GstMetaItem *, ring->size * 2);
+
+    for (num = 0; num < ring->length; num++)
+      items[num] = GST_META_RING_PEEK (ring, num);
+
+    g_free (ring->items);
+
+    ring->items = items;
+    ring->size *= 2;
+    ring->head = 0;
+  }
+
+  idx = ring->length;
+
+  // Most of the time items arrive in order and are appended at the tail.
+  if ((idx > 0) &&
+      (item->timestamp < GST_META_RING_PEEK (ring, idx - 1)->timestamp))
+    idx = gst_meta_ring_upper_bound (ring, item->timestamp);
+
+  // Shift the newer items one position towards the tail.
+  for (num = ring->length; num > idx; num--)
+    GST_META_RING_PEEK (ring, num) = GST_META_RING_PEEK (ring, num - 1);
+
+  GST_META_RING_PEEK (ring, idx) = item;
+  ring->length++;
+}
+
+GstMetaItem *
+gst_meta_ring_pop (GstMetaRing * ring)
+{
+  GstMetaItem *item = NULL;
+
+  if (ring->length == 0)
+    return NULL;
+
+  item = GST_META_RING_PEEK (ring, 0);
+  GST_META_RING_PEEK (ring, 0) = NULL;
+
+  ring->head = (ring->head + 1) & (ring->size - 1);
+  ring->length--;
+
+  return item;
+}
+
+void
+gst_meta_ring_drop (GstMetaRing * ring, guint n_items)
+{
+  n_items = MIN (n_items, ring->length);
+
+  while (n_items-- > 0)
+    gst_metadata_item_free (gst_meta_ring_pop (ring));
+}
+
+guint
+gst_meta_ring_lower_bound (GstMetaRing * ring, GstClockTime timestamp)
+{
+  guint low = 0, high = ring->length, mid = 0;
+
+  // Find the position of the first item with timestamp not less than given.
+  while (low < high) {
+    mid = low + ((high - low) / 2);
+
+    if (GST_META_RING_PEEK (ring, mid)->timestamp < timestamp)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return low;
+}
+
+guint
+gst_meta_ring_upper_bound (GstMetaRing * ring, GstClockTime timestamp)
+{
+  guint low = 0, high = ring->length, mid = 0;
+
+  // Find the position of the first item with timestamp greater than given.
+  while (low < high) {
+    mid = low + ((high - low) / 2);
+
+    if (GST_META_RING_PEEK (ring, mid)->timestamp <= timestamp)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return low;
+}
+
 static gboolean
 queue_is_full_cb (GstDataQueue * queue, guint visible, guint bytes,
     guint64 time, gpointer checkdata)
@@ -205,7 +338,10 @@ gst_metamux_data_pad_finalize (GObject * object)
 {
   GstMetaMuxDataPad *pad = GST_METAMUX_DATA_PAD (object);
 
-  g_queue_free (pad->queue);
+  gst_meta_ring_clear (&pad->ring);
+  g_free (pad->ring.items);
+
+  g_string_free (pad->strbuf, TRUE);
 
   G_OBJECT_CLASS (gst_metamux_data_pad_parent_class)->finalize(object);
 }
@@ -225,9 +361,10 @@ gst_metamux_data_pad_init (GstMetaMuxDataPad * pad)
   gst_segment_init (&pad->segment, GST_FORMAT_UNDEFINED);
 
   pad->prtlmeta = NULL;
-  pad->strcache = NULL;
+  pad->strbuf = g_string_sized_new (GST_METAMUX_STRBUF_DEFAULT_SIZE);
+  pad->strpos = 0;
   pad->lastmeta = NULL;
-  pad->queue = g_queue_new ();
+  gst_meta_ring_init (&pad->ring, GST_META_RING_DEFAULT_SIZE);
 }
 
 static void
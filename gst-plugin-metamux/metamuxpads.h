@@ -85,7 +85,17 @@ G_BEGIN_DECLS
   g_mutex_unlock (&(pad->lock));                                       \
 }
 
+#define GST_META_RING_DEFAULT_SIZE   16
+
+#define GST_METAMUX_STRBUF_DEFAULT_SIZE 4096
+
+#define GST_META_RING_LENGTH(ring)   ((ring)->length)
+#define GST_META_RING_IS_EMPTY(ring) ((ring)->length == 0)
+#define GST_META_RING_PEEK(ring, idx) \
+    ((ring)->items[((ring)->head + (idx)) & ((ring)->size - 1)])
+
 typedef struct _GstMetaItem GstMetaItem;
+typedef struct _GstMetaRing GstMetaRing;
 
 typedef struct _GstMetaMuxDataPad GstMetaMuxDataPad;
 typedef struct _GstMetaMuxDataPadClass GstMetaMuxDataPadClass;
@@ -100,15 +110,36 @@ typedef enum {
   GST_DATA_TYPE_UNKNOWN,
   GST_DATA_TYPE_TEXT,
   GST_DATA_TYPE_OPTICAL_FLOW,
+  GST_DATA_TYPE_RECORDS,
 } GstDataType;
 
 struct _GstMetaItem {
   /// Parsed metadata in list format containing GstStructure.
   GList        *values;
+  /// Binary metadata in list format containing GBytes with #GstMLMetaBlock.
+  GList        *blocks;
   /// The timestamp corresponding to the metadata entry.
   GstClockTime timestamp;
 };
 
+/**
+ * GstMetaRing:
+ * @items: Circular array with the metadata items.
+ * @size: Capacity of the array, always a power of 2.
+ * @head: Position of the oldest item in the array.
+ * @length: Number of items currently in the array.
+ *
+ * Ring buffer holding the metadata items of a data pad sorted by ascending
+ * timestamp, allowing binary search lookups and dropping of stale items at
+ * once. Items without timestamp are sorted at the end of the ring.
+ */
+struct _GstMetaRing {
+  GstMetaItem **items;
+  guint       size;
+  guint       head;
+  guint       length;
+};
+
 struct _GstMetaMuxDataPad {
   /// Inherited parent structure.
   GstPad       parent;
@@ -120,15 +151,17 @@ struct _GstMetaMuxDataPad {
 
   /// Variable for temporarily storing partial meta entry.
   GstMetaItem  *prtlmeta;
-  /// Variable for temporarily storing incomplete string data(meta).
-  gchar        *strcache;
+  /// Reusable buffer holding the incomplete string data(meta).
+  GString      *strbuf;
+  /// Position in the buffer up to which the data was scanned for delimiters.
+  gsize        strpos;
 
   /// Variable for storing the last received full meta entry. This will be
   /// attached when in sync mode, a timeout happens and there is no new entry.
   GstMetaItem  *lastmeta;
 
-  /// Queue for managing parsed #GstMetaItem data.
-  GQueue       *queue;
+  /// Ring buffer for managing parsed #GstMetaItem data sorted by timestamp.
+  GstMetaRing  ring;
 };
 
 struct _GstMetaMuxDataPadClass {
@@ -187,6 +220,23 @@ struct _GstMetaMuxSrcPadClass {
   GstPadClass parent;
 };
 
+GstMetaItem * gst_metadata_item_new (void);
+
+void gst_metadata_item_free (GstMetaItem * item);
+
+void gst_meta_ring_init (GstMetaRing * ring, guint size);
+
+void gst_meta_ring_clear (GstMetaRing * ring);
+
+void gst_meta_ring_push (GstMetaRing * ring, GstMetaItem * item);
+
+GstMetaItem * gst_meta_ring_pop (GstMetaRing * ring);
+
+void gst_meta_ring_drop (GstMetaRing * ring, guint n_items);
+
+guint gst_meta_ring_lower_bound (GstMetaRing * ring, GstClockTime timestamp);
+
+guint gst_meta_ring_upper_bound (GstMetaRing * ring, GstClockTime timestamp);
 
 GType gst_metamux_data_pad_get_type (void);
 
@@ -10,6 +10,7 @@
 #include "mlmetaparser.h"
 
 #include <gst/utils/common-utils.h>
+#include <gst/ml/ml-meta-records.h>
 #include <gst/video/gstvideoclassificationmeta.h>
 #include <gst/video/gstvideolandmarksmeta.h>
 
@@ -25,7 +26,8 @@ G_DEFINE_TYPE (GstMlMetaParser, gst_ml_meta_parser, GST_TYPE_BASE_TRANSFORM);
 
 #define GST_ML_META_PARSER_SINK_CAPS \
     "video/x-raw(ANY); " \
-    "text/x-raw, format = (string) utf8"
+    "text/x-raw, format = (string) utf8; " \
+    GST_ML_META_RECORDS_CAPS
 
 #define GST_ML_META_PARSER_SRC_CAPS \
     "text/x-raw, format = (string) utf8"
@@ -213,6 +215,8 @@ gst_ml_meta_parser_set_caps (GstBaseTransform * base, GstCaps * incaps,
     datatype = GST_DATA_TYPE_TEXT;
   } else if (gst_structure_has_name (structure, "video/x-raw")) {
     datatype = GST_DATA_TYPE_VIDEO;
+  } else if (gst_structure_has_name (structure, GST_ML_META_RECORDS_MEDIA_TYPE)) {
+    datatype = GST_DATA_TYPE_RECORDS;
   } else {
     GST_ELEMENT_ERROR (mlmetaparser, RESOURCE, FAILED, (NULL),
         ("Unsupported data type!"));
@@ -9,6 +9,7 @@
 
 #include <json-glib/json-glib.h>
 #include <gst/utils/common-utils.h>
+#include <gst/ml/ml-meta-records.h>
 #include <gst/video/video-utils.h>
 #include <gst/video/gstvideoclassificationmeta.h>
 #include <gst/video/gstvideolandmarksmeta.h>
@@ -779,6 +780,168 @@ cleanup:
   return success;
 }
 
+static void
+gst_parser_module_process_detection_block (GstParserSubModule * submodule,
+    GPtrArray * blocks, gboolean * visited, const GstMLMetaBlock * block)
+{
+  const GstMLDetectionRecord *records = NULL;
+  const GstMLLandmarkRecord *landmarks = NULL;
+  guint idx = 0, num = 0;
+  gdouble lx = 0.0, ly = 0.0;
+  gboolean derived = FALSE;
+
+  records = GST_ML_META_BLOCK_DETECTIONS (block);
+  landmarks = GST_ML_META_BLOCK_LANDMARKS (block);
+
+  for (idx = 0; idx < block->n_entries; idx++) {
+    const GstMLDetectionRecord *record = &records[idx];
+
+    json_builder_begin_object (submodule->builder);
+
+    json_builder_set_member_name (submodule->builder, "label");
+    json_builder_add_string_value (submodule->builder, record->label);
+    json_builder_set_member_name (submodule->builder, "confidence");
+    json_builder_add_double_value (submodule->builder, record->confidence);
+    json_builder_set_member_name (submodule->builder, "color");
+    json_builder_add_int_value (submodule->builder, record->color);
+
+    json_builder_set_member_name (submodule->builder, "rectangle");
+    json_builder_begin_object (submodule->builder);
+
+    json_builder_set_member_name (submodule->builder, "x");
+    json_builder_add_double_value (submodule->builder, record->x);
+    json_builder_set_member_name (submodule->builder, "y");
+    json_builder_add_double_value (submodule->builder, record->y);
+    json_builder_set_member_name (submodule->builder, "width");
+    json_builder_add_double_value (submodule->builder, record->width);
+    json_builder_set_member_name (submodule->builder, "height");
+    json_builder_add_double_value (submodule->builder, record->height);
+
+    json_builder_end_object (submodule->builder);
+
+    if (record->n_landmarks != 0) {
+      json_builder_set_member_name (submodule->builder, "landmarks");
+      json_builder_begin_object (submodule->builder);
+
+      for (num = 0; num < record->n_landmarks; num++) {
+        const GstMLLandmarkRecord *landmark =
+            &landmarks[record->landmarks + num];
+
+        lx = record->x + landmark->x * record->width;
+        ly = record->y + landmark->y * record->height;
+
+        json_builder_set_member_name (submodule->builder, landmark->name);
+        json_builder_begin_object (submodule->builder);
+
+        json_builder_set_member_name (submodule->builder, "x");
+        json_builder_add_double_value (submodule->builder, lx);
+        json_builder_set_member_name (submodule->builder, "y");
+        json_builder_add_double_value (submodule->builder, ly);
+
+        json_builder_end_object (submodule->builder);
+      }
+
+      json_builder_end_object (submodule->builder);
+    }
+
+    derived = FALSE;
+
+    // Parse derived detection blocks and add section if there are any available.
+    for (num = 0; num < blocks->len; num++) {
+      const GstMLMetaBlock *subblock = g_ptr_array_index (blocks, num);
+
+      if (!(subblock->flags & GST_ML_META_BLOCK_FLAG_PARENT_ID) ||
+          (subblock->parent_id != (gint32) record->id))
+        continue;
+
+      // Each block is parsed only once, this breaks parent ID cycles.
+      if (visited[num])
+        continue;
+
+      visited[num] = TRUE;
+
+      if (!derived) {
+        json_builder_set_member_name (submodule->builder, "object_detection");
+        json_builder_begin_array (submodule->builder);
+        derived = TRUE;
+      }
+
+      gst_parser_module_process_detection_block (submodule, blocks, visited,
+          subblock);
+    }
+
+    if (derived)
+      json_builder_end_array (submodule->builder);
+
+    json_builder_end_object (submodule->builder);
+  }
+}
+
+static gboolean
+gst_parser_module_process_records_buffer (GstParserSubModule * submodule,
+    GstBuffer * buffer)
+{
+  const GstMLMetaBlock *block = NULL;
+  GPtrArray *blocks = NULL;
+  gboolean *visited = NULL;
+  GstMapInfo memmap = { 0, };
+  gsize offset = 0;
+  guint idx = 0;
+  gboolean roots = FALSE, success = TRUE;
+
+  if (!gst_buffer_map (buffer, &memmap, GST_MAP_READ)) {
+    GST_ERROR ("Failed to map %" GST_PTR_FORMAT "!", buffer);
+    return FALSE;
+  }
+
+  blocks = g_ptr_array_new ();
+
+  // Records are used in place, the buffer stays mapped until parsing is done.
+  while (offset < memmap.size) {
+    block = gst_ml_meta_block_validate (memmap.data + offset,
+        memmap.size - offset);
+
+    if (block == NULL) {
+      GST_ERROR ("Invalid metadata block at offset %" G_GSIZE_FORMAT "!", offset);
+      success = FALSE;
+      break;
+    }
+
+    g_ptr_array_add (blocks, (gpointer) block);
+    offset += block->size;
+  }
+
+  visited = g_new0 (gboolean, blocks->len + 1);
+
+  // Parse root detection blocks and add array section if there are any available.
+  for (idx = 0; idx < blocks->len; idx++) {
+    block = g_ptr_array_index (blocks, idx);
+
+    if (block->flags & GST_ML_META_BLOCK_FLAG_PARENT_ID)
+      continue;
+
+    visited[idx] = TRUE;
+
+    if (!roots) {
+      json_builder_set_member_name (submodule->builder, "object_detection");
+      json_builder_begin_array (submodule->builder);
+      roots = TRUE;
+    }
+
+    gst_parser_module_process_detection_block (submodule, blocks, visited,
+        block);
+  }
+
+  if (roots)
+    json_builder_end_array (submodule->builder);
+
+  g_free (visited);
+  g_ptr_array_free (blocks, TRUE);
+  gst_buffer_unmap (buffer, &memmap);
+
+  return success;
+}
+
 static gboolean
 gst_parser_module_process_video_buffer (GstParserSubModule * submodule,
     GstBuffer * buffer)
@@ -912,6 +1075,8 @@ gst_parser_module_process (gpointer instance, GstBuffer * inbuffer,
     success = gst_parser_module_process_video_buffer (submodule, inbuffer);
   else if (submodule->datatype == GST_DATA_TYPE_TEXT)
     success = gst_parser_module_process_text_buffer (submodule, inbuffer);
+  else if (submodule->datatype == GST_DATA_TYPE_RECORDS)
+    success = gst_parser_module_process_records_buffer (submodule, inbuffer);
   else
     GST_ERROR ("Unsupported data type!");
 
@@ -24,6 +24,7 @@ typedef enum {
   GST_DATA_TYPE_NONE,
   GST_DATA_TYPE_VIDEO,
   GST_DATA_TYPE_TEXT,
+  GST_DATA_TYPE_RECORDS,
 } GstDataType;
 
 /**
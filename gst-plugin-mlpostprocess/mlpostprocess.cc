@@ -46,6 +46,7 @@
 #include <gst/ml/gstmlpool.h>
 #include <gst/ml/gstmlmeta.h>
 #include <gst/ml/ml-module-utils.h>
+#include <gst/ml/ml-meta-records.h>
 #include <gst/allocators/gstqtiallocator.h>
 #include <gst/video/video-utils.h>
 #include <gst/video/gstimagepool.h>
@@ -103,6 +104,7 @@ G_DEFINE_TYPE (GstMLPostProcess, gst_ml_post_process,
     "format = (string) " GST_ML_POST_PROCESS_VIDEO_FORMATS "; " \
     "text/x-raw, "                                              \
     "format = (string) " GST_ML_POST_PROCESS_TEXT_FORMATS  "; " \
+    GST_ML_META_RECORDS_CAPS "; "                               \
     "neural-network/tensors"
 
 #define GST_ML_POST_PROCESS_SINK_CAPS \
@@ -137,6 +139,7 @@ enum
   OUTPUT_MODE_VIDEO,
   OUTPUT_MODE_TEXT,
   OUTPUT_MODE_TENSOR,
+  OUTPUT_MODE_RECORDS,
 };
 
 static GstStaticCaps gst_ml_post_process_static_sink_caps =
@@ -919,6 +922,150 @@ gst_ml_video_detection_fill_text_output (GstMLPostProcess * postprocess,
   return TRUE;
 }
 
+static gboolean
+gst_ml_video_detection_fill_records_output (GstMLPostProcess * postprocess,
+    std::any& output, GstBuffer * buffer)
+{
+  GstMemory *mem = NULL;
+  GstMapInfo memmap = {};
+  guint8 *data = NULL;
+  guint idx = 0, num = 0, mrk = 0, n_entries = 0, n_landmarks = 0;
+  guint sequence_idx = 0;
+  gsize size = 0;
+
+  auto& predictions = std::any_cast<DetectionPrediction&>(output);
+  predictions.resize(GST_ML_INFO_TENSOR_DIM (postprocess->mlinfo, 0, 0));
+
+  // Calculate the size of all blocks in order to allocate memory only once.
+  for (idx = 0; idx < predictions.size(); idx++) {
+    auto& detections = predictions[idx];
+
+    n_entries = MIN (detections.size(), postprocess->n_results);
+    n_landmarks = 0;
+
+    for (num = 0; num < n_entries; num++) {
+      if (detections[num].landmarks)
+        n_landmarks += detections[num].landmarks.value().size();
+    }
+
+    size += GST_ML_META_BLOCK_SIZE (n_entries, n_landmarks);
+  }
+
+  if ((mem = gst_allocator_alloc (NULL, size, NULL)) == NULL) {
+    GST_ERROR_OBJECT (postprocess, "Failed to allocate records memory!");
+    return FALSE;
+  }
+
+  if (!gst_memory_map (mem, &memmap, GST_MAP_WRITE)) {
+    GST_ERROR_OBJECT (postprocess, "Failed to map records memory!");
+    gst_memory_unref (mem);
+    return FALSE;
+  }
+
+  data = memmap.data;
+
+  for (idx = 0; idx < predictions.size(); idx++) {
+    auto& detections = predictions[idx];
+    GstMLMetaBlock *block = (GstMLMetaBlock *) data;
+    GstMLDetectionRecord *records = NULL;
+    GstMLLandmarkRecord *landmarks = NULL;
+    GstStructure *info = NULL;
+    gint value = 0;
+
+    n_entries = MIN (detections.size(), postprocess->n_results);
+    n_landmarks = 0;
+
+    for (num = 0; num < n_entries; num++) {
+      if (detections[num].landmarks)
+        n_landmarks += detections[num].landmarks.value().size();
+    }
+
+    // Get saved info for the current batch
+    info = GST_STRUCTURE_CAST (g_ptr_array_index (postprocess->info, idx));
+
+    memset (block, 0, sizeof (GstMLMetaBlock));
+
+    block->magic = GST_ML_META_BLOCK_MAGIC;
+    block->version = GST_ML_META_BLOCK_VERSION;
+    block->type = GST_ML_META_BLOCK_DETECTION;
+    block->size = GST_ML_META_BLOCK_SIZE (n_entries, n_landmarks);
+    block->n_entries = n_entries;
+    block->n_landmarks = n_landmarks;
+    block->parent_id = -1;
+
+    gst_structure_get_uint64 (info, "timestamp", &(block->timestamp));
+    gst_structure_get_uint (info, "sequence-index", &(block->sequence_index));
+    gst_structure_get_uint (info, "sequence-num-entries",
+        &(block->sequence_num_entries));
+
+    if (gst_structure_get_int (info, "stream-id", &value)) {
+      block->stream_id = value;
+      block->flags |= GST_ML_META_BLOCK_FLAG_STREAM_ID;
+    }
+
+    if (gst_structure_get_uint64 (info, "stream-timestamp",
+            &(block->stream_timestamp)))
+      block->flags |= GST_ML_META_BLOCK_FLAG_STREAM_TIMESTAMP;
+
+    if (gst_structure_get_int (info, "parent-id", &value)) {
+      block->parent_id = value;
+      block->flags |= GST_ML_META_BLOCK_FLAG_PARENT_ID;
+    }
+
+    sequence_idx = block->sequence_index;
+
+    records = GST_ML_META_BLOCK_DETECTIONS (block);
+    landmarks = GST_ML_META_BLOCK_LANDMARKS (block);
+    n_landmarks = 0;
+
+    for (num = 0; num < n_entries; num++) {
+      ObjectDetection& entry = detections[num];
+      GstMLDetectionRecord *record = &records[num];
+
+      record->id = GST_META_ID (postprocess->stage_id, sequence_idx, num);
+      record->color = entry.color.value();
+      record->confidence = entry.confidence;
+
+      record->x = entry.left;
+      record->y = entry.top;
+      record->width = entry.right - entry.left;
+      record->height = entry.bottom - entry.top;
+
+      // Zero padded in order to not leak uninitialized bytes downstream.
+      strncpy (record->label, entry.name.c_str(), sizeof (record->label) - 1);
+      record->label[sizeof (record->label) - 1] = '\0';
+
+      record->landmarks = n_landmarks;
+      record->n_landmarks = 0;
+
+      if (entry.landmarks)
+        record->n_landmarks = entry.landmarks.value().size();
+
+      for (mrk = 0; mrk < record->n_landmarks; mrk++) {
+        Keypoint& lndmark = entry.landmarks.value()[mrk];
+        GstMLLandmarkRecord *landmark = &landmarks[n_landmarks++];
+
+        landmark->x = lndmark.x;
+        landmark->y = lndmark.y;
+
+        strncpy (landmark->name, lndmark.name.c_str(), sizeof (landmark->name) - 1);
+        landmark->name[sizeof (landmark->name) - 1] = '\0';
+      }
+
+      GST_TRACE_OBJECT (postprocess, "Batch: %u, ID: %X, Label: %s, Confidence: "
+          "%.1f%%, Box [%.2f %.2f %.2f %.2f]", idx, record->id, record->label,
+          record->confidence, record->x, record->y, record->width, record->height);
+    }
+
+    data += block->size;
+  }
+
+  gst_memory_unmap (mem, &memmap);
+  gst_buffer_append_memory (buffer, mem);
+
+  return TRUE;
+}
+
 static gboolean
 gst_ml_video_classification_fill_video_output (GstMLPostProcess * postprocess,
     std::any& output, GstVideoFrame * vframe)
@@ -1984,6 +2131,11 @@ gst_ml_post_process_transform_caps (GstBaseTransform * base,
               GST_IS_SUPER_RESOLUTION_TYPE (postprocess->type)))
         continue;
 
+      // Binary records are supported only for detection outputs.
+      if (gst_structure_has_name (structure, GST_ML_META_RECORDS_MEDIA_TYPE) &&
+          !GST_IS_DETECTION_TYPE (postprocess->type))
+        continue;
+
       // Make a copy that will be modified.
       structure = gst_structure_copy (structure);
 
@@ -1992,7 +2144,8 @@ gst_ml_post_process_transform_caps (GstBaseTransform * base,
           (direction == GST_PAD_SRC) ? "framerate" : "rate");
 
       // Skip if there is no value or if current caps structure is text.
-      if (value != NULL && !gst_structure_has_name (structure, "text/x-raw")) {
+      if (value != NULL && !gst_structure_has_name (structure, "text/x-raw") &&
+          !gst_structure_has_name (structure, GST_ML_META_RECORDS_MEDIA_TYPE)) {
         gst_structure_set_value (structure,
             (direction == GST_PAD_SRC) ? "rate" : "framerate", value);
       }
@@ -2200,6 +2353,8 @@ gst_ml_post_process_set_caps (GstBaseTransform * base, GstCaps * incaps,
     postprocess->vinfo = gst_video_info_copy (&vinfo);
   } else if (gst_structure_has_name (structure, "text/x-raw")) {
     postprocess->mode = OUTPUT_MODE_TEXT;
+  } else if (gst_structure_has_name (structure, GST_ML_META_RECORDS_MEDIA_TYPE)) {
+    postprocess->mode = OUTPUT_MODE_RECORDS;
   } else if (gst_structure_has_name (structure, "neural-network/tensors")) {
     postprocess->mode = OUTPUT_MODE_TENSOR;
 
@@ -2461,6 +2616,9 @@ gst_ml_post_process_transform (GstBaseTransform * base, GstBuffer * inbuffer,
       success = gst_ml_text_generation_fill_text_output (postprocess,
           output, outbuffer);
     }
+  } else if (postprocess->mode == OUTPUT_MODE_RECORDS) {
+    success = gst_ml_video_detection_fill_records_output (postprocess,
+        output, outbuffer);
   }
 
   if (!success) {
@@ -74,7 +74,7 @@ struct _GstMLPostProcess {
   /// Output ML info.
   GstMLInfo            *outmlinfo;
 
-  /// Output mode (video, text or tensor)
+  /// Output mode (video, text, tensor or binary records)
   guint                mode;
 
   /// Buffer pools.
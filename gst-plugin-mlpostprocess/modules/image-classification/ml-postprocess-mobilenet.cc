@@ -45,7 +45,7 @@ static const std::string kModuleCaps = R"(
   "type": "image-classification",
   "tensors": [
     {
-      "format": ["FLOAT32"],
+      "format": ["UINT8", "INT8", "FLOAT32"],
       "dimensions": [
         [1, [2, 6440]]
       ]
@@ -100,16 +100,17 @@ bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
 
   uint32_t n_inferences = tensors[0].dimensions[1];
 
-  const float *data = static_cast<const float*>(tensors[0].data);
+  // Compare in the native domain and dequantize only the reported results.
+  float threshold = TensorQuantize(tensors[0], threshold_);
 
   // Fill the prediction table.
   for (uint32_t idx = 0; idx < n_inferences; ++idx) {
-    confidence = data[idx];
-
     // Discard results with confidence below the set threshold.
-    if (confidence < threshold_)
+    if (TensorRawValue(tensors[0], idx) < threshold)
       continue;
 
+    confidence = TensorValue(tensors[0], idx);
+
     ImageClassification entry;
     entry.confidence = confidence;
     entry.name = labels_parser_.GetLabel(idx);
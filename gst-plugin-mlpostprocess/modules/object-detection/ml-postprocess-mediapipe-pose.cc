@@ -32,7 +32,8 @@ const std::string kModuleCaps = R"(
 
 Module::Module(LogCallback cb)
     : logger_(cb),
-      threshold_(kDefaultThreshold) {
+      threshold_(kDefaultThreshold),
+      nms_(kNMSIntersectionThreshold) {
 
 }
 
@@ -81,53 +82,6 @@ void Module::TransformDimensions(ObjectDetection &box,
   }
 }
 
-float Module::IntersectionScore(const ObjectDetection &l_box,
-                                const ObjectDetection &r_box) {
-
-  float width = std::min(l_box.right, r_box.right);
-  width -= std::max(l_box.left, r_box.left);
-
-  if (width <= 0.0F)
-    return 0.0F;
-
-  float height = std::min(l_box.bottom, r_box.bottom);
-  height -= std::max(l_box.top, r_box.top);
-
-  if (height <= 0.0F)
-    return 0.0F;
-
-  float intersection = width * height;
-
-  float l_area = (l_box.right - l_box.left) * (l_box.bottom - l_box.top);
-  float r_area = (r_box.right - r_box.left) * (r_box.bottom - r_box.top);
-
-  return intersection / (l_area + r_area - intersection);
-}
-
-int32_t Module::NonMaxSuppression(const ObjectDetection &l_box,
-                                  const ObjectDetections &boxes) {
-
-  for (uint32_t idx = 0; idx < boxes.size();  idx++) {
-    ObjectDetection r_box = boxes[idx];
-
-    if (l_box.name != r_box.name)
-      continue;
-
-    float score = IntersectionScore (l_box, r_box);
-
-    if (score <= kNMSIntersectionThreshold)
-      continue;
-
-    if (l_box.confidence > r_box.confidence)
-      return idx;
-
-    if (l_box.confidence <= r_box.confidence)
-      return -2;
-  }
-
-  return -1;
-}
-
 
 bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
                      std::any& output) {
@@ -140,6 +94,9 @@ bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
   ObjectDetections& detections =
       std::any_cast<ObjectDetections&>(output);
 
+  nms_.Clear();
+  candidates_.clear();
+
   Region& region =
       std::any_cast<Region&>(mlparams["input-tensor-region"]);
 
@@ -242,17 +199,15 @@ bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
 
     TransformDimensions(entry, region);
 
-    int32_t nms = NonMaxSuppression(entry, detections);
-
-    if (nms == (-2))
-      continue;
-
-    if (nms >= 0)
-      detections.erase(detections.begin() + nms);
-
-    detections.push_back(entry);
+    nms_.Add(entry.left, entry.top, entry.right, entry.bottom,
+        entry.confidence, 0);
+    candidates_.emplace_back(std::move(entry));
   }
 
+  // Non-Max Suppression(NMS) of all candidates at once.
+  for (uint32_t idx : nms_.Run())
+    detections.emplace_back(std::move(candidates_[idx]));
+
   return true;
 }
 
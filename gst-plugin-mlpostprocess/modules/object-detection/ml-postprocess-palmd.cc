@@ -33,7 +33,8 @@ static const std::string kModuleCaps = R"(
 
 Module::Module(LogCallback cb)
     : logger_(cb),
-      threshold_(kDefaultThreshold) {
+      threshold_(kDefaultThreshold),
+      nms_(kNmsIntersectionThreshold) {
 
 }
 
@@ -52,71 +53,6 @@ void Module::TransformDimensions(ObjectDetection &box,
   box.right = (box.right - region.x) / region.width;
 }
 
-float Module::IntersectionScore(const ObjectDetection &l_box,
-                                const ObjectDetection &r_box) {
-
-  // Figure out the width of the intersecting rectangle.
-  // 1st: Find out the X axis coordinate of left most Top-Right point.
-  float width = fmin(l_box.right, r_box.right);
-  // 2nd: Find out the X axis coordinate of right most Top-Left point
-  // and substract from the previously found value.
-  width -= fmax(l_box.left, r_box.left);
-
-  // Negative width means that there is no overlapping.
-  if (width <= 0.0F)
-    return 0.0F;
-
-  // Figure out the height of the intersecting rectangle.
-  // 1st: Find out the Y axis coordinate of bottom most Left-Top point.
-  float height = fmin (l_box.bottom, r_box.bottom);
-  // 2nd: Find out the Y axis coordinate of top most Left-Bottom point
-  // and substract from the previously found value.
-  height -= fmax (l_box.top, r_box.top);
-
-  // Negative height means that there is no overlapping.
-  if (height <= 0.0F)
-    return 0.0F;
-
-  // Calculate intersection area.
-  float intersection = width * height;
-
-  // Calculate the area of the 2 objects.
-  float l_area = (l_box.right - l_box.left) * (l_box.bottom - l_box.top);
-  float r_area = (r_box.right - r_box.left) * (r_box.bottom - r_box.top);
-
-  // Intersection over Union score.
-  return intersection / (l_area + r_area - intersection);
-}
-
-int32_t Module::NonMaxSuppression(const ObjectDetection &l_box,
-                                  const ObjectDetections &boxes) {
-
-  for (uint32_t idx = 0; idx < boxes.size();  idx++) {
-    ObjectDetection r_box = boxes[idx];
-
-    // If labels do not match, continue with next list entry.
-    if (l_box.name != r_box.name)
-      continue;
-
-    double score = IntersectionScore (l_box, r_box);
-
-    // If the score is below the threshold, continue with next list entry.
-    if (score <= kNmsIntersectionThreshold)
-      continue;
-
-    // If confidence of current box is higher, remove the old entry.
-    if (l_box.confidence > r_box.confidence)
-      return idx;
-
-    // If confidence of current box is lower, don't add it to the list.
-    if (l_box.confidence <= r_box.confidence)
-      return -2;
-  }
-
-  // If this point is reached then add current box to the list;
-  return -1;
-}
-
 bool Module::Configure(const std::string& labels_file,
                        const std::string& json_settings) {
 
@@ -163,6 +99,9 @@ bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
   ObjectDetections& detections =
       std::any_cast<ObjectDetections&>(output);
 
+  nms_.Clear();
+  candidates_.clear();
+
   // Get region
   Region& region =
       std::any_cast<Region&>(mlparams["input-tensor-region"]);
@@ -217,16 +156,6 @@ bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
     entry.name = labels_parser_.GetLabel(0);
     entry.color = labels_parser_.GetColor(0);
 
-    // Non-Max Suppression (NMS) algorithm.
-    int32_t nms = NonMaxSuppression(entry, detections);
-
-    // If the NMS result is -2 don't add the prediction to the list.
-    if (nms == (-2))
-      continue;
-
-    if (nms >= 0)
-      detections.erase(detections.begin() + nms);
-
     for (uint32_t num = 0; num < n_landmarks; num++) {
       const std::map<uint32_t, std::string>& names = landmarks_.at(0);
 
@@ -251,9 +180,15 @@ bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
           num, lmk.name.c_str(), lmk.x, lmk.y);
     }
 
-    detections.push_back(entry);
+    nms_.Add(entry.left, entry.top, entry.right, entry.bottom,
+        entry.confidence, 0);
+    candidates_.emplace_back(std::move(entry));
   }
 
+  // Non-Max Suppression(NMS) of all candidates at once.
+  for (uint32_t idx : nms_.Run())
+    detections.emplace_back(std::move(candidates_[idx]));
+
   return true;
 }
 
@@ -7,6 +7,7 @@
 
 #include "qti-ml-post-process.h"
 #include "qti-labels-parser.h"
+#include "qti-nms.h"
 
 #include <string>
 
@@ -26,10 +27,6 @@ class Module : public IModule {
                std::any& output) override;
  private:
   void TransformDimensions(ObjectDetection &box, const Region& region);
-  float IntersectionScore(const ObjectDetection &l_box,
-                          const ObjectDetection &r_box);
-  int32_t NonMaxSuppression(const ObjectDetection &l_box,
-                            const ObjectDetections &boxes);
 
   // Logging callback.
   LogCallback  logger_;
@@ -41,4 +38,8 @@ class Module : public IModule {
   LabelsParser labels_parser_;
   // Anchors vector.
   std::vector<std::array<float, 2>> anchors_;
+  // Non-Max Suppression(NMS) of the candidate detections.
+  NonMaxSuppressor nms_;
+  // Detections above the confidence threshold, subject to NMS.
+  ObjectDetections candidates_;
 };
@@ -54,7 +54,8 @@ static const std::string kModuleCaps = R"(
 
 Module::Module(LogCallback cb)
     : logger_(cb),
-      threshold_(kDefaultThreshold) {
+      threshold_(kDefaultThreshold),
+      nms_(kNMSIntersectionTreshold) {
 
 }
 
@@ -96,77 +97,11 @@ void Module::TransformDimensions(ObjectDetection &box,
   box.right = (box.right - region.x) / region.width;
 }
 
-float Module::IntersectionScore(const ObjectDetection &l_box,
-                                const ObjectDetection &r_box) {
-
-  // Figure out the width of the intersecting rectangle.
-  // 1st: Find out the X axis coordinate of left most Top-Right point.
-  float width = std::min(l_box.right, r_box.right);
-  // 2nd: Find out he X axis coordinate of right most Top-Left point
-  // and substract from the previously found value.
-  width -= std::max(l_box.left, r_box.left);
-
-  // Negative width means that there is no overlapping.
-  if (width <= 0.0F)
-    return 0.0F;
-
-  // Figure out the height of the intersecting rectangle.
-  // 1st: Find out the Y axis coordinate of bottom most Left-Top point.
-  float height = std::min(l_box.bottom, r_box.bottom);
-  // 2nd: Find out the Y axis coordinate of top most Left-Bottom point
-  // and substract from the previously found value.
-  height -= std::max(l_box.top, r_box.top);
-
-  // Negative height means that there is no overlapping.
-  if (height <= 0.0F)
-    return 0.0F;
-
-  // Calculate intersection area.
-  float intersection = width * height;
-
-  // Calculate the area of the 2 objects.
-  float l_area = (l_box.right - l_box.left) * (l_box.bottom - l_box.top);
-  float r_area = (r_box.right - r_box.left) * (r_box.bottom - r_box.top);
-
-  // Intersection over Union score.
-  return intersection / (l_area + r_area - intersection);
-}
-
-int32_t Module::NonMaxSuppression(const ObjectDetection &l_box,
-                                  const ObjectDetections &boxes) {
-
-  for (uint32_t idx = 0; idx < boxes.size();  idx++) {
-    ObjectDetection r_box = boxes[idx];
-
-    // If labels do not match, continue with next list entry.
-    if (l_box.name != r_box.name)
-      continue;
-
-    double score = IntersectionScore(l_box, r_box);
-
-    // If the score is below the threshold, continue with next list entry.
-    if (score <= kNMSIntersectionTreshold)
-      continue;
-
-    // If confidence of current box is higher, remove the old entry.
-    if (l_box.confidence > r_box.confidence)
-      return idx;
-
-    // If confidence of current box is lower, don't add it to the list.
-    if (l_box.confidence <= r_box.confidence)
-      return -2;
-  }
-
-  // If this point is reached then add current box to the list;
-  return -1;
-}
-
 bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
                      std::any& output) {
 
   uint32_t scores_idx = 0, landmarks_idx = 0, bboxes_idx = 0, class_idx = 0;
   float confidence = 0.0f;
-  int32_t nms = -1;
 
   if (output.type() != typeid(ObjectDetections)) {
     LOG(logger_, kError, "Unexpected predictions type!");
@@ -176,6 +111,9 @@ bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
   ObjectDetections& detections =
       std::any_cast<ObjectDetections&>(output);
 
+  nms_.Clear();
+  candidates_.clear();
+
   // Copy info
   Region& region =
       std::any_cast<Region&>(mlparams["input-tensor-region"]);
@@ -312,21 +250,19 @@ bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
     entry.name = labels_parser_.GetLabel(class_idx);
     entry.color = labels_parser_.GetColor(class_idx);
 
-    nms = NonMaxSuppression(entry, detections);
-
-    if (nms == (-2))
-      continue;
-
     LOG(logger_, kLog, "Label: %s Confidence: %.2f Box[%f, %f, %f, %f]",
         entry.name.c_str(), entry.confidence, entry.top, entry.left,
         entry.bottom, entry.right);
 
-    if (nms >= 0)
-      detections.erase(detections.begin() + nms);
-
-    detections.emplace_back(std::move(entry));
+    nms_.Add(entry.left, entry.top, entry.right, entry.bottom,
+        entry.confidence, class_idx);
+    candidates_.emplace_back(std::move(entry));
   }
-  // sort entries
+
+  // Non-Max Suppression(NMS) of all candidates at once.
+  for (uint32_t idx : nms_.Run())
+    detections.emplace_back(std::move(candidates_[idx]));
+
   return true;
 }
 
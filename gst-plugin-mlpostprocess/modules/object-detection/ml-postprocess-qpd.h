@@ -7,6 +7,7 @@
 
 #include "qti-ml-post-process.h"
 #include "qti-labels-parser.h"
+#include "qti-nms.h"
 
 #include <string>
 
@@ -27,18 +28,16 @@ class Module : public IModule {
  private:
   void TransformDimensions(ObjectDetection &box, const Region& region);
 
-  float IntersectionScore(const ObjectDetection &l_box,
-                          const ObjectDetection &r_box);
-
-  int32_t NonMaxSuppression(const ObjectDetection &l_box,
-                            const ObjectDetections &boxes);
-
   // Logging callback.
-  LogCallback  logger_;
+  LogCallback      logger_;
   // Confidence threshold value.
-  double       threshold_;
+  double           threshold_;
   // Landmarks map.
-  LandmarksMap landmarks_;
+  LandmarksMap     landmarks_;
   // Labels parser.
-  LabelsParser labels_parser_;
+  LabelsParser     labels_parser_;
+  // Non-Max Suppression(NMS) of the candidate detections.
+  NonMaxSuppressor nms_;
+  // Detections above the confidence threshold, subject to NMS.
+  ObjectDetections candidates_;
 };
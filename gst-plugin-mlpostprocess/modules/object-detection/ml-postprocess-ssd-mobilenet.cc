@@ -44,25 +44,25 @@ static const std::string kModuleCaps = R"(
   "type": "object-detection",
   "tensors": [
     {
-      "format": ["FLOAT32"],
+      "format": ["FLOAT32", "UINT8", "INT8"],
       "dimensions": [
         [1, 10, 4], [1, 10], [1, 10], [1]
       ]
     },
     {
-      "format": ["FLOAT32"],
+      "format": ["FLOAT32", "UINT8", "INT8"],
       "dimensions": [
         [1, 10], [1, 10, 4], [1, 10], [1], [1, 10]
       ]
     },
     {
-      "format": ["FLOAT32"],
+      "format": ["FLOAT32", "UINT8", "INT8"],
       "dimensions": [
         [1, 100], [1], [1, 100, 4], [1, 100]
       ]
     },
     {
-      "format": ["FLOAT32"],
+      "format": ["FLOAT32", "UINT8", "INT8"],
       "dimensions": [
         [1, 25, 4], [1, 25], [1, 25], [1]
       ]
@@ -73,7 +73,8 @@ static const std::string kModuleCaps = R"(
 
 Module::Module(LogCallback cb)
     : logger_(cb),
-      threshold_(kDefaultThreshold) {
+      threshold_(kDefaultThreshold),
+      nms_(kNMSIntersectionTreshold) {
 
 }
 
@@ -115,76 +116,11 @@ void Module::TransformDimensions(ObjectDetection &box,
   box.right = (box.right - region.x) / region.width;
 }
 
-float Module::IntersectionScore(const ObjectDetection &l_box,
-                                const ObjectDetection &r_box) {
-
-  // Figure out the width of the intersecting rectangle.
-  // 1st: Find out the X axis coordinate of left most Top-Right point.
-  float width = std::min(l_box.right, r_box.right);
-  // 2nd: Find out the X axis coordinate of right most Top-Left point
-  // and substract from the previously found value.
-  width -= std::max(l_box.left, r_box.left);
-
-  // Negative width means that there is no overlapping.
-  if (width <= 0.0F)
-    return 0.0F;
-
-  // Figure out the height of the intersecting rectangle.
-  // 1st: Find out the Y axis coordinate of bottom most Left-Top point.
-  float height = std::min(l_box.bottom, r_box.bottom);
-  // 2nd: Find out the Y axis coordinate of top most Left-Bottom point
-  // and substract from the previously found value.
-  height -= std::max(l_box.top, r_box.top);
-
-  // Negative height means that there is no overlapping.
-  if (height <= 0.0F)
-    return 0.0F;
-
-  // Calculate intersection area.
-  float intersection = width * height;
-
-  // Calculate the area of the 2 objects.
-  float l_area = (l_box.right - l_box.left) * (l_box.bottom - l_box.top);
-  float r_area = (r_box.right - r_box.left) * (r_box.bottom - r_box.top);
-
-  // Intersection over Union score.
-  return intersection / (l_area + r_area - intersection);
-}
-
-int32_t Module::NonMaxSuppression(const ObjectDetection &l_box,
-                                  const ObjectDetections &boxes) {
-
-  for (uint32_t idx = 0; idx < boxes.size();  idx++) {
-    ObjectDetection r_box = boxes[idx];
-
-    // If labels do not match, continue with next list entry.
-    if (l_box.name != r_box.name)
-      continue;
-
-    double score = IntersectionScore(l_box, r_box);
-
-    // If the score is below the threshold, continue with next list entry.
-    if (score <= kNMSIntersectionTreshold)
-      continue;
-
-    // If confidence of current box is higher, remove the old entry.
-    if (l_box.confidence > r_box.confidence)
-      return idx;
-
-    // If confidence of current box is lower, don't add it to the list.
-    if (l_box.confidence <= r_box.confidence)
-      return -2;
-  }
-
-  // If this point is reached then add current box to the list;
-  return -1;
-}
-
 bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
                      std::any& output) {
 
-  const float *bboxes = nullptr, *classes = nullptr;
-  const float *scores = nullptr, *n_boxes = nullptr;
+  const Tensor *bboxes = nullptr, *classes = nullptr;
+  const Tensor *scores = nullptr, *n_boxes = nullptr;
 
   if (output.type() != typeid(ObjectDetections)) {
     LOG(logger_, kError, "Unexpected predictions type!");
@@ -194,6 +130,9 @@ bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
   ObjectDetections& detections =
       std::any_cast<ObjectDetections&>(output);
 
+  nms_.Clear();
+  candidates_.clear();
+
   // Copy info
   Region& region =
       std::any_cast<Region&>(mlparams["input-tensor-region"]);
@@ -204,38 +143,44 @@ bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
 
   if (tensors.size() == 4) {
     if (tensors[3].dimensions.size() == 1) {
-      bboxes = reinterpret_cast<const float *>(tensors[0].data);
-      classes = reinterpret_cast<const float *>(tensors[1].data);
-      scores = reinterpret_cast<const float *>(tensors[2].data);
-      n_boxes = reinterpret_cast<const float *>(tensors[3].data);
+      bboxes = &(tensors[0]);
+      classes = &(tensors[1]);
+      scores = &(tensors[2]);
+      n_boxes = &(tensors[3]);
     }
 
     if (tensors[3].dimensions.size() == 2) {
-      bboxes = reinterpret_cast<const float *>(tensors[2].data);
-      classes = reinterpret_cast<const float *>(tensors[0].data);
-      scores = reinterpret_cast<const float *>(tensors[3].data);
-      n_boxes = reinterpret_cast<const float *>(tensors[1].data);
+      bboxes = &(tensors[2]);
+      classes = &(tensors[0]);
+      scores = &(tensors[3]);
+      n_boxes = &(tensors[1]);
     }
   } else if (tensors.size() == 5) {
-    bboxes = reinterpret_cast<const float *>(tensors[1].data);
-    classes = reinterpret_cast<const float *>(tensors[4].data);
-    scores = reinterpret_cast<const float *>(tensors[0].data);
-    n_boxes = reinterpret_cast<const float *>(tensors[3].data);
+    bboxes = &(tensors[1]);
+    classes = &(tensors[4]);
+    scores = &(tensors[0]);
+    n_boxes = &(tensors[3]);
   }
 
-  uint32_t n_entries = n_boxes[0];
+  // Elements are dequantized on access if the tensors are in native type.
+  uint32_t n_entries = TensorValue(*n_boxes, 0);
+
+  // Scores are compared with the threshold in the native tensor domain.
+  float threshold = TensorQuantize(*scores, threshold_);
 
   for (uint32_t idx = 0; idx < n_entries; idx++) {
     ObjectDetection entry;
 
     // Discard results with confidence below the set threshold.
-    if (scores[idx] < threshold_)
+    if (TensorRawValue(*scores, idx) < threshold)
       continue;
 
-    entry.top = bboxes[(idx * 4)] * resolution.height;
-    entry.left = bboxes[(idx * 4) + 1] * resolution.width;
-    entry.bottom = bboxes[(idx * 4) + 2] * resolution.height;
-    entry.right = bboxes[(idx * 4) + 3] * resolution.width;
+    float confidence = TensorValue(*scores, idx);
+
+    entry.top = TensorValue(*bboxes, (idx * 4)) * resolution.height;
+    entry.left = TensorValue(*bboxes, (idx * 4) + 1) * resolution.width;
+    entry.bottom = TensorValue(*bboxes, (idx * 4) + 2) * resolution.height;
+    entry.right = TensorValue(*bboxes, (idx * 4) + 3) * resolution.width;
 
     // Adjust bounding box dimensions with extracted source tensor region.
     TransformDimensions(entry, region);
@@ -244,24 +189,25 @@ bool Module::Process(const Tensors& tensors, Dictionary& mlparams,
        (entry.bottom > 1.0) || (entry.right > 1.0))
       continue;
 
-    entry.confidence = scores[idx] * 100;
-    entry.name = labels_parser_.GetLabel(classes[idx]);
-    entry.color = labels_parser_.GetColor(classes[idx]);
+    uint32_t class_idx = TensorValue(*classes, idx);
 
-    // Non-Max Suppression(NMS) algorithm.
-    int32_t nms = NonMaxSuppression(entry, detections);
+    entry.confidence = confidence * 100;
 
-    // If the NMS result is -2 don't add the prediction to the list.
-    if (nms == (-2))
-      continue;
+    nms_.Add(entry.left, entry.top, entry.right, entry.bottom,
+        entry.confidence, class_idx);
+    candidates_.emplace_back(std::move(entry));
+  }
+
+  // Non-Max Suppression(NMS), labels are fetched only for the survivors.
+  for (uint32_t idx : nms_.Run()) {
+    ObjectDetection& entry = candidates_[idx];
 
-    // If the NMS result is above -1 remove the entry with the nms index.
-    if (nms >= 0)
-      detections.erase(detections.begin() + nms);
+    entry.name = labels_parser_.GetLabel(nms_.Class(idx));
+    entry.color = labels_parser_.GetColor(nms_.Class(idx));
 
     detections.emplace_back(std::move(entry));
   }
-  // sort entries
+
   return true;
 }
 
@@ -38,14 +38,14 @@ const std::string kModuleCaps = R"(
       ]
     },
     {
-      "format": ["FLOAT32"],
+      "format": ["FLOAT32", "UINT8", "INT8"],
       "dimensions": [
         [1, [21, 42840], [1, 1001]],
         [1, [21, 42840], 4]
       ]
     },
     {
-      "format": ["FLOAT32"],
+      "format": ["FLOAT32", "UINT8", "INT8"],
       "dimensions": [
         [1, [21, 42840], 4],
         [1, [21, 42840], [1, 1001]]
@@ -57,7 +57,8 @@ const std::string kModuleCaps = R"(
 
 Module::Module(LogCallback cb)
     : logger_(cb),
-      threshold_(kDefaultThreshold) {
+      threshold_(kDefaultThreshold),
+      nms_(kNMSIntersectionTreshold) {
 
 }
 
@@ -74,85 +75,28 @@ void Module::TransformDimensions(ObjectDetection &box,
   box.right = (box.right - region.x) / region.width;
 }
 
-float Module::IntersectionScore(const ObjectDetection &l_box,
-                                const ObjectDetection &r_box) {
-  // Figure out the width of the intersecting rectangle.
-  // 1st: Find out the X axis coordinate of left most Top-Right point.
-  float width = std::min(l_box.right, r_box.right);
-  // 2nd: Find out the X axis coordinate of right most Top-Left point
-  // and substract from the previously found value.
-  width -= std::max(l_box.left, r_box.left);
-
-  // Negative width means that there is no overlapping.
-  if (width <= 0.0F)
-    return 0.0F;
-
-  // Figure out the height of the intersecting rectangle.
-  // 1st: Find out the Y axis coordinate of bottom most Left-Top point.
-  float height = std::min(l_box.bottom, r_box.bottom);
-  // 2nd: Find out the Y axis coordinate of top most Left-Bottom point
-  // and substract from the previously found value.
-  height -= std::max(l_box.top, r_box.top);
-
-  // Negative height means that there is no overlapping.
-  if (height <= 0.0F)
-    return 0.0F;
-
-  // Calculate intersection area.
-  float intersection = width * height;
-
-  // Calculate the area of the 2 objects.
-  float l_area = (l_box.right - l_box.left) * (l_box.bottom - l_box.top);
-  float r_area = (r_box.right - r_box.left) * (r_box.bottom - r_box.top);
-
-  // Intersection over Union score.
-  return intersection / (l_area + r_area - intersection);
-}
-
-int32_t Module::NonMaxSuppression(const ObjectDetection &l_box,
-                                  const ObjectDetections &boxes) {
-
-  for (uint32_t idx = 0; idx < boxes.size();  idx++) {
-    ObjectDetection r_box = boxes[idx];
+void Module::NonMaxSuppression(ObjectDetections& detections) {
 
-    // If labels do not match, continue with next list entry.
-    if (l_box.name != r_box.name)
-      continue;
+  // Labels and colors are fetched only for the detections which survived.
+  for (uint32_t idx : nms_.Run()) {
+    ObjectDetection& entry = candidates_[idx];
 
-    double score = IntersectionScore(l_box, r_box);
+    entry.name = labels_parser_.GetLabel(nms_.Class(idx));
+    entry.color = labels_parser_.GetColor(nms_.Class(idx));
 
-    // If the score is below the threshold, continue with next list entry.
-    if (score <= kNMSIntersectionTreshold)
-      continue;
-
-    // If confidence of current box is higher, remove the old entry.
-    if (l_box.confidence > r_box.confidence)
-      return idx;
+    LOG(logger_, kTrace, "Label: %s Confidence: %.2f Box[%f, %f, %f, %f]",
+        entry.name.c_str(), entry.confidence, entry.top, entry.left,
+        entry.bottom, entry.right);
 
-    // If confidence of current box is lower, don't add it to the list.
-    if (l_box.confidence <= r_box.confidence)
-      return -2;
+    detections.emplace_back(std::move(entry));
   }
-
-  // If this point is reached then add current box to the list;
-  return -1;
-}
-
-int32_t Module::TensorCompareValues(const float *data,
-                                    const uint32_t& l_idx,
-                                    const uint32_t& r_idx) {
-
-  return ((float*)data)[l_idx] > ((float*)data)[r_idx] ? 1 :
-     ((float*)data)[l_idx] < ((float*)data)[r_idx] ? -1 : 0;
-
 }
 
 void Module::ParseDualblockFrame(const Tensors& tensors,
                                  Dictionary& mlparams,
                                  std::any& output){
 
-  const float *bboxes = NULL, *scores = NULL;
-  uint32_t n_classes = 0;
+  const Tensor *bboxes = nullptr, *scores = nullptr;
 
   if (output.type() != typeid(ObjectDetections)) {
     LOG(logger_, kError, "Unexpected output type!");
@@ -162,6 +106,10 @@ void Module::ParseDualblockFrame(const Tensors& tensors,
   ObjectDetections& detections =
       std::any_cast<ObjectDetections&>(output);
 
+  nms_.Clear();
+  candidates_.clear();
+  scores_.clear();
+
   // Get region
   Region& region =
       std::any_cast<Region&>(mlparams["input-tensor-region"]);
@@ -169,34 +117,30 @@ void Module::ParseDualblockFrame(const Tensors& tensors,
   uint32_t n_paxels = tensors[0].dimensions[1];
 
   if (tensors[0].dimensions[2] == 4) {
-    bboxes = reinterpret_cast <const float *>(tensors[0].data);
-    scores = reinterpret_cast <const float *>(tensors[1].data);
-    n_classes = tensors[1].dimensions[2];
+    bboxes = &(tensors[0]);
+    scores = &(tensors[1]);
   } else {
-    bboxes = reinterpret_cast <const float *>(tensors[1].data);
-    scores = reinterpret_cast <const float *>(tensors[0].data);
-    n_classes = tensors[0].dimensions[2];
+    bboxes = &(tensors[1]);
+    scores = &(tensors[0]);
   }
 
-  for (uint32_t idx = 0; idx < n_paxels; idx++) {
-    ObjectDetection entry;
-
-    uint32_t id = idx * n_classes;
-
-    for (uint32_t num = (id + 1); num < (id + n_classes); num++)
-      id = (TensorCompareValues(scores, num, id) > 0) ? num : id;
+  uint32_t n_classes = scores->dimensions[2];
 
-    double confidence = scores[id];
+  DecodeScoreRows(*scores, 0, n_classes, n_paxels, n_classes, threshold_,
+      scores_);
 
-    uint32_t class_idx = id % n_classes;
+  for (const ScoreCandidate& candidate : scores_) {
+    ObjectDetection entry;
 
-    if (confidence < threshold_)
-      continue;
+    uint32_t idx = candidate.anchor;
+    uint32_t class_idx = candidate.label;
+    double confidence = candidate.confidence;
 
-    entry.left = bboxes[idx * 4];
-    entry.top = bboxes[(idx * 4) + 1];
-    entry.right = bboxes[(idx * 4) + 2];
-    entry.bottom = bboxes[(idx * 4) + 3];
+    // Boxes are dequantized only for the anchors which passed the threshold.
+    entry.left = TensorValue(*bboxes, idx * 4);
+    entry.top = TensorValue(*bboxes, (idx * 4) + 1);
+    entry.right = TensorValue(*bboxes, (idx * 4) + 2);
+    entry.bottom = TensorValue(*bboxes, (idx * 4) + 3);
 
     LOG(logger_, kTrace, "Class: %u Confidence: %.2f Box[%.2f, %.2f, %.2f, %.2f]",
         class_idx, confidence, entry.top, entry.left, entry.bottom, entry.right);
@@ -210,19 +154,13 @@ void Module::ParseDualblockFrame(const Tensors& tensors,
       continue;
 
     entry.confidence = confidence * 100.0f;
-    entry.name = labels_parser_.GetLabel(class_idx);
-    entry.color = labels_parser_.GetColor(class_idx);
-
-    int32_t nms = NonMaxSuppression(entry, detections);
 
-    if (nms == (-2))
-      continue;
-
-    if (nms >= 0)
-      detections.erase(detections.begin() + nms);
-
-    detections.emplace_back(std::move(entry));
+    nms_.Add(entry.left, entry.top, entry.right, entry.bottom,
+        entry.confidence, class_idx);
+    candidates_.emplace_back(std::move(entry));
   }
+
+  NonMaxSuppression(detections);
 }
 
 void Module::ParseTripleblockFrame(const Tensors& tensors,
@@ -237,6 +175,9 @@ void Module::ParseTripleblockFrame(const Tensors& tensors,
   ObjectDetections& detections =
       std::any_cast<ObjectDetections&>(output);
 
+  nms_.Clear();
+  candidates_.clear();
+
   // Get region
   Region& region =
       std::any_cast<Region&>(mlparams["input-tensor-region"]);
@@ -277,26 +218,13 @@ void Module::ParseTripleblockFrame(const Tensors& tensors,
         static_cast<float>((region.x + region.width)));
 
     entry.confidence = confidence * 100.0F;
-    entry.name = labels_parser_.GetLabel(class_idx);
-    entry.color = labels_parser_.GetColor(class_idx);
 
-    // Non-Max Suppression(NMS) algorithm.
-    int32_t nms = NonMaxSuppression(entry, detections);
-
-    // If the NMS result is -2 don't add the prediction to the list.
-    if (nms == (-2))
-      continue;
-
-    LOG(logger_, kTrace, "Label: %s Confidence: %.2f Box[%f, %f, %f, %f]",
-        entry.name.c_str(), entry.confidence, entry.top, entry.left,
-        entry.bottom, entry.right);
-
-    // If the NMS result is above -1 remove the entry with the nms index.
-    if (nms >= 0)
-      detections.erase(detections.begin() + nms);
-
-    detections.emplace_back(std::move(entry));
+    nms_.Add(entry.left, entry.top, entry.right, entry.bottom,
+        entry.confidence, class_idx);
+    candidates_.emplace_back(std::move(entry));
   }
+
+  NonMaxSuppression(detections);
 }
 
 std::string Module::Caps() {
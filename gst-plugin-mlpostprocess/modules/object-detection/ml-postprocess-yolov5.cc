@@ -32,7 +32,7 @@ static const std::string kModuleCaps = R"(
   "type": "object-detection",
   "tensors": [
     {
-      "format": ["FLOAT32"],
+      "format": ["FLOAT32", "UINT8", "INT8"],
       "dimensions": [
         [1, [1, 136], [1, 136], [18, 3018]],
         [1, [1, 136], [1, 136], [18, 3018]],
@@ -40,7 +40,7 @@ static const std::string kModuleCaps = R"(
       ]
     },
     {
-      "format": ["FLOAT32"],
+      "format": ["FLOAT32", "UINT8", "INT8"],
       "dimensions": [
         [1, 3, [1, 136], [1, 136], [6, 85]],
         [1, 3, [1, 136], [1, 136], [6, 85]],
@@ -48,7 +48,7 @@ static const std::string kModuleCaps = R"(
       ]
     },
     {
-      "format": ["FLOAT32"],
+      "format": ["FLOAT32", "UINT8", "INT8"],
       "dimensions": [
         [1, [21, 72828], [6, 85]]
       ]
@@ -59,7 +59,8 @@ static const std::string kModuleCaps = R"(
 
 Module::Module(LogCallback cb)
     : logger_(cb),
-      threshold_(kDefaultThreshold) {
+      threshold_(kDefaultThreshold),
+      nms_(kNMSIntersectionTreshold) {
 
 }
 
@@ -76,79 +77,23 @@ void Module::TransformDimensions(ObjectDetection &box,
   box.right = (box.right - region.x) / region.width;
 }
 
-float Module::IntersectionScore(const ObjectDetection &l_box,
-                                const ObjectDetection &r_box) {
+void Module::NonMaxSuppression(ObjectDetections& detections) {
 
-  // Figure out the width of the intersecting rectangle.
-  // 1st: Find out the X axis coordinate of left most Top-Right point.
-  float width = std::min(l_box.right, r_box.right);
-  // 2nd: Find out the X axis coordinate of right most Top-Left point
-  // and substract from the previously found value.
-  width -= std::max(l_box.left, r_box.left);
+  // Labels and colors are fetched only for the detections which survived.
+  for (uint32_t idx : nms_.Run()) {
+    ObjectDetection& entry = candidates_[idx];
 
-  // Negative width means that there is no overlapping.
-  if (width <= 0.0F)
-    return 0.0F;
+    entry.name = labels_parser_.GetLabel(nms_.Class(idx));
+    entry.color = labels_parser_.GetColor(nms_.Class(idx));
 
-  // Figure out the height of the intersecting rectangle.
-  // 1st: Find out the Y axis coordinate of bottom most Left-Top point.
-  float height = std::min(l_box.bottom, r_box.bottom);
-  // 2nd: Find out the Y axis coordinate of top most Left-Bottom point
-  // and substract from the previously found value.
-  height -= std::max(l_box.top, r_box.top);
+    LOG(logger_, kTrace, "Label: %s Confidence: %.2f Box[%f, %f, %f, %f]",
+        entry.name.c_str(), entry.confidence, entry.top, entry.left,
+        entry.bottom, entry.right);
 
-  // Negative height means that there is no overlapping.
-  if (height <= 0.0F)
-    return 0.0F;
-
-  // Calculate intersection area.
-  float intersection = width * height;
-
-  // Calculate the area of the 2 objects.
-  float l_area = (l_box.right - l_box.left) * (l_box.bottom - l_box.top);
-  float r_area = (r_box.right - r_box.left) * (r_box.bottom - r_box.top);
-
-  // Intersection over Union score.
-  return intersection / (l_area + r_area - intersection);
-}
-
-int32_t Module::NonMaxSuppression(const ObjectDetection &l_box,
-                                  const ObjectDetections &boxes) {
-
-  for (uint32_t idx = 0; idx < boxes.size();  idx++) {
-    ObjectDetection r_box = boxes[idx];
-
-    // If labels do not match, continue with next list entry.
-    if (l_box.name != r_box.name)
-      continue;
-
-    float score = IntersectionScore(l_box, r_box);
-
-    // If the score is below the threshold, continue with next list entry.
-    if (score <= kNMSIntersectionTreshold)
-      continue;
-
-    // If confidence of current box is higher, remove the old entry.
-    if (l_box.confidence > r_box.confidence)
-      return idx;
-
-    // If confidence of current box is lower, don't add it to the list.
-    if (l_box.confidence <= r_box.confidence)
-      return -2;
+    detections.emplace_back(std::move(entry));
   }
-
-  // If this point is reached then add current box to the list;
-  return -1;
-}
-
-int32_t Module::TensorCompareValues(const float *data,
-    const uint32_t& l_idx, const uint32_t& r_idx) {
-
-  return ((float*)data)[l_idx] > ((float*)data)[r_idx] ? 1 :
-     ((float*)data)[l_idx] < ((float*)data)[r_idx] ? -1 : 0;
 }
 
-
 void Module::ParseMonoblockFrame(const Tensors& tensors, Dictionary& mlparams,
                                  std::any& output) {
 
@@ -157,11 +102,14 @@ void Module::ParseMonoblockFrame(const Tensors& tensors, Dictionary& mlparams,
     return;
   }
 
-  int nms = -1;
   float bbox[4] = { 0, };
   ObjectDetections& detections =
     std::any_cast<ObjectDetections&>(output);
 
+  nms_.Clear();
+  candidates_.clear();
+  scores_.clear();
+
   // Get video resolution
   Resolution& resolution =
       std::any_cast<Resolution&>(mlparams["input-tensor-dimensions"]);
@@ -170,37 +118,38 @@ void Module::ParseMonoblockFrame(const Tensors& tensors, Dictionary& mlparams,
   Region& region =
       std::any_cast<Region&>(mlparams["input-tensor-region"]);
 
-  const float* data = reinterpret_cast<const float*>(tensors[0].data);
+  const Tensor& tensor = tensors[0];
 
-  uint32_t n_paxels = tensors[0].dimensions[1];
-  uint32_t n_layers = tensors[0].dimensions[2];
+  uint32_t n_paxels = tensor.dimensions[1];
+  uint32_t n_layers = tensor.dimensions[2];
 
-  uint32_t idx = 0;
+  // The object score is at most 1.0, so the product of class and object scores
+  // can only pass the threshold if the class score alone passes it as well.
+  DecodeScoreRows(tensor, kClassesIdx, n_layers, n_paxels,
+      n_layers - kClassesIdx, threshold_, scores_);
 
-  for (uint32_t num = 0; num < n_paxels; num++, idx += n_layers) {
+  for (const ScoreCandidate& candidate : scores_) {
     ObjectDetection entry;
 
-    float score = data[idx + kScoreIdx];
+    uint32_t idx = candidate.anchor * n_layers;
+    uint32_t class_idx = candidate.label;
+
+    float score = TensorValue(tensor, idx + kScoreIdx);
 
     if (score < threshold_)
       continue;
 
-    uint32_t id = idx + kClassesIdx;
-
-    for (uint32_t m = (idx + kClassesIdx + 1);  m < (idx + n_layers); m++)
-      id = (TensorCompareValues(data, m, id) > 0) ? m : id;
-
-    float confidence = data[id];
+    float confidence = candidate.confidence;
 
     confidence *= score;
 
     if (confidence < threshold_)
       continue;
 
-    bbox[0] = data[idx];
-    bbox[1] = data[idx + 1];
-    bbox[2] = data[idx + 2];
-    bbox[3] = data[idx + 3];
+    bbox[0] = TensorValue(tensor, idx);
+    bbox[1] = TensorValue(tensor, idx + 1);
+    bbox[2] = TensorValue(tensor, idx + 2);
+    bbox[3] = TensorValue(tensor, idx + 3);
 
     entry.top = (bbox[1] - (bbox[3] / 2)) * resolution.height;
     entry.left = (bbox[0] - (bbox[2] / 2)) * resolution.width;
@@ -218,19 +167,13 @@ void Module::ParseMonoblockFrame(const Tensors& tensors, Dictionary& mlparams,
         static_cast<float>((region.x + region.width)));
 
     entry.confidence = confidence * 100.0f;
-    entry.name = labels_parser_.GetLabel(id - (idx + kClassesIdx));
-    entry.color = labels_parser_.GetColor(id - (idx + kClassesIdx));
 
-    nms = NonMaxSuppression(entry, detections);
-
-    if (nms == (-2))
-      continue;
-
-    if (nms >= 0)
-      detections.erase(detections.begin() + nms);
-
-    detections.emplace_back(std::move(entry));
+    nms_.Add(entry.left, entry.top, entry.right, entry.bottom,
+        entry.confidence, class_idx);
+    candidates_.emplace_back(std::move(entry));
   }
+
+  NonMaxSuppression(detections);
 }
 
 void Module::ParseTripleblockFrame(const Tensors& tensors,
@@ -240,7 +183,6 @@ void Module::ParseTripleblockFrame(const Tensors& tensors,
   uint32_t w_idx = 0;
   uint width = 0, height = 0, n_layers = 0, n_anchors = 0;
   float bbox[4] = { 0, };
-  int nms = -1;
 
   if (output.type() != typeid(ObjectDetections)) {
     LOG(logger_, kError, "Unexpected predictions type!");
@@ -250,6 +192,9 @@ void Module::ParseTripleblockFrame(const Tensors& tensors,
   ObjectDetections& detections =
       std::any_cast<ObjectDetections&>(output);
 
+  nms_.Clear();
+  candidates_.clear();
+
   // Get video resolution
   Resolution& resolution =
       std::any_cast<Resolution&>(mlparams["input-tensor-dimensions"]);
@@ -259,21 +204,18 @@ void Module::ParseTripleblockFrame(const Tensors& tensors,
       std::any_cast<Region&>(mlparams["input-tensor-region"]);
 
   for (uint32_t idx = 0; idx < tensors.size(); idx++) {
-    const float *data =
-        reinterpret_cast<const float *>(tensors[idx].data);
+    const Tensor& tensor = tensors[idx];
 
-    uint32_t num = 0;
-
-    if (tensors[idx].dimensions.size() == 5) {
-      n_anchors = tensors[idx].dimensions[1];
-      height = tensors[idx].dimensions[2];
-      width = tensors[idx].dimensions[3];
-      n_layers = tensors[idx].dimensions[4];
+    if (tensor.dimensions.size() == 5) {
+      n_anchors = tensor.dimensions[1];
+      height = tensor.dimensions[2];
+      width = tensor.dimensions[3];
+      n_layers = tensor.dimensions[4];
     } else {
       n_anchors = 3;
-      height = tensors[idx].dimensions[1];
-      width = tensors[idx].dimensions[2];
-      n_layers = tensors[idx].dimensions[3] / n_anchors;
+      height = tensor.dimensions[1];
+      width = tensor.dimensions[2];
+      n_layers = tensor.dimensions[3] / n_anchors;
     }
 
     uint32_t n_paxels = width * height;
@@ -283,102 +225,89 @@ void Module::ParseTripleblockFrame(const Tensors& tensors,
     for (w_idx = 0; w_idx < 3; w_idx++)
       if (weights[w_idx] == paxelsize) break;
 
-    for (uint32_t pxl_idx = 0; pxl_idx < n_paxels; pxl_idx++) {
-
-      for (uint32_t anchor = 0; anchor < n_anchors; anchor++, num += n_layers) {
-        ObjectDetection entry;
-
-        float score = data[num + kScoreIdx];
-
-        if (score < threshold_)
-          continue;
-
-        uint32_t id = num + kClassesIdx;
-
-        for (uint32_t m = (num + kClassesIdx + 1); m < (num + n_layers); m++)
-          id = (TensorCompareValues(data, m, id) > 0 ? m : id);
-
-        uint32_t class_idx = id - (num + kClassesIdx);
-
-        float confidence = data[id];
-
-        if (confidence < threshold_)
-          continue;
-
-        // Apply a sigmoid function in order to normalize the confidence.
-        confidence = 1 / (1 + expf(- confidence));
-        // Normalize the end confidence with the object score value.
-        confidence *= 1 / (1 + expf(- score));
-
-        // Aquire the bounding box parameters.
-        bbox[0] = data[num];
-        bbox[1] = data[num + 1];
-        bbox[2] = data[num + 2];
-        bbox[3] = data[num + 3];
-
-        bbox[0] = 1 / (1 + expf(- bbox[0]));
-        bbox[1] = 1 / (1 + expf(- bbox[1]));
-        bbox[2] = 1 / (1 + expf(- bbox[2]));
-        bbox[3] = 1 / (1 + expf(- bbox[3]));
-
-        uint32_t x = pxl_idx % width;
-        uint32_t y = pxl_idx / width;
-
-        // Special calculations for the bounding box parameters.
-        bbox[0] = (bbox[0] * 2 - 0.5F + x) * paxelsize;
-        bbox[1] = (bbox[1] * 2 - 0.5F + y) * paxelsize;
-        bbox[2] = pow((bbox[2] * 2), 2) * anchors[w_idx][anchor][0];
-        bbox[3] = pow((bbox[3] * 2), 2) * anchors[w_idx][anchor][1];
-
-        entry.top = bbox[1] - (bbox[3] / 2);
-        entry.left = bbox[0] - (bbox[2] / 2);
-        entry.bottom = bbox[1] + (bbox[3] / 2);
-        entry.right = bbox[0] + (bbox[2] / 2);
-
-        LOG(logger_, kTrace, "Class: %u Confidence: %.2f Box[%f, %f, %f, %f]",
-            class_idx, confidence, entry.top, entry.left, entry.bottom, entry.right);
-
-        // Keep dimensions within the region.
-        entry.top = std::clamp(entry.top, static_cast<float>(region.y),
-            static_cast<float>((region.y + region.height)));
-        entry.left = std::clamp(entry.left, static_cast<float>(region.x),
-            static_cast<float>((region.x + region.width)));
-        entry.bottom = std::clamp(entry.bottom, static_cast<float>(region.y),
-            static_cast<float>((region.y + region.height)));
-        entry.right = std::clamp(entry.right, static_cast<float>(region.x),
-            static_cast<float>((region.x + region.width)));
-
-        if (entry.left == entry.right || entry.top == entry.bottom) {
-          LOG (logger_, kTrace, "Discard invalid box");
-          continue;
-        }
-
-        uint32_t size = (entry.right - entry.left) * (entry.bottom - entry.top);
-        if (size < kBboxSizeTreshold)
-          continue;
-
-        TransformDimensions(entry, region);
-
-        entry.name = labels_parser_.GetLabel(id - (num + kClassesIdx));
-        entry.color = labels_parser_.GetColor(id - (num + kClassesIdx));
-        entry.confidence = confidence * 100.0f;
-
-        nms = NonMaxSuppression(entry, detections);
+    // Each row holds the layers of a single anchor of a single paxel.
+    scores_.clear();
+    DecodeScoreRows(tensor, kClassesIdx, n_layers, n_paxels * n_anchors,
+        n_layers - kClassesIdx, threshold_, scores_);
+
+    for (const ScoreCandidate& candidate : scores_) {
+      ObjectDetection entry;
+
+      uint32_t num = candidate.anchor * n_layers;
+      uint32_t pxl_idx = candidate.anchor / n_anchors;
+      uint32_t anchor = candidate.anchor % n_anchors;
+      uint32_t class_idx = candidate.label;
+
+      float score = TensorValue(tensor, num + kScoreIdx);
+
+      if (score < threshold_)
+        continue;
+
+      float confidence = candidate.confidence;
+
+      // Apply a sigmoid function in order to normalize the confidence.
+      confidence = 1 / (1 + expf(- confidence));
+      // Normalize the end confidence with the object score value.
+      confidence *= 1 / (1 + expf(- score));
+
+      // Aquire the bounding box parameters.
+      bbox[0] = TensorValue(tensor, num);
+      bbox[1] = TensorValue(tensor, num + 1);
+      bbox[2] = TensorValue(tensor, num + 2);
+      bbox[3] = TensorValue(tensor, num + 3);
+
+      bbox[0] = 1 / (1 + expf(- bbox[0]));
+      bbox[1] = 1 / (1 + expf(- bbox[1]));
+      bbox[2] = 1 / (1 + expf(- bbox[2]));
+      bbox[3] = 1 / (1 + expf(- bbox[3]));
+
+      uint32_t x = pxl_idx % width;
+      uint32_t y = pxl_idx / width;
+
+      // Special calculations for the bounding box parameters.
+      bbox[0] = (bbox[0] * 2 - 0.5F + x) * paxelsize;
+      bbox[1] = (bbox[1] * 2 - 0.5F + y) * paxelsize;
+      bbox[2] = pow((bbox[2] * 2), 2) * anchors[w_idx][anchor][0];
+      bbox[3] = pow((bbox[3] * 2), 2) * anchors[w_idx][anchor][1];
+
+      entry.top = bbox[1] - (bbox[3] / 2);
+      entry.left = bbox[0] - (bbox[2] / 2);
+      entry.bottom = bbox[1] + (bbox[3] / 2);
+      entry.right = bbox[0] + (bbox[2] / 2);
+
+      LOG(logger_, kTrace, "Class: %u Confidence: %.2f Box[%f, %f, %f, %f]",
+          class_idx, confidence, entry.top, entry.left, entry.bottom, entry.right);
+
+      // Keep dimensions within the region.
+      entry.top = std::clamp(entry.top, static_cast<float>(region.y),
+          static_cast<float>((region.y + region.height)));
+      entry.left = std::clamp(entry.left, static_cast<float>(region.x),
+          static_cast<float>((region.x + region.width)));
+      entry.bottom = std::clamp(entry.bottom, static_cast<float>(region.y),
+          static_cast<float>((region.y + region.height)));
+      entry.right = std::clamp(entry.right, static_cast<float>(region.x),
+          static_cast<float>((region.x + region.width)));
+
+      if (entry.left == entry.right || entry.top == entry.bottom) {
+        LOG (logger_, kTrace, "Discard invalid box");
+        continue;
+      }
 
-        if (nms == (-2))
-          continue;
+      uint32_t size = (entry.right - entry.left) * (entry.bottom - entry.top);
+      if (size < kBboxSizeTreshold)
+        continue;
 
-        LOG(logger_, kTrace, "TRIPLEBLOCK Label: %s Confidence: %.2f Box[%f, %f, %f, %f]",
-            entry.name.c_str(), entry.confidence, entry.top,
-            entry.left, entry.bottom, entry.right);
+      TransformDimensions(entry, region);
 
-        if (nms >= 0)
-          detections.erase(detections.begin() + nms);
+      entry.confidence = confidence * 100.0f;
 
-        detections.emplace_back(std::move(entry));
-      }
+      nms_.Add(entry.left, entry.top, entry.right, entry.bottom,
+          entry.confidence, class_idx);
+      candidates_.emplace_back(std::move(entry));
     }
   }
+
+  NonMaxSuppression(detections);
 }
 
 std::string Module::Caps() {
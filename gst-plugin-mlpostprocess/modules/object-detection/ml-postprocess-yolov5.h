@@ -7,6 +7,8 @@
 
 #include "qti-ml-post-process.h"
 #include "qti-labels-parser.h"
+#include "qti-nms.h"
+#include "qti-score-decoder.h"
 
 #include <string>
 
@@ -24,11 +26,6 @@ class Module : public IModule {
                std::any& output) override;
  private:
   void TransformDimensions(ObjectDetection &box, const Region& region);
-  float IntersectionScore(const ObjectDetection &l_box,
-                          const ObjectDetection &r_box);
-
-  int32_t NonMaxSuppression(const ObjectDetection &l_box,
-                            const ObjectDetections &boxes);
 
   void ParseTripleblockFrame(const Tensors& tensors, Dictionary& mlparams,
                              std::any& output);
@@ -36,13 +33,18 @@ class Module : public IModule {
   void ParseMonoblockFrame(const Tensors& tensors, Dictionary& mlparams,
                            std::any& output);
 
-  int32_t TensorCompareValues(const float *data,
-                              const uint32_t& l_idx, const uint32_t& r_idx);
+  void NonMaxSuppression(ObjectDetections& detections);
 
   // Logging callback.
-  LogCallback  logger_;
+  LogCallback      logger_;
   // Confidence threshold value.
-  double       threshold_;
+  double           threshold_;
   // Labels parser.
-  LabelsParser labels_parser_;
+  LabelsParser     labels_parser_;
+  // Non-Max Suppression(NMS) of the candidate detections.
+  NonMaxSuppressor nms_;
+  // Detections above the confidence threshold, subject to NMS.
+  ObjectDetections candidates_;
+  // Anchors with class score above the confidence threshold.
+  ScoreCandidates  scores_;
 };
@@ -28,14 +28,14 @@ static const std::string kModuleCaps = R"(
       ]
     },
     {
-      "format": ["FLOAT32"],
+      "format": ["FLOAT32", "UINT8", "INT8"],
       "dimensions": [
         [1, 4, [21, 42840]],
         [1, [1, 1001], [21, 42840]]
       ]
     },
     {
-      "format": ["FLOAT32"],
+      "format": ["FLOAT32", "UINT8", "INT8"],
       "dimensions": [
         [1, [5, 1005], [21, 42840]]
       ]
@@ -46,7 +46,8 @@ static const std::string kModuleCaps = R"(
 
 Module::Module(LogCallback cb)
     : logger_(cb),
-      threshold_(kDefaultThreshold) {
+      threshold_(kDefaultThreshold),
+      nms_(kNMSIntersectionTreshold) {
 
 }
 
@@ -59,121 +60,38 @@ void Module::TransformDimensions(ObjectDetection &box,
   box.right = (box.right - region.x) / region.width;
 }
 
-float Module::IntersectionScore(const ObjectDetection &l_box,
-                                const ObjectDetection &r_box) {
-
-  // Figure out the width of the intersecting rectangle.
-  // 1st: Find out the X axis coordinate of left most Top-Right point.
-  float width = std::min(l_box.right, r_box.right);
-  // 2nd: Find out the X axis coordinate of right most Top-Left point
-  // and substract from the previously found value.
-  width -= std::max(l_box.left, r_box.left);
-
-  // Negative width means that there is no overlapping.
-  if (width <= 0.0F)
-    return 0.0F;
-
-  // Figure out the height of the intersecting rectangle.
-  // 1st: Find out the Y axis coordinate of bottom most Left-Top point.
-  float height = std::min(l_box.bottom, r_box.bottom);
-  // 2nd: Find out the Y axis coordinate of top most Left-Bottom point
-  // and substract from the previously found value.
-  height -= std::max(l_box.top, r_box.top);
-
-  // Negative height means that there is no overlapping.
-  if (height <= 0.0F)
-    return 0.0F;
-
-  // Calculate intersection area.
-  float intersection = width * height;
-
-  // Calculate the area of the 2 objects.
-  float l_area = (l_box.right - l_box.left) * (l_box.bottom - l_box.top);
-  float r_area = (r_box.right - r_box.left) * (r_box.bottom - r_box.top);
-
-  // Intersection over Union score.
-  return intersection / (l_area + r_area - intersection);
-}
-
-int32_t Module::NonMaxSuppression(const ObjectDetection &l_box,
-                                  const ObjectDetections &boxes) {
-
-  for (uint32_t idx = 0; idx < boxes.size();  idx++) {
-    ObjectDetection r_box = boxes[idx];
+void Module::NonMaxSuppression(ObjectDetections& detections) {
 
-    // If labels do not match, continue with next list entry.
-    if (l_box.name != r_box.name)
-      continue;
-
-    double score = IntersectionScore(l_box, r_box);
+  // Labels and colors are fetched only for the detections which survived.
+  for (uint32_t idx : nms_.Run()) {
+    ObjectDetection& entry = candidates_[idx];
 
-    // If the score is below the threshold, continue with next list entry.
-    if (score <= kNMSIntersectionTreshold)
-      continue;
+    entry.name = labels_parser_.GetLabel(nms_.Class(idx));
+    entry.color = labels_parser_.GetColor(nms_.Class(idx));
 
-    // If confidence of current box is higher, remove the old entry.
-    if (l_box.confidence > r_box.confidence)
-      return idx;
+    LOG(logger_, kTrace, "Label: %s Confidence: %.2f Box[%f, %f, %f, %f]",
+        entry.name.c_str(), entry.confidence, entry.top, entry.left,
+        entry.bottom, entry.right);
 
-    // If confidence of current box is lower, don't add it to the list.
-    if (l_box.confidence <= r_box.confidence)
-      return -2;
+    detections.emplace_back(std::move(entry));
   }
-
-  // If this point is reached then add current box to the list;
-  return -1;
 }
 
-int32_t Module::TensorCompareValues(const float *data,
-                                    const uint32_t& l_idx,
-                                    const uint32_t& r_idx) {
+void Module::ParseBoxes(const Tensor& tensor, uint32_t n_paxels,
+                        const Region& region) {
 
-  return ((float*)data)[l_idx] > ((float*)data)[r_idx] ? 1 :
-     ((float*)data)[l_idx] < ((float*)data)[r_idx] ? -1 : 0;
-}
-
-void Module::ParseMonoblockFrame(const Tensors& tensors, Dictionary& mlparams,
-                                  std::any& output) {
-
-  if (output.type() != typeid(ObjectDetections)) {
-    LOG(logger_, kError, "Unexpected output type!");
-    return;
-  }
-
-  ObjectDetections& detections =
-    std::any_cast<ObjectDetections&>(output);
-
-  // Get region
-  Region& region =
-      std::any_cast<Region&>(mlparams["input-tensor-region"]);
-
-  uint32_t n_paxels = tensors[0].dimensions[2];
-
-  // We subtract 4 because the last 4 are the bbox coordinates.
-  uint32_t n_classes = tensors[0].dimensions[1] - 4;
-
-  const float* bboxes = reinterpret_cast<const float*>(tensors[0].data);
-  const float* scores = &bboxes[4 * n_paxels];
-
-  for (uint32_t idx = 0; idx < n_paxels; idx++) {
+  for (const ScoreCandidate& candidate : scores_) {
     ObjectDetection entry;
 
-    uint32_t id = idx;
-
-    for (uint32_t num = (idx + n_paxels);
-        num < (n_classes * n_paxels); num += n_paxels)
-      id = (TensorCompareValues(scores, num, id) > 0) ? num : id;
-
-    uint32_t class_idx = id / n_paxels;
-    double confidence = scores[id];
+    uint32_t idx = candidate.anchor;
+    uint32_t class_idx = candidate.label;
+    double confidence = candidate.confidence;
 
-    if (confidence < threshold_)
-      continue;
-
-    double cx = bboxes[idx];
-    double cy = bboxes[idx + n_paxels];
-    double w  = bboxes[idx + 2 * n_paxels];
-    double h  = bboxes[idx + 3 * n_paxels];
+    // Boxes are dequantized only for the anchors which passed the threshold.
+    double cx = TensorValue(tensor, idx);
+    double cy = TensorValue(tensor, idx + n_paxels);
+    double w  = TensorValue(tensor, idx + 2 * n_paxels);
+    double h  = TensorValue(tensor, idx + 3 * n_paxels);
 
     LOG(logger_, kLog, "Class: %u Confidence: %.2f CX x CY[%f, %f] W x H: [%f, %f]",
         class_idx, confidence, cx, cy, w, h);
@@ -196,28 +114,14 @@ void Module::ParseMonoblockFrame(const Tensors& tensors, Dictionary& mlparams,
     TransformDimensions(entry, region);
 
     entry.confidence = confidence * 100.0f;
-    entry.name = labels_parser_.GetLabel(class_idx);
-    entry.color = labels_parser_.GetColor(class_idx);
-
-    int32_t nms = NonMaxSuppression(entry, detections);
 
-    // If the NMS result is -2 don't add the prediction to the list.
-    if (nms == (-2))
-      continue;
-
-    LOG(logger_, kTrace, "Label: %s Confidence: %.2f Box[%f, %f, %f, %f]",
-        entry.name.c_str(), entry.confidence, entry.top, entry.left,
-        entry.bottom, entry.right);
-
-    // If the NMS result is above -1 remove the entry with the nms index.
-    if (nms >= 0)
-      detections.erase(detections.begin() + nms);
-
-    detections.emplace_back(std::move(entry));
+    nms_.Add(entry.left, entry.top, entry.right, entry.bottom,
+        entry.confidence, class_idx);
+    candidates_.emplace_back(std::move(entry));
   }
 }
 
-void Module::ParseDualblockFrame(const Tensors& tensors, Dictionary& mlparams,
+void Module::ParseMonoblockFrame(const Tensors& tensors, Dictionary& mlparams,
                                   std::any& output) {
 
   if (output.type() != typeid(ObjectDetections)) {
@@ -228,77 +132,53 @@ void Module::ParseDualblockFrame(const Tensors& tensors, Dictionary& mlparams,
   ObjectDetections& detections =
     std::any_cast<ObjectDetections&>(output);
 
+  nms_.Clear();
+  candidates_.clear();
+  scores_.clear();
+
   // Get region
   Region& region =
       std::any_cast<Region&>(mlparams["input-tensor-region"]);
 
   uint32_t n_paxels = tensors[0].dimensions[2];
-  uint32_t n_classes = tensors[1].dimensions[1];
-
-  const float* bboxes = reinterpret_cast<const float *>(tensors[0].data);
-  const float* scores = reinterpret_cast<const float *>(tensors[1].data);
-
-  for (uint32_t idx = 0; idx < n_paxels; idx++) {
-    ObjectDetection entry;
-
-    uint32_t id = idx;
-
-    for (uint32_t num = (idx + n_paxels); num < (n_classes * n_paxels); num += n_paxels)
-      id = (TensorCompareValues(scores, num, id) > 0) ? num : id;
-
-    uint32_t class_idx = idx / n_paxels;
 
-    double confidence = scores[id];
-
-    if (confidence < threshold_)
-      continue;
-
-    double cx = bboxes[id + 0 * n_paxels];
-    double cy = bboxes[id + 1 * n_paxels];
-    double w  = bboxes[id + 2 * n_paxels];
-    double h  = bboxes[id + 3 * n_paxels];
-
-    LOG(logger_, kLog, "Class: %u Confidence: %.2f CX x CY[%f, %f] W x H: [%f, %f]",
-        class_idx, confidence, cx, cy, w, h);
+  // We subtract 4 because the last 4 are the bbox coordinates.
+  uint32_t n_classes = tensors[0].dimensions[1] - 4;
 
-    entry.top =  cy - h / 2.0f;
-    entry.left = cx - w / 2.0f;
-    entry.bottom = entry.top + h;
-    entry.right = entry.left + w;
+  // Class score planes follow the 4 bbox coordinate planes.
+  DecodeScorePlanes(tensors[0], 4 * n_paxels, n_paxels, n_classes,
+      threshold_, scores_);
 
-    entry.left = std::max(entry.left,static_cast<float>(region.x));
-    entry.top = std::max(entry.top, static_cast<float>(region.y));
-    entry.right = std::min(entry.right,
-        static_cast<float>((region.x + region.width)));
-    entry.bottom = std::min(entry.bottom,
-        static_cast<float>((region.y + region.height)));
+  ParseBoxes(tensors[0], n_paxels, region);
+  NonMaxSuppression(detections);
+}
 
-    LOG(logger_, kLog, "Class: %u Confidence: %.2f Box[%f, %f, %f, %f]", class_idx,
-        confidence, entry.top, entry.left, entry.bottom,
-        entry.right);
+void Module::ParseDualblockFrame(const Tensors& tensors, Dictionary& mlparams,
+                                  std::any& output) {
 
-    TransformDimensions(entry, region);
+  if (output.type() != typeid(ObjectDetections)) {
+    LOG(logger_, kError, "Unexpected output type!");
+    return;
+  }
 
-    entry.confidence = confidence * 100.0f;
-    entry.name = labels_parser_.GetLabel(class_idx);
-    entry.color = labels_parser_.GetColor(class_idx);
+  ObjectDetections& detections =
+    std::any_cast<ObjectDetections&>(output);
 
-    int32_t nms = NonMaxSuppression(entry, detections);
+  nms_.Clear();
+  candidates_.clear();
+  scores_.clear();
 
-    // If the NMS result is -2 don't add the prediction to the list.
-    if (nms == (-2))
-      continue;
+  // Get region
+  Region& region =
+      std::any_cast<Region&>(mlparams["input-tensor-region"]);
 
-    LOG(logger_, kTrace, "Label: %s Confidence: %.2f Box[%f, %f, %f, %f]",
-        entry.name.c_str(), entry.confidence, entry.top, entry.left,
-        entry.bottom, entry.right);
+  uint32_t n_paxels = tensors[0].dimensions[2];
+  uint32_t n_classes = tensors[1].dimensions[1];
 
-    // If the NMS result is above -1 remove the entry with the nms index.
-    if (nms >= 0)
-      detections.erase(detections.begin() + nms);
+  DecodeScorePlanes(tensors[1], 0, n_paxels, n_classes, threshold_, scores_);
 
-    detections.emplace_back(std::move(entry));
-  }
+  ParseBoxes(tensors[0], n_paxels, region);
+  NonMaxSuppression(detections);
 }
 
 void Module::ParseTripleblockFrame(const Tensors& tensors,
@@ -313,6 +193,9 @@ void Module::ParseTripleblockFrame(const Tensors& tensors,
   ObjectDetections& detections =
       std::any_cast<ObjectDetections&>(output);
 
+  nms_.Clear();
+  candidates_.clear();
+
   // Get region
   Region& region =
       std::any_cast<Region&>(mlparams["input-tensor-region"]);
@@ -351,26 +234,13 @@ void Module::ParseTripleblockFrame(const Tensors& tensors,
       continue;
 
     entry.confidence = confidence * 100.0F;
-    entry.name = labels_parser_.GetLabel(class_idx);
-    entry.color = labels_parser_.GetColor(class_idx);
-
-    // Non-Max Suppression(NMS) algorithm.
-    int32_t nms = NonMaxSuppression(entry, detections);
-
-    // If the NMS result is -2 don't add the prediction to the list.
-    if (nms == (-2))
-      continue;
 
-    LOG(logger_, kTrace, "Label: %s Confidence: %.2f Box[%f, %f, %f, %f]",
-        entry.name.c_str(), entry.confidence, entry.top, entry.left,
-        entry.bottom, entry.right);
-
-    // If the NMS result is above -1 remove the entry with the nms index.
-    if (nms >= 0)
-      detections.erase(detections.begin() + nms);
-
-    detections.emplace_back(std::move(entry));
+    nms_.Add(entry.left, entry.top, entry.right, entry.bottom,
+        entry.confidence, class_idx);
+    candidates_.emplace_back(std::move(entry));
   }
+
+  NonMaxSuppression(detections);
 }
 
 std::string Module::Caps() {
@@ -7,6 +7,8 @@
 
 #include "qti-ml-post-process.h"
 #include "qti-labels-parser.h"
+#include "qti-nms.h"
+#include "qti-score-decoder.h"
 
 #include <string>
 
@@ -25,14 +27,10 @@ class Module : public IModule {
  private:
   void TransformDimensions(ObjectDetection &box, const Region& region);
 
-  float IntersectionScore(const ObjectDetection &l_box,
-                          const ObjectDetection &r_box);
+  void NonMaxSuppression(ObjectDetections& detections);
 
-  int32_t NonMaxSuppression(const ObjectDetection &l_box,
-                            const ObjectDetections &boxes);
-
-  int32_t TensorCompareValues(const float *data,
-                              const uint32_t& l_idx,const uint32_t& r_idx);
+  void ParseBoxes(const Tensor& tensor, uint32_t n_paxels,
+                  const Region& region);
 
   void ParseMonoblockFrame(const Tensors& tensors, Dictionary& mlparams,
                             std::any& output);
@@ -44,9 +42,15 @@ class Module : public IModule {
                              std::any& output);
 
   // Logging callback.
-  LogCallback  logger_;
+  LogCallback      logger_;
   // Confidence threshold value.
-  double       threshold_;
+  double           threshold_;
   // Labels parser.
-  LabelsParser labels_parser_;
+  LabelsParser     labels_parser_;
+  // Non-Max Suppression(NMS) of the candidate detections.
+  NonMaxSuppressor nms_;
+  // Detections above the confidence threshold, subject to NMS.
+  ObjectDetections candidates_;
+  // Anchors with class score above the confidence threshold.
+  ScoreCandidates  scores_;
 };
@@ -14,6 +14,8 @@
 #include <functional>
 #include <cstdarg>
 
+#include <gst/utils/float16-utils.h>
+
 /** The C interface function that a submodule must expose:
  *
  * IModule* NewModule(LogCallback logger) {
@@ -215,6 +217,79 @@ struct Tensor {
 // Variable vector of tensor structures.
 typedef std::vector<Tensor> Tensors;
 
+/** TensorRawValue
+ * @tensor: Tensor from which the element is read.
+ * @idx: Index of the element in the tensor data.
+ *
+ * Read a single element in the native domain of the tensor, without applying
+ * the dequantization parameters. FLOAT16 elements are converted to FLOAT32.
+ *
+ * return: Value of the element
+ */
+inline float TensorRawValue(const Tensor& tensor, size_t idx) {
+
+  switch (tensor.type) {
+    case kInt8:
+      return static_cast<const int8_t*>(tensor.data)[idx];
+    case kUint8:
+      return static_cast<const uint8_t*>(tensor.data)[idx];
+    case kInt16:
+      return static_cast<const int16_t*>(tensor.data)[idx];
+    case kUint16:
+      return static_cast<const uint16_t*>(tensor.data)[idx];
+    case kInt32:
+      return static_cast<const int32_t*>(tensor.data)[idx];
+    case kUint32:
+      return static_cast<const uint32_t*>(tensor.data)[idx];
+    case kInt64:
+      return static_cast<const int64_t*>(tensor.data)[idx];
+    case kUint64:
+      return static_cast<const uint64_t*>(tensor.data)[idx];
+    case kFloat16:
+      return gst_half_to_float(static_cast<const uint16_t*>(tensor.data)[idx]);
+    case kFloat32:
+      return static_cast<const float*>(tensor.data)[idx];
+  }
+
+  return 0.0F;
+}
+
+/** TensorValue
+ * @tensor: Tensor from which the element is read.
+ * @idx: Index of the element in the tensor data.
+ *
+ * Read a single element and dequantize it with the tensor qscale and qoffset.
+ * Allows submodules to accept the native tensors of the inference engines and
+ * to dequantize only the elements that are actually used.
+ *
+ * return: Dequantized value of the element
+ */
+inline float TensorValue(const Tensor& tensor, size_t idx) {
+
+  if (tensor.type == kFloat32 || tensor.type == kFloat16)
+    return TensorRawValue(tensor, idx);
+
+  return (TensorRawValue(tensor, idx) - tensor.qoffset) * tensor.qscale;
+}
+
+/** TensorQuantize
+ * @tensor: Tensor in whose native domain the value is converted.
+ * @value: Dequantized value, for example a confidence threshold.
+ *
+ * Convert a value in the native domain of the tensor, so that it can be
+ * compared directly with the results of TensorRawValue(). The result is not
+ * rounded, comparisons give the same results as with dequantized elements.
+ *
+ * return: Value in the native domain of the tensor
+ */
+inline float TensorQuantize(const Tensor& tensor, float value) {
+
+  if (tensor.type == kFloat32 || tensor.type == kFloat16)
+    return value;
+
+  return (value / tensor.qscale) + tensor.qoffset;
+}
+
 // Map between a parameter and its value: <parameter name, value>
 typedef std::unordered_map<std::string, std::any> Dictionary;
 
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/** qti-nms-benchmark
+ *
+ * Micro-benchmark of the NonMaxSuppressor on 1k-10k random candidates.
+ *
+ * Times the incremental per-box scan which the object detection modules used
+ * before, a scalar greedy reference and the NonMaxSuppressor with hard and
+ * Soft-NMS. Hard NMS results are checked against the scalar reference.
+ *
+ * Usage: qti-nms-benchmark [number of runs]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "qti-nms.h"
+
+static const float kThreshold = 0.5F;
+static const uint32_t kNumClasses = 80;
+static const uint32_t kNumCandidates[] = { 1000, 2000, 5000, 10000 };
+
+struct Candidate {
+  float       left;
+  float       top;
+  float       right;
+  float       bottom;
+  float       confidence;
+  uint32_t    class_id;
+  std::string name;
+};
+
+typedef std::vector<Candidate> Candidates;
+
+static float IntersectionScore(const Candidate& l_box, const Candidate& r_box) {
+
+  float width = std::min(l_box.right, r_box.right) -
+      std::max(l_box.left, r_box.left);
+
+  if (width <= 0.0F)
+    return 0.0F;
+
+  float height = std::min(l_box.bottom, r_box.bottom) -
+      std::max(l_box.top, r_box.top);
+
+  if (height <= 0.0F)
+    return 0.0F;
+
+  float intersection = width * height;
+  float l_area = (l_box.right - l_box.left) * (l_box.bottom - l_box.top);
+  float r_area = (r_box.right - r_box.left) * (r_box.bottom - r_box.top);
+
+  return intersection / (l_area + r_area - intersection);
+}
+
+// Incremental per-box scan, as done by the modules before the shared engine.
+static void LegacySuppression(const Candidates& candidates,
+                              Candidates& detections) {
+  detections.clear();
+
+  for (const Candidate& entry : candidates) {
+    int32_t nms = -1;
+
+    for (uint32_t idx = 0; idx < detections.size(); idx++) {
+      if (entry.name != detections[idx].name)
+        continue;
+
+      if (IntersectionScore(entry, detections[idx]) <= kThreshold)
+        continue;
+
+      nms = (entry.confidence > detections[idx].confidence) ? idx : -2;
+      break;
+    }
+
+    if (nms == (-2))
+      continue;
+
+    if (nms >= 0)
+      detections.erase(detections.begin() + nms);
+
+    detections.push_back(entry);
+  }
+}
+
+// Greedy suppression in descending score order, used for verification.
+static void ReferenceSuppression(const Candidates& candidates,
+                                 std::vector<uint32_t>& results) {
+  std::vector<uint32_t> order(candidates.size());
+
+  for (uint32_t idx = 0; idx < order.size(); idx++)
+    order[idx] = idx;
+
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t l, uint32_t r) {
+    return candidates[l].confidence > candidates[r].confidence;
+  });
+
+  results.clear();
+
+  for (uint32_t idx : order) {
+    bool overlaps = false;
+
+    for (uint32_t num = 0; (num < results.size()) && !overlaps; num++) {
+      const Candidate& kept = candidates[results[num]];
+
+      overlaps = (kept.class_id == candidates[idx].class_id) &&
+          (IntersectionScore(candidates[idx], kept) > kThreshold);
+    }
+
+    if (!overlaps)
+      results.push_back(idx);
+  }
+}
+
+// Random boxes around a limited number of objects, so that many overlap.
+static void GenerateCandidates(uint32_t n_candidates, Candidates& candidates) {
+  std::mt19937 engine(n_candidates);
+  std::uniform_real_distribution<float> position(0.0F, 1.0F);
+  std::uniform_real_distribution<float> size(0.02F, 0.2F);
+  std::normal_distribution<float> jitter(0.0F, 0.01F);
+  std::uniform_real_distribution<float> score(0.05F, 1.0F);
+  std::uniform_int_distribution<uint32_t> label(0, kNumClasses - 1);
+
+  std::vector<Candidate> objects(n_candidates / 10);
+
+  for (Candidate& object : objects) {
+    object.left = position(engine);
+    object.top = position(engine);
+    object.right = object.left + size(engine);
+    object.bottom = object.top + size(engine);
+    object.class_id = label(engine);
+  }
+
+  candidates.resize(n_candidates);
+
+  for (uint32_t idx = 0; idx < n_candidates; idx++) {
+    const Candidate& object = objects[idx % objects.size()];
+    Candidate& candidate = candidates[idx];
+
+    candidate.left = object.left + jitter(engine);
+    candidate.top = object.top + jitter(engine);
+    candidate.right = object.right + jitter(engine);
+    candidate.bottom = object.bottom + jitter(engine);
+    candidate.confidence = score(engine);
+    candidate.class_id = object.class_id;
+    candidate.name = "label-" + std::to_string(object.class_id);
+  }
+}
+
+template<typename Function>
+static double Measure(uint32_t n_runs, Function function) {
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t run = 0; run < n_runs; run++)
+    function();
+
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  return elapsed.count() / n_runs;
+}
+
+static void RunEngine(NonMaxSuppressor& nms, const Candidates& candidates,
+                      std::vector<uint32_t>& results) {
+  nms.Clear();
+
+  for (const Candidate& c : candidates)
+    nms.Add(c.left, c.top, c.right, c.bottom, c.confidence, c.class_id);
+
+  results = nms.Run();
+}
+
+int main(int argc, char* argv[]) {
+  uint32_t n_runs = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 20;
+  bool success = true;
+
+  if (n_runs == 0)
+    n_runs = 1;
+
+  std::printf("%10s %12s %12s %12s %12s %12s %8s\n", "candidates",
+      "legacy(us)", "scalar(us)", "hard(us)", "linear(us)", "gauss(us)",
+      "kept");
+
+  for (uint32_t n_candidates : kNumCandidates) {
+    Candidates candidates, detections;
+    std::vector<uint32_t> reference, results;
+    NonMaxSuppressor nms(kThreshold);
+
+    GenerateCandidates(n_candidates, candidates);
+
+    double legacy = Measure(n_runs,
+        [&]() { LegacySuppression(candidates, detections); });
+    double scalar = Measure(n_runs,
+        [&]() { ReferenceSuppression(candidates, reference); });
+
+    nms.SetMethod(NmsMethod::kHard);
+    double hard = Measure(n_runs,
+        [&]() { RunEngine(nms, candidates, results); });
+
+    std::vector<uint32_t> expected = reference, actual = results;
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+
+    if (expected != actual) {
+      std::fprintf(stderr, "Hard NMS mismatch for %u candidates: %zu kept, "
+          "expected %zu!\n", n_candidates, actual.size(), expected.size());
+      success = false;
+    }
+
+    nms.SetMethod(NmsMethod::kLinear, 0.5F, 0.05F);
+    double linear = Measure(n_runs,
+        [&]() { RunEngine(nms, candidates, results); });
+
+    nms.SetMethod(NmsMethod::kGaussian, 0.5F, 0.05F);
+    double gauss = Measure(n_runs,
+        [&]() { RunEngine(nms, candidates, results); });
+
+    std::printf("%10u %12.1f %12.1f %12.1f %12.1f %12.1f %8zu\n",
+        n_candidates, legacy, scalar, hard, linear, gauss, reference.size());
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,484 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif // __ARM_NEON
+
+/** NmsMethod:
+ * @kHard: Greedy suppression, overlapping boxes with lower score are removed.
+ * @kLinear: Soft-NMS, scores of overlapping boxes are decayed by (1 - IoU).
+ * @kGaussian: Soft-NMS, scores of all boxes are decayed by exp(-IoU^2/sigma).
+ *
+ * Suppression method used by the #NonMaxSuppressor.
+ */
+enum class NmsMethod {
+  kHard,
+  kLinear,
+  kGaussian,
+};
+
+/** NonMaxSuppressor
+ *
+ * Non-Maximum Suppression(NMS) shared by the object detection modules.
+ *
+ * Candidate boxes are accumulated with Add() and filtered at once by Run().
+ * Boxes are bucketed by their integer class ID and suppressed in descending
+ * score order, comparing each candidate against all kept boxes of the same
+ * class at once with vectorized Intersection over Union(IoU) computation.
+ *
+ * Boxes are stored in structure of arrays layout which is retained between
+ * frames, hence no allocations take place once the maximum number of
+ * candidates has been reached.
+ */
+class NonMaxSuppressor {
+ public:
+  NonMaxSuppressor(float threshold = 0.5F)
+      : threshold_(threshold),
+        method_(NmsMethod::kHard),
+        sigma_(0.5F),
+        min_score_(0.0F),
+        agnostic_(false),
+        topk_(0),
+        max_detections_(0) {};
+
+  /** SetThreshold.
+   * @threshold: IoU above which boxes are considered overlapping.
+   */
+  void SetThreshold(float threshold) { threshold_ = threshold; }
+
+  /** SetMethod.
+   * @method: Suppression method.
+   * @sigma: Sigma of the Gaussian decay, used only by #NmsMethod::kGaussian.
+   * @min_score: Boxes with decayed score below this value are discarded,
+   *             used only by the Soft-NMS methods.
+   */
+  void SetMethod(NmsMethod method, float sigma = 0.5F,
+                 float min_score = 0.0F) {
+    method_ = method;
+    sigma_ = sigma;
+    min_score_ = min_score;
+  }
+
+  /** SetClassAgnostic.
+   * @agnostic: Whether boxes of different classes suppress each other.
+   */
+  void SetClassAgnostic(bool agnostic) { agnostic_ = agnostic; }
+
+  /** SetTopK.
+   * @topk: Only the highest scoring candidates are processed, 0 for all.
+   */
+  void SetTopK(uint32_t topk) { topk_ = topk; }
+
+  /** SetMaxDetections.
+   * @max: Maximum number of boxes returned by Run(), 0 for unlimited.
+   */
+  void SetMaxDetections(uint32_t max) { max_detections_ = max; }
+
+  /** Clear.
+   *
+   * Remove all candidates, must be called before processing a new frame.
+   */
+  void Clear() {
+    left_.clear();
+    top_.clear();
+    right_.clear();
+    bottom_.clear();
+    area_.clear();
+    scores_.clear();
+    classes_.clear();
+    results_.clear();
+  }
+
+  /** Add.
+   * @left: X axis coordinate of upper-left corner.
+   * @top: Y axis coordinate of upper-left corner.
+   * @right: X axis coordinate of lower-right corner.
+   * @bottom: Y axis coordinate of lower-right corner.
+   * @score: Confidence of the candidate.
+   * @class_id: Class of the candidate.
+   *
+   * Add a candidate box. Coordinates may be in any system as long as it is
+   * the same for all candidates.
+   *
+   * return: Index of the candidate, used to identify it in Run() results.
+   */
+  uint32_t Add(float left, float top, float right, float bottom,
+               float score, uint32_t class_id) {
+    left_.push_back(left);
+    top_.push_back(top);
+    right_.push_back(right);
+    bottom_.push_back(bottom);
+    area_.push_back(std::max(right - left, 0.0F) *
+        std::max(bottom - top, 0.0F));
+    scores_.push_back(score);
+    classes_.push_back(class_id);
+
+    return scores_.size() - 1;
+  }
+
+  /** Size.
+   *
+   * return: Number of added candidates.
+   */
+  uint32_t Size() const { return scores_.size(); }
+
+  /** Score.
+   * @idx: Index of the candidate.
+   *
+   * return: Score of the candidate, decayed if Soft-NMS was used.
+   */
+  float Score(uint32_t idx) const { return scores_[idx]; }
+
+  /** Class.
+   * @idx: Index of the candidate.
+   *
+   * return: Class ID of the candidate.
+   */
+  uint32_t Class(uint32_t idx) const { return classes_[idx]; }
+
+  /** Run.
+   *
+   * Execute the suppression over all added candidates.
+   *
+   * return: Indices of the kept candidates in descending score order.
+   */
+  const std::vector<uint32_t>& Run() {
+    results_.clear();
+
+    if (scores_.empty())
+      return results_;
+
+    order_.resize(scores_.size());
+    std::iota(order_.begin(), order_.end(), 0);
+
+    auto by_score = [&](uint32_t l_idx, uint32_t r_idx) {
+      return (scores_[l_idx] != scores_[r_idx]) ?
+          (scores_[l_idx] > scores_[r_idx]) : (l_idx < r_idx);
+    };
+
+    // Discard all but the top K candidates before the quadratic part.
+    if ((topk_ != 0) && (order_.size() > topk_)) {
+      std::nth_element(order_.begin(), order_.begin() + topk_, order_.end(),
+          by_score);
+      order_.resize(topk_);
+    }
+
+    // Group the candidates by class, in descending score order in each class.
+    std::sort(order_.begin(), order_.end(), [&](uint32_t l_idx, uint32_t r_idx) {
+      if (!agnostic_ && (classes_[l_idx] != classes_[r_idx]))
+        return classes_[l_idx] < classes_[r_idx];
+
+      return by_score(l_idx, r_idx);
+    });
+
+    for (size_t begin = 0, end = 0; begin < order_.size(); begin = end) {
+      // Find the end of the class bucket.
+      for (end = begin + 1; end < order_.size(); end++)
+        if (!agnostic_ && (classes_[order_[end]] != classes_[order_[begin]]))
+          break;
+
+      if (method_ == NmsMethod::kHard)
+        HardSuppression(begin, end);
+      else
+        SoftSuppression(begin, end);
+    }
+
+    // Merge the results of all classes.
+    std::sort(results_.begin(), results_.end(), by_score);
+
+    if ((max_detections_ != 0) && (results_.size() > max_detections_))
+      results_.resize(max_detections_);
+
+    return results_;
+  }
+
+ private:
+  // Copy a box into the kept boxes of the current class bucket.
+  void Keep(uint32_t idx) {
+    k_left_.push_back(left_[idx]);
+    k_top_.push_back(top_[idx]);
+    k_right_.push_back(right_[idx]);
+    k_bottom_.push_back(bottom_[idx]);
+    k_area_.push_back(area_[idx]);
+
+    results_.push_back(idx);
+  }
+
+  // Check whether a box overlaps with any of the kept boxes above threshold.
+  bool Overlaps(uint32_t idx) const {
+    const uint32_t n_boxes = k_area_.size();
+    uint32_t num = 0;
+
+    // Division is avoided by comparing the intersection with the scaled union.
+#if defined(__ARM_NEON)
+    const float32x4_t zero = vdupq_n_f32(0.0F);
+    const float32x4_t threshold = vdupq_n_f32(threshold_);
+    const float32x4_t left = vdupq_n_f32(left_[idx]);
+    const float32x4_t top = vdupq_n_f32(top_[idx]);
+    const float32x4_t right = vdupq_n_f32(right_[idx]);
+    const float32x4_t bottom = vdupq_n_f32(bottom_[idx]);
+    const float32x4_t area = vdupq_n_f32(area_[idx]);
+
+    for (; (num + 4) <= n_boxes; num += 4) {
+      float32x4_t width = vsubq_f32(vminq_f32(right, vld1q_f32(&k_right_[num])),
+          vmaxq_f32(left, vld1q_f32(&k_left_[num])));
+      float32x4_t height = vsubq_f32(
+          vminq_f32(bottom, vld1q_f32(&k_bottom_[num])),
+          vmaxq_f32(top, vld1q_f32(&k_top_[num])));
+
+      float32x4_t intersection =
+          vmulq_f32(vmaxq_f32(width, zero), vmaxq_f32(height, zero));
+      float32x4_t unison = vsubq_f32(
+          vaddq_f32(area, vld1q_f32(&k_area_[num])), intersection);
+
+      uint32x4_t mask = vcgtq_f32(intersection, vmulq_f32(unison, threshold));
+      uint32x2_t bits = vorr_u32(vget_low_u32(mask), vget_high_u32(mask));
+
+      if ((vget_lane_u32(bits, 0) | vget_lane_u32(bits, 1)) != 0)
+        return true;
+    }
+#elif defined(__SSE2__)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 threshold = _mm_set1_ps(threshold_);
+    const __m128 left = _mm_set1_ps(left_[idx]);
+    const __m128 top = _mm_set1_ps(top_[idx]);
+    const __m128 right = _mm_set1_ps(right_[idx]);
+    const __m128 bottom = _mm_set1_ps(bottom_[idx]);
+    const __m128 area = _mm_set1_ps(area_[idx]);
+
+    for (; (num + 4) <= n_boxes; num += 4) {
+      __m128 width = _mm_sub_ps(_mm_min_ps(right, _mm_loadu_ps(&k_right_[num])),
+          _mm_max_ps(left, _mm_loadu_ps(&k_left_[num])));
+      __m128 height = _mm_sub_ps(
+          _mm_min_ps(bottom, _mm_loadu_ps(&k_bottom_[num])),
+          _mm_max_ps(top, _mm_loadu_ps(&k_top_[num])));
+
+      __m128 intersection =
+          _mm_mul_ps(_mm_max_ps(width, zero), _mm_max_ps(height, zero));
+      __m128 unison = _mm_sub_ps(
+          _mm_add_ps(area, _mm_loadu_ps(&k_area_[num])), intersection);
+
+      __m128 mask = _mm_cmpgt_ps(intersection, _mm_mul_ps(unison, threshold));
+
+      if (_mm_movemask_ps(mask) != 0)
+        return true;
+    }
+#endif // __ARM_NEON
+
+    for (; num < n_boxes; num++) {
+      float width = std::min(right_[idx], k_right_[num]) -
+          std::max(left_[idx], k_left_[num]);
+      float height = std::min(bottom_[idx], k_bottom_[num]) -
+          std::max(top_[idx], k_top_[num]);
+
+      float intersection = std::max(width, 0.0F) * std::max(height, 0.0F);
+      float unison = area_[idx] + k_area_[num] - intersection;
+
+      if (intersection > (unison * threshold_))
+        return true;
+    }
+
+    return false;
+  }
+
+  // Compute the IoU of a kept box against the kept boxes in the given range.
+  void IntersectionScores(uint32_t idx, uint32_t begin, uint32_t end) {
+    uint32_t num = begin;
+
+    ious_.resize(end);
+
+#if defined(__ARM_NEON)
+    const float32x4_t zero = vdupq_n_f32(0.0F);
+    const float32x4_t epsilon = vdupq_n_f32(1e-12F);
+    const float32x4_t left = vdupq_n_f32(k_left_[idx]);
+    const float32x4_t top = vdupq_n_f32(k_top_[idx]);
+    const float32x4_t right = vdupq_n_f32(k_right_[idx]);
+    const float32x4_t bottom = vdupq_n_f32(k_bottom_[idx]);
+    const float32x4_t area = vdupq_n_f32(k_area_[idx]);
+
+    for (; (num + 4) <= end; num += 4) {
+      float32x4_t width = vsubq_f32(vminq_f32(right, vld1q_f32(&k_right_[num])),
+          vmaxq_f32(left, vld1q_f32(&k_left_[num])));
+      float32x4_t height = vsubq_f32(
+          vminq_f32(bottom, vld1q_f32(&k_bottom_[num])),
+          vmaxq_f32(top, vld1q_f32(&k_top_[num])));
+
+      float32x4_t intersection =
+          vmulq_f32(vmaxq_f32(width, zero), vmaxq_f32(height, zero));
+      float32x4_t unison = vmaxq_f32(vsubq_f32(
+          vaddq_f32(area, vld1q_f32(&k_area_[num])), intersection), epsilon);
+
+#if defined(__aarch64__)
+      vst1q_f32(&ious_[num], vdivq_f32(intersection, unison));
+#else
+      // Reciprocal estimate refined by two Newton-Raphson iterations.
+      float32x4_t reciprocal = vrecpeq_f32(unison);
+      reciprocal = vmulq_f32(vrecpsq_f32(unison, reciprocal), reciprocal);
+      reciprocal = vmulq_f32(vrecpsq_f32(unison, reciprocal), reciprocal);
+
+      vst1q_f32(&ious_[num], vmulq_f32(intersection, reciprocal));
+#endif // __aarch64__
+    }
+#elif defined(__SSE2__)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 epsilon = _mm_set1_ps(1e-12F);
+    const __m128 left = _mm_set1_ps(k_left_[idx]);
+    const __m128 top = _mm_set1_ps(k_top_[idx]);
+    const __m128 right = _mm_set1_ps(k_right_[idx]);
+    const __m128 bottom = _mm_set1_ps(k_bottom_[idx]);
+    const __m128 area = _mm_set1_ps(k_area_[idx]);
+
+    for (; (num + 4) <= end; num += 4) {
+      __m128 width = _mm_sub_ps(_mm_min_ps(right, _mm_loadu_ps(&k_right_[num])),
+          _mm_max_ps(left, _mm_loadu_ps(&k_left_[num])));
+      __m128 height = _mm_sub_ps(
+          _mm_min_ps(bottom, _mm_loadu_ps(&k_bottom_[num])),
+          _mm_max_ps(top, _mm_loadu_ps(&k_top_[num])));
+
+      __m128 intersection =
+          _mm_mul_ps(_mm_max_ps(width, zero), _mm_max_ps(height, zero));
+      __m128 unison = _mm_max_ps(_mm_sub_ps(
+          _mm_add_ps(area, _mm_loadu_ps(&k_area_[num])), intersection), epsilon);
+
+      _mm_storeu_ps(&ious_[num], _mm_div_ps(intersection, unison));
+    }
+#endif // __ARM_NEON
+
+    for (; num < end; num++) {
+      float width = std::min(k_right_[idx], k_right_[num]) -
+          std::max(k_left_[idx], k_left_[num]);
+      float height = std::min(k_bottom_[idx], k_bottom_[num]) -
+          std::max(k_top_[idx], k_top_[num]);
+
+      float intersection = std::max(width, 0.0F) * std::max(height, 0.0F);
+      float unison = k_area_[idx] + k_area_[num] - intersection;
+
+      ious_[num] = intersection / std::max(unison, 1e-12F);
+    }
+  }
+
+  // Greedy suppression of a class bucket which is sorted by score.
+  void HardSuppression(size_t begin, size_t end) {
+    k_left_.clear();
+    k_top_.clear();
+    k_right_.clear();
+    k_bottom_.clear();
+    k_area_.clear();
+
+    for (size_t num = begin; num < end; num++) {
+      if ((max_detections_ != 0) && (k_area_.size() >= max_detections_))
+        break;
+
+      if (!Overlaps(order_[num]))
+        Keep(order_[num]);
+    }
+  }
+
+  // Soft-NMS of a class bucket, scores are decayed instead of removed.
+  void SoftSuppression(size_t begin, size_t end) {
+    const uint32_t n_boxes = end - begin;
+
+    // Gather the bucket in order to compute the IoU on contiguous memory.
+    k_left_.resize(n_boxes);
+    k_top_.resize(n_boxes);
+    k_right_.resize(n_boxes);
+    k_bottom_.resize(n_boxes);
+    k_area_.resize(n_boxes);
+    k_scores_.resize(n_boxes);
+
+    for (uint32_t num = 0; num < n_boxes; num++) {
+      uint32_t idx = order_[begin + num];
+
+      k_left_[num] = left_[idx];
+      k_top_[num] = top_[idx];
+      k_right_[num] = right_[idx];
+      k_bottom_[num] = bottom_[idx];
+      k_area_[num] = area_[idx];
+      k_scores_[num] = scores_[idx];
+    }
+
+    for (uint32_t num = 0; num < n_boxes; num++) {
+      // Decayed scores change the order, find the highest remaining score.
+      uint32_t best = num;
+
+      for (uint32_t id = num + 1; id < n_boxes; id++)
+        best = (k_scores_[id] > k_scores_[best]) ? id : best;
+
+      // All remaining scores are lower than the minimum.
+      if (k_scores_[best] < min_score_)
+        break;
+
+      std::swap(order_[begin + num], order_[begin + best]);
+      std::swap(k_left_[num], k_left_[best]);
+      std::swap(k_top_[num], k_top_[best]);
+      std::swap(k_right_[num], k_right_[best]);
+      std::swap(k_bottom_[num], k_bottom_[best]);
+      std::swap(k_area_[num], k_area_[best]);
+      std::swap(k_scores_[num], k_scores_[best]);
+
+      scores_[order_[begin + num]] = k_scores_[num];
+      results_.push_back(order_[begin + num]);
+
+      if ((max_detections_ != 0) && ((num + 1) >= max_detections_))
+        break;
+
+      IntersectionScores(num, num + 1, n_boxes);
+
+      for (uint32_t id = num + 1; id < n_boxes; id++) {
+        if (method_ == NmsMethod::kGaussian)
+          k_scores_[id] *= std::exp(-(ious_[id] * ious_[id]) / sigma_);
+        else if (ious_[id] > threshold_)
+          k_scores_[id] *= (1.0F - ious_[id]);
+      }
+    }
+  }
+
+  // IoU above which boxes are considered overlapping.
+  float                 threshold_;
+  // Suppression method and its Soft-NMS parameters.
+  NmsMethod             method_;
+  float                 sigma_;
+  float                 min_score_;
+  // Whether boxes of different classes suppress each other.
+  bool                  agnostic_;
+  // Maximum number of processed candidates and returned results.
+  uint32_t              topk_;
+  uint32_t              max_detections_;
+
+  // Candidate boxes in structure of arrays layout.
+  std::vector<float>    left_;
+  std::vector<float>    top_;
+  std::vector<float>    right_;
+  std::vector<float>    bottom_;
+  std::vector<float>    area_;
+  std::vector<float>    scores_;
+  std::vector<uint32_t> classes_;
+
+  // Kept boxes, or all boxes for Soft-NMS, of the current class bucket.
+  std::vector<float>    k_left_;
+  std::vector<float>    k_top_;
+  std::vector<float>    k_right_;
+  std::vector<float>    k_bottom_;
+  std::vector<float>    k_area_;
+  std::vector<float>    k_scores_;
+
+  // Candidate indices sorted by class and score.
+  std::vector<uint32_t> order_;
+  // IoU scores used by Soft-NMS.
+  std::vector<float>    ious_;
+  // Indices of the kept candidates.
+  std::vector<uint32_t> results_;
+};
@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#pragma once
+
+#include "qti-ml-post-process.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif // __ARM_NEON
+
+/** ScoreCandidate:
+ * @anchor: Index of the anchor whose best score passed the threshold.
+ * @label: Index of the class with the best score, first one on equal scores.
+ * @confidence: Dequantized best score.
+ *
+ * Compact description of an anchor which survived the score thresholding.
+ */
+struct ScoreCandidate {
+  uint32_t anchor;
+  uint32_t label;
+  float    confidence;
+};
+
+// Variable vector of score candidates.
+typedef std::vector<ScoreCandidate> ScoreCandidates;
+
+namespace detail {
+
+// Threshold in the native domain, saturated to the range of the type.
+// Returns false if no value of the type is able to pass the threshold.
+template<typename T>
+inline bool NativeThreshold(const Tensor& tensor, float threshold, T& result) {
+
+  float value = TensorQuantize(tensor, threshold);
+
+  if constexpr (std::numeric_limits<T>::is_integer) {
+    // Integer values pass if they are above or equal the rounded up value.
+    value = std::ceil(value);
+
+    if (value > std::numeric_limits<T>::max())
+      return false;
+
+    value = std::max(value, static_cast<float>(std::numeric_limits<T>::min()));
+  }
+
+  result = static_cast<T>(value);
+  return true;
+}
+
+// Find the best class of an anchor and append it to the candidates.
+template<typename T>
+inline void EmitCandidate(const Tensor& tensor, const T* scores,
+                          uint32_t anchor, size_t stride, uint32_t n_classes,
+                          ScoreCandidates& candidates) {
+
+  uint32_t label = 0;
+  T best = scores[0];
+
+  for (uint32_t num = 1; num < n_classes; num++) {
+    if (scores[num * stride] > best) {
+      best = scores[num * stride];
+      label = num;
+    }
+  }
+
+  float confidence = static_cast<float>(best);
+
+  if (tensor.type != kFloat32)
+    confidence = (confidence - tensor.qoffset) * tensor.qscale;
+
+  candidates.push_back({anchor, label, confidence});
+}
+
+// Scalar column max for the anchors which are not covered by a vector block.
+template<typename T>
+inline void ScanPlanes(const Tensor& tensor, const T* data, uint32_t begin,
+                       uint32_t n_anchors, uint32_t n_classes, T threshold,
+                       ScoreCandidates& candidates) {
+
+  for (uint32_t anchor = begin; anchor < n_anchors; anchor++) {
+    T best = data[anchor];
+
+    for (uint32_t num = 1; num < n_classes; num++)
+      best = std::max(best, data[(num * n_anchors) + anchor]);
+
+    if (best >= threshold)
+      EmitCandidate(tensor, &data[anchor], anchor, n_anchors, n_classes,
+                    candidates);
+  }
+}
+
+// Column max of channel-major planes, vectorized for FLOAT32.
+inline void ScanPlanes(const Tensor& tensor, const float* data,
+                       uint32_t n_anchors, uint32_t n_classes, float threshold,
+                       ScoreCandidates& candidates) {
+
+  uint32_t anchor = 0;
+
+#if defined(__ARM_NEON)
+  const float32x4_t limit = vdupq_n_f32(threshold);
+
+  for (; (anchor + 4) <= n_anchors; anchor += 4) {
+    float32x4_t best = vld1q_f32(&data[anchor]);
+
+    for (uint32_t num = 1; num < n_classes; num++)
+      best = vmaxq_f32(best, vld1q_f32(&data[(num * n_anchors) + anchor]));
+
+    uint32_t mask[4];
+    vst1q_u32(mask, vcgeq_f32(best, limit));
+
+    for (uint32_t lane = 0; lane < 4; lane++)
+      if (mask[lane] != 0)
+        EmitCandidate(tensor, &data[anchor + lane], anchor + lane, n_anchors,
+                      n_classes, candidates);
+  }
+#elif defined(__SSE2__)
+  const __m128 limit = _mm_set1_ps(threshold);
+
+  for (; (anchor + 4) <= n_anchors; anchor += 4) {
+    __m128 best = _mm_loadu_ps(&data[anchor]);
+
+    for (uint32_t num = 1; num < n_classes; num++)
+      best = _mm_max_ps(best, _mm_loadu_ps(&data[(num * n_anchors) + anchor]));
+
+    int mask = _mm_movemask_ps(_mm_cmpge_ps(best, limit));
+
+    for (uint32_t lane = 0; mask != 0; lane++, mask >>= 1)
+      if (mask & 1)
+        EmitCandidate(tensor, &data[anchor + lane], anchor + lane, n_anchors,
+                      n_classes, candidates);
+  }
+#endif // __ARM_NEON
+
+  ScanPlanes<float>(tensor, data, anchor, n_anchors, n_classes, threshold,
+                    candidates);
+}
+
+// Column max of channel-major planes, vectorized for UINT8.
+inline void ScanPlanes(const Tensor& tensor, const uint8_t* data,
+                       uint32_t n_anchors, uint32_t n_classes,
+                       uint8_t threshold, ScoreCandidates& candidates) {
+
+  uint32_t anchor = 0;
+
+#if defined(__ARM_NEON)
+  const uint8x16_t limit = vdupq_n_u8(threshold);
+
+  for (; (anchor + 16) <= n_anchors; anchor += 16) {
+    uint8x16_t best = vld1q_u8(&data[anchor]);
+
+    for (uint32_t num = 1; num < n_classes; num++)
+      best = vmaxq_u8(best, vld1q_u8(&data[(num * n_anchors) + anchor]));
+
+    uint8_t mask[16];
+    vst1q_u8(mask, vcgeq_u8(best, limit));
+
+    for (uint32_t lane = 0; lane < 16; lane++)
+      if (mask[lane] != 0)
+        EmitCandidate(tensor, &data[anchor + lane], anchor + lane, n_anchors,
+                      n_classes, candidates);
+  }
+#elif defined(__SSE2__)
+  const __m128i limit = _mm_set1_epi8(static_cast<char>(threshold));
+
+  for (; (anchor + 16) <= n_anchors; anchor += 16) {
+    __m128i best = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(&data[anchor]));
+
+    for (uint32_t num = 1; num < n_classes; num++)
+      best = _mm_max_epu8(best, _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(&data[(num * n_anchors) + anchor])));
+
+    // Unsigned greater or equal, max(best, limit) equals best.
+    int mask = _mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_max_epu8(best, limit), best));
+
+    for (uint32_t lane = 0; mask != 0; lane++, mask >>= 1)
+      if (mask & 1)
+        EmitCandidate(tensor, &data[anchor + lane], anchor + lane, n_anchors,
+                      n_classes, candidates);
+  }
+#endif // __ARM_NEON
+
+  ScanPlanes<uint8_t>(tensor, data, anchor, n_anchors, n_classes, threshold,
+                      candidates);
+}
+
+// Column max of channel-major planes, vectorized for INT8.
+inline void ScanPlanes(const Tensor& tensor, const int8_t* data,
+                       uint32_t n_anchors, uint32_t n_classes,
+                       int8_t threshold, ScoreCandidates& candidates) {
+
+  uint32_t anchor = 0;
+
+#if defined(__ARM_NEON)
+  const int8x16_t limit = vdupq_n_s8(threshold);
+
+  for (; (anchor + 16) <= n_anchors; anchor += 16) {
+    int8x16_t best = vld1q_s8(&data[anchor]);
+
+    for (uint32_t num = 1; num < n_classes; num++)
+      best = vmaxq_s8(best, vld1q_s8(&data[(num * n_anchors) + anchor]));
+
+    uint8_t mask[16];
+    vst1q_u8(mask, vcgeq_s8(best, limit));
+
+    for (uint32_t lane = 0; lane < 16; lane++)
+      if (mask[lane] != 0)
+        EmitCandidate(tensor, &data[anchor + lane], anchor + lane, n_anchors,
+                      n_classes, candidates);
+  }
+#elif defined(__SSE2__)
+  // SSE2 has no signed byte max, flip the sign bit and use the unsigned one.
+  const __m128i sign = _mm_set1_epi8(static_cast<char>(0x80));
+  const __m128i limit = _mm_xor_si128(_mm_set1_epi8(threshold), sign);
+
+  for (; (anchor + 16) <= n_anchors; anchor += 16) {
+    __m128i best = _mm_xor_si128(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(&data[anchor])), sign);
+
+    for (uint32_t num = 1; num < n_classes; num++)
+      best = _mm_max_epu8(best, _mm_xor_si128(_mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(&data[(num * n_anchors) + anchor])),
+          sign));
+
+    int mask = _mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_max_epu8(best, limit), best));
+
+    for (uint32_t lane = 0; mask != 0; lane++, mask >>= 1)
+      if (mask & 1)
+        EmitCandidate(tensor, &data[anchor + lane], anchor + lane, n_anchors,
+                      n_classes, candidates);
+  }
+#endif // __ARM_NEON
+
+  ScanPlanes<int8_t>(tensor, data, anchor, n_anchors, n_classes, threshold,
+                     candidates);
+}
+
+// Maximum of a contiguous row, vectorized for FLOAT32.
+inline float RowMax(const float* data, uint32_t n_elements) {
+
+  uint32_t num = 0;
+  float best = data[0];
+
+#if defined(__ARM_NEON)
+  if (n_elements >= 4) {
+    float32x4_t vbest = vld1q_f32(data);
+
+    for (num = 4; (num + 4) <= n_elements; num += 4)
+      vbest = vmaxq_f32(vbest, vld1q_f32(&data[num]));
+
+    float32x2_t pair = vpmax_f32(vget_low_f32(vbest), vget_high_f32(vbest));
+    best = std::max(vget_lane_f32(pair, 0), vget_lane_f32(pair, 1));
+  }
+#elif defined(__SSE2__)
+  if (n_elements >= 4) {
+    __m128 vbest = _mm_loadu_ps(data);
+
+    for (num = 4; (num + 4) <= n_elements; num += 4)
+      vbest = _mm_max_ps(vbest, _mm_loadu_ps(&data[num]));
+
+    vbest = _mm_max_ps(vbest, _mm_movehl_ps(vbest, vbest));
+    vbest = _mm_max_ss(vbest, _mm_shuffle_ps(vbest, vbest, 0x1));
+    best = _mm_cvtss_f32(vbest);
+  }
+#endif // __ARM_NEON
+
+  for (; num < n_elements; num++)
+    best = std::max(best, data[num]);
+
+  return best;
+}
+
+// Maximum of a contiguous row for the types without vectorized version.
+template<typename T>
+inline T RowMax(const T* data, uint32_t n_elements) {
+
+  T best = data[0];
+
+  for (uint32_t num = 1; num < n_elements; num++)
+    best = std::max(best, data[num]);
+
+  return best;
+}
+
+template<typename T>
+inline void DecodePlanes(const Tensor& tensor, size_t offset,
+                         uint32_t n_anchors, uint32_t n_classes,
+                         float threshold, ScoreCandidates& candidates) {
+
+  const T* data = static_cast<const T*>(tensor.data) + offset;
+  T limit;
+
+  if (NativeThreshold(tensor, threshold, limit))
+    ScanPlanes(tensor, data, n_anchors, n_classes, limit, candidates);
+}
+
+template<typename T>
+inline void DecodeRows(const Tensor& tensor, size_t offset, size_t stride,
+                       uint32_t n_anchors, uint32_t n_classes,
+                       float threshold, ScoreCandidates& candidates) {
+
+  const T* data = static_cast<const T*>(tensor.data) + offset;
+  T limit;
+
+  if (!NativeThreshold(tensor, threshold, limit))
+    return;
+
+  for (uint32_t anchor = 0; anchor < n_anchors; anchor++, data += stride)
+    if (RowMax(data, n_classes) >= limit)
+      EmitCandidate(tensor, data, anchor, 1, n_classes, candidates);
+}
+
+} // namespace detail
+
+/** DecodeScorePlanes
+ * @tensor: Tensor containing the class scores.
+ * @offset: Index of the first score of the first class in the tensor data.
+ * @n_anchors: Number of anchors, each class plane is n_anchors elements long.
+ * @n_classes: Number of consecutive class planes.
+ * @threshold: Minimum dequantized score, for example confidence threshold.
+ * @candidates: Vector to which the surviving anchors are appended.
+ *
+ * Decode channel-major scores, i.e. data[(class * n_anchors) + anchor]. The
+ * maximum score of multiple anchors is computed at once, column-wise, and
+ * compared in the native domain of the tensor against the threshold. Only
+ * for the anchors which pass it the best class is searched for, hence the
+ * cost for the rest of the anchors is a single vector max per class.
+ *
+ * return: NONE
+ */
+inline void DecodeScorePlanes(const Tensor& tensor, size_t offset,
+                              uint32_t n_anchors, uint32_t n_classes,
+                              float threshold, ScoreCandidates& candidates) {
+
+  if ((n_anchors == 0) || (n_classes == 0))
+    return;
+
+  switch (tensor.type) {
+    case kFloat32:
+      detail::DecodePlanes<float>(tensor, offset, n_anchors, n_classes,
+                                  threshold, candidates);
+      break;
+    case kUint8:
+      detail::DecodePlanes<uint8_t>(tensor, offset, n_anchors, n_classes,
+                                    threshold, candidates);
+      break;
+    case kInt8:
+      detail::DecodePlanes<int8_t>(tensor, offset, n_anchors, n_classes,
+                                   threshold, candidates);
+      break;
+    default:
+      // Other types are not offered by the modules, decode them one by one.
+      for (uint32_t anchor = 0; anchor < n_anchors; anchor++) {
+        uint32_t label = 0;
+        float best = TensorRawValue(tensor, offset + anchor);
+
+        for (uint32_t num = 1; num < n_classes; num++) {
+          float value =
+              TensorRawValue(tensor, offset + (num * n_anchors) + anchor);
+
+          label = (value > best) ? num : label;
+          best = std::max(best, value);
+        }
+
+        if (best >= TensorQuantize(tensor, threshold))
+          candidates.push_back({anchor, label,
+              TensorValue(tensor, offset + (label * n_anchors) + anchor)});
+      }
+      break;
+  }
+}
+
+/** DecodeScoreRows
+ * @tensor: Tensor containing the class scores.
+ * @offset: Index of the first score of the first anchor in the tensor data.
+ * @stride: Distance in elements between the rows of consecutive anchors.
+ * @n_anchors: Number of anchor rows.
+ * @n_classes: Number of consecutive class scores in each row.
+ * @threshold: Minimum dequantized score, for example confidence threshold.
+ * @candidates: Vector to which the surviving anchors are appended.
+ *
+ * Decode anchor-major scores, i.e. data[(anchor * stride) + class]. Same as
+ * DecodeScorePlanes(), the maximum of each row is compared in the native
+ * domain and the best class is searched only for the surviving anchors.
+ *
+ * return: NONE
+ */
+inline void DecodeScoreRows(const Tensor& tensor, size_t offset, size_t stride,
+                            uint32_t n_anchors, uint32_t n_classes,
+                            float threshold, ScoreCandidates& candidates) {
+
+  if ((n_anchors == 0) || (n_classes == 0))
+    return;
+
+  switch (tensor.type) {
+    case kFloat32:
+      detail::DecodeRows<float>(tensor, offset, stride, n_anchors, n_classes,
+                                threshold, candidates);
+      break;
+    case kUint8:
+      detail::DecodeRows<uint8_t>(tensor, offset, stride, n_anchors,
+                                  n_classes, threshold, candidates);
+      break;
+    case kInt8:
+      detail::DecodeRows<int8_t>(tensor, offset, stride, n_anchors,
+                                 n_classes, threshold, candidates);
+      break;
+    default:
+      // Other types are not offered by the modules, decode them one by one.
+      for (uint32_t anchor = 0; anchor < n_anchors; anchor++) {
+        size_t idx = offset + (anchor * stride);
+        uint32_t label = 0;
+        float best = TensorRawValue(tensor, idx);
+
+        for (uint32_t num = 1; num < n_classes; num++) {
+          float value = TensorRawValue(tensor, idx + num);
+
+          label = (value > best) ? num : label;
+          best = std::max(best, value);
+        }
+
+        if (best >= TensorQuantize(tensor, threshold))
+          candidates.push_back({anchor, label, TensorValue(tensor, idx + label)});
+      }
+      break;
+  }
+}
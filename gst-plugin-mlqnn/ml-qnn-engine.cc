@@ -13,6 +13,7 @@
 #include <dlfcn.h>
 
 #include <gst/ml/gstmlmeta.h>
+#include <gst/ml/ml-quantize.h>
 
 #include <QnnInterface.h>
 #include <System/QnnSystemInterface.h>
@@ -267,113 +268,60 @@ qnn_to_ml_type (Qnn_DataType_t type)
 }
 
 static void
-gst_ml_qnn_convert_to_float (GstMLFrame *mlframe, guint idx,
-    Qnn_Tensor_t *tensor)
+gst_ml_qnn_tensor_quantization (Qnn_Tensor_t * tensor, gfloat * scale,
+    gfloat * offset)
 {
-  float *output = NULL;
-  size_t n_elements = 0;
-
-  output = reinterpret_cast<float *>(GST_ML_FRAME_BLOCK_DATA (mlframe, idx));
-  n_elements = gst_ml_info_tensor_size (&(mlframe->info), idx);
-  n_elements /= gst_ml_type_get_size (mlframe->info.type);
-
   switch (QNN_TENSOR_DATA_TYPE (tensor)) {
     case QNN_DATATYPE_UFIXED_POINT_8:
-    {
-      uint8_t *data = reinterpret_cast<uint8_t *>(QNN_TENSOR_CLIENTBUF (tensor).data);
-      int32_t offset = QNN_TENSOR_QUANTIZE_PARAMS (tensor).scaleOffsetEncoding.offset;
-      float scale = QNN_TENSOR_QUANTIZE_PARAMS (tensor).scaleOffsetEncoding.scale;
-
-      for (gint idx = n_elements - 1; idx >= 0; idx--)
-        output[idx] = (float)(data[idx] + offset) * scale;
-
-      break;
-    }
     case QNN_DATATYPE_UFIXED_POINT_16:
-    {
-      uint16_t *data = reinterpret_cast<uint16_t *>(QNN_TENSOR_CLIENTBUF (tensor).data);
-      int32_t offset = QNN_TENSOR_QUANTIZE_PARAMS (tensor).scaleOffsetEncoding.offset;
-      float scale = QNN_TENSOR_QUANTIZE_PARAMS (tensor).scaleOffsetEncoding.scale;
-
-      for (gint idx = n_elements - 1; idx >= 0; idx--)
-        output[idx] = (float)(data[idx] + offset) * scale;
-
-      break;
-    }
-    case QNN_DATATYPE_UINT_8:
-    {
-      uint8_t *data = reinterpret_cast<uint8_t *>(QNN_TENSOR_CLIENTBUF (tensor).data);
-
-      for (gint idx = n_elements - 1; idx >= 0; idx--)
-        output[idx] = static_cast<float>(data[idx]);
-
-      break;
-    }
-    case QNN_DATATYPE_UINT_16:
-    {
-      uint16_t *data = reinterpret_cast<uint16_t *>(QNN_TENSOR_CLIENTBUF (tensor).data);
-
-      for (gint idx = n_elements - 1; idx >= 0; idx--)
-        output[idx] = static_cast<float>(data[idx]);
-
-      break;
-    }
-    case QNN_DATATYPE_UINT_32:
-    {
-      uint32_t *data = reinterpret_cast<uint32_t *>(QNN_TENSOR_CLIENTBUF (tensor).data);
-
-      for (gint idx = n_elements - 1; idx >= 0; idx--)
-        output[idx] = static_cast<float>(data[idx]);
-
+    case QNN_DATATYPE_UFIXED_POINT_32:
+    case QNN_DATATYPE_SFIXED_POINT_8:
+    case QNN_DATATYPE_SFIXED_POINT_16:
+    case QNN_DATATYPE_SFIXED_POINT_32:
+      // QNN dequantizes as (value + offset) * scale, hence the negation.
+      *scale = QNN_TENSOR_QUANTIZE_PARAMS (tensor).scaleOffsetEncoding.scale;
+      *offset = -QNN_TENSOR_QUANTIZE_PARAMS (tensor).scaleOffsetEncoding.offset;
       break;
-    }
-    case QNN_DATATYPE_INT_8:
-    {
-      int8_t *data = reinterpret_cast<int8_t *>(QNN_TENSOR_CLIENTBUF (tensor).data);
-
-      for (gint idx = n_elements - 1; idx >= 0; idx--)
-        output[idx] = static_cast<float>(data[idx]);
-
+    default:
+      *scale = 1.0F;
+      *offset = 0.0F;
       break;
-    }
-    case QNN_DATATYPE_INT_16:
-    {
-      int16_t *data = reinterpret_cast<int16_t *>(QNN_TENSOR_CLIENTBUF (tensor).data);
+  }
+}
 
-      for (gint idx = n_elements - 1; idx >= 0; idx--)
-        output[idx] = static_cast<float>(data[idx]);
+static void
+gst_ml_qnn_convert_to_float (GstMLFrame *mlframe, guint idx,
+    Qnn_Tensor_t *tensor)
+{
+  float *output = NULL;
+  size_t n_elements = 0;
+  GstMLType mltype = GST_ML_TYPE_UNKNOWN;
+  gfloat scale = 1.0F, offset = 0.0F;
 
-      break;
-    }
-    case QNN_DATATYPE_INT_32:
-    {
-      int32_t *data = reinterpret_cast<int32_t *>(QNN_TENSOR_CLIENTBUF (tensor).data);
+  // Native tensor type match output type so no need of conversion.
+  if (QNN_TENSOR_DATA_TYPE (tensor) == QNN_DATATYPE_FLOAT_32)
+    return;
 
-      for (gint idx = n_elements - 1; idx >= 0; idx--)
-        output[idx] = static_cast<float>(data[idx]);
+  // Boolean values are stored as single bytes.
+  if (QNN_TENSOR_DATA_TYPE (tensor) == QNN_DATATYPE_BOOL_8)
+    mltype = GST_ML_TYPE_UINT8;
+  else
+    mltype = qnn_to_ml_type (QNN_TENSOR_DATA_TYPE (tensor));
 
-      break;
-    }
-    case QNN_DATATYPE_BOOL_8:
-    {
-      uint8_t *data = reinterpret_cast<uint8_t *>(QNN_TENSOR_CLIENTBUF (tensor).data);
+  if (mltype == GST_ML_TYPE_UNKNOWN) {
+    GST_ERROR ("Datatype not supported yet!");
+    return;
+  }
 
-      for (gint idx = n_elements - 1; idx >= 0; idx--)
-        output[idx] = static_cast<float>(data[idx]);
+  output = reinterpret_cast<float *>(GST_ML_FRAME_BLOCK_DATA (mlframe, idx));
+  n_elements = gst_ml_info_tensor_size (&(mlframe->info), idx);
+  n_elements /= gst_ml_type_get_size (mlframe->info.type);
 
-      break;
-    }
-    case QNN_DATATYPE_FLOAT_32:
-    {
-      // Native tensor type match output type so no need of conversion.
-      break;
-    }
-    default:
-      GST_ERROR ("Datatype not supported yet!");
-      break;
-  }
+  gst_ml_qnn_tensor_quantization (tensor, &scale, &offset);
 
-  return;
+  // The client buffer is the start of the output block, expand it in place.
+  gst_ml_dequantize (mltype, QNN_TENSOR_CLIENTBUF (tensor).data, output,
+      n_elements, scale, offset);
 }
 
 static void
@@ -976,9 +924,22 @@ gst_ml_qnn_engine_new (GstStructure *settings)
     engine->graphindices = g_array_new (FALSE, FALSE, sizeof (guint));
   }
 
-  // TODO: Workaround! Need to handle the tensors of different type. For now,
-  // negotiate with float32 and convert from tensor type to float.
-  engine->outinfo->type = GST_ML_TYPE_FLOAT32;
+  // Native output type is negotiable only if all output tensors share it,
+  // otherwise negotiate with float32 and convert from tensor type to float.
+  engine->outinfo->type = GST_ML_TYPE_UNKNOWN;
+
+  for (idx = 0; idx < graph_info->numOutputTensors; ++idx) {
+    GstMLType mltype = qnn_to_ml_type (
+        QNN_TENSOR_DATA_TYPE (&(graph_info->outputTensors[idx])));
+
+    if (engine->outinfo->type == GST_ML_TYPE_UNKNOWN)
+      engine->outinfo->type = mltype;
+    else if (engine->outinfo->type != mltype)
+      engine->outinfo->type = GST_ML_TYPE_FLOAT32;
+  }
+
+  if (engine->outinfo->type == GST_ML_TYPE_UNKNOWN)
+    engine->outinfo->type = GST_ML_TYPE_FLOAT32;
 
   GST_DEBUG ("Number of output tensors: %u",
       GST_ML_INFO_N_TENSORS (engine->outinfo));
@@ -1197,11 +1158,18 @@ gst_ml_qnn_engine_execute (GstMLQnnEngine *engine, GstMLFrame *inframe,
       tensor = &(graph_info->outputTensors[num]);
     }
 
-    GST_LOG ("Converting Native tensor type to Float");
-    gst_ml_qnn_convert_to_float (outframe, idx, tensor);
-
     mlmeta = gst_buffer_get_ml_tensor_meta_id (outframe->buffer, idx);
     mlmeta->name = g_quark_from_string (QNN_TENSOR_NAME (tensor));
+
+    // Native tensors are passed as they are, dequantized lazily downstream.
+    if (outframe->info.type != GST_ML_TYPE_FLOAT32) {
+      gst_ml_qnn_tensor_quantization (tensor, &(mlmeta->qscale),
+          &(mlmeta->qoffset));
+      continue;
+    }
+
+    GST_LOG ("Converting Native tensor type to Float");
+    gst_ml_qnn_convert_to_float (outframe, idx, tensor);
   }
 
   return TRUE;
@@ -114,6 +114,39 @@ gst_ml_qnn_get_num_cdsp_backends ()
   return num_cdsp_backends;
 }
 
+static GstCaps *
+gst_ml_qnn_output_caps (GstMLQnn * mlqnn)
+{
+  const GstMLInfo *mlinfo = NULL;
+  GstCaps *caps = NULL;
+  GValue list = G_VALUE_INIT, value = G_VALUE_INIT;
+
+  mlinfo = gst_ml_qnn_engine_get_output_info (mlqnn->engine);
+  caps = gst_ml_info_to_caps (mlinfo);
+
+  // If native type is already FLOAT, return immediately.
+  if (GST_ML_INFO_TYPE (mlinfo) == GST_ML_TYPE_FLOAT32)
+    return caps;
+
+  g_value_init (&list, GST_TYPE_LIST);
+  g_value_init (&value, G_TYPE_STRING);
+
+  g_value_set_string (&value, gst_ml_type_to_string (GST_ML_TYPE_FLOAT32));
+  gst_value_list_append_value (&list, &value);
+
+  g_value_set_string (&value,
+      gst_ml_type_to_string (GST_ML_INFO_TYPE (mlinfo)));
+  gst_value_list_append_value (&list, &value);
+
+  // Overwrite the type field by adding FLOAT in addition to native type.
+  gst_caps_set_value (caps, "type", &list);
+
+  g_value_unset (&value);
+  g_value_unset (&list);
+
+  return caps;
+}
+
 static GstCaps *
 gst_ml_qnn_transform_caps (GstBaseTransform * base, GstPadDirection direction,
     GstCaps * caps, GstCaps * filter)
@@ -132,22 +165,21 @@ gst_ml_qnn_transform_caps (GstBaseTransform * base, GstPadDirection direction,
   else if (NULL == mlqnn->engine)
     return gst_caps_ref (caps);
 
+  // The source and sink pads caps do not depend on each other so directly take
+  // the ML caps from the engine for the corresponding pad and apply filter.
   switch (direction) {
     case GST_PAD_SRC:
       mlinfo = gst_ml_qnn_engine_get_input_info (mlqnn->engine);
+      mlcaps = gst_ml_info_to_caps (mlinfo);
       break;
     case GST_PAD_SINK:
-      mlinfo = gst_ml_qnn_engine_get_output_info (mlqnn->engine);
+      mlcaps = gst_ml_qnn_output_caps (mlqnn);
       break;
     default:
       GST_ERROR_OBJECT (mlqnn, "Invalid pad direction!");
       return NULL;
   }
 
-  // The source and sink pads caps do not depend on each other so directly take
-  // the ML caps from the engine for the corresponding pad and apply filter.
-  mlcaps = gst_ml_info_to_caps (mlinfo);
-
   // Extract the rate.
   value = gst_structure_get_value (gst_caps_get_structure (caps, 0), "rate");
 
@@ -191,8 +223,7 @@ gst_ml_qnn_accept_caps (GstBaseTransform * base, GstPadDirection direction,
     mlinfo = gst_ml_qnn_engine_get_input_info (mlqnn->engine);
     mlcaps = gst_ml_info_to_caps (mlinfo);
   } else if (direction == GST_PAD_SRC) {
-    mlinfo = gst_ml_qnn_engine_get_output_info (mlqnn->engine);
-    mlcaps = gst_ml_info_to_caps (mlinfo);
+    mlcaps = gst_ml_qnn_output_caps (mlqnn);
   }
 
   if (NULL == mlcaps) {
@@ -210,6 +241,30 @@ gst_ml_qnn_accept_caps (GstBaseTransform * base, GstPadDirection direction,
   return TRUE;
 }
 
+static gboolean
+gst_ml_qnn_set_caps (GstBaseTransform * base, GstCaps * incaps,
+    GstCaps * outcaps)
+{
+  GstMLQnn *mlqnn = GST_ML_QNN (base);
+  GstMLInfo info;
+
+  GST_DEBUG_OBJECT (mlqnn, "Output caps: %" GST_PTR_FORMAT, outcaps);
+
+  // Output type is either the native type of the tensors or FLOAT.
+  if (!gst_ml_info_from_caps (&info, outcaps)) {
+    GST_ERROR_OBJECT (mlqnn, "Failed to get output ML info from caps %"
+        GST_PTR_FORMAT "!", outcaps);
+    return FALSE;
+  }
+
+  if (mlqnn->outinfo != NULL)
+    gst_ml_info_free (mlqnn->outinfo);
+
+  mlqnn->outinfo = gst_ml_info_copy (&info);
+
+  return TRUE;
+}
+
 static GstBufferPool *
 gst_ml_qnn_create_pool (GstMLQnn * mlqnn, GstCaps * caps)
 {
@@ -493,10 +548,9 @@ gst_ml_qnn_transform (GstBaseTransform * base, GstBuffer * inbuffer,
     return GST_FLOW_ERROR;
   }
 
-  info = gst_ml_qnn_engine_get_output_info (mlqnn->engine);
-
-  // Create ML frame from output buffer.
-  if (!gst_ml_frame_map (&outframe, info, outbuffer, GST_MAP_READWRITE)) {
+  // Create ML frame from output buffer with the negotiated output type.
+  if (!gst_ml_frame_map (&outframe, mlqnn->outinfo, outbuffer,
+          GST_MAP_READWRITE)) {
     GST_ERROR_OBJECT (mlqnn, "Failed to map output buffer!");
     gst_ml_frame_unmap (&inframe);
     return GST_FLOW_ERROR;
@@ -616,6 +670,9 @@ gst_ml_qnn_finalize (GObject * object)
   if (mlqnn->outpool != NULL)
     gst_object_unref (mlqnn->outpool);
 
+  if (mlqnn->outinfo != NULL)
+    gst_ml_info_free (mlqnn->outinfo);
+
   gst_ml_qnn_engine_free (mlqnn->engine);
   mlqnn->engine = NULL;
 
@@ -680,6 +737,7 @@ gst_ml_qnn_class_init (GstMLQnnClass * klass)
 
   base->transform_caps = GST_DEBUG_FUNCPTR (gst_ml_qnn_transform_caps);
   base->accept_caps = GST_DEBUG_FUNCPTR (gst_ml_qnn_accept_caps);
+  base->set_caps = GST_DEBUG_FUNCPTR (gst_ml_qnn_set_caps);
 
   base->decide_allocation = GST_DEBUG_FUNCPTR (gst_ml_qnn_decide_allocation);
   base->propose_allocation = GST_DEBUG_FUNCPTR (gst_ml_qnn_propose_allocation);
@@ -694,6 +752,7 @@ gst_ml_qnn_init (GstMLQnn * mlqnn)
 {
   mlqnn->outpool = NULL;
   mlqnn->engine = NULL;
+  mlqnn->outinfo = NULL;
 
   mlqnn->model = NULL;
   mlqnn->backend = NULL;
@@ -44,6 +44,9 @@ struct _GstMLQnn {
 
   GstMLQnnEngine    *engine;
 
+  /// Negotiated output ML info, native tensors type or FLOAT.
+  GstMLInfo         *outinfo;
+
   /// Properties.
   gchar             *model;
   gchar             *backend;
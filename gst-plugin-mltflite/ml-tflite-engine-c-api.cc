@@ -89,9 +89,18 @@
   } \
 }
 
-#define DEFAULT_OPT_THREADS  1
-#define DEFAULT_OPT_DELEGATE GST_ML_TFLITE_DELEGATE_NONE
-#define DEFAULT_OPT_PRIORITY GST_ML_TFLITE_PRIORITY_MIN_LATENCY
+// Alignment required by the interpreter for custom tensor allocations.
+#define GST_ML_TFLITE_TENSOR_ALIGNMENT 64
+
+#define GST_ML_TFLITE_ALIGN_PTR(p) GSIZE_TO_POINTER ((GPOINTER_TO_SIZE (p) + \
+    GST_ML_TFLITE_TENSOR_ALIGNMENT - 1) & ~(GST_ML_TFLITE_TENSOR_ALIGNMENT - 1))
+#define GST_ML_TFLITE_IS_ALIGNED(p) \
+    ((GPOINTER_TO_SIZE (p) & (GST_ML_TFLITE_TENSOR_ALIGNMENT - 1)) == 0)
+
+#define DEFAULT_OPT_THREADS      1
+#define DEFAULT_OPT_DELEGATE     GST_ML_TFLITE_DELEGATE_NONE
+#define DEFAULT_OPT_PRIORITY     GST_ML_TFLITE_PRIORITY_MIN_LATENCY
+#define DEFAULT_OPT_INTERPRETERS 1
 
 #define GET_OPT_MODEL(s) get_opt_string (s, \
     GST_ML_TFLITE_ENGINE_OPT_MODEL)
@@ -103,6 +112,8 @@
 #define GET_OPT_PRIORITY(s) get_opt_enum (s, \
     GST_ML_TFLITE_ENGINE_OPT_PRIORITY, GST_TYPE_ML_TFLITE_PRIORITY, \
     DEFAULT_OPT_PRIORITY)
+#define GET_OPT_INTERPRETERS(s) get_opt_uint (s, \
+    GST_ML_TFLITE_ENGINE_OPT_INTERPRETERS, DEFAULT_OPT_INTERPRETERS)
 
 #define GET_OPT_EXT_DELEGATE_PATH(s) get_opt_string (s, \
     GST_ML_TFLITE_ENGINE_OPT_EXT_DELEGATE_PATH)
@@ -156,6 +167,39 @@ using TensorName_fn = decltype (TfLiteTensorName);
 using TensorData_fn = decltype (TfLiteTensorData);
 using Version_fn = decltype (TfLiteVersion);
 
+// Optional experimental APIs, not present in all TFLite library versions.
+using InterpreterSetCustomAllocationForTensor_fn = TfLiteStatus (
+    TfLiteInterpreter *, int, const TfLiteCustomAllocation *, int64_t);
+using InterpreterGetInputTensorIndex_fn = int32_t (
+    const TfLiteInterpreter *, int32_t);
+using InterpreterGetOutputTensorIndex_fn = int32_t (
+    const TfLiteInterpreter *, int32_t);
+
+typedef struct _GstMLTFLiteInterpreter GstMLTFLiteInterpreter;
+
+struct _GstMLTFLiteInterpreter
+{
+  // TFLite model interpreter.
+  TfLiteInterpreter* interpreter;
+
+  // TFLite model delegate.
+  TfLiteDelegate *delegate;
+
+  // Whether frame memory can be bound directly to the tensors.
+  gboolean zerocopy;
+
+  // Memory currently set as custom allocation of each input/output tensor,
+  // NULL while the tensor still uses the memory of the interpreter arena.
+  gpointer inbinds[GST_ML_MAX_TENSORS];
+  gpointer outbinds[GST_ML_MAX_TENSORS];
+
+  // Engine owned tensor memory, used when a bound tensor can't be bound to
+  // the next frame (e.g. misaligned or too small), as the previous frame
+  // memory is no longer owned by us.
+  gpointer inscratch[GST_ML_MAX_TENSORS];
+  gpointer outscratch[GST_ML_MAX_TENSORS];
+};
+
 struct _GstMLTFLiteEngine
 {
   GstMLInfo *ininfo;
@@ -163,14 +207,15 @@ struct _GstMLTFLiteEngine
 
   GstStructure *settings;
 
-  // TFLite model delegate.
-  TfLiteDelegate *delegate;
-
-  // TFLite flatbuffer model.
+  // TFLite flatbuffer model, shared by all interpreters.
   TfLiteModel* model;
 
-  // TFLite model interpreter.
-  TfLiteInterpreter* interpreter;
+  // Interpreters over the same model, each executes one frame at a time.
+  GstMLTFLiteInterpreter *interpreters;
+  guint n_interpreters;
+
+  // Interpreters which are currently not executing a frame.
+  GAsyncQueue *idle;
 
   // TFLite version variables.
   gint major;
@@ -222,6 +267,14 @@ struct _GstMLTFLiteEngine
   TensorData_fn* TensorData;
 
   Version_fn* Version;
+
+  InterpreterSetCustomAllocationForTensor_fn*
+      InterpreterSetCustomAllocationForTensor;
+  InterpreterGetInputTensorIndex_fn* InterpreterGetInputTensorIndex;
+  InterpreterGetOutputTensorIndex_fn* InterpreterGetOutputTensorIndex;
+
+  // Whether the library supports binding memory directly to the tensors.
+  gboolean zerocopy;
 };
 
 static GstDebugCategory *
@@ -329,6 +382,62 @@ load_symbol (gpointer* method, gpointer handle, const gchar* name)
   return TRUE;
 }
 
+static gboolean
+gst_ml_tflite_interpreter_bind_tensor (GstMLTFLiteEngine * engine,
+    GstMLTFLiteInterpreter * interp, gint index, const TfLiteTensor * tensor,
+    gpointer data, gsize size, gpointer * binding, gpointer * scratch,
+    gboolean * rebind)
+{
+  TfLiteCustomAllocation allocation;
+  TfLiteStatus status = kTfLiteOk;
+  gboolean bindable = FALSE;
+
+  // Frame memory is bound only if it is aligned and large enough.
+  bindable = interp->zerocopy && (data != NULL) &&
+      GST_ML_TFLITE_IS_ALIGNED (data) &&
+      (size >= tensor->bytes) && (tensor->allocation_type != kTfLiteDynamic);
+
+  if (!bindable) {
+    // Tensor still uses the arena memory, copy is required.
+    if (*binding == NULL)
+      return FALSE;
+
+    if (*scratch == NULL)
+      *scratch = g_malloc (tensor->bytes + GST_ML_TFLITE_TENSOR_ALIGNMENT);
+
+    data = GST_ML_TFLITE_ALIGN_PTR (*scratch);
+    size = tensor->bytes;
+  }
+
+  if (*binding == data)
+    return bindable;
+
+  allocation.data = data;
+  allocation.bytes = size;
+
+  status = engine->InterpreterSetCustomAllocationForTensor (
+      interp->interpreter, index, &allocation,
+      kTfLiteCustomAllocationFlagsNone);
+
+  if (status != kTfLiteOk) {
+    GST_WARNING ("Failed to bind memory to tensor %d, disable zero-copy!",
+        index);
+    interp->zerocopy = FALSE;
+    return FALSE;
+  }
+
+  GST_TRACE ("Bound %s memory %p to tensor %d", bindable ? "frame" : "scratch",
+      data, index);
+
+  // Only the switch away from the arena requires the tensors to be allocated.
+  // Afterwards the custom allocation only updates the tensor data pointer,
+  // so rotating pool buffers are rebound without calling AllocateTensors.
+  *rebind |= (*binding == NULL);
+  *binding = data;
+
+  return bindable;
+}
+
 static GstMLType
 gst_ml_type_from_tflite_type (TfLiteType type)
 {
@@ -398,6 +507,12 @@ gst_ml_frame_convert_to_float (GstMLFrame *mlframe, guint idx,
 {
   float *output = NULL;
   size_t n_elements = 0;
+  GstMLType mltype = gst_ml_type_from_tflite_type (type);
+
+  if (mltype == GST_ML_TYPE_UNKNOWN) {
+    GST_ERROR ("Data type not supported yet!");
+    return;
+  }
 
   output = reinterpret_cast<float *>(GST_ML_FRAME_BLOCK_DATA (mlframe, idx));
   n_elements = gst_ml_info_tensor_size (&(mlframe->info), idx);
@@ -407,103 +522,7 @@ gst_ml_frame_convert_to_float (GstMLFrame *mlframe, guint idx,
   GST_LOG ("Converting original tensor from %s to FLOAT32",
       gst_ml_tflite_type_to_string (type));
 
-  switch (type) {
-    case kTfLiteUInt8:
-    {
-      uint8_t *data = reinterpret_cast<uint8_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-    case kTfLiteInt8:
-    {
-      int8_t *data = reinterpret_cast<int8_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-    case kTfLiteUInt16:
-    {
-      uint16_t *data = reinterpret_cast<uint16_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-    case kTfLiteInt16:
-    {
-      int16_t *data = reinterpret_cast<int16_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-#if TF_MAJOR_VERSION > 2 || (TF_MAJOR_VERSION == 2 && TF_MINOR_VERSION >= 5)
-    case kTfLiteUInt32:
-    {
-      uint32_t *data = reinterpret_cast<uint32_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-#endif // TF_MAJOR_VERSION > 2 || (TF_MAJOR_VERSION == 2 && TF_MINOR_VERSION >= 5)
-    case kTfLiteInt32:
-    {
-      int32_t *data = reinterpret_cast<int32_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-    case kTfLiteUInt64:
-    {
-      uint64_t *data = reinterpret_cast<uint64_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-    case kTfLiteInt64:
-    {
-      int64_t *data = reinterpret_cast<int64_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-#if defined(__ARM_FP16_FORMAT_IEEE)
-    case kTfLiteFloat16:
-    {
-      __fp16 *data = reinterpret_cast<__fp16 *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = data[idx];
-
-      break;
-    }
-#endif  // defined(__ARM_FP16_FORMAT_IEEE)
-    case kTfLiteFloat32:
-    {
-      memcpy (output, tensor_data, sizeof (float) * n_elements);
-      break;
-    }
-    default:
-      GST_ERROR ("Data type not supported yet!");
-      break;
-  }
-
-  return;
+  gst_ml_dequantize (mltype, tensor_data, output, n_elements, scale, offset);
 }
 
 static gboolean
@@ -592,6 +611,26 @@ gst_ml_tflite_initialize_library (GstMLTFLiteEngine * engine)
   success &= load_symbol ((gpointer*)&engine->Version,
       engine->libhandle, "TfLiteVersion");
 
+  // Zero-copy of the tensors is possible only with the experimental APIs.
+  engine->InterpreterSetCustomAllocationForTensor =
+      (InterpreterSetCustomAllocationForTensor_fn*) dlsym (engine->libhandle,
+          "TfLiteInterpreterSetCustomAllocationForTensor");
+  engine->InterpreterGetInputTensorIndex =
+      (InterpreterGetInputTensorIndex_fn*) dlsym (engine->libhandle,
+          "TfLiteInterpreterGetInputTensorIndex");
+  engine->InterpreterGetOutputTensorIndex =
+      (InterpreterGetOutputTensorIndex_fn*) dlsym (engine->libhandle,
+          "TfLiteInterpreterGetOutputTensorIndex");
+
+  engine->zerocopy = (engine->InterpreterSetCustomAllocationForTensor != NULL)
+      && (engine->InterpreterGetInputTensorIndex != NULL)
+      && (engine->InterpreterGetOutputTensorIndex != NULL);
+
+  if (!engine->zerocopy) {
+    GST_INFO ("Custom tensor allocations not supported, tensors are copied");
+    engine->InterpreterSetCustomAllocationForTensor = NULL;
+  }
+
   std::string version_str = engine->Version ();
 
   engine->major = std::stoi (version_str);
@@ -737,13 +776,74 @@ gst_ml_tflite_engine_delegate_free (GstMLTFLiteEngine * engine,
   return;
 }
 
+static gboolean
+gst_ml_tflite_interpreter_init (GstMLTFLiteEngine * engine,
+    GstMLTFLiteInterpreter * interp)
+{
+  gint n_threads = 1;
+
+  TfLiteInterpreterOptions* options = engine->InterpreterOptionsCreate ();
+
+  interp->interpreter = engine->InterpreterCreate (engine->model, options);
+
+  GST_ML_RETURN_VAL_IF_FAIL_WITH_CLEAN (interp->interpreter, FALSE,
+      engine->InterpreterOptionsDelete (options),
+      "Failed to construct interpreter!");
+
+  n_threads = GET_OPT_STHREADS (engine->settings);
+
+  engine->InterpreterOptionsSetNumThreads (options, n_threads);
+  GST_DEBUG ("Number of interpreter threads: %u", n_threads);
+
+  interp->delegate = gst_ml_tflite_engine_delegate_new (engine,
+      engine->settings);
+
+  if (interp->delegate != NULL)
+    engine->InterpreterOptionsAddDelegate (options, interp->delegate);
+
+  engine->InterpreterOptionsDelete (options);
+
+  if (interp->delegate != NULL) {
+    TfLiteStatus status =
+        engine->InterpreterModifyGraphWithDelegate(interp->interpreter,
+            interp->delegate);
+
+    GST_ML_RETURN_VAL_IF_FAIL (status == TfLiteStatus::kTfLiteOk, FALSE,
+        "Failed to modify graph with delegate!");
+  }
+
+  GST_ML_RETURN_VAL_IF_FAIL (engine->InterpreterAllocateTensors (
+      interp->interpreter) == kTfLiteOk, FALSE, "Failed to allocate tensors!");
+
+  interp->zerocopy = engine->zerocopy;
+
+  return TRUE;
+}
+
+static void
+gst_ml_tflite_interpreter_deinit (GstMLTFLiteEngine * engine,
+    GstMLTFLiteInterpreter * interp)
+{
+  if (interp->interpreter != NULL)
+    engine->InterpreterDelete (interp->interpreter);
+
+  for (guint idx = 0; idx < GST_ML_MAX_TENSORS; ++idx) {
+    g_free (interp->inscratch[idx]);
+    g_free (interp->outscratch[idx]);
+  }
+
+  gst_ml_tflite_engine_delegate_free (engine, interp->delegate,
+      GET_OPT_DELEGATE (engine->settings));
+}
+
 GstMLTFLiteEngine *
 gst_ml_tflite_engine_new (GstStructure * settings)
 {
   GstMLTFLiteEngine *engine = NULL;
+  TfLiteInterpreter *interpreter = NULL;
   const gchar *filename = NULL;
   guint idx = 0;
-  gint num = 0, n_threads = 1;
+  gint num = 0;
 
   engine = g_slice_new0 (GstMLTFLiteEngine);
   g_return_val_if_fail (engine != NULL, NULL);
@@ -772,49 +872,34 @@ gst_ml_tflite_engine_new (GstStructure * settings)
 
   GST_DEBUG ("Loaded model file '%s'!", filename);
 
-  TfLiteInterpreterOptions* options = engine->InterpreterOptionsCreate ();
-
-  engine->interpreter = engine->InterpreterCreate (engine->model, options);
-
-  GST_ML_RETURN_VAL_IF_FAIL_WITH_CLEAN (engine->interpreter, NULL,
-      gst_ml_tflite_engine_free (engine), "Failed to construct interpreter!");
+  engine->n_interpreters = GET_OPT_INTERPRETERS (engine->settings);
+  engine->interpreters =
+      g_new0 (GstMLTFLiteInterpreter, engine->n_interpreters);
+  engine->idle = g_async_queue_new ();
 
-  n_threads = GET_OPT_STHREADS (engine->settings);
+  for (idx = 0; idx < engine->n_interpreters; ++idx) {
+    GstMLTFLiteInterpreter *interp = &(engine->interpreters[idx]);
 
-  engine->InterpreterOptionsSetNumThreads (options, n_threads);
-  GST_DEBUG ("Number of interpreter threads: %u", n_threads);
-
-  engine->delegate = gst_ml_tflite_engine_delegate_new (engine,
-      engine->settings);
+    GST_ML_RETURN_VAL_IF_FAIL_WITH_CLEAN (
+        gst_ml_tflite_interpreter_init (engine, interp), NULL,
+        gst_ml_tflite_engine_free (engine), "Failed to create interpreter %u!",
+        idx);
 
-  if (engine->delegate != NULL)
-    engine->InterpreterOptionsAddDelegate (options, engine->delegate);
-
-  engine->InterpreterOptionsDelete (options);
-
-  if (engine->delegate != NULL) {
-    TfLiteStatus status =
-        engine->InterpreterModifyGraphWithDelegate(engine->interpreter,
-            engine->delegate);
-
-    if (status != TfLiteStatus::kTfLiteOk) {
-      GST_WARNING ("Failed to modify graph with delegate!");
-      gst_ml_tflite_engine_free (engine);
-      return NULL;
-    }
+    g_async_queue_push (engine->idle, interp);
   }
 
-  GST_ML_RETURN_VAL_IF_FAIL_WITH_CLEAN (engine->InterpreterAllocateTensors (
-      engine->interpreter) == kTfLiteOk, NULL, gst_ml_tflite_engine_free (
-          engine), "Failed to allocate tensors!");
+  GST_DEBUG ("Number of interpreters: %u", engine->n_interpreters);
 
-  engine->ininfo->n_tensors = engine->InterpreterGetInputTensorCount (
-      engine->interpreter);
-  engine->outinfo->n_tensors = engine->InterpreterGetOutputTensorCount (
-      engine->interpreter);
+  // All interpreters are identical, query the tensors from the first one.
+  interpreter = engine->interpreters[0].interpreter;
+
+  engine->ininfo->n_tensors =
+      engine->InterpreterGetInputTensorCount (interpreter);
+  engine->outinfo->n_tensors =
+      engine->InterpreterGetOutputTensorCount (interpreter);
 
   TfLiteTensor* input_tensor =
-      engine->InterpreterGetInputTensor (engine->interpreter, 0);
+      engine->InterpreterGetInputTensor (interpreter, 0);
 
   engine->ininfo->type =
       gst_ml_type_from_tflite_type (engine->TensorType (input_tensor));
@@ -825,7 +910,7 @@ gst_ml_tflite_engine_new (GstStructure * settings)
   }
 
   const TfLiteTensor* output_tensor =
-      engine->InterpreterGetOutputTensor (engine->interpreter, 0);
+      engine->InterpreterGetOutputTensor (interpreter, 0);
 
   engine->outinfo->type =
       gst_ml_type_from_tflite_type (engine->TensorType (output_tensor));
@@ -841,7 +926,7 @@ gst_ml_tflite_engine_new (GstStructure * settings)
 
   for (idx = 0; idx < engine->ininfo->n_tensors; ++idx) {
     TfLiteTensor* tensor = engine->InterpreterGetInputTensor (
-        engine->interpreter, idx);
+        interpreter, idx);
 
     auto dimensions_size = engine->TensorNumDims (tensor);
 
@@ -862,7 +947,7 @@ gst_ml_tflite_engine_new (GstStructure * settings)
 
   for (idx = 0; idx < engine->outinfo->n_tensors; ++idx) {
     const TfLiteTensor* tensor =
-        engine->InterpreterGetOutputTensor (engine->interpreter, idx);
+        engine->InterpreterGetOutputTensor (interpreter, idx);
 
     auto dimensions_size = engine->TensorNumDims (tensor);
 
@@ -887,15 +972,18 @@ gst_ml_tflite_engine_free (GstMLTFLiteEngine * engine)
   if (NULL == engine)
     return;
 
-  if (engine->interpreter != NULL)
-    engine->InterpreterDelete (engine->interpreter);
+  for (guint idx = 0; engine->interpreters != NULL &&
+      idx < engine->n_interpreters; ++idx)
+    gst_ml_tflite_interpreter_deinit (engine, &(engine->interpreters[idx]));
+
+  g_free (engine->interpreters);
+
+  if (engine->idle != NULL)
+    g_async_queue_unref (engine->idle);
 
   if (engine->model != NULL)
     engine->ModelDelete (engine->model);
 
-  gst_ml_tflite_engine_delegate_free (engine, engine->delegate,
-      GET_OPT_DELEGATE (engine->settings));
-
   if (engine->libhandle != NULL)
     dlclose(engine->libhandle);
 
@@ -961,44 +1049,71 @@ gst_ml_tflite_engine_get_output_caps  (GstMLTFLiteEngine * engine)
   return caps;
 }
 
-gboolean
-gst_ml_tflite_engine_execute (GstMLTFLiteEngine * engine,
-    GstMLFrame * inframe, GstMLFrame * outframe)
+static gboolean
+gst_ml_tflite_interpreter_execute (GstMLTFLiteEngine * engine,
+    GstMLTFLiteInterpreter * interp, GstMLFrame * inframe,
+    GstMLFrame * outframe)
 {
   GstMLTensorMeta *mlmeta = NULL;
-  gboolean success = FALSE;
+  gboolean inbound[GST_ML_MAX_TENSORS] = { FALSE, };
+  gboolean outbound[GST_ML_MAX_TENSORS] = { FALSE, };
+  gboolean success = FALSE, rebind = FALSE;
   guint idx = 0;
 
-  g_return_val_if_fail (engine != NULL, FALSE);
-  g_return_val_if_fail (inframe != NULL, FALSE);
-  g_return_val_if_fail (outframe != NULL, FALSE);
+  // Bind the frame memory directly to the tensors where it is possible.
+  for (idx = 0; (engine->InterpreterSetCustomAllocationForTensor != NULL) &&
+      (idx < engine->ininfo->n_tensors); ++idx) {
+    TfLiteTensor* tensor = engine->InterpreterGetInputTensor (
+        interp->interpreter, idx);
 
-  if (GST_ML_FRAME_N_BLOCKS (inframe) != engine->ininfo->n_tensors) {
-    GST_WARNING ("Input buffer has %u memory blocks but engine requires %u!",
-        GST_ML_FRAME_N_BLOCKS (inframe), engine->ininfo->n_tensors);
-    return FALSE;
+    inbound[idx] = gst_ml_tflite_interpreter_bind_tensor (engine, interp,
+        engine->InterpreterGetInputTensorIndex (interp->interpreter, idx),
+        tensor, GST_ML_FRAME_BLOCK_DATA (inframe, idx),
+        GST_ML_FRAME_BLOCK_SIZE (inframe, idx), &(interp->inbinds[idx]),
+        &(interp->inscratch[idx]), &rebind);
   }
 
-  if (GST_ML_FRAME_N_BLOCKS (outframe) != engine->outinfo->n_tensors) {
-    GST_WARNING ("Output buffer has %u memory blocks but engine requires %u!",
-        GST_ML_FRAME_N_BLOCKS (outframe), engine->outinfo->n_tensors);
+  for (idx = 0; (engine->InterpreterSetCustomAllocationForTensor != NULL) &&
+      (idx < engine->outinfo->n_tensors); ++idx) {
+    const TfLiteTensor* tensor = engine->InterpreterGetOutputTensor (
+        interp->interpreter, idx);
+    gpointer data = NULL;
+
+    // Output tensor is bound to the frame memory only when the output frame
+    // type equals the tensor type. Otherwise the tensor is left on the arena
+    // (or scratch) memory and its contents are converted into the frame.
+    if (gst_ml_type_from_tflite_type (tensor->type) == outframe->info.type)
+      data = GST_ML_FRAME_BLOCK_DATA (outframe, idx);
+
+    outbound[idx] = gst_ml_tflite_interpreter_bind_tensor (engine, interp,
+        engine->InterpreterGetOutputTensorIndex (interp->interpreter, idx),
+        tensor, data, GST_ML_FRAME_BLOCK_SIZE (outframe, idx),
+        &(interp->outbinds[idx]), &(interp->outscratch[idx]), &rebind);
+  }
+
+  // Tensors switched from the arena to custom allocations take effect after
+  // the tensors are allocated, later rebinds take effect immediately.
+  if (rebind && (engine->InterpreterAllocateTensors (
+          interp->interpreter) != kTfLiteOk)) {
+    GST_ERROR ("Failed to allocate tensors with custom allocations!");
     return FALSE;
   }
 
   for (idx = 0; idx < engine->ininfo->n_tensors; ++idx) {
     TfLiteTensor* tensor = engine->InterpreterGetInputTensor (
-        engine->interpreter, idx);
+        interp->interpreter, idx);
     guint size = gst_ml_info_tensor_size (&(inframe->info), idx);
 
-    memcpy (engine->TensorData (tensor), GST_ML_FRAME_BLOCK_DATA (inframe, idx),
-        size);
+    if (!inbound[idx])
+      memcpy (engine->TensorData (tensor),
+          GST_ML_FRAME_BLOCK_DATA (inframe, idx), size);
 
     mlmeta = gst_buffer_get_ml_tensor_meta_id (inframe->buffer, idx);
     mlmeta->name = g_quark_from_string (engine->TensorName (tensor));
   }
 
   success = (0 == engine->InterpreterInvoke (
-      engine->interpreter));
+      interp->interpreter));
 
   if (!success) {
     GST_ERROR ("Model execution failed!");
@@ -1007,7 +1122,7 @@ gst_ml_tflite_engine_execute (GstMLTFLiteEngine * engine,
 
   for (idx = 0; idx < engine->outinfo->n_tensors; ++idx) {
     const TfLiteTensor* tensor = engine->InterpreterGetOutputTensor (
-        engine->interpreter, idx);
+        interp->interpreter, idx);
     gfloat scale = 1.0f, offset = 0.0f;
 
     if (tensor->quantization.type != kTfLiteNoQuantization) {
@@ -1015,8 +1130,15 @@ gst_ml_tflite_engine_execute (GstMLTFLiteEngine * engine,
       offset = tensor->params.zero_point;
     }
 
-    gst_ml_frame_convert_to_float (outframe, idx, engine->TensorData (tensor),
-        tensor->type, scale, offset);
+    // Native output type, the quantized data is passed as it is.
+    if (!outbound[idx] &&
+        (gst_ml_type_from_tflite_type (tensor->type) == outframe->info.type))
+      memcpy (GST_ML_FRAME_BLOCK_DATA (outframe, idx),
+          engine->TensorData (tensor),
+          gst_ml_info_tensor_size (&(outframe->info), idx));
+    else if (!outbound[idx])
+      gst_ml_frame_convert_to_float (outframe, idx,
+          engine->TensorData (tensor), tensor->type, scale, offset);
 
     mlmeta = gst_buffer_get_ml_tensor_meta_id (outframe->buffer, idx);
     mlmeta->name = g_quark_from_string (engine->TensorName (tensor));
@@ -1030,3 +1152,39 @@ gst_ml_tflite_engine_execute (GstMLTFLiteEngine * engine,
 
   return success;
 }
+
+gboolean
+gst_ml_tflite_engine_execute (GstMLTFLiteEngine * engine,
+    GstMLFrame * inframe, GstMLFrame * outframe)
+{
+  GstMLTFLiteInterpreter *interp = NULL;
+  gboolean success = FALSE;
+
+  g_return_val_if_fail (engine != NULL, FALSE);
+  g_return_val_if_fail (inframe != NULL, FALSE);
+  g_return_val_if_fail (outframe != NULL, FALSE);
+
+  if (GST_ML_FRAME_N_BLOCKS (inframe) != engine->ininfo->n_tensors) {
+    GST_WARNING ("Input buffer has %u memory blocks but engine requires %u!",
+        GST_ML_FRAME_N_BLOCKS (inframe), engine->ininfo->n_tensors);
+    return FALSE;
+  }
+
+  if (GST_ML_FRAME_N_BLOCKS (outframe) != engine->outinfo->n_tensors) {
+    GST_WARNING ("Output buffer has %u memory blocks but engine requires %u!",
+        GST_ML_FRAME_N_BLOCKS (outframe), engine->outinfo->n_tensors);
+    return FALSE;
+  }
+
+  // Wait for an interpreter to become available, the same interpreter
+  // can't execute more than one frame at a time.
+  interp = (GstMLTFLiteInterpreter *) g_async_queue_pop (engine->idle);
+
+  GST_TRACE ("Executing on interpreter %p", interp);
+  success = gst_ml_tflite_interpreter_execute (engine, interp, inframe,
+      outframe);
+
+  g_async_queue_push (engine->idle, interp);
+
+  return success;
+}
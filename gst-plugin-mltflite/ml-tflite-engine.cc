@@ -91,9 +91,23 @@
   } \
 }
 
-#define DEFAULT_OPT_THREADS  1
-#define DEFAULT_OPT_DELEGATE GST_ML_TFLITE_DELEGATE_NONE
-#define DEFAULT_OPT_PRIORITY GST_ML_TFLITE_PRIORITY_MIN_LATENCY
+// Custom tensor allocations appeared in TFLite 2.6 together with the flags.
+#if !defined(HAVE_TFLITE_VERSION_H) || TF_MAJOR_VERSION > 2 || (TF_MAJOR_VERSION == 2 && TF_MINOR_VERSION >= 6)
+#define HAVE_TFLITE_CUSTOM_ALLOCATION
+#endif // !defined(HAVE_TFLITE_VERSION_H) || TF_MAJOR_VERSION > 2 || (TF_MAJOR_VERSION == 2 && TF_MINOR_VERSION >= 6)
+
+// Alignment required by the interpreter for custom tensor allocations.
+#define GST_ML_TFLITE_TENSOR_ALIGNMENT 64
+
+#define GST_ML_TFLITE_ALIGN_PTR(p) GSIZE_TO_POINTER ((GPOINTER_TO_SIZE (p) + \
+    GST_ML_TFLITE_TENSOR_ALIGNMENT - 1) & ~(GST_ML_TFLITE_TENSOR_ALIGNMENT - 1))
+#define GST_ML_TFLITE_IS_ALIGNED(p) \
+    ((GPOINTER_TO_SIZE (p) & (GST_ML_TFLITE_TENSOR_ALIGNMENT - 1)) == 0)
+
+#define DEFAULT_OPT_THREADS      1
+#define DEFAULT_OPT_DELEGATE     GST_ML_TFLITE_DELEGATE_NONE
+#define DEFAULT_OPT_PRIORITY     GST_ML_TFLITE_PRIORITY_MIN_LATENCY
+#define DEFAULT_OPT_INTERPRETERS 1
 
 #define GET_OPT_MODEL(s) get_opt_string (s, \
     GST_ML_TFLITE_ENGINE_OPT_MODEL)
@@ -105,6 +119,8 @@
 #define GET_OPT_PRIORITY(s) get_opt_enum (s, \
     GST_ML_TFLITE_ENGINE_OPT_PRIORITY, GST_TYPE_ML_TFLITE_PRIORITY, \
     DEFAULT_OPT_PRIORITY)
+#define GET_OPT_INTERPRETERS(s) get_opt_uint (s, \
+    GST_ML_TFLITE_ENGINE_OPT_INTERPRETERS, DEFAULT_OPT_INTERPRETERS)
 
 #ifdef HAVE_EXTERNAL_DELEGATE_H
 #define GET_OPT_EXT_DELEGATE_PATH(s) get_opt_string (s, \
@@ -116,6 +132,32 @@
 
 #define GST_CAT_DEFAULT gst_ml_tflite_engine_debug_category()
 
+typedef struct _GstMLTFLiteInterpreter GstMLTFLiteInterpreter;
+
+struct _GstMLTFLiteInterpreter
+{
+  // TFLite model interpreter.
+  // Raw pointer to c++ unique_ptr because struct is allocated via malloc.
+  tflite::Interpreter *interpreter;
+
+  // TFLite model delegate.
+  TfLiteDelegate *delegate;
+
+  // Whether frame memory can be bound directly to the tensors.
+  gboolean zerocopy;
+
+  // Memory currently set as custom allocation of each input/output tensor,
+  // NULL while the tensor still uses the memory of the interpreter arena.
+  gpointer inbinds[GST_ML_MAX_TENSORS];
+  gpointer outbinds[GST_ML_MAX_TENSORS];
+
+  // Engine owned tensor memory, used when a bound tensor can't be bound to
+  // the next frame (e.g. misaligned or too small), as the previous frame
+  // memory is no longer owned by us.
+  gpointer inscratch[GST_ML_MAX_TENSORS];
+  gpointer outscratch[GST_ML_MAX_TENSORS];
+};
+
 struct _GstMLTFLiteEngine
 {
   GstMLInfo *ininfo;
@@ -123,16 +165,16 @@ struct _GstMLTFLiteEngine
 
   GstStructure *settings;
 
-  // TFLite flatbuffer model.
+  // TFLite flatbuffer model, shared by all interpreters.
   // Raw pointer to c++ unique_ptr because struct is allocated via malloc.
   tflite::FlatBufferModel *model;
 
-  // TFLite model interpreter.
-  // Raw pointer to c++ unique_ptr because struct is allocated via malloc.
-  tflite::Interpreter *interpreter;
+  // Interpreters over the same model, each executes one frame at a time.
+  GstMLTFLiteInterpreter *interpreters;
+  guint n_interpreters;
 
-  // TFLite model delegate.
-  TfLiteDelegate *delegate;
+  // Interpreters which are currently not executing a frame.
+  GAsyncQueue *idle;
 };
 
 static GstDebugCategory *
@@ -248,121 +290,6 @@ gst_ml_tflite_type_to_string (TfLiteType type)
   }
 }
 
-static void
-gst_ml_tflite_convert_to_float (GstMLFrame *mlframe, guint idx,
-    void *tensor_data, TfLiteType type, float scale, float offset)
-{
-  float *output = NULL;
-  size_t n_elements = 0;
-
-  output = reinterpret_cast<float *>(GST_ML_FRAME_BLOCK_DATA (mlframe, idx));
-  n_elements = gst_ml_info_tensor_size (&(mlframe->info), idx);
-  n_elements /= gst_ml_type_get_size (mlframe->info.type);
-
-  GST_LOG ("Dequantization params: scale %f, offset %f", scale, offset);
-  GST_LOG ("Converting original tensor from %s to FLOAT32",
-      gst_ml_tflite_type_to_string (type));
-
-  switch (type) {
-    case kTfLiteUInt8:
-    {
-      uint8_t *data = reinterpret_cast<uint8_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-    case kTfLiteInt8:
-    {
-      int8_t *data = reinterpret_cast<int8_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-    case kTfLiteUInt16:
-    {
-      uint16_t *data = reinterpret_cast<uint16_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-    case kTfLiteInt16:
-    {
-      int16_t *data = reinterpret_cast<int16_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-#if TF_MAJOR_VERSION > 2 || (TF_MAJOR_VERSION == 2 && TF_MINOR_VERSION >= 5)
-    case kTfLiteUInt32:
-    {
-      uint32_t *data = reinterpret_cast<uint32_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-#endif // TF_MAJOR_VERSION > 2 || (TF_MAJOR_VERSION == 2 && TF_MINOR_VERSION >= 5)
-    case kTfLiteInt32:
-    {
-      int32_t *data = reinterpret_cast<int32_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-    case kTfLiteUInt64:
-    {
-      uint64_t *data = reinterpret_cast<uint64_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-    case kTfLiteInt64:
-    {
-      int64_t *data = reinterpret_cast<int64_t *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = (static_cast<float>(data[idx]) - offset) * scale;
-
-      break;
-    }
-#if defined(__ARM_FP16_FORMAT_IEEE)
-    case kTfLiteFloat16:
-    {
-      __fp16 *data = reinterpret_cast<__fp16 *>(tensor_data);
-
-      for (size_t idx = 0; idx < n_elements; idx++)
-        output[idx] = data[idx];
-
-      break;
-    }
-#endif  // defined(__ARM_FP16_FORMAT_IEEE)
-    case kTfLiteFloat32:
-    {
-      memcpy (output, tensor_data, sizeof (float) * n_elements);
-
-      break;
-    }
-    default:
-      GST_ERROR ("Data type not supported yet!");
-      break;
-  }
-
-  return;
-}
-
 static const gchar *
 get_opt_string (GstStructure * settings, const gchar * opt)
 {
@@ -395,6 +322,60 @@ get_opt_structure (GstStructure * settings, const gchar * opt)
 }
 #endif // HAVE_EXTERNAL_DELEGATE_H
 
+#ifdef HAVE_TFLITE_CUSTOM_ALLOCATION
+static gboolean
+gst_ml_tflite_interpreter_bind_tensor (GstMLTFLiteInterpreter * interp,
+    gint index, gpointer data, gsize size, gpointer * binding,
+    gpointer * scratch, gboolean * rebind)
+{
+  TfLiteTensor *tensor = interp->interpreter->tensor(index);
+  TfLiteCustomAllocation allocation;
+  gboolean bindable = FALSE;
+
+  // Frame memory is bound only if it is aligned and large enough.
+  bindable = interp->zerocopy && (data != NULL) &&
+      GST_ML_TFLITE_IS_ALIGNED (data) &&
+      (size >= tensor->bytes) && (tensor->allocation_type != kTfLiteDynamic);
+
+  if (!bindable) {
+    // Tensor still uses the arena memory, copy is required.
+    if (*binding == NULL)
+      return FALSE;
+
+    if (*scratch == NULL)
+      *scratch = g_malloc (tensor->bytes + GST_ML_TFLITE_TENSOR_ALIGNMENT);
+
+    data = GST_ML_TFLITE_ALIGN_PTR (*scratch);
+    size = tensor->bytes;
+  }
+
+  if (*binding == data)
+    return bindable;
+
+  allocation.data = data;
+  allocation.bytes = size;
+
+  if (interp->interpreter->SetCustomAllocationForTensor(index, allocation)
+          != kTfLiteOk) {
+    GST_WARNING ("Failed to bind memory to tensor %d, disable zero-copy!",
+        index);
+    interp->zerocopy = FALSE;
+    return FALSE;
+  }
+
+  GST_TRACE ("Bound %s memory %p to tensor %d", bindable ? "frame" : "scratch",
+      data, index);
+
+  // Only the switch away from the arena requires the tensors to be allocated.
+  // Afterwards the custom allocation only updates the tensor data pointer,
+  // so rotating pool buffers are rebound without calling AllocateTensors.
+  *rebind |= (*binding == NULL);
+  *binding = data;
+
+  return bindable;
+}
+#endif // HAVE_TFLITE_CUSTOM_ALLOCATION
+
 static GstMLType
 tflite_to_ml_type (TfLiteType type)
 {
@@ -427,6 +408,30 @@ tflite_to_ml_type (TfLiteType type)
   }
 }
 
+static void
+gst_ml_tflite_convert_to_float (GstMLFrame *mlframe, guint idx,
+    void *tensor_data, TfLiteType type, float scale, float offset)
+{
+  float *output = NULL;
+  size_t n_elements = 0;
+  GstMLType mltype = tflite_to_ml_type (type);
+
+  if (mltype == GST_ML_TYPE_UNKNOWN) {
+    GST_ERROR ("Data type not supported yet!");
+    return;
+  }
+
+  output = reinterpret_cast<float *>(GST_ML_FRAME_BLOCK_DATA (mlframe, idx));
+  n_elements = gst_ml_info_tensor_size (&(mlframe->info), idx);
+  n_elements /= gst_ml_type_get_size (mlframe->info.type);
+
+  GST_LOG ("Dequantization params: scale %f, offset %f", scale, offset);
+  GST_LOG ("Converting original tensor from %s to FLOAT32",
+      gst_ml_tflite_type_to_string (type));
+
+  gst_ml_dequantize (mltype, tensor_data, output, n_elements, scale, offset);
+}
+
 static TfLiteDelegate *
 gst_ml_tflite_engine_delegate_new (GstStructure * settings)
 {
@@ -644,14 +649,72 @@ gst_ml_tflite_engine_delegate_free (TfLiteDelegate * delegate, gint type)
   return;
 }
 
+static gboolean
+gst_ml_tflite_interpreter_init (GstMLTFLiteEngine * engine,
+    GstMLTFLiteInterpreter * interp)
+{
+  gint n_threads = 1;
+
+  tflite::ops::builtin::BuiltinOpResolver resolver;
+
+  std::unique_ptr<tflite::Interpreter> interpreter;
+  tflite::InterpreterBuilder builder (engine->model->GetModel(), resolver);
+
+  builder (&interpreter);
+  interp->interpreter = interpreter.release();
+
+  GST_ML_RETURN_VAL_IF_FAIL (interp->interpreter, FALSE,
+      "Failed to construct interpreter!");
+
+  n_threads = GET_OPT_STHREADS (engine->settings);
+
+  interp->interpreter->SetNumThreads(n_threads);
+  GST_DEBUG ("Number of interpreter threads: %u", n_threads);
+
+  interp->delegate = gst_ml_tflite_engine_delegate_new(engine->settings);
+
+  if (interp->delegate != NULL) {
+    TfLiteStatus status =
+        interp->interpreter->ModifyGraphWithDelegate(interp->delegate);
+
+    if (status != TfLiteStatus::kTfLiteOk)
+      GST_WARNING ("Failed to modify graph with delegate!");
+  }
+
+  GST_ML_RETURN_VAL_IF_FAIL (
+      interp->interpreter->AllocateTensors() == kTfLiteOk, FALSE,
+      "Failed to allocate tensors!");
+
+#ifdef HAVE_TFLITE_CUSTOM_ALLOCATION
+  interp->zerocopy = TRUE;
+#endif // HAVE_TFLITE_CUSTOM_ALLOCATION
+
+  return TRUE;
+}
+
+static void
+gst_ml_tflite_interpreter_deinit (GstMLTFLiteEngine * engine,
+    GstMLTFLiteInterpreter * interp)
+{
+  if (interp->interpreter != NULL)
+    delete interp->interpreter;
+
+  for (guint idx = 0; idx < GST_ML_MAX_TENSORS; ++idx) {
+    g_free (interp->inscratch[idx]);
+    g_free (interp->outscratch[idx]);
+  }
+
+  gst_ml_tflite_engine_delegate_free (interp->delegate,
+      GET_OPT_DELEGATE (engine->settings));
+}
+
 GstMLTFLiteEngine *
 gst_ml_tflite_engine_new (GstStructure * settings)
 {
   GstMLTFLiteEngine *engine = NULL;
+  tflite::Interpreter *interpreter = NULL;
   const gchar *filename = NULL;
-  gint idx = 0, num = 0, n_threads = 1;
-
-  tflite::ops::builtin::BuiltinOpResolver resolver;
+  gint idx = 0, num = 0;
 
   engine = g_slice_new0 (GstMLTFLiteEngine);
   g_return_val_if_fail (engine != NULL, NULL);
@@ -673,51 +736,52 @@ gst_ml_tflite_engine_new (GstStructure * settings)
 
   GST_DEBUG ("Loaded model file '%s'!", filename);
 
-  std::unique_ptr<tflite::Interpreter> interpreter;
-  tflite::InterpreterBuilder builder (engine->model->GetModel(), resolver);
+  engine->n_interpreters = GET_OPT_INTERPRETERS (engine->settings);
 
-  builder (&interpreter);
-  engine->interpreter = interpreter.release();
-
-  GST_ML_RETURN_VAL_IF_FAIL_WITH_CLEAN (engine->interpreter, NULL,
-      gst_ml_tflite_engine_free (engine), "Failed to construct interpreter!");
-
-  n_threads = GET_OPT_STHREADS (engine->settings);
+#ifdef HAVE_HEXAGON_DELEGATE_H
+  // The Hexagon delegate initializes and tears down a global DSP session.
+  if ((GET_OPT_DELEGATE (engine->settings) == GST_ML_TFLITE_DELEGATE_HEXAGON)
+      && (engine->n_interpreters > 1)) {
+    GST_WARNING ("Hexagon delegate supports only a single interpreter!");
+    engine->n_interpreters = 1;
+  }
+#endif // HAVE_HEXAGON_DELEGATE_H
 
-  engine->interpreter->SetNumThreads(n_threads);
-  GST_DEBUG ("Number of interpreter threads: %u", n_threads);
+  engine->interpreters =
+      g_new0 (GstMLTFLiteInterpreter, engine->n_interpreters);
+  engine->idle = g_async_queue_new ();
 
-  engine->delegate = gst_ml_tflite_engine_delegate_new(engine->settings);
+  for (guint idx = 0; idx < engine->n_interpreters; ++idx) {
+    GstMLTFLiteInterpreter *interp = &(engine->interpreters[idx]);
 
-  if (engine->delegate != NULL) {
-    TfLiteStatus status =
-        engine->interpreter->ModifyGraphWithDelegate(engine->delegate);
+    GST_ML_RETURN_VAL_IF_FAIL_WITH_CLEAN (
+        gst_ml_tflite_interpreter_init (engine, interp), NULL,
+        gst_ml_tflite_engine_free (engine), "Failed to create interpreter %u!",
+        idx);
 
-    if (status != TfLiteStatus::kTfLiteOk)
-      GST_WARNING ("Failed to modify graph with delegate!");
+    g_async_queue_push (engine->idle, interp);
   }
 
-  GST_ML_RETURN_VAL_IF_FAIL_WITH_CLEAN (
-      engine->interpreter->AllocateTensors() == kTfLiteOk, NULL,
-      gst_ml_tflite_engine_free (engine), "Failed to allocate tensors!");
+  GST_DEBUG ("Number of interpreters: %u", engine->n_interpreters);
+
+  // All interpreters are identical, query the tensors from the first one.
+  interpreter = engine->interpreters[0].interpreter;
 
-  engine->ininfo->n_tensors = engine->interpreter->inputs().size();
-  engine->outinfo->n_tensors = engine->interpreter->outputs().size();
+  engine->ininfo->n_tensors = interpreter->inputs().size();
+  engine->outinfo->n_tensors = interpreter->outputs().size();
 
-  idx = engine->interpreter->inputs()[0];
+  idx = interpreter->inputs()[0];
 
-  engine->ininfo->type =
-      tflite_to_ml_type (engine->interpreter->tensor(idx)->type);
+  engine->ininfo->type = tflite_to_ml_type (interpreter->tensor(idx)->type);
 
   if (engine->ininfo->type == GST_ML_TYPE_UNKNOWN) {
     gst_ml_tflite_engine_free (engine);
     return NULL;
   }
 
-  idx = engine->interpreter->outputs()[0];
+  idx = interpreter->outputs()[0];
 
-  engine->outinfo->type =
-      tflite_to_ml_type (engine->interpreter->tensor(idx)->type);
+  engine->outinfo->type = tflite_to_ml_type (interpreter->tensor(idx)->type);
 
   if (engine->outinfo->type == GST_ML_TYPE_UNKNOWN) {
     gst_ml_tflite_engine_free (engine);
@@ -729,13 +793,13 @@ gst_ml_tflite_engine_new (GstStructure * settings)
       gst_ml_type_to_string (engine->ininfo->type));
 
   for (guint idx = 0; idx < engine->ininfo->n_tensors; ++idx) {
-    gint input = engine->interpreter->inputs()[idx];
-    TfLiteIntArray* dimensions = engine->interpreter->tensor(input)->dims;
+    gint input = interpreter->inputs()[idx];
+    TfLiteIntArray* dimensions = interpreter->tensor(input)->dims;
 
     engine->ininfo->n_dimensions[idx] = dimensions->size;
 
     GST_DEBUG ("Input tensor[%u] name: %s", idx,
-        engine->interpreter->GetInputName (idx));
+        interpreter->GetInputName (idx));
 
     for (num = 0; num < dimensions->size; ++num) {
       engine->ininfo->tensors[idx][num] = dimensions->data[num];
@@ -749,13 +813,13 @@ gst_ml_tflite_engine_new (GstStructure * settings)
       gst_ml_type_to_string (engine->outinfo->type));
 
   for (guint idx = 0; idx < engine->outinfo->n_tensors; ++idx) {
-    gint output = engine->interpreter->outputs()[idx];
-    TfLiteIntArray* dimensions = engine->interpreter->tensor(output)->dims;
+    gint output = interpreter->outputs()[idx];
+    TfLiteIntArray* dimensions = interpreter->tensor(output)->dims;
 
     engine->outinfo->n_dimensions[idx] = dimensions->size;
 
     GST_DEBUG ("Output tensor[%u] name: %s", idx,
-        engine->interpreter->GetOutputName (idx));
+        interpreter->GetOutputName (idx));
 
     for (num = 0; num < dimensions->size; ++num) {
       engine->outinfo->tensors[idx][num] = dimensions->data[num];
@@ -774,15 +838,18 @@ gst_ml_tflite_engine_free (GstMLTFLiteEngine * engine)
   if (NULL == engine)
     return;
 
-  if (engine->interpreter != NULL)
-    delete engine->interpreter;
+  for (guint idx = 0; engine->interpreters != NULL &&
+      idx < engine->n_interpreters; ++idx)
+    gst_ml_tflite_interpreter_deinit (engine, &(engine->interpreters[idx]));
+
+  g_free (engine->interpreters);
+
+  if (engine->idle != NULL)
+    g_async_queue_unref (engine->idle);
 
   if (engine->model != NULL)
     delete engine->model;
 
-  gst_ml_tflite_engine_delegate_free (engine->delegate,
-      GET_OPT_DELEGATE (engine->settings));
-
   if (engine->outinfo != NULL) {
     gst_ml_info_free (engine->outinfo);
     engine->outinfo = NULL;
@@ -845,48 +912,71 @@ gst_ml_tflite_engine_get_output_caps  (GstMLTFLiteEngine * engine)
   return caps;
 }
 
-gboolean
-gst_ml_tflite_engine_execute (GstMLTFLiteEngine * engine,
-    GstMLFrame * inframe, GstMLFrame * outframe)
+static gboolean
+gst_ml_tflite_interpreter_execute (GstMLTFLiteEngine * engine,
+    GstMLTFLiteInterpreter * interp, GstMLFrame * inframe,
+    GstMLFrame * outframe)
 {
   GstMLTensorMeta *mlmeta = NULL;
-  gboolean success = FALSE;
+  gboolean inbound[GST_ML_MAX_TENSORS] = { FALSE, };
+  gboolean outbound[GST_ML_MAX_TENSORS] = { FALSE, };
+  gboolean success = FALSE, rebind = FALSE;
   guint idx = 0;
 
-  g_return_val_if_fail (engine != NULL, FALSE);
-  g_return_val_if_fail (inframe != NULL, FALSE);
-  g_return_val_if_fail (outframe != NULL, FALSE);
+#ifdef HAVE_TFLITE_CUSTOM_ALLOCATION
+  // Bind the frame memory directly to the tensors where it is possible.
+  for (idx = 0; idx < engine->ininfo->n_tensors; ++idx) {
+    inbound[idx] = gst_ml_tflite_interpreter_bind_tensor (interp,
+        interp->interpreter->inputs()[idx],
+        GST_ML_FRAME_BLOCK_DATA (inframe, idx),
+        GST_ML_FRAME_BLOCK_SIZE (inframe, idx), &(interp->inbinds[idx]),
+        &(interp->inscratch[idx]), &rebind);
+  }
 
-  if (GST_ML_FRAME_N_BLOCKS (inframe) != engine->ininfo->n_tensors) {
-    GST_WARNING ("Input buffer has %u memory blocks but engine requires %u!",
-        GST_ML_FRAME_N_BLOCKS (inframe), engine->ininfo->n_tensors);
-    return FALSE;
+  for (idx = 0; idx < engine->outinfo->n_tensors; ++idx) {
+    gint output = interp->interpreter->outputs()[idx];
+    TfLiteTensor *tensor = interp->interpreter->tensor(output);
+
+    gpointer data = NULL;
+
+    // Output tensor is bound to the frame memory only when the output frame
+    // type equals the tensor type. Otherwise the tensor is left on the arena
+    // (or scratch) memory and its contents are converted into the frame.
+    if (tflite_to_ml_type (tensor->type) == outframe->info.type)
+      data = GST_ML_FRAME_BLOCK_DATA (outframe, idx);
+
+    outbound[idx] = gst_ml_tflite_interpreter_bind_tensor (interp, output,
+        data, GST_ML_FRAME_BLOCK_SIZE (outframe, idx),
+        &(interp->outbinds[idx]), &(interp->outscratch[idx]), &rebind);
   }
 
-  if (GST_ML_FRAME_N_BLOCKS (outframe) != engine->outinfo->n_tensors) {
-    GST_WARNING ("Output buffer has %u memory blocks but engine requires %u!",
-        GST_ML_FRAME_N_BLOCKS (outframe), engine->outinfo->n_tensors);
+  // Tensors switched from the arena to custom allocations take effect after
+  // the tensors are allocated, later rebinds take effect immediately.
+  if (rebind && (interp->interpreter->AllocateTensors() != kTfLiteOk)) {
+    GST_ERROR ("Failed to allocate tensors with custom allocations!");
     return FALSE;
   }
+#endif // HAVE_TFLITE_CUSTOM_ALLOCATION
 
   for (idx = 0; idx < engine->ininfo->n_tensors; ++idx) {
-    gint input = engine->interpreter->inputs()[idx];
-    TfLiteTensor *tensor = engine->interpreter->tensor(input);
+    gint input = interp->interpreter->inputs()[idx];
+    TfLiteTensor *tensor = interp->interpreter->tensor(input);
     guint size = gst_ml_info_tensor_size (&(inframe->info), idx);
 
-    memcpy (tensor->data.raw, GST_ML_FRAME_BLOCK_DATA (inframe, idx), size);
+    if (!inbound[idx])
+      memcpy (tensor->data.raw, GST_ML_FRAME_BLOCK_DATA (inframe, idx), size);
 
     mlmeta = gst_buffer_get_ml_tensor_meta_id (inframe->buffer, idx);
     mlmeta->name =
-        g_quark_from_string (engine->interpreter->GetInputName (idx));
+        g_quark_from_string (interp->interpreter->GetInputName (idx));
   }
 
-  if (!(success = (engine->interpreter->Invoke() == 0)))
+  if (!(success = (interp->interpreter->Invoke() == 0)))
     GST_ERROR ("Model execution failed!");
 
   for (idx = 0; idx < engine->outinfo->n_tensors; ++idx) {
-    gint output = engine->interpreter->outputs()[idx];
-    TfLiteTensor *tensor = engine->interpreter->tensor(output);
+    gint output = interp->interpreter->outputs()[idx];
+    TfLiteTensor *tensor = interp->interpreter->tensor(output);
     gfloat scale = 1.0f, offset = 0.0f;
 
     if (tensor->quantization.type != kTfLiteNoQuantization) {
@@ -894,12 +984,18 @@ gst_ml_tflite_engine_execute (GstMLTFLiteEngine * engine,
       offset = tensor->params.zero_point;
     }
 
-    gst_ml_tflite_convert_to_float (outframe, idx, tensor->data.raw,
-        tensor->type, scale, offset);
+    // Native output type, the quantized data is passed as it is.
+    if (!outbound[idx] &&
+        (tflite_to_ml_type (tensor->type) == outframe->info.type))
+      memcpy (GST_ML_FRAME_BLOCK_DATA (outframe, idx), tensor->data.raw,
+          gst_ml_info_tensor_size (&(outframe->info), idx));
+    else if (!outbound[idx])
+      gst_ml_tflite_convert_to_float (outframe, idx, tensor->data.raw,
+          tensor->type, scale, offset);
 
     mlmeta = gst_buffer_get_ml_tensor_meta_id (outframe->buffer, idx);
     mlmeta->name =
-        g_quark_from_string (engine->interpreter->GetOutputName (idx));
+        g_quark_from_string (interp->interpreter->GetOutputName (idx));
 
     if (outframe->info.type != GST_ML_TYPE_FLOAT32 &&
         outframe->info.type != GST_ML_TYPE_FLOAT16) {
@@ -910,3 +1006,39 @@ gst_ml_tflite_engine_execute (GstMLTFLiteEngine * engine,
 
   return success;
 }
+
+gboolean
+gst_ml_tflite_engine_execute (GstMLTFLiteEngine * engine,
+    GstMLFrame * inframe, GstMLFrame * outframe)
+{
+  GstMLTFLiteInterpreter *interp = NULL;
+  gboolean success = FALSE;
+
+  g_return_val_if_fail (engine != NULL, FALSE);
+  g_return_val_if_fail (inframe != NULL, FALSE);
+  g_return_val_if_fail (outframe != NULL, FALSE);
+
+  if (GST_ML_FRAME_N_BLOCKS (inframe) != engine->ininfo->n_tensors) {
+    GST_WARNING ("Input buffer has %u memory blocks but engine requires %u!",
+        GST_ML_FRAME_N_BLOCKS (inframe), engine->ininfo->n_tensors);
+    return FALSE;
+  }
+
+  if (GST_ML_FRAME_N_BLOCKS (outframe) != engine->outinfo->n_tensors) {
+    GST_WARNING ("Output buffer has %u memory blocks but engine requires %u!",
+        GST_ML_FRAME_N_BLOCKS (outframe), engine->outinfo->n_tensors);
+    return FALSE;
+  }
+
+  // Wait for an interpreter to become available, the same interpreter
+  // can't execute more than one frame at a time.
+  interp = (GstMLTFLiteInterpreter *) g_async_queue_pop (engine->idle);
+
+  GST_TRACE ("Executing on interpreter %p", interp);
+  success = gst_ml_tflite_interpreter_execute (engine, interp, inframe,
+      outframe);
+
+  g_async_queue_push (engine->idle, interp);
+
+  return success;
+}
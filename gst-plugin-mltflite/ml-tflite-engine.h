@@ -39,6 +39,7 @@
 #include <gst/allocators/allocators.h>
 #include <gst/ml/ml-info.h>
 #include <gst/ml/ml-frame.h>
+#include <gst/ml/ml-quantize.h>
 #include <gst/ml/gstmlmeta.h>
 #if defined(HAVE_TFLITE_VERSION_H)
 #include <tensorflow/lite/version.h>
@@ -121,6 +122,16 @@ GST_API GType gst_ml_tflite_delegate_get_type (void);
 #define GST_ML_TFLITE_ENGINE_OPT_THREADS \
     "GstMLTFLiteEngine.threads"
 
+/**
+ * GST_ML_TFLITE_ENGINE_OPT_INTERPRETERS:
+ *
+ * #G_TYPE_UINT, number of interpreters created over the shared model, which
+ * allows up to that many frames to be executed in parallel
+ * Default: 1
+ */
+#define GST_ML_TFLITE_ENGINE_OPT_INTERPRETERS \
+    "GstMLTFLiteEngine.interpreters"
+
 /**
  * GstMLTFLitePriority:
  * @GST_ML_TFLITE_PRIORITY_MAX_PRECISION : Model precision will be set to 32 bit (FP32)
@@ -51,6 +51,7 @@ G_DEFINE_TYPE (GstMLTFLite, gst_ml_tflite, GST_TYPE_BASE_TRANSFORM);
 #define DEFAULT_PROP_MODEL       NULL
 #define DEFAULT_PROP_DELEGATE    GST_ML_TFLITE_DELEGATE_NONE
 #define DEFAULT_PROP_THREADS     1
+#define DEFAULT_PROP_INTERPRETERS 1
 #define DEFAULT_PROP_PRIORITY    GST_ML_TFLITE_PRIORITY_MIN_LATENCY
 
 #ifdef HAVE_EXTERNAL_DELEGATE_H
@@ -78,12 +79,25 @@ enum
   PROP_DELEGATE,
   PROP_THREADS,
   PROP_PRIORITY,
+  PROP_INTERPRETERS,
 #ifdef HAVE_EXTERNAL_DELEGATE_H
   PROP_EXT_DELEGATE_PATH,
   PROP_EXT_DELEGATE_OPTS,
 #endif // HAVE_EXTERNAL_DELEGATE_H
 };
 
+typedef struct _GstMLTFLiteRequest GstMLTFLiteRequest;
+
+struct _GstMLTFLiteRequest {
+  // Input and output buffers of this request.
+  GstBuffer     *inbuffer;
+  GstBuffer     *outbuffer;
+
+  // Whether execution finished and the result of it.
+  gboolean      done;
+  GstFlowReturn ret;
+};
+
 static GstStaticCaps gst_ml_tflite_static_caps =
     GST_STATIC_CAPS (GST_ML_TFLITE_CAPS);
 
@@ -134,6 +148,7 @@ gst_ml_tflite_create_pool (GstMLTFLite * tflite, GstCaps * caps)
   GstStructure *config = NULL;
   GstAllocator *allocator = NULL;
   GstMLInfo info;
+  guint minbuffers = 0;
 
   if (!gst_ml_info_from_caps (&info, caps)) {
     GST_ERROR_OBJECT (tflite, "Invalid caps %" GST_PTR_FORMAT, caps);
@@ -143,9 +158,12 @@ gst_ml_tflite_create_pool (GstMLTFLite * tflite, GstCaps * caps)
   GST_INFO_OBJECT (tflite, "Uses DMA memory");
   pool = gst_ml_buffer_pool_new (GST_ML_BUFFER_POOL_TYPE_DMA);
 
+  // Each interpreter holds one output buffer while executing.
+  minbuffers = MAX (DEFAULT_PROP_MIN_BUFFERS, tflite->n_interpreters + 1);
+
   config = gst_buffer_pool_get_config (pool);
   gst_buffer_pool_config_set_params (config, caps, gst_ml_info_size (&info),
-      DEFAULT_PROP_MIN_BUFFERS, DEFAULT_PROP_MAX_BUFFERS);
+      minbuffers, MAX (DEFAULT_PROP_MAX_BUFFERS, minbuffers));
 
   allocator = gst_fd_allocator_new ();
 
@@ -174,7 +192,7 @@ gst_ml_tflite_propose_allocation (GstBaseTransform * base,
   GstCaps *caps = NULL;
   GstBufferPool *pool = NULL;
   GstMLInfo info;
-  guint size = 0;
+  guint size = 0, minbuffers = 0;
   gboolean needpool = FALSE;
 
   if (!GST_BASE_TRANSFORM_CLASS (parent_class)->propose_allocation (
@@ -221,8 +239,12 @@ gst_ml_tflite_propose_allocation (GstBaseTransform * base,
     }
   }
 
+  // Each interpreter holds one input buffer while executing.
+  minbuffers = (tflite->n_interpreters > 1) ? tflite->n_interpreters : 0;
+
   // If upstream does't have a pool requirement, set only size in query.
-  gst_query_add_allocation_pool (outquery, needpool ? pool : NULL, size, 0, 0);
+  gst_query_add_allocation_pool (outquery, needpool ? pool : NULL, size,
+      minbuffers, 0);
 
   if (pool != NULL)
     gst_object_unref (pool);
@@ -450,6 +472,253 @@ gst_ml_tflite_set_caps (GstBaseTransform * base, GstCaps * incaps,
   return TRUE;
 }
 
+static GstFlowReturn
+gst_ml_tflite_execute (GstMLTFLite * tflite, GstBuffer * inbuffer,
+    GstBuffer * outbuffer)
+{
+  GstMLFrame inframe, outframe;
+  GstClockTime ts_begin = GST_CLOCK_TIME_NONE, ts_end = GST_CLOCK_TIME_NONE;
+  GstClockTimeDiff tsdelta = GST_CLOCK_STIME_NONE;
+  gboolean success = FALSE;
+
+  // Create ML frame from input buffer.
+  if (!gst_ml_frame_map (&inframe, tflite->ininfo, inbuffer, GST_MAP_READ)) {
+    GST_ERROR_OBJECT (tflite, "Failed to map input buffer!");
+    return GST_FLOW_ERROR;
+  }
+
+  // Create ML frame from output buffer.
+  if (!gst_ml_frame_map (&outframe, tflite->outinfo, outbuffer, GST_MAP_READWRITE)) {
+    GST_ERROR_OBJECT (tflite, "Failed to map output buffer!");
+    gst_ml_frame_unmap (&inframe);
+    return GST_FLOW_ERROR;
+  }
+
+  ts_begin = gst_util_get_timestamp ();
+
+  success = gst_ml_tflite_engine_execute (tflite->engine, &inframe, &outframe);
+
+  ts_end = gst_util_get_timestamp ();
+
+  gst_ml_frame_unmap (&outframe);
+  gst_ml_frame_unmap (&inframe);
+
+  if (!success) {
+    GST_ERROR_OBJECT (tflite, "Failed to execute!");
+    return GST_FLOW_ERROR;
+  }
+
+  tsdelta = GST_CLOCK_DIFF (ts_begin, ts_end);
+
+  GST_LOG_OBJECT (tflite, "Execute took %" G_GINT64_FORMAT ".%03"
+      G_GINT64_FORMAT " ms", GST_TIME_AS_MSECONDS (tsdelta),
+      (GST_TIME_AS_USECONDS (tsdelta) % 1000));
+
+  return GST_FLOW_OK;
+}
+
+static void
+gst_ml_tflite_request_free (GstMLTFLiteRequest * request)
+{
+  if (request->outbuffer != NULL)
+    gst_buffer_unref (request->outbuffer);
+
+  gst_buffer_unref (request->inbuffer);
+  g_slice_free (GstMLTFLiteRequest, request);
+}
+
+static void
+gst_ml_tflite_push_requests (GstMLTFLite * tflite)
+{
+  GstMLTFLiteRequest *request = NULL;
+  GstBuffer *outbuffer = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  // Only one thread at a time pushes, otherwise the order may be lost.
+  g_mutex_lock (&tflite->pushlock);
+  g_mutex_lock (&tflite->lock);
+
+  // Push all completed requests from the head of the queue.
+  while (((request = g_queue_peek_head (tflite->requests)) != NULL) &&
+         request->done) {
+    g_queue_pop_head (tflite->requests);
+
+    ret = (request->ret != GST_FLOW_OK) ? request->ret : tflite->flowret;
+    g_mutex_unlock (&tflite->lock);
+
+    outbuffer = request->outbuffer;
+    request->outbuffer = NULL;
+
+    if (ret == GST_FLOW_OK)
+      ret = gst_pad_push (GST_BASE_TRANSFORM_SRC_PAD (tflite), outbuffer);
+    else
+      gst_buffer_unref (outbuffer);
+
+    gst_ml_tflite_request_free (request);
+
+    g_mutex_lock (&tflite->lock);
+
+    // Keep the first non OK flow return, it is returned on the next buffer.
+    if (tflite->flowret == GST_FLOW_OK)
+      tflite->flowret = ret;
+
+    g_cond_broadcast (&tflite->wakeup);
+  }
+
+  g_mutex_unlock (&tflite->lock);
+  g_mutex_unlock (&tflite->pushlock);
+}
+
+static void
+gst_ml_tflite_drain_requests (GstMLTFLite * tflite)
+{
+  g_mutex_lock (&tflite->lock);
+
+  while (!g_queue_is_empty (tflite->requests)) {
+    GST_DEBUG_OBJECT (tflite, "Waiting for %u requests to finish",
+        g_queue_get_length (tflite->requests));
+    g_cond_wait (&tflite->wakeup, &tflite->lock);
+  }
+
+  g_mutex_unlock (&tflite->lock);
+}
+
+static void
+gst_ml_tflite_worker (gpointer data, gpointer userdata)
+{
+  GstMLTFLite *tflite = GST_ML_TFLITE (userdata);
+  GstMLTFLiteRequest *request = data;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  ret = gst_ml_tflite_execute (tflite, request->inbuffer, request->outbuffer);
+
+  g_mutex_lock (&tflite->lock);
+
+  request->ret = ret;
+  request->done = TRUE;
+
+  g_mutex_unlock (&tflite->lock);
+
+  gst_ml_tflite_push_requests (tflite);
+}
+
+static GstFlowReturn
+gst_ml_tflite_generate_output (GstBaseTransform * base, GstBuffer ** outbuffer)
+{
+  GstMLTFLite *tflite = GST_ML_TFLITE (base);
+  GstMLTFLiteRequest *request = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+  gboolean done = FALSE;
+
+  // Single interpreter, execute synchronously in the streaming thread.
+  if ((NULL == tflite->workers) || gst_base_transform_is_passthrough (base))
+    return GST_BASE_TRANSFORM_CLASS (parent_class)->generate_output (
+        base, outbuffer);
+
+  // Nothing queued by the submit_input_buffer() method. The QoS decision is
+  // taken there, before a request is created, so late buffers are dropped
+  // without waiting for an idle interpreter.
+  if (NULL == base->queued_buf)
+    return GST_FLOW_OK;
+
+  request = g_slice_new0 (GstMLTFLiteRequest);
+
+  request->inbuffer = base->queued_buf;
+  base->queued_buf = NULL;
+
+  ret = gst_ml_tflite_prepare_output_buffer (base, request->inbuffer,
+      &(request->outbuffer));
+
+  if (ret != GST_FLOW_OK) {
+    gst_ml_tflite_request_free (request);
+    return ret;
+  }
+
+  // GAP buffer, nothing to execute but it still needs to be pushed in order.
+  request->done = done = gst_buffer_get_size (request->outbuffer) == 0 &&
+      GST_BUFFER_FLAG_IS_SET (request->outbuffer, GST_BUFFER_FLAG_GAP);
+
+  g_mutex_lock (&tflite->lock);
+
+  // Wait until there is an idle interpreter for this request.
+  while ((tflite->flowret == GST_FLOW_OK) &&
+         (g_queue_get_length (tflite->requests) >= tflite->n_interpreters))
+    g_cond_wait (&tflite->wakeup, &tflite->lock);
+
+  if ((ret = tflite->flowret) != GST_FLOW_OK) {
+    g_mutex_unlock (&tflite->lock);
+
+    GST_DEBUG_OBJECT (tflite, "Dropping buffer, flow return: %s",
+        gst_flow_get_name (ret));
+
+    gst_ml_tflite_request_free (request);
+    return ret;
+  }
+
+  g_queue_push_tail (tflite->requests, request);
+
+  if (!done)
+    g_thread_pool_push (tflite->workers, request, NULL);
+
+  g_mutex_unlock (&tflite->lock);
+
+  // The request may be owned by a worker thread at this point, don't touch it.
+  if (done)
+    gst_ml_tflite_push_requests (tflite);
+
+  // Output buffers are pushed downstream by the worker threads.
+  *outbuffer = NULL;
+  return GST_FLOW_OK;
+}
+
+static gboolean
+gst_ml_tflite_sink_event (GstBaseTransform * base, GstEvent * event)
+{
+  GstMLTFLite *tflite = GST_ML_TFLITE (base);
+
+  if (NULL == tflite->workers)
+    return GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (base, event);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_FLUSH_START:
+      g_mutex_lock (&tflite->lock);
+      tflite->flowret = GST_FLOW_FLUSHING;
+      g_cond_broadcast (&tflite->wakeup);
+      g_mutex_unlock (&tflite->lock);
+      break;
+    case GST_EVENT_FLUSH_STOP:
+      gst_ml_tflite_drain_requests (tflite);
+
+      g_mutex_lock (&tflite->lock);
+      tflite->flowret = GST_FLOW_OK;
+      g_mutex_unlock (&tflite->lock);
+      break;
+    default:
+      // Serialized events (e.g. EOS) must not overtake pending requests.
+      if (GST_EVENT_IS_SERIALIZED (event))
+        gst_ml_tflite_drain_requests (tflite);
+      break;
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (base, event);
+}
+
+static gboolean
+gst_ml_tflite_query (GstBaseTransform * base, GstPadDirection direction,
+    GstQuery * query)
+{
+  GstMLTFLite *tflite = GST_ML_TFLITE (base);
+
+  // Serialized queries (e.g. ALLOCATION, DRAIN) must not overtake pending
+  // requests, otherwise they are answered before the preceding buffers.
+  if ((tflite->workers != NULL) && (direction == GST_PAD_SINK) &&
+      GST_QUERY_IS_SERIALIZED (query))
+    gst_ml_tflite_drain_requests (tflite);
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->query (base, direction,
+      query);
+}
+
 static GstStateChangeReturn
 gst_ml_tflite_change_state (GstElement * element, GstStateChange transition)
 {
@@ -468,6 +737,8 @@ gst_ml_tflite_change_state (GstElement * element, GstStateChange transition)
           tflite->n_threads,
           GST_ML_TFLITE_ENGINE_OPT_PRIORITY, GST_TYPE_ML_TFLITE_PRIORITY,
           tflite->priority,
+          GST_ML_TFLITE_ENGINE_OPT_INTERPRETERS, G_TYPE_UINT,
+          tflite->n_interpreters,
           NULL);
 
       if (settings == NULL) {
@@ -491,8 +762,30 @@ gst_ml_tflite_change_state (GstElement * element, GstStateChange transition)
         GST_ERROR_OBJECT (tflite, "Failed to create engine!");
         return GST_STATE_CHANGE_FAILURE;
       }
+
+      // Additional interpreters are driven by a dedicated worker each.
+      if (tflite->n_interpreters > 1) {
+        GError *error = NULL;
+
+        tflite->workers = g_thread_pool_new (gst_ml_tflite_worker, tflite,
+            tflite->n_interpreters, TRUE, &error);
+
+        if (tflite->workers == NULL) {
+          GST_ERROR_OBJECT (tflite, "Failed to create worker threads, "
+              "error: '%s'!", GST_STR_NULL (error->message));
+          g_clear_error (&error);
+          return GST_STATE_CHANGE_FAILURE;
+        }
+      }
       break;
     }
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      // Unblock the streaming thread if it waits for a free interpreter.
+      g_mutex_lock (&tflite->lock);
+      tflite->flowret = GST_FLOW_FLUSHING;
+      g_cond_broadcast (&tflite->wakeup);
+      g_mutex_unlock (&tflite->lock);
+      break;
     default:
       break;
   }
@@ -500,7 +793,19 @@ gst_ml_tflite_change_state (GstElement * element, GstStateChange transition)
   ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
 
   switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_ml_tflite_drain_requests (tflite);
+
+      g_mutex_lock (&tflite->lock);
+      tflite->flowret = GST_FLOW_OK;
+      g_mutex_unlock (&tflite->lock);
+      break;
     case GST_STATE_CHANGE_READY_TO_NULL:
+      if (tflite->workers != NULL)
+        g_thread_pool_free (tflite->workers, FALSE, TRUE);
+
+      tflite->workers = NULL;
+
       gst_ml_tflite_engine_free (tflite->engine);
       tflite->engine = NULL;
       break;
@@ -516,50 +821,13 @@ gst_ml_tflite_transform (GstBaseTransform * base, GstBuffer * inbuffer,
     GstBuffer * outbuffer)
 {
   GstMLTFLite *tflite = GST_ML_TFLITE (base);
-  GstMLFrame inframe, outframe;
-  GstClockTime ts_begin = GST_CLOCK_TIME_NONE, ts_end = GST_CLOCK_TIME_NONE;
-  GstClockTimeDiff tsdelta = GST_CLOCK_STIME_NONE;
-  gboolean success = FALSE;
 
   // GAP buffer, nothing to do. Propagate output buffer downstream.
   if (gst_buffer_get_size (outbuffer) == 0 &&
       GST_BUFFER_FLAG_IS_SET (outbuffer, GST_BUFFER_FLAG_GAP))
     return GST_FLOW_OK;
 
-  // Create ML frame from input buffer.
-  if (!gst_ml_frame_map (&inframe, tflite->ininfo, inbuffer, GST_MAP_READ)) {
-    GST_ERROR_OBJECT (tflite, "Failed to map input buffer!");
-    return GST_FLOW_ERROR;
-  }
-
-  // Create ML frame from output buffer.
-  if (!gst_ml_frame_map (&outframe, tflite->outinfo, outbuffer, GST_MAP_READWRITE)) {
-    GST_ERROR_OBJECT (tflite, "Failed to map output buffer!");
-    gst_ml_frame_unmap (&inframe);
-    return GST_FLOW_ERROR;
-  }
-
-  ts_begin = gst_util_get_timestamp ();
-
-  success = gst_ml_tflite_engine_execute (tflite->engine, &inframe, &outframe);
-
-  ts_end = gst_util_get_timestamp ();
-
-  gst_ml_frame_unmap (&outframe);
-  gst_ml_frame_unmap (&inframe);
-
-  if (!success) {
-    GST_ERROR_OBJECT (tflite, "Failed to execute!");
-    return GST_FLOW_ERROR;
-  }
-
-  tsdelta = GST_CLOCK_DIFF (ts_begin, ts_end);
-
-  GST_LOG_OBJECT (tflite, "Execute took %" G_GINT64_FORMAT ".%03"
-      G_GINT64_FORMAT " ms", GST_TIME_AS_MSECONDS (tsdelta),
-      (GST_TIME_AS_USECONDS (tsdelta) % 1000));
-
-  return GST_FLOW_OK;
+  return gst_ml_tflite_execute (tflite, inbuffer, outbuffer);
 }
 
 static void
@@ -582,6 +850,9 @@ gst_ml_tflite_set_property (GObject * object, guint prop_id,
     case PROP_PRIORITY:
       tflite->priority = g_value_get_enum (value);
       break;
+    case PROP_INTERPRETERS:
+      tflite->n_interpreters = g_value_get_uint (value);
+      break;
 #ifdef HAVE_EXTERNAL_DELEGATE_H
     case PROP_EXT_DELEGATE_PATH:
       g_free (tflite->ext_delegate_path);
@@ -621,6 +892,9 @@ gst_ml_tflite_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_PRIORITY:
       g_value_set_enum (value, tflite->priority);
       break;
+    case PROP_INTERPRETERS:
+      g_value_set_uint (value, tflite->n_interpreters);
+      break;
 #ifdef HAVE_EXTERNAL_DELEGATE_H
     case PROP_EXT_DELEGATE_PATH:
       g_value_set_string (value, tflite->ext_delegate_path);
@@ -666,6 +940,13 @@ gst_ml_tflite_finalize (GObject * object)
   if (tflite->outpool != NULL)
     gst_object_unref (tflite->outpool);
 
+  g_queue_free_full (tflite->requests,
+      (GDestroyNotify) gst_ml_tflite_request_free);
+
+  g_cond_clear (&tflite->wakeup);
+  g_mutex_clear (&tflite->pushlock);
+  g_mutex_clear (&tflite->lock);
+
   g_free (tflite->model);
 
   G_OBJECT_CLASS (parent_class)->finalize (G_OBJECT (tflite));
@@ -700,6 +981,12 @@ gst_ml_tflite_class_init (GstMLTFLiteClass * klass)
           "Set inference priority explicitly for gpu delegate precision only",
           GST_TYPE_ML_TFLITE_PRIORITY, DEFAULT_PROP_PRIORITY,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject, PROP_INTERPRETERS,
+      g_param_spec_uint ("n-interpreters", "Interpreters",
+          "Number of interpreters executing buffers in parallel, outputs are "
+          "still pushed in order. Hexagon delegate uses a single interpreter",
+          1, 8, DEFAULT_PROP_INTERPRETERS,
+          G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 #ifdef HAVE_EXTERNAL_DELEGATE_H
   g_object_class_install_property (gobject, PROP_EXT_DELEGATE_PATH,
       g_param_spec_string ("external-delegate-path", "External Delegate Path",
@@ -739,6 +1026,10 @@ gst_ml_tflite_class_init (GstMLTFLiteClass * klass)
   base->accept_caps = GST_DEBUG_FUNCPTR (gst_ml_tflite_accept_caps);
   base->set_caps = GST_DEBUG_FUNCPTR (gst_ml_tflite_set_caps);
 
+  base->sink_event = GST_DEBUG_FUNCPTR (gst_ml_tflite_sink_event);
+  base->query = GST_DEBUG_FUNCPTR (gst_ml_tflite_query);
+
+  base->generate_output = GST_DEBUG_FUNCPTR (gst_ml_tflite_generate_output);
   base->transform = GST_DEBUG_FUNCPTR (gst_ml_tflite_transform);
 }
 
@@ -750,6 +1041,14 @@ gst_ml_tflite_init (GstMLTFLite * tflite)
   tflite->ininfo = NULL;
   tflite->outinfo = NULL;
 
+  tflite->workers = NULL;
+  tflite->requests = g_queue_new ();
+  tflite->flowret = GST_FLOW_OK;
+
+  g_mutex_init (&tflite->lock);
+  g_mutex_init (&tflite->pushlock);
+  g_cond_init (&tflite->wakeup);
+
   tflite->model = DEFAULT_PROP_MODEL;
   tflite->delegate = DEFAULT_PROP_DELEGATE;
   tflite->priority = DEFAULT_PROP_PRIORITY;
@@ -758,6 +1057,7 @@ gst_ml_tflite_init (GstMLTFLite * tflite)
   tflite->ext_delegate_opts = DEFAULT_PROP_EXT_DELEGATE_OPTS;
 #endif // HAVE_EXTERNAL_DELEGATE_H
   tflite->n_threads = DEFAULT_PROP_THREADS;
+  tflite->n_interpreters = DEFAULT_PROP_INTERPRETERS;
 
   // Handle buffers with GAP flag internally.
   gst_base_transform_set_gap_aware (GST_BASE_TRANSFORM (tflite), TRUE);
@@ -70,6 +70,19 @@ struct _GstMLTFLite {
   GstMLInfo           *ininfo;
   GstMLInfo           *outinfo;
 
+  /// Worker threads executing requests in parallel, one per interpreter.
+  GThreadPool         *workers;
+  /// Requests in order of submission, pushed downstream in that order.
+  GQueue              *requests;
+  /// Global mutex protecting the requests queue and the flow return.
+  GMutex              lock;
+  /// Mutex serializing the push of completed requests downstream.
+  GMutex              pushlock;
+  /// Condition signalled each time a request is removed from the queue.
+  GCond               wakeup;
+  /// Flow return of the last push, returned upstream on the next buffer.
+  GstFlowReturn       flowret;
+
   /// Properties.
   gchar               *model;
 #ifdef HAVE_EXTERNAL_DELEGATE_H
@@ -79,6 +92,7 @@ struct _GstMLTFLite {
   GstMLTFLiteDelegate delegate;
   GstMLTFLitePriority priority;
   guint               n_threads;
+  guint               n_interpreters;
 };
 
 struct _GstMLTFLiteClass {
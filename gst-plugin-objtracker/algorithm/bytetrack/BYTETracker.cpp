@@ -49,189 +49,205 @@ BYTETracker::~BYTETracker()
 {
 }
 
-vector<STrack> BYTETracker::update(const vector<ByteTrackerObject>& objects)
+void BYTETracker::stage_updates(vector<STrack*> &tracks, vector<STrack*> &dets, vector<pair<int, int> > &matches)
 {
+	for (int i = 0; i < matches.size(); i++)
+	{
+		float xyah[4];
+		dets[matches[i].second]->to_xyah(xyah);
+		this->kalman_filter.stage(tracks[matches[i].first]->slot, xyah);
+	}
+
+	// Correct all matched tracks in one batch.
+	this->kalman_filter.update();
+}
+
+const vector<STrack> &BYTETracker::update(const vector<ByteTrackerObject>& objects)
+{
+	Scratch &s = this->scratch;
 
 	////////////////// Step 1: Get detections //////////////////
 	this->frame_id++;
-	vector<STrack> activated_stracks;
-	vector<STrack> refind_stracks;
-	vector<STrack> removed_stracks;
-	vector<STrack> lost_stracks;
-	vector<STrack> detections;
-	vector<STrack> detections_low;
-
-	vector<STrack> detections_cp;
-	vector<STrack> tracked_stracks_swap;
-	vector<STrack> resa, resb;
-	vector<STrack> output_stracks;
-
-	vector<STrack*> unconfirmed;
-	vector<STrack*> tracked_stracks;
-	vector<STrack*> strack_pool;
-	vector<STrack*> r_tracked_stracks;
+	s.activated_stracks.clear();
+	s.refind_stracks.clear();
+	s.removed_stracks.clear();
+	s.lost_stracks.clear();
+	s.detections.clear();
+	s.detections_low.clear();
+	s.detections_high.clear();
+	s.detections_second.clear();
+	s.detections_remain.clear();
+	s.output_stracks.clear();
+
+	s.unconfirmed.clear();
+	s.tracked_stracks.clear();
+	s.r_tracked_stracks.clear();
 
 	if (objects.size() > 0)
 	{
 		for (int i = 0; i < objects.size(); i++)
 		{
-			vector<float> tlbr_;
-			tlbr_.resize(4);
-			/*tlbr_[0] = objects[i].rect.x;
-			tlbr_[1] = objects[i].rect.y;
-			tlbr_[2] = objects[i].rect.x + objects[i].rect.width;
-			tlbr_[3] = objects[i].rect.y + objects[i].rect.height;*/
+			float tlbr_[4];
             tlbr_[0] = objects[i].bounding_box[0];
             tlbr_[1] = objects[i].bounding_box[1];
             tlbr_[2] = objects[i].bounding_box[2];
             tlbr_[3] = objects[i].bounding_box[3];
+			STrack::tlbr_to_tlwh(tlbr_);
 
 			float score = objects[i].prob;
 
-			STrack strack(STrack::tlbr_to_tlwh(tlbr_), score, objects[i].label); //also set the original detection id
+			STrack strack(tlbr_, score, objects[i].label); //also set the original detection id
 
 			if (score >= track_thresh)
 			{
-				detections.push_back(strack);
+				s.detections.push_back(strack);
 			}
 			else
 			{
-				detections_low.push_back(strack);
+				s.detections_low.push_back(strack);
 			}
 
 		}
 	}
 
+	// Detections are only referenced from here on, never copied.
+	for (int i = 0; i < s.detections.size(); i++)
+		s.detections_high.push_back(&s.detections[i]);
+	for (int i = 0; i < s.detections_low.size(); i++)
+		s.detections_second.push_back(&s.detections_low[i]);
+
 	// Add newly detected tracklets to tracked_stracks
 	for (int i = 0; i < this->tracked_stracks.size(); i++)
 	{
 		if (!this->tracked_stracks[i].is_activated)
-			unconfirmed.push_back(&this->tracked_stracks[i]);
+			s.unconfirmed.push_back(&this->tracked_stracks[i]);
 		else
-			tracked_stracks.push_back(&this->tracked_stracks[i]);
+			s.tracked_stracks.push_back(&this->tracked_stracks[i]);
 	}
 
 	////////////////// Step 2: First association, with IoU //////////////////
-	strack_pool = joint_stracks(tracked_stracks, this->lost_stracks);
-	STrack::multi_predict(strack_pool, this->kalman_filter);
+	joint_stracks(s.tracked_stracks, this->lost_stracks, s.strack_pool);
+
+	s.slots.clear();
+	for (int i = 0; i < s.strack_pool.size(); i++)
+		s.slots.push_back(s.strack_pool[i]->slot);
+	this->kalman_filter.predict(s.slots);
 
     //change object bounding box to prediction
-    for (int i = 0; i < strack_pool.size(); i++) {
-        strack_pool[i]->static_tlwh();
-        strack_pool[i]->static_tlbr();
+    for (int i = 0; i < s.strack_pool.size(); i++) {
+        s.strack_pool[i]->static_tlwh(this->kalman_filter);
+        s.strack_pool[i]->static_tlbr();
     }
 
-	vector<vector<float> > dists;
-	int dist_size = 0, dist_size_size = 0;
-	dists = iou_distance(strack_pool, detections, dist_size, dist_size_size);
+	iou_distance(s.strack_pool, s.detections_high, s.dists);
 
-	vector<vector<int> > matches;
-	vector<int> u_track, u_detection;
-	linear_assignment(dists, dist_size, dist_size_size, match_thresh, matches, u_track, u_detection);
+	s.matches.clear();
+	s.u_track.clear();
+	s.u_detection.clear();
+	linear_assignment(s.dists, match_thresh, s.matches, s.u_track, s.u_detection);
 
-	for (int i = 0; i < matches.size(); i++)
+	stage_updates(s.strack_pool, s.detections_high, s.matches);
+
+	for (int i = 0; i < s.matches.size(); i++)
 	{
-		STrack *track = strack_pool[matches[i][0]];
-		STrack *det = &detections[matches[i][1]];
-        float iou_score = 1 - dists[matches[i][0]][matches[i][1]]; //convert from distance to score, the larger the better
+		STrack *track = s.strack_pool[s.matches[i].first];
+		STrack *det = s.detections_high[s.matches[i].second];
+        float iou_score = 1 - s.dists.at(s.matches[i].first, s.matches[i].second); //convert from distance to score, the larger the better
 		if (track->state == TrackState::Tracked)
 		{
-			track->update(*det, this->frame_id, iou_score, this->track_wh_smooth_factor); //update the tracker with matched detection
-			activated_stracks.push_back(*track);
+			track->update(*det, this->kalman_filter, this->frame_id, iou_score, this->track_wh_smooth_factor); //update the tracker with matched detection
+			s.activated_stracks.push_back(*track);
 		}
 		else
 		{
-			track->re_activate(*det, this->frame_id, false, iou_score);
-			refind_stracks.push_back(*track);
+			track->re_activate(*det, this->kalman_filter, this->frame_id, false, iou_score);
+			s.refind_stracks.push_back(*track);
 		}
 	}
 
 	////////////////// Step 3: Second association, using low score dets //////////////////
-	for (int i = 0; i < u_detection.size(); i++)
+	for (int i = 0; i < s.u_detection.size(); i++)
 	{
-		detections_cp.push_back(detections[u_detection[i]]);
+		s.detections_remain.push_back(s.detections_high[s.u_detection[i]]);
 	}
-	detections.clear();
-	detections.assign(detections_low.begin(), detections_low.end());
 
-	for (int i = 0; i < u_track.size(); i++)
+	for (int i = 0; i < s.u_track.size(); i++)
 	{
-		if (strack_pool[u_track[i]]->state == TrackState::Tracked)
+		if (s.strack_pool[s.u_track[i]]->state == TrackState::Tracked)
 		{
-			r_tracked_stracks.push_back(strack_pool[u_track[i]]);
+			s.r_tracked_stracks.push_back(s.strack_pool[s.u_track[i]]);
 		}
 	}
 
-	dists.clear();
-	dists = iou_distance(r_tracked_stracks, detections, dist_size, dist_size_size);
+	iou_distance(s.r_tracked_stracks, s.detections_second, s.dists);
 
-	matches.clear();
-	u_track.clear();
-	u_detection.clear();
-	linear_assignment(dists, dist_size, dist_size_size, 0.5, matches, u_track, u_detection);
+	s.matches.clear();
+	s.u_track.clear();
+	s.u_detection.clear();
+	linear_assignment(s.dists, 0.5, s.matches, s.u_track, s.u_detection);
 
-	for (int i = 0; i < matches.size(); i++)
+	stage_updates(s.r_tracked_stracks, s.detections_second, s.matches);
+
+	for (int i = 0; i < s.matches.size(); i++)
 	{
-		STrack *track = r_tracked_stracks[matches[i][0]];
-		STrack *det = &detections[matches[i][1]];
-        float iou_score = 1 - dists[matches[i][0]][matches[i][1]]; //convert from distance to score, the larger the better
+		STrack *track = s.r_tracked_stracks[s.matches[i].first];
+		STrack *det = s.detections_second[s.matches[i].second];
+        float iou_score = 1 - s.dists.at(s.matches[i].first, s.matches[i].second); //convert from distance to score, the larger the better
 		if (track->state == TrackState::Tracked)
 		{
-			track->update(*det, this->frame_id, iou_score, this->track_wh_smooth_factor);
-			activated_stracks.push_back(*track);
+			track->update(*det, this->kalman_filter, this->frame_id, iou_score, this->track_wh_smooth_factor);
+			s.activated_stracks.push_back(*track);
 		}
 		else
 		{
-			track->re_activate(*det, this->frame_id, false, iou_score);
-			refind_stracks.push_back(*track);
+			track->re_activate(*det, this->kalman_filter, this->frame_id, false, iou_score);
+			s.refind_stracks.push_back(*track);
 		}
 	}
 
-	for (int i = 0; i < u_track.size(); i++)
+	for (int i = 0; i < s.u_track.size(); i++)
 	{
-		STrack *track = r_tracked_stracks[u_track[i]];
+		STrack *track = s.r_tracked_stracks[s.u_track[i]];
 		if (track->state != TrackState::Lost)
 		{
 			track->mark_lost();
-			lost_stracks.push_back(*track);
+			s.lost_stracks.push_back(*track);
 		}
 	}
 
 	// Deal with unconfirmed tracks, usually tracks with only one beginning frame
-	detections.clear();
-	detections.assign(detections_cp.begin(), detections_cp.end());
+	iou_distance(s.unconfirmed, s.detections_remain, s.dists);
 
-	dists.clear();
-	dists = iou_distance(unconfirmed, detections, dist_size, dist_size_size);
+	s.matches.clear();
+	s.u_unconfirmed.clear();
+	s.u_detection.clear();
+	linear_assignment(s.dists, 0.7f, s.matches, s.u_unconfirmed, s.u_detection);
 
-	matches.clear();
-	vector<int> u_unconfirmed;
-	u_detection.clear();
-	linear_assignment(dists, dist_size, dist_size_size, 0.7f, matches, u_unconfirmed, u_detection);
+	stage_updates(s.unconfirmed, s.detections_remain, s.matches);
 
-	for (int i = 0; i < matches.size(); i++)
+	for (int i = 0; i < s.matches.size(); i++)
 	{
-        float iou_score = 1 - dists[matches[i][0]][matches[i][1]]; //convert from distance to score, the larger the better
-		unconfirmed[matches[i][0]]->update(detections[matches[i][1]], this->frame_id, iou_score, this->track_wh_smooth_factor);
-		activated_stracks.push_back(*unconfirmed[matches[i][0]]);
+        float iou_score = 1 - s.dists.at(s.matches[i].first, s.matches[i].second); //convert from distance to score, the larger the better
+		s.unconfirmed[s.matches[i].first]->update(*s.detections_remain[s.matches[i].second], this->kalman_filter, this->frame_id, iou_score, this->track_wh_smooth_factor);
+		s.activated_stracks.push_back(*s.unconfirmed[s.matches[i].first]);
 	}
 
-	for (int i = 0; i < u_unconfirmed.size(); i++)
+	for (int i = 0; i < s.u_unconfirmed.size(); i++)
 	{
-		STrack *track = unconfirmed[u_unconfirmed[i]];
+		STrack *track = s.unconfirmed[s.u_unconfirmed[i]];
 		track->mark_removed();
-		removed_stracks.push_back(*track);
+		s.removed_stracks.push_back(*track);
 	}
 
 	////////////////// Step 4: Init new stracks //////////////////
     //activation is only on newly unmatched high-confidence detection
-	for (int i = 0; i < u_detection.size(); i++)
+	for (int i = 0; i < s.u_detection.size(); i++)
 	{
-		STrack *track = &detections[u_detection[i]];
+		STrack *track = s.detections_remain[s.u_detection[i]];
 		if (track->score < this->high_thresh)
 			continue;
 		track->activate(this->kalman_filter, this->frame_id);
-		activated_stracks.push_back(*track);
+		s.activated_stracks.push_back(*track);
 	}
 
 	////////////////// Step 5: Update state //////////////////
@@ -240,55 +256,67 @@ vector<STrack> BYTETracker::update(const vector<ByteTrackerObject>& objects)
 		if (this->frame_id - this->lost_stracks[i].end_frame() > this->max_time_lost)
 		{
 			this->lost_stracks[i].mark_removed();
-			removed_stracks.push_back(this->lost_stracks[i]);
+			s.removed_stracks.push_back(this->lost_stracks[i]);
 		}
 	}
 
+	s.swap_a.clear();
 	for (int i = 0; i < this->tracked_stracks.size(); i++)
 	{
 		if (this->tracked_stracks[i].state == TrackState::Tracked)
 		{
-			tracked_stracks_swap.push_back(this->tracked_stracks[i]);
+			s.swap_a.push_back(this->tracked_stracks[i]);
 		}
 	}
-	this->tracked_stracks.clear();
-	this->tracked_stracks.assign(tracked_stracks_swap.begin(), tracked_stracks_swap.end());
 
-	this->tracked_stracks = joint_stracks(this->tracked_stracks, activated_stracks);
-	this->tracked_stracks = joint_stracks(this->tracked_stracks, refind_stracks);
+	joint_stracks(s.swap_a, s.activated_stracks, s.swap_b);
+	joint_stracks(s.swap_b, s.refind_stracks, this->tracked_stracks);
 
 	//std::cout << activated_stracks.size() << std::endl;
 
     //remove re-activated tracks from lost_tracks
-	this->lost_stracks = sub_stracks(this->lost_stracks, this->tracked_stracks);
-	for (int i = 0; i < lost_stracks.size(); i++)
+	sub_stracks(this->lost_stracks, this->tracked_stracks, s.swap_a);
+	for (int i = 0; i < s.lost_stracks.size(); i++)
 	{
-		this->lost_stracks.push_back(lost_stracks[i]);
+		s.swap_a.push_back(s.lost_stracks[i]);
 	}
 
-    //remove removed_stracks from lost_tracks
-	this->lost_stracks = sub_stracks(this->lost_stracks, this->removed_stracks);
-	for (int i = 0; i < removed_stracks.size(); i++)
+    //remove removed_stracks from lost_tracks, including the ones removed in
+    //this frame, as removed_stracks does not persist across frames
+	for (int i = 0; i < s.removed_stracks.size(); i++)
 	{
-		this->removed_stracks.push_back(removed_stracks[i]);
+		this->removed_stracks.push_back(s.removed_stracks[i]);
 	}
+	sub_stracks(s.swap_a, this->removed_stracks, this->lost_stracks);
 
     //remove highly overlapped tracks
-	remove_duplicate_stracks(resa, resb, this->tracked_stracks, this->lost_stracks);
-	this->tracked_stracks.clear();
-	this->tracked_stracks.assign(resa.begin(), resa.end());
-	this->lost_stracks.clear();
-	this->lost_stracks.assign(resb.begin(), resb.end());
+	s.swap_a.clear();
+	s.swap_b.clear();
+	remove_duplicate_stracks(s.swap_a, s.swap_b, this->tracked_stracks, this->lost_stracks);
+	this->tracked_stracks.swap(s.swap_a);
+	this->lost_stracks.swap(s.swap_b);
 
     //memory management on removed_stracks
     this->removed_stracks.clear();
 
+	// Release the Kalman state of the tracks which are no longer kept.
+	next_mark();
+	for (int i = 0; i < this->tracked_stracks.size(); i++)
+		mark(this->tracked_stracks[i]);
+	for (int i = 0; i < this->lost_stracks.size(); i++)
+		mark(this->lost_stracks[i]);
+	for (int slot = 0; slot < this->kalman_filter.size(); slot++)
+	{
+		if (this->kalman_filter.in_use(slot) && s.marks[slot] != s.epoch)
+			this->kalman_filter.release(slot);
+	}
+
     //returned the tracked tracks
 	for (int i = 0; i < this->tracked_stracks.size(); i++)
 	{
 		if (this->tracked_stracks[i].is_activated) //output only tracked, not unconfirmed trackeds
 		{
-			output_stracks.push_back(this->tracked_stracks[i]);
+			s.output_stracks.push_back(this->tracked_stracks[i]);
 		}
 	}
     //add the lost tracks (no matched detections)
@@ -296,8 +324,8 @@ vector<STrack> BYTETracker::update(const vector<ByteTrackerObject>& objects)
     {
         if (this->lost_stracks[i].is_activated) //output only tracked, not unconfirmed trackeds
         {
-            output_stracks.push_back(this->lost_stracks[i]);
+            s.output_stracks.push_back(this->lost_stracks[i]);
         }
     }
-	return output_stracks;
+	return s.output_stracks;
 }
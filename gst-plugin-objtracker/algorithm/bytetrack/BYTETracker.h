@@ -29,6 +29,9 @@
 
 #pragma once
 
+#include <climits>
+#include <utility>
+
 #include "STrack.h"
 
 struct ByteTrackerObject
@@ -68,31 +71,57 @@ public:
 };
 
 
+// Row-major matrix of IoU distances between tracks (rows) and detections
+// (columns), stored in one contiguous block reused across frames.
+struct CostMatrix
+{
+	int rows = 0;
+	int cols = 0;
+	vector<float> data;
+
+	void resize(int n_rows, int n_cols)
+	{
+		rows = n_rows;
+		cols = n_cols;
+		data.resize((size_t) n_rows * n_cols);
+	}
+
+	// data() is valid for an empty vector, indexing it is not.
+	float *row(int r) { return data.data() + (size_t) r * cols; }
+	const float *row(int r) const { return data.data() + (size_t) r * cols; }
+	float at(int r, int c) const { return data[(size_t) r * cols + c]; }
+	bool empty() const { return rows * cols == 0; }
+};
+
 class BYTETracker
 {
 public:
 	BYTETracker(const ByteTrackerConfig &config);
 	~BYTETracker();
 
-	vector<STrack> update(const vector<ByteTrackerObject>& objects);
+	const vector<STrack> &update(const vector<ByteTrackerObject>& objects);
 	//Scalar get_color(int idx);
 
 private:
-	vector<STrack*> joint_stracks(vector<STrack*> &tlista, vector<STrack> &tlistb);
-	vector<STrack> joint_stracks(vector<STrack> &tlista, vector<STrack> &tlistb);
+	void joint_stracks(vector<STrack*> &tlista, vector<STrack> &tlistb, vector<STrack*> &res);
+	void joint_stracks(vector<STrack> &tlista, vector<STrack> &tlistb, vector<STrack> &res);
 
-	vector<STrack> sub_stracks(vector<STrack> &tlista, vector<STrack> &tlistb);
+	void sub_stracks(vector<STrack> &tlista, vector<STrack> &tlistb, vector<STrack> &res);
 	void remove_duplicate_stracks(vector<STrack> &resa, vector<STrack> &resb, vector<STrack> &stracksa, vector<STrack> &stracksb);
 
-	void linear_assignment(vector<vector<float> > &cost_matrix, int cost_matrix_size, int cost_matrix_size_size, float thresh,
-		vector<vector<int> > &matches, vector<int> &unmatched_a, vector<int> &unmatched_b);
-	vector<vector<float> > iou_distance(vector<STrack*> &atracks, vector<STrack> &btracks, int &dist_size, int &dist_size_size);
-	vector<vector<float> > iou_distance(vector<STrack> &atracks, vector<STrack> &btracks);
-	vector<vector<float> > ious(vector<vector<float> > &atlbrs, vector<vector<float> > &btlbrs);
+	void linear_assignment(CostMatrix &cost_matrix, float thresh,
+		vector<pair<int, int> > &matches, vector<int> &unmatched_a, vector<int> &unmatched_b);
+	void iou_distance(const vector<STrack*> &atracks, const vector<STrack*> &btracks, CostMatrix &cost_matrix);
+	void iou_distance(const vector<STrack> &atracks, const vector<STrack> &btracks, CostMatrix &cost_matrix);
+	void ious(CostMatrix &cost_matrix);
 
-	double lapjv(const vector<vector<float> > &cost, vector<int> &rowsol, vector<int> &colsol,
+	double lapjv(const CostMatrix &cost, vector<int> &rowsol, vector<int> &colsol,
 		bool extend_cost = false, float cost_limit = LONG_MAX, bool return_cost = true);
 
+	void next_mark();
+	bool mark(const STrack &track);
+	void stage_updates(vector<STrack*> &tracks, vector<STrack*> &dets, vector<pair<int, int> > &matches);
+
 private:
 
 	float track_thresh;
@@ -107,4 +136,45 @@ private:
 	byte_kalman::KalmanFilter kalman_filter;
 
     float track_wh_smooth_factor;
+
+	// Scratch reused across frames to avoid per frame allocations.
+	struct Scratch
+	{
+		vector<STrack> detections;
+		vector<STrack> detections_low;
+		vector<STrack*> detections_high;
+		vector<STrack*> detections_second;
+		vector<STrack*> detections_remain;
+
+		vector<STrack> activated_stracks;
+		vector<STrack> refind_stracks;
+		vector<STrack> lost_stracks;
+		vector<STrack> removed_stracks;
+		vector<STrack> output_stracks;
+		vector<STrack> swap_a, swap_b;
+
+		vector<STrack*> unconfirmed;
+		vector<STrack*> tracked_stracks;
+		vector<STrack*> strack_pool;
+		vector<STrack*> r_tracked_stracks;
+		vector<int> slots;
+
+		CostMatrix dists;
+		vector<pair<int, int> > matches;
+		vector<int> u_track, u_detection, u_unconfirmed;
+		vector<int> rowsol, colsol;
+
+		// Boxes of the cost matrix columns, one array per coordinate.
+		vector<float> boxes;
+
+		// Extended square cost matrix and its row pointers for lapjv.
+		vector<double> lap_cost;
+		vector<double*> lap_rows;
+		vector<int> lap_x, lap_y;
+
+		// Per slot marks used to deduplicate and subtract track lists.
+		vector<unsigned int> marks;
+		unsigned int epoch = 0;
+		vector<char> dup_a, dup_b;
+	} scratch;
 };
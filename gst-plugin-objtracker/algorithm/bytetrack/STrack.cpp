@@ -27,24 +27,24 @@
  * SPDX-License-Identifier: BSD-3-Clause-Clear
  */
 
+#include <atomic>
+
 #include "STrack.h"
 
-STrack::STrack(vector<float> tlwh_, float score, int det_id)
+STrack::STrack(const float tlwh_[4], float score, int det_id)
 {
-	_tlwh.resize(4);
-	_tlwh.assign(tlwh_.begin(), tlwh_.end());
+	for (int i = 0; i < 4; i++)
+		_tlwh[i] = tlwh_[i];
 
 	is_activated = false;
 	track_id = 0;
 	state = TrackState::New;
-	
-	tlwh.resize(4);
-	tlbr.resize(4);    
+	slot = -1;
 
-	static_tlwh();
+	for (int i = 0; i < 4; i++)
+		tlwh[i] = _tlwh[i];
 	static_tlbr();
 
-    smoothed_wh.resize(2);
     smoothed_wh[0] = this->tlwh[2];
     smoothed_wh[1] = this->tlwh[3];
 
@@ -64,25 +64,13 @@ STrack::~STrack()
 
 void STrack::activate(byte_kalman::KalmanFilter &kalman_filter, int frame_id)
 {
-	this->kalman_filter = kalman_filter;
 	this->track_id = this->next_id();
 
-	vector<float> _tlwh_tmp(4);
-	_tlwh_tmp[0] = this->_tlwh[0];
-	_tlwh_tmp[1] = this->_tlwh[1];
-	_tlwh_tmp[2] = this->_tlwh[2];
-	_tlwh_tmp[3] = this->_tlwh[3];
-	vector<float> xyah = tlwh_to_xyah(_tlwh_tmp);
-	DETECTBOX xyah_box;
-	xyah_box[0] = xyah[0];
-	xyah_box[1] = xyah[1];
-	xyah_box[2] = xyah[2];
-	xyah_box[3] = xyah[3];
-	auto mc = this->kalman_filter.initiate(xyah_box);
-	this->mean = mc.first;
-	this->covariance = mc.second;
-
-	static_tlwh();
+	float xyah[4];
+	to_xyah(xyah);
+	this->slot = kalman_filter.initiate(xyah);
+
+	static_tlwh(kalman_filter);
 	static_tlbr();
 
     this->smoothed_wh[0] = this->tlwh[2];
@@ -102,19 +90,10 @@ void STrack::activate(byte_kalman::KalmanFilter &kalman_filter, int frame_id)
        
 }
 
-void STrack::re_activate(STrack &new_track, int frame_id, bool new_id, float iou_score)
+void STrack::re_activate(const STrack &new_track, const byte_kalman::KalmanFilter &kalman_filter,
+	int frame_id, bool new_id, float iou_score)
 {
-	vector<float> xyah = tlwh_to_xyah(new_track.tlwh);
-	DETECTBOX xyah_box;
-	xyah_box[0] = xyah[0];
-	xyah_box[1] = xyah[1];
-	xyah_box[2] = xyah[2];
-	xyah_box[3] = xyah[3];
-	auto mc = this->kalman_filter.update(this->mean, this->covariance, xyah_box);
-	this->mean = mc.first;
-	this->covariance = mc.second;
-
-	static_tlwh();
+	static_tlwh(kalman_filter);
 	static_tlbr();
 
     //reset the smoothed width and height
@@ -134,23 +113,13 @@ void STrack::re_activate(STrack &new_track, int frame_id, bool new_id, float iou
     this->iou_with_det = iou_score;
 }
 
-void STrack::update(STrack &new_track, int frame_id, float iou_score, float sz_smooth_factor)
+void STrack::update(const STrack &new_track, const byte_kalman::KalmanFilter &kalman_filter,
+	int frame_id, float iou_score, float sz_smooth_factor)
 {
 	this->frame_id = frame_id;
 	this->tracklet_len++;
 
-	vector<float> xyah = tlwh_to_xyah(new_track.tlwh);
-	DETECTBOX xyah_box;
-	xyah_box[0] = xyah[0];
-	xyah_box[1] = xyah[1];
-	xyah_box[2] = xyah[2];
-	xyah_box[3] = xyah[3];
-
-	auto mc = this->kalman_filter.update(this->mean, this->covariance, xyah_box);
-	this->mean = mc.first;
-	this->covariance = mc.second;
-
-	static_tlwh();
+	static_tlwh(kalman_filter);
 	static_tlbr();
 
     //update smoothed width and height
@@ -167,7 +136,7 @@ void STrack::update(STrack &new_track, int frame_id, float iou_score, float sz_s
     this->iou_with_det = iou_score;
 }
 
-void STrack::static_tlwh()
+void STrack::static_tlwh(const byte_kalman::KalmanFilter &kalman_filter)
 {
 	if (this->state == TrackState::New)
 	{
@@ -178,10 +147,10 @@ void STrack::static_tlwh()
 		return;
 	}
 
-	tlwh[0] = mean[0];
-	tlwh[1] = mean[1];
-	tlwh[2] = mean[2];
-	tlwh[3] = mean[3];
+	tlwh[0] = kalman_filter.mean(slot, 0);
+	tlwh[1] = kalman_filter.mean(slot, 1);
+	tlwh[2] = kalman_filter.mean(slot, 2);
+	tlwh[3] = kalman_filter.mean(slot, 3);
 
 	tlwh[2] *= tlwh[3];
 	tlwh[0] -= tlwh[2] / 2;
@@ -190,31 +159,24 @@ void STrack::static_tlwh()
 
 void STrack::static_tlbr()
 {
-	tlbr.clear();
-	tlbr.assign(tlwh.begin(), tlwh.end());
-	tlbr[2] += tlbr[0];
-	tlbr[3] += tlbr[1];
-}
-
-vector<float> STrack::tlwh_to_xyah(vector<float> tlwh_tmp)
-{
-	vector<float> tlwh_output = tlwh_tmp;
-	tlwh_output[0] += tlwh_output[2] / 2;
-	tlwh_output[1] += tlwh_output[3] / 2;
-	tlwh_output[2] /= tlwh_output[3];
-	return tlwh_output;
+	tlbr[0] = tlwh[0];
+	tlbr[1] = tlwh[1];
+	tlbr[2] = tlwh[2] + tlwh[0];
+	tlbr[3] = tlwh[3] + tlwh[1];
 }
 
-vector<float> STrack::to_xyah()
+void STrack::to_xyah(float xyah[4]) const
 {
-	return tlwh_to_xyah(tlwh);
+	xyah[0] = tlwh[0] + tlwh[2] / 2;
+	xyah[1] = tlwh[1] + tlwh[3] / 2;
+	xyah[2] = tlwh[2] / tlwh[3];
+	xyah[3] = tlwh[3];
 }
 
-vector<float> STrack::tlbr_to_tlwh(vector<float> &tlbr)
+void STrack::tlbr_to_tlwh(float box[4])
 {
-	tlbr[2] -= tlbr[0];
-	tlbr[3] -= tlbr[1];
-	return tlbr;
+	box[2] -= box[0];
+	box[3] -= box[1];
 }
 
 void STrack::mark_lost()
@@ -234,24 +196,12 @@ void STrack::mark_removed()
 
 int STrack::next_id()
 {
-	static int _count = 0;
-	_count++;
-	return _count;
+	// Shared by all tracker instances, which may be updated in parallel.
+	static std::atomic<int> _count(0);
+	return ++_count;
 }
 
 int STrack::end_frame()
 {
 	return this->frame_id;
 }
-
-void STrack::multi_predict(vector<STrack*> &stracks, byte_kalman::KalmanFilter &kalman_filter)
-{
-	for (int i = 0; i < stracks.size(); i++)
-	{
-		/*if (stracks[i]->state != TrackState::Tracked)
-		{
-			stracks[i]->mean[7] = 0;
-		}*/
-		kalman_filter.predict(stracks[i]->mean, stracks[i]->covariance);
-	}
-}
@@ -29,7 +29,7 @@
 
 #pragma once
 
-#include <map>
+#include <vector>
 
 #include "kalmanFilter.h"
 
@@ -41,48 +41,45 @@ enum TrackState { New = 0, Tracked, Lost, Removed };
 class STrack
 {
 public:
-    STrack(vector<float> tlwh_, float score, int det_id = -1);
+	STrack(const float tlwh_[4], float score, int det_id = -1);
 	~STrack();
 
-	vector<float> static tlbr_to_tlwh(vector<float> &tlbr);
-	void static multi_predict(vector<STrack*> &stracks, byte_kalman::KalmanFilter &kalman_filter);
-	void static_tlwh();
+	void static tlbr_to_tlwh(float box[4]);
+	void static_tlwh(const byte_kalman::KalmanFilter &kalman_filter);
 	void static_tlbr();
-	vector<float> tlwh_to_xyah(vector<float> tlwh_tmp);
-	vector<float> to_xyah();
+	void to_xyah(float xyah[4]) const;
 	void mark_lost();
 	void mark_removed();
 	int next_id();
 	int end_frame();
 
+	// Kalman state of re_activate() and update() must be corrected before,
+	// the filter processes all matched tracks of a frame as one batch.
 	void activate(byte_kalman::KalmanFilter &kalman_filter, int frame_id);
-	void re_activate(STrack &new_track, int frame_id, bool new_id = false, float iou_score = 0);
-	void update(STrack &new_track, int frame_id, float iou_score = 0, float sz_smooth_factor = 0.9f);
+	void re_activate(const STrack &new_track, const byte_kalman::KalmanFilter &kalman_filter,
+		int frame_id, bool new_id = false, float iou_score = 0);
+	void update(const STrack &new_track, const byte_kalman::KalmanFilter &kalman_filter,
+		int frame_id, float iou_score = 0, float sz_smooth_factor = 0.9f);
 
 public:
 	bool is_activated; //flag for confirmed and unconfirmed tracks
 	int track_id;
 	int state;
 
-	vector<float> _tlwh;
-	vector<float> tlwh;
-	vector<float> tlbr;
+	float _tlwh[4];
+	float tlwh[4];
+	float tlbr[4];
 	int frame_id;
 	int tracklet_len;
 	int start_frame;
 
-    vector<float> smoothed_wh; //size of two
+    float smoothed_wh[2];
 
-	KAL_MEAN mean;
-	KAL_COVA covariance;
+	// Slot of the track state in the Kalman filter, -1 until activated.
+	int slot;
 	float score;
 
     //ADDED members
     int   matched_detection_id; //original index of the matched detection
     float iou_with_det;
-
-
-
-private:
-	byte_kalman::KalmanFilter kalman_filter;
 };
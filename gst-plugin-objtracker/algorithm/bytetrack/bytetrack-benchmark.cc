@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+/** bytetrack-benchmark
+ *
+ * Micro-benchmark of the ByteTrack algorithm on 50-500 moving objects.
+ *
+ * Objects move with constant velocity over a 1920x1080 frame, detections are
+ * jittered, some are missed and a few false positives are added. Objects
+ * randomly respawn elsewhere, so tracks are lost and new ones are created.
+ *
+ * Usage: bytetrack-benchmark [number of frames]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "objtracker-data.h"
+
+extern "C" {
+  void *TrackerAlgoCreate (std::map<std::string, ParameterType> params);
+  std::vector<TrackerAlgoOutputData> TrackerAlgoExecute (void *tracker,
+      std::vector<TrackerAlgoInputData> data);
+  void TrackerAlgoDelete (void *tracker);
+}
+
+static const uint32_t kNumObjects[] = { 50, 100, 200, 500 };
+
+struct Object {
+  float x;
+  float y;
+  float w;
+  float h;
+  float vx;
+  float vy;
+};
+
+class Scene {
+ public:
+  Scene(uint32_t n_objects)
+      : engine_(n_objects), uniform_(0.0F, 1.0F), normal_(0.0F, 1.0F),
+        objects_(n_objects) {
+    for (Object& object : objects_)
+      Spawn(object);
+  }
+
+  void NextFrame(std::vector<TrackerAlgoInputData>& detections) {
+    int id = 0;
+
+    detections.clear();
+
+    for (Object& object : objects_) {
+      object.x += object.vx;
+      object.y += object.vy;
+
+      if (uniform_(engine_) < 0.01F)
+        Spawn(object);
+
+      // Missed detection.
+      if (uniform_(engine_) < 0.08F) {
+        id++;
+        continue;
+      }
+
+      TrackerAlgoInputData detection;
+
+      detection.x = object.x + normal_(engine_) * 2.0F;
+      detection.y = object.y + normal_(engine_) * 2.0F;
+      detection.w = object.w * (1.0F + normal_(engine_) * 0.03F);
+      detection.h = object.h * (1.0F + normal_(engine_) * 0.03F);
+      detection.detection_id = id++;
+      detection.prob = 30.0F + uniform_(engine_) * 70.0F;
+
+      detections.push_back(detection);
+    }
+
+    // False positives with low confidence.
+    for (uint32_t idx = 0; idx < objects_.size() / 20; idx++) {
+      TrackerAlgoInputData detection;
+
+      detection.x = uniform_(engine_) * 1800.0F;
+      detection.y = uniform_(engine_) * 1000.0F;
+      detection.w = 30.0F;
+      detection.h = 60.0F;
+      detection.detection_id = id++;
+      detection.prob = 20.0F + uniform_(engine_) * 50.0F;
+
+      detections.push_back(detection);
+    }
+  }
+
+ private:
+  void Spawn(Object& object) {
+    object.w = 20.0F + uniform_(engine_) * 80.0F;
+    object.h = 40.0F + uniform_(engine_) * 120.0F;
+    object.x = uniform_(engine_) * 1800.0F;
+    object.y = uniform_(engine_) * 1000.0F;
+    object.vx = normal_(engine_) * 4.0F;
+    object.vy = normal_(engine_) * 3.0F;
+  }
+
+  std::mt19937                          engine_;
+  std::uniform_real_distribution<float> uniform_;
+  std::normal_distribution<float>       normal_;
+  std::vector<Object>                   objects_;
+};
+
+int main(int argc, char* argv[]) {
+  uint32_t n_frames = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 300;
+
+  if (n_frames == 0)
+    n_frames = 1;
+
+  std::printf("%10s %10s %14s %10s\n", "objects", "frames", "us/frame",
+      "tracks");
+
+  for (uint32_t n_objects : kNumObjects) {
+    std::vector<TrackerAlgoInputData> detections;
+    std::vector<TrackerAlgoOutputData> results;
+    std::map<std::string, ParameterType> params;
+    Scene scene(n_objects);
+    double elapsed = 0.0;
+
+    void *tracker = TrackerAlgoCreate(params);
+
+    if (tracker == nullptr) {
+      std::fprintf(stderr, "Failed to create tracker!\n");
+      return EXIT_FAILURE;
+    }
+
+    for (uint32_t frame = 0; frame < n_frames; frame++) {
+      scene.NextFrame(detections);
+
+      auto start = std::chrono::steady_clock::now();
+      results = TrackerAlgoExecute(tracker, detections);
+
+      std::chrono::duration<double, std::micro> duration =
+          std::chrono::steady_clock::now() - start;
+      elapsed += duration.count();
+    }
+
+    TrackerAlgoDelete(tracker);
+
+    std::printf("%10u %10u %14.1f %10zu\n", n_objects, n_frames,
+        elapsed / n_frames, results.size());
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -6,8 +6,6 @@
 #include "objtracker-data.h"
 #include "BYTETracker.h"
 
-BYTETracker *tracker;
-
 extern "C" {
   void *TrackerAlgoCreate (std::map<std::string, ParameterType> params);
   std::vector<TrackerAlgoOutputData> TrackerAlgoExecute (void *tracker,
@@ -18,6 +16,7 @@ extern "C" {
 void *TrackerAlgoCreate (std::map<std::string, ParameterType> params)
 {
   ByteTrackerConfig config;
+  BYTETracker *tracker = NULL;
 
   if (params.size() == 0) {
     config.frame_rate = 30;
@@ -87,7 +86,7 @@ std::vector<TrackerAlgoOutputData> TrackerAlgoExecute (void *tracker,
     objects.push_back(object);
   }
 
-  std::vector<STrack> stracks = ((BYTETracker *)tracker)->update(objects);
+  const std::vector<STrack>& stracks = ((BYTETracker *)tracker)->update(objects);
 
   for (const auto& strack : stracks) {
     if (strack.state == TrackState::Removed)
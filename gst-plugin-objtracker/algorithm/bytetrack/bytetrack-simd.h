@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#pragma once
+
+// Minimal 4 lane float vector used by the batched tracker kernels.
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+
+#define BT_VEC_LANES 4
+
+typedef float32x4_t bt_vec;
+
+static inline bt_vec bt_load(const float *p) { return vld1q_f32(p); }
+static inline void bt_store(float *p, bt_vec v) { vst1q_f32(p, v); }
+static inline bt_vec bt_set(float v) { return vdupq_n_f32(v); }
+static inline bt_vec bt_add(bt_vec a, bt_vec b) { return vaddq_f32(a, b); }
+static inline bt_vec bt_sub(bt_vec a, bt_vec b) { return vsubq_f32(a, b); }
+static inline bt_vec bt_mul(bt_vec a, bt_vec b) { return vmulq_f32(a, b); }
+static inline bt_vec bt_div(bt_vec a, bt_vec b) { return vdivq_f32(a, b); }
+static inline bt_vec bt_min(bt_vec a, bt_vec b) { return vminq_f32(a, b); }
+static inline bt_vec bt_max(bt_vec a, bt_vec b) { return vmaxq_f32(a, b); }
+
+// Lanes of b where a > 0, otherwise 0.
+static inline bt_vec bt_positive(bt_vec a, bt_vec b)
+{
+	return vbslq_f32(vcgtq_f32(a, vdupq_n_f32(0.0f)), b, vdupq_n_f32(0.0f));
+}
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+
+#define BT_VEC_LANES 4
+
+typedef __m128 bt_vec;
+
+static inline bt_vec bt_load(const float *p) { return _mm_loadu_ps(p); }
+static inline void bt_store(float *p, bt_vec v) { _mm_storeu_ps(p, v); }
+static inline bt_vec bt_set(float v) { return _mm_set1_ps(v); }
+static inline bt_vec bt_add(bt_vec a, bt_vec b) { return _mm_add_ps(a, b); }
+static inline bt_vec bt_sub(bt_vec a, bt_vec b) { return _mm_sub_ps(a, b); }
+static inline bt_vec bt_mul(bt_vec a, bt_vec b) { return _mm_mul_ps(a, b); }
+static inline bt_vec bt_div(bt_vec a, bt_vec b) { return _mm_div_ps(a, b); }
+static inline bt_vec bt_min(bt_vec a, bt_vec b) { return _mm_min_ps(a, b); }
+static inline bt_vec bt_max(bt_vec a, bt_vec b) { return _mm_max_ps(a, b); }
+
+// Lanes of b where a > 0, otherwise 0.
+static inline bt_vec bt_positive(bt_vec a, bt_vec b)
+{
+	return _mm_and_ps(_mm_cmpgt_ps(a, _mm_setzero_ps()), b);
+}
+#else
+#define BT_VEC_LANES 4
+
+typedef struct { float v[BT_VEC_LANES]; } bt_vec;
+
+#define BT_VEC_OP(name, expr) \
+	static inline bt_vec name(bt_vec a, bt_vec b) \
+	{ \
+		bt_vec r; \
+		for (int i = 0; i < BT_VEC_LANES; i++) \
+			r.v[i] = (expr); \
+		return r; \
+	}
+
+static inline bt_vec bt_load(const float *p)
+{
+	bt_vec r;
+	for (int i = 0; i < BT_VEC_LANES; i++)
+		r.v[i] = p[i];
+	return r;
+}
+
+static inline void bt_store(float *p, bt_vec v)
+{
+	for (int i = 0; i < BT_VEC_LANES; i++)
+		p[i] = v.v[i];
+}
+
+static inline bt_vec bt_set(float v)
+{
+	bt_vec r;
+	for (int i = 0; i < BT_VEC_LANES; i++)
+		r.v[i] = v;
+	return r;
+}
+
+BT_VEC_OP(bt_add, a.v[i] + b.v[i])
+BT_VEC_OP(bt_sub, a.v[i] - b.v[i])
+BT_VEC_OP(bt_mul, a.v[i] * b.v[i])
+BT_VEC_OP(bt_div, a.v[i] / b.v[i])
+BT_VEC_OP(bt_min, (b.v[i] < a.v[i]) ? b.v[i] : a.v[i])
+BT_VEC_OP(bt_max, (a.v[i] < b.v[i]) ? b.v[i] : a.v[i])
+// Lanes of b where a > 0, otherwise 0.
+BT_VEC_OP(bt_positive, (a.v[i] > 0.0f) ? b.v[i] : 0.0f)
+
+#undef BT_VEC_OP
+#endif // __ARM_NEON && __aarch64__
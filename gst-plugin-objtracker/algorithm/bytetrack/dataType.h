@@ -1,66 +0,0 @@
-/*
- * Copyright (c) 2021 Yifu Zhang
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in all
- * copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
- * SOFTWARE.
- */
-
-/*
- * Changes from Qualcomm Technologies, Inc. are provided under the following license:
- *
- * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
- * SPDX-License-Identifier: BSD-3-Clause-Clear
- */
-
-#pragma once
-
-#include <cstddef>
-#include <vector>
-
-#include "Eigen/Core"
-#include "Eigen/Dense"
-
-typedef Eigen::Matrix<float, 1, 4, Eigen::RowMajor> DETECTBOX;
-typedef Eigen::Matrix<float, -1, 4, Eigen::RowMajor> DETECTBOXSS;
-typedef Eigen::Matrix<float, 1, 128, Eigen::RowMajor> FEATURE;
-typedef Eigen::Matrix<float, Eigen::Dynamic, 128, Eigen::RowMajor> FEATURESS;
-//typedef std::vector<FEATURE> FEATURESS;
-
-//Kalmanfilter
-//typedef Eigen::Matrix<float, 8, 8, Eigen::RowMajor> KAL_FILTER;
-typedef Eigen::Matrix<float, 1, 8, Eigen::RowMajor> KAL_MEAN;
-typedef Eigen::Matrix<float, 8, 8, Eigen::RowMajor> KAL_COVA;
-typedef Eigen::Matrix<float, 1, 4, Eigen::RowMajor> KAL_HMEAN;
-typedef Eigen::Matrix<float, 4, 4, Eigen::RowMajor> KAL_HCOVA;
-using KAL_DATA = std::pair<KAL_MEAN, KAL_COVA>;
-using KAL_HDATA = std::pair<KAL_HMEAN, KAL_HCOVA>;
-
-//main
-using RESULT_DATA = std::pair<int, DETECTBOX>;
-
-//tracker:
-using TRACKER_DATA = std::pair<int, FEATURESS>;
-using MATCH_DATA = std::pair<int, int>;
-typedef struct t {
-	std::vector<MATCH_DATA> matches;
-	std::vector<int> unmatched_tracks;
-	std::vector<int> unmatched_detections;
-}TRACHER_MATCHD;
-
-//linear_assignment:
-typedef Eigen::Matrix<float, -1, -1, Eigen::RowMajor> DYNAMICM;
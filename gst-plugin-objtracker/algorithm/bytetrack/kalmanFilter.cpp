@@ -27,156 +27,212 @@
  * SPDX-License-Identifier: BSD-3-Clause-Clear
  */
 
-#include "kalmanFilter.h"
+#include <algorithm>
 
-#include "Eigen/Cholesky"
+#include "kalmanFilter.h"
+#include "bytetrack-simd.h"
 
 namespace byte_kalman
 {
-	const double KalmanFilter::chi2inv95[10] = {
-	0,
-	3.8415,
-	5.9915,
-	7.8147,
-	9.4877,
-	11.070,
-	12.592,
-	14.067,
-	15.507,
-	16.919
-	};
-	KalmanFilter::KalmanFilter()
-	{
-		int ndim = 4;
-		double dt = 1.;
+	// Rows of a packed update batch: the state rows and the measurement.
+	static const int BATCH_ROWS = KalmanFilter::N_ROWS + 4;
 
-		_motion_mat = Eigen::MatrixXf::Identity(8, 8);
-		for (int i = 0; i < ndim; i++) {
-			_motion_mat(i, ndim + i) = dt;
-		}
-		_update_mat = Eigen::MatrixXf::Identity(4, 8);
+	static inline int align_lanes(int n)
+	{
+		return (n + BT_VEC_LANES - 1) / BT_VEC_LANES * BT_VEC_LANES;
+	}
 
+	KalmanFilter::KalmanFilter()
+	{
 		this->_std_weight_position = 1. / 20;
 		this->_std_weight_velocity = 1. / 160;
+
+		this->capacity = 0;
 	}
 
-	KAL_DATA KalmanFilter::initiate(const DETECTBOX &measurement)
+	void KalmanFilter::grow()
 	{
-		DETECTBOX mean_pos = measurement;
-		DETECTBOX mean_vel;
-		for (int i = 0; i < 4; i++) mean_vel(i) = 0;
-
-		KAL_MEAN mean;
-		for (int i = 0; i < 8; i++) {
-			if (i < 4) mean(i) = mean_pos(i);
-			else mean(i) = mean_vel(i - 4);
+		int n = std::max(capacity * 2, 64);
+		std::vector<float> resized((size_t) N_ROWS * n, 0.0f);
+
+		for (int k = 0; k < N_ROWS; k++)
+			std::copy(state.begin() + (size_t) k * capacity,
+				state.begin() + (size_t) (k + 1) * capacity,
+				resized.begin() + (size_t) k * n);
+
+		state.swap(resized);
+		used.resize(n, 0);
+		mask.resize(n, 0.0f);
+
+		// Hand out lower slots first.
+		for (int slot = n - 1; slot >= capacity; slot--)
+			free_slots.push_back(slot);
+
+		capacity = n;
+	}
+
+	int KalmanFilter::initiate(const float measurement[4])
+	{
+		if (free_slots.empty())
+			grow();
+
+		int slot = free_slots.back();
+		free_slots.pop_back();
+		used[slot] = 1;
+
+		float h = measurement[3];
+		float std_pos = 2 * _std_weight_position * h;
+		float std_vel = 10 * _std_weight_velocity * h;
+
+		for (int i = 0; i < 4; i++)
+		{
+			float sp = (i == 2) ? 1e-2f : std_pos;
+			float sv = (i == 2) ? 1e-5f : std_vel;
+
+			state[(MEAN + i) * capacity + slot] = measurement[i];
+			state[(MEAN + 4 + i) * capacity + slot] = 0.0f;
+			state[(COV_PP + i) * capacity + slot] = sp * sp;
+			state[(COV_PV + i) * capacity + slot] = 0.0f;
+			state[(COV_VV + i) * capacity + slot] = sv * sv;
 		}
 
-		KAL_MEAN std;
-		std(0) = 2 * _std_weight_position * measurement[3];
-		std(1) = 2 * _std_weight_position * measurement[3];
-		std(2) = 1e-2;
-		std(3) = 2 * _std_weight_position * measurement[3];
-		std(4) = 10 * _std_weight_velocity * measurement[3];
-		std(5) = 10 * _std_weight_velocity * measurement[3];
-		std(6) = 1e-5;
-		std(7) = 10 * _std_weight_velocity * measurement[3];
-
-		KAL_MEAN tmp = std.array().square();
-		KAL_COVA var = tmp.asDiagonal();
-		return std::make_pair(mean, var);
+		return slot;
 	}
 
-	void KalmanFilter::predict(KAL_MEAN &mean, KAL_COVA &covariance)
+	void KalmanFilter::release(int slot)
 	{
-		//revise the data;
-		DETECTBOX std_pos;
-		std_pos << _std_weight_position * mean(3),
-			_std_weight_position * mean(3),
-			1e-2,
-			_std_weight_position * mean(3);
-		DETECTBOX std_vel;
-		std_vel << _std_weight_velocity * mean(3),
-			_std_weight_velocity * mean(3),
-			1e-5,
-			_std_weight_velocity * mean(3);
-		KAL_MEAN tmp;
-		tmp.block<1, 4>(0, 0) = std_pos;
-		tmp.block<1, 4>(0, 4) = std_vel;
-		tmp = tmp.array().square();
-		KAL_COVA motion_cov = tmp.asDiagonal();
-		KAL_MEAN mean1 = this->_motion_mat * mean.transpose();
-		KAL_COVA covariance1 = this->_motion_mat * covariance *(_motion_mat.transpose());
-		covariance1 += motion_cov;
-
-		mean = mean1;
-		covariance = covariance1;
+		if (slot < 0 || !used[slot])
+			return;
+
+		// Keep the free lanes finite, predict runs over them as well.
+		for (int k = 0; k < N_ROWS; k++)
+			state[k * capacity + slot] = 0.0f;
+
+		used[slot] = 0;
+		free_slots.push_back(slot);
 	}
 
-	KAL_HDATA KalmanFilter::project(const KAL_MEAN &mean, const KAL_COVA &covariance)
+	void KalmanFilter::predict(const std::vector<int> &slots)
 	{
-		DETECTBOX std;
-		std << _std_weight_position * mean(3), _std_weight_position * mean(3),
-			1e-1, _std_weight_position * mean(3);
-		KAL_HMEAN mean1 = _update_mat * mean.transpose();
-		KAL_HCOVA covariance1 = _update_mat * covariance * (_update_mat.transpose());
-		Eigen::Matrix<float, 4, 4> diag = std.asDiagonal();
-		diag = diag.array().square().matrix();
-		covariance1 += diag;
-		//    covariance1.diagonal() << diag;
-		return std::make_pair(mean1, covariance1);
+		if (slots.empty())
+			return;
+
+		std::fill(mask.begin(), mask.end(), 0.0f);
+
+		for (int slot : slots)
+			mask[slot] = 1.0f;
+
+		float *s = state.data();
+		const bt_vec wpos = bt_set(_std_weight_position);
+		const bt_vec wvel = bt_set(_std_weight_velocity);
+		const bt_vec qpos_a = bt_set(1e-2f * 1e-2f);
+		const bt_vec qvel_a = bt_set(1e-5f * 1e-5f);
+
+		// Capacity is a multiple of the vector width, tracks which are not
+		// predicted are masked out.
+		for (int i = 0; i < capacity; i += BT_VEC_LANES)
+		{
+			bt_vec m = bt_load(&mask[i]);
+			bt_vec h = bt_load(&s[(MEAN + 3) * capacity + i]);
+			bt_vec qpos = bt_mul(wpos, h);
+			bt_vec qvel = bt_mul(wvel, h);
+
+			qpos = bt_mul(qpos, qpos);
+			qvel = bt_mul(qvel, qvel);
+
+			for (int d = 0; d < 4; d++)
+			{
+				float *pos = &s[(MEAN + d) * capacity + i];
+				float *vel = &s[(MEAN + 4 + d) * capacity + i];
+				float *pp = &s[(COV_PP + d) * capacity + i];
+				float *pv = &s[(COV_PV + d) * capacity + i];
+				float *vv = &s[(COV_VV + d) * capacity + i];
+
+				bt_vec p = bt_load(pos), v = bt_load(vel);
+				bt_vec cpp = bt_load(pp), cpv = bt_load(pv), cvv = bt_load(vv);
+
+				// x' = x + v, P' = F * P * F^T + Q
+				bt_store(pos, bt_add(p, bt_mul(m, v)));
+				bt_store(pp, bt_add(cpp, bt_mul(m, bt_add(bt_add(bt_add(cpv, cpv), cvv),
+					(d == 2) ? qpos_a : qpos))));
+				bt_store(pv, bt_add(cpv, bt_mul(m, cvv)));
+				bt_store(vv, bt_add(cvv, bt_mul(m, (d == 2) ? qvel_a : qvel)));
+			}
+		}
 	}
 
-	KAL_DATA
-		KalmanFilter::update(
-			const KAL_MEAN &mean,
-			const KAL_COVA &covariance,
-			const DETECTBOX &measurement)
+	void KalmanFilter::stage(int slot, const float measurement[4])
 	{
-		KAL_HDATA pa = project(mean, covariance);
-		KAL_HMEAN projected_mean = pa.first;
-		KAL_HCOVA projected_cov = pa.second;
-
-		//chol_factor, lower =
-		//scipy.linalg.cho_factor(projected_cov, lower=True, check_finite=False)
-		//kalmain_gain =
-		//scipy.linalg.cho_solve((cho_factor, lower),
-		//np.dot(covariance, self._upadte_mat.T).T,
-		//check_finite=False).T
-		Eigen::Matrix<float, 4, 8> B = (covariance * (_update_mat.transpose())).transpose();
-		Eigen::Matrix<float, 8, 4> kalman_gain = (projected_cov.llt().solve(B)).transpose(); // eg.8x4
-		Eigen::Matrix<float, 1, 4> innovation = measurement - projected_mean; //eg.1x4
-		auto tmp = innovation * (kalman_gain.transpose());
-		KAL_MEAN new_mean = (mean.array() + tmp.array()).matrix();
-		KAL_COVA new_covariance = covariance - kalman_gain * projected_cov*(kalman_gain.transpose());
-		return std::make_pair(new_mean, new_covariance);
+		staged_slots.push_back(slot);
+		staged_measurements.insert(staged_measurements.end(), measurement, measurement + 4);
 	}
 
-	Eigen::Matrix<float, 1, -1>
-		KalmanFilter::gating_distance(
-			const KAL_MEAN &mean,
-			const KAL_COVA &covariance,
-			const std::vector<DETECTBOX> &measurements,
-			bool only_position)
+	void KalmanFilter::update()
 	{
-		KAL_HDATA pa = this->project(mean, covariance);
-		if (only_position) {
-			printf("not implement!");
-			exit(0);
+		int n = (int) staged_slots.size();
+
+		if (n == 0)
+			return;
+
+		int stride = align_lanes(n);
+		batch.assign((size_t) BATCH_ROWS * stride, 0.0f);
+
+		// Gather the staged tracks into a packed batch. Padding lanes keep a
+		// unit variance to stay finite.
+		for (int k = 0; k < N_ROWS; k++)
+			for (int j = 0; j < n; j++)
+				batch[k * stride + j] = state[k * capacity + staged_slots[j]];
+
+		for (int d = 0; d < 4; d++)
+		{
+			for (int j = 0; j < n; j++)
+				batch[(N_ROWS + d) * stride + j] = staged_measurements[j * 4 + d];
+			for (int j = n; j < stride; j++)
+				batch[(COV_PP + d) * stride + j] = 1.0f;
 		}
-		KAL_HMEAN mean1 = pa.first;
-		KAL_HCOVA covariance1 = pa.second;
-
-		//    Eigen::Matrix<float, -1, 4, Eigen::RowMajor> d(size, 4);
-		DETECTBOXSS d(measurements.size(), 4);
-		int pos = 0;
-		for (DETECTBOX box : measurements) {
-			d.row(pos++) = box - mean1;
+
+		float *b = batch.data();
+		const bt_vec wpos = bt_set(_std_weight_position);
+		const bt_vec rpos_a = bt_set(1e-1f * 1e-1f);
+
+		for (int i = 0; i < stride; i += BT_VEC_LANES)
+		{
+			bt_vec h = bt_load(&b[(MEAN + 3) * stride + i]);
+			bt_vec rpos = bt_mul(wpos, h);
+
+			rpos = bt_mul(rpos, rpos);
+
+			for (int d = 0; d < 4; d++)
+			{
+				float *pos = &b[(MEAN + d) * stride + i];
+				float *vel = &b[(MEAN + 4 + d) * stride + i];
+				float *pp = &b[(COV_PP + d) * stride + i];
+				float *pv = &b[(COV_PV + d) * stride + i];
+				float *vv = &b[(COV_VV + d) * stride + i];
+
+				bt_vec cpp = bt_load(pp), cpv = bt_load(pv), cvv = bt_load(vv);
+
+				// Innovation covariance S and Kalman gain K = P * H^T / S.
+				bt_vec s = bt_add(cpp, (d == 2) ? rpos_a : rpos);
+				bt_vec k0 = bt_div(cpp, s);
+				bt_vec k1 = bt_div(cpv, s);
+				bt_vec y = bt_sub(bt_load(&b[(N_ROWS + d) * stride + i]), bt_load(pos));
+
+				bt_store(pos, bt_add(bt_load(pos), bt_mul(k0, y)));
+				bt_store(vel, bt_add(bt_load(vel), bt_mul(k1, y)));
+
+				// P' = P - K * S * K^T
+				bt_store(pp, bt_sub(cpp, bt_mul(k0, cpp)));
+				bt_store(pv, bt_sub(cpv, bt_mul(k0, cpv)));
+				bt_store(vv, bt_sub(cvv, bt_mul(k1, cpv)));
+			}
 		}
-		Eigen::Matrix<float, -1, -1, Eigen::RowMajor> factor = covariance1.llt().matrixL();
-		Eigen::Matrix<float, -1, -1> z = factor.triangularView<Eigen::Lower>().solve<Eigen::OnTheRight>(d).transpose();
-		auto zz = ((z.array())*(z.array())).matrix();
-		auto square_maha = zz.colwise().sum();
-		return square_maha;
+
+		for (int k = 0; k < N_ROWS; k++)
+			for (int j = 0; j < n; j++)
+				state[k * capacity + staged_slots[j]] = batch[k * stride + j];
+
+		staged_slots.clear();
+		staged_measurements.clear();
 	}
 }
@@ -29,32 +29,68 @@
 
 #pragma once
 
-#include "dataType.h"
+#include <vector>
 
 namespace byte_kalman
 {
+	/*
+	 * Constant velocity Kalman filter of (x, y, aspect, height) boxes.
+	 *
+	 * Motion and observation models never couple different box dimensions,
+	 * so the 8x8 covariance of a track reduces to 4 independent 2x2 blocks:
+	 * position variance, position/velocity covariance and velocity variance.
+	 *
+	 * The state of all tracks is kept in structure of arrays layout, row k of
+	 * the track in slot i is at state[k * capacity + i]. Predict runs over
+	 * contiguous rows and update over packed batches, 4 tracks at a time.
+	 */
 	class KalmanFilter
 	{
 	public:
-		static const double chi2inv95[10];
+		enum Row
+		{
+			MEAN = 0,     // 8 rows: x, y, a, h and their velocities
+			COV_PP = 8,   // 4 rows: position variance
+			COV_PV = 12,  // 4 rows: position/velocity covariance
+			COV_VV = 16,  // 4 rows: velocity variance
+			N_ROWS = 20
+		};
+
 		KalmanFilter();
-		KAL_DATA initiate(const DETECTBOX& measurement);
-		void predict(KAL_MEAN& mean, KAL_COVA& covariance);
-		KAL_HDATA project(const KAL_MEAN& mean, const KAL_COVA& covariance);
-		KAL_DATA update(const KAL_MEAN& mean,
-			const KAL_COVA& covariance,
-			const DETECTBOX& measurement);
-
-		Eigen::Matrix<float, 1, -1> gating_distance(
-			const KAL_MEAN& mean,
-			const KAL_COVA& covariance,
-			const std::vector<DETECTBOX>& measurements,
-			bool only_position = false);
+
+		// Allocate a slot for a new track and initialize its state from the
+		// (x, y, a, h) measurement.
+		int initiate(const float measurement[4]);
+		// Free the slot of a track which is no longer tracked.
+		void release(int slot);
+
+		// Predict the state of the given tracks one frame ahead.
+		void predict(const std::vector<int> &slots);
+
+		// Queue a measurement for the track in slot, applied by update().
+		void stage(int slot, const float measurement[4]);
+		// Correct the state of all tracks with the staged measurements.
+		void update();
+
+		float mean(int slot, int idx) const { return state[(MEAN + idx) * capacity + slot]; }
+		bool in_use(int slot) const { return used[slot] != 0; }
+		int size() const { return capacity; }
 
 	private:
-		Eigen::Matrix<float, 8, 8, Eigen::RowMajor> _motion_mat;
-		Eigen::Matrix<float, 4, 8, Eigen::RowMajor> _update_mat;
+		void grow();
+
 		float _std_weight_position;
 		float _std_weight_velocity;
+
+		int capacity;
+		std::vector<float> state;
+		std::vector<char> used;
+		std::vector<int> free_slots;
+
+		// Scratch reused across frames.
+		std::vector<float> mask;
+		std::vector<int> staged_slots;
+		std::vector<float> staged_measurements;
+		std::vector<float> batch;
 	};
 }
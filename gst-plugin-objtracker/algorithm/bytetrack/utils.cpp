@@ -27,111 +27,127 @@
  * SPDX-License-Identifier: BSD-3-Clause-Clear
  */
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
 #include "BYTETracker.h"
+#include "bytetrack-simd.h"
 #include "lapjv.h"
 
 using namespace std; 
 
-vector<STrack*> BYTETracker::joint_stracks(vector<STrack*> &tlista, vector<STrack> &tlistb)
+void BYTETracker::next_mark()
+{
+	Scratch &s = this->scratch;
+
+	if (s.marks.size() < this->kalman_filter.size())
+		s.marks.resize(this->kalman_filter.size(), 0);
+
+	if (++s.epoch == 0)
+	{
+		std::fill(s.marks.begin(), s.marks.end(), 0);
+		s.epoch = 1;
+	}
+}
+
+// Marks the Kalman slot of a track, returns false if it was already marked.
+// Slots are 1:1 with track ids, so this replaces the per call id maps.
+bool BYTETracker::mark(const STrack &track)
 {
-	map<int, int> exists;
-	vector<STrack*> res;
+	Scratch &s = this->scratch;
+
+	if (s.marks[track.slot] == s.epoch)
+		return false;
+
+	s.marks[track.slot] = s.epoch;
+	return true;
+}
+
+void BYTETracker::joint_stracks(vector<STrack*> &tlista, vector<STrack> &tlistb, vector<STrack*> &res)
+{
+	next_mark();
+	res.clear();
 	for (int i = 0; i < tlista.size(); i++)
 	{
-		exists.insert(pair<int, int>(tlista[i]->track_id, 1));
+		mark(*tlista[i]);
 		res.push_back(tlista[i]);
 	}
 	for (int i = 0; i < tlistb.size(); i++)
 	{
-		int tid = tlistb[i].track_id;
-		if (!exists[tid] || exists.count(tid) == 0)
-		{
-			exists[tid] = 1;
+		if (mark(tlistb[i]))
 			res.push_back(&tlistb[i]);
-		}
 	}
-	return res;
 }
 
-vector<STrack> BYTETracker::joint_stracks(vector<STrack> &tlista, vector<STrack> &tlistb)
+void BYTETracker::joint_stracks(vector<STrack> &tlista, vector<STrack> &tlistb, vector<STrack> &res)
 {
-	map<int, int> exists;
-	vector<STrack> res;
+	next_mark();
+	res.clear();
 	for (int i = 0; i < tlista.size(); i++)
 	{
-		exists.insert(pair<int, int>(tlista[i].track_id, 1));
+		mark(tlista[i]);
 		res.push_back(tlista[i]);
 	}
 	for (int i = 0; i < tlistb.size(); i++)
 	{
-		int tid = tlistb[i].track_id;
-		if (!exists[tid] || exists.count(tid) == 0)
-		{
-			exists[tid] = 1;
+		if (mark(tlistb[i]))
 			res.push_back(tlistb[i]);
-		}
 	}
-	return res;
 }
 
-vector<STrack> BYTETracker::sub_stracks(vector<STrack> &tlista, vector<STrack> &tlistb)
+void BYTETracker::sub_stracks(vector<STrack> &tlista, vector<STrack> &tlistb, vector<STrack> &res)
 {
-	map<int, STrack> stracks;
-	for (int i = 0; i < tlista.size(); i++)
-	{
-		stracks.insert(pair<int, STrack>(tlista[i].track_id, tlista[i]));
-	}
+	next_mark();
+	res.clear();
 	for (int i = 0; i < tlistb.size(); i++)
 	{
-		int tid = tlistb[i].track_id;
-		if (stracks.count(tid) != 0)
-		{
-			stracks.erase(tid);
-		}
+		mark(tlistb[i]);
 	}
-
-	vector<STrack> res;
-	std::map<int, STrack>::iterator  it;
-	for (it = stracks.begin(); it != stracks.end(); ++it)
+	for (int i = 0; i < tlista.size(); i++)
 	{
-		res.push_back(it->second);
+		if (mark(tlista[i]))
+			res.push_back(tlista[i]);
 	}
 
-	return res;
+	// Keep the track id order of the former map based implementation.
+	std::sort(res.begin(), res.end(), [] (const STrack &a, const STrack &b) {
+		return a.track_id < b.track_id;
+	});
 }
 
 
 //remove tracks that have large overlap (i.e. small iou distance), keep the one with longer tracker history, return the remaining once
 void BYTETracker::remove_duplicate_stracks(std::vector<STrack> &resa, std::vector<STrack> &resb, std::vector<STrack> &stracksa, std::vector<STrack> &stracksb)
 {
-    std::vector<std::vector<float> > pdist = iou_distance(stracksa, stracksb);  // dist = 1 - iou
-    std::vector<std::pair<int, int> > pairs;
-	for (int i = 0; i < pdist.size(); i++)
+	Scratch &s = this->scratch;
+	CostMatrix &pdist = s.dists;
+
+	iou_distance(stracksa, stracksb, pdist);  // dist = 1 - iou
+
+	s.dup_a.assign(stracksa.size(), 0);
+	s.dup_b.assign(stracksb.size(), 0);
+
+	for (int i = 0; i < pdist.rows; i++)
 	{
-		for (int j = 0; j < pdist[i].size(); j++)
+		const float *row = pdist.row(i);
+		for (int j = 0; j < pdist.cols; j++)
 		{
-			if (pdist[i][j] < 0.15)
-			{
-				pairs.push_back(pair<int, int>(i, j));
-			}
-		}
-	}
+			if (row[j] >= 0.15)
+				continue;
 
-	std::vector<int> dupa, dupb;
-	for (int i = 0; i < pairs.size(); i++)
-	{
-		int timep = stracksa[pairs[i].first].frame_id - stracksa[pairs[i].first].start_frame;
-		int timeq = stracksb[pairs[i].second].frame_id - stracksb[pairs[i].second].start_frame;
-		if (timep >= timeq)
-			dupb.push_back(pairs[i].second);
-		else
-			dupa.push_back(pairs[i].first);
+			int timep = stracksa[i].frame_id - stracksa[i].start_frame;
+			int timeq = stracksb[j].frame_id - stracksb[j].start_frame;
+			if (timep >= timeq)
+				s.dup_b[j] = 1;
+			else
+				s.dup_a[i] = 1;
+		}
 	}
 
 	for (int i = 0; i < stracksa.size(); i++)
 	{
-        std::vector<int>::iterator iter = find(dupa.begin(), dupa.end(), i);
-		if (iter == dupa.end())
+		if (!s.dup_a[i])
 		{
 			resa.push_back(stracksa[i]);
 		}
@@ -139,40 +155,37 @@ void BYTETracker::remove_duplicate_stracks(std::vector<STrack> &resa, std::vecto
 
 	for (int i = 0; i < stracksb.size(); i++)
 	{
-        std::vector<int>::iterator iter = find(dupb.begin(), dupb.end(), i);
-		if (iter == dupb.end())
+		if (!s.dup_b[i])
 		{
 			resb.push_back(stracksb[i]);
 		}
 	}
 }
 
-void BYTETracker::linear_assignment(vector<vector<float> > &cost_matrix, int cost_matrix_size, int cost_matrix_size_size, float thresh,
-	vector<vector<int> > &matches, vector<int> &unmatched_a, vector<int> &unmatched_b)
+void BYTETracker::linear_assignment(CostMatrix &cost_matrix, float thresh,
+	vector<pair<int, int> > &matches, vector<int> &unmatched_a, vector<int> &unmatched_b)
 {
-	if (cost_matrix.size() == 0)
+	if (cost_matrix.empty())
 	{
-		for (int i = 0; i < cost_matrix_size; i++)
+		for (int i = 0; i < cost_matrix.rows; i++)
 		{
 			unmatched_a.push_back(i);
 		}
-		for (int i = 0; i < cost_matrix_size_size; i++)
+		for (int i = 0; i < cost_matrix.cols; i++)
 		{
 			unmatched_b.push_back(i);
 		}
 		return;
 	}
 
-	vector<int> rowsol; vector<int> colsol;
-	float c = (float) lapjv(cost_matrix, rowsol, colsol, true, thresh);
+	vector<int> &rowsol = this->scratch.rowsol;
+	vector<int> &colsol = this->scratch.colsol;
+	lapjv(cost_matrix, rowsol, colsol, true, thresh, false);
 	for (int i = 0; i < rowsol.size(); i++)
 	{
 		if (rowsol[i] >= 0)
 		{
-			vector<int> match;
-			match.push_back(i);
-			match.push_back(rowsol[i]);
-			matches.push_back(match);
+			matches.push_back(pair<int, int>(i, rowsol[i]));
 		}
 		else
 		{
@@ -189,123 +202,107 @@ void BYTETracker::linear_assignment(vector<vector<float> > &cost_matrix, int cos
 	}
 }
 
-vector<vector<float> > BYTETracker::ious(vector<vector<float> > &atlbrs, vector<vector<float> > &btlbrs)
+// Fills the cost matrix with 1 - IoU of the boxes staged in scratch by
+// iou_distance(), vectorized over the columns.
+void BYTETracker::ious(CostMatrix &cost_matrix)
 {
-	vector<vector<float> > ious;
-	if (atlbrs.size()*btlbrs.size() == 0)
-		return ious;
-
-	ious.resize(atlbrs.size());
-	for (int i = 0; i < ious.size(); i++)
+	const int rows = cost_matrix.rows;
+	const int cols = cost_matrix.cols;
+	const int stride = (cols + BT_VEC_LANES - 1) & ~(BT_VEC_LANES - 1);
+	float *boxes = &this->scratch.boxes[0];
+
+	// Column boxes and areas, one padded array per coordinate, followed by
+	// the row boxes.
+	float *bx0 = boxes;
+	float *by0 = bx0 + stride;
+	float *bx1 = by0 + stride;
+	float *by1 = bx1 + stride;
+	float *barea = by1 + stride;
+	float *dist = barea + stride;
+	const float *abox = dist + stride;
+
+	for (int k = 0; k < stride; k++)
+		barea[k] = (bx1[k] - bx0[k] + 1) * (by1[k] - by0[k] + 1);
+
+	const bt_vec one = bt_set(1.0f);
+
+	for (int n = 0; n < rows; n++, abox += 4)
 	{
-		ious[i].resize(btlbrs.size());
-	}
+		float area = (abox[2] - abox[0] + 1) * (abox[3] - abox[1] + 1);
+		bt_vec ax0 = bt_set(abox[0]), ay0 = bt_set(abox[1]);
+		bt_vec ax1 = bt_set(abox[2]), ay1 = bt_set(abox[3]);
+		bt_vec aarea = bt_set(area);
 
-	//bbox_ious
-	for (int k = 0; k < btlbrs.size(); k++)
-	{
-		vector<float> ious_tmp;
-		float box_area = (btlbrs[k][2] - btlbrs[k][0] + 1)*(btlbrs[k][3] - btlbrs[k][1] + 1);
-		for (int n = 0; n < atlbrs.size(); n++)
+		for (int k = 0; k < stride; k += BT_VEC_LANES)
 		{
-			float iw = min(atlbrs[n][2], btlbrs[k][2]) - max(atlbrs[n][0], btlbrs[k][0]) + 1;
-			if (iw > 0)
-			{
-				float ih = min(atlbrs[n][3], btlbrs[k][3]) - max(atlbrs[n][1], btlbrs[k][1]) + 1;
-				if(ih > 0)
-				{
-					float ua = (atlbrs[n][2] - atlbrs[n][0] + 1)*(atlbrs[n][3] - atlbrs[n][1] + 1) + box_area - iw * ih;
-					ious[n][k] = iw * ih / ua;
-				}
-				else
-				{
-					ious[n][k] = 0.0;
-				}
-			}
-			else
-			{
-				ious[n][k] = 0.0;
-			}
+			bt_vec iw = bt_add(bt_sub(bt_min(ax1, bt_load(bx1 + k)), bt_max(ax0, bt_load(bx0 + k))), one);
+			bt_vec ih = bt_add(bt_sub(bt_min(ay1, bt_load(by1 + k)), bt_max(ay0, bt_load(by0 + k))), one);
+			bt_vec inter = bt_mul(iw, ih);
+			bt_vec ua = bt_sub(bt_add(aarea, bt_load(barea + k)), inter);
+			bt_vec iou = bt_positive(iw, bt_positive(ih, bt_div(inter, ua)));
+			bt_store(dist + k, bt_sub(one, iou));
 		}
-	}
 
-	return ious;
+		std::copy(dist, dist + cols, cost_matrix.row(n));
+	}
 }
 
-vector<vector<float> > BYTETracker::iou_distance(vector<STrack*> &atracks, vector<STrack> &btracks, int &dist_size, int &dist_size_size)
+static inline const float *strack_tlbr(const STrack *track) { return track->tlbr; }
+static inline const float *strack_tlbr(const STrack &track) { return track.tlbr; }
+
+// Stages the boxes of both track lists in scratch, see ious() for the layout.
+template<typename T>
+static void stage_boxes(vector<float> &boxes, const vector<T> &atracks, const vector<T> &btracks)
 {
-	vector<vector<float> > cost_matrix;
-	if (atracks.size() * btracks.size() == 0)
-	{
-		dist_size = (int) atracks.size();
-		dist_size_size = (int) btracks.size();
-		return cost_matrix;
-	}
-	vector<vector<float> > atlbrs, btlbrs;
-	for (int i = 0; i < atracks.size(); i++)
-	{
-		atlbrs.push_back(atracks[i]->tlbr);
-	}
-	for (int i = 0; i < btracks.size(); i++)
-	{
-		btlbrs.push_back(btracks[i].tlbr);
-	}
+	const int rows = (int) atracks.size();
+	const int cols = (int) btracks.size();
+	const int stride = (cols + BT_VEC_LANES - 1) & ~(BT_VEC_LANES - 1);
 
-	dist_size = (int) atracks.size();
-	dist_size_size = (int) btracks.size();
+	// Padding lanes hold an empty box at the origin, their results are dropped.
+	boxes.assign((size_t) stride * 6 + (size_t) rows * 4, 0.0f);
 
-	vector<vector<float> > _ious = ious(atlbrs, btlbrs);
-	
-	for (int i = 0; i < _ious.size();i++)
+	for (int k = 0; k < cols; k++)
 	{
-		vector<float> _iou;
-		for (int j = 0; j < _ious[i].size(); j++)
-		{
-			_iou.push_back(1 - _ious[i][j]);
-		}
-		cost_matrix.push_back(_iou);
+		const float *tlbr = strack_tlbr(btracks[k]);
+		for (int c = 0; c < 4; c++)
+			boxes[(size_t) c * stride + k] = tlbr[c];
 	}
 
-	return cost_matrix;
+	float *abox = &boxes[(size_t) stride * 6];
+	for (int n = 0; n < rows; n++, abox += 4)
+	{
+		const float *tlbr = strack_tlbr(atracks[n]);
+		std::copy(tlbr, tlbr + 4, abox);
+	}
 }
 
-vector<vector<float> > BYTETracker::iou_distance(vector<STrack> &atracks, vector<STrack> &btracks)
+void BYTETracker::iou_distance(const vector<STrack*> &atracks, const vector<STrack*> &btracks, CostMatrix &cost_matrix)
 {
-	vector<vector<float> > atlbrs, btlbrs;
-	for (int i = 0; i < atracks.size(); i++)
-	{
-		atlbrs.push_back(atracks[i].tlbr);
-	}
-	for (int i = 0; i < btracks.size(); i++)
-	{
-		btlbrs.push_back(btracks[i].tlbr);
-	}
+	cost_matrix.resize((int) atracks.size(), (int) btracks.size());
+	if (cost_matrix.empty())
+		return;
 
-	vector<vector<float> > _ious = ious(atlbrs, btlbrs);
-	vector<vector<float> > cost_matrix;
-	for (int i = 0; i < _ious.size(); i++)
-	{
-		vector<float> _iou;
-		for (int j = 0; j < _ious[i].size(); j++)
-		{
-			_iou.push_back(1 - _ious[i][j]);
-		}
-		cost_matrix.push_back(_iou);
-	}
+	stage_boxes(this->scratch.boxes, atracks, btracks);
+	ious(cost_matrix);
+}
 
-	return cost_matrix;
+void BYTETracker::iou_distance(const vector<STrack> &atracks, const vector<STrack> &btracks, CostMatrix &cost_matrix)
+{
+	cost_matrix.resize((int) atracks.size(), (int) btracks.size());
+	if (cost_matrix.empty())
+		return;
+
+	stage_boxes(this->scratch.boxes, atracks, btracks);
+	ious(cost_matrix);
 }
 
-double BYTETracker::lapjv(const vector<vector<float> > &cost, vector<int> &rowsol, vector<int> &colsol,
+double BYTETracker::lapjv(const CostMatrix &cost, vector<int> &rowsol, vector<int> &colsol,
 	bool extend_cost, float cost_limit, bool return_cost)
 {
-	vector<vector<float> > cost_c;
-	cost_c.assign(cost.begin(), cost.end());
-
-	vector<vector<float> > cost_c_extended;
+	Scratch &s = this->scratch;
 
-	int n_rows = (int) cost.size();
-	int n_cols = (int) cost[0].size();
+	int n_rows = cost.rows;
+	int n_cols = cost.cols;
 	rowsol.resize(n_rows);
 	colsol.resize(n_cols);
 
@@ -323,78 +320,52 @@ double BYTETracker::lapjv(const vector<vector<float> > &cost, vector<int> &rowso
 			exit(0);
 		}
 	}
-		
+
 	if (extend_cost || cost_limit < LONG_MAX)
 	{
 		n = n_rows + n_cols;
-		cost_c_extended.resize(n);
-		for (int i = 0; i < cost_c_extended.size(); i++)
-			cost_c_extended[i].resize(n);
 
+		float fill;
 		if (cost_limit < LONG_MAX)
 		{
-			for (int i = 0; i < cost_c_extended.size(); i++)
-			{
-				for (int j = 0; j < cost_c_extended[i].size(); j++)
-				{
-					cost_c_extended[i][j] = cost_limit / 2.0f;
-				}
-			}
+			fill = cost_limit / 2.0f;
 		}
 		else
 		{
 			float cost_max = -1;
-			for (int i = 0; i < cost_c.size(); i++)
+			for (int i = 0; i < cost.data.size(); i++)
 			{
-				for (int j = 0; j < cost_c[i].size(); j++)
-				{
-					if (cost_c[i][j] > cost_max)
-						cost_max = cost_c[i][j];
-				}
-			}
-			for (int i = 0; i < cost_c_extended.size(); i++)
-			{
-				for (int j = 0; j < cost_c_extended[i].size(); j++)
-				{
-					cost_c_extended[i][j] = cost_max + 1;
-				}
+				if (cost.data[i] > cost_max)
+					cost_max = cost.data[i];
 			}
+			fill = cost_max + 1;
 		}
 
-		for (int i = n_rows; i < cost_c_extended.size(); i++)
+		s.lap_cost.assign((size_t) n * n, fill);
+		for (int i = n_rows; i < n; i++)
 		{
-			for (int j = n_cols; j < cost_c_extended[i].size(); j++)
-			{
-				cost_c_extended[i][j] = 0;
-			}
+			std::fill(&s.lap_cost[(size_t) i * n + n_cols], &s.lap_cost[(size_t) i * n] + n, 0.0);
 		}
-		for (int i = 0; i < n_rows; i++)
-		{
-			for (int j = 0; j < n_cols; j++)
-			{
-				cost_c_extended[i][j] = cost_c[i][j];
-			}
-		}
-
-		cost_c.clear();
-		cost_c.assign(cost_c_extended.begin(), cost_c_extended.end());
+	}
+	else
+	{
+		s.lap_cost.resize((size_t) n * n);
 	}
 
-	double **cost_ptr;
-	cost_ptr = new double *[sizeof(double *) * n];
-	for (int i = 0; i < n; i++)
-		cost_ptr[i] = new double[sizeof(double) * n];
-
-	for (int i = 0; i < n; i++)
+	for (int i = 0; i < n_rows; i++)
 	{
-		for (int j = 0; j < n; j++)
-		{
-			cost_ptr[i][j] = cost_c[i][j];
-		}
+		std::copy(cost.row(i), cost.row(i) + n_cols, &s.lap_cost[(size_t) i * n]);
 	}
 
-	int* x_c = new int[sizeof(int) * n];
-	int *y_c = new int[sizeof(int) * n];
+	s.lap_rows.resize(n);
+	for (int i = 0; i < n; i++)
+		s.lap_rows[i] = &s.lap_cost[(size_t) i * n];
+
+	s.lap_x.resize(n);
+	s.lap_y.resize(n);
+	int *x_c = s.lap_x.data();
+	int *y_c = s.lap_y.data();
+	double **cost_ptr = s.lap_rows.data();
 
 	int ret = lapjv_internal(n, cost_ptr, x_c, y_c);
 	if (ret != 0)
@@ -444,14 +415,6 @@ double BYTETracker::lapjv(const vector<vector<float> > &cost, vector<int> &rowso
 		}
 	}
 
-	for (int i = 0; i < n; i++)
-	{
-		delete[]cost_ptr[i];
-	}
-	delete[]cost_ptr;
-	delete[]x_c;
-	delete[]y_c;
-
 	return opt;
 }
 
@@ -58,13 +58,19 @@ typedef std::vector<TrackerAlgoOutputData> (*TrackerAlgoExecute)
  */
 typedef void (*TrackerAlgoDelete) (void *tracker);
 
+typedef struct _GstObjTrackerStream GstObjTrackerStream;
+
 /**
  * _GstObjTrackerAlgo:
  * @handle: Library handle.
  * @name: Library (Algorithm) name.
- * @subalgo: Pointer to private algorithm structure.
- * @roiregions: Pointer to roi metadata hash table.
- * @bboxregions: Pointer to bbox hash table.
+ * @params: Parameters used to create the subalgo instance of each stream.
+ * @streams: Pointer to hash table with the tracker state of each stream.
+ * @workers: Pool of threads updating independent streams in parallel.
+ * @n_threads: Number of threads updating the streams, including the caller.
+ * @tasklock: Lock protecting the number of pending tasks.
+ * @wakeup: Signalled when the last pending task has finished.
+ * @pending: Number of tasks not yet finished by the worker threads.
  *
  * @algocreate: Function pointer to the subalgo 'TrackerAlgoCreate' API.
  * @algoexecute: Function pointer to the subalgo 'TrackerAlgoExecute' API.
@@ -75,9 +81,14 @@ typedef void (*TrackerAlgoDelete) (void *tracker);
 struct _GstObjTrackerAlgo {
   gpointer                  handle;
   gchar                     *name;
-  gpointer                  subalgo;
-  GHashTable                *roiregions;
-  GHashTable                *bboxregions;
+  ParameterTypeMap          *params;
+  GHashTable                *streams;
+
+  GThreadPool               *workers;
+  guint                     n_threads;
+  GMutex                    tasklock;
+  GCond                     wakeup;
+  guint                     pending;
 
   /// Interface functions.
   TrackerAlgoCreate         algocreate;
@@ -85,6 +96,27 @@ struct _GstObjTrackerAlgo {
   TrackerAlgoDelete         algodelete;
 };
 
+/**
+ * _GstObjTrackerStream:
+ * @algo: Pointer to the parent Objtracker algorithm.
+ * @id: Stream ID or the index in the batch if the stream ID is missing.
+ * @subalgo: Pointer to private algorithm structure, tracker of this stream.
+ * @roiregions: Pointer to roi metadata hash table.
+ * @bboxregions: Pointer to bbox hash table.
+ * @entries: Detection structures of this stream in the current batch.
+ *
+ * Tracking state of a single stream. Streams are independent from each other
+ * and are updated in parallel, entries of the same stream in order.
+ */
+struct _GstObjTrackerStream {
+  GstObjTrackerAlgo         *algo;
+  gint                      id;
+  gpointer                  subalgo;
+  GHashTable                *roiregions;
+  GHashTable                *bboxregions;
+  GPtrArray                 *entries;
+};
+
 typedef struct _GstRegionMetaEntry GstRegionMetaEntry;
 struct _GstRegionMetaEntry {
   // Unique ROI type/name.
@@ -135,6 +167,215 @@ gst_region_meta_entry_free (GstRegionMetaEntry * region)
   g_slice_free (GstRegionMetaEntry, region);
 }
 
+static GstObjTrackerStream *
+gst_objtracker_stream_new (GstObjTrackerAlgo * algo, gint id)
+{
+  GstObjTrackerStream *stream = g_slice_new0 (GstObjTrackerStream);
+
+  stream->algo = algo;
+  stream->id = id;
+
+  stream->subalgo = algo->algocreate (*(algo->params));
+
+  if (stream->subalgo == NULL) {
+    GST_ERROR ("Failed to create %s tracker for stream %d!", algo->name, id);
+    g_slice_free (GstObjTrackerStream, stream);
+    return NULL;
+  }
+
+  stream->roiregions = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) gst_region_meta_entry_free);
+
+  stream->bboxregions = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) gst_structure_free);
+
+  stream->entries = g_ptr_array_new ();
+
+  GST_INFO ("Created %s tracker for stream %d", algo->name, id);
+  return stream;
+}
+
+static void
+gst_objtracker_stream_free (GstObjTrackerStream * stream)
+{
+  if (stream->subalgo != NULL)
+    stream->algo->algodelete (stream->subalgo);
+
+  g_hash_table_destroy (stream->roiregions);
+  g_hash_table_destroy (stream->bboxregions);
+  g_ptr_array_free (stream->entries, TRUE);
+
+  g_slice_free (GstObjTrackerStream, stream);
+}
+
+static GstObjTrackerStream *
+gst_objtracker_algo_get_stream (GstObjTrackerAlgo * algo, gint id)
+{
+  GstObjTrackerStream *stream = NULL;
+
+  stream = (GstObjTrackerStream *) g_hash_table_lookup (algo->streams,
+      GINT_TO_POINTER (id));
+
+  if ((stream == NULL) &&
+      (stream = gst_objtracker_stream_new (algo, id)) != NULL)
+    g_hash_table_insert (algo->streams, GINT_TO_POINTER (id), stream);
+
+  return stream;
+}
+
+static void
+gst_objtracker_stream_process_entry (GstObjTrackerStream * stream,
+    GstStructure * structure)
+{
+  GstObjTrackerAlgo *algo = stream->algo;
+  TrackerAlgoInputData item;
+  gpointer key = NULL;
+  std::vector<TrackerAlgoInputData> data;
+  std::vector<TrackerAlgoOutputData> results;
+  const GValue *bboxes = NULL, *val = NULL;
+  GValue array = G_VALUE_INIT, value = G_VALUE_INIT;
+  GValue trackerbboxes = G_VALUE_INIT;
+  GstStructure *entry = NULL, *region = NULL, *trackerregion = NULL;
+  gdouble confidence = 0.0;
+  guint size = 0, idx = 0, id = 0;
+
+  bboxes = gst_structure_get_value (structure, "bounding-boxes");
+  if ((bboxes == NULL) || (size = gst_value_array_get_size (bboxes)) == 0) {
+    GST_INFO ("There are no bounding-boxes in stream %d!", stream->id);
+    return;
+  }
+
+  g_value_init (&array, GST_TYPE_ARRAY);
+  g_value_init (&trackerbboxes, GST_TYPE_ARRAY);
+
+  for (idx = 0; idx < size; idx++) {
+    val = gst_value_array_get_value (bboxes, idx);
+    entry = GST_STRUCTURE (g_value_get_boxed (val));
+
+    val = gst_structure_get_value (entry, "rectangle");
+    item.x = g_value_get_float (gst_value_array_get_value (val, 0));
+    item.y = g_value_get_float (gst_value_array_get_value (val, 1));
+    item.w = g_value_get_float (gst_value_array_get_value (val, 2));
+    item.h = g_value_get_float (gst_value_array_get_value (val, 3));
+
+    gst_structure_get_uint (entry, "id", &id);
+    item.detection_id = id;
+    gst_structure_get_double (entry, "confidence", &confidence);
+    item.prob = confidence;
+
+    key = GUINT_TO_POINTER (id);
+    region = gst_structure_copy (entry);
+    g_hash_table_insert (stream->bboxregions, key, region);
+
+    data.push_back(item);
+  }
+
+  //remove bounding-boxes
+  gst_structure_remove_field (structure, "bounding-boxes");
+
+  results = algo->algoexecute (stream->subalgo, data);
+
+  for (size_t i = 0; i < results.size(); i++) {
+    key = GUINT_TO_POINTER (results[i].matched_detection_id);
+    region = (GstStructure *) g_hash_table_lookup (stream->bboxregions,
+        key);
+
+    if (region == NULL)
+      continue;
+
+    g_value_init (&value, G_TYPE_FLOAT);
+    trackerregion = gst_structure_copy (region);
+
+    gst_structure_remove_field (trackerregion, "rectangle");
+    g_value_set_float (&value, results[i].x);
+    gst_value_array_append_value (&array, &value);
+    g_value_set_float (&value, results[i].y);
+    gst_value_array_append_value (&array, &value);
+    g_value_set_float (&value, results[i].w);
+    gst_value_array_append_value (&array, &value);
+    g_value_set_float (&value, results[i].h);
+    gst_value_array_append_value (&array, &value);
+    gst_structure_set_value (trackerregion, "rectangle", &array);
+    g_value_reset (&array);
+
+    gst_structure_set (trackerregion, "tracking-id", G_TYPE_UINT,
+        results[i].track_id, NULL);
+
+    g_value_unset (&value);
+    g_value_init (&value, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&value, trackerregion);
+    gst_value_array_append_value (&trackerbboxes, &value);
+    g_value_unset (&value);
+
+    g_hash_table_remove (stream->bboxregions, key);
+  }
+
+  gst_structure_set_value (structure, "bounding-boxes", &trackerbboxes);
+
+  g_value_unset (&array);
+  g_value_unset (&trackerbboxes);
+
+  g_hash_table_remove_all (stream->bboxregions);
+}
+
+static void
+gst_objtracker_stream_process (GstObjTrackerStream * stream)
+{
+  guint idx = 0;
+
+  // Entries of the same stream depend on each other, process them in order.
+  for (idx = 0; idx < stream->entries->len; idx++)
+    gst_objtracker_stream_process_entry (stream,
+        GST_STRUCTURE (g_ptr_array_index (stream->entries, idx)));
+
+  g_ptr_array_set_size (stream->entries, 0);
+}
+
+static void
+gst_objtracker_algo_task (gpointer data, gpointer userdata)
+{
+  GstObjTrackerStream *stream = (GstObjTrackerStream *) data;
+  GstObjTrackerAlgo *algo = (GstObjTrackerAlgo *) userdata;
+
+  gst_objtracker_stream_process (stream);
+
+  g_mutex_lock (&algo->tasklock);
+
+  if (--(algo->pending) == 0)
+    g_cond_signal (&algo->wakeup);
+
+  g_mutex_unlock (&algo->tasklock);
+}
+
+static void
+gst_objtracker_algo_dispatch (GstObjTrackerAlgo * algo, GPtrArray * streams)
+{
+  guint idx = 0;
+
+  if ((algo->workers == NULL) || (streams->len <= 1)) {
+    for (idx = 0; idx < streams->len; idx++)
+      gst_objtracker_stream_process (
+          (GstObjTrackerStream *) g_ptr_array_index (streams, idx));
+    return;
+  }
+
+  algo->pending = streams->len - 1;
+
+  // Offload all but the first stream which is processed in the calling thread.
+  for (idx = 1; idx < streams->len; idx++)
+    g_thread_pool_push (algo->workers, g_ptr_array_index (streams, idx), NULL);
+
+  gst_objtracker_stream_process (
+      (GstObjTrackerStream *) g_ptr_array_index (streams, 0));
+
+  g_mutex_lock (&algo->tasklock);
+
+  while (algo->pending != 0)
+    g_cond_wait (&algo->wakeup, &algo->tasklock);
+
+  g_mutex_unlock (&algo->tasklock);
+}
+
 static inline void
 gst_objtracker_algo_init_debug_category (void)
 {
@@ -172,6 +413,13 @@ gst_objtracker_algo_new (const gchar * name)
   gst_objtracker_algo_init_debug_category ();
 
   algo = g_new0 (GstObjTrackerAlgo, 1);
+
+  g_mutex_init (&algo->tasklock);
+  g_cond_init (&algo->wakeup);
+
+  algo->params = new ParameterTypeMap ();
+  algo->n_threads = 1;
+
   location = g_strdup_printf ("%s/libobjtracker-%s.so",
       GST_QTI_OBJTRACKER_ALGORITHM, name);
 
@@ -211,14 +459,16 @@ gst_objtracker_algo_free (GstObjTrackerAlgo * algo)
   if (NULL == algo)
     return;
 
-  if (algo->subalgo != NULL)
-    algo->algodelete (algo->subalgo);
+  if (algo->workers != NULL)
+    g_thread_pool_free (algo->workers, FALSE, TRUE);
 
-  if (algo->roiregions != NULL)
-    g_hash_table_destroy (algo->roiregions);
+  if (algo->streams != NULL)
+    g_hash_table_destroy (algo->streams);
 
-  if (algo->bboxregions != NULL)
-    g_hash_table_destroy (algo->bboxregions);
+  delete algo->params;
+
+  g_cond_clear (&algo->wakeup);
+  g_mutex_clear (&algo->tasklock);
 
   if (algo->handle != NULL)
     dlclose (algo->handle);
@@ -238,11 +488,8 @@ gst_objtracker_algo_init (GstObjTrackerAlgo * algo)
 {
   g_return_val_if_fail (algo != NULL, FALSE);
 
-  algo->roiregions = g_hash_table_new_full (NULL, NULL, NULL,
-      (GDestroyNotify) gst_region_meta_entry_free);
-
-  algo->bboxregions = g_hash_table_new_full (NULL, NULL, NULL,
-      (GDestroyNotify) gst_structure_free);
+  algo->streams = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) gst_objtracker_stream_free);
 
   return TRUE;
 }
@@ -254,6 +501,7 @@ gst_objtracker_algo_set_opts (GstObjTrackerAlgo * algo,
   gboolean success = TRUE;
   gdouble value;
   GstStructure *parameters = NULL;
+  GError *error = NULL;
   std::map<std::string, ParameterType> params;
   const GValue *frame_rate = NULL, *track_buffer = NULL,
       *wh_smooth_factor = NULL, *track_thresh = NULL,
@@ -261,10 +509,13 @@ gst_objtracker_algo_set_opts (GstObjTrackerAlgo * algo,
 
   g_return_val_if_fail (algo != NULL, FALSE);
 
-  if (options != NULL) {
-    success = gst_structure_has_field (options,
-        GST_OBJTRACKER_ALGO_OPT_PARAMETERS);
+  if ((options != NULL) &&
+      gst_structure_has_field (options, GST_OBJTRACKER_ALGO_OPT_N_THREADS))
+    gst_structure_get_uint (options, GST_OBJTRACKER_ALGO_OPT_N_THREADS,
+        &(algo->n_threads));
 
+  if ((options != NULL) &&
+      gst_structure_has_field (options, GST_OBJTRACKER_ALGO_OPT_PARAMETERS)) {
     parameters = GST_STRUCTURE (g_value_get_boxed (
         gst_structure_get_value (options,
         GST_OBJTRACKER_ALGO_OPT_PARAMETERS)));
@@ -332,10 +583,41 @@ gst_objtracker_algo_set_opts (GstObjTrackerAlgo * algo,
     params.emplace("high-thresh", (float)value);
   }
 
-  algo->subalgo = algo->algocreate(params);
-  if (algo->subalgo == NULL)
+  *(algo->params) = params;
+
+  // Trackers of all streams were created with the previous parameters, drop
+  // them and let each stream create a new tracker on its next entry.
+  g_hash_table_remove_all (algo->streams);
+
+  // Create the tracker of the first stream to validate the parameters.
+  if (gst_objtracker_algo_get_stream (algo, 0) == NULL)
     goto cleanup;
 
+  // Workers are idle between batches, resize or release them as needed.
+  if ((algo->workers != NULL) && (algo->n_threads <= 1)) {
+    g_thread_pool_free (algo->workers, FALSE, TRUE);
+    algo->workers = NULL;
+  } else if ((algo->workers != NULL) && !g_thread_pool_set_max_threads (
+          algo->workers, algo->n_threads - 1, &error)) {
+    GST_ERROR ("Failed to resize worker threads, error: '%s'!",
+        GST_STR_NULL (error->message));
+    g_clear_error (&error);
+    goto cleanup;
+  }
+
+  // The calling thread processes one of the streams, hence one less worker.
+  if ((algo->workers == NULL) && (algo->n_threads > 1)) {
+    algo->workers = g_thread_pool_new (gst_objtracker_algo_task, algo,
+        algo->n_threads - 1, TRUE, &error);
+
+    if (algo->workers == NULL) {
+      GST_ERROR ("Failed to create worker threads, error: '%s'!",
+          GST_STR_NULL (error->message));
+      g_clear_error (&error);
+      goto cleanup;
+    }
+  }
+
   return TRUE;
 
 cleanup:
@@ -346,23 +628,16 @@ gboolean
 gst_objtracker_algo_execute_text (GstObjTrackerAlgo * algo,
     gchar * input_text, gchar ** output_text)
 {
-  TrackerAlgoInputData item;
-  gpointer key = NULL;
-  std::vector<TrackerAlgoInputData> data;
-  std::vector<TrackerAlgoOutputData> results;
+  GstObjTrackerStream *stream = NULL;
+  GPtrArray *streams = NULL;
   GValue list = G_VALUE_INIT;
   gboolean success = FALSE;
-  const GValue *bboxes = NULL, *val = NULL;
-  GValue array = G_VALUE_INIT, value = G_VALUE_INIT;
-  GValue trackerbboxes = G_VALUE_INIT;
-  GstStructure *structure = NULL, *entry = NULL;
-  GstStructure *region = NULL, *trackerregion = NULL;
-  gdouble confidence = 0.0;
-  guint size = 0, idx = 0, id = 0;
+  const GValue *val = NULL;
+  GstStructure *structure = NULL;
+  guint size = 0, idx = 0;
+  gint id = 0;
 
   g_value_init (&list, GST_TYPE_LIST);
-  g_value_init (&array, GST_TYPE_ARRAY);
-  g_value_init (&trackerbboxes, GST_TYPE_ARRAY);
 
   success = gst_value_deserialize (&list, input_text);
   if (!success) {
@@ -370,93 +645,46 @@ gst_objtracker_algo_execute_text (GstObjTrackerAlgo * algo,
     goto cleanup;
   }
 
-  if (gst_value_list_get_size (&list) == 0) {
+  if ((size = gst_value_list_get_size (&list)) == 0) {
     GST_ERROR ("Input contains no data!");
+    g_value_unset (&list);
     return FALSE;
   }
 
-  // TODO: Add support for more than one element in the list
-  val = gst_value_list_get_value (&list, 0);
-  structure = GST_STRUCTURE (g_value_get_boxed (val));
-
-  bboxes = gst_structure_get_value (structure, "bounding-boxes");
-  if ((size = gst_value_array_get_size (bboxes)) == 0) {
-    GST_INFO ("There are no bounding-boxes!");
-    goto cleanup;
-  }
+  streams = g_ptr_array_sized_new (size);
 
+  // Each entry of a batch is tracked by the tracker of its stream.
   for (idx = 0; idx < size; idx++) {
-    val = gst_value_array_get_value (bboxes, idx);
-    entry = GST_STRUCTURE (g_value_get_boxed (val));
-
-    val = gst_structure_get_value (entry, "rectangle");
-    item.x = g_value_get_float (gst_value_array_get_value (val, 0));
-    item.y = g_value_get_float (gst_value_array_get_value (val, 1));
-    item.w = g_value_get_float (gst_value_array_get_value (val, 2));
-    item.h = g_value_get_float (gst_value_array_get_value (val, 3));
-
-    gst_structure_get_uint (entry, "id", &id);
-    item.detection_id = id;
-    gst_structure_get_double (entry, "confidence", &confidence);
-    item.prob = confidence;
-
-    key = GUINT_TO_POINTER (id);
-    region = gst_structure_copy (entry);
-    g_hash_table_insert (algo->bboxregions, key, region);
-
-    data.push_back(item);
-  }
+    val = gst_value_list_get_value (&list, idx);
+    structure = GST_STRUCTURE (g_value_get_boxed (val));
 
-  //remove bounding-boxes
-  gst_structure_remove_field (structure, "bounding-boxes");
+    // Entries without stream ID are identified by their position in the batch.
+    if (!gst_structure_get_int (structure, "stream-id", &id))
+      id = idx;
 
-  results = algo->algoexecute (algo->subalgo, data);
+    if ((stream = gst_objtracker_algo_get_stream (algo, id)) == NULL) {
+      for (guint num = 0; num < streams->len; num++)
+        g_ptr_array_set_size (((GstObjTrackerStream *)
+            g_ptr_array_index (streams, num))->entries, 0);
 
-  for (size_t i = 0; i < results.size(); i++) {
-    key = GUINT_TO_POINTER (results[i].matched_detection_id);
-    region = (GstStructure *) g_hash_table_lookup (algo->bboxregions,
-        key);
-
-    if (region == NULL)
-      continue;
-
-    g_value_init (&value, G_TYPE_FLOAT);
-    trackerregion = gst_structure_copy (region);
-
-    gst_structure_remove_field (trackerregion, "rectangle");
-    g_value_set_float (&value, results[i].x);
-    gst_value_array_append_value (&array, &value);
-    g_value_set_float (&value, results[i].y);
-    gst_value_array_append_value (&array, &value);
-    g_value_set_float (&value, results[i].w);
-    gst_value_array_append_value (&array, &value);
-    g_value_set_float (&value, results[i].h);
-    gst_value_array_append_value (&array, &value);
-    gst_structure_set_value (trackerregion, "rectangle", &array);
-    g_value_reset (&array);
-
-    gst_structure_set (trackerregion, "tracking-id", G_TYPE_UINT,
-        results[i].track_id, NULL);
+      g_ptr_array_free (streams, TRUE);
+      g_value_unset (&list);
+      return FALSE;
+    }
 
-    g_value_unset (&value);
-    g_value_init (&value, GST_TYPE_STRUCTURE);
-    g_value_take_boxed (&value, trackerregion);
-    gst_value_array_append_value (&trackerbboxes, &value);
-    g_value_unset (&value);
+    if (stream->entries->len == 0)
+      g_ptr_array_add (streams, stream);
 
-    g_hash_table_remove (algo->bboxregions, key);
+    g_ptr_array_add (stream->entries, structure);
   }
 
-  gst_structure_set_value (structure, "bounding-boxes", &trackerbboxes);
+  gst_objtracker_algo_dispatch (algo, streams);
+  g_ptr_array_free (streams, TRUE);
 
 cleanup:
   *output_text = gst_value_serialize (&list);
 
   g_value_unset (&list);
-  g_value_unset (&array);
-  g_value_unset (&trackerbboxes);
-
-  g_hash_table_remove_all (algo->bboxregions);
 
   return (*output_text != NULL) ? TRUE : FALSE;
 }
@@ -475,6 +703,7 @@ gboolean
 gst_objtracker_algo_execute_buffer (GstObjTrackerAlgo * algo,
     GstBuffer * buffer)
 {
+  GstObjTrackerStream *stream = NULL;
   GstVideoRegionOfInterestMeta *roimeta = NULL;
   gpointer state = NULL, key = NULL;
   TrackerAlgoInputData item;
@@ -484,6 +713,10 @@ gst_objtracker_algo_execute_buffer (GstObjTrackerAlgo * algo,
   GstRegionMetaEntry *region = NULL;
   gdouble confidence = 0.0;
 
+  // Video frames are not batched, they are tracked as a single stream.
+  if ((stream = gst_objtracker_algo_get_stream (algo, 0)) == NULL)
+    return FALSE;
+
   while ((roimeta = GST_BUFFER_ITERATE_ROI_METAS (buffer, state)) != NULL) {
     item.x = roimeta->x;
     item.y = roimeta->y;
@@ -498,7 +731,7 @@ gst_objtracker_algo_execute_buffer (GstObjTrackerAlgo * algo,
 
     key = GUINT_TO_POINTER (roimeta->id);
     region = gst_region_meta_entry_new (roimeta);
-    g_hash_table_insert (algo->roiregions, key, region);
+    g_hash_table_insert (stream->roiregions, key, region);
 
     data.push_back(item);
   }
@@ -506,11 +739,12 @@ gst_objtracker_algo_execute_buffer (GstObjTrackerAlgo * algo,
   //remove origin ROI metas
   gst_buffer_foreach_meta (buffer, gst_objtracker_remove_roimeta, NULL);
 
-  results = algo->algoexecute (algo->subalgo, data);
+  results = algo->algoexecute (stream->subalgo, data);
 
   for (size_t i = 0; i < results.size(); i++) {
     key = GUINT_TO_POINTER (results[i].matched_detection_id);
-    region = (GstRegionMetaEntry *) g_hash_table_lookup (algo->roiregions, key);
+    region = (GstRegionMetaEntry *) g_hash_table_lookup (stream->roiregions,
+        key);
 
     if (region == NULL)
       continue;
@@ -525,7 +759,7 @@ gst_objtracker_algo_execute_buffer (GstObjTrackerAlgo * algo,
     roimeta->id = region->id;
     roimeta->parent_id = region->parent_id;
     roimeta->params = (GList *) g_steal_pointer (&(region->params));
-    g_hash_table_remove (algo->roiregions, key);
+    g_hash_table_remove (stream->roiregions, key);
 
     param = gst_video_region_of_interest_meta_get_param (roimeta,
         "ObjectDetection");
@@ -533,7 +767,7 @@ gst_objtracker_algo_execute_buffer (GstObjTrackerAlgo * algo,
         NULL);
   }
 
-  g_hash_table_remove_all (algo->roiregions);
+  g_hash_table_remove_all (stream->roiregions);
 
   return TRUE;
 }
@@ -27,6 +27,17 @@ GST_DEBUG_CATEGORY_EXTERN (gst_objtracker_algo_debug);
  */
 #define GST_OBJTRACKER_ALGO_OPT_PARAMETERS "GstObjTrackerAlgo.parameters"
 
+/**
+ * GST_OBJTRACKER_ALGO_OPT_N_THREADS
+ *
+ * #G_TYPE_UINT: Number of threads updating the trackers of different streams
+ *               in parallel, including the calling thread.
+ * Default: 1
+ *
+ * To be used as a possible option for 'gst_objtracker_algo_configure'.
+ */
+#define GST_OBJTRACKER_ALGO_OPT_N_THREADS "GstObjTrackerAlgo.n-threads"
+
 typedef struct _GstObjTrackerAlgo GstObjTrackerAlgo;
 
 
@@ -72,7 +83,9 @@ gst_objtracker_algo_init (GstObjTrackerAlgo * algo);
  * @options: Pointer to GStreamer structure containing the settings.
  *
  * Convenient wrapper function used on plugin level to call the subalgo
- * 'gst_objtracker_algo_configure' API to set various options.
+ * 'gst_objtracker_algo_configure' API to set various options. Calling it
+ * again discards the tracking state of all streams, which are then tracked
+ * anew with the new options. Must not be called concurrently with execute.
  *
  * return: TRUE on success or FALSE on failure
  */
@@ -88,7 +101,9 @@ gst_objtracker_algo_set_opts (GstObjTrackerAlgo * algo,
  *
  * Convenient wrapper function used on plugin level to call the subalgo
  * 'gst_objtracker_algo_process' API in order to process object detection
- * result and generate track id.
+ * result and generate track id. Each entry of the input list is tracked by
+ * the tracker of its 'stream-id', or of its index in the list if the entry
+ * has no stream ID. Different streams are processed in parallel.
  *
  * return: TRUE on success or FALSE on failure
  */
@@ -41,12 +41,14 @@ typedef enum {
 
 #define DEFAULT_PROP_ALGO_BACKEND           GST_OBJTRACK_BACKEND_BYTETRACK
 #define DEFAULT_PROP_PARAMETERS             NULL
+#define DEFAULT_PROP_N_THREADS              4
 
 enum
 {
   PROP_0,
   PROP_ALGO_BACKEND,
   PROP_PARAMETERS,
+  PROP_N_THREADS,
 };
 
 static GstStaticPadTemplate gst_objtracker_sink_template =
@@ -131,19 +133,24 @@ gst_objtracker_set_caps (GstBaseTransform * base, GstCaps * incaps,
     return FALSE;
   }
 
+  structure = gst_structure_new ("options",
+      GST_OBJTRACKER_ALGO_OPT_N_THREADS, G_TYPE_UINT, objtracker->n_threads,
+      NULL);
+
   if (objtracker->algoparameters != NULL)
-    structure = gst_structure_new ("options",
-      GST_OBJTRACKER_ALGO_OPT_PARAMETERS, GST_TYPE_STRUCTURE,
-          objtracker->algoparameters, NULL);
-  else
-    structure = NULL;
+    gst_structure_set (structure,
+        GST_OBJTRACKER_ALGO_OPT_PARAMETERS, GST_TYPE_STRUCTURE,
+        objtracker->algoparameters, NULL);
 
   if (!gst_objtracker_algo_set_opts (objtracker->algo, structure)) {
     GST_ELEMENT_ERROR (objtracker, RESOURCE, FAILED, (NULL),
         ("Failed to set algo options!"));
+    gst_structure_free (structure);
     return FALSE;
   }
 
+  gst_structure_free (structure);
+
   GST_DEBUG_OBJECT (objtracker, "Output caps: %" GST_PTR_FORMAT, outcaps);
 
   return TRUE;
@@ -267,6 +274,9 @@ gst_objtracker_set_property (GObject * object, guint prop_id,
       g_value_unset (&structure);
       break;
     }
+    case PROP_N_THREADS:
+      objtracker->n_threads = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -294,6 +304,9 @@ gst_objtracker_get_property (GObject * object, guint prop_id,
       g_free (string);
       break;
     }
+    case PROP_N_THREADS:
+      g_value_set_uint (value, objtracker->n_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -339,6 +352,13 @@ gst_objtracker_class_init (GstObjTrackerClass * klass)
           "Applicable only for some algorithms.",
           DEFAULT_PROP_PARAMETERS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Number of threads updating the trackers of different streams in "
+          "a batch in parallel",
+          1, 32, DEFAULT_PROP_N_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
 
   gst_element_class_set_static_metadata (element, "Object Tracker",
       "Filter/Effect/Converter",
@@ -364,6 +384,7 @@ gst_objtracker_init (GstObjTracker * objtracker)
 
   objtracker->algo = NULL;
   objtracker->algoparameters = DEFAULT_PROP_PARAMETERS;
+  objtracker->n_threads = DEFAULT_PROP_N_THREADS;
 
   // Handle buffers with GAP flag internally.
   gst_base_transform_set_gap_aware (GST_BASE_TRANSFORM (objtracker), TRUE);
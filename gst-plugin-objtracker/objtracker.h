@@ -35,6 +35,7 @@ struct _GstObjTracker {
   ///Properties
   gint                  backend;
   GstStructure          *algoparameters;
+  guint                 n_threads;
 
 };
 
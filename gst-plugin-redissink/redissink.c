@@ -8,7 +8,13 @@
 #endif
 
 #include "redissink.h"
+
+#include <string.h>
+
 #include <gst/utils/common-utils.h>
+#include <gst/video/gstvideometa.h>
+#include <gst/video/gstvideoclassificationmeta.h>
+#include <gst/video/gstvideolandmarksmeta.h>
 
 #define gst_redis_sink_parent_class parent_class
 G_DEFINE_TYPE (GstRedisSink, gst_redis_sink, GST_TYPE_BASE_SINK);
@@ -18,13 +24,29 @@ GST_DEBUG_CATEGORY_STATIC (gst_redis_sink_debug);
 
 
 #define GST_REDIS_SINK_CAPS \
-    "text/x-raw"
+    "text/x-raw; "         \
+    "video/x-raw(ANY)"
+
+#define GST_TYPE_REDIS_SINK_MODE (gst_redis_sink_mode_get_type())
+#define GST_TYPE_REDIS_SINK_COMMAND (gst_redis_sink_command_get_type())
 
 #define DEFAULT_PROP_HOSTNAME "127.0.0.1"
 #define DEFAULT_PROP_PORT 6379
 #define DEFAULT_PROP_USERNAME NULL
 #define DEFAULT_PROP_PASSWORD NULL
 #define DEFAULT_PROP_CHANNEL NULL
+#define DEFAULT_PROP_MODE GST_REDIS_SINK_MODE_SYNC
+#define DEFAULT_PROP_QUEUE_SIZE 64
+#define DEFAULT_PROP_COMMAND GST_REDIS_SINK_COMMAND_PUBLISH
+#define DEFAULT_PROP_MAXLEN 0
+
+// Connection timeout and bounds of the exponential reconnect backoff.
+#define GST_REDIS_CONNECT_TIMEOUT   (G_TIME_SPAN_SECOND / 2)
+#define GST_REDIS_MIN_BACKOFF       (G_TIME_SPAN_MILLISECOND * 100)
+#define GST_REDIS_MAX_BACKOFF       (G_TIME_SPAN_SECOND * 5)
+
+// Weight (in 1/8 units) of the newest sample in the latency moving average.
+#define GST_REDIS_LATENCY_WEIGHT    1
 
 enum
 {
@@ -33,7 +55,22 @@ enum
   PROP_PORT,
   PROP_USERNAME,
   PROP_PASSWORD,
-  PROP_CHANNEL
+  PROP_CHANNEL,
+  PROP_MODE,
+  PROP_QUEUE_SIZE,
+  PROP_COMMAND,
+  PROP_MAXLEN,
+  PROP_DROPPED,
+  PROP_LATENCY,
+};
+
+typedef struct _GstRedisMessage GstRedisMessage;
+
+struct _GstRedisMessage {
+  /// Bytes of the message payload.
+  GBytes    *payload;
+  /// Monotonic time (in microseconds) at which the message was queued.
+  gint64    time;
 };
 
 static GstStaticPadTemplate redis_sink_template =
@@ -42,58 +79,611 @@ static GstStaticPadTemplate redis_sink_template =
         GST_PAD_ALWAYS,
         GST_STATIC_CAPS (GST_REDIS_SINK_CAPS));
 
+static GType
+gst_redis_sink_mode_get_type (void)
+{
+  static GType gtype = 0;
+  static const GEnumValue variants[] = {
+    { GST_REDIS_SINK_MODE_SYNC,
+        "Each buffer is published from the streaming thread, which waits "
+        "for the reply of the REDIS service.", "sync"
+    },
+    { GST_REDIS_SINK_MODE_ASYNC,
+        "Buffers are placed in a bounded queue and published from a separate "
+        "thread, pipelining all queued messages in a single write. The oldest "
+        "messages are dropped when the queue is full.", "async"
+    },
+    {0, NULL, NULL},
+  };
+
+  if (!gtype)
+    gtype = g_enum_register_static ("GstRedisSinkMode", variants);
+
+  return gtype;
+}
+
+static GType
+gst_redis_sink_command_get_type (void)
+{
+  static GType gtype = 0;
+  static const GEnumValue variants[] = {
+    { GST_REDIS_SINK_COMMAND_PUBLISH,
+        "Publish the messages in the channel, they are delivered only to the "
+        "currently connected subscribers.", "publish"
+    },
+    { GST_REDIS_SINK_COMMAND_XADD,
+        "Append the messages as entries with a single 'data' field to the "
+        "stream with the channel name, trimmed approximately to 'maxlen' "
+        "entries. Consumers can read the stream with consumer groups.", "xadd"
+    },
+    {0, NULL, NULL},
+  };
+
+  if (!gtype)
+    gtype = g_enum_register_static ("GstRedisSinkCommand", variants);
+
+  return gtype;
+}
+
+static inline void
+gst_msgpack_pack_header (GByteArray * array, guint8 type, guint64 value,
+    guint n_bytes)
+{
+  guint8 data[9] = { type, };
+  guint idx = 0;
+
+  // Big endian value following the type byte.
+  for (idx = 0; idx < n_bytes; idx++)
+    data[n_bytes - idx] = (value >> (idx * 8)) & 0xFF;
+
+  g_byte_array_append (array, data, n_bytes + 1);
+}
+
+static inline void
+gst_msgpack_pack_uint (GByteArray * array, guint64 value)
+{
+  if (value < 0x80)
+    gst_msgpack_pack_header (array, value, 0, 0);
+  else if (value <= G_MAXUINT8)
+    gst_msgpack_pack_header (array, 0xCC, value, 1);
+  else if (value <= G_MAXUINT16)
+    gst_msgpack_pack_header (array, 0xCD, value, 2);
+  else if (value <= G_MAXUINT32)
+    gst_msgpack_pack_header (array, 0xCE, value, 4);
+  else
+    gst_msgpack_pack_header (array, 0xCF, value, 8);
+}
+
+static inline void
+gst_msgpack_pack_int (GByteArray * array, gint64 value)
+{
+  if (value >= 0)
+    gst_msgpack_pack_uint (array, value);
+  else if (value >= -32)
+    gst_msgpack_pack_header (array, (guint8) value, 0, 0);
+  else if (value >= G_MININT8)
+    gst_msgpack_pack_header (array, 0xD0, (guint8) value, 1);
+  else if (value >= G_MININT16)
+    gst_msgpack_pack_header (array, 0xD1, (guint16) value, 2);
+  else if (value >= G_MININT32)
+    gst_msgpack_pack_header (array, 0xD2, (guint32) value, 4);
+  else
+    gst_msgpack_pack_header (array, 0xD3, (guint64) value, 8);
+}
+
+static inline void
+gst_msgpack_pack_float (GByteArray * array, gfloat value)
+{
+  union { gfloat f; guint32 u; } bits = { value };
+
+  gst_msgpack_pack_header (array, 0xCA, bits.u, 4);
+}
+
+static inline void
+gst_msgpack_pack_string (GByteArray * array, const gchar * string)
+{
+  gsize length = (string != NULL) ? strlen (string) : 0;
+
+  if (length < 32)
+    gst_msgpack_pack_header (array, 0xA0 | length, 0, 0);
+  else if (length <= G_MAXUINT8)
+    gst_msgpack_pack_header (array, 0xD9, length, 1);
+  else if (length <= G_MAXUINT16)
+    gst_msgpack_pack_header (array, 0xDA, length, 2);
+  else
+    gst_msgpack_pack_header (array, 0xDB, length, 4);
+
+  g_byte_array_append (array, (const guint8 *) string, length);
+}
+
+static inline void
+gst_msgpack_pack_array (GByteArray * array, guint n_entries)
+{
+  if (n_entries < 16)
+    gst_msgpack_pack_header (array, 0x90 | n_entries, 0, 0);
+  else if (n_entries <= G_MAXUINT16)
+    gst_msgpack_pack_header (array, 0xDC, n_entries, 2);
+  else
+    gst_msgpack_pack_header (array, 0xDD, n_entries, 4);
+}
+
+static inline void
+gst_msgpack_pack_map (GByteArray * array, guint n_entries)
+{
+  if (n_entries < 16)
+    gst_msgpack_pack_header (array, 0x80 | n_entries, 0, 0);
+  else if (n_entries <= G_MAXUINT16)
+    gst_msgpack_pack_header (array, 0xDE, n_entries, 2);
+  else
+    gst_msgpack_pack_header (array, 0xDF, n_entries, 4);
+}
+
+static void
+gst_redis_sink_pack_metas (GstRedisSink * sink, GstBuffer * buffer,
+    GByteArray * payload)
+{
+  GstMeta *meta = NULL;
+  gpointer state = NULL;
+  guint idx = 0;
+
+  g_byte_array_set_size (payload, 0);
+  gst_msgpack_pack_map (payload, 4);
+
+  gst_msgpack_pack_string (payload, "timestamp");
+  gst_msgpack_pack_uint (payload, GST_BUFFER_TIMESTAMP (buffer));
+
+  // ROI entries: [id, parent-id, label, x, y, width, height, confidence].
+  gst_msgpack_pack_string (payload, "rois");
+  gst_msgpack_pack_array (payload, gst_buffer_get_n_meta (buffer,
+      GST_VIDEO_REGION_OF_INTEREST_META_API_TYPE));
+
+  while ((meta = gst_buffer_iterate_meta_filtered (buffer, &state,
+              GST_VIDEO_REGION_OF_INTEREST_META_API_TYPE))) {
+    GstVideoRegionOfInterestMeta *roimeta = GST_VIDEO_ROI_META_CAST (meta);
+    GstStructure *params = NULL;
+    gdouble confidence = 0.0;
+
+    params = gst_video_region_of_interest_meta_get_param (roimeta,
+        "ObjectDetection");
+
+    if (params != NULL)
+      gst_structure_get_double (params, "confidence", &confidence);
+
+    gst_msgpack_pack_array (payload, 8);
+    gst_msgpack_pack_int (payload, roimeta->id);
+    gst_msgpack_pack_int (payload, roimeta->parent_id);
+    gst_msgpack_pack_string (payload, g_quark_to_string (roimeta->roi_type));
+    gst_msgpack_pack_uint (payload, roimeta->x);
+    gst_msgpack_pack_uint (payload, roimeta->y);
+    gst_msgpack_pack_uint (payload, roimeta->w);
+    gst_msgpack_pack_uint (payload, roimeta->h);
+    gst_msgpack_pack_float (payload, confidence);
+  }
+
+  // Classification entries: [id, parent-id, [[name, confidence, color]]].
+  gst_msgpack_pack_string (payload, "classifications");
+  gst_msgpack_pack_array (payload, gst_buffer_get_n_meta (buffer,
+      GST_VIDEO_CLASSIFICATION_META_API_TYPE));
+
+  while ((meta = gst_buffer_iterate_meta_filtered (buffer, &state,
+              GST_VIDEO_CLASSIFICATION_META_API_TYPE))) {
+    GstVideoClassificationMeta *classmeta =
+        GST_VIDEO_CLASSIFICATION_META_CAST (meta);
+
+    gst_msgpack_pack_array (payload, 3);
+    gst_msgpack_pack_int (payload, classmeta->id);
+    gst_msgpack_pack_int (payload, classmeta->parent_id);
+    gst_msgpack_pack_array (payload, classmeta->labels->len);
+
+    for (idx = 0; idx < classmeta->labels->len; idx++) {
+      GstClassLabel *label =
+          &(g_array_index (classmeta->labels, GstClassLabel, idx));
+
+      gst_msgpack_pack_array (payload, 3);
+      gst_msgpack_pack_string (payload, g_quark_to_string (label->name));
+      gst_msgpack_pack_float (payload, label->confidence);
+      gst_msgpack_pack_uint (payload, label->color);
+    }
+  }
+
+  // Landmark entries: [id, parent-id, confidence, [[name, x, y, confidence]],
+  // [[source keypoint index, destination keypoint index]]].
+  gst_msgpack_pack_string (payload, "landmarks");
+  gst_msgpack_pack_array (payload, gst_buffer_get_n_meta (buffer,
+      GST_VIDEO_LANDMARKS_META_API_TYPE));
+
+  while ((meta = gst_buffer_iterate_meta_filtered (buffer, &state,
+              GST_VIDEO_LANDMARKS_META_API_TYPE))) {
+    GstVideoLandmarksMeta *lmkmeta = GST_VIDEO_LANDMARKS_META_CAST (meta);
+
+    gst_msgpack_pack_array (payload, 5);
+    gst_msgpack_pack_int (payload, lmkmeta->id);
+    gst_msgpack_pack_int (payload, lmkmeta->parent_id);
+    gst_msgpack_pack_float (payload, lmkmeta->confidence);
+    gst_msgpack_pack_array (payload, lmkmeta->keypoints->len);
+
+    for (idx = 0; idx < lmkmeta->keypoints->len; idx++) {
+      GstVideoKeypoint *kp =
+          &(g_array_index (lmkmeta->keypoints, GstVideoKeypoint, idx));
+
+      gst_msgpack_pack_array (payload, 4);
+      gst_msgpack_pack_string (payload, g_quark_to_string (kp->name));
+      // Positions are sent as floats, exact for all integer pixel positions.
+      gst_msgpack_pack_float (payload, kp->x);
+      gst_msgpack_pack_float (payload, kp->y);
+      gst_msgpack_pack_float (payload, kp->confidence);
+    }
+
+    gst_msgpack_pack_array (payload,
+        (lmkmeta->links != NULL) ? lmkmeta->links->len : 0);
+
+    for (idx = 0; (lmkmeta->links != NULL) && (idx < lmkmeta->links->len);
+        idx++) {
+      GstVideoKeypointLink *link =
+          &(g_array_index (lmkmeta->links, GstVideoKeypointLink, idx));
+
+      gst_msgpack_pack_array (payload, 2);
+      gst_msgpack_pack_uint (payload, link->s_kp_idx);
+      gst_msgpack_pack_uint (payload, link->d_kp_idx);
+    }
+  }
+}
+
+static GBytes *
+gst_redis_sink_build_payload (GstRedisSink * sink, GstBuffer * buffer)
+{
+  GstMapInfo bufmap = { 0, };
+  GBytes *payload = NULL;
+  gsize length = 0;
+
+  if (sink->isvideo) {
+    // Video frames are not sent, only their metas in MessagePack format.
+    gst_redis_sink_pack_metas (sink, buffer, sink->payload);
+    return g_bytes_new (sink->payload->data, sink->payload->len);
+  }
+
+  if (!gst_buffer_map (buffer, &bufmap, GST_MAP_READ)) {
+    GST_ERROR_OBJECT (sink, "Unable to map buffer!");
+    return NULL;
+  }
+
+  length = bufmap.size;
+
+  // Serialized strings may contain a '\0' terminator, which is not sent.
+  while ((length > 0) && (bufmap.data[length - 1] == '\0'))
+    length--;
+
+  payload = g_bytes_new (bufmap.data, length);
+  gst_buffer_unmap (buffer, &bufmap);
+
+  return payload;
+}
+
+static void
+gst_redis_message_free (GstRedisMessage * message)
+{
+  g_bytes_unref (message->payload);
+  g_slice_free (GstRedisMessage, message);
+}
+
 static gboolean
-gst_redis_sink_publish (GstBaseSink * bsink, const gchar *string, gchar *channel)
+gst_redis_sink_connect (GstRedisSink * sink)
+{
+  struct timeval timeout = { 0, GST_REDIS_CONNECT_TIMEOUT };
+  gint64 time = g_get_monotonic_time ();
+
+  if (sink->redis != NULL)
+    return TRUE;
+
+  // Avoid blocking on connect attempts until the backoff interval expires.
+  if (time < sink->reconnect)
+    return FALSE;
+
+  sink->redis = redisConnectWithTimeout (sink->host, sink->port, timeout);
+
+  if ((sink->redis == NULL) || sink->redis->err) {
+    GST_WARNING_OBJECT (sink, "Unable to connect to REDIS service, error: "
+        "'%s'! Retry in %" G_GINT64_FORMAT " ms", (sink->redis != NULL) ?
+        sink->redis->errstr : "unknown", sink->backoff / 1000);
+
+    g_clear_pointer (&(sink->redis), redisFree);
+
+    sink->reconnect = time + sink->backoff;
+    sink->backoff = MIN (sink->backoff * 2, GST_REDIS_MAX_BACKOFF);
+    return FALSE;
+  }
+
+  GST_INFO_OBJECT (sink, "Connected to REDIS service at %s:%u",
+      sink->host, sink->port);
+
+  sink->backoff = GST_REDIS_MIN_BACKOFF;
+  return TRUE;
+}
+
+static void
+gst_redis_sink_disconnect (GstRedisSink * sink)
+{
+  if (sink->redis == NULL)
+    return;
+
+  GST_WARNING_OBJECT (sink, "Lost connection to REDIS service, error: '%s'!",
+      sink->redis->errstr);
+
+  g_clear_pointer (&(sink->redis), redisFree);
+  sink->reconnect = 0;
+}
+
+static gboolean
+gst_redis_sink_append (GstRedisSink * sink, GBytes * payload)
+{
+  const gchar *argv[8] = { NULL, };
+  gsize argvlen[8] = { 0, };
+  gchar maxlen[16] = { 0, };
+  const guint8 *data = NULL;
+  gsize length = 0;
+  guint argc = 0, idx = 0;
+  gint status = REDIS_OK;
+
+  data = g_bytes_get_data (payload, &length);
+
+  if (sink->command == GST_REDIS_SINK_COMMAND_XADD) {
+    argv[argc++] = "XADD";
+    argv[argc++] = sink->channel;
+
+    // Approximate trimming is much more efficient for the REDIS service.
+    if (sink->maxlen != 0) {
+      g_snprintf (maxlen, sizeof (maxlen), "%u", sink->maxlen);
+
+      argv[argc++] = "MAXLEN";
+      argv[argc++] = "~";
+      argv[argc++] = maxlen;
+    }
+
+    argv[argc++] = "*";
+    argv[argc++] = "data";
+  } else {
+    argv[argc++] = "PUBLISH";
+    argv[argc++] = sink->channel;
+  }
+
+  argv[argc++] = (const gchar *) data;
+
+  // Binary safe lengths of all arguments, the payload is always last.
+  for (idx = 0; idx < (argc - 1); idx++)
+    argvlen[idx] = strlen (argv[idx]);
+
+  argvlen[argc - 1] = length;
+
+  GST_DEBUG_OBJECT (sink, "REDIS: %s %s with %" G_GSIZE_FORMAT " bytes",
+      argv[0], sink->channel, length);
+
+  status = redisAppendCommandArgv (sink->redis, argc, argv, argvlen);
+  return (status == REDIS_OK) ? TRUE : FALSE;
+}
+
+static gboolean
+gst_redis_sink_receive (GstRedisSink * sink)
 {
   redisReply *reply = NULL;
-  GstRedisSink *sink = GST_REDIS_SINK (bsink);
 
-  g_return_val_if_fail (string != NULL, FALSE);
-  g_return_val_if_fail (channel != NULL, FALSE);
+  // First call also flushes the output buffer with all appended commands.
+  if (redisGetReply (sink->redis, (void **) &reply) != REDIS_OK)
+    return FALSE;
 
-  GST_DEBUG_OBJECT (sink, "REDIS: PUBLISH %s %s", channel, string);
+  if (reply->type == REDIS_REPLY_ERROR)
+    GST_WARNING_OBJECT (sink, "REDIS: Error reply '%s'!", reply->str);
 
-  reply = redisCommand (sink->redis, "PUBLISH %s %b",
-      channel, string, strlen (string));
-  freeReplyObject(reply);
+  freeReplyObject (reply);
+  return TRUE;
+}
+
+static void
+gst_redis_sink_update_stats (GstRedisSink * sink, guint n_dropped,
+    GstClockTime latency)
+{
+  GST_REDIS_SINK_LOCK (sink);
+
+  sink->n_dropped += n_dropped;
+
+  if (GST_CLOCK_TIME_IS_VALID (latency) && (sink->latency == 0))
+    sink->latency = latency;
+  else if (GST_CLOCK_TIME_IS_VALID (latency))
+    sink->latency += (((gint64) latency - (gint64) sink->latency) *
+        GST_REDIS_LATENCY_WEIGHT) / 8;
+
+  GST_REDIS_SINK_UNLOCK (sink);
+}
+
+static void
+gst_redis_sink_worker_task (gpointer userdata)
+{
+  GstRedisSink *sink = GST_REDIS_SINK (userdata);
+  GQueue messages = G_QUEUE_INIT;
+  GstRedisMessage *message = NULL;
+  guint idx = 0, n_replies = 0;
+
+  GST_REDIS_SINK_LOCK (sink);
+
+  while (sink->active && g_queue_is_empty (sink->messages))
+    g_cond_wait (&(sink)->wakeup, GST_REDIS_SINK_GET_LOCK (sink));
+
+  if (!sink->active) {
+    GST_REDIS_SINK_UNLOCK (sink);
+    return;
+  }
+
+  // Take all queued messages, they will be pipelined together.
+  messages = *(sink->messages);
+  g_queue_init (sink->messages);
+
+  GST_REDIS_SINK_UNLOCK (sink);
+
+  if (!gst_redis_sink_connect (sink)) {
+    GST_LOG_OBJECT (sink, "Not connected, dropping %u messages",
+        messages.length);
+
+    gst_redis_sink_update_stats (sink, messages.length, GST_CLOCK_TIME_NONE);
+    g_queue_clear_full (&messages, (GDestroyNotify) gst_redis_message_free);
+
+    // Wait for the backoff interval or until the task is stopped.
+    GST_REDIS_SINK_LOCK (sink);
+
+    if (sink->active)
+      g_cond_wait_until (&(sink)->wakeup, GST_REDIS_SINK_GET_LOCK (sink),
+          sink->reconnect);
+
+    GST_REDIS_SINK_UNLOCK (sink);
+    return;
+  }
+
+  for (idx = 0; idx < messages.length; idx++) {
+    message = g_queue_peek_nth (&messages, idx);
+
+    if (!gst_redis_sink_append (sink, message->payload))
+      break;
+  }
+
+  GST_LOG_OBJECT (sink, "Pipelined %u messages", idx);
+
+  for (n_replies = 0; n_replies < idx; n_replies++) {
+    if (!gst_redis_sink_receive (sink)) {
+      gst_redis_sink_disconnect (sink);
+      break;
+    }
+  }
+
+  // Latency is measured from queueing until the reply of the last message.
+  message = (n_replies != 0) ? g_queue_peek_nth (&messages, n_replies - 1) :
+      NULL;
+
+  gst_redis_sink_update_stats (sink, messages.length - n_replies,
+      (message != NULL) ? (g_get_monotonic_time () - message->time) *
+          GST_USECOND : GST_CLOCK_TIME_NONE);
+
+  g_queue_clear_full (&messages, (GDestroyNotify) gst_redis_message_free);
+}
+
+static gboolean
+gst_redis_sink_start_worker_task (GstRedisSink * sink)
+{
+  GST_REDIS_SINK_LOCK (sink);
+
+  if (sink->active) {
+    GST_REDIS_SINK_UNLOCK (sink);
+    return TRUE;
+  }
+
+  sink->worktask = gst_task_new (gst_redis_sink_worker_task, sink, NULL);
+  gst_task_set_lock (sink->worktask, &sink->worklock);
+
+  GST_INFO_OBJECT (sink, "Created task %p", sink->worktask);
+
+  sink->active = TRUE;
+  GST_REDIS_SINK_UNLOCK (sink);
+
+  if (!gst_task_start (sink->worktask)) {
+    GST_ERROR_OBJECT (sink, "Failed to start worker task!");
+    return FALSE;
+  }
+
+  GST_INFO_OBJECT (sink, "Started task %p", sink->worktask);
+  return TRUE;
+}
+
+static gboolean
+gst_redis_sink_stop_worker_task (GstRedisSink * sink)
+{
+  GST_REDIS_SINK_LOCK (sink);
+
+  if (!sink->active) {
+    GST_REDIS_SINK_UNLOCK (sink);
+    return TRUE;
+  }
+
+  GST_INFO_OBJECT (sink, "Stopping task %p", sink->worktask);
+
+  if (!gst_task_stop (sink->worktask))
+    GST_WARNING_OBJECT (sink, "Failed to stop worker task!");
+
+  sink->active = FALSE;
+  g_cond_signal (&(sink)->wakeup);
+
+  GST_REDIS_SINK_UNLOCK (sink);
+
+  if (!gst_task_join (sink->worktask)) {
+    GST_ERROR_OBJECT (sink, "Failed to join worker task!");
+    return FALSE;
+  }
+
+  GST_INFO_OBJECT (sink, "Removing task %p", sink->worktask);
+
+  gst_object_unref (sink->worktask);
+  sink->worktask = NULL;
+
+  // Messages which were not sent until now are dropped.
+  g_queue_clear_full (sink->messages, (GDestroyNotify) gst_redis_message_free);
   return TRUE;
 }
 
 static GstFlowReturn
 gst_redis_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
 {
-  GstMapInfo bufmap = { 0, };
-  GstRedisSink *sink;
+  GstRedisSink *sink = GST_REDIS_SINK (bsink);
+  GstRedisMessage *message = NULL;
+  GBytes *payload = NULL;
+  gint64 time = 0;
+  gboolean success = FALSE;
 
-  sink = GST_REDIS_SINK (bsink);
+  if (sink->channel == NULL)
+    return GST_FLOW_OK;
 
-  if (sink->redis == NULL)
-    sink->redis = redisConnect (sink->host, sink->port);
+  // Only the payload is kept, so buffers are returned to their pools at once.
+  if ((payload = gst_redis_sink_build_payload (sink, buffer)) == NULL) {
+    gst_redis_sink_update_stats (sink, 1, GST_CLOCK_TIME_NONE);
+    return GST_FLOW_OK;
+  }
+
+  if (sink->mode == GST_REDIS_SINK_MODE_ASYNC) {
+    message = g_slice_new (GstRedisMessage);
+    message->payload = payload;
+    message->time = g_get_monotonic_time ();
+
+    GST_REDIS_SINK_LOCK (sink);
 
-  if (sink->redis == NULL || sink->redis->err) {
-    GST_WARNING_OBJECT (sink, "Not connected to REDIS service!");
-    if (sink->redis) {
-      redisFree (sink->redis);
-      sink->redis = NULL;
+    // Queue is full, drop the oldest message instead of blocking upstream.
+    if (g_queue_get_length (sink->messages) >= sink->queue_size) {
+      gst_redis_message_free (g_queue_pop_head (sink->messages));
+      sink->n_dropped++;
     }
+
+    g_queue_push_tail (sink->messages, message);
+    g_cond_signal (&(sink)->wakeup);
+
+    GST_REDIS_SINK_UNLOCK (sink);
     return GST_FLOW_OK;
   }
 
-  if (!gst_buffer_map (buffer, &bufmap, GST_MAP_READ)) {
-    GST_ERROR ("Unable to map buffer!");
-    return GST_FLOW_ERROR;
+  if (!gst_redis_sink_connect (sink)) {
+    GST_LOG_OBJECT (sink, "Not connected to REDIS service, dropping buffer");
+    gst_redis_sink_update_stats (sink, 1, GST_CLOCK_TIME_NONE);
+    g_bytes_unref (payload);
+    return GST_FLOW_OK;
   }
 
-  gst_buffer_ref (buffer);
+  time = g_get_monotonic_time ();
 
-  if (sink->channel) {
-    gst_redis_sink_publish (bsink,
-        (gchar*) bufmap.data, sink->channel);
-  }
+  success = gst_redis_sink_append (sink, payload) &&
+      gst_redis_sink_receive (sink);
+  g_bytes_unref (payload);
 
-  gst_buffer_unmap (buffer, &bufmap);
-  gst_buffer_unref (buffer);
+  if (!success) {
+    gst_redis_sink_disconnect (sink);
+    gst_redis_sink_update_stats (sink, 1, GST_CLOCK_TIME_NONE);
+    return GST_FLOW_OK;
+  }
 
+  gst_redis_sink_update_stats (sink, 0,
+      (g_get_monotonic_time () - time) * GST_USECOND);
   return GST_FLOW_OK;
 }
 
@@ -102,11 +692,19 @@ gst_redis_sink_start (GstBaseSink * basesink)
 {
   GstRedisSink *sink = GST_REDIS_SINK (basesink);
 
-  sink->redis = redisConnect (sink->host, sink->port);
+  sink->n_dropped = 0;
+  sink->latency = 0;
+
+  sink->reconnect = 0;
+  sink->backoff = GST_REDIS_MIN_BACKOFF;
 
-  if (sink->redis == NULL || sink->redis->err)
+  if (!gst_redis_sink_connect (sink))
     GST_INFO_OBJECT (sink, "Unable to REDIS connect");
 
+  if ((sink->mode == GST_REDIS_SINK_MODE_ASYNC) &&
+      !gst_redis_sink_start_worker_task (sink))
+    return FALSE;
+
   return TRUE;
 }
 
@@ -117,6 +715,8 @@ gst_redis_sink_stop (GstBaseSink * basesink)
 
   GST_INFO_OBJECT (sink, "Stop");
 
+  gst_redis_sink_stop_worker_task (sink);
+
   if (sink->redis)
     redisFree(sink->redis);
 
@@ -132,6 +732,9 @@ gst_redis_sink_set_caps (GstBaseSink * bsink, GstCaps * caps)
 
   GST_INFO_OBJECT (sink, "Input caps: %" GST_PTR_FORMAT, caps);
 
+  sink->isvideo = gst_structure_has_name (gst_caps_get_structure (caps, 0),
+      "video/x-raw");
+
   return TRUE;
 }
 
@@ -168,6 +771,18 @@ gst_redis_sink_set_property (GObject * object, guint prop_id,
     case PROP_CHANNEL:
       sink->channel = g_strdup (g_value_get_string (value));
       break;
+    case PROP_MODE:
+      sink->mode = g_value_get_enum (value);
+      break;
+    case PROP_QUEUE_SIZE:
+      sink->queue_size = g_value_get_uint (value);
+      break;
+    case PROP_COMMAND:
+      sink->command = g_value_get_enum (value);
+      break;
+    case PROP_MAXLEN:
+      sink->maxlen = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -198,6 +813,28 @@ gst_redis_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_CHANNEL:
       g_value_set_string (value, sink->channel);
       break;
+    case PROP_MODE:
+      g_value_set_enum (value, sink->mode);
+      break;
+    case PROP_QUEUE_SIZE:
+      g_value_set_uint (value, sink->queue_size);
+      break;
+    case PROP_COMMAND:
+      g_value_set_enum (value, sink->command);
+      break;
+    case PROP_MAXLEN:
+      g_value_set_uint (value, sink->maxlen);
+      break;
+    case PROP_DROPPED:
+      GST_REDIS_SINK_LOCK (sink);
+      g_value_set_uint64 (value, sink->n_dropped);
+      GST_REDIS_SINK_UNLOCK (sink);
+      break;
+    case PROP_LATENCY:
+      GST_REDIS_SINK_LOCK (sink);
+      g_value_set_uint64 (value, sink->latency);
+      GST_REDIS_SINK_UNLOCK (sink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -218,6 +855,21 @@ gst_redis_sink_dispose (GObject * obj)
   G_OBJECT_CLASS (parent_class)->dispose (obj);
 }
 
+static void
+gst_redis_sink_finalize (GObject * obj)
+{
+  GstRedisSink *sink = GST_REDIS_SINK (obj);
+
+  g_queue_free_full (sink->messages, (GDestroyNotify) gst_redis_message_free);
+  g_byte_array_unref (sink->payload);
+
+  g_rec_mutex_clear (&sink->worklock);
+  g_cond_clear (&sink->wakeup);
+  g_mutex_clear (&sink->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (obj);
+}
+
 static void
 gst_redis_sink_class_init (GstRedisSinkClass * klass)
 {
@@ -232,6 +884,7 @@ gst_redis_sink_class_init (GstRedisSinkClass * klass)
   gobject->set_property = GST_DEBUG_FUNCPTR (gst_redis_sink_set_property);
   gobject->get_property = GST_DEBUG_FUNCPTR (gst_redis_sink_get_property);
   gobject->dispose      = GST_DEBUG_FUNCPTR (gst_redis_sink_dispose);
+  gobject->finalize     = GST_DEBUG_FUNCPTR (gst_redis_sink_finalize);
 
   g_object_class_install_property (gobject, PROP_HOST,
       g_param_spec_string ("host", "Redis service hostname",
@@ -265,6 +918,44 @@ gst_redis_sink_class_init (GstRedisSinkClass * klass)
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
 
+  g_object_class_install_property (gobject, PROP_MODE,
+      g_param_spec_enum ("mode", "Mode",
+          "Publishing mode", GST_TYPE_REDIS_SINK_MODE, DEFAULT_PROP_MODE,
+          G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  g_object_class_install_property (gobject, PROP_QUEUE_SIZE,
+      g_param_spec_uint ("queue-size", "Queue size",
+          "Maximum number of outgoing messages queued in 'async' mode",
+          1, G_MAXUINT, DEFAULT_PROP_QUEUE_SIZE,
+          G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  g_object_class_install_property (gobject, PROP_COMMAND,
+      g_param_spec_enum ("command", "Command",
+          "REDIS command used for sending the messages",
+          GST_TYPE_REDIS_SINK_COMMAND, DEFAULT_PROP_COMMAND,
+          G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  g_object_class_install_property (gobject, PROP_MAXLEN,
+      g_param_spec_uint ("maxlen", "Maximum stream length",
+          "Approximate maximum number of entries kept in the stream with "
+          "'xadd' command (0 - unlimited)", 0, G_MAXUINT, DEFAULT_PROP_MAXLEN,
+          G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  g_object_class_install_property (gobject, PROP_DROPPED,
+      g_param_spec_uint64 ("dropped", "Dropped",
+          "Number of messages dropped due to full queue or connection loss",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject, PROP_LATENCY,
+      g_param_spec_uint64 ("latency", "Latency",
+          "Moving average of the time between receiving a buffer and the "
+          "reply of the REDIS service (in nanoseconds)",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement,
       "QTI Redis Sink Element", "Redis Sink Element",
       "This plugin send ML data to Redis service", "QTI");
@@ -286,6 +977,27 @@ gst_redis_sink_init (GstRedisSink * sink)
   sink->password = NULL;
   sink->username = NULL;
   sink->channel = NULL;
+  sink->mode = DEFAULT_PROP_MODE;
+  sink->queue_size = DEFAULT_PROP_QUEUE_SIZE;
+  sink->command = DEFAULT_PROP_COMMAND;
+  sink->maxlen = DEFAULT_PROP_MAXLEN;
+
+  sink->isvideo = FALSE;
+  sink->payload = g_byte_array_new ();
+
+  g_mutex_init (&sink->lock);
+  g_cond_init (&sink->wakeup);
+  g_rec_mutex_init (&sink->worklock);
+
+  sink->messages = g_queue_new ();
+  sink->worktask = NULL;
+  sink->active = FALSE;
+
+  sink->n_dropped = 0;
+  sink->latency = 0;
+
+  sink->reconnect = 0;
+  sink->backoff = GST_REDIS_MIN_BACKOFF;
 
   GST_DEBUG_CATEGORY_INIT (gst_redis_sink_debug, "qtiredissink", 0,
     "qtiredissink object");
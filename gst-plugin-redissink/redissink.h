@@ -26,9 +26,25 @@ G_BEGIN_DECLS
   (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_REDIS_SINK))
 #define GST_REDIS_SINK_CAST(obj)       ((GstRedisSink *)(obj))
 
+#define GST_REDIS_SINK_GET_LOCK(obj) (&GST_REDIS_SINK(obj)->lock)
+#define GST_REDIS_SINK_LOCK(obj) \
+    g_mutex_lock(GST_REDIS_SINK_GET_LOCK(obj))
+#define GST_REDIS_SINK_UNLOCK(obj) \
+    g_mutex_unlock(GST_REDIS_SINK_GET_LOCK(obj))
+
 typedef struct _GstRedisSink GstRedisSink;
 typedef struct _GstRedisSinkClass GstRedisSinkClass;
 
+typedef enum {
+  GST_REDIS_SINK_MODE_SYNC,
+  GST_REDIS_SINK_MODE_ASYNC,
+} GstRedisSinkMode;
+
+typedef enum {
+  GST_REDIS_SINK_COMMAND_PUBLISH,
+  GST_REDIS_SINK_COMMAND_XADD,
+} GstRedisSinkCommand;
+
 struct _GstRedisSink {
   /// Inherited parent structure.
   GstBaseSink parent;
@@ -36,12 +52,44 @@ struct _GstRedisSink {
   /// Hiredis library context
   redisContext *redis;
 
+  /// Whether the negotiated caps are video, whose metas are sent in binary.
+  gboolean     isvideo;
+  /// Reusable storage for the binary encoded payload.
+  GByteArray   *payload;
+
+  /// Monotonic time (in microseconds) of the next allowed connect attempt.
+  gint64       reconnect;
+  /// Current reconnect backoff interval (in microseconds).
+  gint64       backoff;
+
+  /// Global mutex lock protecting the outgoing queue and counters.
+  GMutex       lock;
+  /// Condition signalled when messages are queued or the task is stopped.
+  GCond        wakeup;
+  /// Queue with outgoing messages, used in asynchronous mode.
+  GQueue       *messages;
+
+  /// I/O worker task, used in asynchronous mode.
+  GstTask      *worktask;
+  /// I/O worker task mutex.
+  GRecMutex    worklock;
+  /// Indicates whether the I/O worker task is active or not.
+  gboolean     active;
+
+  /// Statistics.
+  guint64      n_dropped;
+  GstClockTime latency;
+
   /// Properties.
-  gchar *host;
-  guint port;
-  gchar *password;
-  gchar *username;
-  gchar *channel;
+  gchar            *host;
+  guint            port;
+  gchar            *password;
+  gchar            *username;
+  gchar            *channel;
+  GstRedisSinkMode mode;
+  guint            queue_size;
+  GstRedisSinkCommand command;
+  guint            maxlen;
 };
 
 struct _GstRedisSinkClass {
@@ -40,6 +40,41 @@
 void
 free_pl_struct (GstPayloadInfo * pl_info)
 {
+  if (pl_info->hello != NULL) {
+    g_free (pl_info->hello);
+    pl_info->hello = NULL;
+  }
+
+  if (pl_info->client_config != NULL) {
+    g_free (pl_info->client_config);
+    pl_info->client_config = NULL;
+  }
+
+  if (pl_info->header != NULL) {
+    g_free (pl_info->header);
+    pl_info->header = NULL;
+  }
+
+  if (pl_info->register_fds != NULL) {
+    g_free (pl_info->register_fds);
+    pl_info->register_fds = NULL;
+  }
+
+  if (pl_info->unregister_fds != NULL) {
+    g_free (pl_info->unregister_fds);
+    pl_info->unregister_fds = NULL;
+  }
+
+  if (pl_info->meta_ring != NULL) {
+    g_free (pl_info->meta_ring);
+    pl_info->meta_ring = NULL;
+  }
+
+  if (pl_info->meta_records != NULL) {
+    g_free (pl_info->meta_records);
+    pl_info->meta_records = NULL;
+  }
+
   if (pl_info->fd_count != NULL) {
     g_free (pl_info->fd_count);
     pl_info->fd_count = NULL;
@@ -99,9 +134,31 @@ send_socket_message (gint sock, GstPayloadInfo * pl_info)
 
   memset (buf, 0, sizeof (buf));
 
+  // Version 2 datagrams always begin with the header.
+  if (pl_info->header != NULL)
+    g_ptr_array_add (send_arr, pl_info->header);
+
+  if (pl_info->hello != NULL)
+    g_ptr_array_add (send_arr, pl_info->hello);
+
+  if (pl_info->client_config != NULL)
+    g_ptr_array_add (send_arr, pl_info->client_config);
+
   if (pl_info->fd_count != NULL)
     g_ptr_array_add (send_arr, pl_info->fd_count);
 
+  if (pl_info->register_fds != NULL)
+    g_ptr_array_add (send_arr, pl_info->register_fds);
+
+  if (pl_info->unregister_fds != NULL)
+    g_ptr_array_add (send_arr, pl_info->unregister_fds);
+
+  if (pl_info->meta_ring != NULL)
+    g_ptr_array_add (send_arr, pl_info->meta_ring);
+
+  if (pl_info->meta_records != NULL)
+    g_ptr_array_add (send_arr, pl_info->meta_records);
+
   if (pl_info->buffer_info != NULL)
     g_ptr_array_add (send_arr, pl_info->buffer_info);
 
@@ -171,7 +228,18 @@ send_socket_message (gint sock, GstPayloadInfo * pl_info)
         (sizeof (*pl_info->fds)) * (GST_PL_INFO_GET_N_FDS (pl_info)));
     msg.msg_controllen = cmsg->cmsg_len;
 
-    memmove (CMSG_DATA (cmsg), pl_info->fds, cmsg->cmsg_len);
+    memmove (CMSG_DATA (cmsg), pl_info->fds,
+        (sizeof (*pl_info->fds)) * (GST_PL_INFO_GET_N_FDS (pl_info)));
+  }
+
+  // SOCK_SEQPACKET preserves the message boundaries, with version 2 the
+  // whole message is sent as a single datagram.
+  if (pl_info->header != NULL) {
+    errno = 0;
+    data_size = sendmsg (sock, &msg, 0);
+
+    g_ptr_array_free (send_arr, TRUE);
+    return data_size;
   }
 
   // Send the message length first as prefix
@@ -180,12 +248,14 @@ send_socket_message (gint sock, GstPayloadInfo * pl_info)
   data_size = send (sock, &msg_len_net, sizeof (msg_len_net), 0);
   if (data_size != sizeof (msg_len_net)) {
     GST_ERROR ("Failed to send message length");
+    g_ptr_array_free (send_arr, TRUE);
     return data_size;
   }
 
   errno = 0;
   data_size = sendmsg (sock, &msg, 0);
 
+  g_ptr_array_free (send_arr, TRUE);
   return data_size;
 }
 
@@ -199,14 +269,27 @@ receive_socket_message (gint sock, GstPayloadInfo * pl_info, int msg_flags)
   ssize_t recv_len;
   uint32_t msg_len_net, msg_len;
 
-  recv_len = recv (sock, &msg_len_net, sizeof (msg_len_net), msg_flags | MSG_WAITALL);
-  if (recv_len != sizeof (msg_len_net)) {
-      GST_ERROR ("Failed to read message length, returned %zd", recv_len);
+  // Get the size of the next datagram without removing it from the socket.
+  recv_len = recv (sock, NULL, 0, msg_flags | MSG_PEEK | MSG_TRUNC);
+  if (recv_len <= 0) {
+      GST_ERROR ("Failed to peek message, returned %zd", recv_len);
       return recv_len;
   }
 
-  // Convert to host byte order
-  msg_len = ntohl (msg_len_net);
+  if (recv_len == sizeof (msg_len_net)) {
+    // Version 1 length prefix, version 2 datagrams are at least 8 bytes.
+    recv_len = recv (sock, &msg_len_net, sizeof (msg_len_net),
+        msg_flags | MSG_WAITALL);
+    if (recv_len != sizeof (msg_len_net)) {
+        GST_ERROR ("Failed to read message length, returned %zd", recv_len);
+        return recv_len;
+    }
+
+    // Convert to host byte order
+    msg_len = ntohl (msg_len_net);
+  } else {
+    msg_len = recv_len;
+  }
 
   // Allocate buffer for the full message
   io_buf = g_malloc (msg_len);
@@ -236,9 +319,16 @@ receive_socket_message (gint sock, GstPayloadInfo * pl_info, int msg_flags)
   for (uint32_t offset = 0; offset < recv_len; ) {
     gpointer payload;
     gpointer iterator = io_buf + offset;
-    gint size = get_payload_size (iterator);
+    gint size = 0;
+
+    // The size of a data payload is read from its own fields.
+    if ((GST_SOCKET_MSG_IDENTITY (iterator) == MESSAGE_DATA) &&
+        ((offset + sizeof (GstDataPayload)) > (gsize) recv_len))
+      break;
+
+    size = get_payload_size (iterator);
 
-    if (size == -1) {
+    if ((size == -1) || ((offset + size) > recv_len)) {
       break;
     }
 
@@ -249,6 +339,27 @@ receive_socket_message (gint sock, GstPayloadInfo * pl_info, int msg_flags)
         GST_SOCKET_MSG_IDENTITY (payload), size);
 
     switch (GST_SOCKET_MSG_IDENTITY (payload)) {
+      case MESSAGE_HELLO:
+        pl_info->hello = (GstVersionPayload *) payload;
+        break;
+      case MESSAGE_HEADER:
+        pl_info->header = (GstVersionPayload *) payload;
+        break;
+      case MESSAGE_CLIENT_CONFIG:
+        pl_info->client_config = (GstClientConfigPayload *) payload;
+        break;
+      case MESSAGE_REGISTER_FDS:
+        pl_info->register_fds = (GstRegisterFdsPayload *) payload;
+        break;
+      case MESSAGE_UNREGISTER_FDS:
+        pl_info->unregister_fds = (GstUnregisterFdsPayload *) payload;
+        break;
+      case MESSAGE_META_RING:
+        pl_info->meta_ring = (GstMetaRingPayload *) payload;
+        break;
+      case MESSAGE_META_RECORDS:
+        pl_info->meta_records = (GstMetaRecordsPayload *) payload;
+        break;
       case MESSAGE_EOS:
       case MESSAGE_DISCONNECT:
         pl_info->message = (GstMessagePayload *) payload;
@@ -259,6 +370,7 @@ receive_socket_message (gint sock, GstPayloadInfo * pl_info, int msg_flags)
       case MESSAGE_FRAME:
       case MESSAGE_TENSOR:
       case MESSAGE_TEXT:
+      case MESSAGE_DATA:
         g_ptr_array_add (pl_info->mem_block_info, payload);
         break;
       case MESSAGE_RETURN_BUFFER:
@@ -320,6 +432,13 @@ get_payload_size (gpointer payload) {
     case MESSAGE_TEXT:
       return sizeof (GstTextPayload);
       break;
+    case MESSAGE_DATA:
+      if (((GstDataPayload *) payload)->size >
+          (G_MAXINT - sizeof (GstDataPayload)))
+        return -1;
+
+      return sizeof (GstDataPayload) + ((GstDataPayload *) payload)->size;
+      break;
     case MESSAGE_RETURN_BUFFER:
       return sizeof (GstReturnBufferPayload);
       break;
@@ -338,6 +457,25 @@ get_payload_size (gpointer payload) {
     case MESSAGE_VIDEO_LM_META:
       return sizeof (GstVideoLmMetaPayload);
       break;
+    case MESSAGE_HELLO:
+    case MESSAGE_HEADER:
+      return sizeof (GstVersionPayload);
+      break;
+    case MESSAGE_REGISTER_FDS:
+      return sizeof (GstRegisterFdsPayload);
+      break;
+    case MESSAGE_UNREGISTER_FDS:
+      return sizeof (GstUnregisterFdsPayload);
+      break;
+    case MESSAGE_CLIENT_CONFIG:
+      return sizeof (GstClientConfigPayload);
+      break;
+    case MESSAGE_META_RING:
+      return sizeof (GstMetaRingPayload);
+      break;
+    case MESSAGE_META_RECORDS:
+      return sizeof (GstMetaRecordsPayload);
+      break;
 
     default:
       return -1;
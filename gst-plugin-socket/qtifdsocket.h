@@ -59,12 +59,32 @@
     (socket->mode == DATA_MODE_TEXT || socket->mode == DATA_MODE_VIDEO ? 1 : 0))
 
 #define GST_MAX_MEM_BLOCKS 10
+#define GST_MAX_UNREGISTER_FDS 32
 #define GST_SERIALIZED_QUARK_MAX_SIZE 32
 #define GST_SERIALIZED_STRUCUTRE_MAX_SZIE 256
 #define GST_MAX_LABELS 32
 #define GST_MAX_KEYPOINTS 64
 #define GST_MAX_KEYPOINT_LINKS 64
 
+// Version 1 sends a length prefix before each message and passes the FDs of
+// the memory blocks with every buffer. Version 2 sends each message as a single
+// datagram starting with a header, and passes each FD only once when it is
+// registered under a buffer ID. Version 3 transfers the video metas as compact
+// records in a shared memory ring instead of fixed size payloads. Version 4
+// transfers text which does not fit into the text payload as sized payload.
+#define GST_SOCKET_PROTOCOL_VERSION 4
+
+// Buffer IDs of registered FDs start above any valid FD number in order to
+// never clash with the FD based buffer IDs of protocol version 1.
+#define GST_SOCKET_FD_ID_BASE (1 << 24)
+
+// Handling of new buffers for a socket source which holds its maximum number
+// of buffers, when connected to a listening socket sink.
+typedef enum {
+  GST_SOCKET_DROP_NEW,
+  GST_SOCKET_DROP_OLD,
+} GstSocketDropPolicy;
+
 typedef enum {
   DATA_MODE_NONE,
   DATA_MODE_VIDEO,
@@ -73,10 +93,17 @@ typedef enum {
 } GstFdSocketDataType;
 
 typedef struct _GstMessagePayload GstMessagePayload;
+typedef struct _GstVersionPayload GstVersionPayload;
+typedef struct _GstRegisterFdsPayload GstRegisterFdsPayload;
+typedef struct _GstUnregisterFdsPayload GstUnregisterFdsPayload;
+typedef struct _GstClientConfigPayload GstClientConfigPayload;
+typedef struct _GstMetaRingPayload GstMetaRingPayload;
+typedef struct _GstMetaRecordsPayload GstMetaRecordsPayload;
 typedef struct _GstBufferPayload GstBufferPayload;
 typedef struct _GstFramePayload GstFramePayload;
 typedef struct _GstTensorPayload GstTensorPayload;
 typedef struct _GstTextPayload GstTextPayload;
+typedef struct _GstDataPayload GstDataPayload;
 typedef struct _GstReturnBufferPayload GstReturnBufferPayload;
 typedef struct _GstFdCountPayload GstFdCountPayload;
 typedef struct _GstPayloadInfo GstPayloadInfo;
@@ -92,6 +119,46 @@ struct __attribute__((packed, aligned(4))) _GstMessagePayload {
   guint32 identity; // Message identity / type
 };
 
+// Used for both the HELLO message and the header of version 2 datagrams.
+struct __attribute__((packed, aligned(4))) _GstVersionPayload {
+  guint32 identity; // Message identity / type
+  guint32 version;
+};
+
+// Buffer IDs for the FDs passed with the same datagram, in the same order.
+struct __attribute__((packed, aligned(4))) _GstRegisterFdsPayload {
+  guint32 identity; // Message identity / type
+  gint    n_ids;
+  gint    buf_id[GST_MAX_MEM_BLOCKS];
+};
+
+// Buffer IDs whose FDs are no longer used and can be closed by the receiver.
+struct __attribute__((packed, aligned(4))) _GstUnregisterFdsPayload {
+  guint32 identity; // Message identity / type
+  gint    n_ids;
+  gint    buf_id[GST_MAX_UNREGISTER_FDS];
+};
+
+// Buffer delivery preferences sent by a socket source together with HELLO.
+struct __attribute__((packed, aligned(4))) _GstClientConfigPayload {
+  guint32 identity; // Message identity / type
+  guint32 queue_depth;
+  guint32 drop_policy;
+};
+
+// Announces the metadata ring, its memfd is passed as the last FD.
+struct __attribute__((packed, aligned(4))) _GstMetaRingPayload {
+  guint32 identity; // Message identity / type
+  guint32 size;
+};
+
+// Location of the metadata records of the buffer in the metadata ring.
+struct __attribute__((packed, aligned(4))) _GstMetaRecordsPayload {
+  guint32 identity; // Message identity / type
+  guint32 position;
+  guint32 size;
+};
+
 struct __attribute__((packed, aligned(4))) _GstBufferPayload {
   guint32  identity; // Message identity / type
   gint     buf_id[GST_MAX_MEM_BLOCKS];
@@ -133,6 +200,13 @@ struct __attribute__((packed, aligned(4))) _GstTextPayload {
   gsize   maxsize;
 };
 
+// Variable sized contents, used for text exceeding the text payload (version 4).
+struct __attribute__((packed, aligned(4))) _GstDataPayload {
+  guint32 identity; // Message identity / type
+  guint32 size;
+  guint8  contents[];
+};
+
 struct __attribute__((packed, aligned(4))) _GstReturnBufferPayload {
   guint32 identity; // Message identity / type
   gint    buf_id[GST_MAX_MEM_BLOCKS];
@@ -224,8 +298,20 @@ struct __attribute__((packed, aligned(4))) _GstVideoLmMetaPayload {
 // message carries a message (EOS/DISCONNECT).
 // buffer_info is the buffer description (BUFFER).
 // return_buffer carries the id of the return buffer (RETURN_BUFFER).
-// mem_block_info carries fd/non-fd memory info (FRAME/TENSOR/TEXT).
+// mem_block_info carries fd/non-fd memory info (FRAME/TENSOR/TEXT/DATA).
+// hello carries the highest supported protocol version (HELLO).
+// client_config carries the buffer delivery preferences (CLIENT_CONFIG).
+// header selects protocol version 2 framing when set (HEADER).
+// register_fds and unregister_fds carry FD registry updates (version 2).
+// meta_ring and meta_records carry the metadata ring location (version 3).
 struct __attribute__((packed, aligned(4))) _GstPayloadInfo {
+  GstVersionPayload *      hello;
+  GstClientConfigPayload * client_config;
+  GstVersionPayload *      header;
+  GstRegisterFdsPayload *  register_fds;
+  GstUnregisterFdsPayload *unregister_fds;
+  GstMetaRingPayload *     meta_ring;
+  GstMetaRecordsPayload *  meta_records;
   GstMessagePayload *      message;
   GstBufferPayload *       buffer_info;
   GstReturnBufferPayload * return_buffer;
@@ -252,7 +338,15 @@ enum
   MESSAGE_PROTECTION_META, //8
   MESSAGE_VIDEO_ROI_META,  //9
   MESSAGE_VIDEO_CLASS_META,//10
-  MESSAGE_VIDEO_LM_META    //11
+  MESSAGE_VIDEO_LM_META,   //11
+  MESSAGE_HELLO,           //12
+  MESSAGE_HEADER,          //13
+  MESSAGE_REGISTER_FDS,    //14
+  MESSAGE_UNREGISTER_FDS,  //15
+  MESSAGE_CLIENT_CONFIG,   //16
+  MESSAGE_META_RING,       //17
+  MESSAGE_META_RECORDS,    //18
+  MESSAGE_DATA             //19
 };
 
 void
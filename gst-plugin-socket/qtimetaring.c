@@ -0,0 +1,698 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "qtimetaring.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <gst/video/gstvideometa.h>
+#include <gst/video/gstvideoclassificationmeta.h>
+#include <gst/video/gstvideolandmarksmeta.h>
+#include <gst/video/video-utils.h>
+
+#define GST_META_RECORDS_APPEND(records, value) \
+    g_byte_array_append (records, (const guint8 *) &(value), sizeof (value))
+
+// Minimum encoded sizes, used to validate counts before allocating arrays.
+#define GST_META_RECORD_LABEL_MIN_SIZE    (sizeof (gdouble) + 4 * sizeof (guint32))
+#define GST_META_RECORD_KEYPOINT_MIN_SIZE (sizeof (gdouble) + 5 * sizeof (guint32))
+#define GST_META_RECORD_LINK_SIZE         (2 * sizeof (guint32))
+
+typedef struct _GstMetaRecordHeader GstMetaRecordHeader;
+typedef struct _GstMetaRecordReader GstMetaRecordReader;
+
+typedef enum {
+  GST_META_RECORD_ROI            = 1,
+  GST_META_RECORD_CLASSIFICATION = 2,
+  GST_META_RECORD_LANDMARKS      = 3,
+} GstMetaRecordType;
+
+typedef enum {
+  // ROI 'ObjectDetection' param with only confidence and color, in binary form.
+  GST_META_RECORD_FLAG_DETECTION        = (1 << 0),
+  // ROI 'ObjectDetection' param with other fields, serialized as string.
+  GST_META_RECORD_FLAG_DETECTION_STRING = (1 << 1),
+  // ROI 'xtraparams' param or landmarks xtraparams, serialized as string.
+  GST_META_RECORD_FLAG_XTRAPARAMS       = (1 << 2),
+} GstMetaRecordFlags;
+
+// Every record starts 8 bytes aligned with this header. Integers are in host
+// byte order, strings are prefixed with their length including the NULL
+// terminator and are padded to 4 bytes.
+struct _GstMetaRecordHeader {
+  guint16 type;
+  guint16 flags;
+  guint32 size;
+  gint32  id;
+  gint32  parent_id;
+};
+
+struct _GstMetaRecordReader {
+  const guint8 *data;
+  gsize        size;
+  gsize        offset;
+};
+
+G_STATIC_ASSERT (sizeof (GstMetaRingHeader) == 16);
+G_STATIC_ASSERT (sizeof (GstMetaRecordHeader) == 16);
+
+GstMetaRing *
+gst_meta_ring_new (guint32 size)
+{
+  GstMetaRing *ring = NULL;
+  gpointer map = NULL;
+  gint fd = -1;
+
+  g_return_val_if_fail ((size != 0) && ((size & (size - 1)) == 0), NULL);
+
+  if ((fd = memfd_create ("qti-meta-ring", MFD_CLOEXEC)) < 0) {
+    GST_ERROR ("Failed to create memfd, error: %s!", g_strerror (errno));
+    return NULL;
+  }
+
+  if (ftruncate (fd, sizeof (GstMetaRingHeader) + size) < 0) {
+    GST_ERROR ("Failed to resize memfd, error: %s!", g_strerror (errno));
+    close (fd);
+    return NULL;
+  }
+
+  map = mmap (NULL, sizeof (GstMetaRingHeader) + size, PROT_READ | PROT_WRITE,
+      MAP_SHARED, fd, 0);
+
+  if (map == MAP_FAILED) {
+    GST_ERROR ("Failed to map memfd, error: %s!", g_strerror (errno));
+    close (fd);
+    return NULL;
+  }
+
+  ring = g_slice_new0 (GstMetaRing);
+
+  ring->fd = fd;
+  ring->header = (GstMetaRingHeader *) map;
+  ring->data = (guint8 *) map + sizeof (GstMetaRingHeader);
+  ring->size = size;
+
+  ring->header->magic = GST_META_RING_MAGIC;
+  ring->header->size = size;
+  g_atomic_int_set (&ring->header->head, 0);
+  g_atomic_int_set (&ring->header->tail, 0);
+
+  return ring;
+}
+
+GstMetaRing *
+gst_meta_ring_import (gint fd)
+{
+  GstMetaRing *ring = NULL;
+  GstMetaRingHeader *header = NULL;
+  struct stat st;
+  gpointer map = NULL;
+
+  if ((fstat (fd, &st) < 0) || (st.st_size < (off_t) sizeof (GstMetaRingHeader))) {
+    GST_ERROR ("Invalid meta ring FD %d!", fd);
+    close (fd);
+    return NULL;
+  }
+
+  map = mmap (NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+  if (map == MAP_FAILED) {
+    GST_ERROR ("Failed to map meta ring, error: %s!", g_strerror (errno));
+    close (fd);
+    return NULL;
+  }
+
+  header = (GstMetaRingHeader *) map;
+
+  if ((header->magic != GST_META_RING_MAGIC) || (header->size == 0) ||
+      ((header->size & (header->size - 1)) != 0) ||
+      ((sizeof (GstMetaRingHeader) + header->size) != (gsize) st.st_size)) {
+    GST_ERROR ("Invalid meta ring header!");
+    munmap (map, st.st_size);
+    close (fd);
+    return NULL;
+  }
+
+  ring = g_slice_new0 (GstMetaRing);
+
+  ring->fd = fd;
+  ring->header = header;
+  ring->data = (guint8 *) map + sizeof (GstMetaRingHeader);
+  ring->size = header->size;
+
+  return ring;
+}
+
+void
+gst_meta_ring_free (GstMetaRing * ring)
+{
+  munmap (ring->header, sizeof (GstMetaRingHeader) + ring->size);
+  close (ring->fd);
+
+  g_slice_free (GstMetaRing, ring);
+}
+
+gboolean
+gst_meta_ring_write (GstMetaRing * ring, gconstpointer data, guint32 size,
+    guint32 * position)
+{
+  guint32 head = g_atomic_int_get (&ring->header->head);
+  guint32 tail = g_atomic_int_get (&ring->header->tail);
+  guint32 offset = head & (ring->size - 1);
+  guint32 padding = 0;
+
+  if (size > ring->size)
+    return FALSE;
+
+  // Records are never split, skip the end of the data area if they don't fit.
+  if (size > (ring->size - offset))
+    padding = ring->size - offset;
+
+  if ((size + padding) > (ring->size - (head - tail)))
+    return FALSE;
+
+  memcpy (ring->data + ((head + padding) & (ring->size - 1)), data, size);
+
+  *position = head + padding;
+  g_atomic_int_set (&ring->header->head, head + padding + size);
+
+  return TRUE;
+}
+
+void
+gst_meta_ring_rewind (GstMetaRing * ring, guint32 position)
+{
+  g_atomic_int_set (&ring->header->head, position);
+}
+
+const guint8 *
+gst_meta_ring_read (GstMetaRing * ring, guint32 position, guint32 size)
+{
+  guint32 head = g_atomic_int_get (&ring->header->head);
+  guint32 tail = g_atomic_int_get (&ring->header->tail);
+  guint32 offset = position & (ring->size - 1);
+
+  if ((size > ring->size) || (size > (ring->size - offset)))
+    return NULL;
+
+  // Records have to be within the written but not yet consumed positions.
+  if (((position - tail) > (head - tail)) ||
+      (size > (head - position)))
+    return NULL;
+
+  return ring->data + offset;
+}
+
+void
+gst_meta_ring_release (GstMetaRing * ring, guint32 position, guint32 size)
+{
+  g_atomic_int_set (&ring->header->tail, position + size);
+}
+
+static void
+gst_meta_records_append_string (GByteArray * records, const gchar * string)
+{
+  static const guint8 zeros[4] = { 0, };
+  guint32 length = strlen (string) + 1;
+
+  GST_META_RECORDS_APPEND (records, length);
+  g_byte_array_append (records, (const guint8 *) string, length);
+  g_byte_array_append (records, zeros, GST_ROUND_UP_4 (length) - length);
+}
+
+static void
+gst_meta_records_append_structure (GByteArray * records,
+    const GstStructure * structure)
+{
+  gchar *string = gst_structure_to_string (structure);
+
+  gst_meta_records_append_string (records, string);
+  g_free (string);
+}
+
+static guint
+gst_meta_records_begin (GByteArray * records, GstMetaRecordType type,
+    gint id, gint parent_id)
+{
+  GstMetaRecordHeader header = { 0, };
+  guint offset = records->len;
+
+  header.type = type;
+  header.id = id;
+  header.parent_id = parent_id;
+
+  GST_META_RECORDS_APPEND (records, header);
+  return offset;
+}
+
+static void
+gst_meta_records_end (GByteArray * records, guint offset, guint16 flags)
+{
+  static const guint8 zeros[8] = { 0, };
+  GstMetaRecordHeader *header = NULL;
+  guint size = records->len - offset;
+
+  g_byte_array_append (records, zeros, GST_ROUND_UP_8 (size) - size);
+
+  header = (GstMetaRecordHeader *) (records->data + offset);
+  header->size = records->len - offset;
+  header->flags = flags;
+}
+
+static void
+gst_meta_records_serialize_roi (GByteArray * records,
+    GstVideoRegionOfInterestMeta * roimeta)
+{
+  const GstStructure *detection = NULL, *xtraparams = NULL;
+  gdouble confidence = 0.0;
+  guint32 coordinates[4] = { roimeta->x, roimeta->y, roimeta->w, roimeta->h };
+  guint32 color = 0;
+  guint offset = 0;
+  guint16 flags = 0;
+
+  offset = gst_meta_records_begin (records, GST_META_RECORD_ROI, roimeta->id,
+      roimeta->parent_id);
+
+  GST_META_RECORDS_APPEND (records, coordinates);
+  gst_meta_records_append_string (records,
+      g_quark_to_string (roimeta->roi_type));
+
+  detection = gst_video_region_of_interest_meta_get_param (roimeta,
+      "ObjectDetection");
+
+  // The common case of only confidence and color avoids string serialization.
+  if ((detection != NULL) && (gst_structure_n_fields (detection) == 2) &&
+      gst_structure_get_double (detection, "confidence", &confidence) &&
+      gst_structure_get_uint (detection, "color", &color)) {
+    GST_META_RECORDS_APPEND (records, confidence);
+    GST_META_RECORDS_APPEND (records, color);
+    flags |= GST_META_RECORD_FLAG_DETECTION;
+  } else if (detection != NULL) {
+    gst_meta_records_append_structure (records, detection);
+    flags |= GST_META_RECORD_FLAG_DETECTION_STRING;
+  }
+
+  xtraparams = gst_video_region_of_interest_meta_get_param (roimeta,
+      "xtraparams");
+
+  if (xtraparams != NULL) {
+    gst_meta_records_append_structure (records, xtraparams);
+    flags |= GST_META_RECORD_FLAG_XTRAPARAMS;
+  }
+
+  gst_meta_records_end (records, offset, flags);
+}
+
+static void
+gst_meta_records_serialize_classification (GByteArray * records,
+    GstVideoClassificationMeta * classmeta)
+{
+  guint32 n_labels = classmeta->labels->len, idx = 0;
+  guint offset = 0;
+
+  offset = gst_meta_records_begin (records, GST_META_RECORD_CLASSIFICATION,
+      classmeta->id, classmeta->parent_id);
+
+  GST_META_RECORDS_APPEND (records, n_labels);
+
+  for (idx = 0; idx < n_labels; idx++) {
+    GstClassLabel *label =
+        &(g_array_index (classmeta->labels, GstClassLabel, idx));
+    guint32 has_xtraparams = (label->xtraparams != NULL);
+
+    GST_META_RECORDS_APPEND (records, label->confidence);
+    GST_META_RECORDS_APPEND (records, label->color);
+    GST_META_RECORDS_APPEND (records, has_xtraparams);
+    gst_meta_records_append_string (records, g_quark_to_string (label->name));
+
+    if (has_xtraparams)
+      gst_meta_records_append_structure (records, label->xtraparams);
+  }
+
+  gst_meta_records_end (records, offset, 0);
+}
+
+static void
+gst_meta_records_serialize_landmarks (GByteArray * records,
+    GstVideoLandmarksMeta * lmkmeta)
+{
+  guint32 n_keypoints = lmkmeta->keypoints->len;
+  guint32 n_links = (lmkmeta->links != NULL) ? lmkmeta->links->len : 0;
+  guint32 idx = 0;
+  guint offset = 0;
+  guint16 flags = 0;
+
+  offset = gst_meta_records_begin (records, GST_META_RECORD_LANDMARKS,
+      lmkmeta->id, lmkmeta->parent_id);
+
+  GST_META_RECORDS_APPEND (records, lmkmeta->confidence);
+  GST_META_RECORDS_APPEND (records, n_keypoints);
+  GST_META_RECORDS_APPEND (records, n_links);
+
+  for (idx = 0; idx < n_keypoints; idx++) {
+    GstVideoKeypoint *kp =
+        &(g_array_index (lmkmeta->keypoints, GstVideoKeypoint, idx));
+    gint32 position[2] = { kp->x, kp->y };
+
+    GST_META_RECORDS_APPEND (records, kp->confidence);
+    GST_META_RECORDS_APPEND (records, kp->color);
+    GST_META_RECORDS_APPEND (records, position);
+    gst_meta_records_append_string (records, g_quark_to_string (kp->name));
+  }
+
+  for (idx = 0; idx < n_links; idx++) {
+    GstVideoKeypointLink *link =
+        &(g_array_index (lmkmeta->links, GstVideoKeypointLink, idx));
+    guint32 indices[2] = { link->s_kp_idx, link->d_kp_idx };
+
+    GST_META_RECORDS_APPEND (records, indices);
+  }
+
+  if (lmkmeta->xtraparams != NULL) {
+    gst_meta_records_append_structure (records, lmkmeta->xtraparams);
+    flags |= GST_META_RECORD_FLAG_XTRAPARAMS;
+  }
+
+  gst_meta_records_end (records, offset, flags);
+}
+
+guint
+gst_meta_records_serialize (GstBuffer * buffer, GByteArray * records)
+{
+  GstMeta *meta = NULL;
+  gpointer state = NULL;
+  guint n_records = 0;
+
+  while ((meta = gst_buffer_iterate_meta (buffer, &state))) {
+    if (meta->info->api == GST_VIDEO_REGION_OF_INTEREST_META_API_TYPE) {
+      gst_meta_records_serialize_roi (records,
+          GST_VIDEO_ROI_META_CAST (meta));
+    } else if (meta->info->api == GST_VIDEO_CLASSIFICATION_META_API_TYPE) {
+      gst_meta_records_serialize_classification (records,
+          GST_VIDEO_CLASSIFICATION_META_CAST (meta));
+    } else if (meta->info->api == GST_VIDEO_LANDMARKS_META_API_TYPE) {
+      gst_meta_records_serialize_landmarks (records,
+          GST_VIDEO_LANDMARKS_META_CAST (meta));
+    } else {
+      continue;
+    }
+
+    n_records++;
+  }
+
+  return n_records;
+}
+
+static inline gsize
+gst_meta_record_reader_remaining (GstMetaRecordReader * reader)
+{
+  return reader->size - reader->offset;
+}
+
+static gboolean
+gst_meta_record_reader_get (GstMetaRecordReader * reader, gpointer value,
+    gsize size)
+{
+  if (size > gst_meta_record_reader_remaining (reader))
+    return FALSE;
+
+  // Fields are not naturally aligned, copy instead of dereferencing.
+  memcpy (value, reader->data + reader->offset, size);
+  reader->offset += size;
+
+  return TRUE;
+}
+
+static gboolean
+gst_meta_record_reader_get_string (GstMetaRecordReader * reader,
+    const gchar ** string)
+{
+  guint32 length = 0;
+
+  if (!gst_meta_record_reader_get (reader, &length, sizeof (length)))
+    return FALSE;
+
+  if ((length == 0) || (length > gst_meta_record_reader_remaining (reader)) ||
+      (GST_ROUND_UP_4 (length) > gst_meta_record_reader_remaining (reader)))
+    return FALSE;
+
+  *string = (const gchar *) (reader->data + reader->offset);
+
+  if ((*string)[length - 1] != '\0')
+    return FALSE;
+
+  reader->offset += GST_ROUND_UP_4 (length);
+  return TRUE;
+}
+
+static gboolean
+gst_meta_records_parse_roi (GstBuffer * buffer,
+    const GstMetaRecordHeader * header, GstMetaRecordReader * reader)
+{
+  GstVideoRegionOfInterestMeta *roimeta = NULL;
+  GstStructure *structure = NULL;
+  const gchar *label = NULL, *detection = NULL, *xtraparams = NULL;
+  guint32 coordinates[4] = { 0, };
+  gdouble confidence = 0.0;
+  guint32 color = 0;
+
+  if (!gst_meta_record_reader_get (reader, coordinates, sizeof (coordinates)) ||
+      !gst_meta_record_reader_get_string (reader, &label))
+    return FALSE;
+
+  if ((header->flags & GST_META_RECORD_FLAG_DETECTION) &&
+      (!gst_meta_record_reader_get (reader, &confidence, sizeof (confidence)) ||
+       !gst_meta_record_reader_get (reader, &color, sizeof (color))))
+    return FALSE;
+
+  if ((header->flags & GST_META_RECORD_FLAG_DETECTION_STRING) &&
+      !gst_meta_record_reader_get_string (reader, &detection))
+    return FALSE;
+
+  if ((header->flags & GST_META_RECORD_FLAG_XTRAPARAMS) &&
+      !gst_meta_record_reader_get_string (reader, &xtraparams))
+    return FALSE;
+
+  roimeta = gst_buffer_add_video_region_of_interest_meta_id (buffer,
+      g_quark_from_string (label), coordinates[0], coordinates[1],
+      coordinates[2], coordinates[3]);
+
+  roimeta->id = header->id;
+  roimeta->parent_id = header->parent_id;
+
+  if (header->flags & GST_META_RECORD_FLAG_DETECTION) {
+    structure = gst_structure_new ("ObjectDetection",
+        "confidence", G_TYPE_DOUBLE, confidence,
+        "color", G_TYPE_UINT, color, NULL);
+    gst_video_region_of_interest_meta_add_param (roimeta, structure);
+  } else if (detection != NULL) {
+    if ((structure = gst_structure_from_string (detection, NULL)) != NULL)
+      gst_video_region_of_interest_meta_add_param (roimeta, structure);
+    else
+      GST_WARNING ("Parsing detection meta from string failed!");
+  }
+
+  if (xtraparams != NULL) {
+    if ((structure = gst_structure_from_string (xtraparams, NULL)) != NULL)
+      gst_video_region_of_interest_meta_add_param (roimeta, structure);
+    else
+      GST_WARNING ("Parsing detection xtraparams from string failed!");
+  }
+
+  return TRUE;
+}
+
+static gboolean
+gst_meta_records_parse_classification (GstBuffer * buffer,
+    const GstMetaRecordHeader * header, GstMetaRecordReader * reader)
+{
+  GstVideoClassificationMeta *classmeta = NULL;
+  GArray *labels = NULL;
+  guint32 n_labels = 0, idx = 0;
+
+  if (!gst_meta_record_reader_get (reader, &n_labels, sizeof (n_labels)) ||
+      (n_labels > (gst_meta_record_reader_remaining (reader) /
+          GST_META_RECORD_LABEL_MIN_SIZE)))
+    return FALSE;
+
+  labels = g_array_sized_new (FALSE, TRUE, sizeof (GstClassLabel), n_labels);
+  g_array_set_size (labels, n_labels);
+
+  for (idx = 0; idx < n_labels; idx++) {
+    GstClassLabel *label = &(g_array_index (labels, GstClassLabel, idx));
+    const gchar *name = NULL, *xtraparams = NULL;
+    guint32 has_xtraparams = 0;
+
+    if (!gst_meta_record_reader_get (reader, &label->confidence,
+            sizeof (label->confidence)) ||
+        !gst_meta_record_reader_get (reader, &label->color,
+            sizeof (label->color)) ||
+        !gst_meta_record_reader_get (reader, &has_xtraparams,
+            sizeof (has_xtraparams)) ||
+        !gst_meta_record_reader_get_string (reader, &name) ||
+        (has_xtraparams &&
+            !gst_meta_record_reader_get_string (reader, &xtraparams)))
+      break;
+
+    label->name = g_quark_from_string (name);
+
+    if ((xtraparams != NULL) &&
+        (label->xtraparams = gst_structure_from_string (xtraparams, NULL)) == NULL)
+      GST_WARNING ("Parsing label xtraparams from string failed!");
+  }
+
+  if (idx != n_labels) {
+    while (idx-- > 0)
+      gst_video_classification_label_cleanup (
+          &(g_array_index (labels, GstClassLabel, idx)));
+
+    g_array_free (labels, TRUE);
+    return FALSE;
+  }
+
+  // The meta frees the labels array, their extra params are freed with it.
+  g_array_set_clear_func (labels,
+      (GDestroyNotify) gst_video_classification_label_cleanup);
+
+  classmeta = gst_buffer_add_video_classification_meta (buffer, labels);
+
+  classmeta->id = header->id;
+  classmeta->parent_id = header->parent_id;
+
+  return TRUE;
+}
+
+static gboolean
+gst_meta_records_parse_landmarks (GstBuffer * buffer,
+    const GstMetaRecordHeader * header, GstMetaRecordReader * reader)
+{
+  GstVideoLandmarksMeta *lmkmeta = NULL;
+  GArray *keypoints = NULL, *links = NULL;
+  const gchar *xtraparams = NULL;
+  gdouble confidence = 0.0;
+  guint32 n_keypoints = 0, n_links = 0, idx = 0;
+
+  if (!gst_meta_record_reader_get (reader, &confidence, sizeof (confidence)) ||
+      !gst_meta_record_reader_get (reader, &n_keypoints, sizeof (n_keypoints)) ||
+      !gst_meta_record_reader_get (reader, &n_links, sizeof (n_links)))
+    return FALSE;
+
+  if ((n_keypoints > (gst_meta_record_reader_remaining (reader) /
+          GST_META_RECORD_KEYPOINT_MIN_SIZE)) ||
+      (n_links > (gst_meta_record_reader_remaining (reader) /
+          GST_META_RECORD_LINK_SIZE)))
+    return FALSE;
+
+  keypoints = g_array_sized_new (FALSE, TRUE, sizeof (GstVideoKeypoint),
+      n_keypoints);
+  g_array_set_size (keypoints, n_keypoints);
+
+  links = g_array_sized_new (FALSE, TRUE, sizeof (GstVideoKeypointLink),
+      n_links);
+  g_array_set_size (links, n_links);
+
+  for (idx = 0; idx < n_keypoints; idx++) {
+    GstVideoKeypoint *kp = &(g_array_index (keypoints, GstVideoKeypoint, idx));
+    const gchar *name = NULL;
+    gint32 position[2] = { 0, };
+
+    if (!gst_meta_record_reader_get (reader, &kp->confidence,
+            sizeof (kp->confidence)) ||
+        !gst_meta_record_reader_get (reader, &kp->color, sizeof (kp->color)) ||
+        !gst_meta_record_reader_get (reader, position, sizeof (position)) ||
+        !gst_meta_record_reader_get_string (reader, &name))
+      goto cleanup;
+
+    kp->name = g_quark_from_string (name);
+    kp->x = position[0];
+    kp->y = position[1];
+  }
+
+  for (idx = 0; idx < n_links; idx++) {
+    GstVideoKeypointLink *link =
+        &(g_array_index (links, GstVideoKeypointLink, idx));
+    guint32 indices[2] = { 0, };
+
+    if (!gst_meta_record_reader_get (reader, indices, sizeof (indices)))
+      goto cleanup;
+
+    link->s_kp_idx = indices[0];
+    link->d_kp_idx = indices[1];
+  }
+
+  if ((header->flags & GST_META_RECORD_FLAG_XTRAPARAMS) &&
+      !gst_meta_record_reader_get_string (reader, &xtraparams))
+    goto cleanup;
+
+  lmkmeta = gst_buffer_add_video_landmarks_meta (buffer, confidence,
+      keypoints, links);
+
+  lmkmeta->id = header->id;
+  lmkmeta->parent_id = header->parent_id;
+
+  if ((xtraparams != NULL) &&
+      (lmkmeta->xtraparams = gst_structure_from_string (xtraparams, NULL)) == NULL)
+    GST_WARNING ("Parsing landmarks xtraparams from string failed!");
+
+  return TRUE;
+
+cleanup:
+  g_array_free (keypoints, TRUE);
+  g_array_free (links, TRUE);
+
+  return FALSE;
+}
+
+gboolean
+gst_meta_records_deserialize (GstBuffer * buffer, const guint8 * data,
+    gsize size)
+{
+  GstMetaRecordHeader header;
+  GstMetaRecordReader reader;
+  gsize offset = 0;
+  gboolean success = TRUE;
+
+  while (success && (offset < size)) {
+    if ((size - offset) < sizeof (header))
+      return FALSE;
+
+    memcpy (&header, data + offset, sizeof (header));
+
+    if ((header.size < sizeof (header)) || (header.size > (size - offset)))
+      return FALSE;
+
+    reader.data = data + offset;
+    reader.size = header.size;
+    reader.offset = sizeof (header);
+
+    switch (header.type) {
+      case GST_META_RECORD_ROI:
+        success = gst_meta_records_parse_roi (buffer, &header, &reader);
+        break;
+      case GST_META_RECORD_CLASSIFICATION:
+        success = gst_meta_records_parse_classification (buffer, &header,
+            &reader);
+        break;
+      case GST_META_RECORD_LANDMARKS:
+        success = gst_meta_records_parse_landmarks (buffer, &header, &reader);
+        break;
+      default:
+        // Records added by newer versions are skipped.
+        break;
+    }
+
+    offset += header.size;
+  }
+
+  return success;
+}
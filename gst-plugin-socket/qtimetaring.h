@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef __GST_QTI_META_RING_H__
+#define __GST_QTI_META_RING_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+#define GST_META_RING_MAGIC    GST_MAKE_FOURCC ('Q', 'M', 'R', 'G')
+
+// Size of the ring data area, must be a power of 2.
+#define GST_META_RING_SIZE     (1 << 20)
+
+typedef struct _GstMetaRing GstMetaRing;
+typedef struct _GstMetaRingHeader GstMetaRingHeader;
+
+/**
+ * GstMetaRingHeader:
+ * @magic: Always #GST_META_RING_MAGIC.
+ * @size: Size in bytes of the data area following the header.
+ * @head: Position up to which records were written, updated by the producer.
+ * @tail: Position up to which records were consumed, updated by the consumer.
+ *
+ * Header at the beginning of the shared memory. Positions increase
+ * monotonically and wrap around at 2^32, the offset inside the data area is
+ * the position modulo @size.
+ */
+struct _GstMetaRingHeader {
+  guint32 magic;
+  guint32 size;
+  gint    head;
+  gint    tail;
+};
+
+/**
+ * GstMetaRing:
+ * @fd: FD of the memfd backing the ring.
+ * @header: Shared header, mapped at the beginning of the memfd.
+ * @data: Shared data area, mapped right after the header.
+ * @size: Size in bytes of the data area.
+ *
+ * Single producer, single consumer ring of variable length metadata records
+ * shared between a socket sink and a socket source.
+ */
+struct _GstMetaRing {
+  gint              fd;
+  GstMetaRingHeader *header;
+  guint8            *data;
+  guint32           size;
+};
+
+/**
+ * gst_meta_ring_new:
+ * @size: Size in bytes of the data area, must be a power of 2.
+ *
+ * Create a new ring backed by an anonymous memfd. The FD is passed to the
+ * consumer which maps it with gst_meta_ring_import().
+ *
+ * return: Pointer to the ring on success or NULL on failure
+ */
+GstMetaRing *  gst_meta_ring_new (guint32 size);
+
+/**
+ * gst_meta_ring_import:
+ * @fd: FD of a memfd created by gst_meta_ring_new() in the producer.
+ *
+ * Map a ring received from the producer. Takes ownership of the FD.
+ *
+ * return: Pointer to the ring on success or NULL on failure
+ */
+GstMetaRing *  gst_meta_ring_import (gint fd);
+
+/**
+ * gst_meta_ring_free:
+ * @ring: The ring.
+ *
+ * Unmap the ring and close its FD.
+ *
+ * return: NONE
+ */
+void           gst_meta_ring_free (GstMetaRing * ring);
+
+/**
+ * gst_meta_ring_write:
+ * @ring: The ring.
+ * @data: Records to be written.
+ * @size: Size of the records in bytes.
+ * @position: (out): Position at which the records were written.
+ *
+ * Copy records into contiguous free space of the ring. Producer only.
+ *
+ * return: TRUE on success or FALSE if there is not enough free space
+ */
+gboolean       gst_meta_ring_write (GstMetaRing * ring, gconstpointer data,
+                                    guint32 size, guint32 * position);
+
+/**
+ * gst_meta_ring_rewind:
+ * @ring: The ring.
+ * @position: Position returned by the last gst_meta_ring_write().
+ *
+ * Discard the last written records, e.g. when the message referencing them
+ * could not be sent. Producer only.
+ *
+ * return: NONE
+ */
+void           gst_meta_ring_rewind (GstMetaRing * ring, guint32 position);
+
+/**
+ * gst_meta_ring_read:
+ * @ring: The ring.
+ * @position: Position received from the producer.
+ * @size: Size of the records in bytes.
+ *
+ * Get the records written at the given position. Consumer only.
+ *
+ * return: Pointer to the records or NULL if position and size are invalid
+ */
+const guint8 * gst_meta_ring_read (GstMetaRing * ring, guint32 position,
+                                   guint32 size);
+
+/**
+ * gst_meta_ring_release:
+ * @ring: The ring.
+ * @position: Position received from the producer.
+ * @size: Size of the records in bytes.
+ *
+ * Mark the records and everything written before them as consumed, making
+ * their space available to the producer. Consumer only.
+ *
+ * return: NONE
+ */
+void           gst_meta_ring_release (GstMetaRing * ring, guint32 position,
+                                      guint32 size);
+
+/**
+ * gst_meta_records_serialize:
+ * @buffer: Buffer whose ROI, classification and landmarks metas are encoded.
+ * @records: Array to which the encoded records are appended.
+ *
+ * Encode the video metas of a buffer into compact variable length records.
+ *
+ * return: Number of encoded records
+ */
+guint          gst_meta_records_serialize (GstBuffer * buffer,
+                                           GByteArray * records);
+
+/**
+ * gst_meta_records_deserialize:
+ * @buffer: Buffer to which the decoded metas are attached.
+ * @data: Encoded records.
+ * @size: Size of the encoded records in bytes.
+ *
+ * Decode records produced by gst_meta_records_serialize() and attach them as
+ * video metas to the buffer. Decoding stops at the first malformed record.
+ *
+ * return: TRUE on success or FALSE if a record was malformed
+ */
+gboolean       gst_meta_records_deserialize (GstBuffer * buffer,
+                                             const guint8 * data, gsize size);
+
+G_END_DECLS
+
+#endif // __GST_QTI_META_RING_H__
@@ -37,14 +37,17 @@
 #endif
 
 #include "qtisocketsink.h"
+#include "qtimetaring.h"
 
 #include <gst/allocators/gstfdmemory.h>
 #include <gst/utils/common-utils.h>
 
 #include <gst/ml/gstmlmeta.h>
+#include <gst/ml/ml-meta-records.h>
 #include <gst/video/video-utils.h>
 
 #include <errno.h>
+#include <fcntl.h>
 
 #define gst_socket_sink_parent_class parent_class
 G_DEFINE_TYPE (GstFdSocketSink, gst_socket_sink, GST_TYPE_BASE_SINK);
@@ -55,14 +58,66 @@ GST_DEBUG_CATEGORY_STATIC (gst_socket_sink_debug);
 #define GST_SOCKET_SINK_CAPS \
     "neural-network/tensors;" \
     "video/x-raw(ANY);" \
-    "text/x-raw"
+    "text/x-raw;" \
+    GST_ML_META_RECORDS_CAPS
 
 #define POLL_TIMEOUT_MS 100000
+#define SERVER_POLL_TIMEOUT_MS 100
+
+#define DEFAULT_PROP_LISTEN FALSE
+
+typedef struct _GstSocketFdEntry GstSocketFdEntry;
+
+struct _GstSocketFdRegistry {
+  GMutex lock;
+  // Next buffer ID to be assigned to a newly registered memory block.
+  gint   nextid;
+  // Buffer IDs of released memory blocks which are pending unregistration.
+  GArray *released;
+
+  // Metadata ring shared with the socket source (version 3), created on use.
+  GstMetaRing *ring;
+  // Whether the ring FD was already passed to the socket source.
+  gboolean     ring_shared;
+};
+
+// Attached as qdata to each registered memory block.
+struct _GstSocketFdEntry {
+  GstSocketFdRegistry *registry;
+  gint                 id;
+};
+
+// Socket source connected to a listening socket sink.
+struct _GstSocketSinkClient {
+  gint                 socket;
+  // Index of the client, selects the key of the memory block registry entries.
+  guint                slot;
+  // Set once the HELLO message was received from the socket source.
+  gboolean             ready;
+  guint                version;
+  GstSocketFdRegistry *registry;
+
+  GMutex               lock;
+  // Buffers held by the socket source, one reference per buffer ID.
+  GHashTable          *bufmap;
+  // Number of additional sends of a buffer ID which is already held.
+  GHashTable          *bufrefs;
+  // Number of buffers held by the socket source.
+  guint                n_buffers;
+
+  // Maximum number of held buffers requested by the socket source, 0 if none.
+  guint                queue_depth;
+  GstSocketDropPolicy  policy;
+  // Latest buffer waiting for a returned buffer, with GST_SOCKET_DROP_OLD.
+  GstBuffer           *pending;
+  guint64              n_dropped;
+};
 
 enum
 {
   PROP_0,
-  PROP_SOCKET
+  PROP_SOCKET,
+  PROP_LISTEN
 };
 
 static GstStaticPadTemplate socket_sink_template =
@@ -84,6 +139,154 @@ gst_socket_sink_get_protection_meta_count (GstBuffer * buffer)
   return size;
 }
 
+static GstSocketFdRegistry *
+gst_socket_fd_registry_new (void)
+{
+  GstSocketFdRegistry *registry = g_atomic_rc_box_new0 (GstSocketFdRegistry);
+
+  g_mutex_init (&registry->lock);
+  registry->nextid = GST_SOCKET_FD_ID_BASE;
+  registry->released = g_array_new (FALSE, FALSE, sizeof (gint));
+
+  return registry;
+}
+
+static void
+gst_socket_fd_registry_clear (GstSocketFdRegistry * registry)
+{
+  if (registry->ring != NULL)
+    gst_meta_ring_free (registry->ring);
+
+  g_array_free (registry->released, TRUE);
+  g_mutex_clear (&registry->lock);
+}
+
+static void
+gst_socket_fd_registry_unref (GstSocketFdRegistry * registry)
+{
+  g_atomic_rc_box_release_full (registry,
+      (GDestroyNotify) gst_socket_fd_registry_clear);
+}
+
+static void
+gst_socket_fd_entry_free (GstSocketFdEntry * entry)
+{
+  GstSocketFdRegistry *registry = entry->registry;
+
+  // Memory block was freed, its FD can be closed by the socket source.
+  g_mutex_lock (&registry->lock);
+  g_array_append_val (registry->released, entry->id);
+  g_mutex_unlock (&registry->lock);
+
+  gst_socket_fd_registry_unref (registry);
+  g_slice_free (GstSocketFdEntry, entry);
+}
+
+static gint
+gst_socket_fd_registry_get_id (GstSocketFdRegistry * registry, GQuark quark,
+    GstMemory * memory, gboolean * registered)
+{
+  GstSocketFdEntry *entry = NULL;
+
+  entry = gst_mini_object_get_qdata (GST_MINI_OBJECT (memory), quark);
+
+  // Entries from a previous connection are replaced by new registrations.
+  if ((entry != NULL) && (entry->registry == registry)) {
+    *registered = FALSE;
+    return entry->id;
+  }
+
+  entry = g_slice_new (GstSocketFdEntry);
+  entry->registry = g_atomic_rc_box_acquire (registry);
+
+  g_mutex_lock (&registry->lock);
+  entry->id = registry->nextid++;
+  g_mutex_unlock (&registry->lock);
+
+  gst_mini_object_set_qdata (GST_MINI_OBJECT (memory), quark, entry,
+      (GDestroyNotify) gst_socket_fd_entry_free);
+
+  *registered = TRUE;
+  return entry->id;
+}
+
+static GstUnregisterFdsPayload *
+gst_socket_fd_registry_take_released (GstSocketFdRegistry * registry)
+{
+  GstUnregisterFdsPayload *unregister_pl = NULL;
+  guint idx = 0;
+
+  g_mutex_lock (&registry->lock);
+
+  if (registry->released->len == 0) {
+    g_mutex_unlock (&registry->lock);
+    return NULL;
+  }
+
+  unregister_pl = g_malloc0 (sizeof (GstUnregisterFdsPayload));
+  unregister_pl->identity = MESSAGE_UNREGISTER_FDS;
+  unregister_pl->n_ids = MIN (registry->released->len, GST_MAX_UNREGISTER_FDS);
+
+  for (idx = 0; idx < (guint) unregister_pl->n_ids; idx++)
+    unregister_pl->buf_id[idx] = g_array_index (registry->released, gint, idx);
+
+  // Remaining IDs will be sent together with the next buffers.
+  g_array_remove_range (registry->released, 0, unregister_pl->n_ids);
+
+  g_mutex_unlock (&registry->lock);
+
+  return unregister_pl;
+}
+
+// Place the metadata records into the ring shared with the socket source. The
+// ring FD is appended to the FDs of the first message which uses the ring.
+static gboolean
+gst_socket_fd_registry_put_records (GstSocketFdRegistry * registry,
+    GByteArray * records, GstPayloadInfo * pl_info, gint * fds, gint * n_fds)
+{
+  guint32 position = 0;
+
+  if ((registry->ring == NULL) &&
+      (registry->ring = gst_meta_ring_new (GST_META_RING_SIZE)) == NULL)
+    return FALSE;
+
+  // No space left for the ring FD, announce the ring with a later message.
+  if (!registry->ring_shared && (*n_fds >= GST_MAX_MEM_BLOCKS))
+    return FALSE;
+
+  if (!gst_meta_ring_write (registry->ring, records->data, records->len,
+          &position))
+    return FALSE;
+
+  pl_info->meta_records = g_malloc (sizeof (GstMetaRecordsPayload));
+  pl_info->meta_records->identity = MESSAGE_META_RECORDS;
+  pl_info->meta_records->position = position;
+  pl_info->meta_records->size = records->len;
+
+  if (!registry->ring_shared) {
+    pl_info->meta_ring = g_malloc (sizeof (GstMetaRingPayload));
+    pl_info->meta_ring->identity = MESSAGE_META_RING;
+    pl_info->meta_ring->size = registry->ring->size;
+
+    fds[(*n_fds)++] = registry->ring->fd;
+  }
+
+  return TRUE;
+}
+
+static void
+gst_socket_fd_registry_records_sent (GstSocketFdRegistry * registry,
+    GstPayloadInfo * pl_info, gboolean success)
+{
+  if (pl_info->meta_records == NULL)
+    return;
+
+  if (success && (pl_info->meta_ring != NULL))
+    registry->ring_shared = TRUE;
+  else if (!success)
+    gst_meta_ring_rewind (registry->ring, pl_info->meta_records->position);
+}
+
 static gboolean
 gst_socket_sink_set_location (GstFdSocketSink * sink, const gchar * location)
 {
@@ -117,6 +320,9 @@ gst_socket_sink_set_property (GObject * object, guint prop_id,
     case PROP_SOCKET:
       gst_socket_sink_set_location (sink, g_value_get_string (value));
       break;
+    case PROP_LISTEN:
+      sink->listen = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -135,6 +341,9 @@ gst_socket_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_SOCKET:
       g_value_set_string (value, sink->sockfile);
       break;
+    case PROP_LISTEN:
+      g_value_set_boolean (value, sink->listen);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -182,6 +391,44 @@ gst_socket_sink_try_connect (GstFdSocketSink * sink)
   return TRUE;
 }
 
+// The same memory block may be sent again while it is still held by the
+// socket source (e.g. non-pool memory). Its first buffer keeps the memory
+// alive, so only the send is counted instead of replacing that buffer.
+static inline void
+gst_socket_sink_hold_buffer (GHashTable * bufmap, GHashTable * bufrefs,
+    gint id, GstBuffer * buffer)
+{
+  gpointer key = GINT_TO_POINTER (id);
+  guint refs = 0;
+
+  if (g_hash_table_lookup (bufmap, key) == NULL) {
+    g_hash_table_insert (bufmap, key, gst_buffer_ref (buffer));
+    return;
+  }
+
+  refs = GPOINTER_TO_UINT (g_hash_table_lookup (bufrefs, key));
+  g_hash_table_insert (bufrefs, key, GUINT_TO_POINTER (refs + 1));
+}
+
+// Returns TRUE if an additional send of the buffer ID was released, in which
+// case the held buffer is still in use by the socket source.
+static inline gboolean
+gst_socket_sink_release_counted (GHashTable * bufrefs, gint id)
+{
+  gpointer key = GINT_TO_POINTER (id);
+  guint refs = GPOINTER_TO_UINT (g_hash_table_lookup (bufrefs, key));
+
+  if (refs == 0)
+    return FALSE;
+
+  if (refs > 1)
+    g_hash_table_insert (bufrefs, key, GUINT_TO_POINTER (refs - 1));
+  else
+    g_hash_table_remove (bufrefs, key);
+
+  return TRUE;
+}
+
 static void
 gst_socket_deinitialize_for_buffers (GstFdSocketSink * sink)
 {
@@ -207,6 +454,7 @@ gst_socket_deinitialize_for_buffers (GstFdSocketSink * sink)
   }
 
   g_list_free (keys_list);
+  g_hash_table_remove_all (sink->bufrefs);
   g_mutex_unlock (&sink->bufmaplock);
 }
 
@@ -428,32 +676,74 @@ gst_socket_serialize_lm_meta (GstVideoLandmarksMeta *lm_meta)
   return lm_meta_pl;
 }
 
+static void
+gst_socket_sink_serialize_video_metas (GstBuffer * buffer,
+    GstPayloadInfo * pl_info)
+{
+  GstMeta *meta = NULL;
+  gpointer state = NULL;
+
+  // Metas are serialized only once per buffer.
+  if (pl_info->roi_meta_info != NULL)
+    return;
+
+  pl_info->roi_meta_info = g_ptr_array_new_with_free_func (g_free);
+  pl_info->class_meta_info = g_ptr_array_new_with_free_func (g_free);
+  pl_info->lm_meta_info = g_ptr_array_new_with_free_func (g_free);
+
+  while ((meta = gst_buffer_iterate_meta (buffer, &state))) {
+    if (meta->info->api == GST_VIDEO_REGION_OF_INTEREST_META_API_TYPE) {
+      GstVideoRegionOfInterestMeta *roi_meta =
+          GST_VIDEO_ROI_META_CAST (meta);
+      GstVideoRoiMetaPayload *roi_meta_pl =
+          gst_socket_serialize_roi_meta (roi_meta);
+      g_ptr_array_add (pl_info->roi_meta_info, roi_meta_pl);
+    }
+    else if (meta->info->api == GST_VIDEO_CLASSIFICATION_META_API_TYPE) {
+      GstVideoClassificationMeta *class_meta =
+          GST_VIDEO_CLASSIFICATION_META_CAST (meta);
+      GstVideoClassMetaPayload *class_meta_pl =
+          gst_socket_serialize_class_meta (class_meta);
+      g_ptr_array_add (pl_info->class_meta_info, class_meta_pl);
+    }
+    else if (meta->info->api == GST_VIDEO_LANDMARKS_META_API_TYPE) {
+      GstVideoLandmarksMeta *lm_meta =
+          GST_VIDEO_LANDMARKS_META_CAST (meta);
+      GstVideoLmMetaPayload *lm_meta_pl =
+          gst_socket_serialize_lm_meta (lm_meta);
+      g_ptr_array_add (pl_info->lm_meta_info, lm_meta_pl);
+    }
+  }
+}
+
+// Text which does not fit into the text payload requires version 4.
+static guint
+gst_socket_sink_required_version (GstPayloadInfo * pl_info)
+{
+  if (pl_info->mem_block_info == NULL)
+    return 1;
+
+  for (guint idx = 0; idx < pl_info->mem_block_info->len; idx++) {
+    gpointer payload = g_ptr_array_index (pl_info->mem_block_info, idx);
+
+    if (GST_SOCKET_MSG_IDENTITY (payload) == MESSAGE_DATA)
+      return 4;
+  }
+
+  return 1;
+}
+
 static GstFlowReturn
-gst_socket_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
+gst_socket_sink_serialize_buffer (GstFdSocketSink * sink, GstBuffer * buffer,
+    GstPayloadInfo * pl_info, gint * memory_fds, GByteArray * records)
 {
-  GstFdSocketSink *sink = GST_SOCKET_SINK (bsink);
   GstBufferPayload * buffer_pl = NULL;
   GstMemory *memory = NULL;
   GstMeta *meta = NULL;
   gpointer state = NULL;
-  GstPayloadInfo pl_info = {0};
-  gint memory_fds[GST_MAX_MEM_BLOCKS]; // todo expand
-  gint memory_fds_send[GST_MAX_MEM_BLOCKS]; // todo expand
   guint n_memory = 0;
-  gint n_memory_send = 0;
 
-  GST_DEBUG_OBJECT (sink, "gst_socket_sink_render %d", sink->mode);
-
-  g_mutex_lock (&sink->socklock);
-  if (!g_atomic_int_get (&sink->connected) ||
-       g_atomic_int_get (&sink->should_disconnect) ||
-       g_atomic_int_get (&sink->should_stop)) {
-    g_mutex_unlock (&sink->socklock);
-    return GST_FLOW_OK;
-  }
-  g_mutex_unlock (&sink->socklock);
-
-  pl_info.protection_metadata_info = g_ptr_array_new_full (
+  pl_info->protection_metadata_info = g_ptr_array_new_full (
       gst_socket_sink_get_protection_meta_count (buffer), g_free);
 
   while ((meta = gst_buffer_iterate_meta_filtered (buffer, &state,
@@ -472,7 +762,7 @@ gst_socket_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
 
     if (sizeof (pmeta_pl->contents) < size) {
         GST_ERROR_OBJECT (sink, "Got too much data");
-        free_pl_struct (&pl_info);
+        free_pl_struct (pl_info);
         return GST_FLOW_ERROR;
     }
 
@@ -480,7 +770,7 @@ gst_socket_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
 
     pmeta_pl->size = size;
     pmeta_pl->maxsize = sizeof (pmeta_pl->contents);
-    g_ptr_array_add (pl_info.protection_metadata_info, pmeta_pl);
+    g_ptr_array_add (pl_info->protection_metadata_info, pmeta_pl);
   }
 
   n_memory = gst_buffer_n_memory (buffer);
@@ -491,14 +781,14 @@ gst_socket_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
 
   buffer_pl = g_malloc (sizeof (GstBufferPayload));
 
-  pl_info.mem_block_info =
+  pl_info->mem_block_info =
       g_ptr_array_new_full (GST_EXPECTED_MEM_BLOCKS(sink), g_free);
   buffer_pl->identity = MESSAGE_BUFFER_INFO;
   buffer_pl->pts = GST_BUFFER_PTS (buffer);
   buffer_pl->dts = GST_BUFFER_DTS (buffer);
   buffer_pl->duration = GST_BUFFER_DURATION (buffer);
   buffer_pl->use_buffer_pool = buffer->pool != NULL;
-  pl_info.buffer_info = buffer_pl;
+  pl_info->buffer_info = buffer_pl;
 
   //From here needs batching logic
   for (guint i = 0; i < n_memory; i++) {
@@ -510,19 +800,14 @@ gst_socket_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
     size = memory->size;
     maxsize = memory->maxsize;
 
-    if (sink->mode == DATA_MODE_TEXT) {
+    if ((sink->mode == DATA_MODE_TEXT) &&
+        (size <= sizeof (((GstTextPayload *) NULL)->contents))) {
       GstTextPayload * text_pl = NULL;
       GstMapInfo map_info;
 
       *(buffer_pl->buf_id) = -1;
       buffer_pl->use_buffer_pool = 0;
 
-      if (sizeof (text_pl->contents) < size) {
-        GST_ERROR ("Got too much text from memory block");
-        free_pl_struct (&pl_info);
-        return GST_FLOW_ERROR;
-      }
-
       text_pl = g_malloc (sizeof (GstTextPayload));
 
       text_pl->identity = MESSAGE_TEXT;
@@ -533,9 +818,34 @@ gst_socket_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
 
       text_pl->size = size;
       text_pl->maxsize = maxsize;
-      g_ptr_array_add (pl_info.mem_block_info, text_pl);
+      g_ptr_array_add (pl_info->mem_block_info, text_pl);
+    } else if (sink->mode == DATA_MODE_TEXT) {
+      GstDataPayload * data_pl = NULL;
+      GstMapInfo map_info;
+
+      *(buffer_pl->buf_id) = -1;
+      buffer_pl->use_buffer_pool = 0;
+
+      // Larger text, e.g. the ML metadata records of many detections, is sent
+      // with its actual size to socket sources supporting version 4.
+      if (size > (G_MAXINT - sizeof (GstDataPayload))) {
+        GST_ERROR_OBJECT (sink, "Got too much text from memory block");
+        free_pl_struct (pl_info);
+        return GST_FLOW_ERROR;
+      }
+
+      data_pl = g_malloc (sizeof (GstDataPayload) + size);
+
+      data_pl->identity = MESSAGE_DATA;
+
+      gst_memory_map (memory, &map_info, GST_MAP_READ);
+      memmove (data_pl->contents, map_info.data, map_info.size);
+      gst_memory_unmap (memory, &map_info);
+
+      data_pl->size = size;
+      g_ptr_array_add (pl_info->mem_block_info, data_pl);
     } else if (!gst_is_fd_memory (memory)) {
-      free_pl_struct (&pl_info);
+      free_pl_struct (pl_info);
       GST_ERROR_OBJECT (sink, "Memory allocator is not fd");
       return GST_FLOW_ERROR;
     }
@@ -567,12 +877,11 @@ gst_socket_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
 
       tensor_pl->size = size;
       tensor_pl->maxsize = maxsize;
-      g_ptr_array_add (pl_info.mem_block_info, tensor_pl);
+      g_ptr_array_add (pl_info->mem_block_info, tensor_pl);
     }
 
     if (sink->mode == DATA_MODE_VIDEO) {
       GstFramePayload * frame_pl = NULL;
-      GstMeta *meta_i = NULL;
 
       memory_fds[i] = gst_fd_memory_get_fd (memory);
       buffer_pl->buf_id[i] = memory_fds[i];
@@ -599,35 +908,7 @@ gst_socket_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
 
       frame_pl->size = size;
       frame_pl->maxsize = maxsize;
-      g_ptr_array_add (pl_info.mem_block_info, frame_pl);
-
-      pl_info.roi_meta_info = g_ptr_array_new ();
-      pl_info.class_meta_info = g_ptr_array_new ();
-      pl_info.lm_meta_info = g_ptr_array_new ();
-
-      while ((meta_i = gst_buffer_iterate_meta (buffer, &state))) {
-        if (meta_i->info->api == GST_VIDEO_REGION_OF_INTEREST_META_API_TYPE) {
-          GstVideoRegionOfInterestMeta *roi_meta =
-              GST_VIDEO_ROI_META_CAST (meta_i);
-          GstVideoRoiMetaPayload *roi_meta_pl =
-              gst_socket_serialize_roi_meta (roi_meta);
-          g_ptr_array_add (pl_info.roi_meta_info, roi_meta_pl);
-        }
-        else if (meta_i->info->api == GST_VIDEO_CLASSIFICATION_META_API_TYPE) {
-          GstVideoClassificationMeta *class_meta =
-              GST_VIDEO_CLASSIFICATION_META_CAST (meta_i);
-          GstVideoClassMetaPayload *class_meta_pl =
-              gst_socket_serialize_class_meta (class_meta);
-          g_ptr_array_add (pl_info.class_meta_info, class_meta_pl);
-        }
-        else if (meta_i->info->api == GST_VIDEO_LANDMARKS_META_API_TYPE) {
-          GstVideoLandmarksMeta *lm_meta =
-              GST_VIDEO_LANDMARKS_META_CAST (meta_i);
-          GstVideoLmMetaPayload *lm_meta_pl =
-              gst_socket_serialize_lm_meta (lm_meta);
-          g_ptr_array_add (pl_info.lm_meta_info, lm_meta_pl);
-        }
-      }
+      g_ptr_array_add (pl_info->mem_block_info, frame_pl);
     }
 
     if (sink->mode != DATA_MODE_TEXT &&
@@ -636,23 +917,113 @@ gst_socket_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
       GST_ERROR_OBJECT (sink, "Unsupported mode: %d", sink->mode);
       return GST_FLOW_ERROR;
     }
+  }
+
+  // Metas belong to the buffer and are sent once, not with each memory block.
+  // Version 3 socket sources receive them as metadata ring records.
+  if ((sink->mode == DATA_MODE_VIDEO) && (records != NULL))
+    gst_meta_records_serialize (buffer, records);
+  else if (sink->mode == DATA_MODE_VIDEO)
+    gst_socket_sink_serialize_video_metas (buffer, pl_info);
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_socket_sink_send_buffer (GstFdSocketSink * sink, GstBuffer * buffer,
+    guint version, GstSocketFdRegistry * registry)
+{
+  GstBufferPayload * buffer_pl = NULL;
+  GstMemory *memory = NULL;
+  GstPayloadInfo pl_info = {0};
+  gint memory_fds[GST_MAX_MEM_BLOCKS]; // todo expand
+  gint memory_fds_send[GST_MAX_MEM_BLOCKS]; // todo expand
+  gint register_ids[GST_MAX_MEM_BLOCKS];
+  GByteArray *records = NULL;
+  guint n_memory = 0;
+  gint n_memory_send = 0, n_register = 0;
+  gboolean success = FALSE;
+
+  // Video metas are placed in the metadata ring starting with version 3.
+  if ((version >= 3) && (sink->mode == DATA_MODE_VIDEO)) {
+    records = sink->records;
+    g_byte_array_set_size (records, 0);
+  }
+
+  if (gst_socket_sink_serialize_buffer (sink, buffer, &pl_info,
+          memory_fds, records) != GST_FLOW_OK) {
+    free_pl_struct (&pl_info);
+    return GST_FLOW_ERROR;
+  }
+
+  if (gst_socket_sink_required_version (&pl_info) > version) {
+    GST_ERROR_OBJECT (sink, "Text too large for socket source protocol "
+        "version %u!", version);
+    free_pl_struct (&pl_info);
+    return GST_FLOW_ERROR;
+  }
+
+  buffer_pl = pl_info.buffer_info;
+  n_memory = (sink->mode != DATA_MODE_TEXT) ? gst_buffer_n_memory (buffer) : 0;
+
+  for (guint i = 0; i < n_memory; i++) {
+    memory = gst_buffer_peek_memory (buffer, i);
 
-    if (sink->mode != DATA_MODE_TEXT) {
+    if (sink->mode != DATA_MODE_TEXT && version >= 2) {
+      gboolean registered = FALSE;
+
+      // FD is passed only with the first buffer containing this memory block,
+      // afterwards the memory block is referred to only by its buffer ID.
+      buffer_pl->buf_id[i] = gst_socket_fd_registry_get_id (registry,
+          sink->fdquark, memory, &registered);
+
+      if (registered) {
+        register_ids[n_register++] = buffer_pl->buf_id[i];
+        memory_fds_send[n_memory_send++] = memory_fds[i];
+      }
+
+      g_mutex_lock (&sink->bufmaplock);
+      gst_socket_sink_hold_buffer (sink->bufmap, sink->bufrefs,
+          buffer_pl->buf_id[i], buffer);
+      sink->bufcount++;
+      g_mutex_unlock (&sink->bufmaplock);
+    } else if (sink->mode != DATA_MODE_TEXT) {
       g_mutex_lock (&sink->bufmaplock);
       if (!buffer->pool ||
           !g_hash_table_contains (sink->bufmap, GINT_TO_POINTER (memory_fds[i]))) {
         memory_fds_send[n_memory_send++] = memory_fds[i];
-        g_hash_table_insert (sink->bufmap, GINT_TO_POINTER (memory_fds[i]), buffer);
-      } else {
-        g_hash_table_insert (sink->bufmap, GINT_TO_POINTER (memory_fds[i]), buffer);
       }
+      gst_socket_sink_hold_buffer (sink->bufmap, sink->bufrefs,
+          memory_fds[i], buffer);
       sink->bufcount++;
       g_mutex_unlock (&sink->bufmaplock);
+    }
+  }
+
+  if (version >= 2) {
+    pl_info.header = g_malloc (sizeof (GstVersionPayload));
+    pl_info.header->identity = MESSAGE_HEADER;
+    pl_info.header->version = version;
+
+    if (n_register > 0) {
+      pl_info.register_fds = g_malloc0 (sizeof (GstRegisterFdsPayload));
+      pl_info.register_fds->identity = MESSAGE_REGISTER_FDS;
+      pl_info.register_fds->n_ids = n_register;
 
-      gst_buffer_ref (buffer);
+      for (gint i = 0; i < n_register; i++)
+        pl_info.register_fds->buf_id[i] = register_ids[i];
     }
+
+    // Piggyback the IDs of freed memory blocks on this buffer.
+    pl_info.unregister_fds = gst_socket_fd_registry_take_released (registry);
   }
 
+  // Fall back to the fixed size payloads while the ring is full.
+  if ((records != NULL) && (records->len > 0) &&
+      !gst_socket_fd_registry_put_records (registry, records, &pl_info,
+          memory_fds_send, &n_memory_send))
+    gst_socket_sink_serialize_video_metas (buffer, &pl_info);
+
   if (n_memory_send > 0) {
     pl_info.fd_count = g_malloc (sizeof (GstFdCountPayload));
     pl_info.fd_count->identity = MESSAGE_FD_COUNT;
@@ -665,7 +1036,10 @@ gst_socket_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
     pl_info.fds = memory_fds_send;
   }
 
-  if (send_socket_message (sink->socket, &pl_info) < 0) {
+  success = (send_socket_message (sink->socket, &pl_info) >= 0);
+  gst_socket_fd_registry_records_sent (registry, &pl_info, success);
+
+  if (!success) {
     if (sink->mode == DATA_MODE_TEXT) {
       GST_ERROR_OBJECT (sink, "Send text message failed! %d", errno);
     } else {
@@ -685,6 +1059,333 @@ gst_socket_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
   return GST_FLOW_OK;
 }
 
+static GstSocketSinkClient *
+gst_socket_sink_client_new (GstFdSocketSink * sink, gint socket)
+{
+  GstSocketSinkClient *client = NULL;
+  guint slot = 0;
+
+  while ((slot < GST_SOCKET_SINK_MAX_CLIENTS) &&
+      (sink->clientslots & (1U << slot)))
+    slot++;
+
+  if (slot == GST_SOCKET_SINK_MAX_CLIENTS)
+    return NULL;
+
+  sink->clientslots |= (1U << slot);
+
+  client = g_slice_new0 (GstSocketSinkClient);
+
+  client->socket = socket;
+  client->slot = slot;
+  client->ready = FALSE;
+  client->version = GST_SOCKET_PROTOCOL_VERSION;
+  client->registry = gst_socket_fd_registry_new ();
+  client->bufmap = g_hash_table_new (NULL, NULL);
+  client->bufrefs = g_hash_table_new (NULL, NULL);
+  client->queue_depth = 0;
+  client->policy = GST_SOCKET_DROP_NEW;
+
+  g_mutex_init (&client->lock);
+
+  return client;
+}
+
+static void
+gst_socket_sink_client_free (GstFdSocketSink * sink,
+    GstSocketSinkClient * client)
+{
+  GHashTableIter iter;
+  gpointer value = NULL;
+
+  GST_INFO_OBJECT (sink, "Remove client %d, dropped buffers: %" G_GUINT64_FORMAT,
+      client->socket, client->n_dropped);
+
+  // Buffers still held by the socket source can go back to their pool.
+  g_hash_table_iter_init (&iter, client->bufmap);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    gst_buffer_unref (GST_BUFFER (value));
+
+  g_hash_table_destroy (client->bufrefs);
+  g_hash_table_destroy (client->bufmap);
+  gst_clear_buffer (&client->pending);
+  gst_socket_fd_registry_unref (client->registry);
+
+  shutdown (client->socket, SHUT_RDWR);
+  close (client->socket);
+
+  sink->clientslots &= ~(1U << client->slot);
+
+  g_mutex_clear (&client->lock);
+  g_slice_free (GstSocketSinkClient, client);
+}
+
+// Must be called with the client lock held.
+static gboolean
+gst_socket_sink_client_send (GstFdSocketSink * sink,
+    GstSocketSinkClient * client, GstBuffer * buffer,
+    GstPayloadInfo * pl_info, gint * memory_fds, GByteArray * records)
+{
+  GstBufferPayload *buffer_pl = pl_info->buffer_info;
+  GQuark quark = sink->clientquarks[client->slot];
+  GstMemory *memory = NULL;
+  GPtrArray *roi_meta_info = NULL, *class_meta_info = NULL;
+  GPtrArray *lm_meta_info = NULL;
+  gint memory_fds_send[GST_MAX_MEM_BLOCKS];
+  gint register_ids[GST_MAX_MEM_BLOCKS];
+  gboolean registered[GST_MAX_MEM_BLOCKS] = { FALSE, };
+  guint idx = 0, n_memory = 0;
+  gint n_memory_send = 0, n_register = 0;
+  gboolean success = FALSE, use_records = FALSE;
+
+  if (gst_socket_sink_required_version (pl_info) > client->version) {
+    GST_WARNING_OBJECT (sink, "Text too large for client %d protocol "
+        "version %u", client->socket, client->version);
+    return FALSE;
+  }
+
+  n_memory = (sink->mode != DATA_MODE_TEXT) ? gst_buffer_n_memory (buffer) : 0;
+
+  // Each client has its own buffer IDs, FDs are passed only once per client.
+  for (idx = 0; idx < n_memory; idx++) {
+    memory = gst_buffer_peek_memory (buffer, idx);
+
+    buffer_pl->buf_id[idx] = gst_socket_fd_registry_get_id (client->registry,
+        quark, memory, &registered[idx]);
+
+    if (registered[idx]) {
+      register_ids[n_register++] = buffer_pl->buf_id[idx];
+      memory_fds_send[n_memory_send++] = memory_fds[idx];
+    }
+  }
+
+  pl_info->header = g_malloc (sizeof (GstVersionPayload));
+  pl_info->header->identity = MESSAGE_HEADER;
+  pl_info->header->version = client->version;
+
+  if (n_register > 0) {
+    pl_info->register_fds = g_malloc0 (sizeof (GstRegisterFdsPayload));
+    pl_info->register_fds->identity = MESSAGE_REGISTER_FDS;
+    pl_info->register_fds->n_ids = n_register;
+
+    for (gint i = 0; i < n_register; i++)
+      pl_info->register_fds->buf_id[i] = register_ids[i];
+  }
+
+  if ((records != NULL) && (records->len > 0)) {
+    use_records = (client->version >= 3) &&
+        gst_socket_fd_registry_put_records (client->registry, records,
+            pl_info, memory_fds_send, &n_memory_send);
+
+    // Older clients and full rings share the fixed size payloads, which are
+    // built once for the first client needing them.
+    if (!use_records && (pl_info->roi_meta_info == NULL))
+      gst_socket_sink_serialize_video_metas (buffer, pl_info);
+  }
+
+  // Metas are already in the ring, do not send them a second time.
+  if (use_records) {
+    roi_meta_info = g_steal_pointer (&pl_info->roi_meta_info);
+    class_meta_info = g_steal_pointer (&pl_info->class_meta_info);
+    lm_meta_info = g_steal_pointer (&pl_info->lm_meta_info);
+  }
+
+  if (n_memory_send > 0) {
+    pl_info->fd_count = g_malloc (sizeof (GstFdCountPayload));
+    pl_info->fd_count->identity = MESSAGE_FD_COUNT;
+    pl_info->fd_count->n_fds = n_memory_send;
+  }
+
+  pl_info->unregister_fds =
+      gst_socket_fd_registry_take_released (client->registry);
+  pl_info->fds = (sink->mode != DATA_MODE_TEXT) ? memory_fds_send : NULL;
+
+  // Client socket is non-blocking, a full socket queue fails immediately.
+  success = (send_socket_message (client->socket, pl_info) >= 0);
+  gst_socket_fd_registry_records_sent (client->registry, pl_info, success);
+
+  if (use_records) {
+    pl_info->roi_meta_info = roi_meta_info;
+    pl_info->class_meta_info = class_meta_info;
+    pl_info->lm_meta_info = lm_meta_info;
+  }
+
+  if (success) {
+    for (idx = 0; idx < n_memory; idx++)
+      gst_socket_sink_hold_buffer (client->bufmap, client->bufrefs,
+          buffer_pl->buf_id[idx], buffer);
+
+    if (n_memory > 0)
+      client->n_buffers++;
+  } else {
+    // The FDs never reached the socket source, register them again next time.
+    for (idx = 0; idx < n_memory; idx++) {
+      if (registered[idx])
+        gst_mini_object_set_qdata (
+            GST_MINI_OBJECT (gst_buffer_peek_memory (buffer, idx)), quark,
+            NULL, NULL);
+    }
+
+    // Unregistered IDs are sent together with one of the next buffers.
+    if (pl_info->unregister_fds != NULL) {
+      g_mutex_lock (&client->registry->lock);
+      g_array_prepend_vals (client->registry->released,
+          pl_info->unregister_fds->buf_id, pl_info->unregister_fds->n_ids);
+      g_mutex_unlock (&client->registry->lock);
+    }
+  }
+
+  // Payload is shared by all clients, remove the per client parts.
+  g_clear_pointer (&pl_info->header, g_free);
+  g_clear_pointer (&pl_info->fd_count, g_free);
+  g_clear_pointer (&pl_info->register_fds, g_free);
+  g_clear_pointer (&pl_info->unregister_fds, g_free);
+  g_clear_pointer (&pl_info->meta_ring, g_free);
+  g_clear_pointer (&pl_info->meta_records, g_free);
+  pl_info->fds = NULL;
+
+  return success;
+}
+
+static void
+gst_socket_sink_client_deliver (GstFdSocketSink * sink,
+    GstSocketSinkClient * client, GstBuffer * buffer,
+    GstPayloadInfo * pl_info, gint * memory_fds, GByteArray * records)
+{
+  g_mutex_lock (&client->lock);
+
+  if (!client->ready) {
+    g_mutex_unlock (&client->lock);
+    return;
+  }
+
+  if ((client->queue_depth != 0) && (client->n_buffers >= client->queue_depth)) {
+    // Buffers already held by the socket source cannot be taken back, so only
+    // the latest buffer is kept until the socket source returns one.
+    if (client->policy == GST_SOCKET_DROP_OLD) {
+      if (client->pending != NULL)
+        client->n_dropped++;
+
+      gst_buffer_replace (&client->pending, buffer);
+    } else {
+      client->n_dropped++;
+    }
+  } else if (!gst_socket_sink_client_send (sink, client, buffer, pl_info,
+      memory_fds, records)) {
+    GST_LOG_OBJECT (sink, "Dropped buffer for client %d, errno: %d",
+        client->socket, errno);
+    client->n_dropped++;
+  }
+
+  g_mutex_unlock (&client->lock);
+}
+
+// Must be called with the client lock held.
+static void
+gst_socket_sink_client_send_pending (GstFdSocketSink * sink,
+    GstSocketSinkClient * client)
+{
+  GstPayloadInfo pl_info = {0};
+  GstBuffer *buffer = NULL;
+  GByteArray *records = NULL;
+  gint memory_fds[GST_MAX_MEM_BLOCKS];
+
+  if (client->pending == NULL)
+    return;
+
+  if ((client->queue_depth != 0) && (client->n_buffers >= client->queue_depth))
+    return;
+
+  buffer = client->pending;
+  client->pending = NULL;
+
+  // Called from the server thread, sink->records belongs to the render thread.
+  if ((client->version >= 3) && (sink->mode == DATA_MODE_VIDEO))
+    records = g_byte_array_new ();
+
+  if ((gst_socket_sink_serialize_buffer (sink, buffer, &pl_info,
+          memory_fds, records) != GST_FLOW_OK) ||
+      !gst_socket_sink_client_send (sink, client, buffer, &pl_info,
+          memory_fds, records))
+    client->n_dropped++;
+
+  if (records != NULL)
+    g_byte_array_unref (records);
+
+  free_pl_struct (&pl_info);
+  gst_buffer_unref (buffer);
+}
+
+static GstFlowReturn
+gst_socket_sink_fan_out_buffer (GstFdSocketSink * sink, GstBuffer * buffer)
+{
+  GstPayloadInfo pl_info = {0};
+  GByteArray *records = NULL;
+  gint memory_fds[GST_MAX_MEM_BLOCKS];
+  GList *list = NULL;
+
+  g_mutex_lock (&sink->clientslock);
+
+  if (sink->clients == NULL) {
+    g_mutex_unlock (&sink->clientslock);
+    return GST_FLOW_OK;
+  }
+
+  if (sink->mode == DATA_MODE_VIDEO) {
+    records = sink->records;
+    g_byte_array_set_size (records, 0);
+  }
+
+  // Serialize only once, clients differ only by their buffer IDs.
+  if (gst_socket_sink_serialize_buffer (sink, buffer, &pl_info,
+          memory_fds, records) != GST_FLOW_OK) {
+    g_mutex_unlock (&sink->clientslock);
+    free_pl_struct (&pl_info);
+    return GST_FLOW_ERROR;
+  }
+
+  for (list = sink->clients; list != NULL; list = list->next)
+    gst_socket_sink_client_deliver (sink, list->data, buffer, &pl_info,
+        memory_fds, records);
+
+  g_mutex_unlock (&sink->clientslock);
+
+  free_pl_struct (&pl_info);
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_socket_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
+{
+  GstFdSocketSink *sink = GST_SOCKET_SINK (bsink);
+  GstSocketFdRegistry *registry = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint version = 0;
+
+  GST_DEBUG_OBJECT (sink, "gst_socket_sink_render %d", sink->mode);
+
+  if (sink->listen)
+    return gst_socket_sink_fan_out_buffer (sink, buffer);
+
+  g_mutex_lock (&sink->socklock);
+  if (!g_atomic_int_get (&sink->connected) ||
+       g_atomic_int_get (&sink->should_disconnect) ||
+       g_atomic_int_get (&sink->should_stop)) {
+    g_mutex_unlock (&sink->socklock);
+    return GST_FLOW_OK;
+  }
+
+  // The registry is replaced on reconnect, keep a reference while sending.
+  version = sink->version;
+  registry = g_atomic_rc_box_acquire (sink->registry);
+  g_mutex_unlock (&sink->socklock);
+
+  ret = gst_socket_sink_send_buffer (sink, buffer, version, registry);
+
+  gst_socket_fd_registry_unref (registry);
+  return ret;
+}
+
 static gpointer
 gst_socket_sink_wait_message_loop (gpointer user_data)
 {
@@ -767,6 +1468,17 @@ gst_socket_sink_wait_message_loop (gpointer user_data)
           break;
         }
 
+        if (pl_info.hello != NULL) {
+          g_mutex_lock (&sink->socklock);
+          sink->version =
+              MIN (pl_info.hello->version, GST_SOCKET_PROTOCOL_VERSION);
+          g_mutex_unlock (&sink->socklock);
+
+          GST_INFO_OBJECT (sink, "Using protocol version %u", sink->version);
+          free_pl_struct (&pl_info);
+          break;
+        }
+
         if (GST_PL_INFO_IS_MESSAGE (&pl_info, MESSAGE_DISCONNECT)) {
           GST_DEBUG_OBJECT (sink, "MESSAGE_DISCONNECT");
           g_atomic_int_set (&sink->should_disconnect, TRUE);
@@ -794,11 +1506,21 @@ gst_socket_sink_wait_message_loop (gpointer user_data)
             gint buf_id = pl_info.return_buffer->buf_id[i];
 
             g_mutex_lock (&sink->bufmaplock);
-            buffer = g_hash_table_lookup (sink->bufmap, GINT_TO_POINTER (buf_id));
-            g_hash_table_insert (sink->bufmap, GINT_TO_POINTER (buf_id), NULL);
+
+            if (gst_socket_sink_release_counted (sink->bufrefs, buf_id)) {
+              buffer = NULL;
+            } else {
+              buffer = g_hash_table_lookup (sink->bufmap,
+                  GINT_TO_POINTER (buf_id));
+              g_hash_table_insert (sink->bufmap, GINT_TO_POINTER (buf_id),
+                  NULL);
+            }
+
             sink->bufcount--;
             g_mutex_unlock (&sink->bufmaplock);
-            gst_buffer_unref (buffer);
+
+            if (buffer != NULL)
+              gst_buffer_unref (buffer);
 
             GST_DEBUG_OBJECT (sink, "Buffer returned %p, buf_id: %d, count: %d",
                 buffer, buf_id, sink->bufcount);
@@ -820,6 +1542,13 @@ gst_socket_sink_wait_message_loop (gpointer user_data)
           unlink (sink->sockfile);
           sink->socket = 0;
         }
+
+        // The next socket source has to announce its protocol version again
+        // and all FDs have to be registered anew.
+        sink->version = 1;
+        gst_socket_fd_registry_unref (sink->registry);
+        sink->registry = gst_socket_fd_registry_new ();
+
         g_mutex_unlock (&sink->socklock);
 
         gst_socket_deinitialize_for_buffers (sink);
@@ -840,6 +1569,208 @@ gst_socket_sink_wait_message_loop (gpointer user_data)
   return NULL;
 }
 
+static gboolean
+gst_socket_sink_listen (GstFdSocketSink * sink)
+{
+  struct sockaddr_un address = {0};
+
+  if ((sink->socket = socket (AF_UNIX, SOCK_SEQPACKET, 0)) < 0) {
+    GST_ERROR_OBJECT (sink, "Socket creation error");
+    return FALSE;
+  }
+
+  unlink (sink->sockfile);
+
+  address.sun_family = AF_UNIX;
+  g_strlcpy (address.sun_path, sink->sockfile, sizeof (address.sun_path));
+
+  if (bind (sink->socket, (struct sockaddr *) &address, sizeof (address)) < 0) {
+    GST_ERROR_OBJECT (sink, "Socket bind failed, errno: %d", errno);
+    close (sink->socket);
+    sink->socket = -1;
+    return FALSE;
+  }
+
+  if (listen (sink->socket, GST_SOCKET_SINK_MAX_CLIENTS) < 0) {
+    GST_ERROR_OBJECT (sink, "Socket listen failed, errno: %d", errno);
+    close (sink->socket);
+    unlink (sink->sockfile);
+    sink->socket = -1;
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (sink, "Listening on %s", sink->sockfile);
+
+  return TRUE;
+}
+
+static void
+gst_socket_sink_accept_client (GstFdSocketSink * sink)
+{
+  GstSocketSinkClient *client = NULL;
+  gint socket = -1;
+
+  if ((socket = accept (sink->socket, NULL, NULL)) < 0) {
+    GST_WARNING_OBJECT (sink, "Socket accept failed, errno: %d", errno);
+    return;
+  }
+
+  // A slow socket source must never block the streaming thread.
+  fcntl (socket, F_SETFL, fcntl (socket, F_GETFL) | O_NONBLOCK);
+
+  if ((client = gst_socket_sink_client_new (sink, socket)) == NULL) {
+    GST_WARNING_OBJECT (sink, "Maximum number of clients reached!");
+    close (socket);
+    return;
+  }
+
+  g_mutex_lock (&sink->clientslock);
+  sink->clients = g_list_append (sink->clients, client);
+  g_mutex_unlock (&sink->clientslock);
+
+  GST_INFO_OBJECT (sink, "Client %d connected", socket);
+}
+
+static void
+gst_socket_sink_remove_client (GstFdSocketSink * sink,
+    GstSocketSinkClient * client)
+{
+  g_mutex_lock (&sink->clientslock);
+  sink->clients = g_list_remove (sink->clients, client);
+  g_mutex_unlock (&sink->clientslock);
+
+  gst_socket_sink_client_free (sink, client);
+}
+
+static gboolean
+gst_socket_sink_client_process (GstFdSocketSink * sink,
+    GstSocketSinkClient * client)
+{
+  GstPayloadInfo pl_info = {0};
+  GstBuffer *buffer = NULL;
+  gboolean connected = TRUE, returned = FALSE;
+
+  if (receive_socket_message (client->socket, &pl_info, 0) <= 0) {
+    free_pl_struct (&pl_info);
+    return FALSE;
+  }
+
+  g_mutex_lock (&client->lock);
+
+  if (pl_info.hello != NULL) {
+    client->version = MIN (pl_info.hello->version, GST_SOCKET_PROTOCOL_VERSION);
+
+    if (pl_info.client_config != NULL) {
+      client->queue_depth = pl_info.client_config->queue_depth;
+      client->policy = pl_info.client_config->drop_policy;
+    }
+
+    // Buffer IDs are assigned per client, which requires version 2.
+    if (client->version < 2) {
+      GST_WARNING_OBJECT (sink, "Client %d protocol version %u not supported",
+          client->socket, client->version);
+      connected = FALSE;
+    } else {
+      GST_INFO_OBJECT (sink, "Client %d ready, version: %u, queue depth: %u, "
+          "drop policy: %u", client->socket, client->version,
+          client->queue_depth, client->policy);
+      client->ready = TRUE;
+    }
+  }
+
+  if (GST_PL_INFO_IS_MESSAGE (&pl_info, MESSAGE_DISCONNECT)) {
+    GST_DEBUG_OBJECT (sink, "Client %d MESSAGE_DISCONNECT", client->socket);
+    connected = FALSE;
+  }
+
+  if ((pl_info.return_buffer != NULL) && (pl_info.fd_count != NULL)) {
+    gint n_fds = CLAMP (pl_info.fd_count->n_fds, 0, GST_MAX_MEM_BLOCKS);
+
+    for (gint i = 0; i < n_fds; i++) {
+      gpointer key = GINT_TO_POINTER (pl_info.return_buffer->buf_id[i]);
+
+      if (gst_socket_sink_release_counted (client->bufrefs,
+              pl_info.return_buffer->buf_id[i])) {
+        returned = TRUE;
+        continue;
+      }
+
+      if ((buffer = g_hash_table_lookup (client->bufmap, key)) == NULL)
+        continue;
+
+      g_hash_table_remove (client->bufmap, key);
+      gst_buffer_unref (buffer);
+      returned = TRUE;
+    }
+
+    if (returned && (client->n_buffers > 0))
+      client->n_buffers--;
+
+    if (connected)
+      gst_socket_sink_client_send_pending (sink, client);
+  }
+
+  g_mutex_unlock (&client->lock);
+
+  free_pl_struct (&pl_info);
+  return connected;
+}
+
+static gpointer
+gst_socket_sink_server_loop (gpointer user_data)
+{
+  GstFdSocketSink *sink = GST_SOCKET_SINK (user_data);
+  GstSocketSinkClient *clients[GST_SOCKET_SINK_MAX_CLIENTS];
+  struct pollfd poll_fds[GST_SOCKET_SINK_MAX_CLIENTS + 1];
+  GList *list = NULL;
+  guint idx = 0, n_clients = 0;
+  gint ret = 0;
+
+  while (!g_atomic_int_get (&sink->should_stop)) {
+    poll_fds[0].fd = sink->socket;
+    poll_fds[0].events = POLLIN;
+    poll_fds[0].revents = 0;
+
+    // Clients are added and removed only by this thread.
+    for (list = sink->clients, n_clients = 0; list != NULL; list = list->next) {
+      clients[n_clients] = list->data;
+
+      poll_fds[n_clients + 1].fd = clients[n_clients]->socket;
+      poll_fds[n_clients + 1].events = POLLIN;
+      poll_fds[n_clients + 1].revents = 0;
+
+      n_clients++;
+    }
+
+    ret = poll (poll_fds, n_clients + 1, SERVER_POLL_TIMEOUT_MS);
+    if (ret < 0 && errno != EINTR) {
+      GST_ERROR_OBJECT (sink, "Socket poll error, errno: %d", errno);
+      break;
+    } else if (ret <= 0) {
+      continue;
+    }
+
+    for (idx = 0; idx < n_clients; idx++) {
+      gshort revents = poll_fds[idx + 1].revents;
+
+      if (revents == 0)
+        continue;
+
+      // Remaining messages are processed before a hang up is handled.
+      if ((revents & POLLIN) &&
+          gst_socket_sink_client_process (sink, clients[idx]))
+        continue;
+
+      gst_socket_sink_remove_client (sink, clients[idx]);
+    }
+
+    if (poll_fds[0].revents & POLLIN)
+      gst_socket_sink_accept_client (sink);
+  }
+
+  return NULL;
+}
+
 static gboolean
 gst_socket_sink_start (GstBaseSink * basesink)
 {
@@ -850,24 +1781,38 @@ gst_socket_sink_start (GstBaseSink * basesink)
   g_object_set (G_OBJECT (basesink), "sync", FALSE, NULL);
 
   sink->bufmap = g_hash_table_new (NULL, NULL);
+  sink->bufrefs = g_hash_table_new (NULL, NULL);
   sink->bufcount = 0;
 
   g_mutex_init (&sink->bufmaplock);
   g_mutex_init (&sink->socklock);
   g_mutex_init (&sink->msglock);
+  g_mutex_init (&sink->clientslock);
 
   g_atomic_int_set (&sink->should_stop, FALSE);
   g_atomic_int_set (&sink->should_disconnect, FALSE);
   g_atomic_int_set (&sink->connected, FALSE);
 
+  // Protocol version 1 is used until the socket source announces otherwise.
+  sink->version = 1;
+  sink->registry = gst_socket_fd_registry_new ();
+  sink->records = g_byte_array_new ();
+
   sink->msg_thread = NULL;
 
   sink->state = GST_SOCKET_TRY_CONNECT;
 
+  sink->clients = NULL;
+  sink->clientslots = 0;
+
+  if (sink->listen && !gst_socket_sink_listen (sink))
+    return FALSE;
+
   g_mutex_lock (&sink->msglock);
   if (sink->msg_thread == NULL) {
-    if ((sink->msg_thread = g_thread_new ("Msg thread",
-        gst_socket_sink_wait_message_loop, sink)) == NULL) {
+    if ((sink->msg_thread = g_thread_new ("Msg thread", sink->listen ?
+        gst_socket_sink_server_loop : gst_socket_sink_wait_message_loop,
+        sink)) == NULL) {
       g_mutex_unlock (&sink->msglock);
       return FALSE;
     }
@@ -892,12 +1837,40 @@ gst_socket_sink_stop (GstBaseSink * basesink)
     sink->msg_thread = NULL;
   }
 
+  if (sink->listen) {
+    while (sink->clients != NULL) {
+      gst_socket_sink_client_free (sink, sink->clients->data);
+      sink->clients = g_list_delete_link (sink->clients, sink->clients);
+    }
+
+    if (sink->socket >= 0) {
+      close (sink->socket);
+      unlink (sink->sockfile);
+      sink->socket = -1;
+    }
+  }
+
   if (sink->bufmap) {
     g_hash_table_destroy (sink->bufmap);
   }
 
+  if (sink->bufrefs) {
+    g_hash_table_destroy (sink->bufrefs);
+  }
+
+  if (sink->registry != NULL) {
+    gst_socket_fd_registry_unref (sink->registry);
+    sink->registry = NULL;
+  }
+
+  if (sink->records != NULL) {
+    g_byte_array_unref (sink->records);
+    sink->records = NULL;
+  }
+
   g_mutex_clear (&sink->bufmaplock);
   g_mutex_clear (&sink->socklock);
+  g_mutex_clear (&sink->clientslock);
 
   if (sink->mlinfo != NULL) {
     gst_ml_info_free (sink->mlinfo);
@@ -952,6 +1925,7 @@ gst_socket_sink_event (GstBaseSink *bsink, GstEvent *event)
   GstFdSocketSink *sink = GST_SOCKET_SINK (bsink);
   GstPayloadInfo pl_info = {0};
   GstMessagePayload msg;
+  GstVersionPayload header = { .identity = MESSAGE_HEADER };
 
   GST_DEBUG_OBJECT (sink, "GST EVENT: %d", GST_EVENT_TYPE (event));
 
@@ -959,11 +1933,44 @@ gst_socket_sink_event (GstBaseSink *bsink, GstEvent *event)
     case GST_EVENT_EOS:
       GST_INFO_OBJECT (sink, "EOS event");
 
-      g_atomic_int_set (&sink->should_stop, TRUE);
-
       msg.identity = MESSAGE_EOS;
       pl_info.message = &msg;
 
+      // Clients keep returning buffers after EOS, until the sink is stopped.
+      if (sink->listen) {
+        GList *list = NULL;
+
+        g_mutex_lock (&sink->clientslock);
+
+        for (list = sink->clients; list != NULL; list = list->next) {
+          GstSocketSinkClient *client = list->data;
+
+          g_mutex_lock (&client->lock);
+
+          header.version = client->version;
+          pl_info.header = &header;
+
+          if (client->ready && (send_socket_message (client->socket,
+                  &pl_info) < 0))
+            GST_WARNING_OBJECT (sink, "Unable to send EOS message to client "
+                "%d.", client->socket);
+
+          g_mutex_unlock (&client->lock);
+        }
+
+        g_mutex_unlock (&sink->clientslock);
+        break;
+      }
+
+      g_atomic_int_set (&sink->should_stop, TRUE);
+
+      g_mutex_lock (&sink->socklock);
+      header.version = sink->version;
+      g_mutex_unlock (&sink->socklock);
+
+      if (header.version >= 2)
+        pl_info.header = &header;
+
       if (g_atomic_int_get (&sink->connected) &&
             (send_socket_message (sink->socket, &pl_info) < 0)) {
         GST_WARNING_OBJECT (sink, "Unable to send EOS message.");
@@ -990,10 +1997,31 @@ gst_socket_sink_dispose (GObject * obj)
 static void
 gst_socket_sink_init (GstFdSocketSink * sink)
 {
+  gchar *name = NULL;
+
   sink->msg_thread = NULL;
   sink->socket = -1;
   sink->mode = DATA_MODE_NONE;
 
+  sink->version = 1;
+  sink->registry = NULL;
+
+  sink->listen = DEFAULT_PROP_LISTEN;
+  sink->clients = NULL;
+  sink->clientslots = 0;
+
+  // Memory blocks may be sent by multiple sinks, each with its own registry.
+  name = g_strdup_printf ("GstSocketFdEntry-%p", sink);
+  sink->fdquark = g_quark_from_string (name);
+  g_free (name);
+
+  // In listen mode every client has its own registry.
+  for (guint idx = 0; idx < GST_SOCKET_SINK_MAX_CLIENTS; idx++) {
+    name = g_strdup_printf ("GstSocketFdEntry-%p-%u", sink, idx);
+    sink->clientquarks[idx] = g_quark_from_string (name);
+    g_free (name);
+  }
+
   g_atomic_int_set (&sink->should_stop, FALSE);
 
   GST_DEBUG_CATEGORY_INIT (gst_socket_sink_debug, "qtisocketsink", 0,
@@ -1014,7 +2042,10 @@ gst_socket_sink_set_caps (GstBaseSink * bsink, GstCaps * caps)
 
   if (gst_structure_has_name (structure, "video/x-raw")) {
     sink->mode = DATA_MODE_VIDEO;
-  } else if (gst_structure_has_name (structure, "text/x-raw")) {
+  } else if (gst_structure_has_name (structure, "text/x-raw") ||
+      gst_structure_has_name (structure, GST_ML_META_RECORDS_MEDIA_TYPE)) {
+    // Binary metadata records are transferred as opaque text payload, or as
+    // sized data payload when exceeding it.
     sink->mode = DATA_MODE_TEXT;
   } else if (gst_structure_has_name (structure, "neural-network/tensors")) {
     sink->mode = DATA_MODE_TENSOR;
@@ -1054,6 +2085,13 @@ gst_socket_sink_class_init (GstFdSocketSinkClass * klass)
         "Location of the Unix Domain Socket", NULL,
         G_PARAM_READWRITE |G_PARAM_STATIC_STRINGS |
         GST_PARAM_MUTABLE_READY));
+  g_object_class_install_property (gobject, PROP_LISTEN,
+    g_param_spec_boolean ("listen", "Listen",
+        "Listen on the socket and send each buffer to all connected socket "
+        "sources (started with listen=false) instead of connecting to one",
+        DEFAULT_PROP_LISTEN,
+        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+        GST_PARAM_MUTABLE_READY));
 
   gst_element_class_set_static_metadata (gstelement,
       "QTI Socket Sink Element", "Socket Sink Element",
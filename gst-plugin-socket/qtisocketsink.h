@@ -54,8 +54,13 @@ G_BEGIN_DECLS
   (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_SOCKET_SINK))
 #define GST_SOCKET_SINK_CAST(obj) ((GstFdSocketSink *)(obj))
 
+// Maximum number of socket sources served simultaneously in listen mode.
+#define GST_SOCKET_SINK_MAX_CLIENTS 32
+
 typedef struct _GstFdSocketSink GstFdSocketSink;
 typedef struct _GstFdSocketSinkClass GstFdSocketSinkClass;
+typedef struct _GstSocketFdRegistry GstSocketFdRegistry;
+typedef struct _GstSocketSinkClient GstSocketSinkClient;
 
 typedef enum {
   GST_SOCKET_TRY_CONNECT,
@@ -80,9 +85,31 @@ struct _GstFdSocketSink {
   GMutex socklock;
 
   GHashTable *bufmap;
+  // Number of additional in-flight sends of a buffer ID which is already
+  // held in the bufmap, protected by bufmaplock.
+  GHashTable *bufrefs;
   GMutex      bufmaplock;
   gint        bufcount;
 
+  // Protocol version negotiated with the socket source, protected by socklock.
+  guint                version;
+  // Buffer IDs of the FDs already passed to the socket source (version 2).
+  GstSocketFdRegistry *registry;
+  // Key of the registry entries attached to the memory blocks.
+  GQuark               fdquark;
+  // Video metas encoded as metadata ring records (version 3), render only.
+  GByteArray          *records;
+
+  // Listen for socket sources instead of connecting to a single one.
+  gboolean listen;
+  // Socket sources connected in listen mode, protected by clientslock.
+  GList    *clients;
+  GMutex    clientslock;
+  // Bitmask of the client slots in use, accessed only by the message thread.
+  guint32   clientslots;
+  // Keys of the registry entries attached to the memory blocks, per slot.
+  GQuark    clientquarks[GST_SOCKET_SINK_MAX_CLIENTS];
+
   gint should_stop;
 
   GstMLInfo *mlinfo;
@@ -44,9 +44,15 @@
 #include <gst/video/video-format.h>
 #include <gst/video/video-frame.h>
 #include <gst/utils/common-utils.h>
+#include <gst/ml/ml-meta-records.h>
 
 #define DEFAULT_SOCKET   NULL
 #define DEFAULT_TIMEOUT  1000
+#define DEFAULT_PROP_LISTEN      TRUE
+#define DEFAULT_PROP_QUEUE_DEPTH 0
+#define DEFAULT_PROP_DROP_POLICY GST_SOCKET_DROP_OLD
+
+#define GST_TYPE_SOCKET_SRC_DROP_POLICY (gst_socket_src_drop_policy_get_type())
 
 #define gst_socket_src_parent_class parent_class
 G_DEFINE_TYPE (GstFdSocketSrc, gst_socket_src, GST_TYPE_PUSH_SRC);
@@ -54,7 +60,8 @@ G_DEFINE_TYPE (GstFdSocketSrc, gst_socket_src, GST_TYPE_PUSH_SRC);
 #define GST_SOCKET_SRC_CAPS \
     "neural-network/tensors;" \
     "video/x-raw(ANY);" \
-    "text/x-raw"
+    "text/x-raw;" \
+    GST_ML_META_RECORDS_CAPS
 
 GST_DEBUG_CATEGORY_STATIC (gst_socket_src_debug);
 #define GST_CAT_DEFAULT gst_socket_src_debug
@@ -63,7 +70,10 @@ enum
 {
   PROP_0,
   PROP_SOCKET,
-  PROP_TIMEOUT
+  PROP_TIMEOUT,
+  PROP_LISTEN,
+  PROP_QUEUE_DEPTH,
+  PROP_DROP_POLICY
 };
 
 static GstStaticPadTemplate socket_src_template =
@@ -80,6 +90,28 @@ G_DEFINE_TYPE(GstSocketSrcBufferPool, gst_socketsrc_buffer_pool, GST_TYPE_BUFFER
 // Declare socket_buffer_qdata_quark() to return Quark for SocketSrc buffer data
 static G_DEFINE_QUARK (SocketBufferQDataQuark, socket_buffer_qdata);
 
+static GType
+gst_socket_src_drop_policy_get_type (void)
+{
+  static GType gtype = 0;
+  static const GEnumValue variants[] = {
+    { GST_SOCKET_DROP_NEW,
+        "Drop new buffers while the maximum number of buffers is held",
+        "drop-new"
+    },
+    { GST_SOCKET_DROP_OLD,
+        "Keep only the latest buffer while the maximum number of buffers is "
+        "held and deliver it once a buffer is released", "drop-old"
+    },
+    { 0, NULL, NULL },
+  };
+
+  if (!gtype)
+    gtype = g_enum_register_static ("GstSocketSrcDropPolicy", variants);
+
+  return gtype;
+}
+
 static void
 gst_socketsrc_buffer_pool_reset (GstBufferPool * pool, GstBuffer * buffer)
 {
@@ -181,6 +213,15 @@ gst_socket_src_set_property (GObject * object, guint prop_id,
       GST_DEBUG_OBJECT (src, "Socket poll timeout %" GST_TIME_FORMAT,
           GST_TIME_ARGS (timeout));
       break;
+    case PROP_LISTEN:
+      src->listen = g_value_get_boolean (value);
+      break;
+    case PROP_QUEUE_DEPTH:
+      src->queue_depth = g_value_get_uint (value);
+      break;
+    case PROP_DROP_POLICY:
+      src->drop_policy = g_value_get_enum (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -201,7 +242,10 @@ gst_socket_src_set_caps (GstBaseSrc * bsrc, GstCaps * caps)
 
   if (gst_structure_has_name (structure, "video/x-raw")) {
     src->mode = DATA_MODE_VIDEO;
-  } else if (gst_structure_has_name (structure, "text/x-raw")) {
+  } else if (gst_structure_has_name (structure, "text/x-raw") ||
+      gst_structure_has_name (structure, GST_ML_META_RECORDS_MEDIA_TYPE)) {
+    // Binary metadata records are transferred as opaque text payload, or as
+    // sized data payload when exceeding it.
     src->mode = DATA_MODE_TEXT;
   } else if (gst_structure_has_name (structure, "neural-network/tensors")) {
      src->mode = DATA_MODE_TENSOR;
@@ -235,6 +279,15 @@ gst_socket_src_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_TIMEOUT:
       g_value_set_uint64 (value, src->timeout);
       break;
+    case PROP_LISTEN:
+      g_value_set_boolean (value, src->listen);
+      break;
+    case PROP_QUEUE_DEPTH:
+      g_value_set_uint (value, src->queue_depth);
+      break;
+    case PROP_DROP_POLICY:
+      g_value_set_enum (value, src->drop_policy);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -242,13 +295,59 @@ gst_socket_src_get_property (GObject * object, guint prop_id, GValue * value,
   GST_OBJECT_UNLOCK (src);
 }
 
-static gpointer
-gst_socket_src_connection_handler (gpointer userdata)
+static gboolean
+gst_socket_src_connect (GstFdSocketSrc * src)
 {
-  GstFdSocketSrc *src = GST_SOCKET_SRC (userdata);
+  struct sockaddr_un address = {0};
+  gint sock = -1;
+
+  address.sun_family = AF_UNIX;
+  g_strlcpy (address.sun_path, src->sockfile, sizeof (address.sun_path));
+
+  // Retry until the socket sink listens or the source is stopped.
+  while (TRUE) {
+    if ((sock = socket (AF_UNIX, SOCK_SEQPACKET, 0)) < 0) {
+      GST_ERROR_OBJECT (src, "Socket creation error");
+      g_mutex_lock (&src->mutex);
+      src->stop_thread = TRUE;
+      g_mutex_unlock (&src->mutex);
+      return FALSE;
+    }
+
+    if (connect (sock, (struct sockaddr *) &address, sizeof (address)) == 0)
+      break;
+
+    close (sock);
+
+    g_mutex_lock (&src->mutex);
+    if (src->stop_thread) {
+      g_mutex_unlock (&src->mutex);
+      return FALSE;
+    }
+    g_mutex_unlock (&src->mutex);
+
+    usleep (10000);
+  }
+
+  g_mutex_lock (&src->mutex);
 
+  // Socket release may have already been done while connecting.
+  if (src->stop_thread) {
+    g_mutex_unlock (&src->mutex);
+    close (sock);
+    return FALSE;
+  }
+
+  src->client_sock = sock;
+  g_mutex_unlock (&src->mutex);
+
+  return TRUE;
+}
+
+static gboolean
+gst_socket_src_accept (GstFdSocketSrc * src)
+{
   struct sockaddr_un address = {0};
-  GstBufferPool *pool = NULL;
   gint addrlen = 0;
 
   g_mutex_lock (&src->mutex);
@@ -257,7 +356,7 @@ gst_socket_src_connection_handler (gpointer userdata)
   if (src->socket < 0) {
     GST_ERROR_OBJECT (src, "Socket creation error");
     g_mutex_unlock (&src->mutex);
-    return NULL;
+    return FALSE;
   }
 
   unlink (src->sockfile);
@@ -270,7 +369,7 @@ gst_socket_src_connection_handler (gpointer userdata)
     GST_ERROR_OBJECT (src, "Socket bind failed");
     src->stop_thread = TRUE;
     g_mutex_unlock (&src->mutex);
-    return NULL;
+    return FALSE;
   }
 
   if (listen (src->socket, 3) < 0) {
@@ -279,7 +378,7 @@ gst_socket_src_connection_handler (gpointer userdata)
     src->socket = 0;
     src->stop_thread = TRUE;
     g_mutex_unlock (&src->mutex);
-    return NULL;
+    return FALSE;
   }
 
   GST_DEBUG_OBJECT (src, "Socket accept");
@@ -295,12 +394,53 @@ gst_socket_src_connection_handler (gpointer userdata)
     g_mutex_lock (&src->mutex);
     src->stop_thread = TRUE;
     g_mutex_unlock (&src->mutex);
-    return NULL;
+    return FALSE;
   }
 
+  return TRUE;
+}
+
+static gpointer
+gst_socket_src_connection_handler (gpointer userdata)
+{
+  GstFdSocketSrc *src = GST_SOCKET_SRC (userdata);
+
+  GstBufferPool *pool = NULL;
+  GstPayloadInfo hello_info = {0};
+  GstVersionPayload hello_pl = { .identity = MESSAGE_HELLO };
+  GstVersionPayload header_pl = { .identity = MESSAGE_HEADER };
+  GstClientConfigPayload config_pl = { .identity = MESSAGE_CLIENT_CONFIG };
+
+  if (src->listen && !gst_socket_src_accept (src))
+    return NULL;
+  else if (!src->listen && !gst_socket_src_connect (src))
+    return NULL;
+
   src->fdmap = g_hash_table_new (NULL, NULL);
   g_mutex_init (&src->fdmaplock);
 
+  // Announce the supported protocol version with version 1 framing, which is
+  // understood and otherwise ignored by older socket sinks.
+  src->version = 1;
+  hello_pl.version = GST_SOCKET_PROTOCOL_VERSION;
+  hello_info.hello = &hello_pl;
+
+  // Only a listening socket sink knows the delivery preferences. It supports
+  // version 2 and reads without blocking, so all messages are sent as single
+  // datagrams which cannot be split into a length prefix and a body.
+  if (!src->listen) {
+    src->version = 2;
+    header_pl.version = GST_SOCKET_PROTOCOL_VERSION;
+    hello_info.header = &header_pl;
+
+    config_pl.queue_depth = src->queue_depth;
+    config_pl.drop_policy = src->drop_policy;
+    hello_info.client_config = &config_pl;
+  }
+
+  if (send_socket_message (src->client_sock, &hello_info) < 0)
+    GST_WARNING_OBJECT (src, "Unable to send hello message.");
+
   pool = gst_socketsrc_buffer_pool_new ();
   if (!pool) {
     GST_ERROR_OBJECT (src, "Failed to create buffer pool!");
@@ -374,6 +514,8 @@ gst_socket_src_socket_release (GstFdSocketSrc * src)
     g_mutex_clear (&src->fdmaplock);
   }
 
+  g_clear_pointer (&src->ring, gst_meta_ring_free);
+
   if (src->socket > 0) {
     shutdown (src->socket, SHUT_RDWR);
     close (src->socket);
@@ -392,7 +534,10 @@ gst_socket_src_socket_release (GstFdSocketSrc * src)
 
   src->thread = NULL;
   src->thread_done = FALSE;
-  unlink (src->sockfile);
+
+  // In connect mode the socket file belongs to the socket sink.
+  if (src->listen)
+    unlink (src->sockfile);
 
   g_mutex_unlock (&src->mutex);
 
@@ -433,6 +578,8 @@ gst_socket_src_buffer_release (GstBufferReleaseData * release_data)
   GstReturnBufferPayload ret_pl;
   GstFdCountPayload fd_count = { .identity = MESSAGE_FD_COUNT,
       .n_fds = release_data->n_fds};
+  GstVersionPayload header = { .identity = MESSAGE_HEADER,
+      .version = release_data->version};
 
   ret_pl.identity = MESSAGE_RETURN_BUFFER;
   for (guint i = 0; i < release_data->n_fds; i++) {
@@ -441,6 +588,9 @@ gst_socket_src_buffer_release (GstBufferReleaseData * release_data)
   pl_info.return_buffer = &ret_pl;
   pl_info.fd_count = &fd_count;
 
+  if (release_data->version >= 2)
+    pl_info.header = &header;
+
   if (send_socket_message (release_data->socket, &pl_info) < 0) {
     GST_ERROR ("Unable to release buffer");
   }
@@ -448,6 +598,105 @@ gst_socket_src_buffer_release (GstBufferReleaseData * release_data)
   g_free (release_data);
 }
 
+static void
+gst_socket_src_update_fds (GstFdSocketSrc * src, GstPayloadInfo * pl_info)
+{
+  gint idx = 0;
+
+  // Socket sink uses version 2 framing only if it supports it.
+  if (pl_info->header != NULL)
+    src->version = MIN (pl_info->header->version, GST_SOCKET_PROTOCOL_VERSION);
+
+  g_mutex_lock (&src->fdmaplock);
+
+  // Close the FDs of memory blocks which were freed by the socket sink.
+  if (pl_info->unregister_fds != NULL) {
+    gint n_ids = CLAMP (pl_info->unregister_fds->n_ids, 0,
+        GST_MAX_UNREGISTER_FDS);
+
+    for (idx = 0; idx < n_ids; idx++) {
+      gpointer key = GINT_TO_POINTER (pl_info->unregister_fds->buf_id[idx]);
+      gpointer fd = NULL;
+
+      if (!g_hash_table_lookup_extended (src->fdmap, key, NULL, &fd))
+        continue;
+
+      GST_DEBUG_OBJECT (src, "Unregister buffer fd: %d, buf_id: %d",
+          GPOINTER_TO_INT (fd), GPOINTER_TO_INT (key));
+
+      g_hash_table_remove (src->fdmap, key);
+      close (GPOINTER_TO_INT (fd));
+    }
+  }
+
+  // Store the newly passed FDs under their buffer IDs.
+  if ((pl_info->register_fds != NULL) && (pl_info->fds != NULL)) {
+    gint n_ids = MIN (pl_info->register_fds->n_ids,
+        GST_PL_INFO_GET_N_FDS (pl_info));
+
+    for (idx = 0; idx < n_ids; idx++) {
+      GST_DEBUG_OBJECT (src, "Register buffer fd: %d, buf_id: %d",
+          pl_info->fds[idx], pl_info->register_fds->buf_id[idx]);
+
+      g_hash_table_insert (src->fdmap,
+          GINT_TO_POINTER (pl_info->register_fds->buf_id[idx]),
+          GINT_TO_POINTER (pl_info->fds[idx]));
+    }
+  }
+
+  g_mutex_unlock (&src->fdmaplock);
+
+  // The metadata ring FD follows the FDs of the memory blocks.
+  if ((pl_info->meta_ring != NULL) && (pl_info->fds != NULL) &&
+      (GST_PL_INFO_GET_N_FDS (pl_info) > 0)) {
+    gint fd = pl_info->fds[GST_PL_INFO_GET_N_FDS (pl_info) - 1];
+
+    g_clear_pointer (&src->ring, gst_meta_ring_free);
+
+    if ((src->ring = gst_meta_ring_import (fd)) == NULL)
+      GST_ERROR_OBJECT (src, "Failed to import metadata ring, fd: %d", fd);
+  }
+}
+
+static void
+gst_socket_src_read_records (GstFdSocketSrc * src, GstBuffer * buffer,
+    GstPayloadInfo * pl_info)
+{
+  GstMetaRecordsPayload *records_pl = pl_info->meta_records;
+  const guint8 *data = NULL;
+
+  if ((records_pl == NULL) || (src->ring == NULL))
+    return;
+
+  data = gst_meta_ring_read (src->ring, records_pl->position, records_pl->size);
+
+  if (data == NULL) {
+    GST_WARNING_OBJECT (src, "Invalid metadata records, position: %u size: %u",
+        records_pl->position, records_pl->size);
+    return;
+  }
+
+  if ((buffer != NULL) &&
+      !gst_meta_records_deserialize (buffer, data, records_pl->size))
+    GST_WARNING_OBJECT (src, "Malformed metadata records!");
+
+  gst_meta_ring_release (src->ring, records_pl->position, records_pl->size);
+}
+
+static gint
+gst_socket_src_lookup_fd (GstFdSocketSrc * src, gint buf_id)
+{
+  gpointer fd = NULL;
+  gboolean found = FALSE;
+
+  g_mutex_lock (&src->fdmaplock);
+  found = g_hash_table_lookup_extended (src->fdmap, GINT_TO_POINTER (buf_id),
+      NULL, &fd);
+  g_mutex_unlock (&src->fdmaplock);
+
+  return found ? GPOINTER_TO_INT (fd) : -1;
+}
+
 static void
 gst_socket_src_flush_socket_queue (GstFdSocketSrc * src)
 {
@@ -488,12 +737,19 @@ gst_socket_src_flush_socket_queue (GstFdSocketSrc * src)
         break;
       }
 
-      if (pl_info.fd_count != NULL) {
+      gst_socket_src_update_fds (src, &pl_info);
+      release_data->version = src->version;
+
+      // Since version 2 the FD count may include FDs which are not buffers.
+      if ((pl_info.fd_count != NULL) && (pl_info.header == NULL)) {
         release_data->n_fds = pl_info.fd_count->n_fds;
       } else {
         release_data->n_fds = pl_info.mem_block_info->len;
       }
 
+      // Records of flushed buffers must be consumed as well.
+      gst_socket_src_read_records (src, NULL, &pl_info);
+
       if (GST_PL_INFO_IS_MESSAGE (&pl_info, MESSAGE_EOS)) {
         g_free (release_data);
         free_pl_struct (&pl_info);
@@ -537,7 +793,14 @@ gst_socket_src_fill_buffer (GstFdSocketSrc * src, GstBuffer ** outbuf)
     return GST_FLOW_ERROR;
   }
 
-  if (pl_info.fd_count != NULL) {
+  gst_socket_src_update_fds (src, &pl_info);
+  release_data->version = src->version;
+
+  // Since version 2 the FD count may include FDs which are not buffers.
+  if ((pl_info.fd_count != NULL) && (pl_info.header != NULL)) {
+    n_fds = pl_info.fd_count->n_fds;
+    release_data->n_fds = pl_info.mem_block_info->len;
+  } else if (pl_info.fd_count != NULL) {
     n_fds = pl_info.fd_count->n_fds;
     release_data->n_fds = pl_info.fd_count->n_fds;
   } else {
@@ -591,7 +854,17 @@ gst_socket_src_fill_buffer (GstFdSocketSrc * src, GstBuffer ** outbuf)
   for (guint i = 0; i < pl_info.mem_block_info->len; i++) {
     release_data->buf_id[i] = pl_info.buffer_info->buf_id[i];
 
-    if (src->mode == DATA_MODE_TEXT) {
+    if ((src->mode == DATA_MODE_TEXT) && (GST_SOCKET_MSG_IDENTITY (
+            g_ptr_array_index (pl_info.mem_block_info, i)) == MESSAGE_DATA)) {
+      GstDataPayload *data_pl =
+          (GstDataPayload *) g_ptr_array_index (pl_info.mem_block_info, i);
+
+      gpointer data = g_malloc (data_pl->size);
+      memmove (data, data_pl->contents, data_pl->size);
+
+      gstmemory = gst_memory_new_wrapped (0, data, data_pl->size, 0,
+          data_pl->size, data, g_free);
+    } else if (src->mode == DATA_MODE_TEXT) {
       GstTextPayload *text_pl =
           (GstTextPayload *) g_ptr_array_index (pl_info.mem_block_info, i);
 
@@ -612,8 +885,20 @@ gst_socket_src_fill_buffer (GstFdSocketSrc * src, GstBuffer ** outbuf)
           tensor_pl->identity, pl_info.buffer_info->buf_id[i],
           pl_info.buffer_info->use_buffer_pool);
 
-      // number of fds should match number of memory blocks
-      if (n_fds == 0) {
+      // Registered FDs are owned by the FD map until they are unregistered.
+      if (pl_info.header != NULL) {
+        fds[i] = gst_socket_src_lookup_fd (src, pl_info.buffer_info->buf_id[i]);
+
+        if (fds[i] < 0) {
+          GST_ERROR_OBJECT (src, "Unknown buf_id: %d",
+              pl_info.buffer_info->buf_id[i]);
+          gst_buffer_unref (gstbuffer);
+          gst_object_unref (allocator);
+          g_free (release_data);
+          free_pl_struct (&pl_info);
+          return GST_FLOW_ERROR;
+        }
+      } else if (n_fds == 0) {
         g_mutex_lock (&src->fdmaplock);
         fds[i] = GPOINTER_TO_INT (g_hash_table_lookup (src->fdmap,
             GINT_TO_POINTER (pl_info.buffer_info->buf_id[i])));
@@ -634,7 +919,7 @@ gst_socket_src_fill_buffer (GstFdSocketSrc * src, GstBuffer ** outbuf)
 
       // Wrap our buffer memory block in FD backed memory.
       gstmemory = gst_fd_allocator_alloc (allocator, fds[i], tensor_pl->maxsize,
-          pl_info.buffer_info->use_buffer_pool ?
+          (pl_info.buffer_info->use_buffer_pool || (pl_info.header != NULL)) ?
           GST_FD_MEMORY_FLAG_DONT_CLOSE : GST_FD_MEMORY_FLAG_NONE);
       if (gstmemory == NULL) {
         gst_buffer_unref (gstbuffer);
@@ -661,8 +946,20 @@ gst_socket_src_fill_buffer (GstFdSocketSrc * src, GstBuffer ** outbuf)
       GST_DEBUG_OBJECT (src, "info: msg_id: %d, buf_id %d",
           frame_pl->identity, pl_info.buffer_info->buf_id[i]);
 
-      // number of fds should match number of memory blocks
-      if (n_fds == 0) {
+      // Registered FDs are owned by the FD map until they are unregistered.
+      if (pl_info.header != NULL) {
+        fds[i] = gst_socket_src_lookup_fd (src, pl_info.buffer_info->buf_id[i]);
+
+        if (fds[i] < 0) {
+          GST_ERROR_OBJECT (src, "Unknown buf_id: %d",
+              pl_info.buffer_info->buf_id[i]);
+          gst_buffer_unref (gstbuffer);
+          gst_object_unref (allocator);
+          g_free (release_data);
+          free_pl_struct (&pl_info);
+          return GST_FLOW_ERROR;
+        }
+      } else if (n_fds == 0) {
         g_mutex_lock (&src->fdmaplock);
         fds[i] = GPOINTER_TO_INT (g_hash_table_lookup (src->fdmap,
             GINT_TO_POINTER (pl_info.buffer_info->buf_id[i])));
@@ -683,7 +980,7 @@ gst_socket_src_fill_buffer (GstFdSocketSrc * src, GstBuffer ** outbuf)
 
       // Wrap our buffer memory block in FD backed memory.
       gstmemory = gst_fd_allocator_alloc (allocator, fds[i], frame_pl->maxsize,
-          pl_info.buffer_info->use_buffer_pool ?
+          (pl_info.buffer_info->use_buffer_pool || (pl_info.header != NULL)) ?
           GST_FD_MEMORY_FLAG_DONT_CLOSE : GST_FD_MEMORY_FLAG_NONE);
       if (gstmemory == NULL) {
         gst_buffer_unref (gstbuffer);
@@ -841,6 +1138,10 @@ gst_socket_src_fill_buffer (GstFdSocketSrc * src, GstBuffer ** outbuf)
     gst_buffer_append_memory (gstbuffer, gstmemory);
   }
 
+  // Metas received as metadata ring records are attached once per buffer.
+  if (src->mode == DATA_MODE_VIDEO)
+    gst_socket_src_read_records (src, gstbuffer, &pl_info);
+
   if (src->mode != DATA_MODE_TEXT) {
     // Unreference the allocator so that it is owned only by the gstmemory.
     gst_object_unref (allocator);
@@ -925,6 +1226,8 @@ gst_socket_src_change_state (GstElement * element, GstStateChange transition)
   GstFdSocketSrc *src = GST_SOCKET_SRC (element);
   GstPayloadInfo msg_info = {0};
   GstMessagePayload disc_msg = { .identity = MESSAGE_DISCONNECT};
+  GstVersionPayload header = { .identity = MESSAGE_HEADER,
+      .version = src->version};
   GstStateChangeReturn ret = GST_STATE_CHANGE_SUCCESS;
 
   switch (transition) {
@@ -934,6 +1237,9 @@ gst_socket_src_change_state (GstElement * element, GstStateChange transition)
       break;
     case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
       msg_info.message = &disc_msg;
+
+      if (header.version >= 2)
+        msg_info.header = &header;
       if (send_socket_message (src->client_sock, &msg_info) < 0) {
         GST_INFO_OBJECT (src, "Unable to send disconnect message.");
       }
@@ -1018,6 +1324,10 @@ gst_socket_src_init (GstFdSocketSrc * src)
   src->mlinfo = NULL;
   src->pool = NULL;
   src->mode = DATA_MODE_NONE;
+  src->version = 1;
+  src->listen = DEFAULT_PROP_LISTEN;
+  src->queue_depth = DEFAULT_PROP_QUEUE_DEPTH;
+  src->drop_policy = DEFAULT_PROP_DROP_POLICY;
 
   g_cond_init (&src->cond);
   g_mutex_init (&src->mutex);
@@ -1056,6 +1366,29 @@ gst_socket_src_class_init (GstFdSocketSrcClass * klass)
         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
         GST_PARAM_MUTABLE_READY | G_PARAM_CONSTRUCT));
 
+  g_object_class_install_property (gobject, PROP_LISTEN,
+    g_param_spec_boolean ("listen", "Listen",
+        "Create the socket and wait for a socket sink, otherwise connect to "
+        "the socket of a socket sink started with listen=true",
+        DEFAULT_PROP_LISTEN,
+        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+        GST_PARAM_MUTABLE_READY));
+
+  g_object_class_install_property (gobject, PROP_QUEUE_DEPTH,
+    g_param_spec_uint ("queue-depth", "Queue depth",
+        "Maximum number of buffers held at a time when connected to a "
+        "listening socket sink (0 = unlimited)", 0, G_MAXUINT,
+        DEFAULT_PROP_QUEUE_DEPTH,
+        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+        GST_PARAM_MUTABLE_READY));
+
+  g_object_class_install_property (gobject, PROP_DROP_POLICY,
+    g_param_spec_enum ("drop-policy", "Drop policy",
+        "Buffers dropped by a listening socket sink once the queue depth is "
+        "reached", GST_TYPE_SOCKET_SRC_DROP_POLICY, DEFAULT_PROP_DROP_POLICY,
+        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+        GST_PARAM_MUTABLE_READY));
+
   gst_element_class_set_static_metadata (gstelement,
       "QTI Socket Source Element", "Socket Source Element",
       "This plugin receive GST buffer over Unix Domain Socket", "QTI");
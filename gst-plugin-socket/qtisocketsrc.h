@@ -40,6 +40,7 @@
 #include <gst/ml/ml-info.h>
 
 #include "qtifdsocket.h"
+#include "qtimetaring.h"
 
 G_BEGIN_DECLS
 
@@ -87,9 +88,20 @@ struct _GstFdSocketSrc {
   gint socket;
   gint client_sock;
 
+  // Create the socket and wait for a socket sink, or connect to its socket.
+  gboolean listen;
+  // Buffer delivery preferences sent to a listening socket sink.
+  guint               queue_depth;
+  GstSocketDropPolicy drop_policy;
+
   GHashTable *fdmap;
   GMutex      fdmaplock;
 
+  // Protocol version used by the connected socket sink.
+  guint version;
+  // Metadata records shared by the socket sink (version 3).
+  GstMetaRing *ring;
+
   GstBufferPool *pool;
 
   GstSegment segment;
@@ -117,6 +129,7 @@ GstBufferPool * gst_socketsrc_buffer_pool_new (void);
 
 struct _GstBufferReleaseData {
   gint  socket;
+  guint version;
   guint n_fds;
   gint  buf_id[GST_MAX_MEM_BLOCKS];
 };
@@ -33,6 +33,9 @@ static const GEnumValue suite_values[] =
   { GST_TEST_SUITE_CAMERA, "camera suite", "camera" },
   { GST_TEST_SUITE_AI, "AI suite", "ai" },
   { GST_TEST_SUITE_ML, "machine learning suite", "ml" },
+  { GST_TEST_SUITE_CV, "computer vision suite", "cv" },
+  { GST_TEST_SUITE_PERF, "performance suite", "perf" },
+  { GST_TEST_SUITE_SOCKET, "socket suite", "socket" },
   // Add new suites.
   { 0, NULL, NULL }
 };
@@ -98,7 +101,7 @@ static void gst_plugin_suite_help (GstPluginSuite *psuite)
         "gst-test-framework");
     gst_printerr ("\n");
     gst_printerr (
-        "  -s: Suite names, could be camera/ml\n"
+        "  -s: Suite names, could be camera/ml/cv/perf/socket\n"
         "  -i: Iteration times for each test, default is 1 time\n"
         "  -d: Running time for each test in seconds, default is 10 seconds\n"
         "  -h: Print available test case names when -s is configured");
@@ -131,6 +134,15 @@ static gboolean gst_plugin_get_suite (GstPluginSuite *psuite)
     case GST_TEST_SUITE_ML:
       GST_PLUGIN_GET_SUITE (ml, psuite);
       break;
+    case GST_TEST_SUITE_CV:
+      GST_PLUGIN_GET_SUITE (cv, psuite);
+      break;
+    case GST_TEST_SUITE_PERF:
+      GST_PLUGIN_GET_SUITE (perf, psuite);
+      break;
+    case GST_TEST_SUITE_SOCKET:
+      GST_PLUGIN_GET_SUITE (socket, psuite);
+      break;
     default:
       ret = FALSE;
       gst_printerr ("Unknown suite index %d.", psuite->idx);
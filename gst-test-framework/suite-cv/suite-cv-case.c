@@ -0,0 +1,475 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <string.h>
+
+#include "plugin-suite.h"
+
+#define CV_TEXT_CAPS          "text/x-raw,format=utf8"
+
+// Number of batches pushed to the object tracker.
+#define CV_N_FRAMES           12
+// Number of streams in a batch and the batch in which the last stream joins.
+#define CV_N_STREAMS          3
+#define CV_LATE_FRAME         6
+// Maximum number of detections of a single stream.
+#define CV_N_DETECTIONS       3
+
+// Scene of the ByteTrack reference, objects and false positives per frame.
+#define CV_SCENE_N_FRAMES     40
+#define CV_SCENE_N_OBJECTS    16
+#define CV_SCENE_N_FALSE      2
+#define CV_SCENE_N_DETECTIONS (CV_SCENE_N_OBJECTS + CV_SCENE_N_FALSE)
+
+typedef struct _CvSceneObject CvSceneObject;
+
+struct _CvSceneObject {
+  gint x;
+  gint y;
+  gint w;
+  gint h;
+  gint vx;
+  gint vy;
+};
+
+// Tracking IDs assigned by the ByteTrack core before its rewrite to every
+// detection of the scene, -1 if not tracked. The ID counter is global to the
+// process, so only which detections share an ID is meaningful, not its value.
+static const gint
+cv_scene_trackids[CV_SCENE_N_FRAMES][CV_SCENE_N_DETECTIONS] = {
+  {  -1, -1,  0,  1, -1,  2, -1,  3, -1, -1,  4,  5, -1,  6,  7, -1,  8, -1 },
+  {  -1, -1,  0,  1, -1,  2, -1,  3, -1, -1,  4,  5, -1,  6,  7, -1, -1, -1 },
+  {   9, -1,  0,  1, -1,  2, -1, -1, 12, -1,  4,  5, 13,  6,  7, -1, -1, -1 },
+  {   9, -1,  0,  1, -1,  2, -1,  3, 12, 16, -1,  5, 13,  6,  7, -1, -1, -1 },
+  {   9, -1,  0,  1, -1,  2, -1,  3, 12, 16, 13, -1, -1,  6,  7, 20, -1, -1 },
+  {   9, -1,  0,  1, 22,  2, -1,  3, 12, -1, 13,  5, -1,  6,  7, 20, -1, -1 },
+  {   9, -1,  0,  1, 22,  2, -1,  3, 12, 16, 13,  5, -1,  6,  7, -1, -1, -1 },
+  {  -1, -1, -1,  1, 22,  2, -1,  3, 12, 16, 13,  5, 25,  6,  7, 20, -1, -1 },
+  {   9, -1, -1,  1, 22,  2, -1,  3, 12, 16, 13,  5, 25,  6,  7, 20, -1, -1 },
+  {   9, 26,  0,  1, 22,  2, -1,  3, 12, 16, 13, -1, 25, -1,  7, 20, -1, -1 },
+  {   9, 26,  0,  1, 22,  2, -1,  3, 12, 16, 13, -1, 25,  6,  7, 20, -1, -1 },
+  {   9, 26,  0, -1, 22,  2, -1, -1, 12, 16, 13, -1, -1,  6,  7, 20, -1, -1 },
+  {   9, 26,  0,  1, 22,  2, 29, -1, 12, 16, 13, -1, 30,  6,  7, 20, -1, -1 },
+  {   9, 26,  0,  1, 22,  2, -1, -1, 12, 16, 13, -1, 30,  6,  7, 20, -1, -1 },
+  {   9, 26,  0,  1, 22, -1, -1, 32, 12, 16, 13, -1, 30,  6,  7, 20, -1, -1 },
+  {  -1, 26, -1,  1, 22, 34, 35, -1, 12, 16, 13, -1, 30,  6, -1, 20, -1, -1 },
+  {   9, 26, -1,  1, 22, 34, 35, -1, 12, 16, 13, -1, 30,  6,  7, 20, -1, -1 },
+  {   9, 26, -1,  1, 22, 34, 35, 32, 12, 16, 13, -1, 30,  6,  7, 20, -1, -1 },
+  {   9, 26, -1,  1, 22, 34, 35, 32, 12, 16, 13, 38, 30, -1,  7, 20, -1, -1 },
+  {   9, 26, -1,  1, 22, 34, 35, 32, 12, 16, 13, 38, -1, -1,  7, 20, -1, -1 },
+  {   9, 26, -1, -1, 22, 34, 35, 32, 12, 16, 13, 38, 30,  6,  7, 20, -1, -1 },
+  {   9, 26, -1,  1, 22, 34, 35, 32, 12, 16, 13, 38, -1, -1,  7, 20, -1, -1 },
+  {   9, -1, 40,  1, 22, 34, 35, 32, -1, 16, 13, 38, -1,  6,  7, 20, -1, -1 },
+  {   9, -1, 40,  1, 22, 34, 35, 32, -1, 16, 13, 38, 30,  6, -1, 20, -1, -1 },
+  {   9, 26, 40,  1, 22, 34, 35, 32, 43, 16, 13, -1, 30,  6, -1, 20, -1, -1 },
+  {   9, 26, 40,  1, 22, 34, 35, 32, 43, 16, 13, 38, 30,  6,  7, 20, -1, -1 },
+  {   9, 26, 40,  1, 22, 34, 35, -1, 43, 16, 13, 38, 30,  6, -1, 20, -1, -1 },
+  {   9, 26, 40,  1, 22, 34, 35, -1, 43, 16, 13, 38, 30,  6, -1, -1, -1, -1 },
+  {   9, 26, 40,  1, 22, 34, 35, -1, -1, 16, 13, -1, 30, -1,  7, 20, -1, -1 },
+  {   9, 26, 40,  1, 22, 34, 35, -1, -1, 16, 13, 38, -1,  6,  7, 20, -1, -1 },
+  {   9, 26, 40,  1, 22, 34, 35, 32, -1, 16, 13, 38, 30,  6,  7, 20, -1, -1 },
+  {   9, 26, 40,  1, 22, 34, 35, 32, -1, 16, 13, 38, 30,  6,  7, 20, -1, -1 },
+  {   9, 26, 40,  1, 22, 34, 35, 32, 43, 16, 13, 38, 30,  6,  7, 20, -1, -1 },
+  {  -1, 26, 40, -1, 22, 34, -1, -1, -1, 16, 13, 38, 30,  6,  7, 20, -1, -1 },
+  {  -1, 26, 40,  1, 22, 34, 35, 32, 43, 16, 13, 38, 30, -1,  7, 20, -1, -1 },
+  {  -1, 26, 40,  1, 22, -1, 35, 32, 43, 16, 13, 38, 30,  6,  7, 20, -1, -1 },
+  {  -1, 26, 40,  1, 22, 34, 35, 32, 43, 16, 13, 38, -1,  6,  7, 20, -1, -1 },
+  {  -1, 26, 40,  1, 22, 34, 35, 32, 43, 16, 13, 38, 30,  6,  7, 20, -1, -1 },
+  {  50, 26, 40,  1, -1, 34, 35, 32, -1, 16, 13, 38, 30,  6, -1, 20, -1, -1 },
+  {  -1, 26, -1,  1, -1, 34, -1, 32, -1, 16, 13, 38, 30,  6,  7, 20, -1, -1 },
+};
+
+static void
+cv_append_detection (GValue * bboxes, guint id, gfloat x, gfloat y,
+    gfloat w, gfloat h, gdouble confidence)
+{
+  GstStructure *entry = NULL;
+  GValue rectangle = G_VALUE_INIT, value = G_VALUE_INIT;
+  gfloat coordinates[4] = { x, y, w, h };
+  guint idx = 0;
+
+  g_value_init (&rectangle, GST_TYPE_ARRAY);
+  g_value_init (&value, G_TYPE_FLOAT);
+
+  for (idx = 0; idx < G_N_ELEMENTS (coordinates); idx++) {
+    g_value_set_float (&value, coordinates[idx]);
+    gst_value_array_append_value (&rectangle, &value);
+  }
+
+  g_value_unset (&value);
+
+  entry = gst_structure_new ("person", "id", G_TYPE_UINT, id,
+      "confidence", G_TYPE_DOUBLE, confidence, NULL);
+  gst_structure_take_value (entry, "rectangle", &rectangle);
+
+  g_value_init (&value, GST_TYPE_STRUCTURE);
+  g_value_take_boxed (&value, entry);
+  gst_value_array_append_and_take_value (bboxes, &value);
+}
+
+static void
+cv_append_entry (GValue * list, gint stream_id, GValue * bboxes)
+{
+  GstStructure *structure = NULL;
+  GValue value = G_VALUE_INIT;
+
+  structure = gst_structure_new_empty ("ObjectDetection");
+
+  if (stream_id >= 0)
+    gst_structure_set (structure, "stream-id", G_TYPE_INT, stream_id, NULL);
+
+  gst_structure_take_value (structure, "bounding-boxes", bboxes);
+
+  g_value_init (&value, GST_TYPE_STRUCTURE);
+  g_value_take_boxed (&value, structure);
+  gst_value_list_append_and_take_value (list, &value);
+}
+
+// Streams 0 and 2 contain the same two objects, stream 1 an additional one.
+static void
+cv_append_stream (GValue * list, gint stream_id, guint frame)
+{
+  GValue bboxes = G_VALUE_INIT;
+
+  g_value_init (&bboxes, GST_TYPE_ARRAY);
+
+  cv_append_detection (&bboxes, 0, 100.0 + 6.0 * frame, 100.0, 50.0, 100.0,
+      90.0);
+  cv_append_detection (&bboxes, 1, 400.0, 300.0 + 4.0 * frame, 60.0, 120.0,
+      85.0);
+
+  if (stream_id == 1)
+    cv_append_detection (&bboxes, 2, 900.0 - 5.0 * frame, 200.0, 40.0, 80.0,
+        80.0);
+
+  cv_append_entry (list, stream_id, &bboxes);
+}
+
+static void
+cv_objtracker_process (GstHarness * h, const GValue * input, GValue * output)
+{
+  GstBuffer *buffer = NULL;
+  GstMapInfo map;
+  gchar *text = NULL;
+
+  text = gst_value_serialize (input);
+  buffer = gst_buffer_new_wrapped (text, strlen (text) + 1);
+
+  buffer = gst_harness_push_and_pull (h, buffer);
+  fail_unless (buffer != NULL);
+
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+  text = g_strndup ((const gchar *) map.data, map.size);
+  gst_buffer_unmap (buffer, &map);
+  gst_buffer_unref (buffer);
+
+  g_value_init (output, GST_TYPE_LIST);
+  fail_unless (gst_value_deserialize (output, text),
+      "Failed to deserialize '%s'!", text);
+
+  g_free (text);
+}
+
+// Bounding box with the given detection ID in the entry at the given index.
+static const GstStructure *
+cv_get_bbox (const GValue * list, guint index, guint id)
+{
+  const GstStructure *structure = NULL, *entry = NULL;
+  const GValue *bboxes = NULL;
+  guint idx = 0, value = 0;
+
+  structure = gst_value_get_structure (gst_value_list_get_value (list, index));
+  bboxes = gst_structure_get_value (structure, "bounding-boxes");
+
+  if (bboxes == NULL)
+    return NULL;
+
+  for (idx = 0; idx < gst_value_array_get_size (bboxes); idx++) {
+    entry = gst_value_get_structure (gst_value_array_get_value (bboxes, idx));
+
+    if (gst_structure_get_uint (entry, "id", &value) && (value == id))
+      return entry;
+  }
+
+  return NULL;
+}
+
+// Deterministic generator, the scene must not depend on the GLib version.
+static guint
+cv_scene_random (guint32 * state, guint range)
+{
+  *state = *state * 1664525 + 1013904223;
+  return (*state >> 8) % range;
+}
+
+static void
+cv_scene_spawn (CvSceneObject * object, guint32 * state)
+{
+  object->w = 20 + cv_scene_random (state, 80);
+  object->h = 40 + cv_scene_random (state, 120);
+  object->x = cv_scene_random (state, 1800);
+  object->y = cv_scene_random (state, 1000);
+  object->vx = (gint) cv_scene_random (state, 9) - 4;
+  object->vy = (gint) cv_scene_random (state, 7) - 3;
+}
+
+// Moving objects which respawn, are missed and mixed with false positives.
+static void
+cv_scene_next_frame (CvSceneObject * objects, guint32 * state, GValue * list)
+{
+  GValue bboxes = G_VALUE_INIT;
+  guint idx = 0, id = 0;
+  gint x = 0, y = 0, w = 0, h = 0;
+
+  g_value_init (&bboxes, GST_TYPE_ARRAY);
+
+  for (idx = 0; idx < CV_SCENE_N_OBJECTS; idx++, id++) {
+    CvSceneObject *object = &objects[idx];
+
+    object->x += object->vx;
+    object->y += object->vy;
+
+    if (cv_scene_random (state, 100) < 2)
+      cv_scene_spawn (object, state);
+
+    // Missed detection.
+    if (cv_scene_random (state, 100) < 8)
+      continue;
+
+    x = object->x + (gint) cv_scene_random (state, 5) - 2;
+    y = object->y + (gint) cv_scene_random (state, 5) - 2;
+    w = object->w + (gint) cv_scene_random (state, 3) - 1;
+    h = object->h + (gint) cv_scene_random (state, 3) - 1;
+
+    cv_append_detection (&bboxes, id, x, y, w, h,
+        30 + cv_scene_random (state, 70));
+  }
+
+  for (idx = 0; idx < CV_SCENE_N_FALSE; idx++, id++) {
+    x = cv_scene_random (state, 1800);
+    y = cv_scene_random (state, 1000);
+
+    cv_append_detection (&bboxes, id, x, y, 30.0, 60.0,
+        20 + cv_scene_random (state, 50));
+  }
+
+  cv_append_entry (list, -1, &bboxes);
+}
+
+static GstHarness *
+cv_objtracker_new (void)
+{
+  GstHarness *h = NULL;
+
+  h = gst_harness_new_parse ("qtiobjtracker n-threads=4");
+  gst_harness_set_caps_str (h, CV_TEXT_CAPS, CV_TEXT_CAPS);
+
+  return h;
+}
+
+GST_START_TEST (test_cv_objtracker_batched_streams)
+{
+  GstHarness *h = NULL, *single = NULL;
+  GHashTable *trackids = NULL;
+  GValue input = G_VALUE_INIT, output = G_VALUE_INIT;
+  GValue reference = G_VALUE_INIT;
+  const GstStructure *structure = NULL, *bbox = NULL, *refbbox = NULL;
+  gint streams[CV_N_STREAMS], tracks[CV_N_STREAMS][CV_N_DETECTIONS];
+  guint frame = 0, n_streams = 0, idx = 0, id = 0, trackid = 0;
+  gint stream_id = 0;
+
+  h = cv_objtracker_new ();
+  single = cv_objtracker_new ();
+
+  for (idx = 0; idx < CV_N_STREAMS; idx++)
+    for (id = 0; id < CV_N_DETECTIONS; id++)
+      tracks[idx][id] = -1;
+
+  for (frame = 0; frame < CV_N_FRAMES; frame++) {
+    n_streams = (frame < CV_LATE_FRAME) ? (CV_N_STREAMS - 1) : CV_N_STREAMS;
+
+    // The order of the streams in the batch changes between batches.
+    for (idx = 0; idx < n_streams; idx++)
+      streams[idx] = (frame % 2) ? (n_streams - idx - 1) : idx;
+
+    g_value_init (&input, GST_TYPE_LIST);
+
+    for (idx = 0; idx < n_streams; idx++)
+      cv_append_stream (&input, streams[idx], frame);
+
+    cv_objtracker_process (h, &input, &output);
+    g_value_unset (&input);
+
+    // Stream 0 tracked alone, as reference for the batched stream 0.
+    g_value_init (&input, GST_TYPE_LIST);
+    cv_append_stream (&input, 0, frame);
+
+    cv_objtracker_process (single, &input, &reference);
+    g_value_unset (&input);
+
+    fail_unless_equals_int (gst_value_list_get_size (&output), n_streams);
+
+    trackids = g_hash_table_new (NULL, NULL);
+
+    for (idx = 0; idx < n_streams; idx++) {
+      structure =
+          gst_value_get_structure (gst_value_list_get_value (&output, idx));
+
+      fail_unless (gst_structure_get_int (structure, "stream-id", &stream_id));
+      fail_unless_equals_int (stream_id, streams[idx]);
+
+      for (id = 0; id < ((stream_id == 1) ? 3 : 2); id++) {
+        // Streams have their own trackers, a stream joining later has its
+        // objects tracked from its first batch on.
+        bbox = cv_get_bbox (&output, idx, id);
+        fail_unless (bbox != NULL, "Object %u of stream %d not tracked in "
+            "batch %u!", id, stream_id, frame);
+
+        fail_unless (gst_structure_get_uint (bbox, "tracking-id", &trackid));
+
+        if (tracks[stream_id][id] < 0)
+          tracks[stream_id][id] = trackid;
+
+        // Objects keep their tracking ID and no two objects share one. The
+        // IDs come from a process wide counter, streams tracked in parallel
+        // get them in any order, so their values are not compared.
+        fail_unless_equals_int (trackid, tracks[stream_id][id]);
+        fail_if (g_hash_table_contains (trackids, GUINT_TO_POINTER (trackid)),
+            "Tracking ID %u used twice in batch %u!", trackid, frame);
+        g_hash_table_add (trackids, GUINT_TO_POINTER (trackid));
+
+        // Other streams in the batch do not change how stream 0 is tracked.
+        if (stream_id != 0)
+          continue;
+
+        refbbox = cv_get_bbox (&reference, 0, id);
+        fail_unless (refbbox != NULL);
+
+        fail_unless (gst_value_compare (
+            gst_structure_get_value (bbox, "rectangle"),
+            gst_structure_get_value (refbbox, "rectangle")) == GST_VALUE_EQUAL,
+            "Object %u of stream 0 differs in batch %u!", id, frame);
+      }
+    }
+
+    g_hash_table_destroy (trackids);
+
+    g_value_unset (&reference);
+    g_value_unset (&output);
+  }
+
+  gst_harness_teardown (single);
+  gst_harness_teardown (h);
+}
+GST_END_TEST;
+
+GST_START_TEST (test_cv_objtracker_bytetrack_reference)
+{
+  GstHarness *h = NULL;
+  CvSceneObject objects[CV_SCENE_N_OBJECTS];
+  GValue input = G_VALUE_INIT, output = G_VALUE_INIT;
+  const GstStructure *bbox = NULL;
+  guint32 state = 42;
+  GHashTable *idmap = NULL, *trackids = NULL;
+  guint frame = 0, id = 0, trackid = 0;
+  gint expected = 0;
+
+  h = cv_objtracker_new ();
+
+  // Expected IDs mapped to the tracking IDs they first appeared with.
+  idmap = g_hash_table_new (NULL, NULL);
+  trackids = g_hash_table_new (NULL, NULL);
+
+  for (id = 0; id < CV_SCENE_N_OBJECTS; id++)
+    cv_scene_spawn (&objects[id], &state);
+
+  for (frame = 0; frame < CV_SCENE_N_FRAMES; frame++) {
+    g_value_init (&input, GST_TYPE_LIST);
+    cv_scene_next_frame (objects, &state, &input);
+
+    cv_objtracker_process (h, &input, &output);
+    g_value_unset (&input);
+
+    for (id = 0; id < CV_SCENE_N_DETECTIONS; id++) {
+      bbox = cv_get_bbox (&output, 0, id);
+      expected = cv_scene_trackids[frame][id];
+
+      if (expected < 0) {
+        fail_unless (bbox == NULL, "Detection %u tracked in frame %u!",
+            id, frame);
+        continue;
+      }
+
+      fail_unless (bbox != NULL, "Detection %u not tracked in frame %u!",
+          id, frame);
+      fail_unless (gst_structure_get_uint (bbox, "tracking-id", &trackid));
+
+      // Tracking IDs are taken from a global counter, compare them by the
+      // detections which share them rather than by their values.
+      if (!g_hash_table_contains (idmap, GINT_TO_POINTER (expected))) {
+        fail_if (g_hash_table_contains (trackids, GUINT_TO_POINTER (trackid)),
+            "Tracking ID %u of detection %u reused in frame %u!",
+            trackid, id, frame);
+
+        g_hash_table_insert (idmap, GINT_TO_POINTER (expected),
+            GUINT_TO_POINTER (trackid));
+        g_hash_table_add (trackids, GUINT_TO_POINTER (trackid));
+      }
+
+      fail_unless_equals_int (trackid, GPOINTER_TO_UINT (
+          g_hash_table_lookup (idmap, GINT_TO_POINTER (expected))));
+    }
+
+    g_value_unset (&output);
+  }
+
+  g_hash_table_destroy (trackids);
+  g_hash_table_destroy (idmap);
+
+  gst_harness_teardown (h);
+}
+GST_END_TEST;
+
+static Suite *
+cv_suite (GList **tcnames, gint iteration, gint duration)
+{
+  Suite *s = suite_create ("cv");
+  TCase *tc;
+  gchar *tcname = NULL;
+  int start = 0, end = 1;
+  // TCase timeout in seconds.
+  int tctimeout = 30;
+
+  if (iteration > 0)
+    end = iteration;
+
+  tcname = "objtracker_batched_streams";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase object tracker with detections of several streams.
+  tcase_add_loop_test (tc, test_cv_objtracker_batched_streams, start, end);
+
+  tcname = "objtracker_bytetrack_reference";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase ByteTrack tracking IDs against the reference results.
+  tcase_add_loop_test (tc, test_cv_objtracker_bytetrack_reference, start, end);
+
+  return s;
+}
+
+void gst_plugin_get_cv_suite (GstPluginSuite* psuite)
+{
+  if (psuite == NULL)
+    return;
+
+  psuite->name = "cv";
+  psuite->suite = cv_suite (&psuite->tcnames,
+      psuite->iteration, psuite->duration);
+}
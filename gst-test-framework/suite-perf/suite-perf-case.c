@@ -0,0 +1,639 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#include <string.h>
+
+#include <gst/video/video-converter-engine.h>
+#include <gst/ml/ml-quantize.h>
+#include <gst/utils/float16-utils.h>
+#include <gst/allocators/gstqtiallocator.h>
+
+#include "plugin-suite.h"
+
+// Number of measured runs per benchmark.
+static gint n_runs = 100;
+
+#define PERF_TENSOR_WIDTH        640
+#define PERF_TENSOR_HEIGHT       640
+#define PERF_TENSOR_CHANNELS     3
+// Number of tensor elements converted by the quantization benchmarks.
+#define PERF_QUANTIZE_ELEMENTS   (1 << 20)
+// Number of halfway elements, one vectorized block of 16 and a scalar tail.
+#define PERF_QUANTIZE_HALFWAY    20
+// Number of threads and allocations per thread in the allocator benchmark.
+#define PERF_ALLOC_THREADS       4
+#define PERF_ALLOC_ITERATIONS    2000
+// Number of size classes recycled by the QTI allocator.
+#define PERF_ALLOC_SIZE_CLASSES  8
+// Number of threads used by the converter when blits are split in tiles.
+#define PERF_CONVERTER_THREADS   4
+
+static guint8 *
+perf_random_data (gsize size, guint32 seed)
+{
+  GRand *rand = g_rand_new_with_seed (seed);
+  guint8 *data = g_malloc (size);
+  gsize idx = 0;
+
+  for (idx = 0; idx < size; idx++)
+    data[idx] = g_rand_int_range (rand, 0, 256);
+
+  g_rand_free (rand);
+  return data;
+}
+
+static void
+perf_fill_tensor (GstMLType type, guint8 * data, gsize n_elements)
+{
+  GRand *rand = g_rand_new_with_seed (0x5EED);
+  gsize idx = 0;
+
+  for (idx = 0; idx < n_elements; idx++) {
+    switch (type) {
+      case GST_ML_TYPE_INT8:
+      case GST_ML_TYPE_UINT8:
+        data[idx] = g_rand_int_range (rand, 0, 256);
+        break;
+      case GST_ML_TYPE_INT16:
+      case GST_ML_TYPE_UINT16:
+        ((guint16 *) data)[idx] = g_rand_int_range (rand, 0, 65536);
+        break;
+      case GST_ML_TYPE_INT32:
+        // Values in the range where FLOAT32 is exact.
+        ((gint32 *) data)[idx] =
+            g_rand_int_range (rand, -(1 << 23), (1 << 23));
+        break;
+      case GST_ML_TYPE_FLOAT16:
+        ((guint16 *) data)[idx] =
+            gst_float_to_half (g_rand_double_range (rand, -8.0, 8.0));
+        break;
+      default:
+        break;
+    }
+  }
+
+  g_rand_free (rand);
+}
+
+static void
+perf_report (const gchar * name, gint64 elapsed, gsize n_bytes)
+{
+  gdouble usecs = (gdouble) elapsed / n_runs;
+
+  g_print ("%-32s %10.1f us/run %8.2f GB/s\n", name, usecs,
+      (n_bytes / usecs) / 1000.0);
+}
+
+// Normalization is fused only into the OpenCV and FastCV compositions.
+static GstVideoConvEngine *
+perf_converter_engine_new (void)
+{
+  GEnumClass *eclass = g_type_class_ref (GST_TYPE_VCE_BACKEND);
+  GEnumValue *evalue = NULL;
+  GstVideoConvEngine *engine = NULL;
+
+  if ((evalue = g_enum_get_value_by_nick (eclass, "ocv")) == NULL)
+    evalue = g_enum_get_value_by_nick (eclass, "fcv");
+
+  if (evalue != NULL)
+    engine = gst_video_converter_engine_new (evalue->value, NULL);
+
+  g_type_class_unref (eclass);
+  return engine;
+}
+
+static void
+perf_check_normalized (GstBuffer * buffer, const gfloat * reference,
+    gsize n_elements)
+{
+  GstMapInfo map;
+  const gfloat *output = NULL;
+  gsize idx = 0;
+
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+  output = (const gfloat *) map.data;
+
+  for (idx = 0; idx < n_elements; idx++)
+    fail_unless (ABS (output[idx] - reference[idx]) < 1e-4,
+        "Element %" G_GSIZE_FORMAT ": %f != %f", idx, output[idx],
+        reference[idx]);
+
+  gst_buffer_unmap (buffer, &map);
+}
+
+typedef struct _PerfAllocContext PerfAllocContext;
+
+struct _PerfAllocContext {
+  GstAllocator *allocator;
+  guint        n_sizes;
+  guint        offset;
+};
+
+// Sizes of a 1080p NV12 frame and its smaller variants, 4K aligned.
+static gsize
+perf_alloc_size (guint idx)
+{
+  return GST_ROUND_UP_N ((1920 * 1080 * 3 / 2) >> (idx % 4), 4096) +
+      (idx / 4) * 4096;
+}
+
+static gpointer
+perf_alloc_thread (gpointer userdata)
+{
+  PerfAllocContext *context = userdata;
+  GstAllocationParams params;
+  GstMemory *memory = NULL;
+  guint idx = 0;
+
+  gst_allocation_params_init (&params);
+
+  for (idx = 0; idx < PERF_ALLOC_ITERATIONS; idx++) {
+    gsize size = perf_alloc_size ((context->offset + idx) % context->n_sizes);
+
+    memory = gst_allocator_alloc (context->allocator, size, &params);
+
+    if (memory == NULL)
+      return GINT_TO_POINTER (FALSE);
+
+    gst_memory_unref (memory);
+  }
+
+  return GINT_TO_POINTER (TRUE);
+}
+
+static void
+perf_alloc_stress (GstAllocator * allocator, guint n_sizes, guint max_blocks)
+{
+  PerfAllocContext contexts[PERF_ALLOC_THREADS];
+  GThread *threads[PERF_ALLOC_THREADS];
+  GstQtiAllocatorStats stats = { 0, };
+  gint64 start = 0, elapsed = 0;
+  guint idx = 0;
+
+  gst_qti_allocator_start (GST_QTI_ALLOCATOR (allocator), max_blocks);
+
+  start = g_get_monotonic_time ();
+
+  for (idx = 0; idx < PERF_ALLOC_THREADS; idx++) {
+    contexts[idx].allocator = allocator;
+    contexts[idx].n_sizes = n_sizes;
+    contexts[idx].offset = idx;
+
+    threads[idx] = g_thread_new ("perf-alloc", perf_alloc_thread,
+        &contexts[idx]);
+  }
+
+  for (idx = 0; idx < PERF_ALLOC_THREADS; idx++)
+    fail_unless (GPOINTER_TO_INT (g_thread_join (threads[idx])),
+        "Allocation failed for %u sizes", n_sizes);
+
+  elapsed = g_get_monotonic_time () - start;
+
+  gst_qti_allocator_get_stats (GST_QTI_ALLOCATOR (allocator), &stats);
+  gst_qti_allocator_stop (GST_QTI_ALLOCATOR (allocator));
+
+  g_print ("alloc %2u sizes, %2u blocks max   %10.2f us/alloc %6.1f%% hits, "
+      "high water %u\n", n_sizes, max_blocks,
+      (gdouble) elapsed / (PERF_ALLOC_THREADS * PERF_ALLOC_ITERATIONS),
+      (100.0 * stats.hits) / MAX (stats.hits + stats.misses, 1),
+      stats.high_water);
+}
+
+GST_START_TEST (test_perf_qti_allocator)
+{
+  GstAllocator *allocator = NULL;
+
+  allocator = gst_qti_allocator_new (GST_FD_MEMORY_FLAG_NONE);
+  fail_unless (allocator != NULL);
+
+  // All sizes are recycled, after warm up allocations should be freelist hits.
+  perf_alloc_stress (allocator, PERF_ALLOC_SIZE_CLASSES, 0);
+  // More sizes than size classes, the remaining sizes are always allocated.
+  perf_alloc_stress (allocator, PERF_ALLOC_SIZE_CLASSES + 4, 0);
+  // Limited number of blocks, recycled blocks of other sizes are evicted.
+  perf_alloc_stress (allocator, PERF_ALLOC_SIZE_CLASSES,
+      PERF_ALLOC_SIZE_CLASSES);
+
+  gst_object_unref (allocator);
+}
+GST_END_TEST;
+
+GST_START_TEST (test_perf_qti_allocator_size_classes)
+{
+  GstAllocator *allocator = NULL;
+  GstAllocationParams params;
+  GstQtiAllocatorStats stats = { 0, };
+  GstMemory *memory = NULL;
+  guint idx = 0, round = 0, num = 0;
+
+  allocator = gst_qti_allocator_new (GST_FD_MEMORY_FLAG_NONE);
+  fail_unless (allocator != NULL);
+
+  gst_allocation_params_init (&params);
+
+  // Every start uses a different set of sizes, as after a resolution change.
+  // Size classes are released on stop, so each set must be recycled again.
+  for (round = 0; round < 3; round++) {
+    gst_qti_allocator_start (GST_QTI_ALLOCATOR (allocator), 0);
+
+    for (idx = 0; idx < PERF_ALLOC_SIZE_CLASSES; idx++) {
+      gsize size = (round * PERF_ALLOC_SIZE_CLASSES + idx + 1) * 4096;
+
+      for (num = 0; num < 2; num++) {
+        memory = gst_allocator_alloc (allocator, size, &params);
+        fail_unless (memory != NULL);
+        gst_memory_unref (memory);
+      }
+    }
+
+    gst_qti_allocator_get_stats (GST_QTI_ALLOCATOR (allocator), &stats);
+
+    fail_unless_equals_uint64 (stats.hits, PERF_ALLOC_SIZE_CLASSES);
+    fail_unless_equals_uint64 (stats.misses, PERF_ALLOC_SIZE_CLASSES);
+
+    gst_qti_allocator_stop (GST_QTI_ALLOCATOR (allocator));
+
+    // Recycled memory blocks are freed on stop.
+    gst_qti_allocator_get_stats (GST_QTI_ALLOCATOR (allocator), &stats);
+    fail_unless_equals_int (stats.n_allocated, 0);
+  }
+
+  gst_object_unref (allocator);
+}
+GST_END_TEST;
+
+GST_START_TEST (test_perf_video_normalize_f32)
+{
+  GstVideoConvEngine *engine = NULL;
+  GstVideoBlit blit = GST_VCE_BLIT_INIT;
+  GstVideoComposition composition = GST_VCE_COMPOSITION_INIT;
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame vframe;
+  GstBuffer *inbuffer = NULL, *outbuffer = NULL;
+  gdouble offsets[GST_VCE_MAX_CHANNELS] = { 0.485, 0.456, 0.406, 0.0 };
+  gdouble scales[GST_VCE_MAX_CHANNELS] = { 4.367, 4.464, 4.444, 1.0 };
+  gsize n_elements =
+      PERF_TENSOR_WIDTH * PERF_TENSOR_HEIGHT * PERF_TENSOR_CHANNELS;
+  guint8 *pixels = NULL;
+  gfloat *reference = NULL;
+  gint64 start = 0, twopass = 0, fused = 0;
+  gint run = 0;
+  gsize idx = 0;
+
+  if ((engine = perf_converter_engine_new ()) == NULL) {
+    g_print ("normalize_f32 skipped, no OpenCV or FastCV converter\n");
+    return;
+  }
+
+  pixels = perf_random_data (n_elements, 0x5EED);
+  reference = g_new (gfloat, n_elements);
+
+  for (idx = 0; idx < n_elements; idx++) {
+    gdouble value = pixels[idx] * (1.0 / G_MAXUINT8);
+
+    reference[idx] = (value - offsets[idx % PERF_TENSOR_CHANNELS]) *
+        scales[idx % PERF_TENSOR_CHANNELS];
+  }
+
+  gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_RGB,
+      PERF_TENSOR_WIDTH, PERF_TENSOR_HEIGHT);
+
+  inbuffer = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&ininfo), NULL);
+  gst_buffer_fill (inbuffer, 0, pixels, n_elements);
+
+  // Tensor layout, same pixels as the input but with FLOAT32 elements.
+  outinfo = ininfo;
+  GST_VIDEO_INFO_PLANE_STRIDE (&outinfo, 0) *= sizeof (gfloat);
+  GST_VIDEO_INFO_SIZE (&outinfo) *= sizeof (gfloat);
+
+  outbuffer =
+      gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&outinfo), NULL);
+
+  blit.buffer = inbuffer;
+  blit.info = &ininfo;
+
+  composition.blits = &blit;
+  composition.n_blits = 1;
+  composition.buffer = outbuffer;
+
+  // Separate pass, UINT8 blit into the front of the tensor which is then
+  // normalized in place.
+  composition.info = &ininfo;
+  composition.datatype = GST_VCE_DATA_TYPE_U8;
+
+  start = g_get_monotonic_time ();
+
+  for (run = 0; run < n_runs; run++) {
+    fail_unless (gst_video_converter_engine_compose (engine, &composition, 1,
+        NULL), "Blit failed");
+
+    fail_unless (gst_video_frame_map (&vframe, &ininfo, outbuffer,
+        GST_MAP_READWRITE));
+    fail_unless (gst_video_frame_normalize_ip (&vframe, GST_VCE_DATA_TYPE_F32,
+        offsets, scales), "Normalization failed");
+    gst_video_frame_unmap (&vframe);
+  }
+
+  twopass = g_get_monotonic_time () - start;
+
+  perf_check_normalized (outbuffer, reference, n_elements);
+  gst_buffer_memset (outbuffer, 0, 0, GST_VIDEO_INFO_SIZE (&outinfo));
+
+  // Fused, the converter normalizes each band while it is still in cache.
+  composition.info = &outinfo;
+  composition.datatype = GST_VCE_DATA_TYPE_F32;
+
+  for (idx = 0; idx < GST_VCE_MAX_CHANNELS; idx++) {
+    composition.offsets[idx] = offsets[idx];
+    composition.scales[idx] = scales[idx];
+  }
+
+  start = g_get_monotonic_time ();
+
+  for (run = 0; run < n_runs; run++)
+    fail_unless (gst_video_converter_engine_compose (engine, &composition, 1,
+        NULL), "Fused composition failed");
+
+  fused = g_get_monotonic_time () - start;
+
+  perf_check_normalized (outbuffer, reference, n_elements);
+
+  perf_report ("normalize_f32 two-pass", twopass,
+      n_elements * (1 + sizeof (gfloat)));
+  perf_report ("normalize_f32 fused", fused,
+      n_elements * (1 + sizeof (gfloat)));
+
+  gst_buffer_unref (outbuffer);
+  gst_buffer_unref (inbuffer);
+
+  g_free (reference);
+  g_free (pixels);
+
+  gst_video_converter_engine_free (engine);
+}
+GST_END_TEST;
+
+static void
+perf_converter_compose (GstVideoConvEngine * engine, const gchar * name,
+    GstBuffer * inbuffer, GstVideoInfo * ininfo, GstBuffer * outbuffer,
+    GstVideoInfo * outinfo)
+{
+  GstVideoBlit blit = GST_VCE_BLIT_INIT;
+  GstVideoComposition composition = GST_VCE_COMPOSITION_INIT;
+  gint64 start = 0;
+  gint run = 0;
+
+  blit.buffer = inbuffer;
+  blit.info = ininfo;
+
+  composition.blits = &blit;
+  composition.n_blits = 1;
+  composition.buffer = outbuffer;
+  composition.info = outinfo;
+
+  start = g_get_monotonic_time ();
+
+  for (run = 0; run < n_runs; run++)
+    fail_unless (gst_video_converter_engine_compose (engine, &composition, 1,
+        NULL), "Composition failed for %s", name);
+
+  perf_report (name, g_get_monotonic_time () - start,
+      GST_VIDEO_INFO_SIZE (ininfo) + GST_VIDEO_INFO_SIZE (outinfo));
+}
+
+GST_START_TEST (test_perf_video_converter_tiles)
+{
+  // Input and output dimensions, downscale, upscale and same size.
+  const guint dimensions[][4] = {
+    { 1920, 1080, 640, 360 },
+    { 640, 360, 1920, 1080 },
+    { 1280, 720, 1280, 720 },
+  };
+  GEnumClass *eclass = NULL;
+  GEnumValue *evalue = NULL;
+  GstStructure *settings = NULL;
+  GstVideoConvEngine *single = NULL, *tiled = NULL;
+  GstVideoInfo ininfo, outinfo;
+  GstBuffer *inbuffer = NULL, *l_outbuffer = NULL, *r_outbuffer = NULL;
+  GstMapInfo l_map, r_map;
+  guint8 *pixels = NULL;
+  gchar *name = NULL;
+  guint idx = 0;
+  gsize offset = 0;
+
+  eclass = g_type_class_ref (GST_TYPE_VCE_BACKEND);
+  evalue = g_enum_get_value_by_nick (eclass, "ocv");
+
+  if (evalue == NULL) {
+    g_print ("converter tiles skipped, no OpenCV converter\n");
+    g_type_class_unref (eclass);
+    return;
+  }
+
+  settings = gst_structure_new ("options",
+      GST_VCE_OPT_OCV_N_THREADS, G_TYPE_UINT, 1, NULL);
+  single = gst_video_converter_engine_new (evalue->value, settings);
+
+  gst_structure_set (settings, GST_VCE_OPT_OCV_N_THREADS, G_TYPE_UINT,
+      PERF_CONVERTER_THREADS, NULL);
+  tiled = gst_video_converter_engine_new (evalue->value, settings);
+
+  gst_structure_free (settings);
+  g_type_class_unref (eclass);
+
+  fail_unless ((single != NULL) && (tiled != NULL));
+
+  for (idx = 0; idx < G_N_ELEMENTS (dimensions); idx++) {
+    gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_NV12,
+        dimensions[idx][0], dimensions[idx][1]);
+    gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_RGB,
+        dimensions[idx][2], dimensions[idx][3]);
+
+    pixels = perf_random_data (GST_VIDEO_INFO_SIZE (&ininfo), 0x5EED + idx);
+
+    inbuffer = gst_buffer_new_wrapped (pixels, GST_VIDEO_INFO_SIZE (&ininfo));
+    l_outbuffer =
+        gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&outinfo), NULL);
+    r_outbuffer =
+        gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&outinfo), NULL);
+
+    name = g_strdup_printf ("ocv %ux%u -> %ux%u x1", dimensions[idx][0],
+        dimensions[idx][1], dimensions[idx][2], dimensions[idx][3]);
+    perf_converter_compose (single, name, inbuffer, &ininfo, l_outbuffer,
+        &outinfo);
+    g_free (name);
+
+    name = g_strdup_printf ("ocv %ux%u -> %ux%u x%u", dimensions[idx][0],
+        dimensions[idx][1], dimensions[idx][2], dimensions[idx][3],
+        PERF_CONVERTER_THREADS);
+    perf_converter_compose (tiled, name, inbuffer, &ininfo, r_outbuffer,
+        &outinfo);
+    g_free (name);
+
+    fail_unless (gst_buffer_map (l_outbuffer, &l_map, GST_MAP_READ));
+    fail_unless (gst_buffer_map (r_outbuffer, &r_map, GST_MAP_READ));
+
+    // Output with multiple threads must not differ from the single threaded.
+    for (offset = 0; offset < l_map.size; offset++) {
+      if (l_map.data[offset] != r_map.data[offset])
+        break;
+    }
+
+    fail_unless (offset == l_map.size,
+        "%ux%u -> %ux%u: Mismatch in row %" G_GSIZE_FORMAT,
+        dimensions[idx][0], dimensions[idx][1], dimensions[idx][2],
+        dimensions[idx][3], offset / GST_VIDEO_INFO_PLANE_STRIDE (&outinfo, 0));
+
+    gst_buffer_unmap (r_outbuffer, &r_map);
+    gst_buffer_unmap (l_outbuffer, &l_map);
+
+    gst_buffer_unref (r_outbuffer);
+    gst_buffer_unref (l_outbuffer);
+    gst_buffer_unref (inbuffer);
+  }
+
+  gst_video_converter_engine_free (tiled);
+  gst_video_converter_engine_free (single);
+}
+GST_END_TEST;
+
+GST_START_TEST (test_perf_ml_quantize)
+{
+  const GstMLType types[] = {
+    GST_ML_TYPE_INT8, GST_ML_TYPE_UINT8, GST_ML_TYPE_INT16,
+    GST_ML_TYPE_UINT16, GST_ML_TYPE_INT32, GST_ML_TYPE_FLOAT16,
+  };
+  gsize n_elements = PERF_QUANTIZE_ELEMENTS;
+  guint8 *tensor = NULL, *output = NULL;
+  gfloat *values = NULL;
+  gint64 start = 0, dequantize = 0, quantize = 0;
+  gfloat scale = 0.0F, offset = 0.0F;
+  gchar *name = NULL;
+  guint idx = 0, size = 0;
+  gint run = 0;
+
+  tensor = g_malloc (n_elements * sizeof (gint32));
+  output = g_malloc (n_elements * sizeof (gint32));
+  values = g_new (gfloat, n_elements);
+
+  for (idx = 0; idx < G_N_ELEMENTS (types); idx++) {
+    size = gst_ml_type_get_size (types[idx]);
+
+    perf_fill_tensor (types[idx], tensor, n_elements);
+
+    // Half precision elements are only converted, without quantization.
+    scale = (types[idx] == GST_ML_TYPE_FLOAT16) ? 1.0F : 0.5F;
+    offset = (types[idx] == GST_ML_TYPE_FLOAT16) ? 0.0F : 3.0F;
+
+    start = g_get_monotonic_time ();
+
+    for (run = 0; run < n_runs; run++)
+      gst_ml_dequantize (types[idx], tensor, values, n_elements, scale, offset);
+
+    dequantize = g_get_monotonic_time () - start;
+    start = g_get_monotonic_time ();
+
+    for (run = 0; run < n_runs; run++)
+      gst_ml_quantize (types[idx], values, output, n_elements, scale, offset);
+
+    quantize = g_get_monotonic_time () - start;
+
+    // The round trip must restore the original elements.
+    fail_unless (memcmp (tensor, output, n_elements * size) == 0,
+        "Round trip mismatch for %s", gst_ml_type_to_string (types[idx]));
+
+    name = g_strdup_printf ("dequantize %s",
+        gst_ml_type_to_string (types[idx]));
+    perf_report (name, dequantize, n_elements * (size + sizeof (gfloat)));
+    g_free (name);
+
+    name = g_strdup_printf ("quantize %s", gst_ml_type_to_string (types[idx]));
+    perf_report (name, quantize, n_elements * (size + sizeof (gfloat)));
+    g_free (name);
+  }
+
+  // Halfway values must round to even in both the block and the scalar tail.
+  for (idx = 0; idx < PERF_QUANTIZE_HALFWAY; idx++)
+    values[idx] = idx + 0.5F;
+
+  gst_ml_quantize (GST_ML_TYPE_UINT8, values, output, PERF_QUANTIZE_HALFWAY,
+      1.0F, 0.0F);
+
+  for (idx = 0; idx < PERF_QUANTIZE_HALFWAY; idx++) {
+    fail_unless (output[idx] == ((idx + 1) & ~1U),
+        "Element %u rounded to %u", idx, output[idx]);
+  }
+
+  g_free (values);
+  g_free (output);
+  g_free (tensor);
+}
+GST_END_TEST;
+
+static Suite *
+perf_suite (GList **tcnames, gint iteration, gint duration)
+{
+  Suite *s = suite_create ("perf");
+  TCase *tc;
+  gchar *tcname = NULL;
+  int start = 0, end = 1;
+  // TCase timeout in seconds.
+  int tctimeout = 60;
+
+  if (iteration > 0)
+    end = iteration;
+
+  tcname = "video_normalize_f32";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase fused normalization.
+  tcase_add_loop_test (tc, test_perf_video_normalize_f32, start, end);
+
+  tcname = "video_converter_tiles";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase tiled scaling against single threaded output.
+  tcase_add_loop_test (tc, test_perf_video_converter_tiles, start, end);
+
+  tcname = "ml_quantize";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase (de)quantization throughput.
+  tcase_add_loop_test (tc, test_perf_ml_quantize, start, end);
+
+  tcname = "qti_allocator";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase allocator stress with multiple threads and sizes.
+  tcase_add_loop_test (tc, test_perf_qti_allocator, start, end);
+
+  tcname = "qti_allocator_size_classes";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase size class release on allocator stop.
+  tcase_add_loop_test (tc, test_perf_qti_allocator_size_classes, start, end);
+
+  return s;
+}
+
+void gst_plugin_get_perf_suite (GstPluginSuite* psuite)
+{
+  if (psuite == NULL)
+    return;
+
+  psuite->name = "perf";
+  psuite->suite = perf_suite (&psuite->tcnames,
+      psuite->iteration, psuite->duration);
+}
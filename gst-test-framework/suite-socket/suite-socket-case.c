@@ -0,0 +1,1364 @@
+/*
+ * Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ * SPDX-License-Identifier: BSD-3-Clause-Clear
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include <gst/allocators/allocators.h>
+#include <gst/video/gstvideometa.h>
+#include <gst/video/gstvideoclassificationmeta.h>
+#include <gst/video/gstvideolandmarksmeta.h>
+#include <gst/video/video-utils.h>
+
+#include "qtifdsocket.h"
+#include "qtimetaring.h"
+#include "plugin-suite.h"
+
+// Size of the text sent as sized data payload, larger than the text payload.
+#define SOCKET_DATA_SIZE      4096
+// Number of clients and buffers used for the fan-out test.
+#define SOCKET_N_CLIENTS      3
+#define SOCKET_N_BUFFERS      16
+// Number of buffers pushed at most while waiting for the clients.
+#define SOCKET_N_PROBES       100
+// Number of frames and of frames held at most by the slow clients.
+#define SOCKET_N_FRAMES       6
+#define SOCKET_QUEUE_DEPTH    2
+// Dimensions of the GRAY8 frames passed as FD memory.
+#define SOCKET_FRAME_WIDTH    64
+#define SOCKET_FRAME_HEIGHT   64
+// Size of the metadata ring data area and of the records written into it.
+#define SOCKET_RING_SIZE      1024
+#define SOCKET_RECORD_SIZE    300
+// Number of messages published through the mock REDIS service.
+#define SOCKET_REDIS_MESSAGES 3
+// Offset of the low byte of the timestamp in the MessagePack payload.
+#define SOCKET_REDIS_TS_BYTE  13
+
+static void
+socket_payload_info_init (GstPayloadInfo * pl_info, gint * fds)
+{
+  memset (pl_info, 0, sizeof (GstPayloadInfo));
+
+  pl_info->fds = fds;
+  pl_info->mem_block_info = g_ptr_array_new_with_free_func (g_free);
+  pl_info->protection_metadata_info = g_ptr_array_new_with_free_func (g_free);
+  pl_info->roi_meta_info = g_ptr_array_new_with_free_func (g_free);
+  pl_info->class_meta_info = g_ptr_array_new_with_free_func (g_free);
+  pl_info->lm_meta_info = g_ptr_array_new_with_free_func (g_free);
+}
+
+// Size of the next datagram, without waiting and without consuming it.
+static gssize
+socket_peek_datagram (gint sock)
+{
+  return recv (sock, NULL, 0, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT);
+}
+
+// Connect to a listening socket sink and announce the protocol version and
+// the buffer delivery preferences.
+static gint
+socket_client_connect (const gchar * path, guint queue_depth,
+    GstSocketDropPolicy policy)
+{
+  GstPayloadInfo pl_info = { 0, };
+  GstVersionPayload header = { .identity = MESSAGE_HEADER,
+      .version = GST_SOCKET_PROTOCOL_VERSION };
+  GstVersionPayload hello = { .identity = MESSAGE_HELLO,
+      .version = GST_SOCKET_PROTOCOL_VERSION };
+  GstClientConfigPayload config = { .identity = MESSAGE_CLIENT_CONFIG,
+      .queue_depth = queue_depth, .drop_policy = policy };
+  struct sockaddr_un address = { 0, };
+  gint sock = -1;
+
+  sock = socket (AF_UNIX, SOCK_SEQPACKET, 0);
+  fail_unless (sock >= 0);
+
+  address.sun_family = AF_UNIX;
+  g_strlcpy (address.sun_path, path, sizeof (address.sun_path));
+
+  fail_unless (connect (sock, (struct sockaddr *) &address,
+      sizeof (address)) == 0);
+
+  pl_info.header = &header;
+  pl_info.hello = &hello;
+  pl_info.client_config = &config;
+
+  fail_unless (send_socket_message (sock, &pl_info) > 0);
+
+  return sock;
+}
+
+// Text of the next received buffer, NULL if nothing arrived in time.
+static gchar *
+socket_client_receive_text (gint sock, gint timeout)
+{
+  GstPayloadInfo pl_info;
+  struct pollfd pfd = { .fd = sock, .events = POLLIN };
+  gpointer payload = NULL;
+  gchar *text = NULL;
+
+  if (poll (&pfd, 1, timeout) <= 0)
+    return NULL;
+
+  socket_payload_info_init (&pl_info, NULL);
+
+  if ((receive_socket_message (sock, &pl_info, MSG_DONTWAIT) > 0) &&
+      (pl_info.mem_block_info->len == 1)) {
+    payload = g_ptr_array_index (pl_info.mem_block_info, 0);
+
+    if (GST_SOCKET_MSG_IDENTITY (payload) == MESSAGE_TEXT) {
+      GstTextPayload *text_pl = payload;
+      text = g_strndup (text_pl->contents, text_pl->size);
+    } else if (GST_SOCKET_MSG_IDENTITY (payload) == MESSAGE_DATA) {
+      GstDataPayload *data_pl = payload;
+      text = g_strndup ((const gchar *) data_pl->contents, data_pl->size);
+    }
+  }
+
+  free_pl_struct (&pl_info);
+  return text;
+}
+
+// Every odd buffer exceeds the text payload and is sent as sized data.
+static gchar *
+socket_buffer_text (guint num)
+{
+  gchar *padding = NULL, *text = NULL;
+
+  padding = g_strnfill ((num % 2) ? SOCKET_DATA_SIZE : 0, 'x');
+  text = g_strdup_printf ("buffer %u %s", num, padding);
+
+  g_free (padding);
+  return text;
+}
+
+static void
+socket_push_text (GstHarness * h, gchar * text)
+{
+  GstBuffer *buffer = gst_buffer_new_wrapped (text, strlen (text));
+  fail_unless_equals_int (gst_harness_push (h, buffer), GST_FLOW_OK);
+}
+
+// Records with contents derived from their position, to detect overwrites.
+static void
+socket_record_fill (guint8 * record, guint32 position)
+{
+  guint idx = 0;
+
+  for (idx = 0; idx < SOCKET_RECORD_SIZE; idx++)
+    record[idx] = (position + idx) % 251;
+}
+
+static void
+socket_record_check (const guint8 * record, guint32 position)
+{
+  guint idx = 0;
+
+  fail_unless (record != NULL);
+
+  for (idx = 0; idx < SOCKET_RECORD_SIZE; idx++)
+    fail_unless_equals_int (record[idx], (position + idx) % 251);
+}
+
+static GstVideoRegionOfInterestMeta *
+socket_add_roi_meta (GstBuffer * buffer, const gchar * label, guint id,
+    GstStructure * detection, GstStructure * xtraparams)
+{
+  GstVideoRegionOfInterestMeta *roimeta = NULL;
+
+  roimeta = gst_buffer_add_video_region_of_interest_meta (buffer, label,
+      10 * id, 20 * id, 30 + id, 40 + id);
+
+  roimeta->id = id;
+  roimeta->parent_id = -1;
+
+  gst_video_region_of_interest_meta_add_param (roimeta, detection);
+
+  if (xtraparams != NULL)
+    gst_video_region_of_interest_meta_add_param (roimeta, xtraparams);
+
+  return roimeta;
+}
+
+static void
+socket_check_roi_meta (GstVideoRegionOfInterestMeta * expected,
+    GstVideoRegionOfInterestMeta * roimeta)
+{
+  const gchar *names[] = { "ObjectDetection", "xtraparams" };
+  const GstStructure *l_param = NULL, *r_param = NULL;
+  guint idx = 0;
+
+  fail_unless_equals_int (roimeta->id, expected->id);
+  fail_unless_equals_int (roimeta->parent_id, expected->parent_id);
+  fail_unless_equals_string (g_quark_to_string (roimeta->roi_type),
+      g_quark_to_string (expected->roi_type));
+  fail_unless_equals_int (roimeta->x, expected->x);
+  fail_unless_equals_int (roimeta->y, expected->y);
+  fail_unless_equals_int (roimeta->w, expected->w);
+  fail_unless_equals_int (roimeta->h, expected->h);
+
+  for (idx = 0; idx < G_N_ELEMENTS (names); idx++) {
+    l_param = gst_video_region_of_interest_meta_get_param (expected, names[idx]);
+    r_param = gst_video_region_of_interest_meta_get_param (roimeta, names[idx]);
+
+    fail_unless ((l_param == NULL) == (r_param == NULL));
+    fail_unless ((l_param == NULL) || gst_structure_is_equal (l_param, r_param),
+        "Param %s differs!", names[idx]);
+  }
+}
+
+static void
+socket_check_classification_meta (GstVideoClassificationMeta * expected,
+    GstVideoClassificationMeta * classmeta)
+{
+  GstClassLabel *l_label = NULL, *r_label = NULL;
+  guint idx = 0;
+
+  fail_unless_equals_int (classmeta->id, expected->id);
+  fail_unless_equals_int (classmeta->parent_id, expected->parent_id);
+  fail_unless_equals_int (classmeta->labels->len, expected->labels->len);
+
+  for (idx = 0; idx < expected->labels->len; idx++) {
+    l_label = &(g_array_index (expected->labels, GstClassLabel, idx));
+    r_label = &(g_array_index (classmeta->labels, GstClassLabel, idx));
+
+    fail_unless_equals_int (r_label->name, l_label->name);
+    fail_unless_equals_float (r_label->confidence, l_label->confidence);
+    fail_unless_equals_int (r_label->color, l_label->color);
+    fail_unless ((l_label->xtraparams == NULL) == (r_label->xtraparams == NULL));
+    fail_unless ((l_label->xtraparams == NULL) ||
+        gst_structure_is_equal (l_label->xtraparams, r_label->xtraparams));
+  }
+}
+
+static void
+socket_check_landmarks_meta (GstVideoLandmarksMeta * expected,
+    GstVideoLandmarksMeta * lmkmeta)
+{
+  GstVideoKeypoint *l_kp = NULL, *r_kp = NULL;
+  GstVideoKeypointLink *l_link = NULL, *r_link = NULL;
+  guint idx = 0;
+
+  fail_unless_equals_int (lmkmeta->id, expected->id);
+  fail_unless_equals_int (lmkmeta->parent_id, expected->parent_id);
+  fail_unless_equals_float (lmkmeta->confidence, expected->confidence);
+  fail_unless_equals_int (lmkmeta->keypoints->len, expected->keypoints->len);
+  fail_unless_equals_int (lmkmeta->links->len, expected->links->len);
+
+  for (idx = 0; idx < expected->keypoints->len; idx++) {
+    l_kp = &(g_array_index (expected->keypoints, GstVideoKeypoint, idx));
+    r_kp = &(g_array_index (lmkmeta->keypoints, GstVideoKeypoint, idx));
+
+    fail_unless_equals_int (r_kp->name, l_kp->name);
+    fail_unless_equals_float (r_kp->confidence, l_kp->confidence);
+    fail_unless_equals_int (r_kp->color, l_kp->color);
+    fail_unless_equals_int (r_kp->x, l_kp->x);
+    fail_unless_equals_int (r_kp->y, l_kp->y);
+  }
+
+  for (idx = 0; idx < expected->links->len; idx++) {
+    l_link = &(g_array_index (expected->links, GstVideoKeypointLink, idx));
+    r_link = &(g_array_index (lmkmeta->links, GstVideoKeypointLink, idx));
+
+    fail_unless_equals_int (r_link->s_kp_idx, l_link->s_kp_idx);
+    fail_unless_equals_int (r_link->d_kp_idx, l_link->d_kp_idx);
+  }
+
+  fail_unless ((expected->xtraparams == NULL) == (lmkmeta->xtraparams == NULL));
+  fail_unless ((expected->xtraparams == NULL) ||
+      gst_structure_is_equal (expected->xtraparams, lmkmeta->xtraparams));
+}
+
+// Listening socket, as opened by a socket source for a socket sink.
+static gint
+socket_server_listen (const gchar * path)
+{
+  struct sockaddr_un address = { 0, };
+  gint sock = -1;
+
+  sock = socket (AF_UNIX, SOCK_SEQPACKET, 0);
+  fail_unless (sock >= 0);
+
+  address.sun_family = AF_UNIX;
+  g_strlcpy (address.sun_path, path, sizeof (address.sun_path));
+
+  unlink (path);
+  fail_unless (bind (sock, (struct sockaddr *) &address,
+      sizeof (address)) == 0);
+  fail_unless (listen (sock, 1) == 0);
+
+  return sock;
+}
+
+static gint
+socket_server_accept (gint sock, gint timeout)
+{
+  struct pollfd pfd = { .fd = sock, .events = POLLIN };
+
+  fail_unless (poll (&pfd, 1, timeout) > 0, "Socket sink did not connect!");
+  return accept (sock, NULL, NULL);
+}
+
+// Receive the next buffer message, FALSE if nothing arrived in time.
+static gboolean
+socket_peer_receive (gint sock, GstPayloadInfo * pl_info, gint * fds,
+    gint timeout)
+{
+  struct pollfd pfd = { .fd = sock, .events = POLLIN };
+
+  if (poll (&pfd, 1, timeout) <= 0)
+    return FALSE;
+
+  socket_payload_info_init (pl_info, fds);
+
+  if ((receive_socket_message (sock, pl_info, MSG_DONTWAIT) > 0) &&
+      (pl_info->buffer_info != NULL))
+    return TRUE;
+
+  free_pl_struct (pl_info);
+  return FALSE;
+}
+
+// Close the passed FDs and return the buffer, as a socket source does.
+static void
+socket_peer_return (gint sock, GstPayloadInfo * pl_info, guint version)
+{
+  GstPayloadInfo ret_info = { 0, };
+  GstVersionPayload header = { .identity = MESSAGE_HEADER, .version = version };
+  GstReturnBufferPayload ret_pl = { .identity = MESSAGE_RETURN_BUFFER };
+  GstFdCountPayload fd_count = { .identity = MESSAGE_FD_COUNT, .n_fds = 1 };
+  gint idx = 0;
+
+  for (idx = 0; idx < GST_PL_INFO_GET_N_FDS (pl_info); idx++)
+    close (pl_info->fds[idx]);
+
+  ret_pl.buf_id[0] = pl_info->buffer_info->buf_id[0];
+
+  ret_info.return_buffer = &ret_pl;
+  ret_info.fd_count = &fd_count;
+  ret_info.header = (version >= 2) ? &header : NULL;
+
+  fail_unless (send_socket_message (sock, &ret_info) > 0);
+}
+
+static GstMemory *
+socket_fd_memory (GstAllocator * allocator)
+{
+  gsize size = SOCKET_FRAME_WIDTH * SOCKET_FRAME_HEIGHT;
+  gint fd = -1;
+
+  fd = memfd_create ("qti-socket-frame", MFD_CLOEXEC);
+  fail_unless (fd >= 0);
+  fail_unless (ftruncate (fd, size) == 0);
+
+  return gst_fd_allocator_alloc (allocator, fd, size, GST_FD_MEMORY_FLAG_NONE);
+}
+
+static GstBuffer *
+socket_fd_buffer (GstMemory * memory)
+{
+  GstBuffer *buffer = gst_buffer_new ();
+
+  gst_buffer_append_memory (buffer, gst_memory_ref (memory));
+  gst_buffer_add_video_meta (buffer, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_GRAY8, SOCKET_FRAME_WIDTH, SOCKET_FRAME_HEIGHT);
+
+  return buffer;
+}
+
+// Wait until the socket sink released its references to the buffer.
+static gboolean
+socket_buffer_released (GstBuffer * buffer)
+{
+  guint num = 0;
+
+  for (num = 0; (num < SOCKET_N_PROBES) &&
+       (GST_MINI_OBJECT_REFCOUNT_VALUE (buffer) > 1); num++)
+    g_usleep (10000);
+
+  return GST_MINI_OBJECT_REFCOUNT_VALUE (buffer) == 1;
+}
+
+static GstHarness *
+socket_sink_harness (const gchar * path, gboolean listen)
+{
+  GstHarness *h = NULL;
+  gchar *description = NULL, *caps = NULL;
+
+  description = g_strdup_printf ("qtisocketsink socket=%s listen=%s", path,
+      listen ? "true" : "false");
+  caps = g_strdup_printf ("video/x-raw,format=GRAY8,width=%u,height=%u,"
+      "framerate=30/1", SOCKET_FRAME_WIDTH, SOCKET_FRAME_HEIGHT);
+
+  h = gst_harness_new_parse (description);
+  gst_harness_set_src_caps_str (h, caps);
+
+  g_free (caps);
+  g_free (description);
+
+  return h;
+}
+
+// Read exactly 'size' bytes from a stream socket.
+static gboolean
+socket_stream_read (gint sock, guint8 * data, gsize size, gint timeout)
+{
+  struct pollfd pfd = { .fd = sock, .events = POLLIN };
+  gssize length = 0;
+  gsize offset = 0;
+
+  while (offset < size) {
+    if (poll (&pfd, 1, timeout) <= 0)
+      return FALSE;
+
+    if ((length = recv (sock, data + offset, size - offset, 0)) <= 0)
+      return FALSE;
+
+    offset += length;
+  }
+
+  return TRUE;
+}
+
+// MessagePack encoding of the metas attached by socket_redis_buffer().
+static const guint8 socket_redis_payload[] = {
+  0x84,
+  0xA9, 't', 'i', 'm', 'e', 's', 't', 'a', 'm', 'p',
+  0xCD, 0x03, 0xE8,
+  0xA4, 'r', 'o', 'i', 's',
+  0x91,
+  // [id, parent-id, label, x, y, width, height, confidence]
+  0x98, 0x01, 0xFF, 0xA6, 'p', 'e', 'r', 's', 'o', 'n',
+  0x0A, 0x14, 0x1F, 0x29, 0xCA, 0x42, 0xAF, 0x00, 0x00,
+  0xAF, 'c', 'l', 'a', 's', 's', 'i', 'f', 'i', 'c', 'a', 't', 'i', 'o', 'n',
+  's',
+  0x90,
+  0xA9, 'l', 'a', 'n', 'd', 'm', 'a', 'r', 'k', 's',
+  0x91,
+  // [id, parent-id, confidence, keypoints, links]
+  0x95, 0x04, 0x01, 0xCA, 0x42, 0x84, 0x00, 0x00,
+  0x92,
+  // [name, x, y, confidence], positions are floats.
+  0x94, 0xA4, 'n', 'o', 's', 'e', 0xCA, 0x42, 0xC8, 0x00, 0x00,
+  0xCA, 0xC1, 0x20, 0x00, 0x00, 0xCA, 0x42, 0x48, 0x00, 0x00,
+  0x94, 0xA3, 'e', 'y', 'e', 0xCA, 0x42, 0xCA, 0x00, 0x00,
+  0xCA, 0x41, 0x20, 0x00, 0x00, 0xCA, 0x42, 0x4C, 0x00, 0x00,
+  0x91, 0x92, 0x00, 0x01,
+};
+
+static GstBuffer *
+socket_redis_buffer (guint num)
+{
+  GstBuffer *buffer = gst_buffer_new ();
+  GstVideoRegionOfInterestMeta *roimeta = NULL;
+  GstVideoLandmarksMeta *lmkmeta = NULL;
+  GArray *keypoints = NULL, *links = NULL;
+  GstVideoKeypoint *kp = NULL;
+  GstVideoKeypointLink *link = NULL;
+
+  GST_BUFFER_TIMESTAMP (buffer) = 1000 + num;
+
+  roimeta = socket_add_roi_meta (buffer, "person", 1,
+      gst_structure_new ("ObjectDetection",
+          "confidence", G_TYPE_DOUBLE, 87.5, NULL),
+      NULL);
+
+  keypoints = g_array_sized_new (FALSE, TRUE, sizeof (GstVideoKeypoint), 2);
+  g_array_set_size (keypoints, 2);
+
+  kp = &(g_array_index (keypoints, GstVideoKeypoint, 0));
+  kp->name = g_quark_from_string ("nose");
+  kp->confidence = 50.0;
+  kp->x = 100;
+  kp->y = -10;
+
+  kp = &(g_array_index (keypoints, GstVideoKeypoint, 1));
+  kp->name = g_quark_from_string ("eye");
+  kp->confidence = 51.0;
+  kp->x = 101;
+  kp->y = 10;
+
+  links = g_array_sized_new (FALSE, TRUE, sizeof (GstVideoKeypointLink), 1);
+  g_array_set_size (links, 1);
+
+  link = &(g_array_index (links, GstVideoKeypointLink, 0));
+  link->s_kp_idx = 0;
+  link->d_kp_idx = 1;
+
+  lmkmeta = gst_buffer_add_video_landmarks_meta (buffer, 66.0,
+      keypoints, links);
+  lmkmeta->id = 4;
+  lmkmeta->parent_id = roimeta->id;
+
+  return buffer;
+}
+
+GST_START_TEST (test_socket_v2_framing)
+{
+  GstPayloadInfo pl_info = { 0, };
+  GstVersionPayload header = { .identity = MESSAGE_HEADER, .version = 2 };
+  GstRegisterFdsPayload register_fds = { .identity = MESSAGE_REGISTER_FDS };
+  GstFdCountPayload fd_count = { .identity = MESSAGE_FD_COUNT, .n_fds = 1 };
+  GstBufferPayload buffer_pl = { .identity = MESSAGE_BUFFER_INFO };
+  GstDataPayload *data_pl = NULL;
+  gint sockets[2] = { -1, -1 }, pipefds[2] = { -1, -1 };
+  gint fds[GST_MAX_MEM_BLOCKS] = { -1, };
+  struct stat sent, received;
+  gssize size = 0;
+  guint idx = 0;
+
+  fail_unless (socketpair (AF_UNIX, SOCK_SEQPACKET, 0, sockets) == 0);
+  fail_unless (pipe (pipefds) == 0);
+
+  // Buffer with one memory block registered under a buffer ID.
+  register_fds.n_ids = 1;
+  register_fds.buf_id[0] = GST_SOCKET_FD_ID_BASE;
+  buffer_pl.buf_id[0] = GST_SOCKET_FD_ID_BASE;
+  buffer_pl.pts = 42 * GST_MSECOND;
+
+  pl_info.header = &header;
+  pl_info.register_fds = &register_fds;
+  pl_info.fd_count = &fd_count;
+  pl_info.buffer_info = &buffer_pl;
+  pl_info.fds = &pipefds[0];
+
+  fail_unless (send_socket_message (sockets[0], &pl_info) > 0);
+
+  // The whole message is a single datagram, no length prefix is sent.
+  size = socket_peek_datagram (sockets[1]);
+  fail_unless_equals_int (size, sizeof (header) + sizeof (fd_count) +
+      sizeof (register_fds) + sizeof (buffer_pl));
+
+  socket_payload_info_init (&pl_info, fds);
+
+  fail_unless_equals_int (
+      receive_socket_message (sockets[1], &pl_info, MSG_DONTWAIT), size);
+
+  fail_unless (pl_info.header != NULL);
+  fail_unless_equals_int (pl_info.header->version, 2);
+  fail_unless (pl_info.register_fds != NULL);
+  fail_unless_equals_int (pl_info.register_fds->n_ids, 1);
+  fail_unless_equals_int (pl_info.register_fds->buf_id[0],
+      GST_SOCKET_FD_ID_BASE);
+  fail_unless (pl_info.buffer_info != NULL);
+  fail_unless_equals_int (pl_info.buffer_info->buf_id[0],
+      GST_SOCKET_FD_ID_BASE);
+  fail_unless_equals_uint64 (pl_info.buffer_info->pts, 42 * GST_MSECOND);
+  fail_unless_equals_int (GST_PL_INFO_GET_N_FDS (&pl_info), 1);
+
+  // The passed FD refers to the same pipe as the sent one.
+  fail_unless (fstat (pipefds[0], &sent) == 0);
+  fail_unless (fstat (fds[0], &received) == 0);
+  fail_unless_equals_uint64 (sent.st_ino, received.st_ino);
+
+  close (fds[0]);
+  free_pl_struct (&pl_info);
+
+  // Text larger than the text payload is sent with its actual size.
+  data_pl = g_malloc (sizeof (GstDataPayload) + SOCKET_DATA_SIZE);
+  data_pl->identity = MESSAGE_DATA;
+  data_pl->size = SOCKET_DATA_SIZE;
+
+  for (idx = 0; idx < SOCKET_DATA_SIZE; idx++)
+    data_pl->contents[idx] = idx % 251;
+
+  socket_payload_info_init (&pl_info, NULL);
+  pl_info.header = g_new (GstVersionPayload, 1);
+  *(pl_info.header) = header;
+  g_ptr_array_add (pl_info.mem_block_info, data_pl);
+
+  fail_unless (send_socket_message (sockets[0], &pl_info) > 0);
+  free_pl_struct (&pl_info);
+
+  socket_payload_info_init (&pl_info, NULL);
+
+  fail_unless_equals_int (
+      receive_socket_message (sockets[1], &pl_info, MSG_DONTWAIT),
+      sizeof (header) + sizeof (GstDataPayload) + SOCKET_DATA_SIZE);
+  fail_unless_equals_int (pl_info.mem_block_info->len, 1);
+
+  data_pl = g_ptr_array_index (pl_info.mem_block_info, 0);
+  fail_unless_equals_int (data_pl->identity, MESSAGE_DATA);
+  fail_unless_equals_int (data_pl->size, SOCKET_DATA_SIZE);
+
+  for (idx = 0; idx < SOCKET_DATA_SIZE; idx++)
+    fail_unless_equals_int (data_pl->contents[idx], idx % 251);
+
+  free_pl_struct (&pl_info);
+
+  // Nothing is left in the socket.
+  errno = 0;
+  fail_unless (socket_peek_datagram (sockets[1]) < 0);
+  fail_unless_equals_int (errno, EAGAIN);
+
+  close (pipefds[0]);
+  close (pipefds[1]);
+  close (sockets[0]);
+  close (sockets[1]);
+}
+GST_END_TEST;
+
+GST_START_TEST (test_socket_fd_registry)
+{
+  GstPayloadInfo pl_info = { 0, }, hello_info = { 0, };
+  GstVersionPayload hello = { .identity = MESSAGE_HELLO, .version = 2 };
+  GstAllocator *allocator = NULL;
+  GstHarness *h = NULL;
+  GstMemory *memory = NULL;
+  GstBuffer *buffers[2] = { NULL, NULL };
+  gint fds[GST_MAX_MEM_BLOCKS] = { -1, };
+  gchar *path = NULL;
+  gint server = -1, peer = -1, id = 0, idx = 0;
+  gboolean ready = FALSE, found = FALSE;
+  guint num = 0;
+
+  allocator = gst_fd_allocator_new ();
+  path = g_strdup_printf ("%s/qti-socket-fd-registry-%d", g_get_tmp_dir (),
+      getpid ());
+
+  // Version 1 peer, never announces its protocol version.
+  server = socket_server_listen (path);
+  h = socket_sink_harness (path, FALSE);
+  peer = socket_server_accept (server, 5000);
+  fail_unless (peer >= 0);
+
+  memory = socket_fd_memory (allocator);
+  buffers[0] = socket_fd_buffer (memory);
+  buffers[1] = socket_fd_buffer (memory);
+
+  // Buffers are dropped until the sink has finished connecting.
+  for (num = 0; !ready && (num < SOCKET_N_PROBES); num++) {
+    gst_harness_push (h, gst_buffer_ref (buffers[0]));
+    ready = socket_peer_receive (peer, &pl_info, fds, 50);
+  }
+
+  fail_unless (ready, "Socket sink did not send to version 1 peer!");
+
+  // Version 1 framing, the FD itself identifies the memory block.
+  fail_unless (pl_info.header == NULL);
+  fail_unless (pl_info.register_fds == NULL);
+  fail_unless_equals_int (GST_PL_INFO_GET_N_FDS (&pl_info), 1);
+  fail_unless_equals_int (pl_info.buffer_info->buf_id[0],
+      gst_fd_memory_get_fd (memory));
+
+  // Same memory block sent again while held, its FD is passed again.
+  gst_harness_push (h, gst_buffer_ref (buffers[1]));
+  socket_peer_return (peer, &pl_info, 1);
+  free_pl_struct (&pl_info);
+
+  fail_unless (socket_peer_receive (peer, &pl_info, fds, 1000));
+  fail_unless_equals_int (GST_PL_INFO_GET_N_FDS (&pl_info), 1);
+  fail_unless_equals_int (pl_info.buffer_info->buf_id[0],
+      gst_fd_memory_get_fd (memory));
+
+  socket_peer_return (peer, &pl_info, 1);
+  free_pl_struct (&pl_info);
+
+  // Both sends are released once both returns are received.
+  fail_unless (socket_buffer_released (buffers[0]));
+  fail_unless (socket_buffer_released (buffers[1]));
+
+  close (peer);
+  gst_harness_teardown (h);
+  close (server);
+
+  // Version 2 peer, announces its version with version 1 framing.
+  server = socket_server_listen (path);
+  h = socket_sink_harness (path, FALSE);
+  peer = socket_server_accept (server, 5000);
+  fail_unless (peer >= 0);
+
+  hello_info.hello = &hello;
+  fail_unless (send_socket_message (peer, &hello_info) > 0);
+
+  // Frames keep version 1 framing until the HELLO has been processed.
+  for (num = 0, ready = FALSE; !ready && (num < SOCKET_N_PROBES); num++) {
+    GstMemory *probe = socket_fd_memory (allocator);
+
+    gst_harness_push (h, socket_fd_buffer (probe));
+    gst_memory_unref (probe);
+
+    while (socket_peer_receive (peer, &pl_info, fds, 50)) {
+      ready = (pl_info.header != NULL);
+      socket_peer_return (peer, &pl_info, ready ? 2 : 1);
+      free_pl_struct (&pl_info);
+    }
+  }
+
+  fail_unless (ready, "Socket sink did not switch to version 2!");
+
+  // The FD is passed and registered only with the first buffer.
+  gst_harness_push (h, gst_buffer_ref (buffers[0]));
+  fail_unless (socket_peer_receive (peer, &pl_info, fds, 1000));
+
+  fail_unless (pl_info.header != NULL);
+  fail_unless_equals_int (pl_info.header->version, 2);
+  fail_unless (pl_info.register_fds != NULL);
+  fail_unless_equals_int (pl_info.register_fds->n_ids, 1);
+  fail_unless_equals_int (GST_PL_INFO_GET_N_FDS (&pl_info), 1);
+
+  id = pl_info.register_fds->buf_id[0];
+  fail_unless (id >= GST_SOCKET_FD_ID_BASE);
+  fail_unless_equals_int (pl_info.buffer_info->buf_id[0], id);
+
+  // Registry hit, the memory block is sent again only by its ID while the
+  // first buffer is still held by the peer.
+  gst_harness_push (h, gst_buffer_ref (buffers[1]));
+  socket_peer_return (peer, &pl_info, 2);
+  free_pl_struct (&pl_info);
+
+  fail_unless (socket_peer_receive (peer, &pl_info, fds, 1000));
+  fail_unless (pl_info.register_fds == NULL);
+  fail_unless_equals_int (GST_PL_INFO_GET_N_FDS (&pl_info), 0);
+  fail_unless_equals_int (pl_info.buffer_info->buf_id[0], id);
+
+  socket_peer_return (peer, &pl_info, 2);
+  free_pl_struct (&pl_info);
+
+  fail_unless (socket_buffer_released (buffers[0]));
+  fail_unless (socket_buffer_released (buffers[1]));
+
+  // Freed memory block is unregistered with the next buffer.
+  gst_buffer_unref (buffers[0]);
+  gst_buffer_unref (buffers[1]);
+  gst_memory_unref (memory);
+
+  memory = socket_fd_memory (allocator);
+  gst_harness_push (h, socket_fd_buffer (memory));
+
+  fail_unless (socket_peer_receive (peer, &pl_info, fds, 1000));
+  // Released probes may be unregistered together with the memory block.
+  fail_unless (pl_info.unregister_fds != NULL);
+
+  for (idx = 0; idx < pl_info.unregister_fds->n_ids; idx++)
+    found |= (pl_info.unregister_fds->buf_id[idx] == id);
+
+  fail_unless (found, "Buffer ID %d was not unregistered!", id);
+  fail_unless (pl_info.register_fds != NULL);
+  fail_unless (pl_info.register_fds->buf_id[0] != id);
+  fail_unless_equals_int (GST_PL_INFO_GET_N_FDS (&pl_info), 1);
+
+  socket_peer_return (peer, &pl_info, 2);
+  free_pl_struct (&pl_info);
+
+  gst_memory_unref (memory);
+
+  close (peer);
+  gst_harness_teardown (h);
+  close (server);
+  unlink (path);
+
+  gst_object_unref (allocator);
+  g_free (path);
+}
+GST_END_TEST;
+
+GST_START_TEST (test_socket_fan_out)
+{
+  GstHarness *h = NULL;
+  gchar *path = NULL, *description = NULL, *text = NULL, *expected = NULL;
+  gint clients[SOCKET_N_CLIENTS];
+  gboolean received[SOCKET_N_CLIENTS] = { FALSE, };
+  gboolean ready = FALSE;
+  guint idx = 0, num = 0;
+
+  path = g_strdup_printf ("%s/qti-socket-fan-out-%d", g_get_tmp_dir (),
+      getpid ());
+  description = g_strdup_printf ("qtisocketsink socket=%s listen=true", path);
+
+  h = gst_harness_new_parse (description);
+  gst_harness_set_src_caps_str (h, "text/x-raw,format=utf8");
+
+  for (idx = 0; idx < SOCKET_N_CLIENTS; idx++)
+    clients[idx] = socket_client_connect (path, 0, GST_SOCKET_DROP_NEW);
+
+  // Clients receive buffers only after the sink has processed their HELLO.
+  for (num = 0; !ready && (num < SOCKET_N_PROBES); num++) {
+    socket_push_text (h, g_strdup ("probe"));
+    ready = TRUE;
+
+    for (idx = 0; idx < SOCKET_N_CLIENTS; idx++) {
+      text = socket_client_receive_text (clients[idx], 50);
+      received[idx] |= (text != NULL);
+      ready &= received[idx];
+      g_free (text);
+    }
+  }
+
+  fail_unless (ready, "Not all clients became ready!");
+
+  for (num = 0; num < SOCKET_N_BUFFERS; num++)
+    socket_push_text (h, socket_buffer_text (num));
+
+  // Every client receives every buffer once and in order.
+  for (idx = 0; idx < SOCKET_N_CLIENTS; idx++) {
+    for (num = 0; num < SOCKET_N_BUFFERS; num++) {
+      text = socket_client_receive_text (clients[idx], 1000);
+
+      // Skip the probes which were still queued when waiting ended.
+      while ((num == 0) && (text != NULL) && g_str_equal (text, "probe")) {
+        g_free (text);
+        text = socket_client_receive_text (clients[idx], 1000);
+      }
+
+      fail_unless (text != NULL, "Client %u missed buffer %u!", idx, num);
+
+      expected = socket_buffer_text (num);
+      fail_unless_equals_string (text, expected);
+
+      g_free (expected);
+      g_free (text);
+    }
+
+    errno = 0;
+    fail_unless (socket_peek_datagram (clients[idx]) < 0);
+    fail_unless_equals_int (errno, EAGAIN);
+  }
+
+  for (idx = 0; idx < SOCKET_N_CLIENTS; idx++)
+    close (clients[idx]);
+
+  gst_harness_teardown (h);
+
+  g_free (description);
+  g_free (path);
+}
+GST_END_TEST;
+
+GST_START_TEST (test_socket_slow_clients)
+{
+  // Fast client without limit, slow clients dropping new and old buffers.
+  const guint depths[] = { 0, SOCKET_QUEUE_DEPTH, SOCKET_QUEUE_DEPTH };
+  const GstSocketDropPolicy policies[] = {
+    GST_SOCKET_DROP_NEW, GST_SOCKET_DROP_NEW, GST_SOCKET_DROP_OLD,
+  };
+  GstPayloadInfo pl_info = { 0, };
+  GstAllocator *allocator = NULL;
+  GstHarness *h = NULL;
+  GstMemory *memory = NULL;
+  GstBuffer *buffers[SOCKET_N_FRAMES] = { NULL, };
+  GPtrArray *probes = NULL;
+  gint fds[GST_MAX_MEM_BLOCKS] = { -1, };
+  gint clients[G_N_ELEMENTS (depths)];
+  gboolean received[G_N_ELEMENTS (depths)] = { FALSE, };
+  gboolean ready = FALSE;
+  gchar *path = NULL;
+  guint idx = 0, num = 0;
+
+  allocator = gst_fd_allocator_new ();
+  probes = g_ptr_array_new_with_free_func ((GDestroyNotify) gst_buffer_unref);
+  path = g_strdup_printf ("%s/qti-socket-slow-clients-%d", g_get_tmp_dir (),
+      getpid ());
+
+  h = socket_sink_harness (path, TRUE);
+
+  for (idx = 0; idx < G_N_ELEMENTS (depths); idx++)
+    clients[idx] = socket_client_connect (path, depths[idx], policies[idx]);
+
+  // Clients receive buffers only after the sink has processed their HELLO.
+  // Probes are returned right away, so they never fill the client queues.
+  for (num = 0; !ready && (num < SOCKET_N_PROBES); num++) {
+    memory = socket_fd_memory (allocator);
+    g_ptr_array_add (probes, socket_fd_buffer (memory));
+    gst_memory_unref (memory);
+
+    gst_harness_push (h, gst_buffer_ref (g_ptr_array_index (probes, num)));
+    ready = TRUE;
+
+    for (idx = 0; idx < G_N_ELEMENTS (depths); idx++) {
+      while (socket_peer_receive (clients[idx], &pl_info, fds, 50)) {
+        socket_peer_return (clients[idx], &pl_info, pl_info.header->version);
+        free_pl_struct (&pl_info);
+        received[idx] = TRUE;
+      }
+
+      ready &= received[idx];
+    }
+  }
+
+  fail_unless (ready, "Not all clients became ready!");
+
+  // Probes sent after a late return are returned as well.
+  for (idx = 0; idx < G_N_ELEMENTS (depths); idx++) {
+    while (socket_peer_receive (clients[idx], &pl_info, fds, 100)) {
+      socket_peer_return (clients[idx], &pl_info, pl_info.header->version);
+      free_pl_struct (&pl_info);
+    }
+  }
+
+  // Once every client returned its probes nothing is held or pending.
+  for (num = 0; num < probes->len; num++)
+    fail_unless (socket_buffer_released (g_ptr_array_index (probes, num)));
+
+  g_ptr_array_free (probes, TRUE);
+
+  for (num = 0; num < SOCKET_N_FRAMES; num++) {
+    memory = socket_fd_memory (allocator);
+    buffers[num] = socket_fd_buffer (memory);
+    gst_memory_unref (memory);
+
+    GST_BUFFER_PTS (buffers[num]) = num * GST_SECOND;
+    gst_harness_push (h, gst_buffer_ref (buffers[num]));
+  }
+
+  // Fast client receives every frame in order and returns each of them.
+  for (num = 0; num < SOCKET_N_FRAMES; num++) {
+    fail_unless (socket_peer_receive (clients[0], &pl_info, fds, 1000),
+        "Fast client missed frame %u!", num);
+    fail_unless_equals_uint64 (pl_info.buffer_info->pts, num * GST_SECOND);
+
+    socket_peer_return (clients[0], &pl_info, pl_info.header->version);
+    free_pl_struct (&pl_info);
+  }
+
+  // Slow clients receive only the frames fitting into their queue depth.
+  for (idx = 1; idx < G_N_ELEMENTS (depths); idx++) {
+    for (num = 0; num < SOCKET_QUEUE_DEPTH; num++) {
+      fail_unless (socket_peer_receive (clients[idx], &pl_info, fds, 1000),
+          "Slow client %u missed frame %u!", idx, num);
+      fail_unless_equals_uint64 (pl_info.buffer_info->pts, num * GST_SECOND);
+
+      // Only the first frame is returned, the second one stays held.
+      if (num == 0)
+        socket_peer_return (clients[idx], &pl_info, pl_info.header->version);
+
+      free_pl_struct (&pl_info);
+    }
+  }
+
+  // Returned frame frees one slot. The drop-new client lost the remaining
+  // frames, while the drop-old client gets the latest frame.
+  fail_if (socket_peer_receive (clients[1], &pl_info, fds, 200),
+      "Drop-new client received a dropped frame!");
+
+  fail_unless (socket_peer_receive (clients[2], &pl_info, fds, 1000));
+  fail_unless_equals_uint64 (pl_info.buffer_info->pts,
+      (SOCKET_N_FRAMES - 1) * GST_SECOND);
+  free_pl_struct (&pl_info);
+
+  fail_if (socket_peer_receive (clients[2], &pl_info, fds, 200),
+      "Drop-old client received a replaced frame!");
+
+  // Frames returned by every client, or dropped for the slow ones, are free.
+  fail_unless (socket_buffer_released (buffers[0]));
+
+  for (num = SOCKET_QUEUE_DEPTH; num < (SOCKET_N_FRAMES - 1); num++)
+    fail_unless (socket_buffer_released (buffers[num]));
+
+  // Second frame is held by the slow clients and the last by drop-old only.
+  fail_unless (GST_MINI_OBJECT_REFCOUNT_VALUE (buffers[1]) > 1);
+  fail_unless (
+      GST_MINI_OBJECT_REFCOUNT_VALUE (buffers[SOCKET_N_FRAMES - 1]) > 1);
+
+  // Disconnected clients release every buffer they still held.
+  close (clients[1]);
+  close (clients[2]);
+
+  for (num = 0; num < SOCKET_N_FRAMES; num++)
+    fail_unless (socket_buffer_released (buffers[num]),
+        "Frame %u not released after disconnect!", num);
+
+  for (num = 0; num < SOCKET_N_FRAMES; num++)
+    gst_buffer_unref (buffers[num]);
+
+  close (clients[0]);
+  gst_harness_teardown (h);
+
+  gst_object_unref (allocator);
+  g_free (path);
+}
+GST_END_TEST;
+
+GST_START_TEST (test_socket_meta_ring)
+{
+  GstMetaRing *producer = NULL, *consumer = NULL;
+  guint8 record[SOCKET_RECORD_SIZE];
+  guint32 positions[4] = { 0, }, position = 0;
+  guint idx = 0;
+
+  producer = gst_meta_ring_new (SOCKET_RING_SIZE);
+  fail_unless (producer != NULL);
+
+  consumer = gst_meta_ring_import (dup (producer->fd));
+  fail_unless (consumer != NULL);
+  fail_unless_equals_int (consumer->size, SOCKET_RING_SIZE);
+
+  // Fill the ring, the last record does not fit in the remaining space.
+  for (idx = 0; idx < 3; idx++) {
+    socket_record_fill (record, idx * SOCKET_RECORD_SIZE);
+    fail_unless (gst_meta_ring_write (producer, record, SOCKET_RECORD_SIZE,
+        &positions[idx]));
+    fail_unless_equals_int (positions[idx], idx * SOCKET_RECORD_SIZE);
+  }
+
+  fail_if (gst_meta_ring_write (producer, record, SOCKET_RECORD_SIZE,
+      &position));
+
+  for (idx = 0; idx < 3; idx++)
+    socket_record_check (gst_meta_ring_read (consumer, positions[idx],
+        SOCKET_RECORD_SIZE), positions[idx]);
+
+  // Records which were not written or exceed the data area are rejected.
+  fail_unless (gst_meta_ring_read (consumer, positions[2] + SOCKET_RECORD_SIZE,
+      SOCKET_RECORD_SIZE) == NULL);
+  fail_unless (gst_meta_ring_read (consumer, SOCKET_RING_SIZE - 8,
+      SOCKET_RECORD_SIZE) == NULL);
+
+  // Releasing the second record also releases the first one. The next record
+  // does not fit before the end of the data area and is written at its start.
+  gst_meta_ring_release (consumer, positions[1], SOCKET_RECORD_SIZE);
+
+  socket_record_fill (record, SOCKET_RING_SIZE);
+  fail_unless (gst_meta_ring_write (producer, record, SOCKET_RECORD_SIZE,
+      &positions[3]));
+  fail_unless_equals_int (positions[3], SOCKET_RING_SIZE);
+
+  socket_record_check (gst_meta_ring_read (consumer, positions[3],
+      SOCKET_RECORD_SIZE), positions[3]);
+  socket_record_check (gst_meta_ring_read (consumer, positions[2],
+      SOCKET_RECORD_SIZE), positions[2]);
+
+  // Released records are no longer accessible.
+  fail_unless (gst_meta_ring_read (consumer, positions[0],
+      SOCKET_RECORD_SIZE) == NULL);
+
+  // Records of a message which was not sent are discarded.
+  fail_unless (gst_meta_ring_write (producer, record, 64, &position));
+  gst_meta_ring_rewind (producer, position);
+  fail_unless (gst_meta_ring_read (consumer, position, 64) == NULL);
+
+  gst_meta_ring_release (consumer, positions[3], SOCKET_RECORD_SIZE);
+  fail_unless_equals_int (g_atomic_int_get (&consumer->header->head),
+      g_atomic_int_get (&consumer->header->tail));
+
+  gst_meta_ring_free (consumer);
+  gst_meta_ring_free (producer);
+}
+GST_END_TEST;
+
+GST_START_TEST (test_socket_meta_records)
+{
+  GstBuffer *buffer = NULL, *outbuffer = NULL;
+  GstVideoRegionOfInterestMeta *roimetas[2] = { NULL, };
+  GstVideoClassificationMeta *classmeta = NULL;
+  GstVideoLandmarksMeta *lmkmetas[2] = { NULL, };
+  GstMeta *meta = NULL;
+  GByteArray *records = NULL;
+  GArray *labels = NULL, *keypoints = NULL, *links = NULL;
+  GstClassLabel *label = NULL;
+  GstVideoKeypoint *kp = NULL;
+  GstVideoKeypointLink *link = NULL;
+  gpointer state = NULL;
+  guint idx = 0, n_rois = 0, n_lmks = 0;
+
+  buffer = gst_buffer_new ();
+
+  // Detection with only confidence and color, encoded in binary form.
+  roimetas[0] = socket_add_roi_meta (buffer, "person", 1,
+      gst_structure_new ("ObjectDetection",
+          "confidence", G_TYPE_DOUBLE, 87.5,
+          "color", G_TYPE_UINT, 0xFF0000FF, NULL),
+      NULL);
+
+  // Detection with other fields and extra params, encoded as strings.
+  roimetas[1] = socket_add_roi_meta (buffer, "car", 2,
+      gst_structure_new ("ObjectDetection",
+          "confidence", G_TYPE_DOUBLE, 51.25,
+          "color", G_TYPE_UINT, 0x00FF00FF,
+          "tracking-id", G_TYPE_UINT, 7, NULL),
+      gst_structure_new ("xtraparams",
+          "stream-id", G_TYPE_INT, 3, NULL));
+
+  labels = g_array_sized_new (FALSE, TRUE, sizeof (GstClassLabel), 2);
+  g_array_set_size (labels, 2);
+  g_array_set_clear_func (labels,
+      (GDestroyNotify) gst_video_classification_label_cleanup);
+
+  label = &(g_array_index (labels, GstClassLabel, 0));
+  label->name = g_quark_from_string ("hatchback");
+  label->confidence = 92.0;
+  label->color = 0x0000FFFF;
+
+  label = &(g_array_index (labels, GstClassLabel, 1));
+  label->name = g_quark_from_string ("sedan");
+  label->confidence = 7.5;
+  label->color = 0xFFFF00FF;
+  label->xtraparams = gst_structure_new ("xtraparams",
+      "source", G_TYPE_STRING, "secondary", NULL);
+
+  classmeta = gst_buffer_add_video_classification_meta (buffer, labels);
+  classmeta->id = 3;
+  classmeta->parent_id = roimetas[1]->id;
+
+  keypoints = g_array_sized_new (FALSE, TRUE, sizeof (GstVideoKeypoint), 3);
+  g_array_set_size (keypoints, 3);
+
+  for (idx = 0; idx < keypoints->len; idx++) {
+    kp = &(g_array_index (keypoints, GstVideoKeypoint, idx));
+    kp->name = g_quark_from_string ((idx == 0) ? "nose" : "eye");
+    kp->confidence = 50.0 + idx;
+    kp->color = 0x000000FF + idx;
+    kp->x = 100 + idx;
+    kp->y = -(gint) idx;
+  }
+
+  links = g_array_sized_new (FALSE, TRUE, sizeof (GstVideoKeypointLink), 2);
+  g_array_set_size (links, 2);
+
+  for (idx = 0; idx < links->len; idx++) {
+    link = &(g_array_index (links, GstVideoKeypointLink, idx));
+    link->s_kp_idx = 0;
+    link->d_kp_idx = idx + 1;
+  }
+
+  lmkmetas[0] = gst_buffer_add_video_landmarks_meta (buffer, 66.0,
+      keypoints, links);
+  lmkmetas[0]->id = 4;
+  lmkmetas[0]->parent_id = roimetas[0]->id;
+  lmkmetas[0]->xtraparams = gst_structure_new ("xtraparams",
+      "keypoints", G_TYPE_STRING, "face", NULL);
+
+  // Landmarks without links.
+  keypoints = g_array_copy (keypoints);
+  lmkmetas[1] = gst_buffer_add_video_landmarks_meta (buffer, 12.0,
+      keypoints, NULL);
+  lmkmetas[1]->id = 5;
+  lmkmetas[1]->parent_id = -1;
+
+  records = g_byte_array_new ();
+
+  fail_unless_equals_int (gst_meta_records_serialize (buffer, records), 5);
+  fail_unless_equals_int (records->len % 8, 0);
+
+  outbuffer = gst_buffer_new ();
+  fail_unless (gst_meta_records_deserialize (outbuffer, records->data,
+      records->len));
+
+  // Decoded metas are matched with the original ones by their IDs.
+  while ((meta = gst_buffer_iterate_meta (outbuffer, &state))) {
+    if (meta->info->api == GST_VIDEO_REGION_OF_INTEREST_META_API_TYPE) {
+      GstVideoRegionOfInterestMeta *roimeta = GST_VIDEO_ROI_META_CAST (meta);
+
+      fail_unless ((roimeta->id >= 1) && (roimeta->id <= 2));
+      socket_check_roi_meta (roimetas[roimeta->id - 1], roimeta);
+      n_rois++;
+    } else if (meta->info->api == GST_VIDEO_CLASSIFICATION_META_API_TYPE) {
+      socket_check_classification_meta (classmeta,
+          GST_VIDEO_CLASSIFICATION_META_CAST (meta));
+    } else if (meta->info->api == GST_VIDEO_LANDMARKS_META_API_TYPE) {
+      GstVideoLandmarksMeta *lmkmeta = GST_VIDEO_LANDMARKS_META_CAST (meta);
+
+      fail_unless ((lmkmeta->id >= 4) && (lmkmeta->id <= 5));
+      idx = lmkmeta->id - 4;
+
+      // Missing links are decoded as an empty array.
+      if (lmkmetas[idx]->links == NULL) {
+        fail_unless_equals_int (lmkmeta->links->len, 0);
+        lmkmetas[idx]->links =
+            g_array_new (FALSE, FALSE, sizeof (GstVideoKeypointLink));
+      }
+
+      socket_check_landmarks_meta (lmkmetas[idx], lmkmeta);
+      n_lmks++;
+    }
+  }
+
+  fail_unless_equals_int (n_rois, G_N_ELEMENTS (roimetas));
+  fail_unless_equals_int (n_lmks, G_N_ELEMENTS (lmkmetas));
+  fail_unless (gst_buffer_get_video_classification_meta (outbuffer) != NULL);
+
+  gst_buffer_unref (outbuffer);
+
+  // Truncated records are rejected.
+  outbuffer = gst_buffer_new ();
+  fail_if (gst_meta_records_deserialize (outbuffer, records->data,
+      records->len - 8));
+  gst_buffer_unref (outbuffer);
+
+  g_byte_array_unref (records);
+  gst_buffer_unref (buffer);
+}
+GST_END_TEST;
+
+GST_START_TEST (test_socket_redis_pipeline)
+{
+  GstHarness *h = NULL;
+  struct sockaddr_in address = { 0, };
+  socklen_t length = sizeof (address);
+  struct pollfd pfd = { .fd = -1, .events = POLLIN };
+  GByteArray *expected = NULL;
+  guint8 *received = NULL;
+  gchar *pipeline = NULL, *prefix = NULL;
+  guint64 dropped = 0;
+  gint server = -1, sock = -1;
+  guint num = 0;
+
+  // Mock REDIS service, accepts a single connection on a free port.
+  server = socket (AF_INET, SOCK_STREAM, 0);
+  fail_unless (server >= 0);
+
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+
+  fail_unless (bind (server, (struct sockaddr *) &address,
+      sizeof (address)) == 0);
+  fail_unless (listen (server, 1) == 0);
+  fail_unless (getsockname (server, (struct sockaddr *) &address,
+      &length) == 0);
+
+  pipeline = g_strdup_printf ("qtiredissink host=127.0.0.1 port=%u "
+      "channel=meta mode=async sync=false", ntohs (address.sin_port));
+
+  h = gst_harness_new_parse (pipeline);
+  g_free (pipeline);
+
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw,format=NV12,width=320,height=240,framerate=30/1");
+
+  // Messages are queued, they are sent once the connection is accepted.
+  for (num = 0; num < SOCKET_REDIS_MESSAGES; num++)
+    fail_unless_equals_int (gst_harness_push (h, socket_redis_buffer (num)),
+        GST_FLOW_OK);
+
+  pfd.fd = server;
+  fail_unless (poll (&pfd, 1, 5000) == 1);
+
+  sock = accept (server, NULL, NULL);
+  fail_unless (sock >= 0);
+
+  for (num = 0; num < SOCKET_REDIS_MESSAGES; num++) {
+    expected = g_byte_array_new ();
+
+    prefix = g_strdup_printf ("*3\r\n$7\r\nPUBLISH\r\n$4\r\nmeta\r\n"
+        "$%" G_GSIZE_FORMAT "\r\n", sizeof (socket_redis_payload));
+    g_byte_array_append (expected, (const guint8 *) prefix, strlen (prefix));
+    g_free (prefix);
+
+    g_byte_array_append (expected, socket_redis_payload,
+        sizeof (socket_redis_payload));
+    g_byte_array_append (expected, (const guint8 *) "\r\n", 2);
+
+    // Each message carries the timestamp of its buffer.
+    expected->data[expected->len - sizeof (socket_redis_payload) - 2 +
+        SOCKET_REDIS_TS_BYTE] += num;
+
+    received = g_malloc (expected->len);
+
+    fail_unless (socket_stream_read (sock, received, expected->len, 5000),
+        "Message %u was not received", num);
+    fail_unless (memcmp (received, expected->data, expected->len) == 0,
+        "Message %u differs from the expected encoding", num);
+
+    // Reply with the number of subscribers which received the message.
+    fail_unless (send (sock, ":1\r\n", 4, MSG_NOSIGNAL) == 4);
+
+    g_free (received);
+    g_byte_array_unref (expected);
+  }
+
+  g_object_get (h->element, "dropped", &dropped, NULL);
+  fail_unless_equals_uint64 (dropped, 0);
+
+  gst_harness_teardown (h);
+
+  close (sock);
+  close (server);
+}
+GST_END_TEST;
+
+static Suite *
+socket_suite (GList **tcnames, gint iteration, gint duration)
+{
+  Suite *s = suite_create ("socket");
+  TCase *tc;
+  gchar *tcname = NULL;
+  int start = 0, end = 1;
+  // TCase timeout in seconds.
+  int tctimeout = 30;
+
+  if (iteration > 0)
+    end = iteration;
+
+  tcname = "socket_v2_framing";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase single datagram framing and FD passing.
+  tcase_add_loop_test (tc, test_socket_v2_framing, start, end);
+
+  tcname = "socket_fd_registry";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase version negotiation and FD registry of the socket sink.
+  tcase_add_loop_test (tc, test_socket_fd_registry, start, end);
+
+  tcname = "socket_fan_out";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase listening sink delivering to several clients.
+  tcase_add_loop_test (tc, test_socket_fan_out, start, end);
+
+  tcname = "socket_slow_clients";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase queue depth and drop policies of listening sink clients.
+  tcase_add_loop_test (tc, test_socket_slow_clients, start, end);
+
+  tcname = "socket_meta_ring";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase metadata ring positions, wrap around and release.
+  tcase_add_loop_test (tc, test_socket_meta_ring, start, end);
+
+  tcname = "socket_meta_records";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase video metas encoded as metadata records and back.
+  tcase_add_loop_test (tc, test_socket_meta_records, start, end);
+
+  tcname = "socket_redis_pipeline";
+  tc = tcase_create (tcname);
+  *tcnames = g_list_append (*tcnames, (gpointer)tcname);
+  suite_add_tcase (s, tc);
+  tcase_set_timeout (tc, tctimeout);
+  // Add test to TCase REDIS sink messages pipelined to a mock service.
+  tcase_add_loop_test (tc, test_socket_redis_pipeline, start, end);
+
+  return s;
+}
+
+void gst_plugin_get_socket_suite (GstPluginSuite* psuite)
+{
+  if (psuite == NULL)
+    return;
+
+  psuite->name = "socket";
+  psuite->suite = socket_suite (&psuite->tcnames,
+      psuite->iteration, psuite->duration);
+}
@@ -23,6 +23,8 @@ typedef enum {
   GST_TEST_SUITE_AI,
   GST_TEST_SUITE_ML,
   GST_TEST_SUITE_CV,
+  GST_TEST_SUITE_PERF,
+  GST_TEST_SUITE_SOCKET,
   GST_TEST_SUITE_MAX
 } GstPluginSuiteIdx;
 
@@ -42,6 +44,15 @@ gst_plugin_get_camera_suite (GstPluginSuite* psuite);
 GST_API void
 gst_plugin_get_ml_suite (GstPluginSuite* psuite);
 
+GST_API void
+gst_plugin_get_cv_suite (GstPluginSuite* psuite);
+
+GST_API void
+gst_plugin_get_perf_suite (GstPluginSuite* psuite);
+
+GST_API void
+gst_plugin_get_socket_suite (GstPluginSuite* psuite);
+
 G_END_DECLS
 
 #endif /* __GST_PLUGIN_SUITE_H__ */